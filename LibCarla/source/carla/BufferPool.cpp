@@ -0,0 +1,219 @@
+// Copyright (c) 2023 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "carla/BufferPool.h"
+
+#include "carla/profiler/Profiler.h"
+
+#include <algorithm>
+
+#if defined(__linux__)
+#  include <sys/mman.h>
+#endif
+
+namespace carla {
+
+  // ===========================================================================
+  // -- Buckets ----------------------------------------------------------------
+  // ===========================================================================
+
+  static constexpr size_t MIN_BUCKET_LOG2 = 10u;
+
+  static size_t FloorLog2(size_t value) {
+    size_t result = 0u;
+    while (value >>= 1u) {
+      ++result;
+    }
+    return result;
+  }
+
+  /// Capacity of the buffers of @a bucket, the four buckets of each power of
+  /// two are 4/4, 5/4, 6/4 and 7/4 of it.
+  static size_t GetBucketCapacity(size_t bucket) {
+    const size_t exponent = MIN_BUCKET_LOG2 + bucket / 4u;
+    return (4u + bucket % 4u) << (exponent - 2u);
+  }
+
+  /// Biggest bucket whose capacity is less or equal than @a capacity.
+  static size_t GetBucketToPush(size_t capacity, size_t number_of_buckets) {
+    if (capacity < (size_t(1u) << MIN_BUCKET_LOG2)) {
+      return 0u;
+    }
+    const size_t exponent = FloorLog2(capacity);
+    const size_t quarter = (capacity >> (exponent - 2u)) - 4u;
+    return std::min(4u * (exponent - MIN_BUCKET_LOG2) + quarter, number_of_buckets - 1u);
+  }
+
+  /// Smallest bucket whose capacity is greater or equal than @a size.
+  static size_t GetBucketToPop(size_t size, size_t number_of_buckets) {
+    const size_t bucket = GetBucketToPush(size, number_of_buckets);
+    if ((bucket + 1u < number_of_buckets) && (GetBucketCapacity(bucket) < size)) {
+      return bucket + 1u;
+    }
+    return bucket;
+  }
+
+  static void AdviseHugePages(const void *data, const size_t size) {
+#if defined(__linux__)
+    // Only the 2 MiB aligned part of the allocation can be backed by huge
+    // pages, the memory was not touched yet so the kernel can do it on the
+    // first page fault.
+    const auto begin = reinterpret_cast<uintptr_t>(data);
+    const auto end = begin + size;
+    const auto aligned_begin = (begin + BufferPool::huge_page_size - 1u) & ~uintptr_t(BufferPool::huge_page_size - 1u);
+    const auto aligned_end = end & ~uintptr_t(BufferPool::huge_page_size - 1u);
+    if (aligned_end > aligned_begin) {
+      ::madvise(reinterpret_cast<void *>(aligned_begin), aligned_end - aligned_begin, MADV_HUGEPAGE);
+    }
+#else
+    (void) data;
+    (void) size;
+#endif // __linux__
+  }
+
+  // ===========================================================================
+  // -- BufferPool -------------------------------------------------------------
+  // ===========================================================================
+
+  BufferPool::BufferPool(std::string name, const size_t max_bytes_retained)
+    : _name(std::move(name)),
+      _max_bytes_retained(max_bytes_retained) {
+    for (auto &bucket : _buckets) {
+      bucket = nullptr;
+    }
+  }
+
+  BufferPool::~BufferPool() {
+#ifdef LIBCARLA_ENABLE_PROFILER
+    if (!_name.empty()) {
+      constexpr double MB = 1024.0 * 1024.0;
+      const size_t pops = _hits + _misses;
+      const double hit_ratio = pops > 0u ? 100.0 * static_cast<double>(_hits) / static_cast<double>(pops) : 0.0;
+      CARLA_PROFILE_COUNTER(_name + ".hit_ratio", hit_ratio, hit_ratio, "%", pops);
+      CARLA_PROFILE_COUNTER(_name + ".bytes_retained", _bytes_retained / MB, _max_bytes_retained_reached / MB, "MB", pops);
+      CARLA_PROFILE_COUNTER(_name + ".bytes_trimmed", _bytes_trimmed / MB, _bytes_trimmed / MB, "MB", pops);
+    }
+#endif // LIBCARLA_ENABLE_PROFILER
+    for (auto &bucket : _buckets) {
+      delete bucket.load();
+    }
+  }
+
+  Buffer BufferPool::Pop(const size_t size) {
+    DEBUG_ASSERT(size <= Buffer::max_size());
+    const auto first = GetBucketToPop(size, number_of_buckets);
+    const auto last = std::min(first + 4u, number_of_buckets);
+    Buffer item;
+    bool found = false;
+    for (auto bucket = first; !found && (bucket < last); ++bucket) {
+      found = TryPop(bucket, item);
+    }
+    if (found && (item.capacity() >= size)) {
+      ++_hits;
+    } else {
+      // A buffer too small can only be one resized outside the pool, let it
+      // be deleted. Putting it back would have it popped again on every miss.
+      ++_misses;
+      // Allocate the full capacity of the bucket so the buffer returns to it,
+      // also for small sizes, so any buffer of the first bucket serves any
+      // small pop.
+      const auto capacity = std::max(size, std::min(GetBucketCapacity(first), size_t(Buffer::max_size())));
+      Allocate(item, capacity);
+    }
+    item.reset(static_cast<Buffer::size_type>(size));
+    Adopt(item);
+    return item;
+  }
+
+  Buffer BufferPool::Pop() {
+    Buffer item;
+    if (TryPop(_last_bucket, item)) {
+      ++_hits;
+    } else {
+      ++_misses;
+    }
+    Adopt(item);
+    return item;
+  }
+
+  void BufferPool::Trim(const size_t bytes) {
+    for (auto bucket = number_of_buckets; (bucket > 0u) && (_bytes_retained > bytes);) {
+      --bucket;
+      Buffer item;
+      while ((_bytes_retained > bytes) && TryPop(bucket, item)) {
+        _bytes_trimmed += item.capacity();
+        item.clear();
+      }
+    }
+  }
+
+  BufferPoolStatistics BufferPool::GetStatistics() const {
+    BufferPoolStatistics statistics;
+    statistics.hits = _hits;
+    statistics.misses = _misses;
+    statistics.bytes_retained = _bytes_retained;
+    statistics.max_bytes_retained = _max_bytes_retained_reached;
+    statistics.bytes_trimmed = _bytes_trimmed;
+    return statistics;
+  }
+
+  void BufferPool::Push(Buffer &&buffer) {
+    const size_t capacity = buffer.capacity();
+    const size_t retained = _bytes_retained.fetch_add(capacity) + capacity;
+    if (retained > _max_bytes_retained) {
+      // Over the high-water mark, let the buffer be deleted.
+      _bytes_retained -= capacity;
+      _bytes_trimmed += capacity;
+      return;
+    }
+    size_t max_retained = _max_bytes_retained_reached;
+    while ((retained > max_retained) &&
+           !_max_bytes_retained_reached.compare_exchange_weak(max_retained, retained));
+    const auto bucket = GetBucketToPush(capacity, number_of_buckets);
+    _last_bucket = bucket;
+    GetBucket(bucket).enqueue(std::move(buffer));
+  }
+
+  bool BufferPool::TryPop(const size_t bucket, Buffer &buffer) {
+    auto *queue = _buckets[bucket].load(std::memory_order_acquire);
+    if ((queue == nullptr) || !queue->try_dequeue(buffer)) {
+      return false;
+    }
+    _bytes_retained -= buffer.capacity();
+    return true;
+  }
+
+  BufferPool::Bucket &BufferPool::GetBucket(const size_t bucket) {
+    auto *queue = _buckets[bucket].load(std::memory_order_acquire);
+    if (queue == nullptr) {
+      auto created = std::make_unique<Bucket>(0u);
+      if (_buckets[bucket].compare_exchange_strong(queue, created.get(), std::memory_order_acq_rel)) {
+        queue = created.release();
+      }
+    }
+    return *queue;
+  }
+
+  void BufferPool::Allocate(Buffer &buffer, const size_t capacity) {
+    // Not value-initialized, so no page is touched before the advice.
+    std::unique_ptr<Buffer::value_type[]> data(new Buffer::value_type[capacity]);
+    if (_huge_pages && (capacity >= huge_page_size)) {
+      AdviseHugePages(data.get(), capacity);
+    }
+    buffer._data = std::move(data);
+    buffer._capacity = static_cast<Buffer::size_type>(capacity);
+    buffer._size = 0u;
+  }
+
+  void BufferPool::Adopt(Buffer &buffer) {
+#if __cplusplus >= 201703L // C++17
+    buffer._parent_pool = weak_from_this();
+#else
+    buffer._parent_pool = shared_from_this();
+#endif
+  }
+
+} // namespace carla
@@ -17,44 +17,113 @@
 #  pragma clang diagnostic pop
 #endif
 
+#include <array>
+#include <atomic>
 #include <memory>
+#include <string>
 
 namespace carla {
 
+  /// Counters of a BufferPool.
+  struct BufferPoolStatistics {
+    /// Pops served with a buffer from the pool.
+    size_t hits = 0u;
+    /// Pops that had to allocate a new buffer.
+    size_t misses = 0u;
+    /// Bytes held by the buffers currently in the pool.
+    size_t bytes_retained = 0u;
+    /// Maximum value reached by bytes_retained.
+    size_t max_bytes_retained = 0u;
+    /// Bytes released because the pool was over its high-water mark.
+    size_t bytes_trimmed = 0u;
+  };
+
   /// A pool of Buffer. Buffers popped from this pool automatically return to
   /// the pool on destruction so the allocated memory can be reused.
   ///
-  /// @warning Buffers adjust their size only by growing, they never shrink
-  /// unless explicitly cleared. The allocated memory is only deleted when this
-  /// pool is destroyed.
+  /// Returned buffers are kept in buckets by capacity, four per power of two,
+  /// so a small message is not handed the memory of a big one. The pool
+  /// retains at most a configurable amount of memory, buffers returned above
+  /// this high-water mark are deleted.
   class BufferPool : public std::enable_shared_from_this<BufferPool> {
   public:
 
-    BufferPool() = default;
+    static constexpr size_t default_max_bytes_retained = 256u * 1024u * 1024u;
 
-    explicit BufferPool(size_t estimated_size) : _queue(estimated_size) {}
+    /// Buffers of at least this size may be backed by huge pages.
+    static constexpr size_t huge_page_size = 2u * 1024u * 1024u;
 
-    /// Pop a Buffer from the queue, creates a new one if the queue is empty.
-    Buffer Pop() {
-      Buffer item;
-      _queue.try_dequeue(item); // we don't care if it fails.
-#if __cplusplus >= 201703L // C++17
-      item._parent_pool = weak_from_this();
-#else
-      item._parent_pool = shared_from_this();
-#endif
-      return item;
+    /// If a @a name is given, the counters of the pool are written to the
+    /// profiler output when the pool is destroyed.
+    explicit BufferPool(
+        std::string name = "",
+        size_t max_bytes_retained = default_max_bytes_retained);
+
+    ~BufferPool();
+
+    /// Pop a Buffer of @a size bytes, creates a new one if there is no buffer
+    /// of a similar capacity in the pool.
+    Buffer Pop(size_t size);
+
+    /// Pop a Buffer of unknown size. Returns one of the capacity of the last
+    /// buffer that returned to the pool, or an empty buffer if there is none.
+    Buffer Pop();
+
+    /// Delete buffers from the pool, biggest first, until at most @a bytes
+    /// are retained.
+    void Trim(size_t bytes = 0u);
+
+    /// Back the new buffers of at least huge_page_size bytes with transparent
+    /// huge pages. Only has effect on Linux. Meant for pools of big messages,
+    /// like the images of the sensor streams.
+    void SetHugePages(bool enabled) {
+      _huge_pages = enabled;
     }
 
+    BufferPoolStatistics GetStatistics() const;
+
   private:
 
+    using Bucket = moodycamel::ConcurrentQueue<Buffer>;
+
+    /// From 1 KiB to the maximum size of a Buffer, four buckets per power of
+    /// two. Bucket zero also holds the buffers smaller than 1 KiB.
+    static constexpr size_t number_of_buckets = 4u * (32u - 10u);
+
     friend class Buffer;
 
-    void Push(Buffer &&buffer) {
-      _queue.enqueue(std::move(buffer));
-    }
+    void Push(Buffer &&buffer);
+
+    bool TryPop(size_t bucket, Buffer &buffer);
+
+    /// Replace the memory of @a buffer with a new uninitialized block of
+    /// @a capacity bytes.
+    void Allocate(Buffer &buffer, size_t capacity);
+
+    Bucket &GetBucket(size_t bucket);
+
+    void Adopt(Buffer &buffer);
+
+    const std::string _name;
+
+    const size_t _max_bytes_retained;
+
+    std::atomic_bool _huge_pages{false};
+
+    std::atomic_size_t _last_bucket{0u};
+
+    std::atomic_size_t _hits{0u};
+
+    std::atomic_size_t _misses{0u};
+
+    std::atomic_size_t _bytes_retained{0u};
+
+    std::atomic_size_t _max_bytes_retained_reached{0u};
+
+    std::atomic_size_t _bytes_trimmed{0u};
 
-    moodycamel::ConcurrentQueue<Buffer> _queue;
+    /// Created on first use, most pools only see a few sizes.
+    std::array<std::atomic<Bucket *>, number_of_buckets> _buckets;
   };
 
 } // namespace carla
@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include "carla/Debug.h"
 #include "carla/MoveHandler.h"
 #include "carla/NonCopyable.h"
 #include "carla/ThreadGroup.h"
@@ -14,7 +15,13 @@
 #include <boost/asio/io_context.hpp>
 #include <boost/asio/post.hpp>
 
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
 #include <future>
+#include <memory>
+#include <mutex>
 #include <thread>
 #include <type_traits>
 
@@ -49,6 +56,7 @@ namespace carla {
     /// threads if @a worker_threads is provided, otherwise use all available
     /// hardware concurrency.
     void AsyncRun(size_t worker_threads) {
+      _number_of_workers += worker_threads;
       _workers.CreateThreads(worker_threads, [this]() { Run(); });
     }
 
@@ -76,15 +84,98 @@ namespace carla {
     void Stop() {
       _io_context.stop();
       _workers.JoinAll();
+      _number_of_workers = 0u;
+    }
+
+    /// Call @a task(begin, end) for consecutive ranges of @a grain_size
+    /// indices covering [0, @a size), and wait until all of them are done.
+    /// The ranges are taken one at a time by the threads of the pool and by
+    /// the calling thread, so calling it from a task of the same pool does not
+    /// deadlock. The first exception thrown by a task is rethrown here.
+    template <typename TaskT>
+    void ParallelFor(size_t size, size_t grain_size, TaskT &&task);
+
+    /// Pool shared by the computations of the library that are split with
+    /// ParallelFor, e.g. loading and querying the maps. Its threads are
+    /// started on first use.
+    static ThreadPool &GetShared() {
+      static ThreadPool pool(std::max(1u, std::thread::hardware_concurrency()) - 1u);
+      return pool;
     }
 
   private:
 
+    explicit ThreadPool(size_t worker_threads) : ThreadPool() {
+      AsyncRun(worker_threads);
+    }
+
     boost::asio::io_context _io_context;
 
     boost::asio::io_context::work _work_to_do;
 
     ThreadGroup _workers;
+
+    std::atomic_size_t _number_of_workers{0u};
   };
 
+  template <typename TaskT>
+  void ThreadPool::ParallelFor(const size_t size, const size_t grain_size, TaskT &&task) {
+    DEBUG_ASSERT(grain_size > 0u);
+    const size_t number_of_ranges = (size + grain_size - 1u) / grain_size;
+    if (number_of_ranges <= 1u || _number_of_workers == 0u) {
+      if (size > 0u) {
+        task(size_t(0u), size);
+      }
+      return;
+    }
+
+    // Shared with the helpers posted to the pool, which may start after this
+    // call returned. By then every range is taken and they return without
+    // touching the task.
+    struct State {
+      std::atomic_size_t next_range{0u};
+      std::mutex mutex;
+      std::condition_variable finished;
+      size_t ranges_done = 0u;
+      std::exception_ptr exception;
+    };
+    auto state = std::make_shared<State>();
+    auto run_ranges = [state, &task, size, grain_size, number_of_ranges]() {
+      for (size_t range = state->next_range++; range < number_of_ranges; range = state->next_range++) {
+        const size_t begin = range * grain_size;
+        std::exception_ptr exception;
+#ifndef LIBCARLA_NO_EXCEPTIONS
+        try {
+#endif // LIBCARLA_NO_EXCEPTIONS
+          task(begin, std::min(begin + grain_size, size));
+#ifndef LIBCARLA_NO_EXCEPTIONS
+        } catch (...) {
+          exception = std::current_exception();
+        }
+#endif // LIBCARLA_NO_EXCEPTIONS
+        std::lock_guard<std::mutex> lock(state->mutex);
+        if (exception && !state->exception) {
+          state->exception = exception;
+        }
+        if (++state->ranges_done == number_of_ranges) {
+          state->finished.notify_all();
+        }
+      }
+    };
+
+    const size_t number_of_helpers = std::min<size_t>(_number_of_workers, number_of_ranges - 1u);
+    for (size_t i = 0u; i < number_of_helpers; ++i) {
+      boost::asio::post(_io_context, run_ranges);
+    }
+    run_ranges();
+
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->finished.wait(lock, [&]() { return state->ranges_done == number_of_ranges; });
+#ifndef LIBCARLA_NO_EXCEPTIONS
+    if (state->exception) {
+      std::rethrow_exception(state->exception);
+    }
+#endif // LIBCARLA_NO_EXCEPTIONS
+  }
+
 } // namespace carla
@@ -108,6 +108,12 @@ namespace client {
       return World{_simulator->GetCurrentEpisode()};
     }
 
+    /// Receive only the actors that changed each tick instead of the whole
+    /// episode state. Returns false if the server does not support it.
+    bool SetEpisodeStateDeltas(bool enabled) const {
+      return _simulator->SetEpisodeStateDeltas(enabled);
+    }
+
     /// Return an instance of the TrafficManager currently active in the simulator.
     TrafficManager GetInstanceTM(uint16_t port = TM_DEFAULT_PORT) const {
       return TrafficManager(_simulator->GetCurrentEpisode(), port);
@@ -118,8 +124,8 @@ namespace client {
       return _simulator->GetCurrentEpisode();
     }
 
-    std::string StartRecorder(std::string name, bool additional_data = false) {
-      return _simulator->StartRecorder(name, additional_data);
+    std::string StartRecorder(std::string name, bool additional_data = false, bool compressed = false) {
+      return _simulator->StartRecorder(name, additional_data, compressed);
     }
 
     void StopRecorder(void) {
@@ -67,15 +67,20 @@ namespace client {
   }
 
   std::vector<uint8_t> FileTransfer::ReadFile(std::string path) {
+    std::string fullpath = GetFilePath(path);
+    // Read the binary file from the base folder
+    std::ifstream file(fullpath, std::ios::binary);
+    std::vector<uint8_t> content(std::istreambuf_iterator<char>(file), {});
+    return content;
+  }
+
+  std::string FileTransfer::GetFilePath(const std::string &path) {
     std::string fullpath = _filesBaseFolder;
     fullpath += "/";
     fullpath += ::carla::version();
     fullpath += "/";
     fullpath += path;
-    // Read the binary file from the base folder
-    std::ifstream file(fullpath, std::ios::binary);
-    std::vector<uint8_t> content(std::istreambuf_iterator<char>(file), {});
-    return content;
+    return fullpath;
   }
 
 } // namespace client
@@ -32,6 +32,9 @@ namespace client {
 
     static std::vector<uint8_t> ReadFile(std::string path);
 
+    /// Returns the full path of a file stored in the cache folder.
+    static std::string GetFilePath(const std::string &path);
+
   private:
 
     static std::string _filesBaseFolder;
@@ -0,0 +1,101 @@
+// Copyright (c) 2023 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/Debug.h"
+#include "carla/Time.h"
+
+#include <functional>
+#include <type_traits>
+#include <utility>
+
+namespace carla {
+namespace client {
+
+  /// Result of a request to the simulator that has already been sent, but
+  /// whose response may have not arrived yet. Several requests can be in
+  /// flight on the same connection, so sending them all before waiting for
+  /// any of them saves a round trip per request.
+  ///
+  /// The response is read, and converted, by Get() in the calling thread.
+  /// Get() can be called only once.
+  template <typename T>
+  class Future {
+  public:
+
+    using value_type = T;
+
+    /// Waits up to the given time for the response, returns whether it
+    /// arrived.
+    using WaitFunction = std::function<bool(time_duration)>;
+
+    using GetFunction = std::function<T()>;
+
+    Future() = default;
+
+    Future(WaitFunction wait, GetFunction get)
+      : _wait(std::move(wait)),
+        _get(std::move(get)) {}
+
+    /// A future whose result is already known.
+    static Future MakeReady(T value) {
+      return Future(
+          [](time_duration) { return true; },
+          [value=std::move(value)]() { return value; });
+    }
+
+    /// Whether Get() can still be called.
+    bool IsValid() const {
+      return _get != nullptr;
+    }
+
+    /// Whether the response arrived, without blocking.
+    bool IsReady() const {
+      return WaitFor(time_duration::milliseconds(0u));
+    }
+
+    /// Blocks until the response arrives or @a timeout expires, returns
+    /// whether it arrived.
+    bool WaitFor(time_duration timeout) const {
+      DEBUG_ASSERT(_wait != nullptr);
+      return _wait(timeout);
+    }
+
+    /// Blocks until the response arrives and returns its result. Throws if the
+    /// request failed or if the response did not arrive within the networking
+    /// timeout of the client.
+    T Get() {
+      DEBUG_ASSERT(IsValid());
+      auto get = std::move(_get);
+      _get = nullptr;
+      return get();
+    }
+
+    /// Returns a future with the result of @a callback applied to the result
+    /// of this one. The callback is called by Get() of the future returned.
+    template <typename FunctorT>
+    auto Then(FunctorT &&callback) && {
+      using ResultT = std::decay_t<decltype(callback(std::declval<T>()))>;
+      DEBUG_ASSERT(IsValid());
+      auto get = std::move(_get);
+      _get = nullptr;
+      return Future<ResultT>(
+          std::move(_wait),
+          [get=std::move(get), callback=std::forward<FunctorT>(callback)]() mutable {
+            return callback(get());
+          });
+    }
+
+  private:
+
+    WaitFunction _wait;
+
+    GetFunction _get;
+  };
+
+} // namespace client
+} // namespace carla
@@ -6,6 +6,9 @@
 
 #include "carla/client/Map.h"
 
+#include "carla/FileSystem.h"
+#include "carla/Logging.h"
+#include "carla/client/FileTransfer.h"
 #include "carla/client/Junction.h"
 #include "carla/client/Waypoint.h"
 #include "carla/opendrive/OpenDriveParser.h"
@@ -18,9 +21,26 @@
 namespace carla {
 namespace client {
 
+  /// Path of the compiled map of @a opendrive_contents in the cache folder,
+  /// empty if the folder cannot be created.
+  static std::string GetCompiledMapPath(const std::string &opendrive_contents) {
+    auto path = FileTransfer::GetFilePath(
+        "CompiledMaps/" + opendrive::OpenDriveParser::GetCompiledMapName(opendrive_contents));
+    try {
+      FileSystem::ValidateFilePath(path);
+    } catch (const std::exception &e) {
+      log_warning("unable to create the compiled maps folder:", e.what());
+      return {};
+    }
+    return path;
+  }
+
   static auto MakeMap(const std::string &opendrive_contents) {
     auto stream = std::istringstream(opendrive_contents);
-    auto map = opendrive::OpenDriveParser::Load(stream.str());
+    const auto compiled_map_path = GetCompiledMapPath(opendrive_contents);
+    auto map = compiled_map_path.empty() ?
+        opendrive::OpenDriveParser::Load(stream.str()) :
+        opendrive::OpenDriveParser::Load(stream.str(), compiled_map_path);
     if (!map.has_value()) {
       throw_exception(std::runtime_error("failed to generate map"));
     }
@@ -67,6 +87,18 @@ namespace client {
         nullptr;
   }
 
+  SharedPtr<Waypoint> Map::GetWaypointXODR(
+      carla::road::RoadId road_id,
+      carla::road::SectionId section_id,
+      carla::road::LaneId lane_id,
+      double s) const {
+    boost::optional<road::element::Waypoint> waypoint;
+    waypoint = _map.GetWaypoint(road_id, section_id, lane_id, s);
+    return waypoint.has_value() ?
+        SharedPtr<Waypoint>(new Waypoint{shared_from_this(), *waypoint}) :
+        nullptr;
+  }
+
   Map::TopologyList Map::GetTopology() const {
     namespace re = carla::road::element;
     std::unordered_map<re::Waypoint, SharedPtr<Waypoint>> waypoints;
@@ -56,11 +56,26 @@ namespace client {
         bool project_to_road = true,
         int32_t lane_type = static_cast<uint32_t>(road::Lane::LaneType::Driving)) const;
 
+    /// Projects all @a locations at once, see road::Map::ProjectLocations.
+    /// Avoids creating a Waypoint object per location.
+    std::vector<road::Map::WaypointProjection> ProjectLocations(
+        const std::vector<geom::Location> &locations,
+        bool project_to_road = true,
+        int32_t lane_type = static_cast<uint32_t>(road::Lane::LaneType::Driving)) const {
+      return _map.ProjectLocations(locations, project_to_road, lane_type);
+    }
+
     SharedPtr<Waypoint> GetWaypointXODR(
       carla::road::RoadId road_id,
       carla::road::LaneId lane_id,
       float s) const;
 
+    SharedPtr<Waypoint> GetWaypointXODR(
+      carla::road::RoadId road_id,
+      carla::road::SectionId section_id,
+      carla::road::LaneId lane_id,
+      double s) const;
+
     using TopologyList = std::vector<std::pair<SharedPtr<Waypoint>, SharedPtr<Waypoint>>>;
 
     TopologyList GetTopology() const;
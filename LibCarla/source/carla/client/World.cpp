@@ -53,6 +53,10 @@ namespace client {
     return _episode.Lock()->GetEpisodeSettings();
   }
 
+  Future<rpc::EpisodeSettings> World::GetSettingsAsync() const {
+    return _episode.Lock()->GetEpisodeSettingsAsync();
+  }
+
   uint64_t World::ApplySettings(const rpc::EpisodeSettings &settings, time_duration timeout) {
     rpc::EpisodeSettings new_settings = settings;
     uint64_t id = _episode.Lock()->SetEpisodeSettings(settings);
@@ -115,6 +119,19 @@ namespace client {
                                   _episode.Lock()->GetActorsById(actor_ids)}};
   }
 
+  rpc::ActorColumns World::GetActorsState(
+      const std::vector<ActorId> &actor_ids,
+      rpc::ActorFieldType fields) const {
+    return _episode.Lock()->GetActorsState(actor_ids, fields);
+  }
+
+  Future<SharedPtr<ActorList>> World::GetActorsAsync(const std::vector<ActorId> &actor_ids) const {
+    return _episode.Lock()->GetActorsByIdAsync(actor_ids).Then(
+        [episode=_episode](std::vector<rpc::Actor> actors) {
+          return SharedPtr<ActorList>{new ActorList{episode, std::move(actors)}};
+        });
+  }
+
   SharedPtr<Actor> World::SpawnActor(
       const ActorBlueprint &blueprint,
       const geom::Transform &transform,
@@ -123,6 +140,14 @@ namespace client {
     return _episode.Lock()->SpawnActor(blueprint, transform, parent_actor, attachment_type);
   }
 
+  Future<SharedPtr<Actor>> World::SpawnActorAsync(
+      const ActorBlueprint &blueprint,
+      const geom::Transform &transform,
+      Actor *parent_actor,
+      rpc::AttachmentType attachment_type) {
+    return _episode.Lock()->SpawnActorAsync(blueprint, transform, parent_actor, attachment_type);
+  }
+
   SharedPtr<Actor> World::TrySpawnActor(
       const ActorBlueprint &blueprint,
       const geom::Transform &transform,
@@ -164,6 +189,10 @@ namespace client {
     _episode.Lock()->SetPedestriansSeed(seed);
   }
 
+  nav::RoutePlannerStatistics World::GetPedestriansRouteStatistics() const {
+    return _episode.Lock()->GetPedestriansRouteStatistics();
+  }
+
   SharedPtr<Actor> World::GetTrafficSign(const Landmark& landmark) const {
     SharedPtr<ActorList> actors = GetActors();
     SharedPtr<TrafficSign> result;
@@ -9,6 +9,7 @@
 #include "carla/Memory.h"
 #include "carla/Time.h"
 #include "carla/client/DebugHelper.h"
+#include "carla/client/Future.h"
 #include "carla/client/Landmark.h"
 #include "carla/client/Waypoint.h"
 #include "carla/client/Junction.h"
@@ -17,7 +18,9 @@
 #include "carla/client/WorldSnapshot.h"
 #include "carla/client/detail/EpisodeProxy.h"
 #include "carla/geom/Transform.h"
+#include "carla/nav/RoutePlannerStatistics.h"
 #include "carla/rpc/Actor.h"
+#include "carla/rpc/ActorColumns.h"
 #include "carla/rpc/AttachmentType.h"
 #include "carla/rpc/EpisodeSettings.h"
 #include "carla/rpc/EnvironmentObject.h"
@@ -84,6 +87,9 @@ namespace client {
 
     rpc::EpisodeSettings GetSettings() const;
 
+    /// Same as GetSettings, but it returns without waiting for the response.
+    Future<rpc::EpisodeSettings> GetSettingsAsync() const;
+
     /// @return The id of the frame when the settings were applied.
     uint64_t ApplySettings(const rpc::EpisodeSettings &settings, time_duration timeout);
 
@@ -105,6 +111,16 @@ namespace client {
     /// Return a list with the actors requested by ActorId.
     SharedPtr<ActorList> GetActors(const std::vector<ActorId> &actor_ids) const;
 
+    /// Same as GetActors, but it returns without waiting for the response.
+    Future<SharedPtr<ActorList>> GetActorsAsync(const std::vector<ActorId> &actor_ids) const;
+
+    /// Return the given @a fields, a combination of rpc::ActorField flags, of
+    /// the actors requested by ActorId, one column per field. It makes at
+    /// most one call to the server.
+    rpc::ActorColumns GetActorsState(
+        const std::vector<ActorId> &actor_ids,
+        rpc::ActorFieldType fields) const;
+
     /// Spawn an actor into the world based on the @a blueprint provided at @a
     /// transform. If a @a parent is provided, the actor is attached to
     /// @a parent.
@@ -122,6 +138,15 @@ namespace client {
         Actor *parent = nullptr,
         rpc::AttachmentType attachment_type = rpc::AttachmentType::Rigid) noexcept;
 
+    /// Same as SpawnActor, but it returns as soon as the request is sent, so
+    /// many actors can be spawned without waiting a round trip for each one.
+    /// The errors are thrown when reading the result of the future.
+    Future<SharedPtr<Actor>> SpawnActorAsync(
+        const ActorBlueprint &blueprint,
+        const geom::Transform &transform,
+        Actor *parent = nullptr,
+        rpc::AttachmentType attachment_type = rpc::AttachmentType::Rigid);
+
     /// Block calling thread until a world tick is received.
     WorldSnapshot WaitForTick(time_duration timeout) const;
 
@@ -148,6 +173,10 @@ namespace client {
     /// set the seed to use with random numbers in the pedestrians module
     void SetPedestriansSeed(unsigned int seed);
 
+    /// return the queue length and latencies of the pedestrian routes computed
+    /// in the background
+    nav::RoutePlannerStatistics GetPedestriansRouteStatistics() const;
+
     SharedPtr<Actor> GetTrafficSign(const Landmark& landmark) const;
 
     SharedPtr<Actor> GetTrafficLight(const Landmark& landmark) const;
@@ -45,6 +45,18 @@ namespace client {
       return _state->GetActorSnapshotIfPresent(actor_id);
     }
 
+    /// Return the ids of the actors present in this WorldSnapshot, sorted.
+    auto GetActorIds() const {
+      return _state->GetActorIds();
+    }
+
+    /// Check if this WorldSnapshot has the same actors as @a rhs. Snapshots of
+    /// consecutive frames without actors spawned or destroyed are compared in
+    /// constant time.
+    bool HasSameActors(const WorldSnapshot &rhs) const {
+      return _state->HasSameActors(*rhs._state);
+    }
+
     /// Return number of ActorSnapshots present in this WorldSnapshot.
     size_t size() const {
       return _state->size();
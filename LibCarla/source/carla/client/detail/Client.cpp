@@ -26,6 +26,7 @@
 
 #include <rpc/rpc_error.h>
 
+#include <future>
 #include <thread>
 
 namespace carla {
@@ -77,6 +78,30 @@ namespace detail {
       return Get(response);
     }
 
+    /// Sends the call and returns without waiting for the response, that is
+    /// read by the future returned. The networking timeout starts when the
+    /// response is requested.
+    template <typename T, typename ... Args>
+    Future<T> CallAsync(const std::string &function, Args && ... args) {
+      auto future = std::make_shared<std::future<clmdep_msgpack::object_handle>>(
+          rpc_client.async_call_with_response(function, std::forward<Args>(args) ...));
+      return Future<T>(
+          [future](time_duration timeout) {
+            return future->wait_for(timeout.to_chrono()) == std::future_status::ready;
+          },
+          [future, endpoint=endpoint, timeout=GetTimeout()]() {
+            if (future->wait_for(timeout.to_chrono()) != std::future_status::ready) {
+              throw_exception(TimeoutException(endpoint, timeout));
+            }
+            using R = typename carla::rpc::Response<T>;
+            auto response = future->get().template as<R>();
+            if (response.HasError()) {
+              throw_exception(std::runtime_error(response.GetError().What()));
+            }
+            return Get(response);
+          });
+    }
+
     template <typename ... Args>
     void AsyncCall(const std::string &function, Args && ... args) {
       // Discard returned future.
@@ -186,6 +211,19 @@ namespace detail {
     return _pimpl->CallAndWait<rpc::EpisodeInfo>("get_episode_info");
   }
 
+  boost::optional<rpc::EpisodeInfo> Client::GetEpisodeDeltaInfo() {
+    try {
+      return _pimpl->CallAndWait<rpc::EpisodeInfo>("get_episode_delta_info");
+    } catch (const ::rpc::rpc_error &) {
+      // The server is older than this client and has no delta stream.
+      return boost::none;
+    }
+  }
+
+  void Client::RequestEpisodeKeyFrame() {
+    _pimpl->AsyncCall("get_episode_delta_info");
+  }
+
   rpc::MapInfo Client::GetMapInfo() {
     return _pimpl->CallAndWait<rpc::MapInfo>("get_map_info");
   }
@@ -255,6 +293,10 @@ namespace detail {
     return _pimpl->CallAndWait<rpc::EpisodeSettings>("get_episode_settings");
   }
 
+  Future<rpc::EpisodeSettings> Client::GetEpisodeSettingsAsync() {
+    return _pimpl->CallAsync<rpc::EpisodeSettings>("get_episode_settings");
+  }
+
   uint64_t Client::SetEpisodeSettings(const rpc::EpisodeSettings &settings) {
     return _pimpl->CallAndWait<uint64_t>("set_episode_settings", settings);
   }
@@ -273,6 +315,18 @@ namespace detail {
     return _pimpl->CallAndWait<return_t>("get_actors_by_id", ids);
   }
 
+  Future<std::vector<rpc::Actor>> Client::GetActorsByIdAsync(
+      const std::vector<ActorId> &ids) {
+    using return_t = std::vector<rpc::Actor>;
+    return _pimpl->CallAsync<return_t>("get_actors_by_id", ids);
+  }
+
+  rpc::ActorColumns Client::GetActorsState(
+      const std::vector<ActorId> &ids,
+      rpc::ActorFieldType fields) {
+    return _pimpl->CallAndWait<rpc::ActorColumns>("get_actors_state", ids, fields);
+  }
+
   rpc::VehiclePhysicsControl Client::GetVehiclePhysicsControl(
       rpc::ActorId vehicle) const {
     return _pimpl->CallAndWait<carla::rpc::VehiclePhysicsControl>("get_physics_control", vehicle);
@@ -326,24 +380,34 @@ namespace detail {
     return _pimpl->CallAndWait<rpc::Actor>("spawn_actor", description, transform);
   }
 
-  rpc::Actor Client::SpawnActorWithParent(
+  Future<rpc::Actor> Client::SpawnActorAsync(
       const rpc::ActorDescription &description,
+      const geom::Transform &transform) {
+    return _pimpl->CallAsync<rpc::Actor>("spawn_actor", description, transform);
+  }
+
+  static void WarnAboutIllFormedAttachment(
       const geom::Transform &transform,
-      rpc::ActorId parent,
       rpc::AttachmentType attachment_type) {
-
-      if (attachment_type == rpc::AttachmentType::SpringArm ||
-          attachment_type == rpc::AttachmentType::SpringArmGhost)
-      {
-        const auto a = transform.location.MakeSafeUnitVector(std::numeric_limits<float>::epsilon());
-        const auto z = geom::Vector3D(0.0f, 0.f, 1.0f);
-        constexpr float OneEps = 1.0f - std::numeric_limits<float>::epsilon();
-        if (geom::Math::Dot(a, z) > OneEps) {
-          std::cout << "WARNING: Transformations with translation only in the 'z' axis are ill-formed when \
+    if (attachment_type == rpc::AttachmentType::SpringArm ||
+        attachment_type == rpc::AttachmentType::SpringArmGhost)
+    {
+      const auto a = transform.location.MakeSafeUnitVector(std::numeric_limits<float>::epsilon());
+      const auto z = geom::Vector3D(0.0f, 0.f, 1.0f);
+      constexpr float OneEps = 1.0f - std::numeric_limits<float>::epsilon();
+      if (geom::Math::Dot(a, z) > OneEps) {
+        std::cout << "WARNING: Transformations with translation only in the 'z' axis are ill-formed when \
             using SpringArm or SpringArmGhost attachment. Please, be careful with that." << std::endl;
-        }
       }
+    }
+  }
 
+  rpc::Actor Client::SpawnActorWithParent(
+      const rpc::ActorDescription &description,
+      const geom::Transform &transform,
+      rpc::ActorId parent,
+      rpc::AttachmentType attachment_type) {
+    WarnAboutIllFormedAttachment(transform, attachment_type);
     return _pimpl->CallAndWait<rpc::Actor>("spawn_actor_with_parent",
         description,
         transform,
@@ -351,6 +415,19 @@ namespace detail {
         attachment_type);
   }
 
+  Future<rpc::Actor> Client::SpawnActorWithParentAsync(
+      const rpc::ActorDescription &description,
+      const geom::Transform &transform,
+      rpc::ActorId parent,
+      rpc::AttachmentType attachment_type) {
+    WarnAboutIllFormedAttachment(transform, attachment_type);
+    return _pimpl->CallAsync<rpc::Actor>("spawn_actor_with_parent",
+        description,
+        transform,
+        parent,
+        attachment_type);
+  }
+
   bool Client::DestroyActor(rpc::ActorId actor) {
     try {
       return _pimpl->CallAndWait<bool>("destroy_actor", actor);
@@ -544,8 +621,8 @@ namespace detail {
     return _pimpl->CallAndWait<return_t>("get_group_traffic_lights", traffic_light);
   }
 
-  std::string Client::StartRecorder(std::string name, bool additional_data) {
-    return _pimpl->CallAndWait<std::string>("start_recorder", name, additional_data);
+  std::string Client::StartRecorder(std::string name, bool additional_data, bool compressed) {
+    return _pimpl->CallAndWait<std::string>("start_recorder", name, additional_data, compressed);
   }
 
   void Client::StopRecorder() {
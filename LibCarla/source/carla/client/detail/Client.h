@@ -9,9 +9,11 @@
 #include "carla/Memory.h"
 #include "carla/NonCopyable.h"
 #include "carla/Time.h"
+#include "carla/client/Future.h"
 #include "carla/geom/Transform.h"
 #include "carla/geom/Location.h"
 #include "carla/rpc/Actor.h"
+#include "carla/rpc/ActorColumns.h"
 #include "carla/rpc/ActorDefinition.h"
 #include "carla/rpc/AttachmentType.h"
 #include "carla/rpc/Command.h"
@@ -34,6 +36,8 @@
 #include "carla/rpc/Texture.h"
 #include "carla/rpc/MaterialParameter.h"
 
+#include <boost/optional.hpp>
+
 #include <functional>
 #include <memory>
 #include <string>
@@ -121,6 +125,13 @@ namespace detail {
 
     rpc::EpisodeInfo GetEpisodeInfo();
 
+    /// Returns the episode info with the token of the delta stream, or none if
+    /// the server does not support it.
+    boost::optional<rpc::EpisodeInfo> GetEpisodeDeltaInfo();
+
+    /// Asks the server to send a key frame through the delta stream.
+    void RequestEpisodeKeyFrame();
+
     rpc::MapInfo GetMapInfo();
 
     std::vector<uint8_t> GetNavigationMesh() const;
@@ -143,6 +154,8 @@ namespace detail {
 
     rpc::EpisodeSettings GetEpisodeSettings();
 
+    Future<rpc::EpisodeSettings> GetEpisodeSettingsAsync();
+
     uint64_t SetEpisodeSettings(const rpc::EpisodeSettings &settings);
 
     rpc::WeatherParameters GetWeatherParameters();
@@ -151,6 +164,13 @@ namespace detail {
 
     std::vector<rpc::Actor> GetActorsById(const std::vector<ActorId> &ids);
 
+    Future<std::vector<rpc::Actor>> GetActorsByIdAsync(const std::vector<ActorId> &ids);
+
+    /// Fields of the server (rpc::ServerActorFields) of several actors.
+    rpc::ActorColumns GetActorsState(
+        const std::vector<ActorId> &ids,
+        rpc::ActorFieldType fields);
+
     rpc::VehiclePhysicsControl GetVehiclePhysicsControl(rpc::ActorId vehicle) const;
 
     rpc::VehicleLightState GetVehicleLightState(rpc::ActorId vehicle) const;
@@ -175,12 +195,24 @@ namespace detail {
         const rpc::ActorDescription &description,
         const geom::Transform &transform);
 
+    /// Same as SpawnActor, but it does not wait for the response. Many
+    /// requests can be in flight at the same time.
+    Future<rpc::Actor> SpawnActorAsync(
+        const rpc::ActorDescription &description,
+        const geom::Transform &transform);
+
     rpc::Actor SpawnActorWithParent(
         const rpc::ActorDescription &description,
         const geom::Transform &transform,
         rpc::ActorId parent,
         rpc::AttachmentType attachment_type);
 
+    Future<rpc::Actor> SpawnActorWithParentAsync(
+        const rpc::ActorDescription &description,
+        const geom::Transform &transform,
+        rpc::ActorId parent,
+        rpc::AttachmentType attachment_type);
+
     bool DestroyActor(rpc::ActorId actor);
 
     void SetActorLocation(
@@ -352,7 +384,7 @@ namespace detail {
     std::vector<ActorId> GetGroupTrafficLights(
         rpc::ActorId traffic_light);
 
-    std::string StartRecorder(std::string name, bool additional_data);
+    std::string StartRecorder(std::string name, bool additional_data, bool compressed);
 
     void StopRecorder();
 
@@ -10,8 +10,10 @@
 #include "carla/client/detail/Client.h"
 #include "carla/client/detail/WalkerNavigation.h"
 #include "carla/sensor/Deserializer.h"
+#include "carla/sensor/s11n/EpisodeStateDeltaSerializer.h"
 #include "carla/trafficmanager/TrafficManager.h"
 
+#include <atomic>
 #include <exception>
 
 namespace carla {
@@ -45,21 +47,55 @@ using namespace std::chrono_literals;
 
   Episode::~Episode() {
     try {
-      _client.UnSubscribeFromStream(_token);
+      _client.UnSubscribeFromStream(GetActiveToken());
     } catch (const std::exception &e) {
       log_error("exception trying to disconnect from episode:", e.what());
     }
   }
 
   void Episode::Listen() {
+    std::lock_guard<std::mutex> lock(_stream_mutex);
+    Subscribe(_state_deltas);
+  }
+
+  bool Episode::SetStateDeltasEnabled(const bool enabled) {
+    std::lock_guard<std::mutex> lock(_stream_mutex);
+    if (enabled == _state_deltas) {
+      return true;
+    }
+    if (enabled && !_delta_token.has_value()) {
+      auto info = _client.GetEpisodeDeltaInfo();
+      if (!info.has_value()) {
+        log_warning("the server does not support episode state deltas, using full states");
+        return false;
+      }
+      _delta_token = info->token;
+    }
+    _client.UnSubscribeFromStream(GetActiveToken());
+    _state_deltas = enabled;
+    Subscribe(enabled);
+    return true;
+  }
+
+  void Episode::Subscribe(const bool deltas) {
     std::weak_ptr<Episode> weak = shared_from_this();
-    _client.SubscribeToStream(_token, [weak](auto buffer) {
+    _client.SubscribeToStream(GetActiveToken(), [weak, deltas](auto buffer) {
       auto self = weak.lock();
       if (self != nullptr) {
 
-        auto data = sensor::Deserializer::Deserialize(std::move(buffer));
-        auto next = std::make_shared<const EpisodeState>(CastData(*data));
+        std::shared_ptr<const EpisodeState> next;
         auto prev = self->GetState();
+        if (deltas) {
+          next = self->ApplyStateDelta(buffer);
+          if (next == nullptr) {
+            return;
+          }
+        } else {
+          auto data = sensor::Deserializer::Deserialize(std::move(buffer));
+          auto state = self->AcquireState();
+          state->Assign(CastData(*data), prev.get());
+          next = std::move(state);
+        }
 
         // TODO: Update how the map change is detected
         bool HasMapChanged = next->HasMapChanged();
@@ -110,6 +146,58 @@ using namespace std::chrono_literals;
     });
   }
 
+  std::shared_ptr<const EpisodeState> Episode::ApplyStateDelta(const Buffer &buffer) {
+    using Serializer = sensor::s11n::EpisodeStateDeltaSerializer;
+    Serializer::Message message;
+    if (!Serializer::Deserialize(buffer, message)) {
+      log_warning("received an invalid episode state delta");
+      return nullptr;
+    }
+    std::lock_guard<std::mutex> lock(_delta_mutex);
+    if (message.IsKeyFrame()) {
+      auto state = AcquireState();
+      state->Assign(message, nullptr);
+      _delta_state = std::move(state);
+      _waiting_key_frame = false;
+    } else if (
+        _delta_state != nullptr &&
+        _delta_state->GetEpisodeId() == message.header->episode_id &&
+        _delta_state->GetFrame() == message.delta_header->base_frame) {
+      auto state = AcquireState();
+      state->Assign(message, _delta_state.get());
+      _delta_state = std::move(state);
+    } else {
+      // We missed the frame this delta is based on, drop everything until the
+      // next key frame.
+      if (!_waiting_key_frame) {
+        _waiting_key_frame = true;
+        _client.RequestEpisodeKeyFrame();
+      }
+      _delta_state = nullptr;
+    }
+    return _delta_state;
+  }
+
+  std::shared_ptr<EpisodeState> Episode::AcquireState() {
+    std::lock_guard<std::mutex> lock(_state_pool_mutex);
+    for (auto &state : _state_pool) {
+      if (state == nullptr) {
+        state = std::make_shared<EpisodeState>(0u);
+        return state;
+      }
+      // Only the pool references it, nobody can be reading it.
+      if (state.use_count() == 1) {
+        // use_count() is a relaxed read. The last holder released its
+        // reference with a release decrement, this fence makes its reads of
+        // the state happen before the writes of the next Assign.
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return state;
+      }
+    }
+    // Every state of the pool is still in use, e.g. held by user snapshots.
+    return std::make_shared<EpisodeState>(0u);
+  }
+
   boost::optional<rpc::Actor> Episode::GetActorById(ActorId id) {
     auto actor = _actors.GetActorById(id);
     if (!actor.has_value()) {
@@ -126,6 +214,18 @@ using namespace std::chrono_literals;
     return GetActorsById_Impl(_client, _actors, actor_ids);
   }
 
+  Future<std::vector<rpc::Actor>> Episode::GetActorsByIdAsync(const std::vector<ActorId> &actor_ids) {
+    auto missing_ids = _actors.GetMissingIds(actor_ids);
+    if (missing_ids.empty()) {
+      return Future<std::vector<rpc::Actor>>::MakeReady(_actors.GetActorsById(actor_ids));
+    }
+    return _client.GetActorsByIdAsync(missing_ids).Then(
+        [self=shared_from_this(), actor_ids](std::vector<rpc::Actor> actors) {
+          self->_actors.InsertRange(std::move(actors));
+          return self->_actors.GetActorsById(actor_ids);
+        });
+  }
+
   std::vector<rpc::Actor> Episode::GetActors() {
     return GetActorsById_Impl(_client, _actors, GetState()->GetActorIds());
   }
@@ -7,8 +7,10 @@
 #pragma once
 
 #include "carla/AtomicSharedPtr.h"
+#include "carla/Buffer.h"
 #include "carla/NonCopyable.h"
 #include "carla/RecurrentSharedFuture.h"
+#include "carla/client/Future.h"
 #include "carla/client/Timestamp.h"
 #include "carla/client/WorldSnapshot.h"
 #include "carla/client/detail/CachedActorList.h"
@@ -17,6 +19,10 @@
 #include "carla/client/detail/EpisodeProxy.h"
 #include "carla/rpc/EpisodeInfo.h"
 
+#include <boost/optional.hpp>
+
+#include <array>
+#include <mutex>
 #include <vector>
 
 namespace carla {
@@ -42,6 +48,11 @@ namespace detail {
 
     void Listen();
 
+    /// Switch between receiving the full episode state every tick and
+    /// receiving only the actors that changed. Returns false if the server
+    /// does not support deltas.
+    bool SetStateDeltasEnabled(bool enabled);
+
     auto GetId() const {
       return GetState()->GetEpisodeId();
     }
@@ -58,6 +69,10 @@ namespace detail {
 
     std::vector<rpc::Actor> GetActorsById(const std::vector<ActorId> &actor_ids);
 
+    /// Same as GetActorsById, but only the actors not yet cached are
+    /// requested, and without waiting for the response.
+    Future<std::vector<rpc::Actor>> GetActorsByIdAsync(const std::vector<ActorId> &actor_ids);
+
     std::vector<rpc::Actor> GetActors();
 
     boost::optional<WorldSnapshot> WaitForState(time_duration timeout) {
@@ -105,6 +120,21 @@ namespace detail {
 
     Episode(Client &client, const rpc::EpisodeInfo &info, std::weak_ptr<Simulator> simulator);
 
+    /// @pre _stream_mutex is locked.
+    void Subscribe(bool deltas);
+
+    const streaming::Token &GetActiveToken() const {
+      return _state_deltas ? *_delta_token : _token;
+    }
+
+    /// Returns a state whose memory can be overwritten with a new frame,
+    /// recycling the states of the pool no longer referenced elsewhere.
+    std::shared_ptr<EpisodeState> AcquireState();
+
+    /// Returns the state resulting of applying @a buffer, or nullptr if it
+    /// cannot be applied yet.
+    std::shared_ptr<const EpisodeState> ApplyStateDelta(const Buffer &buffer);
+
     void OnEpisodeStarted();
 
     void OnEpisodeChanged();
@@ -129,6 +159,25 @@ namespace detail {
 
     const streaming::Token _token;
 
+    boost::optional<streaming::Token> _delta_token;
+
+    bool _state_deltas = false;
+
+    std::mutex _stream_mutex;
+
+    std::mutex _delta_mutex;
+
+    /// Last state reconstructed from the delta stream.
+    std::shared_ptr<const EpisodeState> _delta_state;
+
+    bool _waiting_key_frame = false;
+
+    std::mutex _state_pool_mutex;
+
+    /// States reused to publish new frames, one is usually the current state,
+    /// another the one being filled, and a third may be held by a callback.
+    std::array<std::shared_ptr<EpisodeState>, 3u> _state_pool;
+
     bool _pending_exceptions = false;
 
     bool _should_update_map = true;
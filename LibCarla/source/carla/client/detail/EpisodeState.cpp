@@ -6,34 +6,167 @@
 
 #include "carla/client/detail/EpisodeState.h"
 
+#include <algorithm>
+#include <numeric>
+
 namespace carla {
 namespace client {
 namespace detail {
 
-  EpisodeState::EpisodeState(const sensor::data::RawEpisodeState &state)
-    : _episode_id(state.GetEpisodeId()),
-      _timestamp(
-          state.GetFrame(),
-          state.GetGameTimeStamp(),
-          state.GetDeltaSeconds(),
-          state.GetPlatformTimeStamp()),
-      _map_origin(state.GetMapOrigin()),
-      _simulation_state(state.GetSimulationState()) {
-    _actors.reserve(state.size());
-    for (auto &&actor : state) {
+  static ActorSnapshot MakeActorSnapshot(const sensor::data::ActorDynamicState &actor) {
+    return ActorSnapshot{
+        actor.id,
+        actor.actor_state,
+        actor.transform,
+        actor.velocity,
+        actor.angular_velocity,
+        actor.acceleration,
+        actor.state};
+  }
+
+  EpisodeState::EpisodeState(const sensor::data::RawEpisodeState &state) {
+    Assign(state, nullptr);
+  }
+
+  EpisodeState::EpisodeState(const DeltaMessage &message, const EpisodeState *base) {
+    Assign(message, base);
+  }
+
+  const std::vector<ActorId> &EpisodeState::GetSortedIds() const {
+    static const std::vector<ActorId> empty;
+    return _index != nullptr ? _index->ids : empty;
+  }
+
+  std::shared_ptr<const EpisodeState::ActorIndex> EpisodeState::MakeIndex(
+      std::vector<ActorId> received_ids) {
+    auto index = std::make_shared<ActorIndex>();
+    const auto size = received_ids.size();
+
+    std::vector<uint32_t> order(size);
+    std::iota(order.begin(), order.end(), 0u);
+    std::sort(order.begin(), order.end(), [&](uint32_t lhs, uint32_t rhs) {
+      return received_ids[lhs] < received_ids[rhs];
+    });
+
+    index->positions.resize(size);
+    index->ids.resize(size);
+    index->table.reserve(size);
+    for (uint32_t position = 0u; position < size; ++position) {
+      const uint32_t received = order[position];
+      index->positions[received] = position;
+      index->ids[position] = received_ids[received];
       DEBUG_ONLY(auto result = )
-      _actors.emplace(
-          actor.id,
-          ActorSnapshot{
-              actor.id,
-              actor.actor_state,
-              actor.transform,
-              actor.velocity,
-              actor.angular_velocity,
-              actor.acceleration,
-              actor.state});
+      index->table.emplace(received_ids[received], position);
       DEBUG_ASSERT(result.second);
     }
+    index->received_ids = std::move(received_ids);
+    return index;
+  }
+
+  void EpisodeState::Assign(
+      const sensor::data::RawEpisodeState &state,
+      const EpisodeState *previous) {
+    _episode_id = state.GetEpisodeId();
+    _timestamp = Timestamp(
+        state.GetFrame(),
+        state.GetGameTimeStamp(),
+        state.GetDeltaSeconds(),
+        state.GetPlatformTimeStamp());
+    _map_origin = state.GetMapOrigin();
+    _simulation_state = state.GetSimulationState();
+
+    // Most ticks the server sends the same actors in the same order, in that
+    // case the index of the previous state is still valid.
+    _index = previous != nullptr ? previous->_index : nullptr;
+    bool same_actors = _index != nullptr && _index->received_ids.size() == state.size();
+    for (size_t i = 0u; same_actors && i < state.size(); ++i) {
+      same_actors = _index->received_ids[i] == state[i].id;
+    }
+    if (!same_actors) {
+      std::vector<ActorId> received_ids;
+      received_ids.reserve(state.size());
+      for (auto &&actor : state) {
+        received_ids.emplace_back(actor.id);
+      }
+      _index = MakeIndex(std::move(received_ids));
+    }
+
+    _actors.resize(state.size());
+    for (size_t i = 0u; i < state.size(); ++i) {
+      _actors[_index->positions[i]] = MakeActorSnapshot(state[i]);
+    }
+  }
+
+  void EpisodeState::Assign(const DeltaMessage &message, const EpisodeState *base) {
+    _episode_id = message.header->episode_id;
+    _timestamp = Timestamp(
+        message.frame,
+        message.timestamp,
+        message.header->delta_seconds,
+        message.header->platform_timestamp);
+    _map_origin = message.header->map_origin;
+    _simulation_state = message.header->simulation_state;
+
+    const auto &delta_header = *message.delta_header;
+    const auto *updated = message.updated;
+
+    if (message.IsKeyFrame()) {
+      std::vector<ActorId> received_ids;
+      received_ids.reserve(delta_header.updated_count);
+      for (auto i = 0u; i < delta_header.updated_count; ++i) {
+        received_ids.emplace_back(updated[i].id);
+      }
+      _index = MakeIndex(std::move(received_ids));
+      _actors.resize(delta_header.updated_count);
+      for (auto i = 0u; i < delta_header.updated_count; ++i) {
+        _actors[_index->positions[i]] = MakeActorSnapshot(updated[i]);
+      }
+      return;
+    }
+
+    DEBUG_ASSERT(base != nullptr);
+    bool same_actors = delta_header.removed_count == 0u;
+    for (auto i = 0u; same_actors && i < delta_header.updated_count; ++i) {
+      same_actors = base->ContainsActorSnapshot(updated[i].id);
+    }
+
+    if (same_actors) {
+      _index = base->_index;
+      _actors.assign(base->_actors.begin(), base->_actors.end());
+    } else {
+      // Actors were added or removed, rebuild the index from the surviving
+      // actors of the base followed by the new ones.
+      std::vector<ActorId> removed_ids(delta_header.removed_count);
+      for (auto i = 0u; i < delta_header.removed_count; ++i) {
+        removed_ids[i] = message.GetRemovedId(i);
+      }
+      std::sort(removed_ids.begin(), removed_ids.end());
+
+      std::vector<ActorId> received_ids;
+      received_ids.reserve(delta_header.actor_count);
+      for (const auto &actor : base->_actors) {
+        if (!std::binary_search(removed_ids.begin(), removed_ids.end(), actor.id)) {
+          received_ids.emplace_back(actor.id);
+        }
+      }
+      const size_t number_of_survivors = received_ids.size();
+      for (auto i = 0u; i < delta_header.updated_count; ++i) {
+        if (!base->ContainsActorSnapshot(updated[i].id)) {
+          received_ids.emplace_back(updated[i].id);
+        }
+      }
+      _index = MakeIndex(std::move(received_ids));
+      _actors.resize(_index->ids.size());
+      for (size_t i = 0u; i < number_of_survivors; ++i) {
+        const ActorId id = _index->received_ids[i];
+        _actors[_index->positions[i]] = *base->FindActorSnapshot(id);
+      }
+    }
+
+    for (auto i = 0u; i < delta_header.updated_count; ++i) {
+      _actors[_index->table.at(updated[i].id)] = MakeActorSnapshot(updated[i]);
+    }
+    DEBUG_ASSERT(_actors.size() == delta_header.actor_count);
   }
 
 } // namespace detail
@@ -6,36 +6,57 @@
 
 #pragma once
 
-#include "carla/Iterator.h"
 #include "carla/ListView.h"
 #include "carla/NonCopyable.h"
 #include "carla/client/ActorSnapshot.h"
 #include "carla/client/Timestamp.h"
 #include "carla/geom/Vector3DInt.h"
 #include "carla/sensor/data/RawEpisodeState.h"
+#include "carla/sensor/s11n/EpisodeStateDeltaSerializer.h"
 
 #include <boost/optional.hpp>
 
 #include <memory>
 #include <unordered_map>
+#include <vector>
 
 namespace carla {
 namespace client {
 namespace detail {
 
   /// Represents the state of all the actors of an episode at a given frame.
+  ///
+  /// Snapshots are stored in a flat array sorted by actor id. The lookup
+  /// table from id to position is shared between consecutive states as long
+  /// as the set of actors does not change, and the arrays of a state can be
+  /// refilled with Assign to publish new frames without allocating.
   class EpisodeState
     : public std::enable_shared_from_this<EpisodeState>,
       private NonCopyable {
 
       using SimulationState = sensor::s11n::EpisodeStateSerializer::SimulationState;
 
+      using DeltaMessage = sensor::s11n::EpisodeStateDeltaSerializer::Message;
+
   public:
 
     explicit EpisodeState(uint64_t episode_id) : _episode_id(episode_id) {}
 
     explicit EpisodeState(const sensor::data::RawEpisodeState &state);
 
+    /// Builds the state from a message of the delta stream. Key frames are
+    /// applied on their own, deltas on top of @a base, which must be the state
+    /// of the frame the delta is based on.
+    EpisodeState(const DeltaMessage &message, const EpisodeState *base);
+
+    /// Replaces the contents of this state with @a state, reusing the actor
+    /// index of @a previous if it has the same actors.
+    void Assign(const sensor::data::RawEpisodeState &state, const EpisodeState *previous);
+
+    /// Replaces the contents of this state with @a message applied on top of
+    /// @a base.
+    void Assign(const DeltaMessage &message, const EpisodeState *base);
+
     auto GetEpisodeId() const {
       return _episode_id;
     }
@@ -61,7 +82,7 @@ namespace detail {
     }
 
     bool ContainsActorSnapshot(ActorId actor_id) const {
-      return _actors.find(actor_id) != _actors.end();
+      return FindActorSnapshot(actor_id) != nullptr;
     }
 
     ActorSnapshot GetActorSnapshot(ActorId id) const {
@@ -76,10 +97,24 @@ namespace detail {
       return state;
     }
 
+    /// Returns a pointer to the snapshot of @a id, or nullptr if not present.
+    const ActorSnapshot *FindActorSnapshot(ActorId id) const {
+      if (_index == nullptr) {
+        return nullptr;
+      }
+      auto it = _index->table.find(id);
+      return it != _index->table.end() ? &_actors[it->second] : nullptr;
+    }
+
     auto GetActorIds() const {
-      return MakeListView(
-          iterator::make_map_keys_const_iterator(_actors.begin()),
-          iterator::make_map_keys_const_iterator(_actors.end()));
+      return MakeListView(GetSortedIds().begin(), GetSortedIds().end());
+    }
+
+    /// Whether @a other has the same actors as this state. Consecutive states
+    /// share their index while no actor is spawned or destroyed, in that case
+    /// this takes constant time.
+    bool HasSameActors(const EpisodeState &other) const {
+      return (_index == other._index) || (GetSortedIds() == other.GetSortedIds());
     }
 
     size_t size() const {
@@ -87,32 +122,52 @@ namespace detail {
     }
 
     auto begin() const {
-      return iterator::make_map_values_const_iterator(_actors.begin());
+      return _actors.begin();
     }
 
     auto end() const {
-      return iterator::make_map_values_const_iterator(_actors.end());
+      return _actors.end();
     }
 
   private:
 
+    /// Lookup table of a set of actors, immutable once built.
+    struct ActorIndex {
+      /// Actor ids in the order they were received.
+      std::vector<ActorId> received_ids;
+      /// Position in the sorted arrays of each received actor.
+      std::vector<uint32_t> positions;
+      /// Actor ids sorted.
+      std::vector<ActorId> ids;
+      /// Position in the sorted arrays of each actor.
+      std::unordered_map<ActorId, uint32_t> table;
+    };
+
+    const std::vector<ActorId> &GetSortedIds() const;
+
+    /// Builds the index of the actors received in @a received_ids order.
+    static std::shared_ptr<const ActorIndex> MakeIndex(std::vector<ActorId> received_ids);
+
     template <typename T>
     void CopyActorSnapshotIfPresent(ActorId id, T &value) const {
-      auto it = _actors.find(id);
-      if (it != _actors.end()) {
-        value = it->second;
+      const ActorSnapshot *snapshot = FindActorSnapshot(id);
+      if (snapshot != nullptr) {
+        value = *snapshot;
       }
     }
 
-    const uint64_t _episode_id;
+    uint64_t _episode_id;
 
-    const Timestamp _timestamp;
+    Timestamp _timestamp;
 
     geom::Vector3DInt _map_origin;
 
     SimulationState _simulation_state;
 
-    std::unordered_map<ActorId, ActorSnapshot> _actors;
+    std::shared_ptr<const ActorIndex> _index;
+
+    /// Snapshots sorted by actor id.
+    std::vector<ActorSnapshot> _actors;
   };
 
 } // namespace detail
@@ -10,6 +10,7 @@
 #include "carla/Exception.h"
 #include "carla/Logging.h"
 #include "carla/RecurrentSharedFuture.h"
+#include "carla/StringUtil.h"
 #include "carla/client/BlueprintLibrary.h"
 #include "carla/client/FileTransfer.h"
 #include "carla/client/Map.h"
@@ -23,6 +24,7 @@
 
 #include <exception>
 #include <thread>
+#include <unordered_map>
 
 using namespace std::string_literals;
 
@@ -338,6 +340,12 @@ EpisodeProxy Simulator::GetCurrentEpisode() {
     nav->SetPedestriansSeed(seed);
   }
 
+  nav::RoutePlannerStatistics Simulator::GetPedestriansRouteStatistics() {
+    DEBUG_ASSERT(_episode != nullptr);
+    auto nav = _episode->CreateNavigationIfMissing();
+    return nav->GetRoutePlannerStatistics();
+  }
+
   // ===========================================================================
   // -- General operations with actors -----------------------------------------
   // ===========================================================================
@@ -372,6 +380,35 @@ EpisodeProxy Simulator::GetCurrentEpisode() {
     return result;
   }
 
+  Future<SharedPtr<Actor>> Simulator::SpawnActorAsync(
+      const ActorBlueprint &blueprint,
+      const geom::Transform &transform,
+      Actor *parent,
+      rpc::AttachmentType attachment_type,
+      GarbageCollectionPolicy gc) {
+    auto future = (parent != nullptr) ?
+        _client.SpawnActorWithParentAsync(
+            blueprint.MakeActorDescription(),
+            transform,
+            parent->GetId(),
+            attachment_type) :
+        _client.SpawnActorAsync(
+            blueprint.MakeActorDescription(),
+            transform);
+    const auto gca = (gc == GarbageCollectionPolicy::Inherit ? _gc_policy : gc);
+    return std::move(future).Then([self=shared_from_this(), gca](rpc::Actor actor) {
+      DEBUG_ASSERT(self->_episode != nullptr);
+      self->_episode->RegisterActor(actor);
+      auto result = ActorFactory::MakeActor(self->GetCurrentEpisode(), actor, gca);
+      log_debug(
+          result->GetDisplayId(),
+          "created",
+          gca == GarbageCollectionPolicy::Enabled ? "with" : "without",
+          "garbage collection");
+      return result;
+    });
+  }
+
   bool Simulator::DestroyActor(Actor &actor) {
     bool success = true;
     success = _client.DestroyActor(actor.GetId());
@@ -385,6 +422,96 @@ EpisodeProxy Simulator::GetCurrentEpisode() {
     return success;
   }
 
+  rpc::ActorColumns Simulator::GetActorsState(
+      const std::vector<ActorId> &actor_ids,
+      const rpc::ActorFieldType fields) {
+    using rpc::ActorField;
+    using rpc::HasField;
+    DEBUG_ASSERT(_episode != nullptr);
+    rpc::ActorColumns columns;
+    if ((fields & rpc::ServerActorFields) != 0u) {
+      columns = _client.GetActorsState(actor_ids, fields & rpc::ServerActorFields);
+      DEBUG_ASSERT(columns.ids == actor_ids);
+    } else {
+      columns.ids = actor_ids;
+    }
+    const auto count = actor_ids.size();
+    if (HasField(fields, ActorField::Transform)) {
+      columns.transform.resize(count, geom::Transform{});
+    }
+    if (HasField(fields, ActorField::Velocity)) {
+      columns.velocity.resize(count, geom::Vector3D{});
+    }
+    if (HasField(fields, ActorField::AngularVelocity)) {
+      columns.angular_velocity.resize(count, geom::Vector3D{});
+    }
+    if (HasField(fields, ActorField::Acceleration)) {
+      columns.acceleration.resize(count, geom::Vector3D{});
+    }
+    if (HasField(fields, ActorField::VehicleControl)) {
+      columns.vehicle_control.resize(count);
+    }
+    if (HasField(fields, ActorField::SpeedLimit)) {
+      columns.speed_limit.resize(count, 0.0f);
+    }
+    if (HasField(fields, ActorField::TrafficLightState)) {
+      columns.traffic_light_state.resize(count, 0u);
+    }
+    // The type dependent state is an union, only read it if the actor has the
+    // right type. The descriptions are cached, so this usually does not call
+    // the server.
+    const bool needs_type =
+        HasField(fields, ActorField::VehicleControl) ||
+        HasField(fields, ActorField::SpeedLimit) ||
+        HasField(fields, ActorField::TrafficLightState);
+    std::unordered_map<ActorId, std::string> type_ids;
+    if (needs_type) {
+      for (auto &&actor : _episode->GetActorsById(actor_ids)) {
+        type_ids.emplace(actor.id, actor.description.id);
+      }
+    }
+    const auto state = _episode->GetState();
+    for (auto i = 0u; i < count; ++i) {
+      const auto *snapshot = state->FindActorSnapshot(actor_ids[i]);
+      if (snapshot == nullptr) {
+        continue;
+      }
+      if (!columns.transform.empty()) {
+        columns.transform[i] = snapshot->transform;
+      }
+      if (!columns.velocity.empty()) {
+        columns.velocity[i] = snapshot->velocity;
+      }
+      if (!columns.angular_velocity.empty()) {
+        columns.angular_velocity[i] = snapshot->angular_velocity;
+      }
+      if (!columns.acceleration.empty()) {
+        columns.acceleration[i] = snapshot->acceleration;
+      }
+      if (needs_type) {
+        auto type_id = type_ids.find(actor_ids[i]);
+        if (type_id == type_ids.end()) {
+          continue;
+        }
+        if (StringUtil::StartsWith(type_id->second, "vehicle.")) {
+          const auto &vehicle_data = snapshot->state.vehicle_data;
+          if (!columns.vehicle_control.empty()) {
+            columns.vehicle_control[i] = rpc::VehicleControl(vehicle_data.control);
+          }
+          if (!columns.speed_limit.empty()) {
+            columns.speed_limit[i] = vehicle_data.speed_limit;
+          }
+        } else if (StringUtil::StartsWith(type_id->second, "traffic.traffic_light")) {
+          if (!columns.traffic_light_state.empty()) {
+            columns.traffic_light_state[i] =
+                static_cast<uint8_t>(snapshot->state.traffic_light_data.state);
+          }
+        }
+      }
+    }
+    return columns;
+  }
+
   // ===========================================================================
   // -- Operations with sensors ------------------------------------------------
   // ===========================================================================
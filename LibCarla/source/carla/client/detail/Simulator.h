@@ -21,6 +21,7 @@
 #include "carla/client/detail/Client.h"
 #include "carla/client/detail/Episode.h"
 #include "carla/client/detail/EpisodeProxy.h"
+#include "carla/nav/RoutePlannerStatistics.h"
 #include "carla/profiler/LifetimeProfiled.h"
 #include "carla/rpc/TrafficLightState.h"
 #include "carla/rpc/VehicleLightStateList.h"
@@ -104,6 +105,12 @@ namespace detail {
     void GetReadyCurrentEpisode();
     EpisodeProxy GetCurrentEpisode();
 
+    /// @copydoc Episode::SetStateDeltasEnabled
+    bool SetEpisodeStateDeltas(bool enabled) {
+      GetReadyCurrentEpisode();
+      return _episode->SetStateDeltasEnabled(enabled);
+    }
+
     /// @}
     // =========================================================================
     /// @name World snapshot
@@ -249,6 +256,10 @@ namespace detail {
       return _client.GetEpisodeSettings();
     }
 
+    Future<rpc::EpisodeSettings> GetEpisodeSettingsAsync() {
+      return _client.GetEpisodeSettingsAsync();
+    }
+
     uint64_t SetEpisodeSettings(const rpc::EpisodeSettings &settings);
 
     rpc::WeatherParameters GetWeatherParameters() {
@@ -312,6 +323,8 @@ namespace detail {
 
     void SetPedestriansSeed(unsigned int seed);
 
+    nav::RoutePlannerStatistics GetPedestriansRouteStatistics();
+
     /// @}
     // =========================================================================
     /// @name General operations with actors
@@ -328,6 +341,18 @@ namespace detail {
       return _episode->GetActorsById(actor_ids);
     }
 
+    Future<std::vector<rpc::Actor>> GetActorsByIdAsync(const std::vector<ActorId> &actor_ids) const {
+      DEBUG_ASSERT(_episode != nullptr);
+      return _episode->GetActorsByIdAsync(actor_ids);
+    }
+
+    /// Reads the given @a fields (rpc::ActorField flags) of several actors at
+    /// once. The fields of the server are requested with a single call, the
+    /// rest are read from the current episode state.
+    rpc::ActorColumns GetActorsState(
+        const std::vector<ActorId> &actor_ids,
+        rpc::ActorFieldType fields);
+
     std::vector<rpc::Actor> GetAllTheActorsInTheEpisode() const {
       DEBUG_ASSERT(_episode != nullptr);
       return _episode->GetActors();
@@ -359,6 +384,15 @@ namespace detail {
         rpc::AttachmentType attachment_type = rpc::AttachmentType::Rigid,
         GarbageCollectionPolicy gc = GarbageCollectionPolicy::Inherit);
 
+    /// Same as SpawnActor, but it returns as soon as the request is sent. The
+    /// actor is registered in the episode when the result is read.
+    Future<SharedPtr<Actor>> SpawnActorAsync(
+        const ActorBlueprint &blueprint,
+        const geom::Transform &transform,
+        Actor *parent = nullptr,
+        rpc::AttachmentType attachment_type = rpc::AttachmentType::Rigid,
+        GarbageCollectionPolicy gc = GarbageCollectionPolicy::Inherit);
+
     bool DestroyActor(Actor &actor);
 
     bool DestroyActor(ActorId actor_id)
@@ -578,8 +612,8 @@ namespace detail {
     // =========================================================================
     /// @{
 
-    std::string StartRecorder(std::string name, bool additional_data) {
-      return _client.StartRecorder(std::move(name), additional_data);
+    std::string StartRecorder(std::string name, bool additional_data, bool compressed) {
+      return _client.StartRecorder(std::move(name), additional_data, compressed);
     }
 
     void StopRecorder(void) {
@@ -15,6 +15,7 @@
 #include "carla/rpc/DebugShape.h"
 #include "carla/rpc/WalkerControl.h"
 
+#include <algorithm>
 #include <sstream>
 
 namespace carla {
@@ -48,36 +49,37 @@ namespace detail {
     // update crowd in navigation module
     _nav.UpdateCrowd(*state);
 
-    carla::geom::Transform trans;
+    // get the state of all walkers at once
+    _nav.GetWalkerStates(_walker_states);
+
     using Cmd = rpc::Command;
     std::vector<Cmd> commands;
-    commands.reserve(walkers->size());
-    for (auto handle : *walkers) {
-      // get the transform of the walker
-      if (_nav.GetWalkerTransform(handle.walker, trans)) {
-        float speed = _nav.GetWalkerSpeed(handle.walker);
-        commands.emplace_back(Cmd::ApplyWalkerState{ handle.walker, trans, speed });
-      }
+    commands.reserve(_walker_states.ids.size() + 3u * _walker_states.dead.size());
+    for (size_t i = 0u; i < _walker_states.ids.size(); ++i) {
+      commands.emplace_back(Cmd::ApplyWalkerState{
+          _walker_states.ids[i],
+          _walker_states.transforms[i],
+          _walker_states.speeds[i]});
     }
-    _simulator.lock()->ApplyBatchSync(std::move(commands), false);
 
-    // check if any agent has been killed
-    bool alive;
-    for (auto handle : *walkers) {
-      // get the agent state
-      if (_nav.IsWalkerAlive(handle.walker, alive)) {
-        if (!alive) {
-          _simulator.lock()->SetActorCollisions(handle.walker, true);
-          _simulator.lock()->SetActorDead(handle.walker);
-          // remove from the crowd
-          _nav.RemoveAgent(handle.walker);
-          // destroy the controller
-          _simulator.lock()->DestroyActor(handle.controller);
-          // unregister from list
-          UnregisterWalker(handle.walker, handle.controller);
-        }
+    // the agents killed are sent to the simulator in the same batch
+    for (auto walker_id : _walker_states.dead) {
+      auto it = std::find_if(walkers->begin(), walkers->end(), [walker_id](const WalkerHandle &handle) {
+        return handle.walker == walker_id;
+      });
+      if (it == walkers->end()) {
+        continue;
       }
+      commands.emplace_back(Cmd::SetActorCollisions{it->walker, true});
+      commands.emplace_back(Cmd::SetActorDead{it->walker});
+      // destroy the controller
+      commands.emplace_back(Cmd::DestroyActor{it->controller});
+      // remove from the crowd
+      _nav.RemoveAgent(it->walker);
+      // unregister from list
+      UnregisterWalker(it->walker, it->controller);
     }
+    _simulator.lock()->ApplyBatchSync(std::move(commands), false);
   }
 
   void WalkerNavigation::CheckIfWalkerExist(std::vector<WalkerHandle> walkers, const EpisodeState &state) {
@@ -88,6 +88,12 @@ namespace detail {
       _nav.SetSeed(seed);
     }
 
+    // return the queue length and latencies of the routes computed in the
+    // background
+    carla::nav::RoutePlannerStatistics GetRoutePlannerStatistics() const {
+      return _nav.GetRoutePlannerStatistics();
+    }
+
   private:
 
     std::weak_ptr<Simulator> _simulator;
@@ -103,6 +109,9 @@ namespace detail {
 
     AtomicList<WalkerHandle> _walkers;
 
+    /// state of the walkers read from the crowd every tick
+    carla::nav::WalkerStates _walker_states;
+
     /// check a few walkers and if they don't exist then remove from the crowd
     void CheckIfWalkerExist(std::vector<WalkerHandle> walkers, const EpisodeState &state);
     /// add/update/delete all vehicles in crowd
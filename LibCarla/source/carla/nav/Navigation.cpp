@@ -33,6 +33,7 @@ namespace nav {
   static const int   MAX_POLYS = 256;
   static const int   MAX_AGENTS = 500;
   static const int   MAX_QUERY_SEARCH_NODES = 2048;
+  static const size_t ROUTE_PLANNER_WORKERS = 2u;
   static const float AGENT_HEIGHT = 1.8f;
   static const float AGENT_RADIUS = 0.3f;
 
@@ -48,12 +49,56 @@ namespace nav {
     return static_cast<float>(rand()) / static_cast<float>(RAND_MAX);
   }
 
+  // return the speed of an agent
+  static float AgentSpeed(const dtCrowdAgent &agent) {
+    return sqrtf(agent.vel[0] * agent.vel[0] + agent.vel[1] * agent.vel[1] + agent.vel[2] * agent.vel[2]);
+  }
+
+  // return the transform of an agent in Unreal coordinates, turning smoothly
+  // from its yaw in the previous tick, which is updated
+  static carla::geom::Transform AgentTransform(
+      const dtCrowdAgent &agent,
+      double delta_seconds,
+      float &previous_yaw) {
+    carla::geom::Transform trans;
+
+    // set its position in Unreal coordinates
+    trans.location.x = agent.npos[0];
+    trans.location.y = agent.npos[2];
+    trans.location.z = agent.npos[1];
+
+    // set its rotation
+    float yaw;
+    float speed = 0.0f;
+    float min = 0.1f;
+    if (agent.vel[0] < -min || agent.vel[0] > min ||
+        agent.vel[2] < -min || agent.vel[2] > min) {
+      yaw = atan2f(agent.vel[2], agent.vel[0]) * (180.0f / static_cast<float>(M_PI));
+      speed = AgentSpeed(agent);
+    } else {
+      yaw = atan2f(agent.dvel[2], agent.dvel[0]) * (180.0f / static_cast<float>(M_PI));
+      speed = sqrtf(agent.dvel[0] * agent.dvel[0] + agent.dvel[1] * agent.dvel[1] + agent.dvel[2] * agent.dvel[2]);
+    }
+
+    // interpolate current and target angle
+    float shortest_angle = fmod(yaw - previous_yaw + 540.0f, 360.0f) - 180.0f;
+    float per = (speed / 1.5f);
+    if (per > 1.0f) per = 1.0f;
+    float rotation_speed = per * 6.0f;
+    trans.rotation.yaw = previous_yaw +
+    (shortest_angle * rotation_speed * static_cast<float>(delta_seconds));
+    previous_yaw = trans.rotation.yaw;
+
+    return trans;
+  }
+
   Navigation::Navigation() {
     // assign walker manager
     _walker_manager.SetNav(this);
   }
 
   Navigation::~Navigation() {
+    _route_planner.Stop();
     _ready = false;
     _time_to_unblock = 0.0f;
     _mapped_walkers_id.clear();
@@ -179,6 +224,9 @@ namespace nav {
       tile_header.tile_ref, 0);
     }
 
+    // the workers use the previous mesh until they are stopped
+    _route_planner.Stop();
+
     // exchange
     dtFreeNavMesh(_nav_mesh);
     _nav_mesh = mesh;
@@ -195,6 +243,11 @@ namespace nav {
     // create and init the crowd manager
     CreateCrowd();
 
+    // start the workers that compute the routes
+    if (_crowd != nullptr) {
+      _route_planner.Start(_nav_mesh, ROUTE_PLANNER_WORKERS, MAX_QUERY_SEARCH_NODES);
+    }
+
     return true;
   }
 
@@ -371,17 +424,6 @@ namespace nav {
 
   bool Navigation::GetAgentRoute(ActorId id, carla::geom::Location from, carla::geom::Location to,
   std::vector<carla::geom::Location> &path, std::vector<unsigned char> &area) {
-    // path found
-    float straight_path[MAX_POLYS * 3];
-    unsigned char straight_path_flags[MAX_POLYS];
-    dtPolyRef straight_path_polys[MAX_POLYS];
-    int num_straight_path = 0;
-    int straight_path_options = DT_STRAIGHTPATH_AREA_CROSSINGS;
-
-    // polys in path
-    dtPolyRef polys[MAX_POLYS];
-    int num_polys;
-
     // check if all is ready
     if (!_ready) {
       return false;
@@ -389,84 +431,38 @@ namespace nav {
 
     DEBUG_ASSERT(_nav_query != nullptr);
 
-    // point extension
-    float poly_pick_ext[3] = {2,4,2};
-
     // get current filter from agent
     auto it = _mapped_walkers_id.find(id);
     if (it == _mapped_walkers_id.end())
       return false;
 
-    const dtQueryFilter *filter;
-    {
-      // critical section, force single thread running this
-      std::lock_guard<std::mutex> lock(_mutex);
-      filter = _crowd->getFilter(_crowd->getAgent(it->second)->params.queryFilterType);
-    }
-
-    // set the points
-    dtPolyRef start_ref = 0;
-    dtPolyRef end_ref = 0;
-    float start_pos[3] = { from.x, from.z, from.y };
-    float end_pos[3] = { to.x, to.z, to.y };
-    {
-      // critical section, force single thread running this
-      std::lock_guard<std::mutex> lock(_mutex);
-      _nav_query->findNearestPoly(start_pos, poly_pick_ext, filter, &start_ref, 0);
-      _nav_query->findNearestPoly(end_pos, poly_pick_ext, filter, &end_ref, 0);
-    }
-    if (!start_ref || !end_ref) {
-      return false;
-    }
+    // critical section, force single thread running this
+    std::lock_guard<std::mutex> lock(_mutex);
+    const dtQueryFilter *filter = _crowd->getFilter(_crowd->getAgent(it->second)->params.queryFilterType);
+    return RoutePlanner::FindRoute(*_nav_query, *filter, from, to, path, area);
+  }
 
-    // get the path of nodes
-    {
-      // critical section, force single thread running this
-      std::lock_guard<std::mutex> lock(_mutex);
-      _nav_query->findPath(start_ref, end_ref, start_pos, end_pos, filter, polys, &num_polys, MAX_POLYS);
+  // queue the route of an agent to the route planner
+  uint64_t Navigation::RequestAgentRoute(ActorId id, carla::geom::Location from, carla::geom::Location to) {
+    // check if all is ready
+    if (!_ready) {
+      return 0u;
     }
 
-    // get the path of points
-    if (num_polys == 0) {
-      return false;
-    }
+    DEBUG_ASSERT(_crowd != nullptr);
 
-    // in case of partial path, make sure the end point is clamped to the last
-    // polygon
-    float end_pos2[3];
-    dtVcopy(end_pos2, end_pos);
-    if (polys[num_polys - 1] != end_ref) {
-      // critical section, force single thread running this
-      std::lock_guard<std::mutex> lock(_mutex);
-      _nav_query->closestPointOnPoly(polys[num_polys - 1], end_pos, end_pos2, 0);
-    }
+    // get current filter from agent
+    auto it = _mapped_walkers_id.find(id);
+    if (it == _mapped_walkers_id.end())
+      return 0u;
 
-    // get the points
+    const dtQueryFilter *filter;
     {
       // critical section, force single thread running this
       std::lock_guard<std::mutex> lock(_mutex);
-      _nav_query->findStraightPath(start_pos, end_pos2, polys, num_polys,
-      straight_path, straight_path_flags,
-      straight_path_polys, &num_straight_path, MAX_POLYS, straight_path_options);
-    }
-
-    // copy the path to the output buffer
-    path.clear();
-    path.reserve(static_cast<unsigned long>(num_straight_path));
-    unsigned char area_type;
-    for (int i = 0, j = 0; j < num_straight_path; i += 3, ++j) {
-      // save coordinate for Unreal axis (x, z, y)
-      path.emplace_back(straight_path[i], straight_path[i + 2], straight_path[i + 1]);
-      // save area type
-      {
-        // critical section, force single thread running this
-        std::lock_guard<std::mutex> lock(_mutex);
-        _nav_mesh->getPolyArea(straight_path_polys[j], &area_type);
-      }
-      area.emplace_back(area_type);
+      filter = _crowd->getFilter(_crowd->getAgent(it->second)->params.queryFilterType);
     }
-
-    return true;
+    return _route_planner.Request(id, from, to, filter);
   }
 
   // create a new walker in crowd
@@ -679,6 +675,7 @@ namespace nav {
         _crowd->removeAgent(it->second);
       }
       _walker_manager.RemoveWalker(id);
+      _route_planner.Cancel(id);
       // remove from mapping
       _mapped_walkers_id.erase(it);
       _mapped_by_index.erase(it->second);
@@ -854,65 +851,43 @@ namespace nav {
     // update the time to check for blocked agents
     _time_to_unblock += _delta_seconds;
 
-    // check all active agents
-    int total_unblocked = 0;
-    int total_agents;
+    // check for blocked agents, all in a single critical section
+    if (_time_to_unblock < AGENT_UNBLOCK_TIME) {
+      return;
+    }
+    std::vector<int> blocked;
     {
       // critical section, force single thread running this
       std::lock_guard<std::mutex> lock(_mutex);
-      total_agents = _crowd->getAgentCount();
-    }
-    const dtCrowdAgent *ag;
-    for (int i = 0; i < total_agents; ++i) {
-      {
-        // critical section, force single thread running this
-        std::lock_guard<std::mutex> lock(_mutex);
-        ag = _crowd->getAgent(i);
-      }
+      const int total_agents = _crowd->getAgentCount();
+      for (int i = 0; i < total_agents; ++i) {
+        const dtCrowdAgent *ag = _crowd->getAgent(i);
 
-      if (!ag->active || ag->paused || ag->dead) {
-        continue;
-      }
+        // check only pedestrians not paused, and no vehicles
+        if (!ag->active || ag->paused || ag->dead || ag->params.useObb) {
+          continue;
+        }
 
-      // check only pedestrians not paused, and no vehicles
-      if (!ag->params.useObb && !ag->paused) {
-        bool reset_target_pos = false;
-        bool use_same_filter = false;
-
-        // check for unblocking actors
-        if (_time_to_unblock >= AGENT_UNBLOCK_TIME) {
-          // get the distance moved by each actor
-          carla::geom::Vector3D previous = _walkers_blocked_position[i];
-          carla::geom::Vector3D current = carla::geom::Vector3D(ag->npos[0], ag->npos[1], ag->npos[2]);
-          carla::geom::Vector3D distance = current - previous;
-          float d = distance.SquaredLength();
-          if (d < AGENT_UNBLOCK_DISTANCE_SQUARED) {
-            ++total_unblocked;
-            reset_target_pos = true;
-            use_same_filter = true;
-          }
-          // update with current position
-          _walkers_blocked_position[i] = current;
-
-          // check to assign a new target position
-          if (reset_target_pos) {
-            // set if the agent can cross roads or not
-            if (!use_same_filter) {
-              if (frand() <= _probability_crossing) {
-                SetAgentFilter(i, 1);
-              } else {
-                SetAgentFilter(i, 0);
-              }
-            }
-            // set a new random target
-            carla::geom::Location location;
-            GetRandomLocation(location, nullptr);
-            _walker_manager.SetWalkerRoute(_mapped_by_index[i], location);
-          }
+        // get the distance moved by each actor
+        carla::geom::Vector3D previous = _walkers_blocked_position[i];
+        carla::geom::Vector3D current = carla::geom::Vector3D(ag->npos[0], ag->npos[1], ag->npos[2]);
+        carla::geom::Vector3D distance = current - previous;
+        if (distance.SquaredLength() < AGENT_UNBLOCK_DISTANCE_SQUARED) {
+          blocked.emplace_back(i);
         }
+        // update with current position
+        _walkers_blocked_position[i] = current;
       }
     }
 
+    // assign a new random target to the blocked agents, out of the critical
+    // section because these lock it again
+    for (int i : blocked) {
+      carla::geom::Location location;
+      GetRandomLocation(location, nullptr);
+      _walker_manager.SetWalkerRoute(_mapped_by_index[i], location);
+    }
+
     // check for resetting time
     if (_time_to_unblock >= AGENT_UNBLOCK_TIME) {
       _time_to_unblock = 0.0f;
@@ -953,32 +928,7 @@ namespace nav {
       return false;
     }
 
-    // set its position in Unreal coordinates
-    trans.location.x = agent->npos[0];
-    trans.location.y = agent->npos[2];
-    trans.location.z = agent->npos[1];
-
-    // set its rotation
-    float yaw;
-    float speed = 0.0f;
-    float min = 0.1f;
-    if (agent->vel[0] < -min || agent->vel[0] > min ||
-        agent->vel[2] < -min || agent->vel[2] > min) {
-      yaw = atan2f(agent->vel[2], agent->vel[0]) * (180.0f / static_cast<float>(M_PI));
-      speed = sqrtf(agent->vel[0] * agent->vel[0] + agent->vel[1] * agent->vel[1] + agent->vel[2] * agent->vel[2]);
-    } else {
-      yaw = atan2f(agent->dvel[2], agent->dvel[0]) * (180.0f / static_cast<float>(M_PI));
-      speed = sqrtf(agent->dvel[0] * agent->dvel[0] + agent->dvel[1] * agent->dvel[1] + agent->dvel[2] * agent->dvel[2]);
-    }
-
-    // interpolate current and target angle
-    float shortest_angle = fmod(yaw - _yaw_walkers[id] + 540.0f, 360.0f) - 180.0f;
-    float per = (speed / 1.5f);
-    if (per > 1.0f) per = 1.0f;
-    float rotation_speed = per * 6.0f;
-    trans.rotation.yaw = _yaw_walkers[id] +
-    (shortest_angle * rotation_speed * static_cast<float>(_delta_seconds));
-    _yaw_walkers[id] = trans.rotation.yaw;
+    trans = AgentTransform(*agent, _delta_seconds, _yaw_walkers[id]);
 
     return true;
   }
@@ -1054,8 +1004,54 @@ namespace nav {
       agent = _crowd->getAgent(index);
     }
 
-    return sqrt(agent->vel[0] * agent->vel[0] + agent->vel[1] * agent->vel[1] + agent->vel[2] *
-    agent->vel[2]);
+    return AgentSpeed(*agent);
+  }
+
+  // take the next route computed by the route planner
+  bool Navigation::GetNextAgentRoute(PlannedRoute &route) {
+    return _route_planner.TryPop(route);
+  }
+
+  // return the counters of the route planner
+  RoutePlannerStatistics Navigation::GetRoutePlannerStatistics() const {
+    return _route_planner.GetStatistics();
+  }
+
+  // get the transform and speed of all walkers in a single pass
+  void Navigation::GetWalkerStates(WalkerStates &states) {
+    states.ids.clear();
+    states.transforms.clear();
+    states.speeds.clear();
+    states.dead.clear();
+
+    // check if all is ready
+    if (!_ready) {
+      return;
+    }
+
+    DEBUG_ASSERT(_crowd != nullptr);
+
+    states.ids.reserve(_mapped_walkers_id.size());
+    states.transforms.reserve(_mapped_walkers_id.size());
+    states.speeds.reserve(_mapped_walkers_id.size());
+
+    // critical section, force single thread running this
+    std::lock_guard<std::mutex> lock(_mutex);
+    for (auto &&walker : _mapped_walkers_id) {
+      if (walker.second == -1) {
+        continue;
+      }
+      const dtCrowdAgent *agent = _crowd->getAgent(walker.second);
+      if (!agent->active) {
+        continue;
+      }
+      states.ids.emplace_back(walker.first);
+      states.transforms.emplace_back(AgentTransform(*agent, _delta_seconds, _yaw_walkers[walker.first]));
+      states.speeds.emplace_back(AgentSpeed(*agent));
+      if (agent->dead) {
+        states.dead.emplace_back(walker.first);
+      }
+    }
   }
 
   // get a random location for navigation
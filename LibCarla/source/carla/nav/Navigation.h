@@ -11,6 +11,7 @@
 #include "carla/geom/BoundingBox.h"
 #include "carla/geom/Location.h"
 #include "carla/geom/Transform.h"
+#include "carla/nav/RoutePlanner.h"
 #include "carla/nav/WalkerManager.h"
 #include "carla/rpc/ActorId.h"
 #include <recast/Recast.h>
@@ -50,6 +51,16 @@ namespace nav {
     carla::geom::BoundingBox bounding;
   };
 
+  /// struct to get the state of all walkers of the crowd at once, one entry
+  /// per walker in each array
+  struct WalkerStates {
+    std::vector<carla::rpc::ActorId> ids;
+    std::vector<carla::geom::Transform> transforms;
+    std::vector<float> speeds;
+    /// walkers killed by a vehicle, they are also in the arrays above
+    std::vector<carla::rpc::ActorId> dead;
+  };
+
   /// Manage the pedestrians navigation, using the Recast & Detour library for low level calculations.
   ///
   /// This class gets the binary content of the map from the server, which is required for the path finding.
@@ -70,6 +81,14 @@ namespace nav {
     std::vector<carla::geom::Location> &path, std::vector<unsigned char> &area);
     bool GetAgentRoute(ActorId id, carla::geom::Location from, carla::geom::Location to,
     std::vector<carla::geom::Location> &path, std::vector<unsigned char> &area);
+    /// queue the route of an agent to be computed in the background, return
+    /// the number of the request or 0 if it could not be queued
+    uint64_t RequestAgentRoute(ActorId id, carla::geom::Location from, carla::geom::Location to);
+    /// take the next route computed in the background, return false if none
+    bool GetNextAgentRoute(PlannedRoute &route);
+    /// return the queue length and latencies of the routes computed in the
+    /// background
+    RoutePlannerStatistics GetRoutePlannerStatistics() const;
 
     /// reference to the simulator to access API functions
     void SetSimulator(std::weak_ptr<carla::client::detail::Simulator> simulator);
@@ -98,6 +117,9 @@ namespace nav {
     bool GetWalkerPosition(ActorId id, carla::geom::Location &location);
     /// get the walker current transform
     float GetWalkerSpeed(ActorId id);
+    /// get the transform and speed of all walkers in a single pass, reusing
+    /// the memory of the arrays
+    void GetWalkerStates(WalkerStates &states);
     /// update all walkers in crowd
     void UpdateCrowd(const client::detail::EpisodeState &state);
     /// get a random location for navigation
@@ -142,6 +164,9 @@ namespace nav {
     /// walker manager for the route planning with events
     WalkerManager _walker_manager;
 
+    /// workers that compute the routes of the walker manager
+    RoutePlanner _route_planner;
+
     std::weak_ptr<carla::client::detail::Simulator> _simulator;
     
     mutable std::mutex _mutex;
@@ -0,0 +1,240 @@
+// Copyright (c) 2023 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "carla/nav/RoutePlanner.h"
+
+#include "carla/Logging.h"
+
+#include <recast/DetourCommon.h>
+
+#include <algorithm>
+
+namespace carla {
+namespace nav {
+
+  // same limit of polygons in a path than in Navigation
+  static const int MAX_POLYS = 256;
+
+  RoutePlanner::~RoutePlanner() {
+    Stop();
+  }
+
+  // start the workers
+  bool RoutePlanner::Start(const dtNavMesh *nav_mesh, size_t workers, int max_nodes) {
+    DEBUG_ASSERT(nav_mesh != nullptr);
+    Stop();
+
+    // a query for each worker
+    for (size_t i = 0u; i < workers; ++i) {
+      dtNavMeshQuery *query = dtAllocNavMeshQuery();
+      if (query == nullptr || dtStatusFailed(query->init(nav_mesh, max_nodes))) {
+        logging::log("Nav: failed to create the query of the route planner");
+        dtFreeNavMeshQuery(query);
+        Stop();
+        return false;
+      }
+      _queries.emplace_back(query);
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _stop = false;
+    }
+    for (auto query : _queries) {
+      _workers.CreateThread([this, query]() { Run(query); });
+    }
+    return true;
+  }
+
+  // stop and join the workers
+  void RoutePlanner::Stop() {
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _stop = true;
+      _requests.clear();
+      _routes.clear();
+      _latest_request.clear();
+    }
+    _condition.notify_all();
+    _workers.JoinAll();
+    for (auto query : _queries) {
+      dtFreeNavMeshQuery(query);
+    }
+    _queries.clear();
+  }
+
+  // queue a route for a walker
+  uint64_t RoutePlanner::Request(ActorId id, carla::geom::Location from, carla::geom::Location to,
+  const dtQueryFilter *filter) {
+    DEBUG_ASSERT(filter != nullptr);
+    RouteRequest request;
+    request.route.id = id;
+    request.route.from = from;
+    request.route.to = to;
+    request.route.requested = std::chrono::steady_clock::now();
+    request.filter = filter;
+    uint64_t number;
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      number = _next_request++;
+      request.route.request = number;
+      _latest_request[id] = number;
+      _requests.emplace_back(std::move(request));
+    }
+    _condition.notify_one();
+    return number;
+  }
+
+  // discard the requests pending of a walker
+  void RoutePlanner::Cancel(ActorId id) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _latest_request.erase(id);
+  }
+
+  // take the next route computed
+  bool RoutePlanner::TryPop(PlannedRoute &route) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    while (!_routes.empty()) {
+      route = std::move(_routes.front());
+      _routes.pop_front();
+
+      // skip the routes of requests that have been replaced or cancelled
+      auto it = _latest_request.find(route.id);
+      if (it == _latest_request.end() || it->second != route.request) {
+        continue;
+      }
+      _latest_request.erase(it);
+
+      // update the latencies
+      std::chrono::duration<double> latency = std::chrono::steady_clock::now() - route.requested;
+      ++_routes_delivered;
+      _last_latency = latency.count();
+      _total_latency += _last_latency;
+      _max_latency = std::max(_max_latency, _last_latency);
+      return true;
+    }
+    return false;
+  }
+
+  // return the counters of the planner
+  RoutePlannerStatistics RoutePlanner::GetStatistics() const {
+    RoutePlannerStatistics statistics;
+    std::lock_guard<std::mutex> lock(_mutex);
+    statistics.queued_requests = _requests.size();
+    statistics.ready_routes = _routes.size();
+    statistics.routes_delivered = _routes_delivered;
+    statistics.last_latency = _last_latency;
+    if (_routes_delivered > 0u) {
+      statistics.mean_latency = _total_latency / static_cast<double>(_routes_delivered);
+    }
+    statistics.max_latency = _max_latency;
+    return statistics;
+  }
+
+  // loop of each worker
+  void RoutePlanner::Run(dtNavMeshQuery *query) {
+    for (;;) {
+      RouteRequest request;
+      {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _condition.wait(lock, [this]() { return _stop || !_requests.empty(); });
+        if (_stop) {
+          return;
+        }
+        request = std::move(_requests.front());
+        _requests.pop_front();
+
+        // skip the requests that have been replaced or cancelled
+        auto it = _latest_request.find(request.route.id);
+        if (it == _latest_request.end() || it->second != request.route.request) {
+          continue;
+        }
+      }
+
+      PlannedRoute &route = request.route;
+      route.found = FindRoute(*query, *request.filter, route.from, route.to, route.path, route.area);
+
+      {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_stop) {
+          return;
+        }
+        _routes.emplace_back(std::move(route));
+      }
+    }
+  }
+
+  // compute the path points to go from one position to another
+  bool RoutePlanner::FindRoute(dtNavMeshQuery &query, const dtQueryFilter &filter,
+  carla::geom::Location from, carla::geom::Location to,
+  std::vector<carla::geom::Location> &path, std::vector<unsigned char> &area) {
+    // path found
+    float straight_path[MAX_POLYS * 3];
+    unsigned char straight_path_flags[MAX_POLYS];
+    dtPolyRef straight_path_polys[MAX_POLYS];
+    int num_straight_path = 0;
+    int straight_path_options = DT_STRAIGHTPATH_AREA_CROSSINGS;
+
+    // polys in path
+    dtPolyRef polys[MAX_POLYS];
+    int num_polys = 0;
+
+    path.clear();
+    area.clear();
+
+    // point extension
+    float poly_pick_ext[3] = {2,4,2};
+
+    // set the points
+    dtPolyRef start_ref = 0;
+    dtPolyRef end_ref = 0;
+    float start_pos[3] = { from.x, from.z, from.y };
+    float end_pos[3] = { to.x, to.z, to.y };
+    query.findNearestPoly(start_pos, poly_pick_ext, &filter, &start_ref, 0);
+    query.findNearestPoly(end_pos, poly_pick_ext, &filter, &end_ref, 0);
+    if (!start_ref || !end_ref) {
+      return false;
+    }
+
+    // get the path of nodes
+    query.findPath(start_ref, end_ref, start_pos, end_pos, &filter, polys, &num_polys, MAX_POLYS);
+
+    // get the path of points
+    if (num_polys == 0) {
+      return false;
+    }
+
+    // in case of partial path, make sure the end point is clamped to the last
+    // polygon
+    float end_pos2[3];
+    dtVcopy(end_pos2, end_pos);
+    if (polys[num_polys - 1] != end_ref) {
+      query.closestPointOnPoly(polys[num_polys - 1], end_pos, end_pos2, 0);
+    }
+
+    // get the points
+    query.findStraightPath(start_pos, end_pos2, polys, num_polys,
+    straight_path, straight_path_flags,
+    straight_path_polys, &num_straight_path, MAX_POLYS, straight_path_options);
+
+    // copy the path to the output buffer
+    const dtNavMesh *nav_mesh = query.getAttachedNavMesh();
+    path.reserve(static_cast<unsigned long>(num_straight_path));
+    area.reserve(static_cast<unsigned long>(num_straight_path));
+    unsigned char area_type;
+    for (int i = 0, j = 0; j < num_straight_path; i += 3, ++j) {
+      // save coordinate for Unreal axis (x, z, y)
+      path.emplace_back(straight_path[i], straight_path[i + 2], straight_path[i + 1]);
+      // save area type
+      nav_mesh->getPolyArea(straight_path_polys[j], &area_type);
+      area.emplace_back(area_type);
+    }
+
+    return true;
+  }
+
+} // namespace nav
+} // namespace carla
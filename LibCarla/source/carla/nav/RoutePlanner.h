@@ -0,0 +1,106 @@
+// Copyright (c) 2023 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/NonCopyable.h"
+#include "carla/ThreadGroup.h"
+#include "carla/geom/Location.h"
+#include "carla/nav/RoutePlannerStatistics.h"
+#include "carla/rpc/ActorId.h"
+#include <recast/DetourNavMesh.h>
+#include <recast/DetourNavMeshQuery.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace carla {
+namespace nav {
+
+  /// route computed for a walker by the route planner
+  struct PlannedRoute {
+    ActorId id { 0u };
+    /// number of the request, as returned by RoutePlanner::Request
+    uint64_t request { 0u };
+    carla::geom::Location from;
+    carla::geom::Location to;
+    /// whether a path was found, otherwise the points are empty
+    bool found { false };
+    std::vector<carla::geom::Location> path;
+    std::vector<unsigned char> area;
+    std::chrono::steady_clock::time_point requested;
+  };
+
+  /// Computes the routes of the walkers in a pool of worker threads, so the
+  /// path finding does not stall the tick. Each worker has its own query
+  /// object on the navigation mesh, that is only read.
+  ///
+  /// Only the latest request of each walker is computed, older requests still
+  /// queued are skipped.
+  class RoutePlanner : private NonCopyable {
+
+  public:
+
+    RoutePlanner() = default;
+    ~RoutePlanner();
+
+    /// start the workers, each with a query of @a max_nodes search nodes
+    bool Start(const dtNavMesh *nav_mesh, size_t workers, int max_nodes);
+    /// stop and join the workers, the requests pending are discarded
+    void Stop();
+    /// queue a route for a walker, @a filter must outlive the request; return
+    /// the number of the request
+    uint64_t Request(ActorId id, carla::geom::Location from, carla::geom::Location to,
+    const dtQueryFilter *filter);
+    /// discard the requests pending of a walker
+    void Cancel(ActorId id);
+    /// take the next route computed, return false if there is none
+    bool TryPop(PlannedRoute &route);
+    /// return the counters of the planner
+    RoutePlannerStatistics GetStatistics() const;
+
+    /// compute the path points to go from one position to another with the
+    /// given query object, which can not be used by other threads meanwhile
+    static bool FindRoute(dtNavMeshQuery &query, const dtQueryFilter &filter,
+    carla::geom::Location from, carla::geom::Location to,
+    std::vector<carla::geom::Location> &path, std::vector<unsigned char> &area);
+
+  private:
+
+    struct RouteRequest {
+      PlannedRoute route;
+      const dtQueryFilter *filter;
+    };
+
+    void Run(dtNavMeshQuery *query);
+
+    mutable std::mutex _mutex;
+    std::condition_variable _condition;
+    bool _stop { false };
+
+    std::deque<RouteRequest> _requests;
+    std::deque<PlannedRoute> _routes;
+    /// latest request of each walker with a route pending
+    std::unordered_map<ActorId, uint64_t> _latest_request;
+    uint64_t _next_request { 1u };
+
+    /// latencies of the routes delivered
+    uint64_t _routes_delivered { 0u };
+    double _last_latency { 0.0 };
+    double _total_latency { 0.0 };
+    double _max_latency { 0.0 };
+
+    std::vector<dtNavMeshQuery *> _queries;
+    ThreadGroup _workers;
+  };
+
+} // namespace nav
+} // namespace carla
@@ -0,0 +1,29 @@
+// Copyright (c) 2023 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace carla {
+namespace nav {
+
+  /// counters of the route planner, the latencies are the time in seconds from
+  /// a request until its route is taken by the tick
+  struct RoutePlannerStatistics {
+    /// requests waiting for a worker
+    size_t queued_requests { 0u };
+    /// routes computed and not taken yet
+    size_t ready_routes { 0u };
+    uint64_t routes_delivered { 0u };
+    double last_latency { 0.0 };
+    double mean_latency { 0.0 };
+    double max_latency { 0.0 };
+  };
+
+} // namespace nav
+} // namespace carla
@@ -14,9 +14,15 @@
 #include "carla/nav/Navigation.h"
 #include "carla/rpc/Actor.h"
 
+#include <chrono>
+
 namespace carla {
 namespace nav {
 
+    // maximum time per update to apply the routes computed in the background,
+    // the rest are applied in the next updates
+    static const std::chrono::microseconds ROUTES_TIME_BUDGET { 1000 };
+
     WalkerManager::WalkerManager() {
     }
 
@@ -60,6 +66,10 @@ namespace nav {
 	// update all routes
     bool WalkerManager::Update(double delta) {
 
+        // apply the routes computed since the last update
+        if (_nav != nullptr)
+            ApplyRoutes();
+
         // check all walkers
         for (auto &it : _walkers) {
 
@@ -137,17 +147,46 @@ namespace nav {
 
         // get it
         WalkerInfo &info = it->second;
-        std::vector<carla::geom::Location> path;
-        std::vector<unsigned char> area;
 
         // save both points for the route
         _nav->GetWalkerPosition(id, info.from);
         info.to = to;
         info.currentIndex = 0;
         info.state = WALKER_IDLE;
+        info.route.clear();
+
+        // ask navigation for a route, it is applied in a later update
+        info.routeRequest = _nav->RequestAgentRoute(id, info.from, to);
+        return (info.routeRequest != 0);
+    }
+
+    // take the routes computed in the background, within a time budget
+    void WalkerManager::ApplyRoutes() {
+        auto start = std::chrono::steady_clock::now();
+        PlannedRoute route;
+        while (_nav->GetNextAgentRoute(route)) {
+            ApplyRoute(route);
+            if (std::chrono::steady_clock::now() - start >= ROUTES_TIME_BUDGET) {
+                break;
+            }
+        }
+    }
+
+    // create the points of a route computed, with its events
+    void WalkerManager::ApplyRoute(PlannedRoute &route) {
+        // search
+        auto it = _walkers.find(route.id);
+        if (it == _walkers.end())
+            return;
+
+        // get it, skipping the routes replaced by a newer request
+        WalkerInfo &info = it->second;
+        if (info.routeRequest != route.request)
+            return;
+        info.routeRequest = 0;
 
-        // get a route from navigation
-        _nav->GetAgentRoute(id, info.from, to, path, area);
+        std::vector<carla::geom::Location> &path = route.path;
+        std::vector<unsigned char> &area = route.area;
 
         // create each point of the route
         info.route.clear();
@@ -176,8 +215,7 @@ namespace nav {
         }
 
         // assign the first point to go (second in the list)
-        SetWalkerNextPoint(id);
-        return true;
+        SetWalkerNextPoint(route.id);
     }
 
     // set the next point in the route
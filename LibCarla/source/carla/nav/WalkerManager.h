@@ -11,6 +11,7 @@
 #include "carla/client/TrafficLight.h"
 #include "carla/client/World.h"
 #include "carla/geom/Location.h"
+#include "carla/nav/RoutePlanner.h"
 #include "carla/nav/WalkerEvent.h"
 #include "carla/rpc/ActorId.h"
 #include "carla/rpc/TrafficLightState.h"
@@ -39,6 +40,8 @@ namespace nav {
         carla::geom::Location to;
         unsigned int currentIndex { 0 };
         WalkerState state;
+        /// request of the route being computed, 0 if none
+        uint64_t routeRequest { 0 };
         std::vector<WalkerRoutePoint> route;
     };
 
@@ -64,7 +67,8 @@ namespace nav {
     /// update all routes
     bool Update(double delta);
 
-    /// set a new route from its current position
+    /// set a new route from its current position, the route is computed in
+    /// the background and the walker stays idle until it is ready
     bool SetWalkerRoute(ActorId id);
     bool SetWalkerRoute(ActorId id, carla::geom::Location to);
 
@@ -89,6 +93,12 @@ namespace nav {
 
     EventResult ExecuteEvent(ActorId id, WalkerInfo &info, double delta);
 
+    /// take the routes computed in the background, within a time budget
+    void ApplyRoutes();
+
+    /// create the points of a route computed, with its events
+    void ApplyRoute(PlannedRoute &route);
+
     std::unordered_map<ActorId, WalkerInfo> _walkers;
     std::vector<std::pair<SharedPtr<carla::client::TrafficLight>, carla::geom::Location>> _traffic_lights;
     Navigation *_nav { nullptr };
@@ -21,20 +21,27 @@
 
 #include <pugixml/pugixml.hpp>
 
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iterator>
+#include <random>
+#include <sstream>
+#include <vector>
+
 namespace carla {
 namespace opendrive {
 
-  boost::optional<road::Map> OpenDriveParser::Load(const std::string &opendrive) {
+  static bool Parse(const std::string &opendrive, road::MapBuilder &map_builder) {
     pugi::xml_document xml;
     pugi::xml_parse_result parse_result = xml.load_string(opendrive.c_str());
 
     if (parse_result == false) {
       log_error("unable to parse the OpenDRIVE XML string");
-      return {};
+      return false;
     }
 
-    carla::road::MapBuilder map_builder;
-
     parser::GeoReferenceParser::Parse(xml, map_builder);
     parser::RoadParser::Parse(xml, map_builder);
     parser::JunctionParser::Parse(xml, map_builder);
@@ -45,9 +52,70 @@ namespace opendrive {
     parser::SignalParser::Parse(xml, map_builder);
     parser::ObjectParser::Parse(xml, map_builder);
     parser::ControllerParser::Parse(xml, map_builder);
+    return true;
+  }
 
+  boost::optional<road::Map> OpenDriveParser::Load(const std::string &opendrive) {
+    carla::road::MapBuilder map_builder;
+    if (!Parse(opendrive, map_builder)) {
+      return {};
+    }
     return map_builder.Build();
   }
 
+  boost::optional<road::Map> OpenDriveParser::Load(
+      const std::string &opendrive,
+      const std::string &compiled_map_path) {
+    carla::road::MapBuilder map_builder;
+    if (!Parse(opendrive, map_builder)) {
+      return {};
+    }
+
+    std::vector<uint8_t> compiled_map;
+    {
+      std::ifstream file(compiled_map_path, std::ios::binary);
+      if (file.good()) {
+        compiled_map.assign(std::istreambuf_iterator<char>(file), {});
+      }
+    }
+
+    auto map = map_builder.Build(compiled_map);
+
+    // The builder leaves the compiled map empty if it was valid.
+    if (map.has_value() && !compiled_map.empty()) {
+      log_info("writing compiled map", compiled_map_path);
+      // Written to a temporary file first, other clients loading the same
+      // map may be reading it.
+      const auto temporary_path = compiled_map_path + '.' + std::to_string(std::random_device{}());
+      bool success;
+      {
+        std::ofstream file(temporary_path, std::ios::trunc | std::ios::binary);
+        file.write(
+            reinterpret_cast<const char *>(compiled_map.data()),
+            static_cast<std::streamsize>(compiled_map.size()));
+        success = file.good();
+      }
+      success = success && (std::rename(temporary_path.c_str(), compiled_map_path.c_str()) == 0);
+      if (!success) {
+        log_warning("unable to write compiled map", compiled_map_path);
+        std::remove(temporary_path.c_str());
+      }
+    }
+    return map;
+  }
+
+  std::string OpenDriveParser::GetCompiledMapName(const std::string &opendrive) {
+    // 64-bit FNV-1a, stable across platforms and runs.
+    uint64_t hash = 0xCBF29CE484222325u;
+    for (const char c : opendrive) {
+      hash ^= static_cast<uint8_t>(c);
+      hash *= 0x100000001B3u;
+    }
+    std::ostringstream name;
+    name << std::hex << std::setfill('0') << std::setw(16) << hash
+         << std::dec << '_' << opendrive.size() << ".rtree";
+    return name.str();
+  }
+
 } // namespace opendrive
 } // namespace carla
@@ -19,6 +19,19 @@ namespace opendrive {
   public:
 
     static boost::optional<road::Map> Load(const std::string &opendrive);
+
+    /// Same as Load, but the R-tree of the map and the junction conflicts,
+    /// which take most of the loading time, are read from the compiled map at
+    /// @a compiled_map_path.
+    /// If the file does not exist or it is not valid for this map, it is
+    /// written for the next time.
+    static boost::optional<road::Map> Load(
+        const std::string &opendrive,
+        const std::string &compiled_map_path);
+
+    /// File name for the compiled map of @a opendrive, made of a hash of its
+    /// contents so every version of the XODR gets its own file.
+    static std::string GetCompiledMapName(const std::string &opendrive);
   };
 
 } // namespace opendrive
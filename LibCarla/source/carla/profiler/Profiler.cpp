@@ -70,8 +70,22 @@ namespace detail {
     const std::string _filename;
   };
 
-  ProfilerData::~ProfilerData() {
+  static StaticProfiler &GetStaticProfiler() {
     static StaticProfiler PROFILER{"profiler.csv"};
+    return PROFILER;
+  }
+
+  void WriteCounter(
+      const std::string &name,
+      const double value,
+      const double maximum,
+      const char *units,
+      const size_t times) {
+    GetStaticProfiler().write_line(name, value, maximum, value, units, times);
+  }
+
+  ProfilerData::~ProfilerData() {
+    auto &PROFILER = GetStaticProfiler();
     if (_count > 0u) {
       if (_print_fps) {
         PROFILER.write_line(_name, fps(average()), fps(minimum()), fps(maximum()), "FPS", _count);
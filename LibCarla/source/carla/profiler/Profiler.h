@@ -9,6 +9,7 @@
 #ifndef LIBCARLA_ENABLE_PROFILER
 #  define CARLA_PROFILE_SCOPE(context, profiler_name)
 #  define CARLA_PROFILE_FPS(context, profiler_name)
+#  define CARLA_PROFILE_COUNTER(name, value, maximum, units, times)
 #else
 
 #include "carla/StopWatch.h"
@@ -73,6 +74,14 @@ namespace detail {
     size_t _min_elapsed = std::numeric_limits<size_t>::max();
   };
 
+  /// Writes the final value of a counter to the profiler output.
+  void WriteCounter(
+      const std::string &name,
+      double value,
+      double maximum,
+      const char *units,
+      size_t times);
+
   class ScopedProfiler {
   public:
 
@@ -121,4 +130,7 @@ namespace detail {
       stop_watch.Restart(); \
     }
 
+#define CARLA_PROFILE_COUNTER(name, value, maximum, units, times) \
+    ::carla::profiler::detail::WriteCounter(name, value, maximum, units, times);
+
 #endif // LIBCARLA_ENABLE_PROFILER
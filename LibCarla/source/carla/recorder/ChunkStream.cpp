@@ -0,0 +1,400 @@
+// Copyright (c) 2023 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "carla/recorder/ChunkStream.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+
+namespace carla {
+namespace recorder {
+
+  // ===========================================================================
+  // -- Static local methods ---------------------------------------------------
+  // ===========================================================================
+
+  /// Packet header plus the chunk header.
+  static constexpr uint64_t ChunkPacketHeaderSize = sizeof(PacketHeader) + sizeof(ChunkHeader);
+
+  template <typename T>
+  static void WriteValue(std::ostream &out, const T &value) {
+    out.write(reinterpret_cast<const char *>(&value), sizeof(T));
+  }
+
+  template <typename T>
+  static bool ReadValue(std::istream &in, T &value) {
+    return static_cast<bool>(in.read(reinterpret_cast<char *>(&value), sizeof(T)));
+  }
+
+  static bool SkipString(std::istream &in) {
+    uint16_t length = 0u;
+    return ReadValue(in, length) && in.seekg(length, std::ios::cur);
+  }
+
+  /// Skips the info header of a recording, same layout as RecordingInfo.
+  static bool SkipInfo(std::istream &in) {
+    uint16_t version = 0u;
+    int64_t date = 0;
+    return ReadValue(in, version) &&
+           SkipString(in) &&
+           ReadValue(in, date) &&
+           SkipString(in);
+  }
+
+  // ===========================================================================
+  // -- ChunkWriter ------------------------------------------------------------
+  // ===========================================================================
+
+  ChunkWriter::~ChunkWriter() {
+    Close();
+  }
+
+  bool ChunkWriter::Open(const std::string &filename) {
+    Close();
+
+    _file.open(filename, std::ios::binary);
+    if (!_file.is_open()) {
+      return false;
+    }
+
+    _buffer.clear();
+    _buffer_position = 0u;
+    _buffer_offset = 0u;
+    _stop = false;
+    _thread = std::thread(&ChunkWriter::WriterThread, this);
+    return true;
+  }
+
+  void ChunkWriter::Close() {
+    if (!_file.is_open()) {
+      return;
+    }
+
+    if (!_buffer.empty()) {
+      Send(_buffer.size(), true);
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _stop = true;
+    }
+    _condition.notify_all();
+    _thread.join();
+
+    _file.close();
+    _free_buffers.clear();
+  }
+
+  void ChunkWriter::WriteUncompressed() {
+    if (!_buffer.empty()) {
+      Send(_buffer.size(), false);
+    }
+  }
+
+  void ChunkWriter::FlushBefore(std::streampos position) {
+    const uint64_t end = static_cast<uint64_t>(position);
+    if (end > _buffer_offset &&
+        end <= _buffer_offset + _buffer_position &&
+        end - _buffer_offset >= _chunk_size) {
+      Send(end - _buffer_offset, true);
+    }
+  }
+
+  void ChunkWriter::Send(size_t count, bool compress) {
+    PendingChunk chunk;
+    chunk.compress = compress;
+
+    // wait only if the writer thread is too far behind
+    std::unique_lock<std::mutex> lock(_mutex);
+    _condition.wait(lock, [this]() { return _pending.size() < MaxPendingChunks; });
+    if (!_free_buffers.empty()) {
+      chunk.data = std::move(_free_buffers.back());
+      _free_buffers.pop_back();
+    }
+    lock.unlock();
+
+    chunk.data.assign(_buffer.begin(), _buffer.begin() + count);
+
+    // keep the rest at the beginning of the buffer
+    _buffer.erase(_buffer.begin(), _buffer.begin() + count);
+    _buffer_position -= std::min(_buffer_position, count);
+    _buffer_offset += count;
+
+    lock.lock();
+    _pending.push_back(std::move(chunk));
+    lock.unlock();
+    _condition.notify_all();
+  }
+
+  void ChunkWriter::WriterThread() {
+    std::vector<char> compressed;
+    for (;;) {
+      PendingChunk chunk;
+      {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _condition.wait(lock, [this]() { return _stop || !_pending.empty(); });
+        if (_pending.empty()) {
+          // stopped and everything written
+          break;
+        }
+        chunk = std::move(_pending.front());
+        _pending.pop_front();
+      }
+      _condition.notify_all();
+
+      if (!chunk.compress) {
+        _file.write(chunk.data.data(), chunk.data.size());
+      } else {
+        // data that doesn't compress is stored as is
+        const bool is_compressed = _compressor && _compressor(chunk.data, compressed);
+        const std::vector<char> &data = is_compressed ? compressed : chunk.data;
+        const ChunkHeader header{
+            is_compressed ? ChunkFormat::LZ4 : ChunkFormat::Stored,
+            static_cast<uint32_t>(chunk.data.size())};
+        WriteValue(_file, PacketHeader{
+            PacketId::Chunk,
+            static_cast<uint32_t>(sizeof(ChunkHeader) + data.size())});
+        WriteValue(_file, header);
+        _file.write(data.data(), data.size());
+      }
+
+      std::lock_guard<std::mutex> lock(_mutex);
+      chunk.data.clear();
+      _free_buffers.push_back(std::move(chunk.data));
+    }
+    _file.flush();
+  }
+
+  std::streamsize ChunkWriter::xsputn(const char *data, std::streamsize count) {
+    const size_t end = _buffer_position + static_cast<size_t>(count);
+    if (end > _buffer.size()) {
+      _buffer.resize(end);
+    }
+    std::memcpy(_buffer.data() + _buffer_position, data, static_cast<size_t>(count));
+    _buffer_position = end;
+    return count;
+  }
+
+  ChunkWriter::int_type ChunkWriter::overflow(int_type c) {
+    if (!traits_type::eq_int_type(c, traits_type::eof())) {
+      const char value = traits_type::to_char_type(c);
+      xsputn(&value, 1);
+    }
+    return traits_type::not_eof(c);
+  }
+
+  ChunkWriter::pos_type ChunkWriter::seekoff(
+      off_type offset,
+      std::ios_base::seekdir direction,
+      std::ios_base::openmode mode) {
+    off_type base = 0;
+    if (direction == std::ios_base::cur) {
+      base = static_cast<off_type>(_buffer_offset + _buffer_position);
+    } else if (direction == std::ios_base::end) {
+      base = static_cast<off_type>(_buffer_offset + _buffer.size());
+    }
+    return seekpos(base + offset, mode);
+  }
+
+  ChunkWriter::pos_type ChunkWriter::seekpos(pos_type position, std::ios_base::openmode mode) {
+    const off_type target = position;
+    // only the data not sent yet can be rewritten
+    if (!(mode & std::ios_base::out) ||
+        target < static_cast<off_type>(_buffer_offset) ||
+        target > static_cast<off_type>(_buffer_offset + _buffer.size())) {
+      return pos_type(off_type(-1));
+    }
+    _buffer_position = static_cast<size_t>(target - static_cast<off_type>(_buffer_offset));
+    return position;
+  }
+
+  // ===========================================================================
+  // -- ChunkReader ------------------------------------------------------------
+  // ===========================================================================
+
+  bool ChunkReader::Open(const std::string &filename) {
+    Close();
+
+    _file.open(filename, std::ios::binary);
+    if (!_file.is_open()) {
+      return false;
+    }
+    _file.seekg(0, std::ios::end);
+    _file_length = static_cast<uint64_t>(_file.tellg());
+    _file.seekg(0, std::ios::beg);
+
+    // the info header is not compressed, the file is compressed if a chunk
+    // follows it
+    PacketHeader packet;
+    const bool has_info = SkipInfo(_file);
+    const uint64_t header_size = static_cast<uint64_t>(_file.tellg());
+    if (!has_info || !ReadValue(_file, packet) || packet.id != PacketId::Chunk) {
+      Close();
+      return false;
+    }
+
+    // the header is the first chunk, stored as is
+    _chunks.push_back(Chunk{
+        0u,
+        0u,
+        static_cast<uint32_t>(header_size),
+        static_cast<uint32_t>(header_size),
+        ChunkFormat::Stored});
+    if (!LoadChunk(0u)) {
+      Close();
+      return false;
+    }
+    return true;
+  }
+
+  void ChunkReader::Close() {
+    if (_file.is_open()) {
+      _file.close();
+    }
+    _file.clear();
+    _chunks.clear();
+    _data.clear();
+    _compressed_data.clear();
+    _current_chunk = 0u;
+    _file_length = 0u;
+    _past_end = false;
+    _end_position = 0u;
+    setg(nullptr, nullptr, nullptr);
+  }
+
+  bool ChunkReader::FindNextChunk() {
+    const uint64_t offset = _chunks.back().offset + _chunks.back().size;
+    const uint64_t file_offset = _chunks.back().file_offset + _chunks.back().file_size;
+    if (file_offset + ChunkPacketHeaderSize > _file_length) {
+      return false;
+    }
+
+    PacketHeader packet;
+    ChunkHeader header;
+    _file.clear();
+    _file.seekg(static_cast<std::streamoff>(file_offset), std::ios::beg);
+    if (!ReadValue(_file, packet) ||
+        !ReadValue(_file, header) ||
+        packet.id != PacketId::Chunk ||
+        packet.size < sizeof(ChunkHeader)) {
+      return false;
+    }
+
+    // the last chunk can be incomplete if the recording was not closed
+    const uint32_t data_size = packet.size - static_cast<uint32_t>(sizeof(ChunkHeader));
+    if (file_offset + ChunkPacketHeaderSize + data_size > _file_length) {
+      return false;
+    }
+
+    _chunks.push_back(Chunk{
+        offset,
+        file_offset + ChunkPacketHeaderSize,
+        data_size,
+        header.uncompressed_size,
+        header.format});
+    return true;
+  }
+
+  bool ChunkReader::LoadChunk(size_t index) {
+    while (index >= _chunks.size()) {
+      if (!FindNextChunk()) {
+        return false;
+      }
+    }
+
+    const Chunk &entry = _chunks[index];
+    _data.resize(entry.size);
+    _file.clear();
+    _file.seekg(static_cast<std::streamoff>(entry.file_offset), std::ios::beg);
+    bool valid = false;
+    switch (entry.format) {
+      case ChunkFormat::Stored:
+        _file.read(_data.data(), static_cast<std::streamsize>(_data.size()));
+        valid = _file && entry.file_size == entry.size;
+        break;
+
+      case ChunkFormat::LZ4:
+        _compressed_data.resize(entry.file_size);
+        _file.read(_compressed_data.data(), static_cast<std::streamsize>(_compressed_data.size()));
+        valid = _file && _decompressor && _decompressor(_compressed_data, _data);
+        break;
+    }
+    if (!valid) {
+      return false;
+    }
+
+    _current_chunk = index;
+    _past_end = false;
+    setg(_data.data(), _data.data(), _data.data() + _data.size());
+    return true;
+  }
+
+  ChunkReader::int_type ChunkReader::underflow() {
+    if (gptr() < egptr()) {
+      return traits_type::to_int_type(*gptr());
+    }
+    if (_past_end) {
+      return traits_type::eof();
+    }
+    while (LoadChunk(_current_chunk + 1u)) {
+      if (gptr() < egptr()) {
+        return traits_type::to_int_type(*gptr());
+      }
+    }
+    return traits_type::eof();
+  }
+
+  ChunkReader::pos_type ChunkReader::seekoff(
+      off_type offset,
+      std::ios_base::seekdir direction,
+      std::ios_base::openmode mode) {
+    if (_chunks.empty()) {
+      return pos_type(off_type(-1));
+    }
+    off_type base = 0;
+    if (direction == std::ios_base::cur) {
+      base = static_cast<off_type>(_past_end ?
+          _end_position :
+          _chunks[_current_chunk].offset + static_cast<uint64_t>(gptr() - eback()));
+    } else if (direction == std::ios_base::end) {
+      while (FindNextChunk());
+      base = static_cast<off_type>(_chunks.back().offset + _chunks.back().size);
+    }
+    return seekpos(base + offset, mode);
+  }
+
+  ChunkReader::pos_type ChunkReader::seekpos(pos_type position, std::ios_base::openmode mode) {
+    const off_type target = position;
+    if (!(mode & std::ios_base::in) || _chunks.empty() || target < 0) {
+      return pos_type(off_type(-1));
+    }
+    const uint64_t offset = static_cast<uint64_t>(target);
+
+    // find the chunk with the position, looking for new chunks if needed
+    while (_chunks.back().offset + _chunks.back().size <= offset && FindNextChunk());
+    auto it = std::upper_bound(_chunks.begin(), _chunks.end(), offset,
+        [](uint64_t value, const Chunk &entry) {
+          return value < entry.offset;
+        });
+    const size_t index = static_cast<size_t>(std::distance(_chunks.begin(), it)) - 1u;
+
+    // as with files, it is possible to seek past the end, but then there is
+    // nothing to read
+    if (offset >= _chunks[index].offset + _chunks[index].size ||
+        ((index != _current_chunk || _past_end) && !LoadChunk(index))) {
+      _past_end = true;
+      _end_position = offset;
+      setg(nullptr, nullptr, nullptr);
+      return position;
+    }
+
+    setg(eback(), eback() + (offset - _chunks[index].offset), egptr());
+    return position;
+  }
+
+} // namespace recorder
+} // namespace carla
@@ -0,0 +1,189 @@
+// Copyright (c) 2023 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/NonCopyable.h"
+#include "carla/recorder/RecorderPackets.h"
+
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace carla {
+namespace recorder {
+
+  // A compressed recording has the info header as is, followed by Chunk
+  // packets. Each chunk is compressed on its own and holds whole frames, once
+  // decompressed and put together they are the same packets of a plain
+  // recording. Positions in the file (as the ones in the index) always refer
+  // to this uncompressed stream.
+
+  /// Compresses the data of a chunk. Returns false if the data can't be
+  /// compressed or it does not get smaller, then the chunk is stored as is.
+  using ChunkCompressor = std::function<bool(const std::vector<char> &data, std::vector<char> &compressed)>;
+
+  /// Decompresses the data of a chunk into @a data, already sized to the
+  /// uncompressed size. Returns false if the data is not valid.
+  using ChunkDecompressor = std::function<bool(const std::vector<char> &compressed, std::vector<char> &data)>;
+
+  /// Stream buffer that buffers everything written to it and sends it, in
+  /// chunks, to a thread that compresses and writes them to the file. Seeking
+  /// is only possible in the data not sent yet.
+  class ChunkWriter
+    : public std::streambuf,
+      private NonCopyable {
+  public:
+
+    /// Uncompressed size from which frames are sent as a chunk.
+    static constexpr size_t DefaultChunkSize = 4u * 1024u * 1024u;
+
+    /// Chunks that can wait for the writer thread before the recorder has to.
+    static constexpr size_t MaxPendingChunks = 2u;
+
+    explicit ChunkWriter(ChunkCompressor compressor, size_t chunk_size = DefaultChunkSize)
+      : _compressor(std::move(compressor)),
+        _chunk_size(chunk_size) {}
+
+    ~ChunkWriter();
+
+    bool Open(const std::string &filename);
+
+    /// Sends what is left as the last chunk and waits for it to be written.
+    void Close();
+
+    bool IsOpen() const {
+      return _file.is_open();
+    }
+
+    /// Writes the data buffered so far as is, used for the info header so the
+    /// file can be identified without decompressing it.
+    void WriteUncompressed();
+
+    /// Sends the data before @a position to be compressed, if there is
+    /// enough for a chunk.
+    void FlushBefore(std::streampos position);
+
+  protected:
+
+    std::streamsize xsputn(const char *data, std::streamsize count) override;
+
+    int_type overflow(int_type c) override;
+
+    pos_type seekoff(off_type offset, std::ios_base::seekdir direction, std::ios_base::openmode mode) override;
+
+    pos_type seekpos(pos_type position, std::ios_base::openmode mode) override;
+
+  private:
+
+    struct PendingChunk {
+      std::vector<char> data;
+      bool compress;
+    };
+
+    /// Sends the first @a count bytes of the buffer to the writer thread.
+    void Send(size_t count, bool compress);
+
+    void WriterThread();
+
+    const ChunkCompressor _compressor;
+
+    const size_t _chunk_size;
+
+    std::ofstream _file;
+
+    /// Data not sent yet, starting at _buffer_offset of the stream.
+    std::vector<char> _buffer;
+
+    size_t _buffer_position = 0u;
+
+    uint64_t _buffer_offset = 0u;
+
+    /// Chunks waiting for the writer thread, and buffers to reuse.
+    std::thread _thread;
+
+    std::mutex _mutex;
+
+    std::condition_variable _condition;
+
+    std::deque<PendingChunk> _pending;
+
+    std::vector<std::vector<char>> _free_buffers;
+
+    bool _stop = false;
+  };
+
+  /// Stream buffer that reads a compressed recording as if it were a plain
+  /// one, decompressing the chunk at the current position. The last chunk is
+  /// ignored if it is incomplete, as in a recording that was not closed.
+  class ChunkReader
+    : public std::streambuf,
+      private NonCopyable {
+  public:
+
+    explicit ChunkReader(ChunkDecompressor decompressor)
+      : _decompressor(std::move(decompressor)) {}
+
+    /// Returns false if the file can't be opened or it is not compressed.
+    bool Open(const std::string &filename);
+
+    void Close();
+
+    bool IsOpen() const {
+      return _file.is_open();
+    }
+
+  protected:
+
+    int_type underflow() override;
+
+    pos_type seekoff(off_type offset, std::ios_base::seekdir direction, std::ios_base::openmode mode) override;
+
+    pos_type seekpos(pos_type position, std::ios_base::openmode mode) override;
+
+  private:
+
+    struct Chunk {
+      uint64_t offset;
+      uint64_t file_offset;
+      uint32_t file_size;
+      uint32_t size;
+      ChunkFormat format;
+    };
+
+    /// Reads the header of the chunk after the last known one.
+    bool FindNextChunk();
+
+    bool LoadChunk(size_t index);
+
+    const ChunkDecompressor _decompressor;
+
+    std::ifstream _file;
+
+    std::vector<Chunk> _chunks;
+
+    std::vector<char> _data;
+
+    std::vector<char> _compressed_data;
+
+    size_t _current_chunk = 0u;
+
+    uint64_t _file_length = 0u;
+
+    /// Position when seeking past the last chunk.
+    bool _past_end = false;
+
+    uint64_t _end_position = 0u;
+  };
+
+} // namespace recorder
+} // namespace carla
@@ -0,0 +1,119 @@
+// Copyright (c) 2023 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include <cstdint>
+
+namespace carla {
+namespace recorder {
+
+  /// Id of each packet in a recording, see ref_recorder_binary_file_format.md.
+  /// Shared with the recorder in the simulator, new packets must be added at
+  /// the end.
+  enum class PacketId : uint8_t {
+    FrameStart = 0,
+    FrameEnd,
+    EventAdd,
+    EventDel,
+    EventParent,
+    Collision,
+    Position,
+    State,
+    AnimVehicle,
+    AnimWalker,
+    VehicleLight,
+    SceneLight,
+    Kinematics,
+    BoundingBox,
+    PlatformTime,
+    PhysicsControl,
+    TrafficLightTime,
+    TriggerVolume,
+    FrameCounter,
+    WalkerBones,
+    VisualTime,
+    AnimVehicleWheels,
+    AnimBiker,
+    Keyframe,
+    Index,
+    IndexFooter,
+    Chunk
+  };
+
+  /// Type of the actors in the Event Add packet.
+  enum class ActorType : uint8_t {
+    Other = 0,
+    Vehicle,
+    Walker,
+    TrafficLight,
+    TrafficSign,
+    Sensor
+  };
+
+  /// Format of the data of a Chunk packet.
+  enum class ChunkFormat : uint8_t {
+    Stored = 0,
+    LZ4
+  };
+
+  /// Magic number at the end of the Index Footer packet.
+  constexpr uint32_t IndexFooterMagic = 0x58495243u;
+
+  /// Database id of the collisions with objects that are not actors.
+  constexpr uint32_t NoActorId = 0xFFFFFFFFu;
+
+  // Fixed size records, as written by the recorder. Locations are in
+  // centimeters and rotations are Euler angles (roll, pitch, yaw) in degrees.
+
+#pragma pack(push, 1)
+
+  struct PacketHeader {
+    PacketId id;
+    uint32_t size;
+  };
+
+  struct FrameRecord {
+    uint64_t id;
+    double duration;
+    double elapsed;
+  };
+
+  struct PositionRecord {
+    uint32_t database_id;
+    float location[3u];
+    float rotation[3u];
+  };
+
+  struct CollisionRecord {
+    uint32_t id;
+    uint32_t database_id_1;
+    uint32_t database_id_2;
+    bool is_actor_1_hero;
+    bool is_actor_2_hero;
+  };
+
+  struct ChunkHeader {
+    ChunkFormat format;
+    uint32_t uncompressed_size;
+  };
+
+  struct IndexFrameRecord {
+    double elapsed;
+    uint64_t offset;
+  };
+
+#pragma pack(pop)
+
+  static_assert(sizeof(PacketHeader) == 5u, "Invalid packet header size.");
+  static_assert(sizeof(FrameRecord) == 24u, "Invalid frame record size.");
+  static_assert(sizeof(PositionRecord) == 28u, "Invalid position record size.");
+  static_assert(sizeof(CollisionRecord) == 14u, "Invalid collision record size.");
+  static_assert(sizeof(ChunkHeader) == 5u, "Invalid chunk header size.");
+  static_assert(sizeof(IndexFrameRecord) == 16u, "Invalid index record size.");
+
+} // namespace recorder
+} // namespace carla
@@ -0,0 +1,561 @@
+// Copyright (c) 2023 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "carla/recorder/RecorderQuery.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <condition_variable>
+#include <exception>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace carla {
+namespace recorder {
+
+  // ===========================================================================
+  // -- Static local methods ---------------------------------------------------
+  // ===========================================================================
+
+namespace {
+
+  /// Reads the values of a packet, checking they are inside it.
+  class PacketCursor {
+  public:
+
+    explicit PacketCursor(const Packet &packet)
+      : _position(packet.data),
+        _end(packet.data + packet.size) {}
+
+    template <typename T>
+    bool Read(T &value) {
+      if (static_cast<size_t>(_end - _position) < sizeof(T)) {
+        return false;
+      }
+      std::memcpy(&value, _position, sizeof(T));
+      _position += sizeof(T);
+      return true;
+    }
+
+    bool Skip(size_t size) {
+      if (static_cast<size_t>(_end - _position) < size) {
+        return false;
+      }
+      _position += size;
+      return true;
+    }
+
+    bool ReadString(std::string &value) {
+      uint16_t length = 0u;
+      if (!Read(length) || static_cast<size_t>(_end - _position) < length) {
+        return false;
+      }
+      value.assign(_position, length);
+      _position += length;
+      return true;
+    }
+
+    bool SkipString() {
+      uint16_t length = 0u;
+      return Read(length) && Skip(length);
+    }
+
+  private:
+
+    const char *_position;
+
+    const char *_end;
+  };
+
+} // namespace
+
+  /// Calls @a scan with the packets of each segment of the file, in parallel,
+  /// and returns the results of the segments in order.
+  template <typename T, typename ScanFunction>
+  static std::vector<T> ScanSegments(const RecordingFile &file, ScanFunction &&scan) {
+    std::vector<T> results(file.GetNumberOfSegments());
+
+    // segments can take very different times (compressed or not, more or
+    // less actors), so each thread takes the next one when it is done
+    std::atomic_size_t next_segment{0u};
+    std::exception_ptr error;
+    std::mutex error_mutex;
+    auto worker = [&]() {
+      std::vector<char> buffer;
+      try {
+        for (size_t index = next_segment++; index < results.size(); index = next_segment++) {
+          scan(file.ReadSegment(index, buffer), results[index]);
+        }
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(error_mutex);
+        if (!error) {
+          error = std::current_exception();
+        }
+        next_segment = results.size();
+      }
+    };
+
+    const size_t number_of_threads = std::min<size_t>(
+        std::max(1u, std::thread::hardware_concurrency()),
+        results.size());
+    std::vector<std::thread> workers;
+    for (size_t i = 1u; i < number_of_threads; ++i) {
+      workers.emplace_back(worker);
+    }
+    worker();
+    for (auto &thread : workers) {
+      thread.join();
+    }
+    if (error) {
+      std::rethrow_exception(error);
+    }
+    return results;
+  }
+
+  /// Calls @a scan with the packets of each segment of the file, in parallel,
+  /// and @a consume with the result of each segment, in order, as soon as it
+  /// is ready. Only the results of a few segments are kept in memory at the
+  /// same time, for the queries that have to go through the segments in
+  /// order.
+  template <typename T, typename ScanFunction, typename ConsumeFunction>
+  static void StreamSegments(const RecordingFile &file, ScanFunction &&scan, ConsumeFunction &&consume) {
+    const size_t number_of_segments = file.GetNumberOfSegments();
+    if (number_of_segments == 0u) {
+      return;
+    }
+    const size_t number_of_threads = std::min<size_t>(
+        std::max(1u, std::thread::hardware_concurrency()),
+        number_of_segments);
+
+    // segments scanned ahead of the one being consumed
+    const size_t window = 2u * number_of_threads;
+    std::vector<T> results(window);
+    std::vector<bool> ready(window, false);
+    size_t next_segment = 0u;
+    size_t consumed = 0u;
+    bool stop = false;
+    std::exception_ptr error;
+    std::mutex mutex;
+    std::condition_variable condition;
+
+    auto worker = [&]() {
+      std::vector<char> buffer;
+      for (;;) {
+        size_t index;
+        {
+          std::unique_lock<std::mutex> lock(mutex);
+          condition.wait(lock, [&]() { return stop || next_segment < consumed + window; });
+          if (stop || next_segment >= number_of_segments) {
+            return;
+          }
+          index = next_segment++;
+        }
+        T result;
+        try {
+          scan(file.ReadSegment(index, buffer), result);
+        } catch (...) {
+          std::lock_guard<std::mutex> lock(mutex);
+          if (!error) {
+            error = std::current_exception();
+          }
+          stop = true;
+          condition.notify_all();
+          return;
+        }
+        {
+          std::lock_guard<std::mutex> lock(mutex);
+          results[index % window] = std::move(result);
+          ready[index % window] = true;
+        }
+        condition.notify_all();
+      }
+    };
+
+    std::vector<std::thread> workers;
+    for (size_t i = 0u; i < number_of_threads; ++i) {
+      workers.emplace_back(worker);
+    }
+    for (size_t index = 0u; index < number_of_segments; ++index) {
+      T result;
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        condition.wait(lock, [&]() { return stop || ready[index % window]; });
+        if (stop) {
+          break;
+        }
+        result = std::move(results[index % window]);
+        ready[index % window] = false;
+        ++consumed;
+      }
+      condition.notify_all();
+      consume(result);
+    }
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      stop = true;
+    }
+    condition.notify_all();
+    for (auto &thread : workers) {
+      thread.join();
+    }
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  }
+
+  template <typename T>
+  static std::vector<T> Join(std::vector<std::vector<T>> &&parts) {
+    size_t total = 0u;
+    for (const auto &part : parts) {
+      total += part.size();
+    }
+    std::vector<T> result;
+    result.reserve(total);
+    for (auto &part : parts) {
+      result.insert(result.end(), part.begin(), part.end());
+      part = std::vector<T>{};
+    }
+    return result;
+  }
+
+  static bool ReadFrame(const Packet &packet, FrameRecord &frame) {
+    return PacketCursor(packet).Read(frame);
+  }
+
+  /// Calls @a callback with each record of a packet made of a count and
+  /// fixed size records.
+  template <typename T, typename Function>
+  static void ForEachRecord(const Packet &packet, Function &&callback) {
+    PacketCursor cursor(packet);
+    uint16_t total = 0u;
+    cursor.Read(total);
+    T record;
+    for (uint16_t i = 0u; i < total && cursor.Read(record); ++i) {
+      callback(record);
+    }
+  }
+
+  static void ReadActors(const Packet &packet, double elapsed, std::vector<ActorInfo> &actors) {
+    PacketCursor cursor(packet);
+    uint16_t total = 0u;
+    cursor.Read(total);
+    for (uint16_t i = 0u; i < total; ++i) {
+      ActorInfo actor;
+      uint32_t uid;
+      uint16_t attributes = 0u;
+      if (!cursor.Read(actor.id) ||
+          !cursor.Read(actor.type) ||
+          !cursor.Skip(2u * 3u * sizeof(float)) ||
+          !cursor.Read(uid) ||
+          !cursor.ReadString(actor.type_id) ||
+          !cursor.Read(attributes)) {
+        return;
+      }
+      for (uint16_t j = 0u; j < attributes; ++j) {
+        if (!cursor.Skip(sizeof(uint8_t)) || !cursor.SkipString() || !cursor.SkipString()) {
+          return;
+        }
+      }
+      actor.spawn_time = elapsed;
+      actor.destroy_time = -1.0;
+      actors.emplace_back(std::move(actor));
+    }
+  }
+
+  static char GetCategory(ActorType type) {
+    switch (type) {
+      case ActorType::Vehicle:      return 'v';
+      case ActorType::Walker:       return 'w';
+      case ActorType::TrafficLight: return 't';
+      default:                      return 'o';
+    }
+  }
+
+  // ===========================================================================
+  // -- RecorderQuery ----------------------------------------------------------
+  // ===========================================================================
+
+  std::vector<ActorInfo> RecorderQuery::GetActors() const {
+    struct SegmentActors {
+      std::vector<ActorInfo> spawned;
+      std::vector<std::pair<uint32_t, double>> destroyed;
+    };
+    auto segments = ScanSegments<SegmentActors>(_file, [](PacketReader reader, SegmentActors &result) {
+      FrameRecord frame{0u, 0.0, 0.0};
+      Packet packet;
+      while (reader.Next(packet)) {
+        switch (packet.id) {
+          case PacketId::FrameStart:
+            ReadFrame(packet, frame);
+            break;
+          case PacketId::EventAdd:
+            ReadActors(packet, frame.elapsed, result.spawned);
+            break;
+          case PacketId::EventDel:
+            ForEachRecord<uint32_t>(packet, [&](uint32_t id) {
+              result.destroyed.emplace_back(id, frame.elapsed);
+            });
+            break;
+          default:
+            break;
+        }
+      }
+    });
+
+    std::map<uint32_t, ActorInfo> actors;
+    for (auto &segment : segments) {
+      for (auto &actor : segment.spawned) {
+        actors[actor.id] = std::move(actor);
+      }
+      for (const auto &destroyed : segment.destroyed) {
+        auto it = actors.find(destroyed.first);
+        if (it != actors.end()) {
+          it->second.destroy_time = destroyed.second;
+        }
+      }
+    }
+    std::vector<ActorInfo> result;
+    result.reserve(actors.size());
+    for (auto &actor : actors) {
+      result.emplace_back(std::move(actor.second));
+    }
+    return result;
+  }
+
+  std::vector<TrajectoryPoint> RecorderQuery::GetTrajectories(
+      const std::vector<uint32_t> &actor_ids) const {
+    std::vector<uint32_t> filter(actor_ids);
+    std::sort(filter.begin(), filter.end());
+    auto segments = ScanSegments<std::vector<TrajectoryPoint>>(_file,
+        [&filter](PacketReader reader, std::vector<TrajectoryPoint> &result) {
+      FrameRecord frame{0u, 0.0, 0.0};
+      Packet packet;
+      while (reader.Next(packet)) {
+        if (packet.id == PacketId::FrameStart) {
+          ReadFrame(packet, frame);
+        } else if (packet.id == PacketId::Position) {
+          ForEachRecord<PositionRecord>(packet, [&](const PositionRecord &position) {
+            if (!filter.empty() &&
+                !std::binary_search(filter.begin(), filter.end(), position.database_id)) {
+              return;
+            }
+            // the recorder stores the rotation as (roll, pitch, yaw)
+            result.push_back(TrajectoryPoint{
+                frame.elapsed,
+                static_cast<uint32_t>(frame.id),
+                position.database_id,
+                position.location[0u] / 100.0f,
+                position.location[1u] / 100.0f,
+                position.location[2u] / 100.0f,
+                position.rotation[1u],
+                position.rotation[2u],
+                position.rotation[0u]});
+          });
+        }
+      }
+    });
+    return Join(std::move(segments));
+  }
+
+  std::vector<Collision> RecorderQuery::GetCollisions(
+      const char category_1,
+      const char category_2) const {
+    struct FrameCollision {
+      uint64_t frame;
+      double elapsed;
+      CollisionRecord record;
+    };
+    struct SegmentCollisions {
+      std::vector<ActorInfo> actors;
+      std::vector<FrameCollision> collisions;
+    };
+    auto segments = ScanSegments<SegmentCollisions>(_file, [](PacketReader reader, SegmentCollisions &result) {
+      FrameRecord frame{0u, 0.0, 0.0};
+      Packet packet;
+      while (reader.Next(packet)) {
+        switch (packet.id) {
+          case PacketId::FrameStart:
+            ReadFrame(packet, frame);
+            break;
+          case PacketId::EventAdd:
+            ReadActors(packet, frame.elapsed, result.actors);
+            break;
+          case PacketId::Collision:
+            ForEachRecord<CollisionRecord>(packet, [&](const CollisionRecord &collision) {
+              result.collisions.push_back(FrameCollision{frame.id, frame.elapsed, collision});
+            });
+            break;
+          default:
+            break;
+        }
+      }
+    });
+
+    // database ids are never reused, so the type of an actor can be looked up
+    // in any frame
+    std::unordered_map<uint32_t, ActorType> types;
+    for (const auto &segment : segments) {
+      for (const auto &actor : segment.actors) {
+        types[actor.id] = actor.type;
+      }
+    }
+    auto get_category = [&types](uint32_t id) {
+      auto it = types.find(id);
+      return it == types.end() ? 'o' : GetCategory(it->second);
+    };
+    auto pass_filter = [](char filter, char category, bool is_hero) {
+      return filter == 'a' || filter == category || (filter == 'h' && is_hero);
+    };
+
+    // a collision is shown only in the first frame, if the same pair of
+    // actors collides in consecutive frames it is the same collision
+    std::unordered_set<uint64_t> previous_frame;
+    std::unordered_set<uint64_t> current_frame;
+    uint64_t current_frame_id = 0u;
+    std::vector<Collision> result;
+    for (const auto &segment : segments) {
+      for (const auto &collision : segment.collisions) {
+        const auto &record = collision.record;
+        const char type_1 = record.database_id_1 == NoActorId ? 'o' : get_category(record.database_id_1);
+        const char type_2 = record.database_id_2 == NoActorId ? 'o' : get_category(record.database_id_2);
+        if (!pass_filter(category_1, type_1, record.is_actor_1_hero) ||
+            !pass_filter(category_2, type_2, record.is_actor_2_hero)) {
+          continue;
+        }
+        if (collision.frame != current_frame_id) {
+          if (collision.frame == current_frame_id + 1u) {
+            previous_frame = std::move(current_frame);
+          } else {
+            previous_frame.clear();
+          }
+          current_frame.clear();
+          current_frame_id = collision.frame;
+        }
+        const uint64_t pair = (static_cast<uint64_t>(record.database_id_1) << 32u) | record.database_id_2;
+        if (previous_frame.count(pair) == 0u) {
+          result.push_back(Collision{
+              collision.elapsed,
+              static_cast<uint32_t>(collision.frame),
+              record.database_id_1,
+              record.database_id_2,
+              type_1,
+              type_2,
+              record.is_actor_1_hero,
+              record.is_actor_2_hero});
+        }
+        current_frame.insert(pair);
+      }
+    }
+    return result;
+  }
+
+  std::vector<BlockedActor> RecorderQuery::GetBlockedActors(
+      const double min_time,
+      const double min_distance) const {
+    struct Sample {
+      double elapsed;
+      double duration;
+      PositionRecord position;
+    };
+    struct SegmentSamples {
+      std::vector<Sample> samples;
+      /// Actors destroyed, with the number of samples before.
+      std::vector<std::pair<size_t, uint32_t>> destroyed;
+    };
+
+    // positions are in centimeters in the file
+    const float max_distance = static_cast<float>(100.0 * min_distance);
+    struct ActorState {
+      float location[3u] = {0.0f, 0.0f, 0.0f};
+      double elapsed = 0.0;
+      double duration = 0.0;
+    };
+    std::map<uint32_t, ActorState> actors;
+    std::vector<BlockedActor> result;
+    auto add_result = [&](uint32_t id, const ActorState &state) {
+      if (state.duration >= min_time) {
+        result.push_back(BlockedActor{
+            state.elapsed,
+            state.duration,
+            id,
+            state.location[0u] / 100.0f,
+            state.location[1u] / 100.0f,
+            state.location[2u] / 100.0f});
+      }
+    };
+    auto remove_actor = [&](uint32_t id) {
+      auto it = actors.find(id);
+      if (it != actors.end()) {
+        add_result(id, it->second);
+        actors.erase(it);
+      }
+    };
+
+    // whether an actor is blocked depends on where it stopped, that can be
+    // in any segment before, so the samples are processed in order and only
+    // the state of the actors alive is kept
+    StreamSegments<SegmentSamples>(_file, [](PacketReader reader, SegmentSamples &segment) {
+      FrameRecord frame{0u, 0.0, 0.0};
+      Packet packet;
+      while (reader.Next(packet)) {
+        if (packet.id == PacketId::FrameStart) {
+          ReadFrame(packet, frame);
+        } else if (packet.id == PacketId::Position) {
+          ForEachRecord<PositionRecord>(packet, [&](const PositionRecord &position) {
+            segment.samples.push_back(Sample{frame.elapsed, frame.duration, position});
+          });
+        } else if (packet.id == PacketId::EventDel) {
+          ForEachRecord<uint32_t>(packet, [&](uint32_t id) {
+            segment.destroyed.emplace_back(segment.samples.size(), id);
+          });
+        }
+      }
+    }, [&](const SegmentSamples &segment) {
+      auto destroyed = segment.destroyed.begin();
+      for (size_t i = 0u; i < segment.samples.size(); ++i) {
+        for (; destroyed != segment.destroyed.end() && destroyed->first == i; ++destroyed) {
+          remove_actor(destroyed->second);
+        }
+        const auto &position = segment.samples[i].position;
+        auto &state = actors[position.database_id];
+        const float dx = position.location[0u] - state.location[0u];
+        const float dy = position.location[1u] - state.location[1u];
+        const float dz = position.location[2u] - state.location[2u];
+        if (std::sqrt(dx * dx + dy * dy + dz * dz) < max_distance) {
+          // actor stopped
+          if (state.duration == 0.0) {
+            state.elapsed = segment.samples[i].elapsed;
+          }
+          state.duration += segment.samples[i].duration;
+        } else {
+          // actor moving again
+          add_result(position.database_id, state);
+          state.duration = 0.0;
+          std::copy_n(position.location, 3u, state.location);
+        }
+      }
+      for (; destroyed != segment.destroyed.end(); ++destroyed) {
+        remove_actor(destroyed->second);
+      }
+    });
+
+    // actors that did not move again
+    for (const auto &actor : actors) {
+      add_result(actor.first, actor.second);
+    }
+
+    std::stable_sort(result.begin(), result.end(), [](const BlockedActor &lhs, const BlockedActor &rhs) {
+      return lhs.duration > rhs.duration;
+    });
+    return result;
+  }
+
+} // namespace recorder
+} // namespace carla
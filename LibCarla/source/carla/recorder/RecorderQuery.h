@@ -0,0 +1,109 @@
+// Copyright (c) 2023 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/recorder/RecordingFile.h"
+
+#include <string>
+#include <vector>
+
+namespace carla {
+namespace recorder {
+
+  /// An actor created during the recording.
+  struct ActorInfo {
+    uint32_t id;
+    ActorType type;
+    std::string type_id;
+    double spawn_time;
+    /// Negative if the actor was never destroyed.
+    double destroy_time;
+  };
+
+  // Records returned by the queries. Their layout is part of the Python API,
+  // that returns them as numpy structured arrays. Locations are in meters and
+  // rotations in degrees, as in the rest of the client.
+
+  struct TrajectoryPoint {
+    double elapsed;
+    uint32_t frame;
+    uint32_t actor_id;
+    float x, y, z;
+    float pitch, yaw, roll;
+  };
+
+  struct Collision {
+    double elapsed;
+    uint32_t frame;
+    uint32_t actor_id_1;
+    uint32_t actor_id_2;
+    char type_1;
+    char type_2;
+    bool is_actor_1_hero;
+    bool is_actor_2_hero;
+  };
+
+  struct BlockedActor {
+    /// Time at which the actor stopped.
+    double elapsed;
+    double duration;
+    uint32_t actor_id;
+    float x, y, z;
+  };
+
+  static_assert(sizeof(TrajectoryPoint) == 40u, "Unexpected padding.");
+  static_assert(sizeof(Collision) == 24u, "Unexpected padding.");
+  static_assert(sizeof(BlockedActor) == 32u, "Unexpected padding.");
+
+  /// Queries on a recording, without a simulator. Each query is a single pass
+  /// over the file that reads its segments in parallel, parsing only the
+  /// packets it needs, and joins the results of the segments in order.
+  ///
+  /// Same queries as the ones of the simulator (show_recorder_collisions and
+  /// show_recorder_actors_blocked), but returning the records instead of a
+  /// text.
+  class RecorderQuery : private NonCopyable {
+  public:
+
+    explicit RecorderQuery(
+        const std::string &filename,
+        size_t segment_size = RecordingFile::DefaultSegmentSize)
+      : _file(filename, segment_size) {}
+
+    const RecordingInfo &GetInfo() const {
+      return _file.GetInfo();
+    }
+
+    /// Actors created during the recording, sorted by id.
+    std::vector<ActorInfo> GetActors() const;
+
+    /// Location and rotation of the actors at every frame, sorted by frame.
+    /// If @a actor_ids is not empty, only those actors are returned.
+    std::vector<TrajectoryPoint> GetTrajectories(
+        const std::vector<uint32_t> &actor_ids = {}) const;
+
+    /// Collisions between actors of the given categories: 'h' hero, 'v'
+    /// vehicle, 'w' walker, 't' traffic light, 'o' other and 'a' any. Only
+    /// the first frame of each collision is returned.
+    std::vector<Collision> GetCollisions(
+        char category_1 = 'a',
+        char category_2 = 'a') const;
+
+    /// Actors that moved less than @a min_distance meters for at least
+    /// @a min_time seconds, sorted by the time they were blocked, longest
+    /// first.
+    std::vector<BlockedActor> GetBlockedActors(
+        double min_time = 60.0,
+        double min_distance = 1.0) const;
+
+  private:
+
+    RecordingFile _file;
+  };
+
+} // namespace recorder
+} // namespace carla
@@ -0,0 +1,272 @@
+// Copyright (c) 2023 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "carla/recorder/RecordingFile.h"
+
+#include "carla/Debug.h"
+#include "carla/Exception.h"
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include <stdexcept>
+
+namespace carla {
+namespace recorder {
+
+  namespace bip = boost::interprocess;
+
+  struct RecordingFile::Mapping {
+    bip::file_mapping file;
+    bip::mapped_region region;
+  };
+
+  // ===========================================================================
+  // -- Static local methods ---------------------------------------------------
+  // ===========================================================================
+
+  template <typename T>
+  static bool ReadValue(const char *data, size_t size, size_t &position, T &value) {
+    if (size - position < sizeof(T)) {
+      return false;
+    }
+    std::memcpy(&value, data + position, sizeof(T));
+    position += sizeof(T);
+    return true;
+  }
+
+  static bool ReadString(const char *data, size_t size, size_t &position, std::string &value) {
+    uint16_t length = 0u;
+    if (!ReadValue(data, size, position, length) || size - position < length) {
+      return false;
+    }
+    value.assign(data + position, length);
+    position += length;
+    return true;
+  }
+
+  // ===========================================================================
+  // -- DecompressLZ4 ----------------------------------------------------------
+  // ===========================================================================
+
+  // A sequence is a token with the lengths of the literals and the
+  // match, the literals, and the offset of the match; the last sequence has
+  // only literals.
+  bool DecompressLZ4(const char *source, size_t source_size, char *destination, size_t destination_size) {
+    const auto *input = reinterpret_cast<const uint8_t *>(source);
+    const auto *input_end = input + source_size;
+    auto *output = reinterpret_cast<uint8_t *>(destination);
+    auto *output_begin = output;
+    auto *output_end = output + destination_size;
+
+    auto read_length = [&](size_t length, size_t &result) {
+      if (length == 15u) {
+        uint8_t byte;
+        do {
+          if (input == input_end) {
+            return false;
+          }
+          byte = *input++;
+          length += byte;
+        } while (byte == 255u);
+      }
+      result = length;
+      return true;
+    };
+
+    while (input < input_end) {
+      const uint8_t token = *input++;
+
+      size_t length;
+      if (!read_length(token >> 4u, length) ||
+          length > static_cast<size_t>(input_end - input) ||
+          length > static_cast<size_t>(output_end - output)) {
+        return false;
+      }
+      std::memcpy(output, input, length);
+      input += length;
+      output += length;
+      if (input == input_end) {
+        break;
+      }
+
+      if (input_end - input < 2) {
+        return false;
+      }
+      const size_t offset = input[0u] | (input[1u] << 8u);
+      input += 2u;
+      if (offset == 0u || offset > static_cast<size_t>(output - output_begin)) {
+        return false;
+      }
+      if (!read_length(token & 15u, length)) {
+        return false;
+      }
+      length += 4u;
+      if (length > static_cast<size_t>(output_end - output)) {
+        return false;
+      }
+      // the match can overlap the output, copy it byte by byte in that case
+      const uint8_t *match = output - offset;
+      if (offset >= length) {
+        std::memcpy(output, match, length);
+        output += length;
+      } else {
+        for (size_t i = 0u; i < length; ++i) {
+          *output++ = *match++;
+        }
+      }
+    }
+    return output == output_end;
+  }
+
+  // ===========================================================================
+  // -- RecordingFile ----------------------------------------------------------
+  // ===========================================================================
+
+  RecordingFile::RecordingFile(const std::string &filename, size_t segment_size) {
+    try {
+      _mapping = std::make_unique<Mapping>();
+      _mapping->file = bip::file_mapping(filename.c_str(), bip::read_only);
+      _mapping->region = bip::mapped_region(_mapping->file, bip::read_only);
+    } catch (const bip::interprocess_exception &e) {
+      throw_exception(std::runtime_error(filename + ": " + e.what()));
+    }
+    _data = static_cast<const char *>(_mapping->region.get_address());
+    _size = _mapping->region.get_size();
+
+    size_t header_size = 0u;
+    ReadInfo(header_size);
+    if (_info.magic != "CARLA_RECORDER") {
+      throw_exception(std::runtime_error(filename + ": not a CARLA recording"));
+    }
+
+    // the file is compressed if a chunk follows the header
+    PacketReader reader(_data + header_size, _data + _size);
+    Packet packet;
+    _compressed = reader.Next(packet) && packet.id == PacketId::Chunk;
+    if (_compressed) {
+      FindChunks(header_size);
+    } else if (!FindSegmentsFromIndex(header_size, segment_size)) {
+      FindSegmentsFromPackets(header_size, segment_size);
+    }
+  }
+
+  RecordingFile::~RecordingFile() = default;
+
+  void RecordingFile::ReadInfo(size_t &header_size) {
+    size_t position = 0u;
+    if (!ReadValue(_data, _size, position, _info.version) ||
+        !ReadString(_data, _size, position, _info.magic) ||
+        !ReadValue(_data, _size, position, _info.date) ||
+        !ReadString(_data, _size, position, _info.map_name)) {
+      _info = RecordingInfo{};
+    }
+    header_size = position;
+  }
+
+  void RecordingFile::FindChunks(size_t begin) {
+    // the last chunk can be incomplete if the recording was not closed
+    PacketReader reader(_data + begin, _data + _size);
+    Packet packet;
+    while (reader.Next(packet) &&
+           packet.id == PacketId::Chunk &&
+           packet.size >= sizeof(ChunkHeader)) {
+      ChunkHeader header;
+      std::memcpy(&header, packet.data, sizeof(ChunkHeader));
+      _segments.push_back(Segment{
+          static_cast<uint64_t>(packet.data + sizeof(ChunkHeader) - _data),
+          packet.size - sizeof(ChunkHeader),
+          header.uncompressed_size,
+          header.format});
+    }
+  }
+
+  bool RecordingFile::FindSegmentsFromIndex(size_t begin, size_t segment_size) {
+    // the footer is a packet with the offset of the index and the magic
+    constexpr size_t footer_size = sizeof(PacketHeader) + sizeof(uint64_t) + sizeof(uint32_t);
+    if (_size < begin + footer_size) {
+      return false;
+    }
+    size_t position = _size - footer_size;
+    PacketHeader footer;
+    uint64_t index_offset = 0u;
+    uint32_t magic = 0u;
+    ReadValue(_data, _size, position, footer);
+    ReadValue(_data, _size, position, index_offset);
+    ReadValue(_data, _size, position, magic);
+    if (footer.id != PacketId::IndexFooter ||
+        magic != IndexFooterMagic ||
+        index_offset < begin ||
+        index_offset >= _size - footer_size) {
+      return false;
+    }
+
+    // the index must end just before the footer
+    position = index_offset;
+    PacketHeader header;
+    uint32_t total = 0u;
+    if (!ReadValue(_data, _size, position, header) ||
+        header.id != PacketId::Index ||
+        index_offset + sizeof(PacketHeader) + header.size + footer_size != _size ||
+        !ReadValue(_data, _size, position, total) ||
+        (_size - position) / sizeof(IndexFrameRecord) < total) {
+      return false;
+    }
+
+    // a new segment starts at the first frame past the segment size
+    std::vector<Segment> segments;
+    uint64_t start = begin;
+    for (uint32_t i = 0u; i < total; ++i) {
+      IndexFrameRecord frame;
+      ReadValue(_data, _size, position, frame);
+      if (frame.offset < start || frame.offset > index_offset) {
+        return false;
+      }
+      if (frame.offset - start >= segment_size) {
+        segments.push_back(Segment{start, frame.offset - start, 0u, ChunkFormat::Stored});
+        start = frame.offset;
+      }
+    }
+    segments.push_back(Segment{start, index_offset - start, 0u, ChunkFormat::Stored});
+    _segments = std::move(segments);
+    return true;
+  }
+
+  void RecordingFile::FindSegmentsFromPackets(size_t begin, size_t segment_size) {
+    PacketReader reader(_data + begin, _data + _size);
+    Packet packet;
+    uint64_t start = begin;
+    uint64_t end = begin;
+    while (reader.Next(packet)) {
+      const uint64_t packet_start = static_cast<uint64_t>(packet.data - _data) - sizeof(PacketHeader);
+      if (packet.id == PacketId::FrameStart && packet_start - start >= segment_size) {
+        _segments.push_back(Segment{start, packet_start - start, 0u, ChunkFormat::Stored});
+        start = packet_start;
+      }
+      end = packet_start + sizeof(PacketHeader) + packet.size;
+    }
+    _segments.push_back(Segment{start, end - start, 0u, ChunkFormat::Stored});
+  }
+
+  PacketReader RecordingFile::ReadSegment(size_t index, std::vector<char> &buffer) const {
+    DEBUG_ASSERT(index < _segments.size());
+    const auto &segment = _segments[index];
+    const char *data = _data + segment.offset;
+    switch (segment.format) {
+      case ChunkFormat::Stored:
+        return PacketReader(data, data + segment.size);
+      case ChunkFormat::LZ4:
+        buffer.resize(segment.uncompressed_size);
+        if (!DecompressLZ4(data, segment.size, buffer.data(), buffer.size())) {
+          throw_exception(std::runtime_error("recording chunk " + std::to_string(index) + " is corrupted"));
+        }
+        return PacketReader(buffer.data(), buffer.data() + buffer.size());
+    }
+    throw_exception(std::runtime_error("recording chunk " + std::to_string(index) + " has an unknown format"));
+  }
+
+} // namespace recorder
+} // namespace carla
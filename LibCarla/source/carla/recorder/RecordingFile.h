@@ -0,0 +1,140 @@
+// Copyright (c) 2023 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/NonCopyable.h"
+#include "carla/recorder/RecorderPackets.h"
+
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace carla {
+namespace recorder {
+
+  /// General information in the header of a recording.
+  struct RecordingInfo {
+    uint16_t version = 0u;
+    std::string magic;
+    int64_t date = 0;
+    std::string map_name;
+  };
+
+  /// Decompresses a block in the LZ4 block format, as written by the
+  /// recorder. Returns false if the block is not valid or does not fill the
+  /// destination exactly.
+  bool DecompressLZ4(const char *source, size_t source_size, char *destination, size_t destination_size);
+
+  /// A packet of a recording, pointing to its data in memory.
+  struct Packet {
+    PacketId id;
+    const char *data;
+    uint32_t size;
+  };
+
+  /// Iterates the packets in a piece of a recording, without copying them.
+  /// Stops at the first packet that does not fit, as the last one of a
+  /// recording that was not properly closed.
+  class PacketReader {
+  public:
+
+    PacketReader() = default;
+
+    PacketReader(const char *begin, const char *end)
+      : _position(begin),
+        _end(end) {}
+
+    bool Next(Packet &packet) {
+      if (static_cast<size_t>(_end - _position) < sizeof(PacketHeader)) {
+        return false;
+      }
+      PacketHeader header;
+      std::memcpy(&header, _position, sizeof(PacketHeader));
+      const char *data = _position + sizeof(PacketHeader);
+      if (static_cast<size_t>(_end - data) < header.size) {
+        return false;
+      }
+      packet = Packet{header.id, data, header.size};
+      _position = data + header.size;
+      return true;
+    }
+
+  private:
+
+    const char *_position = nullptr;
+
+    const char *_end = nullptr;
+  };
+
+  /// A recording opened for reading. The file is mapped in memory and split
+  /// in segments that start at the beginning of a frame, so they can be read
+  /// in parallel. Plain recordings are split using the frame index at the end
+  /// of the file, if any, and the packets are read in place. Each chunk of a
+  /// compressed recording is a segment.
+  class RecordingFile : private NonCopyable {
+  public:
+
+    /// Default size of the segments of a plain recording.
+    static constexpr size_t DefaultSegmentSize = 4u * 1024u * 1024u;
+
+    /// Throws if the file can't be opened or it is not a recording.
+    explicit RecordingFile(const std::string &filename, size_t segment_size = DefaultSegmentSize);
+
+    ~RecordingFile();
+
+    const RecordingInfo &GetInfo() const {
+      return _info;
+    }
+
+    bool IsCompressed() const {
+      return _compressed;
+    }
+
+    size_t GetNumberOfSegments() const {
+      return _segments.size();
+    }
+
+    /// Returns the packets of the segment at @a index. Compressed segments
+    /// are decompressed into @a buffer, that must be kept while reading.
+    /// This is thread-safe, as long as each thread uses its own buffer.
+    PacketReader ReadSegment(size_t index, std::vector<char> &buffer) const;
+
+  private:
+
+    struct Segment {
+      uint64_t offset;
+      uint64_t size;
+      uint32_t uncompressed_size;
+      ChunkFormat format;
+    };
+
+    void ReadInfo(size_t &header_size);
+
+    void FindChunks(size_t begin);
+
+    bool FindSegmentsFromIndex(size_t begin, size_t segment_size);
+
+    void FindSegmentsFromPackets(size_t begin, size_t segment_size);
+
+    struct Mapping;
+
+    std::unique_ptr<Mapping> _mapping;
+
+    const char *_data = nullptr;
+
+    size_t _size = 0u;
+
+    RecordingInfo _info;
+
+    bool _compressed = false;
+
+    std::vector<Segment> _segments;
+  };
+
+} // namespace recorder
+} // namespace carla
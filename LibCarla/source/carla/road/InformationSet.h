@@ -6,32 +6,57 @@
 
 #pragma once
 
+#include "carla/Debug.h"
+#include "carla/Logging.h"
 #include "carla/NonCopyable.h"
 #include "carla/road/RoadElementSet.h"
 #include "carla/road/element/RoadInfo.h"
 #include "carla/road/element/RoadInfoIterator.h"
+#include "carla/road/element/RoadInfoVisitor.h"
 
-#include <vector>
+#include <algorithm>
+#include <array>
+#include <iterator>
 #include <memory>
+#include <type_traits>
+#include <vector>
 
 namespace carla {
 namespace road {
 
+  /// Road information records ordered by their distance on the road.
+  ///
+  /// Besides the full set, the records are indexed by their type so looking up
+  /// the record of a type at a given distance is a binary search over the
+  /// records of that type only.
   class InformationSet : private MovableNonCopyable {
   public:
 
     InformationSet() = default;
 
     InformationSet(std::vector<std::unique_ptr<element::RoadInfo>> &&vec)
-      : _road_set(std::move(vec)) {}
+      : _road_set(std::move(vec)) {
+      for (const auto &info : _road_set) {
+        DEBUG_ASSERT(info != nullptr);
+        const auto index = GetTypeIndex(*info, RoadInfoTypes{});
+        if (index >= _infos_by_type.size()) {
+          // A RoadInfo missing from RoadInfoTypes, GetInfo could never
+          // return it anyway.
+          log_error("InformationSet: ignoring road info of unknown type at s =", info->GetDistance());
+          continue;
+        }
+        _infos_by_type[index].emplace_back(info.get());
+      }
+    }
 
     /// Return all infos given a type from the start of the road
     template <typename T>
     std::vector<const T *> GetInfos() const {
+      const auto &infos = GetInfosOfType<T>();
       std::vector<const T *> vec;
-      auto it = element::MakeRoadInfoIterator<T>(_road_set.GetAll());
-      for (; !it.IsAtEnd(); ++it) {
-        vec.emplace_back(&*it);
+      vec.reserve(infos.size());
+      for (const auto *info : infos) {
+        vec.emplace_back(static_cast<const T *>(info));
       }
       return vec;
     }
@@ -40,25 +65,27 @@ namespace road {
     /// the start of the road
     template <typename T>
     const T *GetInfo(const double s) const {
-      auto it = element::MakeRoadInfoIterator<T>(_road_set.GetReverseSubset(s));
-      return it.IsAtEnd() ? nullptr : &*it;
+      const auto &infos = GetInfosOfType<T>();
+      auto it = std::upper_bound(infos.begin(), infos.end(), s, LessComp());
+      return it == infos.begin() ? nullptr : static_cast<const T *>(*std::prev(it));
     }
 
     /// Return all infos given a type in a given range of the road
     template <typename T>
     std::vector<const T *> GetInfos(const double min_s, const double max_s) const {
+      const auto &infos = GetInfosOfType<T>();
       std::vector<const T *> vec;
       if(min_s < max_s) {
-        auto it = element::MakeRoadInfoIterator<T>(
-            _road_set.GetSubsetInRange(min_s, max_s)); //reverse
-        for (; !it.IsAtEnd(); ++it) {
-          vec.emplace_back(&*it);
+        auto low_bound = std::lower_bound(infos.begin(), infos.end(), min_s, LessComp());
+        auto up_bound = std::upper_bound(low_bound, infos.end(), max_s, LessComp());
+        for (auto it = low_bound; it != up_bound; ++it) {
+          vec.emplace_back(static_cast<const T *>(*it));
         }
       } else {
-        auto it = element::MakeRoadInfoIterator<T>(
-            _road_set.GetReverseSubsetInRange(max_s, min_s)); //reverse
-        for (; !it.IsAtEnd(); ++it) {
-          vec.emplace_back(&*it);
+        auto low_bound = std::lower_bound(infos.begin(), infos.end(), max_s, LessComp());
+        auto up_bound = std::upper_bound(low_bound, infos.end(), min_s, LessComp());
+        for (auto it = up_bound; it != low_bound; --it) { //reverse
+          vec.emplace_back(static_cast<const T *>(*std::prev(it)));
         }
       }
       return vec;
@@ -66,7 +93,87 @@ namespace road {
 
   private:
 
+    template <typename... Ts>
+    struct TypeList {};
+
+    /// Every concrete RoadInfo, one per overload of RoadInfoVisitor.
+    using RoadInfoTypes = TypeList<
+        element::RoadInfoElevation,
+        element::RoadInfoGeometry,
+        element::RoadInfoLaneAccess,
+        element::RoadInfoLaneBorder,
+        element::RoadInfoLaneHeight,
+        element::RoadInfoLaneMaterial,
+        element::RoadInfoLaneOffset,
+        element::RoadInfoLaneRule,
+        element::RoadInfoLaneVisibility,
+        element::RoadInfoLaneWidth,
+        element::RoadInfoMarkRecord,
+        element::RoadInfoMarkTypeLine,
+        element::RoadInfoSpeed,
+        element::RoadInfoCrosswalk,
+        element::RoadInfoSignal>;
+
+    static constexpr size_t number_of_types = 15u;
+
+    /// Visitor matching a single type, as RoadInfoIterator does. Used instead
+    /// of typeid since LibCarla may be built without RTTI.
+    template <typename T>
+    class TypeMatcher : private element::RoadInfoVisitor {
+    public:
+
+      static bool IsA(element::RoadInfo &info) {
+        TypeMatcher matcher;
+        info.AcceptVisitor(matcher);
+        return matcher._matches;
+      }
+
+    private:
+
+      void Visit(T &) final {
+        _matches = true;
+      }
+
+      bool _matches = false;
+    };
+
+    template <typename... Ts>
+    static size_t GetTypeIndex(element::RoadInfo &info, TypeList<Ts...>) {
+      static_assert(sizeof...(Ts) == number_of_types, "Type list size mismatch.");
+      const bool matches[] = {TypeMatcher<Ts>::IsA(info)...};
+      return static_cast<size_t>(std::find(std::begin(matches), std::end(matches), true) - std::begin(matches));
+    }
+
+    template <typename T, typename... Ts>
+    static constexpr size_t GetTypeIndex(TypeList<Ts...>) {
+      constexpr bool matches[] = {std::is_same<T, Ts>::value...};
+      size_t index = 0u;
+      while ((index < sizeof...(Ts)) && !matches[index]) {
+        ++index;
+      }
+      return index;
+    }
+
+    template <typename T>
+    const std::vector<const element::RoadInfo *> &GetInfosOfType() const {
+      constexpr size_t index = GetTypeIndex<T>(RoadInfoTypes{});
+      static_assert(index < number_of_types, "Not a RoadInfo type.");
+      return _infos_by_type[index];
+    }
+
+    struct LessComp {
+      bool operator()(const double s, const element::RoadInfo *info) const {
+        return s < info->GetDistance();
+      }
+      bool operator()(const element::RoadInfo *info, const double s) const {
+        return info->GetDistance() < s;
+      }
+    };
+
     RoadElementSet<std::unique_ptr<element::RoadInfo>> _road_set;
+
+    /// Pointers to the records in _road_set by type, keeping its order.
+    std::array<std::vector<const element::RoadInfo *>, number_of_types> _infos_by_type;
   };
 
 } // road
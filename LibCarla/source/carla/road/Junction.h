@@ -18,6 +18,7 @@
 namespace carla {
 namespace road {
 
+  class Map;
   class MapBuilder;
 
   class Junction : private MovableNonCopyable {
@@ -88,6 +89,8 @@ namespace road {
 
   private:
 
+    friend Map;
+
     friend MapBuilder;
 
     JuncId _id;
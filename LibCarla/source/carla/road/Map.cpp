@@ -6,6 +6,7 @@
 
 #include "carla/road/Map.h"
 #include "carla/Exception.h"
+#include "carla/ThreadPool.h"
 #include "carla/geom/Math.h"
 #include "carla/geom/Vector3D.h"
 #include "carla/road/MeshFactory.h"
@@ -22,6 +23,7 @@
 
 #include "marchingcube/MeshReconstruction.h"
 
+#include <algorithm>
 #include <vector>
 #include <unordered_map>
 #include <stdexcept>
@@ -29,6 +31,7 @@
 #include <thread>
 #include <iomanip>
 #include <cmath>
+#include <cstring>
 
 namespace carla {
 namespace road {
@@ -270,10 +273,75 @@ namespace road {
     return waypoint;
   }
 
+  boost::optional<Waypoint> Map::GetWaypoint(
+      RoadId road_id,
+      SectionId section_id,
+      LaneId lane_id,
+      double s) const {
+
+    // check the road
+    if (!_data.ContainsRoad(road_id)) {
+      return boost::optional<Waypoint>{};
+    }
+    const Road &road = _data.GetRoad(road_id);
+
+    // check the 's' distance
+    if (s < 0.0 || s >= road.GetLength()) {
+      return boost::optional<Waypoint>{};
+    }
+
+    // check the section and the lane
+    for (auto &section : road.GetLaneSections()) {
+      if (section.GetId() == section_id) {
+        if (!section.ContainsLane(lane_id)) {
+          break;
+        }
+        Waypoint waypoint;
+        waypoint.road_id = road_id;
+        waypoint.section_id = section_id;
+        waypoint.lane_id = lane_id;
+        waypoint.s = s;
+        return waypoint;
+      }
+    }
+    return boost::optional<Waypoint>{};
+  }
+
   geom::Transform Map::ComputeTransform(Waypoint waypoint) const {
     return GetLane(waypoint).ComputeTransform(waypoint.s);
   }
 
+  std::vector<Map::WaypointProjection> Map::ProjectLocations(
+      const std::vector<geom::Location> &locations,
+      const bool project_to_road,
+      const int32_t lane_type) const {
+    std::vector<WaypointProjection> result(locations.size());
+
+    auto project_range = [&](const size_t begin, const size_t end) {
+      for (auto i = begin; i < end; ++i) {
+        const auto &location = locations[i];
+        const auto waypoint = GetClosestWaypointOnRoad(location, lane_type);
+        if (!waypoint.has_value()) {
+          continue;
+        }
+        auto &projection = result[i];
+        projection.waypoint = *waypoint;
+        projection.transform = ComputeTransform(*waypoint);
+        projection.lane_width = GetLaneWidth(*waypoint);
+        // Same check as GetWaypoint, reusing the transform computed above.
+        projection.is_valid = project_to_road ||
+            (geom::Math::Distance2D(projection.transform.location, location) <
+             0.5 * projection.lane_width);
+      }
+    };
+
+    // Each R-tree query is independent, the locations are split in ranges
+    // big enough to amortize handing them to the threads of the pool.
+    constexpr size_t locations_per_task = 1024u;
+    ThreadPool::GetShared().ParallelFor(locations.size(), locations_per_task, project_range);
+    return result;
+  }
+
   // ===========================================================================
   // -- Map: Road information --------------------------------------------------
   // ===========================================================================
@@ -790,42 +858,69 @@ namespace road {
         {max_corner.x, max_corner.y, max_corner.z});
     auto segments = _rtree.GetIntersections(box);
 
-    for (size_t i = 0; i < segments.size(); ++i){
-      auto &segment1 = segments[i];
-      auto waypoint1 = segment1.second.first;
-      JuncId junc_id1 = _data.GetRoad(waypoint1.road_id).GetJunctionId();
-      // only segments in the junction
-      if(junc_id1 != id){
+    // only segments in the junction, each with its 2D bounding box
+    struct JunctionSegment {
+      Segment2d segment;
+      RoadId road_id;
+      float min_x, max_x, min_y, max_y;
+    };
+    std::vector<JunctionSegment> junction_segments;
+    junction_segments.reserve(segments.size());
+    for (const auto &segment : segments) {
+      const auto &waypoint = segment.second.first;
+      if (_data.GetRoad(waypoint.road_id).GetJunctionId() != id) {
         continue;
       }
-      Segment2d seg1{{segment1.first.first.get<0>(), segment1.first.first.get<1>()},
-          {segment1.first.second.get<0>(), segment1.first.second.get<1>()}};
-      for (size_t j = i + 1; j < segments.size(); ++j){
-        auto &segment2 = segments[j];
-        auto waypoint2 = segment2.second.first;
-        JuncId junc_id2 = _data.GetRoad(waypoint2.road_id).GetJunctionId();
-        // only segments in the junction
-        if(junc_id2 != id){
-          continue;
+      const auto &first = segment.first.first;
+      const auto &second = segment.first.second;
+      junction_segments.push_back({
+          {{first.get<0>(), first.get<1>()}, {second.get<0>(), second.get<1>()}},
+          waypoint.road_id,
+          std::min(first.get<0>(), second.get<0>()),
+          std::max(first.get<0>(), second.get<0>()),
+          std::min(first.get<1>(), second.get<1>()),
+          std::max(first.get<1>(), second.get<1>())});
+    }
+
+    // better to set distance to lanewidth
+    constexpr double max_distance = 2.0;
+    // Segments whose bounding boxes are further apart than this cannot be
+    // closer than max_distance, the margin covers the rounding of the exact
+    // distance computation.
+    constexpr double max_gap = max_distance + 0.001;
+
+    // Sweep along x, for each segment only the ones that start before it
+    // ends (plus the distance) are candidates.
+    std::sort(junction_segments.begin(), junction_segments.end(),
+        [](const JunctionSegment &lhs, const JunctionSegment &rhs) {
+          return lhs.min_x < rhs.min_x;
+        });
+    for (size_t i = 0; i < junction_segments.size(); ++i) {
+      const auto &segment1 = junction_segments[i];
+      for (size_t j = i + 1; j < junction_segments.size(); ++j) {
+        const auto &segment2 = junction_segments[j];
+        if (static_cast<double>(segment2.min_x) - segment1.max_x > max_gap) {
+          break;
         }
         // discard same road
-        if(waypoint1.road_id == waypoint2.road_id){
+        if (segment1.road_id == segment2.road_id) {
           continue;
         }
-        Segment2d seg2{{segment2.first.first.get<0>(), segment2.first.first.get<1>()},
-            {segment2.first.second.get<0>(), segment2.first.second.get<1>()}};
-
-        double distance = boost::geometry::distance(seg1, seg2);
-        // better to set distance to lanewidth
-        if(distance > 2.0){
+        if (static_cast<double>(segment2.min_y) - segment1.max_y > max_gap ||
+            static_cast<double>(segment1.min_y) - segment2.max_y > max_gap) {
           continue;
         }
-        if(conflicts[waypoint1.road_id].count(waypoint2.road_id) == 0){
-          conflicts[waypoint1.road_id].insert(waypoint2.road_id);
+        // already in conflict, skip the distance
+        auto it = conflicts.find(segment1.road_id);
+        if (it != conflicts.end() && it->second.count(segment2.road_id) > 0) {
+          continue;
         }
-        if(conflicts[waypoint2.road_id].count(waypoint1.road_id) == 0){
-          conflicts[waypoint2.road_id].insert(waypoint1.road_id);
+        double distance = boost::geometry::distance(segment1.segment, segment2.segment);
+        if (distance > max_distance) {
+          continue;
         }
+        conflicts[segment1.road_id].insert(segment2.road_id);
+        conflicts[segment2.road_id].insert(segment1.road_id);
       }
     }
     return conflicts;
@@ -846,7 +941,7 @@ namespace road {
       geom::Transform &current_transform,
       geom::Transform &next_transform,
       Waypoint &current_waypoint,
-      Waypoint &next_waypoint) {
+      Waypoint &next_waypoint) const {
     Rtree::BPoint init =
         Rtree::BPoint(
         current_transform.location.x,
@@ -866,7 +961,7 @@ namespace road {
       std::vector<Rtree::TreeElement> &rtree_elements,
       geom::Transform &current_transform,
       Waypoint &current_waypoint,
-      Waypoint &next_waypoint) {
+      Waypoint &next_waypoint) const {
     geom::Transform next_transform = ComputeTransform(next_waypoint);
     AddElementToRtree(rtree_elements, current_transform, next_transform,
     current_waypoint, next_waypoint);
@@ -884,7 +979,9 @@ namespace road {
     }
   }
 
-  void Map::CreateRtree() {
+  void Map::AddLaneToRtree(
+      std::vector<Rtree::TreeElement> &rtree_elements,
+      const Waypoint &lane_start_waypoint) const {
     const double epsilon = 0.000001; // small delta in the road (set to 1
                                      // micrometer to prevent numeric errors)
     const double min_delta_s = 1;    // segments of minimum 1m through the road
@@ -894,6 +991,87 @@ namespace road {
     // maximum distance of a segment
     constexpr double max_segment_length = 100.0;
 
+    auto current_waypoint = lane_start_waypoint;
+
+    const Lane &lane = GetLane(current_waypoint);
+
+    geom::Transform current_transform = ComputeTransform(current_waypoint);
+
+    // Save computation time in straight lines
+    if (lane.IsStraight()) {
+      double delta_s = min_delta_s;
+      double remaining_length =
+          GetRemainingLength(lane, current_waypoint.s);
+      remaining_length -= epsilon;
+      delta_s = remaining_length;
+      if (delta_s < epsilon) {
+        return;
+      }
+      auto next = GetNext(current_waypoint, delta_s);
+
+      RELEASE_ASSERT(next.size() == 1);
+      RELEASE_ASSERT(next.front().road_id == current_waypoint.road_id);
+      auto next_waypoint = next.front();
+
+      AddElementToRtreeAndUpdateTransforms(
+          rtree_elements,
+          current_transform,
+          current_waypoint,
+          next_waypoint);
+      // end of lane
+    } else {
+      auto next_waypoint = current_waypoint;
+
+      // Loop until the end of the lane
+      // Advance in small s-increments
+      while (true) {
+        double delta_s = min_delta_s;
+        double remaining_length =
+            GetRemainingLength(lane, next_waypoint.s);
+        remaining_length -= epsilon;
+        delta_s = std::min(delta_s, remaining_length);
+
+        if (delta_s < epsilon) {
+          AddElementToRtreeAndUpdateTransforms(
+              rtree_elements,
+              current_transform,
+              current_waypoint,
+              next_waypoint);
+          break;
+        }
+
+        auto next = GetNext(next_waypoint, delta_s);
+        if (next.size() != 1 ||
+        current_waypoint.section_id != next.front().section_id) {
+          AddElementToRtreeAndUpdateTransforms(
+              rtree_elements,
+              current_transform,
+              current_waypoint,
+              next_waypoint);
+          break;
+        }
+
+        next_waypoint = next.front();
+        geom::Transform next_transform = ComputeTransform(next_waypoint);
+        double angle = geom::Math::GetVectorAngle(
+            current_transform.GetForwardVector(), next_transform.GetForwardVector());
+
+        if (std::abs(angle) > angle_threshold ||
+            std::abs(current_waypoint.s - next_waypoint.s) > max_segment_length) {
+          AddElementToRtree(
+              rtree_elements,
+              current_transform,
+              next_transform,
+              current_waypoint,
+              next_waypoint);
+          current_waypoint = next_waypoint;
+          current_transform = next_transform;
+        }
+      }
+    }
+  }
+
+  std::vector<Map::Rtree::TreeElement> Map::ComputeRtreeElements() const {
     // Generate waypoints at start of every lane
     std::vector<Waypoint> topology;
     for (const auto &pair : _data.GetRoads()) {
@@ -905,93 +1083,200 @@ namespace road {
       });
     }
 
-    // Container of segments and waypoints
-    std::vector<Rtree::TreeElement> rtree_elements;
-    // Loop through all lanes
-    for (auto &waypoint : topology) {
-      auto &lane_start_waypoint = waypoint;
+    // Every lane is sampled independently, each range of lanes fills its own
+    // list and the lists are concatenated in order, so the R-tree does not
+    // depend on the number of threads.
+    constexpr size_t lanes_per_task = 256u;
+    std::vector<std::vector<Rtree::TreeElement>> results(
+        (topology.size() + lanes_per_task - 1u) / lanes_per_task);
+    ThreadPool::GetShared().ParallelFor(topology.size(), lanes_per_task, [&](size_t begin, size_t end) {
+      auto &result = results[begin / lanes_per_task];
+      for (auto i = begin; i < end; ++i) {
+        AddLaneToRtree(result, topology[i]);
+      }
+    });
+    if (results.empty()) {
+      return {};
+    }
 
-      auto current_waypoint = lane_start_waypoint;
+    size_t number_of_elements = 0u;
+    for (const auto &result : results) {
+      number_of_elements += result.size();
+    }
+    std::vector<Rtree::TreeElement> rtree_elements = std::move(results.front());
+    rtree_elements.reserve(number_of_elements);
+    for (size_t i = 1u; i < results.size(); ++i) {
+      rtree_elements.insert(rtree_elements.end(), results[i].begin(), results[i].end());
+    }
+    return rtree_elements;
+  }
 
-      const Lane &lane = GetLane(current_waypoint);
+  void Map::CreateRtree() {
+    // Add segments to Rtree
+    _rtree.InsertElements(ComputeRtreeElements());
+  }
 
-      geom::Transform current_transform = ComputeTransform(current_waypoint);
+  // ===========================================================================
+  // -- Map: Compiled map ------------------------------------------------------
+  // ===========================================================================
 
-      // Save computation time in straight lines
-      if (lane.IsStraight()) {
-        double delta_s = min_delta_s;
-        double remaining_length =
-            GetRemainingLength(lane, current_waypoint.s);
-        remaining_length -= epsilon;
-        delta_s = remaining_length;
-        if (delta_s < epsilon) {
-          continue;
+  static constexpr uint64_t COMPILED_MAP_MAGIC = 0x45455254524C5243u; // "CRLRTREE".
+
+  /// Increase every time the layout, the sampling of the segments or the
+  /// computation of the conflicts changes.
+  static constexpr uint32_t COMPILED_MAP_VERSION = 2u;
+
+  /// Followed by the R-tree elements and then by the junction conflicts.
+  struct CompiledMapHeader {
+    uint64_t magic;
+    uint32_t version;
+    uint32_t element_size;
+    uint64_t number_of_elements;
+    uint64_t number_of_conflicts;
+  };
+
+  /// A segment and the waypoints at both of its ends.
+  struct CompiledRtreeElement {
+    float points[6];
+    uint32_t road_id[2];
+    uint32_t section_id[2];
+    int32_t lane_id[2];
+    double s[2];
+  };
+
+  /// Two roads of a junction that conflict, stored in both directions.
+  struct CompiledJunctionConflict {
+    int32_t junction_id;
+    uint32_t road_id;
+    uint32_t conflicting_road_id;
+  };
+
+  static_assert(sizeof(CompiledMapHeader) == 32u, "Unexpected padding.");
+  static_assert(sizeof(CompiledRtreeElement) == 64u, "Unexpected padding.");
+  static_assert(sizeof(CompiledJunctionConflict) == 12u, "Unexpected padding.");
+
+  Map::Map(MapData m, std::vector<uint8_t> &compiled_map)
+    : _data(std::move(m)) {
+    std::vector<Rtree::TreeElement> rtree_elements;
+    if (ReadCompiledMap(compiled_map, rtree_elements)) {
+      compiled_map.clear();
+    } else {
+      rtree_elements = ComputeRtreeElements();
+      compiled_map = WriteCompiledMap(rtree_elements);
+    }
+    _rtree.InsertElements(rtree_elements);
+  }
+
+  bool Map::ReadCompiledMap(
+      const std::vector<uint8_t> &compiled_map,
+      std::vector<Rtree::TreeElement> &rtree_elements) {
+    CompiledMapHeader header;
+    if (compiled_map.size() < sizeof(header)) {
+      return false;
+    }
+    std::memcpy(&header, compiled_map.data(), sizeof(header));
+    if ((header.magic != COMPILED_MAP_MAGIC) ||
+        (header.version != COMPILED_MAP_VERSION) ||
+        (header.element_size != sizeof(CompiledRtreeElement)) ||
+        (header.number_of_elements > compiled_map.size() / sizeof(CompiledRtreeElement)) ||
+        (header.number_of_conflicts > compiled_map.size() / sizeof(CompiledJunctionConflict)) ||
+        (compiled_map.size() !=
+            sizeof(header) +
+            header.number_of_elements * sizeof(CompiledRtreeElement) +
+            header.number_of_conflicts * sizeof(CompiledJunctionConflict))) {
+      return false;
+    }
+    const uint8_t *data = compiled_map.data() + sizeof(header);
+    std::vector<Rtree::TreeElement> result;
+    result.reserve(header.number_of_elements);
+    for (uint64_t i = 0u; i < header.number_of_elements; ++i) {
+      CompiledRtreeElement element;
+      std::memcpy(&element, data, sizeof(element));
+      data += sizeof(element);
+      Waypoint waypoints[2];
+      for (auto j = 0u; j < 2u; ++j) {
+        // Every segment must belong to this map, otherwise it would break the
+        // queries later.
+        if (!_data.ContainsRoad(element.road_id[j])) {
+          return false;
         }
-        auto next = GetNext(current_waypoint, delta_s);
-
-        RELEASE_ASSERT(next.size() == 1);
-        RELEASE_ASSERT(next.front().road_id == current_waypoint.road_id);
-        auto next_waypoint = next.front();
-
-        AddElementToRtreeAndUpdateTransforms(
-            rtree_elements,
-            current_transform,
-            current_waypoint,
-            next_waypoint);
-        // end of lane
-      } else {
-        auto next_waypoint = current_waypoint;
-
-        // Loop until the end of the lane
-        // Advance in small s-increments
-        while (true) {
-          double delta_s = min_delta_s;
-          double remaining_length =
-              GetRemainingLength(lane, next_waypoint.s);
-          remaining_length -= epsilon;
-          delta_s = std::min(delta_s, remaining_length);
-
-          if (delta_s < epsilon) {
-            AddElementToRtreeAndUpdateTransforms(
-                rtree_elements,
-                current_transform,
-                current_waypoint,
-                next_waypoint);
-            break;
-          }
+        waypoints[j].road_id = element.road_id[j];
+        waypoints[j].section_id = element.section_id[j];
+        waypoints[j].lane_id = element.lane_id[j];
+        waypoints[j].s = element.s[j];
+      }
+      result.emplace_back(
+          Rtree::BSegment(
+              Rtree::BPoint(element.points[0], element.points[1], element.points[2]),
+              Rtree::BPoint(element.points[3], element.points[4], element.points[5])),
+          std::make_pair(waypoints[0], waypoints[1]));
+    }
+    std::unordered_map<JuncId, std::unordered_map<RoadId, std::unordered_set<RoadId>>> conflicts;
+    for (uint64_t i = 0u; i < header.number_of_conflicts; ++i) {
+      CompiledJunctionConflict conflict;
+      std::memcpy(&conflict, data, sizeof(conflict));
+      data += sizeof(conflict);
+      if (_data.GetJunction(conflict.junction_id) == nullptr) {
+        return false;
+      }
+      conflicts[conflict.junction_id][conflict.road_id].insert(conflict.conflicting_road_id);
+    }
+    rtree_elements = std::move(result);
+    for (auto &pair : conflicts) {
+      _data.GetJunction(pair.first)->_road_conflicts = std::move(pair.second);
+    }
+    return true;
+  }
 
-          auto next = GetNext(next_waypoint, delta_s);
-          if (next.size() != 1 ||
-          current_waypoint.section_id != next.front().section_id) {
-            AddElementToRtreeAndUpdateTransforms(
-                rtree_elements,
-                current_transform,
-                current_waypoint,
-                next_waypoint);
-            break;
-          }
+  std::vector<uint8_t> Map::WriteCompiledMap(
+      const std::vector<Rtree::TreeElement> &rtree_elements) {
+    CompiledMapHeader header;
+    header.magic = COMPILED_MAP_MAGIC;
+    header.version = COMPILED_MAP_VERSION;
+    header.element_size = sizeof(CompiledRtreeElement);
+    header.number_of_elements = rtree_elements.size();
+    header.number_of_conflicts = 0u;
+    std::vector<uint8_t> result(sizeof(header) + rtree_elements.size() * sizeof(CompiledRtreeElement));
+    std::memcpy(result.data(), &header, sizeof(header));
+    uint8_t *data = result.data() + sizeof(header);
+    for (const auto &rtree_element : rtree_elements) {
+      const auto &segment = rtree_element.first;
+      const Waypoint waypoints[2] = {rtree_element.second.first, rtree_element.second.second};
+      CompiledRtreeElement element;
+      element.points[0] = segment.first.get<0>();
+      element.points[1] = segment.first.get<1>();
+      element.points[2] = segment.first.get<2>();
+      element.points[3] = segment.second.get<0>();
+      element.points[4] = segment.second.get<1>();
+      element.points[5] = segment.second.get<2>();
+      for (auto j = 0u; j < 2u; ++j) {
+        element.road_id[j] = waypoints[j].road_id;
+        element.section_id[j] = waypoints[j].section_id;
+        element.lane_id[j] = waypoints[j].lane_id;
+        element.s[j] = waypoints[j].s;
+      }
+      std::memcpy(data, &element, sizeof(element));
+      data += sizeof(element);
+    }
+    return result;
+  }
 
-          next_waypoint = next.front();
-          geom::Transform next_transform = ComputeTransform(next_waypoint);
-          double angle = geom::Math::GetVectorAngle(
-              current_transform.GetForwardVector(), next_transform.GetForwardVector());
-
-          if (std::abs(angle) > angle_threshold ||
-              std::abs(current_waypoint.s - next_waypoint.s) > max_segment_length) {
-            AddElementToRtree(
-                rtree_elements,
-                current_transform,
-                next_transform,
-                current_waypoint,
-                next_waypoint);
-            current_waypoint = next_waypoint;
-            current_transform = next_transform;
-          }
+  void Map::WriteCompiledJunctionConflicts(std::vector<uint8_t> &compiled_map) const {
+    CompiledMapHeader header;
+    DEBUG_ASSERT(compiled_map.size() >= sizeof(header));
+    std::memcpy(&header, compiled_map.data(), sizeof(header));
+    for (const auto &junction_pair : _data.GetJunctions()) {
+      for (const auto &road_pair : junction_pair.second._road_conflicts) {
+        for (const auto conflicting_road_id : road_pair.second) {
+          const CompiledJunctionConflict conflict{
+              junction_pair.first, road_pair.first, conflicting_road_id};
+          const auto *bytes = reinterpret_cast<const uint8_t *>(&conflict);
+          compiled_map.insert(compiled_map.end(), bytes, bytes + sizeof(conflict));
+          ++header.number_of_conflicts;
         }
       }
     }
-    // Add segments to Rtree
-    _rtree.InsertElements(rtree_elements);
+    std::memcpy(compiled_map.data(), &header, sizeof(header));
   }
 
   Junction* Map::GetJunction(JuncId id) {
@@ -1050,28 +1335,57 @@ namespace road {
   }
 
 
+  /// Meshes of a group of roads or junctions sorted by lane type.
+  using MeshesByLaneType = std::map<road::Lane::LaneType, std::vector<std::unique_ptr<geom::Mesh>>>;
+
+  /// Roads are generated in groups, a single road is too small a task.
+  static constexpr size_t NUMBER_OF_ROADS_PER_MESH_TASK = 30u;
+
+  /// Runs @a task for every index in [0, number_of_tasks) on the shared pool
+  /// and returns the results sorted by index. Idle threads take the next
+  /// pending task, and every task has its own output so there is nothing to
+  /// lock while they run.
+  template <typename TaskT>
+  static auto RunMeshTasks(const size_t number_of_tasks, TaskT &&task)
+      -> std::vector<decltype(task(size_t(0u)))> {
+    std::vector<decltype(task(size_t(0u)))> results(number_of_tasks);
+    ThreadPool::GetShared().ParallelFor(number_of_tasks, 1u, [&](size_t begin, size_t end) {
+      for (auto i = begin; i < end; ++i) {
+        results[i] = task(i);
+      }
+    });
+    return results;
+  }
+
+  /// Moves the meshes of @a source to the end of the lists in @a destination.
+  static void AppendMeshes(MeshesByLaneType &&source, MeshesByLaneType &destination) {
+    for (auto &&pair : source) {
+      auto &meshes = destination[pair.first];
+      meshes.insert(
+          meshes.end(),
+          std::make_move_iterator(pair.second.begin()),
+          std::make_move_iterator(pair.second.end()));
+    }
+  }
+
   std::vector<std::unique_ptr<geom::Mesh>> Map::GenerateChunkedMesh(
       const rpc::OpendriveGenerationParameters& params) const {
     geom::MeshFactory mesh_factory(params);
     std::vector<std::unique_ptr<geom::Mesh>> out_mesh_list;
 
-    std::unordered_map<JuncId, geom::Mesh> junction_map;
+    std::vector<const Road *> roads;
     for (auto &&pair : _data.GetRoads()) {
-      const auto &road = pair.second;
-      if (!road.IsJunction()) {
-        std::vector<std::unique_ptr<geom::Mesh>> road_mesh_list =
-            mesh_factory.GenerateAllWithMaxLen(road);
-
-        out_mesh_list.insert(
-            out_mesh_list.end(),
-            std::make_move_iterator(road_mesh_list.begin()),
-            std::make_move_iterator(road_mesh_list.end()));
+      if (!pair.second.IsJunction()) {
+        roads.push_back(&pair.second);
       }
     }
+    std::vector<const Junction *> junctions;
+    for (const auto &junc_pair : _data.GetJunctions()) {
+      junctions.push_back(&junc_pair.second);
+    }
 
     // Generate roads within junctions and smooth them
-    for (const auto &junc_pair : _data.GetJunctions()) {
-      const auto &junction = junc_pair.second;
+    auto generate_junction = [&](const Junction &junction) {
       std::vector<std::unique_ptr<geom::Mesh>> lane_meshes;
       std::vector<std::unique_ptr<geom::Mesh>> sidewalk_lane_meshes;
       for(const auto &connection_pair : junction.GetConnections()) {
@@ -1093,7 +1407,7 @@ namespace road {
         for(auto& lane : sidewalk_lane_meshes) {
           *merged_mesh += *lane;
         }
-        out_mesh_list.push_back(std::move(merged_mesh));
+        return merged_mesh;
       } else {
         std::unique_ptr<geom::Mesh> junction_mesh = std::make_unique<geom::Mesh>();
         for(auto& lane : lane_meshes) {
@@ -1102,8 +1416,49 @@ namespace road {
         for(auto& lane : sidewalk_lane_meshes) {
           *junction_mesh += *lane;
         }
-        out_mesh_list.push_back(std::move(junction_mesh));
+        return junction_mesh;
+      }
+    };
+
+    // Junctions are queued first, they are the most expensive tasks and
+    // should not be the last ones to start. The results keep the order of a
+    // serial loop, all the roads and then all the junctions.
+    const size_t number_of_road_tasks =
+        (roads.size() + NUMBER_OF_ROADS_PER_MESH_TASK - 1u) / NUMBER_OF_ROADS_PER_MESH_TASK;
+    auto results = RunMeshTasks(junctions.size() + number_of_road_tasks, [&](const size_t index) {
+      std::vector<std::unique_ptr<geom::Mesh>> meshes;
+      if (index < junctions.size()) {
+        meshes.push_back(generate_junction(*junctions[index]));
+        return meshes;
       }
+      const size_t begin = (index - junctions.size()) * NUMBER_OF_ROADS_PER_MESH_TASK;
+      const size_t end = std::min(begin + NUMBER_OF_ROADS_PER_MESH_TASK, roads.size());
+      for (size_t i = begin; i < end; ++i) {
+        auto road_mesh_list = mesh_factory.GenerateAllWithMaxLen(*roads[i]);
+        meshes.insert(
+            meshes.end(),
+            std::make_move_iterator(road_mesh_list.begin()),
+            std::make_move_iterator(road_mesh_list.end()));
+      }
+      return meshes;
+    });
+    std::rotate(results.begin(), results.begin() + junctions.size(), results.end());
+    for (auto &meshes : results) {
+      out_mesh_list.insert(
+          out_mesh_list.end(),
+          std::make_move_iterator(meshes.begin()),
+          std::make_move_iterator(meshes.end()));
+    }
+
+    // Meshes are placed in a chunk by their first vertex, lanes of zero width
+    // produce meshes without vertices.
+    out_mesh_list.erase(
+        std::remove_if(out_mesh_list.begin(), out_mesh_list.end(), [](const auto &mesh) {
+          return mesh->GetVertices().empty();
+        }),
+        out_mesh_list.end());
+    if (out_mesh_list.empty()) {
+      return out_mesh_list;
     }
 
     auto min_pos = geom::Vector2D(
@@ -1142,62 +1497,36 @@ namespace road {
 
     geom::MeshFactory mesh_factory(params);
     std::map<road::Lane::LaneType, std::vector<std::unique_ptr<geom::Mesh>>> road_out_mesh_list;
-    std::map<road::Lane::LaneType, std::vector<std::unique_ptr<geom::Mesh>>> junction_out_mesh_list;
-
-    std::thread juntction_thread( &Map::GenerateJunctions, this, mesh_factory, params,
-      minpos, maxpos, &junction_out_mesh_list);
 
     const std::vector<RoadId> RoadsIDToGenerate = FilterRoadsByPosition(minpos, maxpos);
+    const std::vector<JuncId> JunctionsToGenerate = FilterJunctionsByPosition(minpos, maxpos);
 
     size_t num_roads = RoadsIDToGenerate.size();
-    size_t num_roads_per_thread = 30;
-    size_t num_threads = (num_roads / num_roads_per_thread) + 1;
-    num_threads = num_threads > 1 ? num_threads : 1;
-    std::vector<std::thread> workers;
-    std::mutex write_mutex;
-    std::cout << "Generating " << std::to_string(num_roads) << " roads" << std::endl;
-
-    for ( size_t i = 0; i < num_threads; ++i ) {
-      std::thread neworker(
-        [this, &write_mutex, &mesh_factory, &RoadsIDToGenerate, &road_out_mesh_list, i, num_roads_per_thread]() {
-        std::map<road::Lane::LaneType, std::vector<std::unique_ptr<geom::Mesh>>> Current =
-          std::move(GenerateRoadsMultithreaded(mesh_factory, RoadsIDToGenerate,i, num_roads_per_thread ));
-        std::lock_guard<std::mutex> guard(write_mutex);
-        for ( auto&& pair : Current ) {
-          if (road_out_mesh_list.find(pair.first) != road_out_mesh_list.end()) {
-            road_out_mesh_list[pair.first].insert(road_out_mesh_list[pair.first].end(),
-              std::make_move_iterator(pair.second.begin()),
-              std::make_move_iterator(pair.second.end()));
-          } else {
-            road_out_mesh_list[pair.first] = std::move(pair.second);
-          }
-        }
-      });
-      workers.push_back(std::move(neworker));
-    }
-
-    for (size_t i = 0; i < workers.size(); ++i) {
-      workers[i].join();
-    }
-    workers.clear();
-    for (size_t i = 0; i < workers.size(); ++i) {
-      if (workers[i].joinable()) {
-        workers[i].join();
+    size_t num_road_tasks =
+        (num_roads + NUMBER_OF_ROADS_PER_MESH_TASK - 1u) / NUMBER_OF_ROADS_PER_MESH_TASK;
+    std::cout << "Generating " << std::to_string(num_roads) << " roads and "
+              << std::to_string(JunctionsToGenerate.size()) << " junctions" << std::endl;
+
+    // Roads and junctions share the pool, junctions first as they are the
+    // most expensive tasks. The results are merged in the order of the tasks.
+    auto results = RunMeshTasks(JunctionsToGenerate.size() + num_road_tasks, [&](const size_t index) {
+      MeshesByLaneType out;
+      if (index < JunctionsToGenerate.size()) {
+        GenerateSingleJunction(mesh_factory, JunctionsToGenerate[index], &out);
+      } else {
+        out = GenerateRoadsMultithreaded(
+            mesh_factory,
+            RoadsIDToGenerate,
+            index - JunctionsToGenerate.size(),
+            NUMBER_OF_ROADS_PER_MESH_TASK);
       }
+      return out;
+    });
+    for (size_t i = JunctionsToGenerate.size(); i < results.size(); ++i) {
+      AppendMeshes(std::move(results[i]), road_out_mesh_list);
     }
-
-    juntction_thread.join();
-    for (auto&& pair : junction_out_mesh_list) {
-      if (road_out_mesh_list.find(pair.first) != road_out_mesh_list.end())
-      {
-        road_out_mesh_list[pair.first].insert(road_out_mesh_list[pair.first].end(),
-          std::make_move_iterator(pair.second.begin()),
-          std::make_move_iterator(pair.second.end()));
-      }
-      else
-      {
-        road_out_mesh_list[pair.first] = std::move(pair.second);
-      }
+    for (size_t i = 0u; i < JunctionsToGenerate.size(); ++i) {
+      AppendMeshes(std::move(results[i]), road_out_mesh_list);
     }
     std::cout << "Generated " << std::to_string(num_roads) << " roads" << std::endl;
 
@@ -1354,57 +1683,16 @@ namespace road {
     std::vector<JuncId> JunctionsToGenerate = FilterJunctionsByPosition(minpos, maxpos);
     size_t num_junctions = JunctionsToGenerate.size();
     std::cout << "Generating " << std::to_string(num_junctions) << " junctions" << std::endl;
-    size_t junctionindex = 0;
-    size_t num_junctions_per_thread = 5;
-    size_t num_threads = (num_junctions / num_junctions_per_thread) + 1;
-    num_threads = num_threads > 1 ? num_threads : 1;
-    std::vector<std::thread> workers;
-    std::mutex write_mutex;
-
-    for ( size_t i = 0; i < num_threads; ++i ) {
-      std::thread neworker(
-        [this, &write_mutex, &mesh_factory, &junction_out_mesh_list, JunctionsToGenerate, i, num_junctions_per_thread, num_junctions]() {
-        std::map<road::Lane::LaneType,
-          std::vector<std::unique_ptr<geom::Mesh>>> junctionsofthisthread;
-
-        size_t minimum = 0;
-        if( (i + 1) * num_junctions_per_thread < num_junctions ){
-          minimum = (i + 1) * num_junctions_per_thread;
-        }else{
-          minimum = num_junctions;
-        }
-        std::cout << "Generating Junctions between  " << std::to_string(i * num_junctions_per_thread) << " and " << std::to_string(minimum) << std::endl;
 
-        for ( size_t junctionindex = i * num_junctions_per_thread;
-                        junctionindex < minimum;
-                        ++junctionindex )
-        {
-          GenerateSingleJunction(mesh_factory, JunctionsToGenerate[junctionindex], &junctionsofthisthread);
-        }
-        std::cout << "Generated Junctions between  " << std::to_string(i * num_junctions_per_thread) << " and " << std::to_string(minimum) << std::endl;
-        std::lock_guard<std::mutex> guard(write_mutex);
-        for ( auto&& pair : junctionsofthisthread ) {
-          if ((*junction_out_mesh_list).find(pair.first) != (*junction_out_mesh_list).end()) {
-            (*junction_out_mesh_list)[pair.first].insert((*junction_out_mesh_list)[pair.first].end(),
-              std::make_move_iterator(pair.second.begin()),
-              std::make_move_iterator(pair.second.end()));
-          } else {
-            (*junction_out_mesh_list)[pair.first] = std::move(pair.second);
-          }
-        }
-      });
-      workers.push_back(std::move(neworker));
-    }
-
-    for (size_t i = 0; i < workers.size(); ++i) {
-      workers[i].join();
-    }
-    workers.clear();
-    for (size_t i = 0; i < workers.size(); ++i) {
-      if (workers[i].joinable()) {
-        workers[i].join();
-      }
+    auto results = RunMeshTasks(num_junctions, [&](const size_t index) {
+      MeshesByLaneType out;
+      GenerateSingleJunction(mesh_factory, JunctionsToGenerate[index], &out);
+      return out;
+    });
+    for (auto &result : results) {
+      AppendMeshes(std::move(result), *junction_out_mesh_list);
     }
+    std::cout << "Generated " << std::to_string(num_junctions) << " junctions" << std::endl;
   }
 
   std::vector<JuncId> Map::FilterJunctionsByPosition( const geom::Vector3D& minpos,
@@ -21,6 +21,7 @@
 
 #include <boost/optional.hpp>
 
+#include <cstdint>
 #include <vector>
 
 namespace carla {
@@ -39,6 +40,14 @@ namespace road {
       CreateRtree();
     }
 
+    /// Same as above, but the segments of the R-tree and the conflicts of the
+    /// junctions are read from @a compiled_map if it holds the data of this
+    /// map, as written by a previous call, and @a compiled_map is cleared.
+    /// Otherwise the segments are computed and @a compiled_map is overwritten
+    /// with them, MapBuilder appends the conflicts once they are computed so
+    /// the caller can store it for the next time.
+    Map(MapData m, std::vector<uint8_t> &compiled_map);
+
     /// ========================================================================
     /// -- Georeference --------------------------------------------------------
     /// ========================================================================
@@ -64,8 +73,34 @@ namespace road {
         LaneId lane_id,
         float s) const;
 
+    /// Return the waypoint at the exact @a road_id, @a section_id, @a lane_id
+    /// and @a s, or nothing if the lane is not in that section of the road.
+    boost::optional<element::Waypoint> GetWaypoint(
+        RoadId road_id,
+        SectionId section_id,
+        LaneId lane_id,
+        double s) const;
+
     geom::Transform ComputeTransform(Waypoint waypoint) const;
 
+    /// Result of projecting a location with ProjectLocations.
+    struct WaypointProjection {
+      /// False if the location could not be projected to a lane of the
+      /// requested type, in which case the rest of the fields must be ignored.
+      bool is_valid = false;
+      Waypoint waypoint;
+      geom::Transform transform;
+      double lane_width = 0.0;
+    };
+
+    /// Projects each of @a locations to the road, as GetClosestWaypointOnRoad
+    /// if @a project_to_road is true, otherwise as GetWaypoint. The locations
+    /// are split among the threads of ThreadPool::GetShared().
+    std::vector<WaypointProjection> ProjectLocations(
+        const std::vector<geom::Location> &locations,
+        bool project_to_road = true,
+        int32_t lane_type = static_cast<int32_t>(Lane::LaneType::Driving)) const;
+
     /// ========================================================================
     /// -- Road information ----------------------------------------------------
     /// ========================================================================
@@ -211,19 +246,36 @@ private:
 
     void CreateRtree();
 
+    /// Samples the segments of every lane, the lanes are split among worker
+    /// threads and the result is in the same order as a serial loop.
+    std::vector<Rtree::TreeElement> ComputeRtreeElements() const;
+
+    bool ReadCompiledMap(
+        const std::vector<uint8_t> &compiled_map,
+        std::vector<Rtree::TreeElement> &rtree_elements);
+
+    static std::vector<uint8_t> WriteCompiledMap(
+        const std::vector<Rtree::TreeElement> &rtree_elements);
+
+    void WriteCompiledJunctionConflicts(std::vector<uint8_t> &compiled_map) const;
+
     /// Helper Functions for constructing the rtree element list
+    void AddLaneToRtree(
+        std::vector<Rtree::TreeElement> &rtree_elements,
+        const Waypoint &lane_start_waypoint) const;
+
     void AddElementToRtree(
         std::vector<Rtree::TreeElement> &rtree_elements,
         geom::Transform &current_transform,
         geom::Transform &next_transform,
         Waypoint &current_waypoint,
-        Waypoint &next_waypoint);
+        Waypoint &next_waypoint) const;
 
     void AddElementToRtreeAndUpdateTransforms(
         std::vector<Rtree::TreeElement> &rtree_elements,
         geom::Transform &current_transform,
         Waypoint &current_waypoint,
-        Waypoint &next_waypoint);
+        Waypoint &next_waypoint) const;
 
 public:
     inline float GetZPosInDeformation(float posx, float posy) const;
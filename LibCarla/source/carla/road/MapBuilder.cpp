@@ -5,6 +5,7 @@
 // For a copy, see <https://opensource.org/licenses/MIT>.
 
 #include "carla/StringUtil.h"
+#include "carla/ThreadPool.h"
 #include "carla/road/MapBuilder.h"
 #include "carla/road/element/RoadInfoElevation.h"
 #include "carla/road/element/RoadInfoGeometry.h"
@@ -36,6 +37,14 @@ namespace carla {
 namespace road {
 
   boost::optional<Map> MapBuilder::Build() {
+    return Build(nullptr);
+  }
+
+  boost::optional<Map> MapBuilder::Build(std::vector<uint8_t> &compiled_map) {
+    return Build(&compiled_map);
+  }
+
+  boost::optional<Map> MapBuilder::Build(std::vector<uint8_t> *compiled_map) {
 
     CreatePointersBetweenRoadSegments();
     RemoveZeroLaneValiditySignalReferences();
@@ -62,9 +71,18 @@ namespace road {
     // _map_data is a memeber of MapBuilder so you must especify if
     // you want to keep it (will return copy -> Map(const Map &))
     // or move it (will return move -> Map(Map &&))
-    Map map(std::move(_map_data));
+    Map map = (compiled_map != nullptr) ?
+        Map(std::move(_map_data), *compiled_map) :
+        Map(std::move(_map_data));
     CreateJunctionBoundingBoxes(map);
-    ComputeJunctionRoadConflicts(map);
+    // A valid compiled map already has the conflicts, otherwise they are
+    // computed and added to it.
+    if (compiled_map == nullptr || !compiled_map->empty()) {
+      ComputeJunctionRoadConflicts(map);
+      if (compiled_map != nullptr) {
+        map.WriteCompiledJunctionConflicts(*compiled_map);
+      }
+    }
     CheckSignalsOnRoads(map);
 
     return map;
@@ -937,10 +955,19 @@ void MapBuilder::CreateController(
 }
 
   void MapBuilder::ComputeJunctionRoadConflicts(Map &map) {
+    std::vector<Junction *> junctions;
     for (auto &junctionpair : map._data.GetJunctions()) {
-      auto& junction = junctionpair.second;
-      junction._road_conflicts = (map.ComputeJunctionConflicts(junction.GetId()));
+      junctions.push_back(&junctionpair.second);
     }
+
+    // Junctions are independent, each range writes only to its own junctions.
+    constexpr size_t junctions_per_task = 16u;
+    ThreadPool::GetShared().ParallelFor(junctions.size(), junctions_per_task,
+        [&](const size_t begin, const size_t end) {
+      for (auto i = begin; i < end; ++i) {
+        junctions[i]->_road_conflicts = map.ComputeJunctionConflicts(junctions[i]->GetId());
+      }
+    });
   }
 
   void MapBuilder::GenerateDefaultValiditiesForSignalReferences() {
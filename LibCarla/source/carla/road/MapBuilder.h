@@ -13,6 +13,7 @@
 #include <boost/optional.hpp>
 
 #include <map>
+#include <vector>
 
 namespace carla {
 namespace road {
@@ -22,6 +23,11 @@ namespace road {
 
     boost::optional<Map> Build();
 
+    /// Same as Build, but the segments of the R-tree and the conflicts of the
+    /// junctions are read from or written to @a compiled_map, see
+    /// Map::Map(MapData, std::vector<uint8_t> &).
+    boost::optional<Map> Build(std::vector<uint8_t> &compiled_map);
+
     // called from road parser
     carla::road::Road *AddRoad(
         const RoadId road_id,
@@ -364,6 +370,8 @@ namespace road {
 
   private:
 
+    boost::optional<Map> Build(std::vector<uint8_t> *compiled_map);
+
     MapData _map_data;
 
     /// Create the pointers between RoadSegments based on the ids.
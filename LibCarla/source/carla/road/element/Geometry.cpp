@@ -82,16 +82,11 @@ namespace element {
     double t;
     odrSpiral(s, curve_dot, &x, &y, &t);
 
-    double x_o;
-    double y_o;
-    double t_o;
-    odrSpiral(s_o, curve_dot, &x_o, &y_o, &t_o);
+    x = x - _x_o;
+    y = y - _y_o;
+    t = t - _t_o;
 
-    x = x - x_o;
-    y = y - y_o;
-    t = t - t_o;
-
-    geom::Vector2D pos = RotatebyAngle(_heading - t_o, x, y);
+    geom::Vector2D pos = RotatebyAngle(_heading - _t_o, x, y);
     p.location.x += pos.x;
     p.location.y += pos.y;
     p.tangent = _heading + t;
@@ -99,6 +94,12 @@ namespace element {
     return p;
   }
 
+  void GeometrySpiral::PreComputeOrigin() {
+    const double curve_dot = (_curve_end - _curve_start) / (_length);
+    const double s_o = _curve_start / curve_dot;
+    odrSpiral(s_o, curve_dot, &_x_o, &_y_o, &_t_o);
+  }
+
   /// @todo
   std::pair<float, float> GeometrySpiral::DistanceTo(const geom::Location &location) const {
     // Not analytic, discretize and find nearest point
@@ -106,12 +107,25 @@ namespace element {
     return {location.x - _start_position.x, location.y - _start_position.y};
   }
 
+  /// Returns the two consecutive samples around @a dist, or the first or last
+  /// two samples if @a dist is out of their range.
+  template <typename SplineValueT>
+  static std::pair<const SplineValueT &, const SplineValueT &> GetSamplesAround(
+      const std::vector<SplineValueT> &samples,
+      const double dist) {
+    DEBUG_ASSERT(samples.size() >= 2u);
+    auto it = std::upper_bound(samples.begin(), samples.end(), dist,
+        [](const double lhs, const SplineValueT &rhs) { return lhs < rhs.s; });
+    const auto index = geom::Math::Clamp<size_t>(
+        static_cast<size_t>(std::distance(samples.begin(), it)), 1u, samples.size() - 1u);
+    return {samples[index - 1u], samples[index]};
+  }
+
   DirectedPoint GeometryPoly3::PosFromDist(double dist) const {
-    auto result = _rtree.GetNearestNeighbours(
-        Rtree::BPoint(static_cast<float>(dist))).front();
+    const auto result = GetSamplesAround(_samples, dist);
 
-    auto &val1 = result.second.first;
-    auto &val2 = result.second.second;
+    auto &val1 = result.first;
+    auto &val2 = result.second;
 
     double rate = (val2.s - dist) / (val2.s - val1.s);
     double u = rate * val1.u + (1.0 - rate) * val2.u;
@@ -139,8 +153,7 @@ namespace element {
     double current_u = 0;
     double last_u = 0;
     double last_v = _poly.Evaluate(current_u);
-    double last_s = 0;
-    RtreeValue last_val{last_u, last_v, last_s, _poly.Tangent(current_u)};
+    _samples.emplace_back(SplineValue{last_u, last_v, 0.0, _poly.Tangent(current_u)});
     while (current_s < _length + delta_u) {
       current_u += delta_u;
       double current_v = _poly.Evaluate(current_u);
@@ -149,26 +162,20 @@ namespace element {
       double ds = sqrt(du * du + dv * dv);
       current_s += ds;
       double current_t = _poly.Tangent(current_u);
-      RtreeValue current_val{current_u, current_v, current_s, current_t};
+      SplineValue current_val{current_u, current_v, current_s, current_t};
 
-      Rtree::BPoint p1(static_cast<float>(last_s));
-      Rtree::BPoint p2(static_cast<float>(current_s));
-      _rtree.InsertElement(Rtree::BSegment(p1, p2), last_val, current_val);
+      _samples.emplace_back(current_val);
 
       last_u = current_u;
       last_v = current_v;
-      last_s = current_s;
-      last_val = current_val;
-
     }
   }
 
   DirectedPoint GeometryParamPoly3::PosFromDist(double dist) const {
-    auto result = _rtree.GetNearestNeighbours(
-        Rtree::BPoint(static_cast<float>(dist))).front();
+    const auto result = GetSamplesAround(_samples, dist);
 
-    auto &val1 = result.second.first;
-    auto &val2 = result.second.second;
+    auto &val1 = result.first;
+    auto &val2 = result.second;
     double rate = (val2.s - dist) / (val2.s - val1.s);
     double u = rate * val1.u + (1.0 - rate) * val2.u;
     double v = rate * val1.v + (1.0 - rate) * val2.v;
@@ -201,13 +208,12 @@ namespace element {
     double current_s = 0;
     double last_u = _polyU.Evaluate(param_p);
     double last_v = _polyV.Evaluate(param_p);
-    double last_s = 0;
-    RtreeValue last_val{
+    _samples.emplace_back(SplineValue{
         last_u,
         last_v,
-        last_s,
+        0.0,
         _polyU.Tangent(param_p),
-        _polyV.Tangent(param_p) };
+        _polyV.Tangent(param_p) });
     for(size_t i = 0; i < number_intervals; ++i) {
       param_p += delta_p;
       double current_u = _polyU.Evaluate(param_p);
@@ -218,21 +224,17 @@ namespace element {
       current_s += ds;
       double current_t_u = _polyU.Tangent(param_p);
       double current_t_v = _polyV.Tangent(param_p);
-      RtreeValue current_val{
+      SplineValue current_val{
           current_u,
           current_v,
           current_s,
           current_t_u,
           current_t_v };
 
-      Rtree::BPoint p1(static_cast<float>(last_s));
-      Rtree::BPoint p2(static_cast<float>(current_s));
-      _rtree.InsertElement(Rtree::BSegment(p1, p2), last_val, current_val);
+      _samples.emplace_back(current_val);
 
       last_u = current_u;
       last_v = current_v;
-      last_s = current_s;
-      last_val = current_val;
 
       if(current_s > _length){
         break;
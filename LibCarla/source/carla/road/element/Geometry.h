@@ -9,7 +9,8 @@
 #include "carla/geom/Location.h"
 #include "carla/geom/Math.h"
 #include "carla/geom/CubicPolynomial.h"
-#include "carla/geom/Rtree.h"
+
+#include <vector>
 
 namespace carla {
 namespace road {
@@ -173,7 +174,9 @@ namespace element {
         double curv_e)
       : Geometry(GeometryType::SPIRAL, start_offset, length, heading, start_pos),
         _curve_start(curv_s),
-        _curve_end(curv_e) {}
+        _curve_end(curv_e) {
+      PreComputeOrigin();
+    }
 
     double GetCurveStart() {
       return _curve_start;
@@ -191,6 +194,13 @@ namespace element {
 
     double _curve_start;
     double _curve_end;
+
+    /// Point of the standard spiral where this geometry starts, it does not
+    /// depend on the distance so it is computed only once.
+    double _x_o = 0.0;
+    double _y_o = 0.0;
+    double _t_o = 0.0;
+    void PreComputeOrigin();
   };
 
   class GeometryPoly3 final : public Geometry {
@@ -240,15 +250,15 @@ namespace element {
     double _c;
     double _d;
 
-    struct RtreeValue {
+    struct SplineValue {
       double u = 0;
       double v = 0;
       double s = 0;
       double t = 0;
     };
-    using Rtree = geom::SegmentCloudRtree<RtreeValue, 1>;
-    using TreeElement = Rtree::TreeElement;
-    Rtree _rtree;
+    /// Samples of the curve sorted by s, consecutive samples are linearly
+    /// interpolated.
+    std::vector<SplineValue> _samples;
     void PreComputeSpline();
   };
 
@@ -327,16 +337,16 @@ namespace element {
     double _dV;
     bool _arcLength;
 
-    struct RtreeValue {
+    struct SplineValue {
       double u = 0;
       double v = 0;
       double s = 0;
       double t_u = 0;
       double t_v = 0;
     };
-    using Rtree = geom::SegmentCloudRtree<RtreeValue, 1>;
-    using TreeElement = Rtree::TreeElement;
-    Rtree _rtree;
+    /// Samples of the curve sorted by s, consecutive samples are linearly
+    /// interpolated.
+    std::vector<SplineValue> _samples;
     void PreComputeSpline();
   };
 
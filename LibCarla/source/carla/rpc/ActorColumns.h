@@ -0,0 +1,134 @@
+// Copyright (c) 2023 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/MsgPack.h"
+#include "carla/geom/Location.h"
+#include "carla/geom/Transform.h"
+#include "carla/geom/Vector3D.h"
+#include "carla/rpc/ActorId.h"
+#include "carla/rpc/VehicleControl.h"
+#include "carla/rpc/VehicleLightState.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace carla {
+namespace rpc {
+
+  using ActorFieldType = uint32_t;
+
+  /// Fields of the actors that can be requested in bulk, used as flags.
+  ///
+  /// The fields in the lower half are read by the client from the state it
+  /// receives every tick, without calling the server. The ones in the upper
+  /// half are requested to the server, with a single call for all the actors.
+  enum class ActorField : ActorFieldType {
+    None              =  0,
+    Transform         =  0x1,
+    Velocity          =  0x1 << 1,
+    AngularVelocity   =  0x1 << 2,
+    Acceleration      =  0x1 << 3,
+    VehicleControl    =  0x1 << 4,
+    SpeedLimit        =  0x1 << 5,
+    TrafficLightState =  0x1 << 6,
+    VehicleLightState =  0x1 << 16,
+    VehiclePhysics    =  0x1 << 17,
+    BoneTransforms    =  0x1 << 18,
+    All               =  0xFFFFFFFF,
+  };
+
+  /// Fields that only the server knows.
+  constexpr ActorFieldType ServerActorFields = 0xFFFF0000u;
+
+  inline bool HasField(ActorFieldType fields, ActorField field) {
+    return (fields & static_cast<ActorFieldType>(field)) != 0u;
+  }
+
+#pragma pack(push, 1)
+
+  /// Same fields as VehicleControl, without padding.
+  struct VehicleControlRecord {
+
+    VehicleControlRecord() = default;
+
+    VehicleControlRecord(const VehicleControl &control)
+      : throttle(control.throttle),
+        steer(control.steer),
+        brake(control.brake),
+        hand_brake(control.hand_brake),
+        reverse(control.reverse),
+        manual_gear_shift(control.manual_gear_shift),
+        gear(control.gear) {}
+
+    float throttle = 0.0f;
+    float steer = 0.0f;
+    float brake = 0.0f;
+    bool hand_brake = false;
+    bool reverse = false;
+    bool manual_gear_shift = false;
+    int32_t gear = 0;
+  };
+
+#pragma pack(pop)
+
+  /// The scalar parameters of VehiclePhysicsControl.
+  struct VehiclePhysicsRecord {
+    float mass = 0.0f;
+    float max_rpm = 0.0f;
+    float moi = 0.0f;
+    float drag_coefficient = 0.0f;
+    geom::Location center_of_mass;
+
+    MSGPACK_DEFINE_ARRAY(mass, max_rpm, moi, drag_coefficient, center_of_mass);
+  };
+
+  static_assert(sizeof(VehicleControlRecord) == 19u, "Unexpected padding.");
+  static_assert(sizeof(VehiclePhysicsRecord) == 28u, "Unexpected padding.");
+  static_assert(sizeof(geom::Transform) == 24u, "Unexpected padding.");
+  static_assert(sizeof(geom::Vector3D) == 12u, "Unexpected padding.");
+
+  /// State of several actors, one column per field. The columns requested
+  /// have an entry per actor, in the order of @a ids, and the rest are empty.
+  /// The entries of actors that do not exist, or that do not have the field
+  /// (e.g. the control of a walker), are zero.
+  ///
+  /// Only the fields of the server are serialized; the client fills the rest.
+  class ActorColumns {
+  public:
+
+    std::vector<ActorId> ids;
+
+    std::vector<geom::Transform> transform;
+
+    std::vector<geom::Vector3D> velocity;
+
+    std::vector<geom::Vector3D> angular_velocity;
+
+    std::vector<geom::Vector3D> acceleration;
+
+    std::vector<VehicleControlRecord> vehicle_control;
+
+    std::vector<float> speed_limit;
+
+    std::vector<uint8_t> traffic_light_state;
+
+    std::vector<VehicleLightState::flag_type> vehicle_light_state;
+
+    std::vector<VehiclePhysicsRecord> vehicle_physics;
+
+    /// Number of bones of each actor, their transforms are consecutive in
+    /// @a bone_transforms, in world coordinates.
+    std::vector<uint32_t> bone_count;
+
+    std::vector<geom::Transform> bone_transforms;
+
+    MSGPACK_DEFINE_ARRAY(ids, vehicle_light_state, vehicle_physics, bone_count, bone_transforms);
+  };
+
+} // namespace rpc
+} // namespace carla
@@ -38,6 +38,14 @@ namespace rpc {
       _client.async_call(function, Metadata::MakeAsync(), std::forward<Args>(args)...);
     }
 
+    /// Sends the call without waiting for the response. Unlike async_call the
+    /// server does send the response, that is read from the future returned,
+    /// so many calls can be in flight on the same connection.
+    template <typename... Args>
+    auto async_call_with_response(const std::string &function, Args &&... args) {
+      return _client.async_call(function, Metadata::MakeSync(), std::forward<Args>(args)...);
+    }
+
   private:
 
     ::rpc::client _client;
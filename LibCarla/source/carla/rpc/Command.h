@@ -223,6 +223,24 @@ namespace rpc {
       MSGPACK_DEFINE_ARRAY(actor, enabled);
     };
 
+    struct SetActorCollisions : CommandBase<SetActorCollisions> {
+      SetActorCollisions() = default;
+      SetActorCollisions(ActorId id, bool value)
+        : actor(id),
+          enabled(value) {}
+      ActorId actor;
+      bool enabled;
+      MSGPACK_DEFINE_ARRAY(actor, enabled);
+    };
+
+    struct SetActorDead : CommandBase<SetActorDead> {
+      SetActorDead() = default;
+      SetActorDead(ActorId id)
+        : actor(id) {}
+      ActorId actor;
+      MSGPACK_DEFINE_ARRAY(actor);
+    };
+
     struct SetAutopilot : CommandBase<SetAutopilot> {
       SetAutopilot() = default;
       SetAutopilot(
@@ -303,7 +321,9 @@ namespace rpc {
         SetVehicleLightState,
         ApplyLocation,
         ConsoleCommand,
-        SetTrafficLightState>;
+        SetTrafficLightState,
+        SetActorCollisions,
+        SetActorDead>;
 
     CommandType command;
 
@@ -0,0 +1,160 @@
+// Copyright (c) 2023 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "carla/sensor/s11n/EpisodeStateDeltaSerializer.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace carla {
+namespace sensor {
+namespace s11n {
+
+  using ActorDynamicState = data::ActorDynamicState;
+
+  /// Quantization steps of the stream. Changes below these are not sent, the
+  /// error is bounded since actors are compared against the last state sent.
+  static constexpr float LOCATION_STEP = 1e-3f;          // 1 mm.
+  static constexpr float ROTATION_STEP = 1e-2f;          // 0.01 degrees.
+  static constexpr float VELOCITY_STEP = 1e-3f;          // 1 mm/s.
+  static constexpr float ANGULAR_VELOCITY_STEP = 1e-2f;  // 0.01 degrees/s.
+  static constexpr float ACCELERATION_STEP = 1e-2f;      // 1 cm/s^2.
+
+  static bool Differ(float lhs, float rhs, float step) {
+    return std::abs(lhs - rhs) >= step;
+  }
+
+  static bool Differ(const geom::Vector3D &lhs, const geom::Vector3D &rhs, float step) {
+    return Differ(lhs.x, rhs.x, step) || Differ(lhs.y, rhs.y, step) || Differ(lhs.z, rhs.z, step);
+  }
+
+  static bool DifferAngle(float lhs, float rhs) {
+    const float diff = std::fmod(std::abs(lhs - rhs), 360.0f);
+    return std::min(diff, 360.0f - diff) >= ROTATION_STEP;
+  }
+
+  // ===========================================================================
+  // -- EpisodeStateDeltaSerializer --------------------------------------------
+  // ===========================================================================
+
+  bool EpisodeStateDeltaSerializer::Deserialize(const Buffer &buffer, Message &message) {
+    if (buffer.size() < header_offset) {
+      return false;
+    }
+    const auto &sensor_header = SensorHeaderSerializer::Deserialize(buffer);
+    const unsigned char *begin = buffer.data() + SensorHeaderSerializer::header_offset;
+    message.frame = sensor_header.frame;
+    message.timestamp = sensor_header.timestamp;
+    message.header = reinterpret_cast<const EpisodeStateSerializer::Header *>(begin);
+    message.delta_header = reinterpret_cast<const DeltaHeader *>(begin + EpisodeStateSerializer::header_offset);
+    const size_t updated_size = sizeof(ActorDynamicState) * message.delta_header->updated_count;
+    const size_t removed_size = sizeof(rpc::ActorId) * message.delta_header->removed_count;
+    if (buffer.size() != header_offset + updated_size + removed_size) {
+      return false;
+    }
+    message.updated = reinterpret_cast<const ActorDynamicState *>(buffer.data() + header_offset);
+    message.removed = buffer.data() + header_offset + updated_size;
+    return true;
+  }
+
+  // ===========================================================================
+  // -- EpisodeStateDeltaEncoder -----------------------------------------------
+  // ===========================================================================
+
+  bool EpisodeStateDeltaEncoder::HasChanged(
+      const ActorDynamicState &lhs,
+      const ActorDynamicState &rhs) {
+    const auto &lt = lhs.transform;
+    const auto &rt = rhs.transform;
+    return
+        lhs.actor_state != rhs.actor_state ||
+        Differ(lt.location, rt.location, LOCATION_STEP) ||
+        DifferAngle(lt.rotation.pitch, rt.rotation.pitch) ||
+        DifferAngle(lt.rotation.yaw, rt.rotation.yaw) ||
+        DifferAngle(lt.rotation.roll, rt.rotation.roll) ||
+        Differ(lhs.velocity, rhs.velocity, VELOCITY_STEP) ||
+        Differ(lhs.angular_velocity, rhs.angular_velocity, ANGULAR_VELOCITY_STEP) ||
+        Differ(lhs.acceleration, rhs.acceleration, ACCELERATION_STEP) ||
+        std::memcmp(&lhs.state, &rhs.state, sizeof(lhs.state)) != 0;
+  }
+
+  Buffer EpisodeStateDeltaEncoder::Encode(
+      const uint64_t frame,
+      const EpisodeStateSerializer::Header &header,
+      const std::vector<ActorDynamicState> &actors,
+      Buffer &&buffer) {
+    const bool is_keyframe =
+        _keyframe_requested.exchange(false) ||
+        !_has_frame ||
+        frame != _last_frame + 1u ||
+        header.episode_id != _last_episode_id ||
+        _frames_since_keyframe + 1u >= _keyframe_interval;
+
+    Serializer::DeltaHeader delta_header;
+    delta_header.frame_type = is_keyframe ? Serializer::FrameType::KeyFrame : Serializer::FrameType::Delta;
+    delta_header.base_frame = is_keyframe ? frame : _last_frame;
+    delta_header.actor_count = static_cast<uint32_t>(actors.size());
+
+    _updated.clear();
+    _removed.clear();
+
+    if (is_keyframe) {
+      _sent.clear();
+      _sent.reserve(actors.size());
+    }
+    for (const auto &actor : actors) {
+      auto result = _sent.emplace(actor.id, SentActor{actor, frame});
+      SentActor &sent = result.first->second;
+      if (result.second || is_keyframe) {
+        _updated.emplace_back(&actor);
+      } else if (HasChanged(sent.state, actor)) {
+        sent.state = actor;
+        _updated.emplace_back(&actor);
+      }
+      sent.frame = frame;
+    }
+    if (_sent.size() != actors.size()) {
+      for (auto it = _sent.begin(); it != _sent.end();) {
+        if (it->second.frame != frame) {
+          _removed.emplace_back(it->first);
+          it = _sent.erase(it);
+        } else {
+          ++it;
+        }
+      }
+    }
+
+    delta_header.updated_count = static_cast<uint32_t>(_updated.size());
+    delta_header.removed_count = static_cast<uint32_t>(_removed.size());
+
+    const size_t header_size = sizeof(header) + sizeof(delta_header);
+    const size_t updated_size = sizeof(ActorDynamicState) * _updated.size();
+    const size_t removed_size = sizeof(rpc::ActorId) * _removed.size();
+    buffer.reset(header_size + updated_size + removed_size);
+
+    auto *it = buffer.data();
+    std::memcpy(it, &header, sizeof(header));
+    it += sizeof(header);
+    std::memcpy(it, &delta_header, sizeof(delta_header));
+    it += sizeof(delta_header);
+    for (const auto *actor : _updated) {
+      std::memcpy(it, actor, sizeof(ActorDynamicState));
+      it += sizeof(ActorDynamicState);
+    }
+    if (!_removed.empty()) {
+      std::memcpy(it, _removed.data(), removed_size);
+    }
+
+    _has_frame = true;
+    _last_frame = frame;
+    _last_episode_id = header.episode_id;
+    _frames_since_keyframe = is_keyframe ? 0u : _frames_since_keyframe + 1u;
+    return std::move(buffer);
+  }
+
+} // namespace s11n
+} // namespace sensor
+} // namespace carla
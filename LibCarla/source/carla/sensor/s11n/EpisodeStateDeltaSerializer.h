@@ -0,0 +1,148 @@
+// Copyright (c) 2023 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/Buffer.h"
+#include "carla/rpc/ActorId.h"
+#include "carla/sensor/data/ActorDynamicState.h"
+#include "carla/sensor/s11n/EpisodeStateSerializer.h"
+#include "carla/sensor/s11n/SensorHeaderSerializer.h"
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <unordered_map>
+#include <vector>
+
+namespace carla {
+namespace sensor {
+namespace s11n {
+
+  /// Serializes the state of the episode as the difference with the previous
+  /// message sent through the same stream. The message layout, after the
+  /// sensor header, is
+  ///
+  ///   EpisodeStateSerializer::Header
+  ///   DeltaHeader
+  ///   ActorDynamicState[updated_count]  (added or changed actors)
+  ///   ActorId[removed_count]
+  ///
+  /// Key frames contain every actor and no removals.
+  class EpisodeStateDeltaSerializer {
+  public:
+
+    enum class FrameType : uint8_t {
+      KeyFrame = 0u,
+      Delta    = 1u
+    };
+
+#pragma pack(push, 1)
+    struct DeltaHeader {
+      FrameType frame_type;
+      /// Frame of the message this delta applies on top of.
+      uint64_t base_frame;
+      /// Number of actors in the resulting state.
+      uint32_t actor_count;
+      uint32_t updated_count;
+      uint32_t removed_count;
+    };
+#pragma pack(pop)
+
+    constexpr static auto header_offset =
+        SensorHeaderSerializer::header_offset +
+        EpisodeStateSerializer::header_offset +
+        sizeof(DeltaHeader);
+
+    /// View over a received message, valid as long as the buffer is alive.
+    struct Message {
+      uint64_t frame;
+      double timestamp;
+      const EpisodeStateSerializer::Header *header;
+      const DeltaHeader *delta_header;
+      const data::ActorDynamicState *updated;
+      const unsigned char *removed;
+
+      bool IsKeyFrame() const {
+        return delta_header->frame_type == FrameType::KeyFrame;
+      }
+
+      rpc::ActorId GetRemovedId(size_t index) const {
+        rpc::ActorId id;
+        std::memcpy(&id, removed + index * sizeof(rpc::ActorId), sizeof(rpc::ActorId));
+        return id;
+      }
+    };
+
+    /// Fills @a message from @a buffer, which must contain the sensor header.
+    /// Returns false if the buffer is not a valid delta message.
+    static bool Deserialize(const Buffer &buffer, Message &message);
+  };
+
+  /// Keeps the last state sent through a delta stream and generates the
+  /// messages for the following frames.
+  class EpisodeStateDeltaEncoder {
+  public:
+
+    using Serializer = EpisodeStateDeltaSerializer;
+
+    explicit EpisodeStateDeltaEncoder(uint32_t keyframe_interval = 30u)
+      : _keyframe_interval(keyframe_interval) {}
+
+    void SetKeyFrameInterval(uint32_t keyframe_interval) {
+      _keyframe_interval = keyframe_interval;
+    }
+
+    /// Forces the next message to be a key frame. Thread-safe.
+    void RequestKeyFrame() {
+      _keyframe_requested = true;
+    }
+
+    /// Writes into @a buffer the message for @a frame given the complete list
+    /// of actors at that frame. Frames not consecutive to the last encoded one
+    /// start with a key frame.
+    Buffer Encode(
+        uint64_t frame,
+        const EpisodeStateSerializer::Header &header,
+        const std::vector<data::ActorDynamicState> &actors,
+        Buffer &&buffer);
+
+    /// Returns true if @a lhs and @a rhs differ by more than the quantization
+    /// step of the stream.
+    static bool HasChanged(
+        const data::ActorDynamicState &lhs,
+        const data::ActorDynamicState &rhs);
+
+  private:
+
+    struct SentActor {
+      data::ActorDynamicState state;
+      uint64_t frame;
+    };
+
+    uint32_t _keyframe_interval;
+
+    std::atomic_bool _keyframe_requested{true};
+
+    bool _has_frame = false;
+
+    uint64_t _last_frame = 0u;
+
+    uint64_t _last_episode_id = 0u;
+
+    uint32_t _frames_since_keyframe = 0u;
+
+    /// Last state sent of every actor, and the frame it was last seen at.
+    std::unordered_map<rpc::ActorId, SentActor> _sent;
+
+    std::vector<const data::ActorDynamicState *> _updated;
+
+    std::vector<rpc::ActorId> _removed;
+  };
+
+} // namespace s11n
+} // namespace sensor
+} // namespace carla
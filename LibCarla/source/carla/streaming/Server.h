@@ -71,6 +71,14 @@ namespace streaming {
       _server.SetSynchronousMode(is_synchro);
     }
 
+    void SetSendQueuePolicy(detail::tcp::SendQueuePolicy policy, size_t capacity) {
+      _server.SetSendQueuePolicy(policy, capacity);
+    }
+
+    void SetSharedMemoryCapacity(size_t capacity) {
+      _server.SetSharedMemoryCapacity(capacity);
+    }
+
     token_type GetToken(stream_id sensor_id) {
       return _server.GetToken(sensor_id);
     }
@@ -103,6 +103,14 @@ namespace detail {
     }
   }
   
+  void Dispatcher::SetSharedMemory(const bool enabled) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _cached_token.set_shared_memory(enabled);
+    for (auto &pair : _stream_map) {
+      pair.second->SetSharedMemory(enabled);
+    }
+  }
+
   token_type Dispatcher::GetToken(stream_id_type sensor_id) {
     std::lock_guard<std::mutex> lock(_mutex);
     log_debug("Searching sensor id: ", sensor_id);
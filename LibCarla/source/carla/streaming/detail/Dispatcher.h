@@ -43,6 +43,10 @@ namespace detail {
 
     token_type GetToken(stream_id_type sensor_id);
 
+    /// Set whether the tokens of the streams advertise the shared memory
+    /// transport, applies to the existing streams too.
+    void SetSharedMemory(bool enabled);
+
     void EnableForROS(stream_id_type sensor_id) {
       auto search = _stream_map.find(sensor_id);
       if (search != _stream_map.end()) {
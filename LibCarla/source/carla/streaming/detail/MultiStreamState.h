@@ -10,6 +10,9 @@
 #include "carla/Logging.h"
 #include "carla/streaming/detail/StreamStateBase.h"
 #include "carla/streaming/detail/tcp/Message.h"
+#include "carla/streaming/detail/tcp/SendQueue.h"
+
+#include <boost/optional.hpp>
 
 #include <mutex>
 #include <vector>
@@ -34,11 +37,12 @@ namespace detail {
 
     template <typename... Buffers>
     void Write(Buffers... buffers) {
+      const auto policy = GetSendQueuePolicy();
       // try write single stream
       auto session = _session.load();
       if (session != nullptr) {
         auto message = Session::MakeMessage(buffers...);
-        session->Write(std::move(message));
+        session->Write(std::move(message), session->GetWriteDeadline(), policy);
         log_debug("sensor ", session->get_stream_id()," data sent");
         // Return here, _session is only valid if we have a
         // single session.
@@ -49,15 +53,28 @@ namespace detail {
       std::lock_guard<std::mutex> lock(_mutex);
       if (_sessions.size() > 0) {
         auto message = Session::MakeMessage(buffers...);
+        // all the sessions share the deadline, so a blocking policy waits
+        // for one timeout at most instead of one per session
+        boost::optional<tcp::SendQueue::clock_type::time_point> deadline;
         for (auto &s : _sessions) {
           if (s != nullptr) {
-            s->Write(message);
+            if (!deadline) {
+              deadline = s->GetWriteDeadline();
+            }
+            s->Write(message, *deadline, policy);
             log_debug("sensor ", s->get_stream_id()," data sent ");
          }
         }
       }
     }
 
+    /// Use @a policy for the send queues of the sessions of this stream,
+    /// instead of the server's policy.
+    void SetSendQueuePolicy(tcp::SendQueuePolicy policy) {
+      _send_queue_policy = policy;
+      _has_send_queue_policy = true;
+    }
+
     void ForceActive() {
       _force_active = true;
     }
@@ -78,6 +95,19 @@ namespace detail {
       return (_sessions.size() > 0 || _force_active || _enabled_for_ros);
     }
 
+    /// Counters of the messages sent and dropped by all the sessions that
+    /// have been connected to this stream.
+    tcp::SendQueueStatistics GetStatistics() {
+      std::lock_guard<std::mutex> lock(_mutex);
+      auto statistics = _closed_sessions_statistics;
+      for (auto &s : _sessions) {
+        if (s != nullptr) {
+          statistics += s->GetStatistics();
+        }
+      }
+      return statistics;
+    }
+
     void ConnectSession(std::shared_ptr<Session> session) final {
       DEBUG_ASSERT(session != nullptr);
       std::lock_guard<std::mutex> lock(_mutex);
@@ -96,6 +126,7 @@ namespace detail {
       std::lock_guard<std::mutex> lock(_mutex);
       log_debug("Calling DisconnectSession for ", session->get_stream_id());
       if (_sessions.size() == 0) return;
+      RecordStatistics(*session);
       if (_sessions.size() == 1) {
         DEBUG_ASSERT(session == _session.load());
         _session.store(nullptr);
@@ -120,6 +151,7 @@ namespace detail {
       std::lock_guard<std::mutex> lock(_mutex);
       for (auto &s : _sessions) {
         if (s != nullptr) {
+          RecordStatistics(*s);
           s->Close();
         }
       }
@@ -131,6 +163,19 @@ namespace detail {
 
   private:
 
+    void RecordStatistics(const Session &session) {
+      auto statistics = session.GetStatistics();
+      statistics.queue_depth = 0u;
+      _closed_sessions_statistics += statistics;
+    }
+
+    boost::optional<tcp::SendQueuePolicy> GetSendQueuePolicy() const {
+      if (_has_send_queue_policy) {
+        return _send_queue_policy.load();
+      }
+      return boost::none;
+    }
+
     std::mutex _mutex;
 
     // if there is only one session, then we use atomic
@@ -139,6 +184,9 @@ namespace detail {
     std::vector<std::shared_ptr<Session>> _sessions;
     bool _force_active {false};
     bool _enabled_for_ros {false};
+    tcp::SendQueueStatistics _closed_sessions_statistics;
+    std::atomic_bool _has_send_queue_policy{false};
+    std::atomic<tcp::SendQueuePolicy> _send_queue_policy{tcp::SendQueuePolicy::LatestOnly};
   };
 
 } // namespace detail
@@ -0,0 +1,257 @@
+// Copyright (c) 2023 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "carla/streaming/detail/SharedMemoryRing.h"
+
+#include "carla/Debug.h"
+#include "carla/Logging.h"
+
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <cstring>
+#include <iomanip>
+#include <new>
+#include <random>
+#include <sstream>
+
+#if defined(__linux__)
+#  include <cerrno>
+#  include <fcntl.h>
+#  include <linux/futex.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <sys/syscall.h>
+#  include <time.h>
+#  include <unistd.h>
+#endif
+
+namespace carla {
+namespace streaming {
+namespace detail {
+
+  static constexpr uint64_t MAGIC = 0x474E4952414C5243u; // "CRLARING".
+
+  /// Bytes reserved for the header, the data starts at the next page.
+  static constexpr size_t HEADER_SIZE = 4096u;
+
+  static_assert(
+      sizeof(std::atomic<uint32_t>) == sizeof(uint32_t) && ATOMIC_INT_LOCK_FREE == 2,
+      "The futex word must be a lock-free 32-bit integer.");
+
+  /// Lives at the beginning of the segment, shared by both processes.
+  struct SharedMemoryRing::Header {
+    uint64_t magic;
+    key_type key;
+    uint64_t capacity;
+    /// Total bytes written and read since the ring was created, the offset in
+    /// the data is the position modulo the capacity.
+    alignas(64) std::atomic<uint64_t> write_position{0u};
+    /// Futex word, changes every time there is something new for the reader.
+    std::atomic<uint32_t> sequence{0u};
+    std::atomic<uint32_t> closed{0u};
+    alignas(64) std::atomic<uint64_t> read_position{0u};
+  };
+
+  static std::string GetName(SharedMemoryRing::key_type key) {
+    std::ostringstream name;
+    name << "/carla_stream_" << std::hex << std::setfill('0') << std::setw(16) << key;
+    return name.str();
+  }
+
+#if defined(__linux__)
+
+  static void FutexWait(std::atomic<uint32_t> &word, uint32_t expected, time_duration timeout) {
+    const auto milliseconds = timeout.milliseconds();
+    timespec ts;
+    ts.tv_sec = static_cast<time_t>(milliseconds / 1000u);
+    ts.tv_nsec = static_cast<long>((milliseconds % 1000u) * 1000000u);
+    ::syscall(SYS_futex, reinterpret_cast<uint32_t *>(&word), FUTEX_WAIT, expected, &ts, nullptr, 0);
+  }
+
+  static void FutexWake(std::atomic<uint32_t> &word) {
+    ::syscall(SYS_futex, reinterpret_cast<uint32_t *>(&word), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+  }
+
+  bool SharedMemoryRing::IsSupported() {
+    return true;
+  }
+
+  std::unique_ptr<SharedMemoryRing> SharedMemoryRing::Create(const size_t capacity) {
+    static_assert(sizeof(Header) <= HEADER_SIZE, "Shared memory header too big.");
+    DEBUG_ASSERT(capacity > sizeof(message_size_type));
+    std::random_device device;
+    const key_type key = (static_cast<key_type>(device()) << 32u) | device();
+    const auto name = GetName(key);
+    const int fd = ::shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, S_IRUSR | S_IWUSR);
+    if (fd < 0) {
+      log_warning("shared memory: failed to create", name, ':', std::strerror(errno));
+      return nullptr;
+    }
+    const size_t size = HEADER_SIZE + capacity;
+    void *address = MAP_FAILED;
+    if (::ftruncate(fd, static_cast<off_t>(size)) == 0) {
+      address = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    ::close(fd);
+    if (address == MAP_FAILED) {
+      log_warning("shared memory: failed to map", name, ':', std::strerror(errno));
+      ::shm_unlink(name.c_str());
+      return nullptr;
+    }
+    auto *header = new (address) Header();
+    header->key = key;
+    header->capacity = capacity;
+    header->magic = MAGIC;
+    return std::unique_ptr<SharedMemoryRing>(new SharedMemoryRing(key, address, size, true));
+  }
+
+  std::unique_ptr<SharedMemoryRing> SharedMemoryRing::Open(const key_type key) {
+    const auto name = GetName(key);
+    const int fd = ::shm_open(name.c_str(), O_RDWR, 0);
+    if (fd < 0) {
+      log_debug("shared memory: failed to open", name, ':', std::strerror(errno));
+      return nullptr;
+    }
+    struct stat status;
+    void *address = MAP_FAILED;
+    size_t size = 0u;
+    if ((::fstat(fd, &status) == 0) && (static_cast<size_t>(status.st_size) > HEADER_SIZE)) {
+      size = static_cast<size_t>(status.st_size);
+      address = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    ::close(fd);
+    if (address == MAP_FAILED) {
+      log_debug("shared memory: failed to map", name);
+      return nullptr;
+    }
+    const auto *header = static_cast<const Header *>(address);
+    if ((header->magic != MAGIC) || (header->key != key) || (HEADER_SIZE + header->capacity > size)) {
+      log_debug("shared memory: invalid segment", name);
+      ::munmap(address, size);
+      return nullptr;
+    }
+    return std::unique_ptr<SharedMemoryRing>(new SharedMemoryRing(key, address, size, false));
+  }
+
+  SharedMemoryRing::~SharedMemoryRing() {
+    if (_is_owner) {
+      Close();
+      ::shm_unlink(GetName(_key).c_str());
+    }
+    ::munmap(_address, _size);
+  }
+
+#else
+
+  static void FutexWait(std::atomic<uint32_t> &, uint32_t, time_duration) {}
+
+  static void FutexWake(std::atomic<uint32_t> &) {}
+
+  bool SharedMemoryRing::IsSupported() {
+    return false;
+  }
+
+  std::unique_ptr<SharedMemoryRing> SharedMemoryRing::Create(size_t) {
+    return nullptr;
+  }
+
+  std::unique_ptr<SharedMemoryRing> SharedMemoryRing::Open(key_type) {
+    return nullptr;
+  }
+
+  SharedMemoryRing::~SharedMemoryRing() = default;
+
+#endif // __linux__
+
+  SharedMemoryRing::SharedMemoryRing(
+      const key_type key,
+      void *address,
+      const size_t size,
+      const bool is_owner)
+    : _key(key),
+      _address(address),
+      _size(size),
+      _is_owner(is_owner),
+      _header(static_cast<Header *>(address)),
+      _data(static_cast<unsigned char *>(address) + HEADER_SIZE) {}
+
+  size_t SharedMemoryRing::GetCapacity() const {
+    return _header->capacity;
+  }
+
+  bool SharedMemoryRing::Reserve(const size_t size, uint64_t &position) {
+    position = _header->write_position.load(std::memory_order_relaxed);
+    const auto read_position = _header->read_position.load(std::memory_order_acquire);
+    return _header->capacity - (position - read_position) >= size;
+  }
+
+  void SharedMemoryRing::Commit(const uint64_t position) {
+    _header->write_position.store(position, std::memory_order_release);
+    Notify();
+  }
+
+  void SharedMemoryRing::Notify() {
+    _header->sequence.fetch_add(1u, std::memory_order_release);
+    FutexWake(_header->sequence);
+  }
+
+  void SharedMemoryRing::CopyTo(const uint64_t position, const unsigned char *source, const size_t size) {
+    const size_t offset = position % _header->capacity;
+    const size_t first = std::min<size_t>(size, _header->capacity - offset);
+    std::memcpy(_data + offset, source, first);
+    std::memcpy(_data, source + first, size - first);
+  }
+
+  void SharedMemoryRing::CopyFrom(const uint64_t position, unsigned char *destination, const size_t size) const {
+    const size_t offset = position % _header->capacity;
+    const size_t first = std::min<size_t>(size, _header->capacity - offset);
+    std::memcpy(destination, _data + offset, first);
+    std::memcpy(destination + first, _data, size - first);
+  }
+
+  bool SharedMemoryRing::Read(Buffer &buffer, const time_duration timeout) {
+    const auto position = _header->read_position.load(std::memory_order_relaxed);
+    if (_header->write_position.load(std::memory_order_acquire) == position) {
+      const auto sequence = _header->sequence.load(std::memory_order_acquire);
+      if (IsClosed()) {
+        return false;
+      }
+      // Check again now that we hold the sequence, a write in between changes
+      // it and the wait returns immediately.
+      if (_header->write_position.load(std::memory_order_acquire) == position) {
+        FutexWait(_header->sequence, sequence, timeout);
+      }
+      if (IsClosed() || (_header->write_position.load(std::memory_order_acquire) == position)) {
+        return false;
+      }
+    }
+    // The writer does not touch the data until the read position moves, so
+    // the copy can be made directly from the ring.
+    message_size_type size;
+    CopyFrom(position, reinterpret_cast<unsigned char *>(&size), sizeof(size));
+    buffer.reset(size);
+    CopyFrom(position + sizeof(size), buffer.data(), size);
+    _header->read_position.store(position + sizeof(size) + size, std::memory_order_release);
+    return true;
+  }
+
+  void SharedMemoryRing::Close() {
+    _header->closed.store(1u, std::memory_order_release);
+    Notify();
+  }
+
+  bool SharedMemoryRing::IsClosed() const {
+    return _header->closed.load(std::memory_order_acquire) != 0u;
+  }
+
+  void SharedMemoryRing::Interrupt() {
+    Notify();
+  }
+
+} // namespace detail
+} // namespace streaming
+} // namespace carla
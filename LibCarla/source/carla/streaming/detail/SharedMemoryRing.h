@@ -0,0 +1,123 @@
+// Copyright (c) 2023 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/Buffer.h"
+#include "carla/NonCopyable.h"
+#include "carla/Time.h"
+#include "carla/streaming/detail/Types.h"
+
+#include <boost/asio/buffer.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace carla {
+namespace streaming {
+namespace detail {
+
+  /// Single-producer single-consumer ring of messages in a shared memory
+  /// segment, used to send the data of a stream to a client on the same host.
+  ///
+  /// Messages keep the TCP layout, a message_size_type followed by the data.
+  /// The read and write positions are lock-free atomics in the segment, and
+  /// the reader sleeps on a futex when the ring is empty. Only available on
+  /// Linux, elsewhere Create and Open always fail.
+  class SharedMemoryRing : private NonCopyable {
+  public:
+
+    using key_type = uint64_t;
+
+    static bool IsSupported();
+
+    /// Creates a new segment able to hold @a capacity bytes of messages.
+    /// Returns nullptr if the segment cannot be created.
+    static std::unique_ptr<SharedMemoryRing> Create(size_t capacity);
+
+    /// Maps the segment created by the server with @a key. Returns nullptr if
+    /// the segment does not exist, which is the case if the server is on a
+    /// different host.
+    static std::unique_ptr<SharedMemoryRing> Open(key_type key);
+
+    /// The creator closes the ring and removes the segment, the memory is
+    /// released once both processes unmap it.
+    ~SharedMemoryRing();
+
+    key_type GetKey() const {
+      return _key;
+    }
+
+    size_t GetCapacity() const;
+
+    /// Copies the message in @a buffers to the ring, the first buffer must
+    /// contain the size of the message. Returns false if there is no room for
+    /// it yet. Only one thread may write.
+    template <typename BufferSequence>
+    bool TryWrite(const BufferSequence &buffers) {
+      size_t size = 0u;
+      for (const auto &buffer : buffers) {
+        size += boost::asio::buffer_size(buffer);
+      }
+      uint64_t position;
+      if (!Reserve(size, position)) {
+        return false;
+      }
+      for (const auto &buffer : buffers) {
+        const auto length = boost::asio::buffer_size(buffer);
+        CopyTo(position, static_cast<const unsigned char *>(buffer.data()), length);
+        position += length;
+      }
+      Commit(position);
+      return true;
+    }
+
+    /// Waits up to @a timeout for a message and copies it to @a buffer.
+    /// Returns false if no message arrived or the ring was closed. Only one
+    /// thread may read.
+    bool Read(Buffer &buffer, time_duration timeout);
+
+    /// Marks the ring as closed and wakes up the reader.
+    void Close();
+
+    bool IsClosed() const;
+
+    /// Wakes up the reader without closing the ring.
+    void Interrupt();
+
+  private:
+
+    struct Header;
+
+    SharedMemoryRing(key_type key, void *address, size_t size, bool is_owner);
+
+    bool Reserve(size_t size, uint64_t &position);
+
+    void Commit(uint64_t position);
+
+    void CopyTo(uint64_t position, const unsigned char *source, size_t size);
+
+    void CopyFrom(uint64_t position, unsigned char *destination, size_t size) const;
+
+    void Notify();
+
+    const key_type _key;
+
+    void *const _address;
+
+    const size_t _size;
+
+    const bool _is_owner;
+
+    Header *const _header;
+
+    unsigned char *const _data;
+  };
+
+} // namespace detail
+} // namespace streaming
+} // namespace carla
@@ -9,6 +9,7 @@
 #include "carla/Buffer.h"
 #include "carla/Debug.h"
 #include "carla/streaming/Token.h"
+#include "carla/streaming/detail/tcp/SendQueue.h"
 
 #include <memory>
 
@@ -47,6 +48,13 @@ namespace detail {
       return state->MakeBuffer();
     }
 
+    /// Pop a Buffer of @a size bytes from the pool of the stream, reusing the
+    /// memory of a previous message of similar size if available.
+    Buffer MakeBuffer(size_t size) {
+      auto state = _shared_state;
+      return state->MakeBuffer(size);
+    }
+
     /// Flush @a buffers down the stream. No copies are made.
     template <typename... Buffers>
     void Write(Buffers &&... buffers) {
@@ -67,6 +75,20 @@ namespace detail {
       return _shared_state ? _shared_state->AreClientsListening() : false;
     }
 
+    /// Counters of the messages sent and dropped by the sessions subscribed to
+    /// this stream.
+    auto GetStatistics()
+    {
+      return _shared_state ? _shared_state->GetStatistics() : decltype(_shared_state->GetStatistics()){};
+    }
+
+    /// Set the policy of the send queues of the sessions subscribed to this
+    /// stream, overriding the server's policy.
+    void SetSendQueuePolicy(tcp::SendQueuePolicy policy)
+    {
+      _shared_state->SetSendQueuePolicy(policy);
+    }
+
   private:
 
     friend class detail::Dispatcher;
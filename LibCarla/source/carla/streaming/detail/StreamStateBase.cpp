@@ -8,13 +8,19 @@
 
 #include "carla/BufferPool.h"
 
+#include <string>
+
 namespace carla {
 namespace streaming {
 namespace detail {
 
   StreamStateBase::StreamStateBase(const token_type &token)
     : _token(token),
-      _buffer_pool(std::make_shared<BufferPool>()) {}
+      _buffer_pool(std::make_shared<BufferPool>(
+          "stream." + std::to_string(token.get_stream_id()))) {
+    // sensor streams carry images of several megabytes
+    _buffer_pool->SetHugePages(true);
+  }
 
   StreamStateBase::~StreamStateBase() = default;
 
@@ -23,6 +29,11 @@ namespace detail {
     return pool->Pop();
   }
 
+  Buffer StreamStateBase::MakeBuffer(const size_t size) {
+    auto pool = _buffer_pool;
+    return pool->Pop(size);
+  }
+
 } // namespace detail
 } // namespace streaming
 } // namespace carla
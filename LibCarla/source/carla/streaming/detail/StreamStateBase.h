@@ -32,8 +32,16 @@ namespace detail {
       return _token;
     }
 
+    /// Set whether the token advertises the shared memory transport. Should
+    /// only be called before the token is handed to any client.
+    void SetSharedMemory(bool enabled) {
+      _token.set_shared_memory(enabled);
+    }
+
     Buffer MakeBuffer();
 
+    Buffer MakeBuffer(size_t size);
+
     virtual void ConnectSession(std::shared_ptr<Session> session) = 0;
 
     virtual void DisconnectSession(std::shared_ptr<Session> session) = 0;
@@ -42,7 +50,7 @@ namespace detail {
 
   private:
 
-    const token_type _token;
+    token_type _token;
 
     const std::shared_ptr<BufferPool> _buffer_pool;
   };
@@ -29,7 +29,10 @@ namespace detail {
     enum class protocol : uint8_t {
       not_set,
       tcp,
-      udp
+      udp,
+      /// TCP stream that can be read through shared memory by clients on the
+      /// same host.
+      tcp_shared_memory
     } protocol = protocol::not_set;
 
     enum class address : uint8_t {
@@ -74,7 +77,7 @@ namespace detail {
     template <typename P>
     boost::asio::ip::basic_endpoint<P> get_endpoint() const {
       DEBUG_ASSERT(is_valid());
-      DEBUG_ASSERT(get_protocol<P>() == _token.protocol);
+      DEBUG_ASSERT(has_same_protocol(boost::asio::ip::basic_endpoint<P>{}));
       return {get_address(), _token.port};
     }
 
@@ -152,12 +155,28 @@ namespace detail {
     }
 
     bool protocol_is_tcp() const {
-      return _token.protocol == token_data::protocol::tcp;
+      return _token.protocol == token_data::protocol::tcp ||
+             _token.protocol == token_data::protocol::tcp_shared_memory;
+    }
+
+    /// Whether the server offers this stream through shared memory to the
+    /// clients on the same host.
+    bool has_shared_memory() const {
+      return _token.protocol == token_data::protocol::tcp_shared_memory;
+    }
+
+    void set_shared_memory(bool enabled) {
+      DEBUG_ASSERT(protocol_is_tcp());
+      _token.protocol = enabled ?
+          token_data::protocol::tcp_shared_memory :
+          token_data::protocol::tcp;
     }
 
     template <typename Protocol>
     bool has_same_protocol(const boost::asio::ip::basic_endpoint<Protocol> &) const {
-      return _token.protocol == get_protocol<Protocol>();
+      return get_protocol<Protocol>() == token_data::protocol::tcp ?
+          protocol_is_tcp() :
+          _token.protocol == get_protocol<Protocol>();
     }
 
     boost::asio::ip::udp::endpoint to_udp_endpoint() const {
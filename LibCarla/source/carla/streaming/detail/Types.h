@@ -19,6 +19,10 @@ namespace detail {
 
   using message_size_type = uint32_t;
 
+  /// Set by the clients in the stream id they send when subscribing to
+  /// request the data of the stream through shared memory.
+  static constexpr stream_id_type shared_memory_request_flag = 1u << 31u;
+
   static_assert(
       std::is_same<message_size_type, Buffer::size_type>::value,
       "uint type mismatch!");
@@ -18,6 +18,7 @@
 #include <boost/asio/post.hpp>
 #include <boost/asio/bind_executor.hpp>
 
+#include <cstring>
 #include <exception>
 
 namespace carla {
@@ -30,11 +31,11 @@ namespace tcp {
   // ===========================================================================
 
   /// Helper for reading incoming TCP messages. Allocates the whole message in
-  /// a single buffer.
+  /// a single buffer, popped from the pool once the size is known.
   class IncomingMessage {
   public:
 
-    explicit IncomingMessage(Buffer &&buffer) : _message(std::move(buffer)) {}
+    explicit IncomingMessage(std::shared_ptr<BufferPool> pool) : _pool(std::move(pool)) {}
 
     boost::asio::mutable_buffer size_as_buffer() {
       return boost::asio::buffer(&_size, sizeof(_size));
@@ -42,7 +43,7 @@ namespace tcp {
 
     boost::asio::mutable_buffer buffer() {
       DEBUG_ASSERT(_size > 0u);
-      _message.reset(_size);
+      _message = _pool->Pop(_size);
       return _message.buffer();
     }
 
@@ -56,6 +57,8 @@ namespace tcp {
 
   private:
 
+    const std::shared_ptr<BufferPool> _pool;
+
     message_size_type _size = 0u;
 
     Buffer _message;
@@ -76,13 +79,18 @@ namespace tcp {
       _socket(io_context),
       _strand(io_context),
       _connection_timer(io_context),
-      _buffer_pool(std::make_shared<BufferPool>()) {
+      _buffer_pool(std::make_shared<BufferPool>(
+          "tcp_client." + std::to_string(token.get_stream_id()))) {
     if (!_token.protocol_is_tcp()) {
       throw_exception(std::invalid_argument("invalid token, only TCP tokens supported"));
     }
+    // the messages received are sensor data, often images of several megabytes
+    _buffer_pool->SetHugePages(true);
   }
 
-  Client::~Client() = default;
+  Client::~Client() {
+    StopReadingSharedMemory();
+  }
 
   void Client::Connect() {
     auto self = shared_from_this();
@@ -93,6 +101,8 @@ namespace tcp {
 
       using boost::system::error_code;
 
+      StopReadingSharedMemory();
+
       if (_socket.is_open()) {
         _socket.close();
       }
@@ -111,20 +121,31 @@ namespace tcp {
           _socket.set_option(boost::asio::ip::tcp::no_delay(true));
           log_debug("streaming client: connected to", ep);
           // Send the stream id to subscribe to the stream.
-          const auto &stream_id = _token.get_stream_id();
-          log_debug("streaming client: sending stream id", stream_id);
+          const bool use_shared_memory =
+              _token.has_shared_memory() &&
+              SharedMemoryRing::IsSupported() &&
+              !_shared_memory_failed;
+          _subscription_id = _token.get_stream_id();
+          if (use_shared_memory) {
+            _subscription_id |= shared_memory_request_flag;
+          }
+          log_debug("streaming client: sending stream id", _token.get_stream_id());
           boost::asio::async_write(
               _socket,
-              boost::asio::buffer(&stream_id, sizeof(stream_id)),
+              boost::asio::buffer(&_subscription_id, sizeof(_subscription_id)),
               boost::asio::bind_executor(_strand, [=](error_code ec, size_t DEBUG_ONLY(bytes)) {
                 // Ensures to stop the execution once the connection has been stopped.
                 if (_done) {
                   return;
                 }
                 if (!ec) {
-                  DEBUG_ASSERT_EQ(bytes, sizeof(stream_id));
+                  DEBUG_ASSERT_EQ(bytes, sizeof(_subscription_id));
                   // If succeeded start reading data.
-                  ReadData();
+                  if (use_shared_memory) {
+                    ReadSharedMemoryKey();
+                  } else {
+                    ReadData();
+                  }
                 } else {
                   // Else try again.
                   log_debug("streaming client: failed to send stream id:", ec.message());
@@ -147,6 +168,7 @@ namespace tcp {
     auto self = shared_from_this();
     boost::asio::post(_strand, [this, self]() {
       _done = true;
+      StopReadingSharedMemory();
       if (_socket.is_open()) {
         _socket.close();
       }
@@ -172,7 +194,7 @@ namespace tcp {
 
       // log_debug("streaming client: Client::ReadData");
 
-      auto message = std::make_shared<IncomingMessage>(_buffer_pool->Pop());
+      auto message = std::make_shared<IncomingMessage>(_buffer_pool);
 
       auto handle_read_data = [this, self, message](boost::system::error_code ec, size_t DEBUG_ONLY(bytes)) {
         DEBUG_ONLY(log_debug("streaming client: Client::ReadData.handle_read_data", bytes, "bytes"));
@@ -222,6 +244,95 @@ namespace tcp {
     });
   }
 
+  void Client::ReadSharedMemoryKey() {
+    auto self = shared_from_this();
+    auto handle_read = [this, self](boost::system::error_code ec, size_t DEBUG_ONLY(bytes)) {
+      if (_done) {
+        return;
+      }
+      message_size_type size;
+      std::memcpy(&size, _shared_memory_reply.data(), sizeof(size));
+      if (ec || (size != sizeof(SharedMemoryRing::key_type))) {
+        log_debug("streaming client: failed to read shared memory key:", ec.message());
+        Connect();
+        return;
+      }
+      DEBUG_ASSERT_EQ(bytes, _shared_memory_reply.size());
+      SharedMemoryRing::key_type key;
+      std::memcpy(&key, _shared_memory_reply.data() + sizeof(size), sizeof(key));
+      if (key == 0u) {
+        // The server has the shared memory disabled, keep using the socket.
+        ReadData();
+        return;
+      }
+      _shared_memory = SharedMemoryRing::Open(key);
+      if (_shared_memory == nullptr) {
+        log_info("streaming client: shared memory not available, using TCP for stream", _token.get_stream_id());
+        _shared_memory_failed = true;
+        Connect();
+        return;
+      }
+      log_debug("streaming client: reading stream", _token.get_stream_id(), "from shared memory");
+      StartReadingSharedMemory();
+      WaitForDisconnection();
+    };
+
+    boost::asio::async_read(
+        _socket,
+        boost::asio::buffer(_shared_memory_reply),
+        boost::asio::bind_executor(_strand, handle_read));
+  }
+
+  void Client::StartReadingSharedMemory() {
+    DEBUG_ASSERT(_shared_memory != nullptr);
+    DEBUG_ASSERT(!_shared_memory_reader.joinable());
+    _stop_reading = false;
+    std::weak_ptr<Client> weak = shared_from_this();
+    _shared_memory_reader = std::thread([this, weak]() {
+      while (!_stop_reading) {
+        auto buffer = std::make_shared<Buffer>(_buffer_pool->Pop());
+        if (_shared_memory->Read(*buffer, time_duration::milliseconds(100u))) {
+          boost::asio::post(_strand, [weak, buffer]() {
+            auto self = weak.lock();
+            if (self != nullptr) {
+              self->_callback(std::move(*buffer));
+            }
+          });
+        } else if (_shared_memory->IsClosed()) {
+          // The session is over, the socket notices it too and reconnects.
+          break;
+        }
+      }
+    });
+  }
+
+  void Client::StopReadingSharedMemory() {
+    if (_shared_memory_reader.joinable()) {
+      _stop_reading = true;
+      _shared_memory->Interrupt();
+      _shared_memory_reader.join();
+    }
+    _shared_memory.reset();
+  }
+
+  void Client::WaitForDisconnection() {
+    auto self = shared_from_this();
+    auto handle_read = [this, self](boost::system::error_code ec, size_t) {
+      if (_done) {
+        return;
+      }
+      if (!ec) {
+        WaitForDisconnection();
+      } else {
+        log_debug("streaming client: shared memory session closed:", ec.message());
+        Connect();
+      }
+    };
+    _socket.async_read_some(
+        boost::asio::buffer(&_disconnection_probe, sizeof(_disconnection_probe)),
+        boost::asio::bind_executor(_strand, handle_read));
+  }
+
 } // namespace tcp
 } // namespace detail
 } // namespace streaming
@@ -9,6 +9,7 @@
 #include "carla/Buffer.h"
 #include "carla/NonCopyable.h"
 #include "carla/profiler/LifetimeProfiled.h"
+#include "carla/streaming/detail/SharedMemoryRing.h"
 #include "carla/streaming/detail/Token.h"
 #include "carla/streaming/detail/Types.h"
 
@@ -17,9 +18,11 @@
 #include <boost/asio/ip/tcp.hpp>
 #include <boost/asio/strand.hpp>
 
+#include <array>
 #include <atomic>
 #include <functional>
 #include <memory>
+#include <thread>
 
 namespace carla {
 
@@ -31,6 +34,11 @@ namespace tcp {
 
   /// A client that connects to a single stream.
   ///
+  /// If the token says the stream is available through shared memory, the
+  /// client asks for it when subscribing and reads the data from the ring in a
+  /// dedicated thread. If the ring cannot be opened, because the server is on
+  /// a different host, it reconnects and reads from the socket instead.
+  ///
   /// @warning This client should be stopped before releasing the shared pointer
   /// or won't be destroyed.
   class Client
@@ -64,8 +72,19 @@ namespace tcp {
 
     void ReadData();
 
+    void ReadSharedMemoryKey();
+
+    void StartReadingSharedMemory();
+
+    void StopReadingSharedMemory();
+
+    void WaitForDisconnection();
+
     const token_type _token;
 
+    /// Stream id sent to the server, with the shared memory flag if requested.
+    stream_id_type _subscription_id;
+
     callback_function_type _callback;
 
     boost::asio::ip::tcp::socket _socket;
@@ -77,6 +96,18 @@ namespace tcp {
     std::shared_ptr<BufferPool> _buffer_pool;
 
     std::atomic_bool _done{false};
+
+    bool _shared_memory_failed = false;
+
+    std::unique_ptr<SharedMemoryRing> _shared_memory;
+
+    std::thread _shared_memory_reader;
+
+    std::atomic_bool _stop_reading{false};
+
+    std::array<unsigned char, sizeof(message_size_type) + sizeof(SharedMemoryRing::key_type)> _shared_memory_reply;
+
+    unsigned char _disconnection_probe;
   };
 
 } // namespace tcp
@@ -0,0 +1,106 @@
+// Copyright (c) 2023 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "carla/streaming/detail/tcp/SendQueue.h"
+
+#include "carla/Debug.h"
+#include "carla/Logging.h"
+
+namespace carla {
+namespace streaming {
+namespace detail {
+namespace tcp {
+
+  bool SendQueue::Push(
+      value_type message,
+      const SendQueuePolicy policy,
+      const size_t capacity,
+      const clock_type::time_point deadline) {
+    DEBUG_ASSERT(message != nullptr);
+    std::unique_lock<std::mutex> lock(_mutex);
+    if (_is_closed) {
+      return false;
+    }
+    const size_t max_depth = std::max<size_t>(capacity, 1u);
+    switch (policy) {
+      case SendQueuePolicy::LatestOnly:
+        while (!_queue.empty()) {
+          DropOldest();
+        }
+        break;
+      case SendQueuePolicy::DropOldest:
+        while (_queue.size() >= max_depth) {
+          DropOldest();
+        }
+        break;
+      case SendQueuePolicy::Block:
+        if (!_room_available.wait_until(lock, deadline, [&]() {
+              return _is_closed || _queue.size() < max_depth;
+            })) {
+          log_debug("send queue: connection too slow, message discarded");
+          while (_queue.size() >= max_depth) {
+            DropOldest();
+          }
+        }
+        if (_is_closed) {
+          return false;
+        }
+        break;
+    }
+    _queue.emplace_back(std::move(message));
+    _statistics.queue_depth = _queue.size();
+    _statistics.max_queue_depth = std::max(_statistics.max_queue_depth, _queue.size());
+    if (_is_writing) {
+      return false;
+    }
+    _is_writing = true;
+    return true;
+  }
+
+  bool SendQueue::Pop(std::vector<value_type> &batch, const size_t max_messages) {
+    batch.clear();
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      DEBUG_ASSERT(_is_writing);
+      while (!_queue.empty() && batch.size() < max_messages) {
+        batch.emplace_back(std::move(_queue.front()));
+        _queue.pop_front();
+      }
+      _statistics.messages_sent += batch.size();
+      _statistics.queue_depth = _queue.size();
+      if (batch.empty()) {
+        _is_writing = false;
+        return false;
+      }
+    }
+    _room_available.notify_all();
+    return true;
+  }
+
+  void SendQueue::Close() {
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _is_closed = true;
+      _queue.clear();
+      _statistics.queue_depth = 0u;
+    }
+    _room_available.notify_all();
+  }
+
+  SendQueueStatistics SendQueue::GetStatistics() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _statistics;
+  }
+
+  void SendQueue::DropOldest() {
+    _queue.pop_front();
+    ++_statistics.messages_dropped;
+  }
+
+} // namespace tcp
+} // namespace detail
+} // namespace streaming
+} // namespace carla
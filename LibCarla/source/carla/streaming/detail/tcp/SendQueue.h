@@ -0,0 +1,113 @@
+// Copyright (c) 2023 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/NonCopyable.h"
+#include "carla/Time.h"
+#include "carla/streaming/detail/tcp/Message.h"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace carla {
+namespace streaming {
+namespace detail {
+namespace tcp {
+
+  /// What a session does with a new message while its send queue is full.
+  enum class SendQueuePolicy : uint8_t {
+    /// Only the most recent pending message is kept.
+    LatestOnly,
+    /// The oldest pending message is discarded.
+    DropOldest,
+    /// The caller waits until there is room in the queue.
+    Block
+  };
+
+  /// Counters of the messages that went through one or more send queues.
+  struct SendQueueStatistics {
+    uint64_t messages_sent = 0u;
+    uint64_t messages_dropped = 0u;
+    /// Messages currently waiting to be sent.
+    size_t queue_depth = 0u;
+    /// Maximum number of messages that have been waiting at once.
+    size_t max_queue_depth = 0u;
+
+    SendQueueStatistics &operator+=(const SendQueueStatistics &rhs) {
+      messages_sent += rhs.messages_sent;
+      messages_dropped += rhs.messages_dropped;
+      queue_depth += rhs.queue_depth;
+      max_queue_depth = std::max(max_queue_depth, rhs.max_queue_depth);
+      return *this;
+    }
+  };
+
+  /// Bounded queue of the messages pending to be written to a session's
+  /// socket. Any thread may push, a single writer pops batches of messages to
+  /// send them in a single gather write.
+  class SendQueue : private NonCopyable {
+  public:
+
+    using value_type = std::shared_ptr<const Message>;
+
+    using clock_type = std::chrono::steady_clock;
+
+    /// Queues @a message applying @a policy if the queue already holds
+    /// @a capacity messages. With SendQueuePolicy::Block the caller waits until
+    /// @a deadline and then drops the oldest message. Returns true if nobody is
+    /// writing, in which case the caller becomes the writer and must pop.
+    bool Push(
+        value_type message,
+        SendQueuePolicy policy,
+        size_t capacity,
+        clock_type::time_point deadline);
+
+    bool Push(
+        value_type message,
+        SendQueuePolicy policy,
+        size_t capacity,
+        time_duration timeout) {
+      return Push(std::move(message), policy, capacity, clock_type::now() + timeout.to_chrono());
+    }
+
+    /// Moves to @a batch up to @a max_messages pending messages. If there are
+    /// none the writer is released and returns false.
+    bool Pop(std::vector<value_type> &batch, size_t max_messages);
+
+    /// Discards the pending messages and wakes up any blocked caller, further
+    /// messages are ignored.
+    void Close();
+
+    SendQueueStatistics GetStatistics() const;
+
+  private:
+
+    void DropOldest();
+
+    mutable std::mutex _mutex;
+
+    std::condition_variable _room_available;
+
+    std::deque<value_type> _queue;
+
+    bool _is_writing = false;
+
+    bool _is_closed = false;
+
+    SendQueueStatistics _statistics;
+  };
+
+} // namespace tcp
+} // namespace detail
+} // namespace streaming
+} // namespace carla
@@ -62,6 +62,36 @@ namespace tcp {
       return _synchronous;
     }
 
+    /// Set what the sessions do when more than @a capacity messages are
+    /// waiting to be sent. By default the sessions block the caller in
+    /// synchronous mode and keep only the latest message otherwise.
+    void SetSendQueuePolicy(SendQueuePolicy policy, size_t capacity) {
+      _send_queue_policy = policy;
+      _send_queue_capacity = capacity;
+      _has_send_queue_policy = true;
+    }
+
+    SendQueuePolicy GetSendQueuePolicy() const {
+      if (_has_send_queue_policy) {
+        return _send_queue_policy;
+      }
+      return _synchronous ? SendQueuePolicy::Block : SendQueuePolicy::LatestOnly;
+    }
+
+    size_t GetSendQueueCapacity() const {
+      return _send_queue_capacity;
+    }
+
+    /// Size in bytes of the shared memory ring created for each session of a
+    /// client on the same host, zero disables the shared memory transport.
+    void SetSharedMemoryCapacity(size_t capacity) {
+      _shared_memory_capacity = capacity;
+    }
+
+    size_t GetSharedMemoryCapacity() const {
+      return _shared_memory_capacity;
+    }
+
   private:
 
     void OpenSession(
@@ -76,6 +106,14 @@ namespace tcp {
     std::atomic<time_duration> _timeout;
 
     bool _synchronous;
+
+    std::atomic_bool _has_send_queue_policy{false};
+
+    std::atomic<SendQueuePolicy> _send_queue_policy{SendQueuePolicy::LatestOnly};
+
+    std::atomic_size_t _send_queue_capacity{4u};
+
+    std::atomic_size_t _shared_memory_capacity{0u};
   };
 
 } // namespace tcp
@@ -16,7 +16,7 @@
 #include <boost/asio/post.hpp>
 
 #include <atomic>
-#include <thread>
+#include <cstring>
 
 namespace carla {
 namespace streaming {
@@ -36,7 +36,8 @@ namespace tcp {
       _socket(io_context),
       _timeout(timeout),
       _deadline(io_context),
-      _strand(io_context) {}
+      _strand(io_context),
+      _shared_memory_timer(io_context) {}
 
   void ServerSession::Open(
       callback_function_type on_opened,
@@ -58,6 +59,11 @@ namespace tcp {
           size_t DEBUG_ONLY(bytes_received)) {
         if (!ec) {
           DEBUG_ASSERT_EQ(bytes_received, sizeof(_stream_id));
+          if ((_stream_id & shared_memory_request_flag) != 0u) {
+            _stream_id &= ~shared_memory_request_flag;
+            OpenSharedMemory(callback);
+            return;
+          }
           log_debug("session", _session_id, "for stream", _stream_id, " started");
           boost::asio::post(_strand.context(), [=]() { callback(self); });
         } else {
@@ -75,47 +81,159 @@ namespace tcp {
     });
   }
 
-  void ServerSession::Write(std::shared_ptr<const Message> message) {
+  void ServerSession::Write(
+      std::shared_ptr<const Message> message,
+      const SendQueue::clock_type::time_point deadline,
+      const boost::optional<SendQueuePolicy> policy) {
     DEBUG_ASSERT(message != nullptr);
     DEBUG_ASSERT(!message->empty());
+    const bool start_writing = _send_queue.Push(
+        std::move(message),
+        policy.get_value_or(_server.GetSendQueuePolicy()),
+        _server.GetSendQueueCapacity(),
+        deadline);
+    if (start_writing) {
+      boost::asio::post(_strand, [self=shared_from_this()]() { self->WritePending(); });
+    }
+  }
+
+  void ServerSession::OpenSharedMemory(callback_function_type on_opened) {
+    const auto capacity = _server.GetSharedMemoryCapacity();
+    if (capacity > 0u) {
+      _shared_memory = SharedMemoryRing::Create(capacity);
+    }
+    const SharedMemoryRing::key_type key = _shared_memory != nullptr ? _shared_memory->GetKey() : 0u;
+    const message_size_type size = sizeof(key);
+    std::memcpy(_shared_memory_reply.data(), &size, sizeof(size));
+    std::memcpy(_shared_memory_reply.data() + sizeof(size), &key, sizeof(key));
+
     auto self = shared_from_this();
-    boost::asio::post(_strand, [=]() {
-      if (!_socket.is_open()) {
-        return;
-      }
-      if (_is_writing) {
-        if (_server.IsSynchronousMode()) {
-          // wait until previous message has been sent
-          while (_is_writing) {
-            std::this_thread::yield();
-          }
+    auto handle_sent = [this, self, callback=std::move(on_opened)](
+        const boost::system::error_code &ec,
+        size_t DEBUG_ONLY(bytes)) {
+      if (!ec) {
+        DEBUG_ASSERT_EQ(bytes, _shared_memory_reply.size());
+        if (_shared_memory != nullptr) {
+          log_debug("session", _session_id, "for stream", _stream_id, " started through shared memory");
+          WaitForDisconnection();
         } else {
-          // ignore this message
-          log_debug("session", _session_id, ": connection too slow: message discarded");
-          return;
+          log_debug("session", _session_id, "for stream", _stream_id, " started");
         }
+        boost::asio::post(_strand.context(), [=]() { callback(self); });
+      } else {
+        log_error("session", _session_id, ": error sending shared memory key :", ec.message());
+        CloseNow(ec);
       }
-      _is_writing = true;
+    };
 
-      auto handle_sent = [this, self, message](const boost::system::error_code &ec, size_t DEBUG_ONLY(bytes)) {
-        _is_writing = false;
-        if (ec) {
-          log_info("session", _session_id, ": error sending data :", ec.message());
-          CloseNow(ec);
-        } else {
-          DEBUG_ONLY(log_debug("session", _session_id, ": successfully sent", bytes, "bytes"));
-          DEBUG_ASSERT_EQ(bytes, sizeof(message_size_type) + message->size());
+    boost::asio::async_write(
+        _socket,
+        boost::asio::buffer(_shared_memory_reply),
+        boost::asio::bind_executor(_strand, handle_sent));
+  }
+
+  void ServerSession::WaitForDisconnection() {
+    // The client does not send anything else, the read only completes when
+    // the connection is closed.
+    auto handle_read = [this, self=shared_from_this()](
+        const boost::system::error_code &ec,
+        size_t) {
+      if (!ec) {
+        WaitForDisconnection();
+      } else if (ec != boost::asio::error::operation_aborted) {
+        log_debug("session", _session_id, ": client disconnected :", ec.message());
+        CloseNow(ec);
+      }
+    };
+    _socket.async_read_some(
+        boost::asio::buffer(&_disconnection_probe, sizeof(_disconnection_probe)),
+        boost::asio::bind_executor(_strand, handle_read));
+  }
+
+  void ServerSession::WriteSharedMemory() {
+    DEBUG_ASSERT(_shared_memory != nullptr);
+    for (;;) {
+      if (_shared_memory->IsClosed()) {
+        _messages_in_flight.clear();
+        _send_queue.Close();
+        return;
+      }
+      if (_messages_in_flight.empty() &&
+          !_send_queue.Pop(_messages_in_flight, _server.GetSendQueueCapacity())) {
+        return;
+      }
+      auto it = _messages_in_flight.begin();
+      for (; it != _messages_in_flight.end(); ++it) {
+        const auto &message = **it;
+        if (sizeof(message_size_type) + message.size() > _shared_memory->GetCapacity()) {
+          log_warning("session", _session_id, ": message of", message.size(), "bytes does not fit in shared memory, discarded");
+        } else if (!_shared_memory->TryWrite(message.GetBufferSequence())) {
+          break;
         }
-      };
+      }
+      if (it != _messages_in_flight.begin()) {
+        _deadline.expires_from_now(_timeout);
+      }
+      _messages_in_flight.erase(_messages_in_flight.begin(), it);
+      if (!_messages_in_flight.empty()) {
+        // The client is behind, wait for it to make room. Meanwhile the send
+        // queue applies its policy to the new messages.
+        _shared_memory_timer.expires_from_now(boost::posix_time::milliseconds(1));
+        _shared_memory_timer.async_wait(boost::asio::bind_executor(
+            _strand,
+            [this, self=shared_from_this()](boost::system::error_code ec) {
+              if (!ec) {
+                WriteSharedMemory();
+              }
+            }));
+        return;
+      }
+    }
+  }
 
-      log_debug("session", _session_id, ": sending message of", message->size(), "bytes");
+  void ServerSession::WritePending() {
+    if (_shared_memory != nullptr) {
+      WriteSharedMemory();
+      return;
+    }
+    if (!_socket.is_open()) {
+      _send_queue.Close();
+      return;
+    }
+    if (!_send_queue.Pop(_messages_in_flight, _server.GetSendQueueCapacity())) {
+      return;
+    }
 
-      _deadline.expires_from_now(_timeout);
-      boost::asio::async_write(
-          _socket,
-          message->GetBufferSequence(),
-          handle_sent);
-    });
+    _buffers_in_flight.clear();
+    size_t total_size = 0u;
+    for (const auto &message : _messages_in_flight) {
+      for (const auto &buffer : message->GetBufferSequence()) {
+        _buffers_in_flight.emplace_back(buffer);
+      }
+      total_size += sizeof(message_size_type) + message->size();
+    }
+
+    auto handle_sent = [this, self=shared_from_this()](
+        const boost::system::error_code &ec,
+        size_t DEBUG_ONLY(bytes)) {
+      _messages_in_flight.clear();
+      if (ec) {
+        log_info("session", _session_id, ": error sending data :", ec.message());
+        _send_queue.Close();
+        CloseNow(ec);
+      } else {
+        DEBUG_ONLY(log_debug("session", _session_id, ": successfully sent", bytes, "bytes"));
+        WritePending();
+      }
+    };
+
+    log_debug("session", _session_id, ": sending", _messages_in_flight.size(), "messages of", total_size, "bytes");
+
+    _deadline.expires_from_now(_timeout);
+    boost::asio::async_write(
+        _socket,
+        _buffers_in_flight,
+        boost::asio::bind_executor(_strand, handle_sent));
   }
 
   void ServerSession::Close() {
@@ -139,6 +257,11 @@ namespace tcp {
 
   void ServerSession::CloseNow(boost::system::error_code ec) {
     _deadline.cancel();
+    _send_queue.Close();
+    if (_shared_memory != nullptr) {
+      _shared_memory_timer.cancel();
+      _shared_memory->Close();
+    }
     if (!ec)
     {
       if (_socket.is_open()) {
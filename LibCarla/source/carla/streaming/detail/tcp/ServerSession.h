@@ -10,8 +10,10 @@
 #include "carla/Time.h"
 #include "carla/TypeTraits.h"
 #include "carla/profiler/LifetimeProfiled.h"
+#include "carla/streaming/detail/SharedMemoryRing.h"
 #include "carla/streaming/detail/Types.h"
 #include "carla/streaming/detail/tcp/Message.h"
+#include "carla/streaming/detail/tcp/SendQueue.h"
 
 #if defined(__clang__)
 #  pragma clang diagnostic push
@@ -21,12 +23,15 @@
 #include <boost/asio/io_context.hpp>
 #include <boost/asio/ip/tcp.hpp>
 #include <boost/asio/strand.hpp>
+#include <boost/optional.hpp>
 #if defined(__clang__)
 #  pragma clang diagnostic pop
 #endif
 
+#include <array>
 #include <functional>
 #include <memory>
+#include <vector>
 
 namespace carla {
 namespace streaming {
@@ -38,6 +43,10 @@ namespace tcp {
   /// A TCP server session. When a session opens, it reads from the socket a
   /// stream id object and passes itself to the callback functor. The session
   /// closes itself after @a timeout of inactivity is met.
+  ///
+  /// If the client requests it in the stream id, the session replies with the
+  /// key of a shared memory ring and writes the data there instead, the socket
+  /// is then only used to detect the client disconnecting.
   class ServerSession
     : public std::enable_shared_from_this<ServerSession>,
       private profiler::LifetimeProfiled,
@@ -72,8 +81,21 @@ namespace tcp {
       return std::make_shared<const Message>(buffers...);
     }
 
-    /// Writes some data to the socket.
-    void Write(std::shared_ptr<const Message> message);
+    /// Queues some data to be written to the socket. If the send queue is
+    /// full @a policy, or the server's send queue policy if not set, decides
+    /// which message is dropped, or whether the caller waits. The caller
+    /// waits at most until @a deadline, so a message written to several
+    /// sessions blocks for one timeout at most.
+    void Write(
+        std::shared_ptr<const Message> message,
+        SendQueue::clock_type::time_point deadline,
+        boost::optional<SendQueuePolicy> policy = boost::none);
+
+    /// Queues some data to be written to the socket, waiting at most the
+    /// session timeout if the send queue is full.
+    void Write(std::shared_ptr<const Message> message) {
+      Write(std::move(message), GetWriteDeadline());
+    }
 
     /// Writes some data to the socket.
     template <typename... Buffers>
@@ -84,8 +106,30 @@ namespace tcp {
     /// Post a job to close the session.
     void Close();
 
+    /// Latest time a write issued now may wait for room in the send queue.
+    SendQueue::clock_type::time_point GetWriteDeadline() const {
+      return SendQueue::clock_type::now() + _timeout.to_chrono();
+    }
+
+    SendQueueStatistics GetStatistics() const {
+      return _send_queue.GetStatistics();
+    }
+
   private:
 
+    /// Sends every pending message in a single write, must run in the strand.
+    void WritePending();
+
+    /// Creates the shared memory ring, if enabled, and sends its key to the
+    /// client. A zero key tells the client to keep reading from the socket.
+    void OpenSharedMemory(callback_function_type on_opened);
+
+    /// Copies the pending messages to the shared memory ring, retries later
+    /// if the ring is full. Must run in the strand.
+    void WriteSharedMemory();
+
+    void WaitForDisconnection();
+
     void StartTimer();
 
     void CloseNow(boost::system::error_code ec = boost::system::error_code());
@@ -108,7 +152,20 @@ namespace tcp {
 
     callback_function_type _on_closed;
 
-    bool _is_writing = false;
+    SendQueue _send_queue;
+
+    /// Messages being written, kept alive until the write completes.
+    std::vector<std::shared_ptr<const Message>> _messages_in_flight;
+
+    std::vector<boost::asio::const_buffer> _buffers_in_flight;
+
+    std::unique_ptr<SharedMemoryRing> _shared_memory;
+
+    boost::asio::deadline_timer _shared_memory_timer;
+
+    std::array<unsigned char, sizeof(message_size_type) + sizeof(SharedMemoryRing::key_type)> _shared_memory_reply;
+
+    unsigned char _disconnection_probe;
   };
 
 } // namespace tcp
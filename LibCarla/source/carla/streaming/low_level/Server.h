@@ -7,7 +7,9 @@
 #pragma once
 
 #include "carla/streaming/detail/Dispatcher.h"
+#include "carla/streaming/detail/SharedMemoryRing.h"
 #include "carla/streaming/detail/Types.h"
+#include "carla/streaming/detail/tcp/SendQueue.h"
 #include "carla/streaming/Stream.h"
 
 #include <boost/asio/io_context.hpp>
@@ -77,6 +79,21 @@ namespace low_level {
       _server.SetSynchronousMode(is_synchro);
     }
 
+    void SetSendQueuePolicy(detail::tcp::SendQueuePolicy policy, size_t capacity) {
+      _server.SetSendQueuePolicy(policy, capacity);
+    }
+
+    /// Offer the streams through a shared memory ring of @a capacity bytes
+    /// per session to the clients on the same host, zero disables it.
+    ///
+    /// @warning Clients without support for it cannot subscribe to the
+    /// streams while enabled.
+    void SetSharedMemoryCapacity(size_t capacity) {
+      const bool enabled = (capacity > 0u) && detail::SharedMemoryRing::IsSupported();
+      _server.SetSharedMemoryCapacity(enabled ? capacity : 0u);
+      _dispatcher.SetSharedMemory(enabled);
+    }
+
     token_type GetToken(stream_id sensor_id) {
       return _dispatcher.GetToken(sensor_id);
     }
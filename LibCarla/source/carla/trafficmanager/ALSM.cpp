@@ -1,9 +1,11 @@
 
+#include <algorithm>
+#include <iterator>
+
 #include "boost/pointer_cast.hpp"
 
 #include "carla/client/Actor.h"
 #include "carla/client/Vehicle.h"
-#include "carla/client/Walker.h"
 
 #include "carla/trafficmanager/Constants.h"
 #include "carla/trafficmanager/LocalizationUtils.h"
@@ -46,45 +48,28 @@ void ALSM::Update() {
 
   bool hybrid_physics_mode = parameters.GetHybridPhysicsMode();
 
-  std::set<ActorId> world_vehicle_ids;
-  std::set<ActorId> world_pedestrian_ids;
-  std::vector<ActorId> unregistered_list_to_be_deleted;
-
-  current_timestamp = world.GetSnapshot().GetTimestamp();
-  ActorList world_actors = world.GetActors();
-
-  // Find destroyed actors and perform clean up.
-  const ALSM::DestroyeddActors destroyed_actors = IdentifyDestroyedActors(world_actors);
+  const cc::WorldSnapshot world_snapshot = world.GetSnapshot();
+  current_timestamp = world_snapshot.GetTimestamp();
 
-  const ActorIdSet &destroyed_registered = destroyed_actors.first;
-  for (const auto &deletion_id: destroyed_registered) {
-    RemoveActor(deletion_id, true);
-  }
+  // Find the actors spawned and destroyed since the last update.
+  std::vector<ActorId> spawned_actors;
+  std::vector<ActorId> destroyed_actors;
+  IdentifyActorChanges(world_snapshot, spawned_actors, destroyed_actors);
 
-  const ActorIdSet &destroyed_unregistered = destroyed_actors.second;
-  for (auto deletion_id : destroyed_unregistered) {
-    RemoveActor(deletion_id, false);
+  // Perform clean up of destroyed actors, invalidating them as hero actors too.
+  for (const ActorId deletion_id : destroyed_actors) {
+    RemoveActor(deletion_id, registered_vehicles.Contains(deletion_id));
+    hero_actors.erase(deletion_id);
   }
 
-  // Invalidate hero actor if it is not alive anymore.
-  if (hero_actors.size() != 0u) {
-    ActorIdSet hero_actors_to_delete;
-    for (auto &hero_actor_info: hero_actors) {
-      if (destroyed_unregistered.find(hero_actor_info.first) != destroyed_unregistered.end()) {
-        hero_actors_to_delete.insert(hero_actor_info.first);
-      }
-      if (destroyed_registered.find(hero_actor_info.first) != destroyed_registered.end()) {
-        hero_actors_to_delete.insert(hero_actor_info.first);
-      }
-    }
-
-    for (auto &deletion_id: hero_actors_to_delete) {
-      hero_actors.erase(deletion_id);
-    }
+  // Vehicles unregistered from the traffic manager are tracked again as new actors.
+  if (registered_vehicles.GetState() != registered_vehicles_state) {
+    std::vector<ActorId> released_vehicles = UpdateRegistrations(world_snapshot);
+    spawned_actors.insert(spawned_actors.end(), released_vehicles.begin(), released_vehicles.end());
   }
 
-  // Scan for new unregistered actors.
-  IdentifyNewActors(world_actors);
+  // Scan new unregistered actors.
+  IdentifyNewActors(spawned_actors);
 
   // Update dynamic state and static attributes for all registered vehicles.
   ALSM::IdleInfo max_idle_time = std::make_pair(0u, current_timestamp.elapsed_seconds);
@@ -108,62 +93,89 @@ void ALSM::Update() {
     marked_for_removal.clear();
   }
 
-  // Update dynamic state and static attributes for unregistered actors.
-  UpdateUnregisteredActorsData();
+  // Update dynamic state for unregistered actors.
+  UpdateUnregisteredActorsData(world_snapshot);
 }
 
-void ALSM::IdentifyNewActors(const ActorList &actor_list) {
-  for (auto iter = actor_list->begin(); iter != actor_list->end(); ++iter) {
-    ActorPtr actor = *iter;
-    ActorId actor_id = actor->GetId();
-    // Identify any new hero vehicle
-    if (actor->GetTypeId().front() == 'v') {
-     if (hero_actors.size() == 0u || hero_actors.find(actor_id) == hero_actors.end()) {
-      for (auto&& attribute: actor->GetAttributes()) {
-        if (attribute.GetId() == "role_name" && attribute.GetValue() == "hero") {
-          hero_actors.insert({actor_id, actor});
-        }
-      }
-    }
-  }
-    if (!registered_vehicles.Contains(actor_id)
-        && unregistered_actors.find(actor_id) == unregistered_actors.end()) {
-
-      unregistered_actors.insert({actor_id, actor});
+void ALSM::IdentifyActorChanges(const cc::WorldSnapshot &world_snapshot,
+                                std::vector<ActorId> &spawned_actors,
+                                std::vector<ActorId> &destroyed_actors) {
+
+  // Most ticks no actor is spawned or destroyed, and the snapshots share their actors.
+  if (!previous_snapshot || !world_snapshot.HasSameActors(*previous_snapshot)) {
+    const auto current_ids = world_snapshot.GetActorIds();
+    if (!previous_snapshot) {
+      spawned_actors.assign(current_ids.begin(), current_ids.end());
+    } else {
+      // Both lists of ids are sorted.
+      const auto previous_ids = previous_snapshot->GetActorIds();
+      std::set_difference(current_ids.begin(), current_ids.end(),
+                          previous_ids.begin(), previous_ids.end(),
+                          std::back_inserter(spawned_actors));
+      std::set_difference(previous_ids.begin(), previous_ids.end(),
+                          current_ids.begin(), current_ids.end(),
+                          std::back_inserter(destroyed_actors));
     }
   }
+  previous_snapshot = world_snapshot;
 }
 
-ALSM::DestroyeddActors ALSM::IdentifyDestroyedActors(const ActorList &actor_list) {
+std::vector<ActorId> ALSM::UpdateRegistrations(const cc::WorldSnapshot &world_snapshot) {
 
-  ALSM::DestroyeddActors destroyed_actors;
-  ActorIdSet &deleted_registered = destroyed_actors.first;
-  ActorIdSet &deleted_unregistered = destroyed_actors.second;
+  // Read the state before the list, a registration in between is seen next update.
+  registered_vehicles_state = registered_vehicles.GetState();
+  const std::vector<ActorId> registered_ids = registered_vehicles.GetIDList();
 
-  // Building hash set of actors present in current frame.
-  ActorIdSet current_actors;
-  for  (auto iter = actor_list->begin(); iter != actor_list->end(); ++iter) {
-    current_actors.insert((*iter)->GetId());
+  ActorIdSet current_registered;
+  for (const ActorId actor_id : registered_ids) {
+    if (!world_snapshot.Contains(actor_id)) {
+      // Registered after being destroyed.
+      RemoveActor(actor_id, true);
+      hero_actors.erase(actor_id);
+      continue;
+    }
+    if (unregistered_actors.find(actor_id) != unregistered_actors.end()) {
+      RemoveActor(actor_id, false);
+    }
+    current_registered.insert(actor_id);
   }
 
-  // Searching for destroyed registered actors.
-  std::vector<ActorId> registered_ids = registered_vehicles.GetIDList();
-  for (const ActorId &actor_id : registered_ids) {
-    if (current_actors.find(actor_id) == current_actors.end()) {
-      deleted_registered.insert(actor_id);
+  std::vector<ActorId> released_vehicles;
+  for (const ActorId actor_id : known_registered_vehicles) {
+    if (current_registered.find(actor_id) == current_registered.end()
+        && world_snapshot.Contains(actor_id)) {
+      released_vehicles.push_back(actor_id);
     }
   }
+  known_registered_vehicles = std::move(current_registered);
+  return released_vehicles;
+}
 
-  // Searching for destroyed unregistered actors.
-  for (const auto &actor_info: unregistered_actors) {
-    const ActorId &actor_id = actor_info.first;
-     if (current_actors.find(actor_id) == current_actors.end()
-         || registered_vehicles.Contains(actor_id)) {
-      deleted_unregistered.insert(actor_id);
+void ALSM::IdentifyNewActors(const std::vector<ActorId> &actor_ids) {
+  if (actor_ids.empty()) {
+    return;
+  }
+  ActorList actor_list = world.GetActors(actor_ids);
+  for (auto iter = actor_list->begin(); iter != actor_list->end(); ++iter) {
+    ActorPtr actor = *iter;
+    ActorId actor_id = actor->GetId();
+    const char type = actor->GetTypeId().front();
+    // Identify any new hero vehicle
+    if (type == 'v') {
+      for (auto&& attribute: actor->GetAttributes()) {
+        if (attribute.GetId() == "role_name" && attribute.GetValue() == "hero") {
+          hero_actors.insert({actor_id, actor});
+        }
+      }
+    }
+    // Only vehicles and walkers are part of the traffic, the rest of the actors are ignored.
+    if ((type == 'v' || type == 'w')
+        && !registered_vehicles.Contains(actor_id)
+        && unregistered_actors.find(actor_id) == unregistered_actors.end()) {
+      const ActorType actor_type = type == 'v' ? ActorType::Vehicle : ActorType::Pedestrian;
+      unregistered_actors.insert({actor_id, UnregisteredActor{actor, actor_type, actor->GetBoundingBox().extent}});
     }
   }
-
-  return destroyed_actors;
 }
 
 void ALSM::UpdateRegisteredActorsData(const bool hybrid_physics_mode, ALSM::IdleInfo &max_idle_time) {
@@ -267,35 +279,37 @@ void ALSM::UpdateData(const bool hybrid_physics_mode, const Actor &vehicle,
 }
 
 
-void ALSM::UpdateUnregisteredActorsData() {
+void ALSM::UpdateUnregisteredActorsData(const cc::WorldSnapshot &world_snapshot) {
   for (auto &actor_info: unregistered_actors) {
 
     const ActorId actor_id = actor_info.first;
-    const ActorPtr actor_ptr = actor_info.second;
-    const std::string type_id = actor_ptr->GetTypeId();
-
-    const cg::Transform actor_transform = actor_ptr->GetTransform();
+    const UnregisteredActor &unregistered_actor = actor_info.second;
+    const ActorType actor_type = unregistered_actor.type;
+    const cg::Vector3D &dimensions = unregistered_actor.extent;
+
+    // The dynamic state is read from the snapshot of this update, destroyed actors were already removed.
+    const boost::optional<cc::ActorSnapshot> actor_snapshot = world_snapshot.Find(actor_id);
+    if (!actor_snapshot) {
+      continue;
+    }
+    const cg::Transform &actor_transform = actor_snapshot->transform;
     const cg::Location actor_location = actor_transform.location;
     const cg::Rotation actor_rotation = actor_transform.rotation;
-    const cg::Vector3D actor_velocity = actor_ptr->GetVelocity();
-    const bool actor_is_dormant = actor_ptr->IsDormant();
+    const cg::Vector3D actor_velocity = actor_snapshot->velocity;
+    const bool actor_is_dormant = actor_snapshot->actor_state == rpc::ActorState::Dormant;
     KinematicState kinematic_state {actor_location, actor_rotation, actor_velocity, -1.0f, true, actor_is_dormant, cg::Location()};
 
     TrafficLightState tl_state;
-    ActorType actor_type = ActorType::Any;
-    cg::Vector3D dimensions;
-    std::vector<SimpleWaypointPtr> nearest_waypoints;
+    std::vector<WaypointIndex> nearest_waypoints;
 
     bool state_entry_not_present = !simulation_state.ContainsActor(actor_id);
-    if (type_id.front() == 'v') {
-      auto vehicle_ptr = boost::static_pointer_cast<cc::Vehicle>(actor_ptr);
-      kinematic_state.speed_limit = vehicle_ptr->GetSpeedLimit();
+    if (actor_type == ActorType::Vehicle) {
+      const auto &vehicle_data = actor_snapshot->state.vehicle_data;
+      kinematic_state.speed_limit = vehicle_data.speed_limit;
 
-      tl_state = {vehicle_ptr->GetTrafficLightState(), vehicle_ptr->IsAtTrafficLight()};
+      tl_state = {vehicle_data.traffic_light_state, vehicle_data.has_traffic_light};
 
       if (state_entry_not_present) {
-        dimensions = vehicle_ptr->GetBoundingBox().extent;
-        actor_type = ActorType::Vehicle;
         StaticAttributes attributes {actor_type, dimensions.x, dimensions.y, dimensions.z};
 
         simulation_state.AddActor(actor_id, kinematic_state, attributes, tl_state);
@@ -305,22 +319,17 @@ void ALSM::UpdateUnregisteredActorsData() {
       }
 
       // Identify occupied waypoints.
-      cg::Vector3D extent = vehicle_ptr->GetBoundingBox().extent;
-      cg::Vector3D heading_vector = vehicle_ptr->GetTransform().GetForwardVector();
-      std::vector<cg::Location> corners = {actor_location + cg::Location(extent.x * heading_vector),
+      cg::Vector3D heading_vector = actor_transform.GetForwardVector();
+      std::vector<cg::Location> corners = {actor_location + cg::Location(dimensions.x * heading_vector),
                                            actor_location,
-                                           actor_location + cg::Location(-extent.x * heading_vector)};
+                                           actor_location + cg::Location(-dimensions.x * heading_vector)};
       for (cg::Location &vertex: corners) {
-        SimpleWaypointPtr nearest_waypoint = local_map->GetWaypoint(vertex);
+        WaypointIndex nearest_waypoint = local_map->GetWaypoint(vertex);
         nearest_waypoints.push_back(nearest_waypoint);
       }
     }
-    else if (type_id.front() == 'w') {
-      auto walker_ptr = boost::static_pointer_cast<cc::Walker>(actor_ptr);
-
+    else {
       if (state_entry_not_present) {
-        dimensions = walker_ptr->GetBoundingBox().extent;
-        actor_type = ActorType::Pedestrian;
         StaticAttributes attributes {actor_type, dimensions.x, dimensions.y, dimensions.z};
 
         simulation_state.AddActor(actor_id, kinematic_state, attributes, tl_state);
@@ -329,11 +338,11 @@ void ALSM::UpdateUnregisteredActorsData() {
       }
 
       // Identify occupied waypoints.
-      SimpleWaypointPtr nearest_waypoint = local_map->GetWaypoint(actor_location);
+      WaypointIndex nearest_waypoint = local_map->GetWaypoint(actor_location);
       nearest_waypoints.push_back(nearest_waypoint);
     }
 
-    track_traffic.UpdateUnregisteredGridPosition(actor_id, nearest_waypoints);
+    track_traffic.UpdateUnregisteredGridPosition(actor_id, nearest_waypoints, local_map->GetWaypointGraph());
   }
 }
 
@@ -377,7 +386,6 @@ void ALSM::RemoveActor(const ActorId actor_id, const bool registered_actor) {
   }
   else {
     unregistered_actors.erase(actor_id);
-    hero_actors.erase(actor_id);
   }
 
   track_traffic.DeleteActor(actor_id);
@@ -386,6 +394,9 @@ void ALSM::RemoveActor(const ActorId actor_id, const bool registered_actor) {
 
 void ALSM::Reset() {
   unregistered_actors.clear();
+  previous_snapshot.reset();
+  known_registered_vehicles.clear();
+  registered_vehicles_state = -1;
   idle_time.clear();
   hero_actors.clear();
   elapsed_last_actor_destruction = 0.0;
@@ -3,9 +3,12 @@
 
 #include <memory>
 
+#include <boost/optional.hpp>
+
 #include "carla/client/ActorList.h"
 #include "carla/client/Timestamp.h"
 #include "carla/client/World.h"
+#include "carla/client/WorldSnapshot.h"
 #include "carla/Memory.h"
 
 #include "carla/trafficmanager/AtomicActorSet.h"
@@ -35,6 +38,16 @@ using ActorMap = std::unordered_map<ActorId, ActorPtr>;
 using IdleTimeMap = std::unordered_map<ActorId, double>;
 using LocalMapPtr = std::shared_ptr<InMemoryMap>;
 
+/// Vehicle or walker not registered with the traffic manager, with the
+/// attributes that do not change during its life.
+struct UnregisteredActor {
+  ActorPtr actor;
+  ActorType type;
+  cg::Vector3D extent;
+};
+
+using UnregisteredActorMap = std::unordered_map<ActorId, UnregisteredActor>;
+
 /// ALSM: Agent Lifecycle and State Managerment
 /// This class has functionality to update the local cache of kinematic states
 /// and manage memory and cleanup for varying number of vehicles in the simulation.
@@ -42,8 +55,13 @@ class ALSM {
 
 private:
   AtomicActorSet &registered_vehicles;
-  // Structure containing vehicles in the simulator not registered with the traffic manager.
-  ActorMap unregistered_actors;
+  // Structure containing vehicles and walkers in the simulator not registered with the traffic manager.
+  UnregisteredActorMap unregistered_actors;
+  // Snapshot of the last update, to find the actors spawned and destroyed since then.
+  boost::optional<cc::WorldSnapshot> previous_snapshot;
+  // Registered vehicles as of the last update, and the state of the set at that time.
+  ActorIdSet known_registered_vehicles;
+  int registered_vehicles_state = -1;
   BufferMap &buffer_map;
   // Structure keeping track of duration of vehicles stuck in a location.
   IdleTimeMap idle_time;
@@ -72,13 +90,17 @@ private:
   // Method to determine if a vehicle is stuck at a place for too long.
   bool IsVehicleStuck(const ActorId& actor_id);
 
-  // Method to identify actors newly spawned in the simulation since last tick.
-  void IdentifyNewActors(const ActorList &actor_list);
+  // Method to identify actors spawned and destroyed in the simulation since last tick.
+  void IdentifyActorChanges(const cc::WorldSnapshot &world_snapshot,
+                            std::vector<ActorId> &spawned_actors,
+                            std::vector<ActorId> &destroyed_actors);
+
+  // Method to keep track of vehicles registered and unregistered since last tick.
+  // Vehicles unregistered that are still alive are returned to be tracked as new actors.
+  std::vector<ActorId> UpdateRegistrations(const cc::WorldSnapshot &world_snapshot);
 
-  using DestroyeddActors = std::pair<ActorIdSet, ActorIdSet>;
-  // Method to identify actors deleted in the last frame.
-  // Arrays of registered and unregistered actors are returned separately.
-  DestroyeddActors IdentifyDestroyedActors(const ActorList &actor_list);
+  // Method to start tracking the given actors, newly spawned or unregistered.
+  void IdentifyNewActors(const std::vector<ActorId> &actor_ids);
 
   using IdleInfo = std::pair<ActorId, double>;
   void UpdateRegisteredActorsData(const bool hybrid_physics_mode, IdleInfo &max_idle_time);
@@ -86,7 +108,7 @@ private:
   void UpdateData(const bool hybrid_physics_mode, const Actor &vehicle,
                   const bool hero_actor_present, const float physics_radius_square);
 
-  void UpdateUnregisteredActorsData();
+  void UpdateUnregisteredActorsData(const cc::WorldSnapshot &world_snapshot);
 
 public:
   ALSM(AtomicActorSet &registered_vehicles,
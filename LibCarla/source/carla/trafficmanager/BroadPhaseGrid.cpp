@@ -0,0 +1,118 @@
+// Copyright (c) 2023 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "carla/trafficmanager/BroadPhaseGrid.h"
+
+namespace carla {
+namespace traffic_manager {
+
+// Maximum number of cells per entry of the grid, and minimum number of cells
+// allowed whatever the number of entries.
+static constexpr int64_t MAX_CELLS_PER_ENTRY = 16;
+static constexpr int64_t MIN_MAX_CELLS = 4096;
+
+BroadPhaseGrid::BroadPhaseGrid(const float cell_size)
+  : cell_size(cell_size),
+    grid_cell_size(cell_size),
+    inv_cell_size(1.0f / cell_size) {}
+
+int64_t BroadPhaseGrid::GetCellCoordinate(const float value) const {
+  const float coordinate = std::floor(value * inv_cell_size);
+  const float limit = static_cast<float>(std::numeric_limits<int32_t>::max());
+  return static_cast<int64_t>(std::max(-limit, std::min(coordinate, limit)));
+}
+
+void BroadPhaseGrid::Build(const std::vector<cg::Location> &locations) {
+  Clear();
+  if (locations.empty()) {
+    return;
+  }
+
+  float min_location_x = locations.front().x;
+  float max_location_x = min_location_x;
+  float min_location_y = locations.front().y;
+  float max_location_y = min_location_y;
+  for (const cg::Location &location : locations) {
+    min_location_x = std::min(min_location_x, location.x);
+    max_location_x = std::max(max_location_x, location.x);
+    min_location_y = std::min(min_location_y, location.y);
+    max_location_y = std::max(max_location_y, location.y);
+  }
+
+  // Grow the cells until the grid is small enough.
+  const int64_t max_cells = std::max(MIN_MAX_CELLS,
+      MAX_CELLS_PER_ENTRY * static_cast<int64_t>(locations.size()));
+  grid_cell_size = cell_size;
+  for (;;) {
+    inv_cell_size = 1.0f / grid_cell_size;
+    min_x = GetCellCoordinate(min_location_x);
+    min_y = GetCellCoordinate(min_location_y);
+    width = GetCellCoordinate(max_location_x) - min_x + 1;
+    height = GetCellCoordinate(max_location_y) - min_y + 1;
+    if (width * height <= max_cells) {
+      break;
+    }
+    grid_cell_size *= 2.0f;
+  }
+
+  // Counting sort of the entries by cell.
+  cell_start.assign(static_cast<std::size_t>(width * height) + 1u, 0u);
+  entry_cells.resize(locations.size());
+  for (std::size_t index = 0u; index < locations.size(); ++index) {
+    const cg::Location &location = locations[index];
+    const int64_t x = GetCellCoordinate(location.x) - min_x;
+    const int64_t y = GetCellCoordinate(location.y) - min_y;
+    entry_cells[index] = static_cast<std::size_t>(y * width + x);
+    ++cell_start[entry_cells[index] + 1u];
+  }
+  for (std::size_t cell = 1u; cell < cell_start.size(); ++cell) {
+    cell_start[cell] += cell_start[cell - 1u];
+  }
+  entries.resize(locations.size());
+  std::vector<std::size_t> cell_end(cell_start.begin(), cell_start.end() - 1);
+  for (std::size_t index = 0u; index < locations.size(); ++index) {
+    entries[cell_end[entry_cells[index]]++] = index;
+  }
+}
+
+void BroadPhaseGrid::Query(const cg::Location &location,
+                           const float radius,
+                           std::vector<std::size_t> &result) const {
+  if (entries.empty()) {
+    return;
+  }
+
+  const int64_t first_x = std::max(GetCellCoordinate(location.x - radius) - min_x, int64_t(0));
+  const int64_t last_x = std::min(GetCellCoordinate(location.x + radius) - min_x, width - 1);
+  const int64_t first_y = std::max(GetCellCoordinate(location.y - radius) - min_y, int64_t(0));
+  const int64_t last_y = std::min(GetCellCoordinate(location.y + radius) - min_y, height - 1);
+  if (first_x > last_x || first_y > last_y) {
+    return;
+  }
+
+  // The cells of a row are contiguous, and so are their entries.
+  for (int64_t y = first_y; y <= last_y; ++y) {
+    const std::size_t row = static_cast<std::size_t>(y * width);
+    const std::size_t begin = cell_start[row + static_cast<std::size_t>(first_x)];
+    const std::size_t end = cell_start[row + static_cast<std::size_t>(last_x) + 1u];
+    result.insert(result.end(), entries.begin() + static_cast<std::ptrdiff_t>(begin),
+                  entries.begin() + static_cast<std::ptrdiff_t>(end));
+  }
+}
+
+void BroadPhaseGrid::Clear() {
+  entries.clear();
+  cell_start.clear();
+  width = 0;
+  height = 0;
+}
+
+} // namespace traffic_manager
+} // namespace carla
@@ -0,0 +1,67 @@
+// Copyright (c) 2023 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "carla/geom/Location.h"
+
+namespace carla {
+namespace traffic_manager {
+
+namespace cg = carla::geom;
+
+/// Uniform grid over the top view positions of a set of actors, rebuilt
+/// every cycle. It is used to find the actors near a location without
+/// testing every pair of actors. Entries are the indices of the locations
+/// the grid was built from, usually the simulation state slots.
+///
+/// The cells covering the bounding box of the locations are stored densely,
+/// row by row, so a query reads a contiguous range of entries per row
+/// instead of looking up every cell. If the locations are spread too far
+/// apart for the given cell size, the cells are made larger to keep the
+/// number of cells proportional to the number of entries.
+class BroadPhaseGrid {
+
+private:
+  float cell_size;
+  /// Size and inverse size of the cells of the current grid.
+  float grid_cell_size;
+  float inv_cell_size;
+  /// Coordinates of the first cell and number of cells in each axis.
+  int64_t min_x = 0;
+  int64_t min_y = 0;
+  int64_t width = 0;
+  int64_t height = 0;
+  /// Index of every entry, sorted by cell.
+  std::vector<std::size_t> entries;
+  /// Range of entries [cell_start[i], cell_start[i + 1]) in each cell.
+  std::vector<std::size_t> cell_start;
+  /// Cell of every entry, kept to avoid computing it twice while building.
+  std::vector<std::size_t> entry_cells;
+
+  int64_t GetCellCoordinate(const float value) const;
+
+public:
+  explicit BroadPhaseGrid(const float cell_size);
+
+  /// Method to rebuild the grid from the given locations.
+  void Build(const std::vector<cg::Location> &locations);
+
+  /// Method to append to result the index of every entry lying in a cell
+  /// touched by the circle of the given radius around location. The result
+  /// is a superset of the entries in the circle and needs exact filtering.
+  void Query(const cg::Location &location,
+             const float radius,
+             std::vector<std::size_t> &result) const;
+
+  void Clear();
+};
+
+} // namespace traffic_manager
+} // namespace carla
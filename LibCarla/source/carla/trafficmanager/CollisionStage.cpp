@@ -22,14 +22,58 @@ CollisionStage::CollisionStage(
   const TrackTraffic &track_traffic,
   const Parameters &parameters,
   CollisionFrame &output_array,
-  RandomGenerator &random_device)
+  VehicleRandomGenerators &random_devices,
+  const LocalMapPtr &local_map)
   : vehicle_id_list(vehicle_id_list),
     simulation_state(simulation_state),
     buffer_map(buffer_map),
     track_traffic(track_traffic),
     parameters(parameters),
     output_array(output_array),
-    random_device(random_device) {}
+    random_devices(random_devices),
+    local_map(local_map),
+    broad_phase_grid(BROAD_PHASE_CELL_SIZE) {}
+
+void SelectCollisionCandidates(const SimulationState &simulation_state,
+                               const std::size_t ego_slot,
+                               const float collision_radius_square,
+                               const std::vector<std::size_t> &nearby_slots,
+                               const ActorIdSet &overlapping_actors,
+                               std::vector<CollisionCandidate> &candidates) {
+  const std::vector<cg::Location> &locations = simulation_state.GetLocationArray();
+  const std::vector<ActorId> &actor_ids = simulation_state.GetActorIdArray();
+  const cg::Location ego_location = locations[ego_slot];
+
+  // If actor is within maximum collision avoidance and vertical overlap range.
+  auto add_candidate = [&](const std::size_t slot) {
+    const cg::Location &actor_location = locations[slot];
+    const float distance_square = cg::Math::DistanceSquared(actor_location, ego_location);
+    if (slot != ego_slot
+        && distance_square < collision_radius_square
+        && std::abs(ego_location.z - actor_location.z) < VERTICAL_OVERLAP_THRESHOLD) {
+      candidates.emplace_back(distance_square, actor_ids[slot]);
+    }
+  };
+
+  if (overlapping_actors.size() < nearby_slots.size()) {
+    for (const ActorId actor_id : overlapping_actors) {
+      const std::size_t slot = simulation_state.GetSlot(actor_id);
+      if (slot != INVALID_STATE_SLOT) {
+        add_candidate(slot);
+      }
+    }
+  } else {
+    for (const std::size_t slot : nearby_slots) {
+      if (overlapping_actors.find(actor_ids[slot]) != overlapping_actors.end()) {
+        add_candidate(slot);
+      }
+    }
+  }
+
+  // Pairs compare by distance first and by actor id on ties, so the order does
+  // not depend on the order the candidates were found in.
+  std::sort(candidates.begin(), candidates.end());
+}
 
 void CollisionStage::Update(const unsigned long index) {
   ActorId obstacle_id = 0u;
@@ -37,19 +81,29 @@ void CollisionStage::Update(const unsigned long index) {
   float available_distance_margin = std::numeric_limits<float>::infinity();
 
   const ActorId ego_actor_id = vehicle_id_list.at(index);
-  if (simulation_state.ContainsActor(ego_actor_id)) {
-    const cg::Location ego_location = simulation_state.GetLocation(ego_actor_id);
+
+  // Working copy of the vehicle's collision lock.
+  CollisionLockEntry &ego_lock = cycle_locks.at(index);
+  const CollisionLock *committed_lock = collision_locks.Find(ego_actor_id);
+  ego_lock.valid = committed_lock != nullptr;
+  if (ego_lock.valid) {
+    ego_lock.lock = *committed_lock;
+  }
+
+  const std::size_t ego_slot = simulation_state.GetSlot(ego_actor_id);
+  if (ego_slot != INVALID_STATE_SLOT) {
+    const std::vector<cg::Location> &locations = simulation_state.GetLocationArray();
+    const cg::Location ego_location = locations[ego_slot];
     const Buffer &ego_buffer = buffer_map.at(ego_actor_id);
-    const unsigned long look_ahead_index = GetTargetWaypoint(ego_buffer, JUNCTION_LOOK_AHEAD).second;
-    const float velocity = simulation_state.GetVelocity(ego_actor_id).Length();
+    const unsigned long look_ahead_index = GetTargetWaypoint(local_map->GetWaypointGraph(), ego_buffer, JUNCTION_LOOK_AHEAD).second;
+    const float velocity = simulation_state.GetVelocityArray()[ego_slot].Length();
 
-    ActorIdSet overlapping_actors = track_traffic.GetOverlappingVehicles(ego_actor_id);
-    std::vector<ActorId> collision_candidate_ids;
-    // Run through vehicles with overlapping paths and filter them;
-    const float distance_to_leading = parameters.GetDistanceToLeadingVehicle(ego_actor_id);
+    // Run through nearby vehicles and filter them;
+    const VehicleParameters &ego_parameters = parameters.GetVehicleParameters(index);
+    const float distance_to_leading = ego_parameters.distance_to_leading_vehicle;
     float collision_radius_square = SQUARE(COLLISION_RADIUS_RATE * velocity + COLLISION_RADIUS_MIN);
     if (velocity < 2.0f) {
-      const float length = simulation_state.GetDimensions(ego_actor_id).x;
+      const float length = simulation_state.GetDimensionArray()[ego_slot].x;
       const float collision_radius_stop = COLLISION_RADIUS_STOP + length;
       collision_radius_square = SQUARE(collision_radius_stop);
     }
@@ -57,43 +111,38 @@ void CollisionStage::Update(const unsigned long index) {
         collision_radius_square = SQUARE(distance_to_leading);
     }
 
-    for (ActorId overlapping_actor_id : overlapping_actors) {
-      // If actor is within maximum collision avoidance and vertical overlap range.
-      const cg::Location &overlapping_actor_location = simulation_state.GetLocation(overlapping_actor_id);
-      if (overlapping_actor_id != ego_actor_id
-          && cg::Math::DistanceSquared(overlapping_actor_location, ego_location) < collision_radius_square
-          && std::abs(ego_location.z - overlapping_actor_location.z) < VERTICAL_OVERLAP_THRESHOLD) {
-        collision_candidate_ids.push_back(overlapping_actor_id);
-      }
+    // Only actors whose paths overlap the ego vehicle's path are considered,
+    // and the overlapping paths are only looked up if there is any actor nearby.
+    std::vector<CollisionCandidate> collision_candidates;
+    std::vector<std::size_t> nearby_slots;
+    broad_phase_grid.Query(ego_location, std::sqrt(collision_radius_square), nearby_slots);
+    if (nearby_slots.size() > 1u) {
+      SelectCollisionCandidates(simulation_state, ego_slot, collision_radius_square, nearby_slots,
+                                track_traffic.GetOverlappingVehicles(ego_actor_id), collision_candidates);
     }
 
-    // Sorting collision candidates in accending order of distance to current vehicle.
-    std::sort(collision_candidate_ids.begin(), collision_candidate_ids.end(),
-              [this, &ego_location](const ActorId &a_id_1, const ActorId &a_id_2) {
-                const cg::Location &e_loc = ego_location;
-                const cg::Location &loc_1 = simulation_state.GetLocation(a_id_1);
-                const cg::Location &loc_2 = simulation_state.GetLocation(a_id_2);
-                return (cg::Math::DistanceSquared(e_loc, loc_1) < cg::Math::DistanceSquared(e_loc, loc_2));
-              });
-
     // Check every actor in the vicinity if it poses a collision hazard.
-    for (auto iter = collision_candidate_ids.begin();
-         iter != collision_candidate_ids.end() && !collision_hazard;
+    for (auto iter = collision_candidates.begin();
+         iter != collision_candidates.end() && !collision_hazard;
          ++iter) {
-      const ActorId other_actor_id = *iter;
+      const ActorId other_actor_id = iter->second;
       const ActorType other_actor_type = simulation_state.GetType(other_actor_id);
 
-      if (parameters.GetCollisionDetection(ego_actor_id, other_actor_id)
-          && buffer_map.find(ego_actor_id) != buffer_map.end()
-          && simulation_state.ContainsActor(other_actor_id)) {
+      if (ego_parameters.GetCollisionDetection(other_actor_id)
+          && buffer_map.find(ego_actor_id) != buffer_map.end()) {
         std::pair<bool, float> negotiation_result = NegotiateCollision(ego_actor_id,
                                                                        other_actor_id,
-                                                                       look_ahead_index);
+                                                                       look_ahead_index,
+                                                                       ego_lock);
+        if (!parallel_cycle) {
+          CommitCollisionLock(ego_actor_id, ego_lock);
+        }
         if (negotiation_result.first) {
+          RandomGenerator &ego_random_device = random_devices.Get(index);
           if ((other_actor_type == ActorType::Vehicle
-               && parameters.GetPercentageIgnoreVehicles(ego_actor_id) <= random_device.next())
+               && ego_parameters.perc_ignore_vehicles <= ego_random_device.next())
               || (other_actor_type == ActorType::Pedestrian
-                  && parameters.GetPercentageIgnoreWalkers(ego_actor_id) <= random_device.next())) {
+                  && ego_parameters.perc_ignore_walkers <= ego_random_device.next())) {
             collision_hazard = true;
             obstacle_id = other_actor_id;
             available_distance_margin = negotiation_result.second;
@@ -110,23 +159,40 @@ void CollisionStage::Update(const unsigned long index) {
 }
 
 void CollisionStage::RemoveActor(const ActorId actor_id) {
-  collision_locks.erase(actor_id);
+  collision_locks.Erase(actor_id);
 }
 
 void CollisionStage::Reset() {
-  collision_locks.clear();
+  collision_locks.Clear();
+  cycle_locks.clear();
+  geodesic_polygon_map.Clear();
+  geometry_cache.Clear();
+  bbox_polygons.clear();
+  broad_phase_grid.Clear();
 }
 
 float CollisionStage::GetBoundingBoxExtention(const ActorId actor_id) {
 
+  CollisionLockEntry lock_entry;
+  const CollisionLock *committed_lock = collision_locks.Find(actor_id);
+  if (committed_lock != nullptr) {
+    lock_entry.valid = true;
+    lock_entry.lock = *committed_lock;
+  }
+
+  return GetBoundingBoxExtention(actor_id, lock_entry);
+}
+
+float CollisionStage::GetBoundingBoxExtention(const ActorId actor_id, const CollisionLockEntry &lock_entry) {
+
   const float velocity = cg::Math::Dot(simulation_state.GetVelocity(actor_id), simulation_state.GetHeading(actor_id));
   float bbox_extension;
   // Using a function to calculate boundary length.
   float velocity_extension = VEL_EXT_FACTOR * velocity;
   bbox_extension = BOUNDARY_EXTENSION_MINIMUM + velocity_extension * velocity_extension;
   // If a valid collision lock present, change boundary length to maintain lock.
-  if (collision_locks.find(actor_id) != collision_locks.end()) {
-    const CollisionLock &lock = collision_locks.at(actor_id);
+  if (lock_entry.valid) {
+    const CollisionLock &lock = lock_entry.lock;
     float lock_boundary_length = static_cast<float>(lock.distance_to_lead_vehicle + LOCKING_DISTANCE_PADDING);
     // Only extend boundary track vehicle if the leading vehicle
     // if it is not further than velocity dependent extension by MAX_LOCKING_EXTENSION.
@@ -139,16 +205,17 @@ float CollisionStage::GetBoundingBoxExtention(const ActorId actor_id) {
 }
 
 LocationVector CollisionStage::GetBoundary(const ActorId actor_id) {
-  const ActorType actor_type = simulation_state.GetType(actor_id);
-  const cg::Vector3D heading_vector = simulation_state.GetHeading(actor_id);
+  const std::size_t slot = simulation_state.GetSlot(actor_id);
+  const ActorType actor_type = simulation_state.GetTypeArray().at(slot);
+  const cg::Vector3D heading_vector = simulation_state.GetHeadingArray()[slot];
 
   float forward_extension = 0.0f;
   if (actor_type == ActorType::Pedestrian) {
     // Extend the pedestrians bbox to "predict" where they'll be and avoid collisions.
-    forward_extension = simulation_state.GetVelocity(actor_id).Length() * WALKER_TIME_EXTENSION;
+    forward_extension = simulation_state.GetVelocityArray()[slot].Length() * WALKER_TIME_EXTENSION;
   }
 
-  cg::Vector3D dimensions = simulation_state.GetDimensions(actor_id);
+  const cg::Vector3D &dimensions = simulation_state.GetDimensionArray()[slot];
 
   float bbox_x = dimensions.x;
   float bbox_y = dimensions.y;
@@ -158,7 +225,7 @@ LocationVector CollisionStage::GetBoundary(const ActorId actor_id) {
   const cg::Vector3D y_boundary_vector = perpendicular_vector * (bbox_y + forward_extension);
 
   // Four corners of the vehicle in top view clockwise order (left-handed system).
-  const cg::Location location = simulation_state.GetLocation(actor_id);
+  const cg::Location location = simulation_state.GetLocationArray()[slot];
   LocationVector bbox_boundary = {
       location + cg::Location(x_boundary_vector - y_boundary_vector),
       location + cg::Location(-1.0f * x_boundary_vector - y_boundary_vector),
@@ -172,76 +239,81 @@ LocationVector CollisionStage::GetBoundary(const ActorId actor_id) {
 LocationVector CollisionStage::GetGeodesicBoundary(const ActorId actor_id) {
   LocationVector geodesic_boundary;
 
-  if (geodesic_boundary_map.find(actor_id) != geodesic_boundary_map.end()) {
-    geodesic_boundary = geodesic_boundary_map.at(actor_id);
-  } else {
-    const LocationVector bbox = GetBoundary(actor_id);
-
-    if (buffer_map.find(actor_id) != buffer_map.end()) {
-      float bbox_extension = GetBoundingBoxExtention(actor_id);
-      const float specific_lead_distance = parameters.GetDistanceToLeadingVehicle(actor_id);
-      bbox_extension = std::max(specific_lead_distance, bbox_extension);
-      const float bbox_extension_square = SQUARE(bbox_extension);
-
-      LocationVector left_boundary;
-      LocationVector right_boundary;
-      cg::Vector3D dimensions = simulation_state.GetDimensions(actor_id);
-      const float width = dimensions.y;
-      const float length = dimensions.x;
-
-      const Buffer &waypoint_buffer = buffer_map.at(actor_id);
-      const TargetWPInfo target_wp_info = GetTargetWaypoint(waypoint_buffer, length);
-      const SimpleWaypointPtr boundary_start = target_wp_info.first;
-      const uint64_t boundary_start_index = target_wp_info.second;
-
-      // At non-signalized junctions, we extend the boundary across the junction
-      // and in all other situations, boundary length is velocity-dependent.
-      SimpleWaypointPtr boundary_end = nullptr;
-      SimpleWaypointPtr current_point = waypoint_buffer.at(boundary_start_index);
-      bool reached_distance = false;
-      for (uint64_t j = boundary_start_index; !reached_distance && (j < waypoint_buffer.size()); ++j) {
-        if (boundary_start->DistanceSquared(current_point) > bbox_extension_square || j == waypoint_buffer.size() - 1) {
-          reached_distance = true;
-        }
-        if (boundary_end == nullptr
-            || cg::Math::Dot(boundary_end->GetForwardVector(), current_point->GetForwardVector()) < COS_10_DEGREES
-            || reached_distance) {
-
-          const cg::Vector3D heading_vector = current_point->GetForwardVector();
-          const cg::Location location = current_point->GetLocation();
-          cg::Vector3D perpendicular_vector = cg::Vector3D(-heading_vector.y, heading_vector.x, 0.0f);
-          perpendicular_vector = perpendicular_vector.MakeSafeUnitVector(EPSILON);
-          // Direction determined for the left-handed system.
-          const cg::Vector3D scaled_perpendicular = perpendicular_vector * width;
-          left_boundary.push_back(location + cg::Location(scaled_perpendicular));
-          right_boundary.push_back(location + cg::Location(-1.0f * scaled_perpendicular));
-
-          boundary_end = current_point;
-        }
-
-        current_point = waypoint_buffer.at(j);
+  const LocationVector bbox = GetBoundary(actor_id);
+
+  if (buffer_map.find(actor_id) != buffer_map.end()) {
+    float bbox_extension = GetBoundingBoxExtention(actor_id);
+    const float specific_lead_distance = parameters.GetActorParameters(actor_id).distance_to_leading_vehicle;
+    bbox_extension = std::max(specific_lead_distance, bbox_extension);
+    const float bbox_extension_square = SQUARE(bbox_extension);
+
+    LocationVector left_boundary;
+    LocationVector right_boundary;
+    cg::Vector3D dimensions = simulation_state.GetDimensions(actor_id);
+    const float width = dimensions.y;
+    const float length = dimensions.x;
+
+    const WaypointGraph &waypoint_graph = local_map->GetWaypointGraph();
+    const Buffer &waypoint_buffer = buffer_map.at(actor_id);
+    const TargetWPInfo target_wp_info = GetTargetWaypoint(waypoint_graph, waypoint_buffer, length);
+    const WaypointIndex boundary_start = target_wp_info.first;
+    const uint64_t boundary_start_index = target_wp_info.second;
+
+    // At non-signalized junctions, we extend the boundary across the junction
+    // and in all other situations, boundary length is velocity-dependent.
+    WaypointIndex boundary_end = INVALID_WAYPOINT_INDEX;
+    WaypointIndex current_point = waypoint_buffer[boundary_start_index];
+    bool reached_distance = false;
+    for (uint64_t j = boundary_start_index; !reached_distance && (j < waypoint_buffer.size()); ++j) {
+      if (waypoint_graph.DistanceSquared(boundary_start, current_point) > bbox_extension_square || j == waypoint_buffer.size() - 1) {
+        reached_distance = true;
+      }
+      const WaypointRecord &current_record = waypoint_graph.GetRecord(current_point);
+      if (boundary_end == INVALID_WAYPOINT_INDEX
+          || cg::Math::Dot(waypoint_graph.GetRecord(boundary_end).forward_vector, current_record.forward_vector) < COS_10_DEGREES
+          || reached_distance) {
+
+        const cg::Vector3D heading_vector = current_record.forward_vector;
+        const cg::Location location = current_record.location;
+        cg::Vector3D perpendicular_vector = cg::Vector3D(-heading_vector.y, heading_vector.x, 0.0f);
+        perpendicular_vector = perpendicular_vector.MakeSafeUnitVector(EPSILON);
+        // Direction determined for the left-handed system.
+        const cg::Vector3D scaled_perpendicular = perpendicular_vector * width;
+        left_boundary.push_back(location + cg::Location(scaled_perpendicular));
+        right_boundary.push_back(location + cg::Location(-1.0f * scaled_perpendicular));
+
+        boundary_end = current_point;
       }
 
-      // Reversing right boundary to construct clockwise (left-hand system)
-      // boundary. This is so because both left and right boundary vectors have
-      // the closest point to the vehicle at their starting index for the right
-      // boundary,
-      // we want to begin at the farthest point to have a clockwise trace.
-      std::reverse(right_boundary.begin(), right_boundary.end());
-      geodesic_boundary.insert(geodesic_boundary.end(), right_boundary.begin(), right_boundary.end());
-      geodesic_boundary.insert(geodesic_boundary.end(), bbox.begin(), bbox.end());
-      geodesic_boundary.insert(geodesic_boundary.end(), left_boundary.begin(), left_boundary.end());
-    } else {
-
-      geodesic_boundary = bbox;
+      current_point = waypoint_buffer[j];
     }
 
-    geodesic_boundary_map.insert({actor_id, geodesic_boundary});
+    // Reversing right boundary to construct clockwise (left-hand system)
+    // boundary. This is so because both left and right boundary vectors have
+    // the closest point to the vehicle at their starting index for the right
+    // boundary,
+    // we want to begin at the farthest point to have a clockwise trace.
+    std::reverse(right_boundary.begin(), right_boundary.end());
+    geodesic_boundary.insert(geodesic_boundary.end(), right_boundary.begin(), right_boundary.end());
+    geodesic_boundary.insert(geodesic_boundary.end(), bbox.begin(), bbox.end());
+    geodesic_boundary.insert(geodesic_boundary.end(), left_boundary.begin(), left_boundary.end());
+  } else {
+
+    geodesic_boundary = bbox;
   }
 
   return geodesic_boundary;
 }
 
+Polygon CollisionStage::GetGeodesicPolygon(const ActorId actor_id) {
+  const Polygon *cached_polygon = geodesic_polygon_map.Find(actor_id);
+  if (cached_polygon != nullptr) {
+    return *cached_polygon;
+  }
+
+  return geodesic_polygon_map.Insert(actor_id, GetPolygon(GetGeodesicBoundary(actor_id)));
+}
+
 Polygon CollisionStage::GetPolygon(const LocationVector &boundary) {
 
   traffic_manager::Polygon boundary_polygon;
@@ -271,20 +343,21 @@ GeometryComparison CollisionStage::GetGeometryBetweenActors(const ActorId refere
 
   GeometryComparison comparision_result{-1.0, -1.0, -1.0, -1.0};
 
-  if (geometry_cache.find(actor_id_key) != geometry_cache.end()) {
+  const GeometryComparison *cached_result = geometry_cache.Find(actor_id_key);
+  if (cached_result != nullptr) {
+    comparision_result = *cached_result;
 
-    comparision_result = geometry_cache.at(actor_id_key);
     double mref_veh_other = comparision_result.reference_vehicle_to_other_geodesic;
     comparision_result.reference_vehicle_to_other_geodesic = comparision_result.other_vehicle_to_reference_geodesic;
     comparision_result.other_vehicle_to_reference_geodesic = mref_veh_other;
   } else {
 
-    const Polygon reference_polygon = GetPolygon(GetBoundary(reference_vehicle_id));
-    const Polygon other_polygon = GetPolygon(GetBoundary(other_actor_id));
+    const Polygon &reference_polygon = bbox_polygons.at(simulation_state.GetSlot(reference_vehicle_id));
+    const Polygon &other_polygon = bbox_polygons.at(simulation_state.GetSlot(other_actor_id));
 
-    const Polygon reference_geodesic_polygon = GetPolygon(GetGeodesicBoundary(reference_vehicle_id));
+    const Polygon reference_geodesic_polygon = GetGeodesicPolygon(reference_vehicle_id);
 
-    const Polygon other_geodesic_polygon = GetPolygon(GetGeodesicBoundary(other_actor_id));
+    const Polygon other_geodesic_polygon = GetGeodesicPolygon(other_actor_id);
 
     const double reference_vehicle_to_other_geodesic = bg::distance(reference_polygon, other_geodesic_polygon);
     const double other_vehicle_to_reference_geodesic = bg::distance(other_polygon, reference_geodesic_polygon);
@@ -296,7 +369,7 @@ GeometryComparison CollisionStage::GetGeometryBetweenActors(const ActorId refere
               inter_geodesic_distance,
               inter_bbox_distance};
 
-    geometry_cache.insert({actor_id_key, comparision_result});
+    geometry_cache.Insert(actor_id_key, comparision_result);
   }
 
   return comparision_result;
@@ -304,31 +377,38 @@ GeometryComparison CollisionStage::GetGeometryBetweenActors(const ActorId refere
 
 std::pair<bool, float> CollisionStage::NegotiateCollision(const ActorId reference_vehicle_id,
                                                           const ActorId other_actor_id,
-                                                          const uint64_t reference_junction_look_ahead_index) {
+                                                          const uint64_t reference_junction_look_ahead_index,
+                                                          CollisionLockEntry &reference_lock) {
   // Output variables for the method.
   bool hazard = false;
   float available_distance_margin = std::numeric_limits<float>::infinity();
 
-  const cg::Location reference_location = simulation_state.GetLocation(reference_vehicle_id);
-  const cg::Location other_location = simulation_state.GetLocation(other_actor_id);
+  const std::size_t reference_slot = simulation_state.GetSlot(reference_vehicle_id);
+  const std::size_t other_slot = simulation_state.GetSlot(other_actor_id);
+  const std::vector<cg::Location> &locations = simulation_state.GetLocationArray();
+  const std::vector<cg::Vector3D> &headings = simulation_state.GetHeadingArray();
+  const std::vector<cg::Vector3D> &dimensions = simulation_state.GetDimensionArray();
+
+  const cg::Location reference_location = locations.at(reference_slot);
+  const cg::Location other_location = locations.at(other_slot);
 
   // Ego and other vehicle heading.
-  const cg::Vector3D reference_heading = simulation_state.GetHeading(reference_vehicle_id);
+  const cg::Vector3D reference_heading = headings[reference_slot];
   // Vector from ego position to position of the other vehicle.
   cg::Vector3D reference_to_other = other_location - reference_location;
   reference_to_other = reference_to_other.MakeSafeUnitVector(EPSILON);
 
   // Other vehicle heading.
-  const cg::Vector3D other_heading = simulation_state.GetHeading(other_actor_id);
+  const cg::Vector3D other_heading = headings[other_slot];
   // Vector from other vehicle position to ego position.
   cg::Vector3D other_to_reference = reference_location - other_location;
   other_to_reference = other_to_reference.MakeSafeUnitVector(EPSILON);
 
-  float reference_vehicle_length = simulation_state.GetDimensions(reference_vehicle_id).x * SQUARE_ROOT_OF_TWO;
-  float other_vehicle_length = simulation_state.GetDimensions(other_actor_id).x * SQUARE_ROOT_OF_TWO;
+  float reference_vehicle_length = dimensions[reference_slot].x * SQUARE_ROOT_OF_TWO;
+  float other_vehicle_length = dimensions[other_slot].x * SQUARE_ROOT_OF_TWO;
 
   float inter_vehicle_distance = cg::Math::DistanceSquared(reference_location, other_location);
-  float ego_bounding_box_extension = GetBoundingBoxExtention(reference_vehicle_id);
+  float ego_bounding_box_extension = GetBoundingBoxExtention(reference_vehicle_id, reference_lock);
   float other_bounding_box_extension = GetBoundingBoxExtention(other_actor_id);
   // Calculate minimum distance between vehicle to consider collision negotiation.
   float inter_vehicle_length = reference_vehicle_length + other_vehicle_length;
@@ -340,14 +420,15 @@ std::pair<bool, float> CollisionStage::NegotiateCollision(const ActorId referenc
   bool other_vehicles_in_cross_detection_range = inter_vehicle_distance < cross_detection_range;
   float reference_heading_to_other_dot = cg::Math::Dot(reference_heading, reference_to_other);
   bool other_vehicle_in_front = reference_heading_to_other_dot > 0;
+  const WaypointGraph &waypoint_graph = local_map->GetWaypointGraph();
   const Buffer &reference_vehicle_buffer = buffer_map.at(reference_vehicle_id);
-  SimpleWaypointPtr closest_point = reference_vehicle_buffer.front();
-  bool ego_inside_junction = closest_point->CheckJunction();
+  const WaypointRecord &closest_point = waypoint_graph.GetRecord(reference_vehicle_buffer.front());
+  bool ego_inside_junction = closest_point.is_junction;
   TrafficLightState reference_tl_state = simulation_state.GetTLS(reference_vehicle_id);
   bool ego_at_traffic_light = reference_tl_state.at_traffic_light;
   bool ego_stopped_by_light = reference_tl_state.tl_state != TLS::Green && reference_tl_state.tl_state != TLS::Off;
-  SimpleWaypointPtr look_ahead_point = reference_vehicle_buffer.at(reference_junction_look_ahead_index);
-  bool ego_at_junction_entrance = !closest_point->CheckJunction() && look_ahead_point->CheckJunction();
+  const WaypointRecord &look_ahead_point = waypoint_graph.GetRecord(reference_vehicle_buffer[reference_junction_look_ahead_index]);
+  bool ego_at_junction_entrance = !closest_point.is_junction && look_ahead_point.is_junction;
 
   // Conditions to consider collision negotiation.
   if (!(ego_at_junction_entrance && ego_at_traffic_light && ego_stopped_by_light)
@@ -374,7 +455,7 @@ std::pair<bool, float> CollisionStage::NegotiateCollision(const ActorId referenc
 
       hazard = true;
 
-      const float reference_lead_distance = parameters.GetDistanceToLeadingVehicle(reference_vehicle_id);
+      const float reference_lead_distance = parameters.GetActorParameters(reference_vehicle_id).distance_to_leading_vehicle;
       const float specific_distance_margin = std::max(reference_lead_distance, MIN_REFERENCE_DISTANCE);
       available_distance_margin = static_cast<float>(std::max(geometry_comparison.reference_vehicle_to_other_geodesic
                                                               - static_cast<double>(specific_distance_margin), 0.0));
@@ -385,8 +466,8 @@ std::pair<bool, float> CollisionStage::NegotiateCollision(const ActorId referenc
       // This enables us to smoothly approach the lead vehicle.
 
       // When possible collision found, check if an entry for collision lock present.
-      if (collision_locks.find(reference_vehicle_id) != collision_locks.end()) {
-        CollisionLock &lock = collision_locks.at(reference_vehicle_id);
+      if (reference_lock.valid) {
+        CollisionLock &lock = reference_lock.lock;
         // Check if the same vehicle is under lock.
         if (other_actor_id == lock.lead_vehicle_id) {
           // If the body of the lead vehicle is touching the reference vehicle bounding box.
@@ -403,25 +484,56 @@ std::pair<bool, float> CollisionStage::NegotiateCollision(const ActorId referenc
         }
       } else {
         // Insert and initialize lock entry if not present.
-        collision_locks.insert({reference_vehicle_id,
-                                {geometry_comparison.inter_bbox_distance,
-                                 geometry_comparison.inter_bbox_distance,
-                                 other_actor_id}});
+        reference_lock.valid = true;
+        reference_lock.lock = {geometry_comparison.inter_bbox_distance,
+                               geometry_comparison.inter_bbox_distance,
+                               other_actor_id};
       }
     }
   }
 
   // If no collision hazard detected, then flush collision lock held by the vehicle.
-  if (!hazard && collision_locks.find(reference_vehicle_id) != collision_locks.end()) {
-    collision_locks.erase(reference_vehicle_id);
+  if (!hazard) {
+    reference_lock.valid = false;
   }
 
   return {hazard, available_distance_margin};
 }
 
+void CollisionStage::PrepareCycle(const std::size_t number_of_workers) {
+  parallel_cycle = number_of_workers > 1u;
+  cycle_locks.clear();
+  cycle_locks.resize(vehicle_id_list.size());
+
+  // Broad phase structures, the simulation state does not change while the stage runs.
+  broad_phase_grid.Build(simulation_state.GetLocationArray());
+  const std::vector<ActorId> &actor_ids = simulation_state.GetActorIdArray();
+  bbox_polygons.clear();
+  bbox_polygons.reserve(actor_ids.size());
+  for (const ActorId actor_id : actor_ids) {
+    bbox_polygons.push_back(GetPolygon(GetBoundary(actor_id)));
+  }
+}
+
+void CollisionStage::CommitCollisionLock(const ActorId actor_id, const CollisionLockEntry &lock_entry) {
+  if (lock_entry.valid) {
+    collision_locks.Set(actor_id, lock_entry.lock);
+  } else {
+    collision_locks.Erase(actor_id);
+  }
+}
+
 void CollisionStage::ClearCycleCache() {
-  geodesic_boundary_map.clear();
-  geometry_cache.clear();
+  for (unsigned long index = 0u; index < cycle_locks.size() && index < vehicle_id_list.size(); ++index) {
+    CommitCollisionLock(vehicle_id_list.at(index), cycle_locks.at(index));
+  }
+  cycle_locks.clear();
+  parallel_cycle = false;
+
+  geodesic_polygon_map.Clear();
+  geometry_cache.Clear();
+  bbox_polygons.clear();
+  broad_phase_grid.Clear();
 }
 
 } // namespace traffic_manager
@@ -2,6 +2,7 @@
 #pragma once
 
 #include <memory>
+#include <mutex>
 
 #if defined(__clang__)
 #  pragma clang diagnostic push
@@ -15,11 +16,15 @@
 #  pragma clang diagnostic pop
 #endif
 
+#include "carla/trafficmanager/BroadPhaseGrid.h"
 #include "carla/trafficmanager/DataStructures.h"
+#include "carla/trafficmanager/InMemoryMap.h"
 #include "carla/trafficmanager/Parameters.h"
 #include "carla/trafficmanager/RandomGenerator.h"
+#include "carla/trafficmanager/ShardedMap.h"
 #include "carla/trafficmanager/SimulationState.h"
 #include "carla/trafficmanager/Stage.h"
+#include "carla/trafficmanager/TrackTraffic.h"
 
 namespace carla {
 namespace traffic_manager {
@@ -36,17 +41,37 @@ struct CollisionLock {
   double initial_lock_distance;
   ActorId lead_vehicle_id;
 };
-using CollisionLockMap = std::unordered_map<ActorId, CollisionLock>;
+using CollisionLockMap = ShardedMap<ActorId, CollisionLock>;
+
+/// Collision lock held by a vehicle while its update is in progress.
+struct CollisionLockEntry {
+  bool valid = false;
+  CollisionLock lock;
+};
+using CollisionLockFrame = std::vector<CollisionLockEntry>;
 
 namespace cc = carla::client;
 namespace bg = boost::geometry;
 
-using Buffer = std::deque<std::shared_ptr<SimpleWaypoint>>;
-using BufferMap = std::unordered_map<carla::ActorId, Buffer>;
+using LocalMapPtr = std::shared_ptr<InMemoryMap>;
 using LocationVector = std::vector<cg::Location>;
-using GeodesicBoundaryMap = std::unordered_map<ActorId, LocationVector>;
-using GeometryComparisonMap = std::unordered_map<uint64_t, GeometryComparison>;
+using GeometryComparisonMap = ShardedMap<uint64_t, GeometryComparison>;
 using Polygon = bg::model::polygon<bg::model::d2::point_xy<double>>;
+using GeodesicPolygonMap = ShardedMap<ActorId, Polygon>;
+/// Actor near the ego vehicle, with its squared distance to it.
+using CollisionCandidate = std::pair<float, ActorId>;
+
+/// Method to collect the actors within the collision radius and the vertical
+/// overlap range of the actor in ego_slot whose paths overlap its path, sorted
+/// in ascending order of (distance, actor id). nearby_slots are the slots
+/// returned by the broad-phase grid around the ego vehicle; whichever of them
+/// and overlapping_actors is smaller is walked.
+void SelectCollisionCandidates(const SimulationState &simulation_state,
+                               const std::size_t ego_slot,
+                               const float collision_radius_square,
+                               const std::vector<std::size_t> &nearby_slots,
+                               const ActorIdSet &overlapping_actors,
+                               std::vector<CollisionCandidate> &candidates);
 
 /// This class has functionality to detect potential collision with a nearby actor.
 class CollisionStage : Stage {
@@ -58,21 +83,38 @@ private:
   const Parameters &parameters;
   CollisionFrame &output_array;
   // Structure keeping track of blocking lead vehicles.
+  // Changes made by each vehicle are kept in cycle_locks. A single worker
+  // commits them right away, as vehicles are updated one after the other.
+  // Several workers only read it during an update cycle, and the changes
+  // are committed once the cycle ends.
   CollisionLockMap collision_locks;
+  CollisionLockFrame cycle_locks;
+  bool parallel_cycle = false;
   // Structures to cache geodesic boundaries of vehicle and
   // comparision between vehicle boundaries
   // to avoid repeated computation within a cycle.
   GeometryComparisonMap geometry_cache;
-  GeodesicBoundaryMap geodesic_boundary_map;
-  RandomGenerator &random_device;
+  GeodesicPolygonMap geodesic_polygon_map;
+  VehicleRandomGenerators &random_devices;
+  const LocalMapPtr &local_map;
+  // Bounding box polygon of every actor, indexed by simulation state slot
+  // and built once at the beginning of every cycle.
+  std::vector<Polygon> bbox_polygons;
+  // Grid over the actor locations used to find collision candidates.
+  BroadPhaseGrid broad_phase_grid;
 
   // Method to determine if a vehicle is on a collision path to another.
   std::pair<bool, float> NegotiateCollision(const ActorId reference_vehicle_id,
                                             const ActorId other_actor_id,
-                                            const uint64_t reference_junction_look_ahead_index);
+                                            const uint64_t reference_junction_look_ahead_index,
+                                            CollisionLockEntry &reference_lock);
 
   // Method to calculate bounding box extention length ahead of the vehicle.
   float GetBoundingBoxExtention(const ActorId actor_id);
+  float GetBoundingBoxExtention(const ActorId actor_id, const CollisionLockEntry &lock_entry);
+
+  // Method to make the collision lock of a vehicle visible to the others.
+  void CommitCollisionLock(const ActorId actor_id, const CollisionLockEntry &lock_entry);
 
   // Method to calculate polygon points around the vehicle's bounding box.
   LocationVector GetBoundary(const ActorId actor_id);
@@ -80,6 +122,10 @@ private:
   // Method to construct polygon points around the path boundary of the vehicle.
   LocationVector GetGeodesicBoundary(const ActorId actor_id);
 
+  // Method to get the polygon around the path boundary of the vehicle,
+  // cached for reuse in current update cycle.
+  Polygon GetGeodesicPolygon(const ActorId actor_id);
+
   Polygon GetPolygon(const LocationVector &boundary);
 
   // Method to compare path boundaries, bounding boxes of vehicles
@@ -97,7 +143,8 @@ public:
                  const TrackTraffic &track_traffic,
                  const Parameters &parameters,
                  CollisionFrame &output_array,
-                 RandomGenerator &random_device);
+                 VehicleRandomGenerators &random_devices,
+                 const LocalMapPtr &local_map);
 
   void Update (const unsigned long index) override;
 
@@ -105,7 +152,11 @@ public:
 
   void Reset() override;
 
-  // Method to flush cache for current update cycle.
+  // Method to prepare the per-cycle structures before the vehicles are updated,
+  // possibly from several workers.
+  void PrepareCycle(const std::size_t number_of_workers);
+
+  // Method to commit collision locks and flush cache for current update cycle.
   void ClearCycleCache();
 };
 
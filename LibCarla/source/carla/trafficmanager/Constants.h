@@ -87,6 +87,7 @@ static const float EPSILON = 2.0f * std::numeric_limits<float>::epsilon();
 static const float MIN_REFERENCE_DISTANCE = 0.5f;
 static const float MIN_VELOCITY_COLL_RADIUS = 2.0f;
 static const float VEL_EXT_FACTOR = 0.36f;
+static const float BROAD_PHASE_CELL_SIZE = 20.0f;
 } // namespace Collision
 
 namespace FrameMemory {
@@ -158,6 +159,7 @@ static const std::vector<float> LATERAL_HIGHWAY_PARAM = {2.0f, 0.02f, 0.04f};
 namespace TrackTraffic {
 static const uint64_t BUFFER_STEP_THROUGH = 5;
 static const float INV_BUFFER_STEP_THROUGH = 1.0f / static_cast<float>(BUFFER_STEP_THROUGH);
+static const std::size_t DEFERRED_UPDATE_SHARDS = 16u;
 } // namespace TrackTraffic
 
 } // namespace constants
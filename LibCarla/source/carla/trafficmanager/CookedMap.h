@@ -0,0 +1,101 @@
+// Copyright (c) 2023 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#include "carla/trafficmanager/SpatialTree.h"
+#include "carla/trafficmanager/WaypointGraph.h"
+
+namespace carla {
+namespace traffic_manager {
+namespace cooked_map {
+
+  /// Layout of the cooked InMemoryMap files. The file is a fixed header
+  /// followed by sections of plain records, each starting at an offset
+  /// multiple of 8 from the beginning of the file. Waypoints are referenced
+  /// by their position in the waypoint section and tree nodes by their
+  /// position in the node section, so the local map reads the waypoint graph
+  /// and the spatial tree in place from a memory mapping of the file.
+  ///
+  /// The waypoint and tree sections hold WaypointRecord, SpatialTreeNode and
+  /// SpatialTreeItem as laid out in memory, checked below. All values are
+  /// stored in little-endian order. Files are written and read with the byte
+  /// order of the host, so cooking and loading are refused on big-endian
+  /// hosts.
+
+  static constexpr char MAGIC[8] = {'C', 'A', 'T', 'M', 'M', 'A', 'P', '\0'};
+
+  /// Increment whenever the layout of any section changes.
+  static constexpr uint32_t VERSION = 3u;
+
+  static constexpr uint32_t INVALID_INDEX = 0xFFFFFFFFu;
+
+  struct Header {
+    char magic[8];
+    uint32_t version;
+    uint32_t header_size;
+    uint64_t waypoint_count;
+    /// Number of entries of the successor and predecessor index sections.
+    uint64_t next_count;
+    uint64_t previous_count;
+    /// Offsets from the beginning of the file to each section.
+    uint64_t waypoints_offset;
+    /// waypoint_count + 1 offsets into the successor index section.
+    uint64_t next_offsets_offset;
+    uint64_t next_indices_offset;
+    /// waypoint_count + 1 offsets into the predecessor index section.
+    uint64_t previous_offsets_offset;
+    uint64_t previous_indices_offset;
+    /// Spatial tree, the first tree_leaf_count nodes being the leaves. It
+    /// has an item per waypoint.
+    uint64_t tree_node_count;
+    uint64_t tree_leaf_count;
+    uint64_t tree_nodes_offset;
+    uint64_t tree_items_offset;
+  };
+
+  static_assert(sizeof(Header) == 112u, "Unexpected cooked map header size");
+
+  static_assert(std::is_trivially_copyable<WaypointRecord>::value, "Waypoint records must be plain data");
+  static_assert(std::is_standard_layout<WaypointRecord>::value, "Waypoint records must be plain data");
+  static_assert(sizeof(WaypointRecord) == 88u, "Unexpected cooked map waypoint size");
+  static_assert(alignof(WaypointRecord) <= 8u, "Unexpected cooked map waypoint alignment");
+  static_assert(offsetof(WaypointRecord, id) == 40u, "Unexpected cooked map waypoint layout");
+  static_assert(offsetof(WaypointRecord, s) == 48u, "Unexpected cooked map waypoint layout");
+  static_assert(offsetof(WaypointRecord, road_id) == 56u, "Unexpected cooked map waypoint layout");
+  static_assert(offsetof(WaypointRecord, left) == 76u, "Unexpected cooked map waypoint layout");
+  static_assert(offsetof(WaypointRecord, is_junction) == 85u, "Unexpected cooked map waypoint layout");
+
+  static_assert(std::is_trivially_copyable<SpatialTreeNode>::value, "Spatial tree nodes must be plain data");
+  static_assert(sizeof(SpatialTreeNode) == 32u, "Unexpected cooked map tree node size");
+  static_assert(std::is_trivially_copyable<SpatialTreeItem>::value, "Spatial tree items must be plain data");
+  static_assert(sizeof(SpatialTreeItem) == 16u, "Unexpected cooked map tree item size");
+
+  static inline uint64_t AlignOffset(const uint64_t offset) {
+    return (offset + 7u) & ~static_cast<uint64_t>(7u);
+  }
+
+  /// Returns true if the host stores values in little-endian order.
+  static inline bool IsLittleEndianHost() {
+    const uint16_t value = 1u;
+    uint8_t first_byte;
+    std::memcpy(&first_byte, &value, sizeof(first_byte));
+    return first_byte == 1u;
+  }
+
+  /// Returns true if the buffer starts with a cooked map header.
+  static inline bool IsCookedMap(const uint8_t *data, const std::size_t size) {
+    return size >= sizeof(Header) && std::memcmp(data, MAGIC, sizeof(MAGIC)) == 0;
+  }
+
+} // namespace cooked_map
+} // namespace traffic_manager
+} // namespace carla
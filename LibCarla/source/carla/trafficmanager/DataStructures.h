@@ -4,7 +4,6 @@
 #pragma once
 
 #include <chrono>
-#include <deque>
 #include <vector>
 
 #include "carla/client/Actor.h"
@@ -16,6 +15,8 @@
 #include "carla/rpc/TrafficLightState.h"
 
 #include "carla/trafficmanager/SimpleWaypoint.h"
+#include "carla/trafficmanager/WaypointBuffer.h"
+#include "carla/trafficmanager/WaypointGraph.h"
 
 namespace carla {
 namespace traffic_manager {
@@ -29,14 +30,14 @@ using ActorPtr = carla::SharedPtr<cc::Actor>;
 using JunctionID = carla::road::JuncId;
 using Junction = carla::SharedPtr<carla::client::Junction>;
 using SimpleWaypointPtr = std::shared_ptr<SimpleWaypoint>;
-using Buffer = std::deque<SimpleWaypointPtr>;
+using Buffer = WaypointBuffer;
 using BufferMap = std::unordered_map<carla::ActorId, Buffer>;
 using TimeInstance = chr::time_point<chr::system_clock, chr::nanoseconds>;
 using TLS = carla::rpc::TrafficLightState;
 
 struct LocalizationData {
-  SimpleWaypointPtr junction_end_point;
-  SimpleWaypointPtr safe_point;
+  WaypointIndex junction_end_point;
+  WaypointIndex safe_point;
   bool is_at_junction_entrance;
 };
 using LocalizationFrame = std::vector<LocalizationData>;
@@ -5,10 +5,17 @@
 // For a copy, see <https://opensource.org/licenses/MIT>.
 
 #include "carla/Logging.h"
+#include "carla/ThreadPool.h"
 
 #include "carla/trafficmanager/Constants.h"
 #include "carla/trafficmanager/InMemoryMap.h"
-#include <boost/geometry/geometries/box.hpp>
+#include "carla/trafficmanager/CookedMap.h"
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include <algorithm>
+#include <cstring>
 
 namespace carla {
 namespace traffic_manager {
@@ -68,6 +75,56 @@ namespace traffic_manager {
     return result;
   }
 
+  // The legacy cache only stores the road, lane and distance of a waypoint.
+  static WaypointPtr GetCachedWaypoint(const WorldMap &world_map, const CachedSimpleWaypoint &cached_wp) {
+    return world_map->GetWaypointXODR(cached_wp.road_id, cached_wp.lane_id, cached_wp.s);
+  }
+
+  // Waypoints link to each other, so they are only released once unlinked.
+  static void ReleaseTopology(NodeList &dense_topology) {
+    for (const SimpleWaypointPtr &swp : dense_topology) {
+      if (swp != nullptr) {
+        swp->ClearLinks();
+      }
+    }
+    dense_topology.clear();
+  }
+
+  template <typename CachedWaypoint>
+  bool InMemoryMap::SetUpCachedWaypoints(const std::vector<CachedWaypoint> &cached_waypoints,
+                                         NodeList &dense_topology) {
+    Clear();
+    dense_topology.clear();
+    dense_topology.resize(cached_waypoints.size());
+
+    // Resolving a waypoint computes its transform on the road geometry, which
+    // is most of the load time. Every waypoint is independent, so each range
+    // fills its own part of dense_topology.
+    auto set_up_range = [this, &cached_waypoints, &dense_topology](const size_t begin, const size_t end) {
+      for (size_t i = begin; i < end; ++i) {
+        const CachedWaypoint &cached_wp = cached_waypoints[i];
+        WaypointPtr waypoint_ptr = GetCachedWaypoint(_world_map, cached_wp);
+        if (waypoint_ptr == nullptr) {
+          continue;
+        }
+        SimpleWaypointPtr wp = std::make_shared<SimpleWaypoint>(waypoint_ptr);
+        wp->SetGeodesicGridId(cached_wp.geodesic_grid_id);
+        wp->SetIsJunction(static_cast<bool>(cached_wp.is_junction));
+        wp->SetRoadOption(static_cast<RoadOption>(cached_wp.road_option));
+        dense_topology[i] = std::move(wp);
+      }
+    };
+
+    constexpr size_t waypoints_per_task = 4096u;
+    ThreadPool::GetShared().ParallelFor(cached_waypoints.size(), waypoints_per_task, set_up_range);
+
+    if (std::find(dense_topology.begin(), dense_topology.end(), nullptr) != dense_topology.end()) {
+      dense_topology.clear();
+      return false;
+    }
+    return true;
+  }
+
   void InMemoryMap::Cook(WorldMap world_map, const std::string& path) {
     InMemoryMap local_map(world_map);
     local_map.SetUp();
@@ -75,6 +132,11 @@ namespace traffic_manager {
   }
 
   void InMemoryMap::Save(const std::string& path) {
+    if (!cooked_map::IsLittleEndianHost()) {
+      log_error("Could not generate the binary file. Cooked maps are only supported on little-endian hosts");
+      return;
+    }
+
     std::string filename;
     if (path.empty()) {
       filename = this->GetMapName() + ".bin";
@@ -89,49 +151,227 @@ namespace traffic_manager {
       return;
     }
 
-    // write total records
-    uint32_t total = static_cast<uint32_t>(dense_topology.size());
-    out_file.write(reinterpret_cast<const char *>(&total), sizeof(uint32_t));
-
-    // write simple waypoints
+    namespace cm = cooked_map;
+
+    // Sections are laid out one after the other, aligned to 8 bytes.
+    const uint64_t total = waypoint_graph.Size();
+    cm::Header header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, cm::MAGIC, sizeof(cm::MAGIC));
+    header.version = cm::VERSION;
+    header.header_size = sizeof(cm::Header);
+    header.waypoint_count = total;
+    for (uint64_t i = 0u; i < total; ++i) {
+      header.next_count += waypoint_graph.GetNext(static_cast<WaypointIndex>(i)).size();
+      header.previous_count += waypoint_graph.GetPrevious(static_cast<WaypointIndex>(i)).size();
+    }
+    header.waypoints_offset = cm::AlignOffset(sizeof(cm::Header));
+    header.next_offsets_offset = cm::AlignOffset(header.waypoints_offset + total * sizeof(WaypointRecord));
+    header.next_indices_offset = cm::AlignOffset(header.next_offsets_offset + (total + 1u) * sizeof(uint32_t));
+    header.previous_offsets_offset = cm::AlignOffset(header.next_indices_offset + header.next_count * sizeof(uint32_t));
+    header.previous_indices_offset = cm::AlignOffset(header.previous_offsets_offset + (total + 1u) * sizeof(uint32_t));
+    header.tree_node_count = spatial_tree.GetNodes().size();
+    header.tree_leaf_count = spatial_tree.GetLeafCount();
+    header.tree_nodes_offset = cm::AlignOffset(header.previous_indices_offset + header.previous_count * sizeof(uint32_t));
+    header.tree_items_offset = cm::AlignOffset(header.tree_nodes_offset + header.tree_node_count * sizeof(SpatialTreeNode));
+
+    std::vector<uint8_t> content(header.tree_items_offset + total * sizeof(SpatialTreeItem), 0u);
+    std::memcpy(content.data(), &header, sizeof(header));
+
+    uint32_t next_offset = 0u;
+    uint32_t previous_offset = 0u;
     std::unordered_set<uint64_t> used_ids;
-    for (auto& wp: dense_topology) {
-      if (used_ids.find(wp->GetId()) != used_ids.end()) {
+    for (uint64_t i = 0u; i < total; ++i) {
+      const WaypointIndex index = static_cast<WaypointIndex>(i);
+      const WaypointRecord &record = waypoint_graph.GetRecord(index);
+      if (!used_ids.insert(record.id).second) {
         log_error("Could not generate the binary file. There are repeated waypoints");
       }
-      CachedSimpleWaypoint cached_wp(wp);
-      cached_wp.Write(out_file);
 
-      used_ids.insert(wp->GetId());
+      std::memcpy(&content[header.waypoints_offset + i * sizeof(WaypointRecord)], &record, sizeof(record));
+
+      std::memcpy(&content[header.next_offsets_offset + i * sizeof(uint32_t)], &next_offset, sizeof(uint32_t));
+      for (const WaypointIndex next : waypoint_graph.GetNext(index)) {
+        std::memcpy(&content[header.next_indices_offset + next_offset * sizeof(uint32_t)], &next, sizeof(uint32_t));
+        ++next_offset;
+      }
+      std::memcpy(&content[header.previous_offsets_offset + i * sizeof(uint32_t)], &previous_offset, sizeof(uint32_t));
+      for (const WaypointIndex previous : waypoint_graph.GetPrevious(index)) {
+        std::memcpy(&content[header.previous_indices_offset + previous_offset * sizeof(uint32_t)], &previous, sizeof(uint32_t));
+        ++previous_offset;
+      }
+    }
+    std::memcpy(&content[header.next_offsets_offset + total * sizeof(uint32_t)], &next_offset, sizeof(uint32_t));
+    std::memcpy(&content[header.previous_offsets_offset + total * sizeof(uint32_t)], &previous_offset, sizeof(uint32_t));
+
+    const auto &tree_nodes = spatial_tree.GetNodes();
+    const auto &tree_items = spatial_tree.GetItems();
+    if (!tree_nodes.empty()) {
+      std::memcpy(&content[header.tree_nodes_offset], tree_nodes.data(), tree_nodes.size() * sizeof(SpatialTreeNode));
+      std::memcpy(&content[header.tree_items_offset], tree_items.data(), tree_items.size() * sizeof(SpatialTreeItem));
     }
 
+    out_file.write(reinterpret_cast<const char *>(content.data()), static_cast<std::streamsize>(content.size()));
     out_file.close();
     return;
   }
 
+  bool InMemoryMap::Load(const std::string& filename) {
+    namespace bip = boost::interprocess;
+    try {
+      // The file is mapped read-only, so the pages are shared between every
+      // process loading the same map.
+      bip::file_mapping mapping(filename.c_str(), bip::read_only);
+      auto region = std::make_shared<bip::mapped_region>(mapping, bip::read_only);
+      const uint8_t *data = static_cast<const uint8_t *>(region->get_address());
+      const std::size_t size = region->get_size();
+      if (cooked_map::IsCookedMap(data, size)) {
+        return LoadCooked(std::move(region), data, size);
+      }
+      return Load(std::vector<uint8_t>(data, data + size));
+    } catch (const bip::interprocess_exception &e) {
+      log_warning("Could not map InMemoryMap cache file", filename, ":", e.what());
+      return false;
+    }
+  }
+
+  bool InMemoryMap::LoadCooked(std::shared_ptr<const void> holder, const uint8_t *data, const std::size_t size) {
+    namespace cm = cooked_map;
+
+    Clear();
+
+    if (!cm::IsLittleEndianHost()) {
+      log_warning("InMemoryMap cache files are only supported on little-endian hosts");
+      return false;
+    }
+
+    cm::Header header;
+    std::memcpy(&header, data, sizeof(header));
+    if (header.version != cm::VERSION || header.header_size != sizeof(cm::Header)) {
+      log_warning("Unsupported InMemoryMap cache version", header.version);
+      return false;
+    }
+
+    // The sections are read in place, so they must be within the file and
+    // aligned for their records.
+    const uint64_t total = header.waypoint_count;
+    auto section_fits = [data, size](uint64_t offset, uint64_t count, uint64_t element_size) {
+      return offset <= size && count <= (size - offset) / element_size
+          && cm::AlignOffset(reinterpret_cast<uintptr_t>(data) + offset) == reinterpret_cast<uintptr_t>(data) + offset;
+    };
+    if (total >= cm::INVALID_INDEX
+        || !section_fits(header.waypoints_offset, total, sizeof(WaypointRecord))
+        || !section_fits(header.next_offsets_offset, total + 1u, sizeof(uint32_t))
+        || !section_fits(header.next_indices_offset, header.next_count, sizeof(WaypointIndex))
+        || !section_fits(header.previous_offsets_offset, total + 1u, sizeof(uint32_t))
+        || !section_fits(header.previous_indices_offset, header.previous_count, sizeof(WaypointIndex))
+        || !section_fits(header.tree_nodes_offset, header.tree_node_count, sizeof(SpatialTreeNode))
+        || !section_fits(header.tree_items_offset, total, sizeof(SpatialTreeItem))) {
+      log_warning("Corrupted InMemoryMap cache file");
+      return false;
+    }
+
+    auto section = [data](uint64_t offset) {
+      return data + offset;
+    };
+    const WaypointRecord *records = reinterpret_cast<const WaypointRecord *>(section(header.waypoints_offset));
+    const uint32_t *next_offsets = reinterpret_cast<const uint32_t *>(section(header.next_offsets_offset));
+    const WaypointIndex *next_indices = reinterpret_cast<const WaypointIndex *>(section(header.next_indices_offset));
+    const uint32_t *previous_offsets = reinterpret_cast<const uint32_t *>(section(header.previous_offsets_offset));
+    const WaypointIndex *previous_indices = reinterpret_cast<const WaypointIndex *>(section(header.previous_indices_offset));
+    const SpatialTreeNode *tree_nodes = reinterpret_cast<const SpatialTreeNode *>(section(header.tree_nodes_offset));
+    const SpatialTreeItem *tree_items = reinterpret_cast<const SpatialTreeItem *>(section(header.tree_items_offset));
+
+    auto links_are_valid = [total](const uint32_t *offsets, const WaypointIndex *indices, uint64_t count) {
+      if (offsets[0] != 0u || offsets[total] != count) {
+        return false;
+      }
+      for (uint64_t i = 0u; i < total; ++i) {
+        if (offsets[i] > offsets[i + 1u]) {
+          return false;
+        }
+      }
+      for (uint64_t i = 0u; i < count; ++i) {
+        if (indices[i] >= total) {
+          return false;
+        }
+      }
+      return true;
+    };
+    auto lane_change_is_valid = [total](WaypointIndex index) {
+      return index == INVALID_WAYPOINT_INDEX || index < total;
+    };
+    if (!links_are_valid(next_offsets, next_indices, header.next_count)
+        || !links_are_valid(previous_offsets, previous_indices, header.previous_count)) {
+      log_warning("Corrupted InMemoryMap cache file");
+      return false;
+    }
+    for (uint64_t i = 0u; i < total; ++i) {
+      if (!lane_change_is_valid(records[i].left) || !lane_change_is_valid(records[i].right)
+          || tree_items[i].index >= total) {
+        log_warning("Corrupted InMemoryMap cache file");
+        return false;
+      }
+    }
+
+    // Only checks the OpenDRIVE position of every waypoint exists, computing
+    // its transform is left until the waypoint is requested.
+    const crd::Map &road_map = _world_map->GetMap();
+    for (uint64_t i = 0u; i < total; ++i) {
+      const WaypointRecord &record = records[i];
+      if (!road_map.GetWaypoint(record.road_id, record.section_id, record.lane_id, record.s).has_value()) {
+        log_warning("Corrupted InMemoryMap cache file: waypoint out of the map");
+        return false;
+      }
+    }
+
+    if (!spatial_tree.Attach(tree_nodes, header.tree_node_count, header.tree_leaf_count, tree_items, total)) {
+      log_warning("Corrupted InMemoryMap cache file");
+      return false;
+    }
+    waypoint_graph.Attach(records, total,
+                          next_offsets, next_indices, header.next_count,
+                          previous_offsets, previous_indices, header.previous_count);
+    open_drive_waypoints.resize(total);
+    cooked_data = std::move(holder);
+
+    return true;
+  }
+
   bool InMemoryMap::Load(const std::vector<uint8_t>& content) {
+    if (cooked_map::IsCookedMap(content.data(), content.size())) {
+      auto copy = std::make_shared<std::vector<uint8_t>>(content);
+      return LoadCooked(copy, copy->data(), copy->size());
+    }
+
+    // Files cooked before the versioned format only hold the waypoint records.
     unsigned long pos = 0;
     std::vector<CachedSimpleWaypoint> cached_waypoints;
     std::unordered_map<uint64_t, uint32_t> id2index;
 
     // read total records
     uint32_t total;
+    if (content.size() < sizeof(total)) {
+      log_warning("Corrupted InMemoryMap cache file");
+      return false;
+    }
     memcpy(&total, &content[pos], sizeof(total));
     pos += sizeof(total);
 
     // read simple waypoints
+    cached_waypoints.reserve(total);
     for (uint32_t i=0; i < total; i++) {
       CachedSimpleWaypoint cached_wp;
       cached_wp.Read(content, pos);
       cached_waypoints.push_back(cached_wp);
-      id2index.insert({cached_wp.waypoint_id, i});
-
-      WaypointPtr waypoint_ptr = _world_map->GetWaypointXODR(cached_wp.road_id, cached_wp.lane_id, cached_wp.s);
-      SimpleWaypointPtr wp = std::make_shared<SimpleWaypoint>(waypoint_ptr);
-      wp->SetGeodesicGridId(cached_wp.geodesic_grid_id);
-      wp->SetIsJunction(cached_wp.is_junction);
-      wp->SetRoadOption(static_cast<RoadOption>(cached_wp.road_option));
-      dense_topology.push_back(wp);
+      if (!id2index.insert({cached_wp.waypoint_id, i}).second) {
+        log_warning("InMemoryMap cache file with repeated waypoints");
+      }
+    }
+    NodeList dense_topology;
+    if (!SetUpCachedWaypoints(cached_waypoints, dense_topology)) {
+      log_warning("Corrupted InMemoryMap cache file: waypoint out of the map");
+      return false;
     }
 
     // connect waypoints
@@ -158,13 +398,23 @@ namespace traffic_manager {
     }
 
     // create spatial tree
-    SetUpSpatialTree();
+    SetUpSpatialTree(dense_topology);
+    SetUpWaypointGraph(dense_topology);
 
     return true;
   }
 
+  void InMemoryMap::Clear() {
+    waypoint_graph.Clear();
+    spatial_tree.Clear();
+    open_drive_waypoints.clear();
+    cooked_data.reset();
+  }
+
   void InMemoryMap::SetUp() {
 
+    Clear();
+
     // 1. Building segment topology (i.e., defining set of segment predecessors and successors)
     assert(_world_map != nullptr && "No map reference found.");
     auto waypoint_topology = _world_map->GetTopology();
@@ -227,6 +477,7 @@ namespace traffic_manager {
     }
 
     // 2. Consuming the raw dense topology from cc::Map into SimpleWaypoints.
+    NodeList dense_topology;
     SegmentMap segment_map;
     assert(_world_map != nullptr && "No map reference found.");
     auto raw_dense_topology = _world_map->GenerateWaypoints(MAP_RESOLUTION);
@@ -323,7 +574,7 @@ namespace traffic_manager {
       }
     }
 
-    SetUpSpatialTree();
+    SetUpSpatialTree(dense_topology);
 
     // Placing inter-segment connections.
     for (auto &segment : segment_map) {
@@ -340,7 +591,7 @@ namespace traffic_manager {
     // Linking lane change connections.
     for (auto &swp : dense_topology) {
       if (!swp->CheckJunction()) {
-        FindAndLinkLaneChange(swp);
+        FindAndLinkLaneChange(dense_topology, swp);
       }
     }
 
@@ -362,20 +613,32 @@ namespace traffic_manager {
     }
 
     // Specifying a RoadOption for each SimpleWaypoint
-    SetUpRoadOption();
+    SetUpRoadOption(dense_topology);
+
+    SetUpWaypointGraph(dense_topology);
   }
 
-  void InMemoryMap::SetUpSpatialTree() {
-    for (auto &simple_waypoint: dense_topology) {
-      if (simple_waypoint != nullptr) {
-        const cg::Location loc = simple_waypoint->GetLocation();
-        Point3D point(loc.x, loc.y, loc.z);
-        rtree.insert(std::make_pair(point, simple_waypoint));
-      }
+  void InMemoryMap::SetUpSpatialTree(const NodeList &dense_topology) {
+    std::vector<SpatialTreeItem> items;
+    items.reserve(dense_topology.size());
+    for (std::size_t i = 0u; i < dense_topology.size(); ++i) {
+      items.push_back({dense_topology[i]->GetLocation(), static_cast<WaypointIndex>(i)});
     }
+    spatial_tree.Build(std::move(items));
   }
 
-  void InMemoryMap::SetUpRoadOption() {
+  void InMemoryMap::SetUpWaypointGraph(NodeList &dense_topology) {
+    waypoint_graph.Build(dense_topology);
+    open_drive_waypoints.clear();
+    open_drive_waypoints.reserve(dense_topology.size());
+    for (const SimpleWaypointPtr &swp : dense_topology) {
+      open_drive_waypoints.push_back(swp->GetWaypoint());
+    }
+    // The traffic manager only walks the graph from now on.
+    ReleaseTopology(dense_topology);
+  }
+
+  void InMemoryMap::SetUpRoadOption(const NodeList &dense_topology) {
     for (auto &swp : dense_topology) {
       std::vector<SimpleWaypointPtr> next_waypoints = swp->GetNextWaypoint();
       std::size_t next_swp_size = next_waypoints.size();
@@ -464,52 +727,52 @@ namespace traffic_manager {
     }
   }
 
-  SimpleWaypointPtr InMemoryMap::GetWaypoint(const cg::Location loc) const {
-
-    Point3D query_point(loc.x, loc.y, loc.z);
-    std::vector<SpatialTreeEntry> result_1;
-
-    rtree.query(bgi::nearest(query_point, 1), std::back_inserter(result_1));
-
-    SpatialTreeEntry &closest_entry = result_1.front();
-    SimpleWaypointPtr &closest_point = closest_entry.second;
-
-    return closest_point;
+  WaypointIndex InMemoryMap::GetWaypoint(const cg::Location loc) const {
+    return spatial_tree.Nearest(loc);
   }
 
-  NodeList InMemoryMap::GetWaypointsInDelta(const cg::Location loc, const uint16_t n_points, const float random_sample) const {
-    Point3D query_point(loc.x, loc.y, loc.z);
-
-    Point3D lower_p1(loc.x + random_sample, loc.y + random_sample, loc.z + Z_DELTA);
-    Point3D lower_p2(loc.x - random_sample, loc.y - random_sample, loc.z - Z_DELTA);
-    Point3D upper_p1(loc.x + random_sample + DELTA, loc.y + random_sample + DELTA, loc.z + Z_DELTA);
-    Point3D upper_p2(loc.x - random_sample - DELTA, loc.y - random_sample - DELTA, loc.z - Z_DELTA);
+  std::vector<WaypointIndex> InMemoryMap::GetWaypointsInDelta(const cg::Location loc, const uint16_t n_points, const float random_sample) const {
+    const cg::Location lower_p1(loc.x + random_sample, loc.y + random_sample, loc.z + Z_DELTA);
+    const cg::Location lower_p2(loc.x - random_sample, loc.y - random_sample, loc.z - Z_DELTA);
+    const cg::Location upper_p1(loc.x + random_sample + DELTA, loc.y + random_sample + DELTA, loc.z + Z_DELTA);
+    const cg::Location upper_p2(loc.x - random_sample - DELTA, loc.y - random_sample - DELTA, loc.z - Z_DELTA);
 
-    Box lower_query_box(lower_p2, lower_p1);
-    Box upper_query_box(upper_p2, upper_p1);
+    auto within_lower_box = [&](const cg::Location &l) {
+      return l.x > lower_p2.x && l.x < lower_p1.x
+          && l.y > lower_p2.y && l.y < lower_p1.y
+          && l.z > lower_p2.z && l.z < lower_p1.z;
+    };
 
-    NodeList result;
-    uint8_t x = 0;
-    for (Rtree::const_query_iterator
-        it = rtree.qbegin(bgi::within(upper_query_box)
-        && !bgi::within(lower_query_box)
-        && bgi::satisfies([&](SpatialTreeEntry const& v) { return !v.second->CheckJunction();}));
-        it != rtree.qend();
-        ++it) {
-    x++;
-    result.push_back(it->second);
-    if (x >= n_points)
-        break;
-    }
+    std::vector<WaypointIndex> result;
+    spatial_tree.Query(upper_p2, upper_p1, [&](const SpatialTreeItem &item) {
+      if (!within_lower_box(item.location) && !waypoint_graph.GetRecord(item.index).is_junction) {
+        result.push_back(item.index);
+      }
+      return result.size() < n_points;
+    });
 
     return result;
   }
 
-  NodeList InMemoryMap::GetDenseTopology() const {
-    return dense_topology;
+  const WaypointGraph &InMemoryMap::GetWaypointGraph() const {
+    return waypoint_graph;
+  }
+
+  WaypointPtr InMemoryMap::GetOpenDriveWaypoint(const WaypointIndex index) const {
+    // Stages ask for waypoints from several threads, so the cache is read and
+    // filled atomically. Two threads resolving the same waypoint get equal
+    // waypoints.
+    WaypointPtr &cached_waypoint = open_drive_waypoints.at(index);
+    WaypointPtr waypoint = boost::atomic_load(&cached_waypoint);
+    if (waypoint == nullptr) {
+      const WaypointRecord &record = waypoint_graph.GetRecord(index);
+      waypoint = _world_map->GetWaypointXODR(record.road_id, record.section_id, record.lane_id, record.s);
+      boost::atomic_store(&cached_waypoint, waypoint);
+    }
+    return waypoint;
   }
 
-  void InMemoryMap::FindAndLinkLaneChange(SimpleWaypointPtr reference_waypoint) {
+  void InMemoryMap::FindAndLinkLaneChange(const NodeList &dense_topology, SimpleWaypointPtr reference_waypoint) {
 
     const WaypointPtr raw_waypoint = reference_waypoint->GetWaypoint();
     const crd::element::LaneMarking::LaneChange lane_change = raw_waypoint->GetLaneChange();
@@ -525,7 +788,7 @@ namespace traffic_manager {
         left_waypoint->GetType() == crd::Lane::LaneType::Driving &&
         (left_waypoint->GetLaneId() * raw_waypoint->GetLaneId() > 0)) {
 
-          SimpleWaypointPtr closest_simple_waypoint = GetWaypoint(left_waypoint->GetTransform().location);
+          SimpleWaypointPtr closest_simple_waypoint = dense_topology[GetWaypoint(left_waypoint->GetTransform().location)];
           reference_waypoint->SetLeftWaypoint(closest_simple_waypoint);
         }
       }
@@ -539,7 +802,7 @@ namespace traffic_manager {
 	    right_waypoint->GetType() == crd::Lane::LaneType::Driving &&
 	    (right_waypoint->GetLaneId() * raw_waypoint->GetLaneId() > 0)) {
 
-	      SimpleWaypointPtr closest_simple_waypoint = GetWaypoint(right_waypoint->GetTransform().location);
+	      SimpleWaypointPtr closest_simple_waypoint = dense_topology[GetWaypoint(right_waypoint->GetTransform().location)];
 	      reference_waypoint->SetRightWaypoint(closest_simple_waypoint);
 	    }
       }
@@ -554,7 +817,7 @@ namespace traffic_manager {
         right_waypoint->GetType() == crd::Lane::LaneType::Driving &&
         (right_waypoint->GetLaneId() * raw_waypoint->GetLaneId() > 0)) {
 
-          SimpleWaypointPtr closest_simple_waypointR = GetWaypoint(right_waypoint->GetTransform().location);
+          SimpleWaypointPtr closest_simple_waypointR = dense_topology[GetWaypoint(right_waypoint->GetTransform().location)];
           reference_waypoint->SetRightWaypoint(closest_simple_waypointR);
         }
 
@@ -564,7 +827,7 @@ namespace traffic_manager {
         left_waypoint->GetType() == crd::Lane::LaneType::Driving &&
         (left_waypoint->GetLaneId() * raw_waypoint->GetLaneId() > 0)) {
 
-          SimpleWaypointPtr closest_simple_waypointL = GetWaypoint(left_waypoint->GetTransform().location);
+          SimpleWaypointPtr closest_simple_waypointL = dense_topology[GetWaypoint(left_waypoint->GetTransform().location)];
           reference_waypoint->SetLeftWaypoint(closest_simple_waypointL);
         }
       }
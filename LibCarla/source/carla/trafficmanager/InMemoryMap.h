@@ -11,17 +11,6 @@
 #include <unordered_map>
 #include <unordered_set>
 
-#if defined(__clang__)
-#  pragma clang diagnostic push
-#  pragma clang diagnostic ignored "-Wshadow"
-#endif
-#include "boost/geometry.hpp"
-#include "boost/geometry/geometries/point.hpp"
-#include "boost/geometry/index/rtree.hpp"
-#if defined(__clang__)
-#  pragma clang diagnostic pop
-#endif
-
 #include "carla/client/Map.h"
 #include "carla/client/Waypoint.h"
 #include "carla/geom/Location.h"
@@ -32,6 +21,8 @@
 #include "carla/trafficmanager/RandomGenerator.h"
 #include "carla/trafficmanager/SimpleWaypoint.h"
 #include "carla/trafficmanager/CachedSimpleWaypoint.h"
+#include "carla/trafficmanager/SpatialTree.h"
+#include "carla/trafficmanager/WaypointGraph.h"
 
 namespace carla {
 namespace traffic_manager {
@@ -39,8 +30,6 @@ namespace traffic_manager {
 namespace cg = carla::geom;
 namespace cc = carla::client;
 namespace crd = carla::road;
-namespace bg = boost::geometry;
-namespace bgi = boost::geometry::index;
 
   using WaypointPtr = carla::SharedPtr<cc::Waypoint>;
   using SimpleWaypointPtr = std::shared_ptr<SimpleWaypoint>;
@@ -48,14 +37,9 @@ namespace bgi = boost::geometry::index;
   using GeoGridId = crd::JuncId;
   using WorldMap = carla::SharedPtr<const cc::Map>;
 
-  using Point3D = bg::model::point<float, 3, bg::cs::cartesian>;
-  using Box = bg::model::box<Point3D>;
-  using SpatialTreeEntry = std::pair<Point3D, SimpleWaypointPtr>;
-
   using SegmentId = std::tuple<crd::RoadId, crd::LaneId, crd::SectionId>;
   using SegmentTopology = std::map<SegmentId, std::pair<std::vector<SegmentId>, std::vector<SegmentId>>>;
   using SegmentMap = std::map<SegmentId, std::vector<SimpleWaypointPtr>>;
-  using Rtree = bgi::rtree<SpatialTreeEntry, bgi::rstar<16>>;
 
   /// This class builds a discretized local map-cache.
   /// Instantiate the class with the world and run SetUp() to construct the
@@ -66,11 +50,18 @@ namespace bgi = boost::geometry::index;
 
     /// Object to hold the world map received by the constructor.
     WorldMap _world_map;
-    /// Structure to hold all custom waypoint objects after interpolation of
-    /// sparse topology.
-    NodeList dense_topology;
-    /// Spatial quadratic R-tree for indexing and querying waypoints.
-    Rtree rtree;
+    /// Packed R-tree for indexing and querying waypoints.
+    SpatialTree spatial_tree;
+
+    /// Discrete samples of the map after interpolation of the sparse
+    /// topology, with their connectivity.
+    WaypointGraph waypoint_graph;
+    /// OpenDRIVE waypoint of every waypoint of the graph. Waypoints of a
+    /// cooked map are resolved the first time they are requested.
+    mutable std::vector<WaypointPtr> open_drive_waypoints;
+    /// Cooked map the waypoint graph and the spatial tree are attached to,
+    /// kept for as long as they are in use.
+    std::shared_ptr<const void> cooked_data;
 
   public:
 
@@ -79,20 +70,28 @@ namespace bgi = boost::geometry::index;
 
     static void Cook(WorldMap world_map, const std::string& path);
 
-    //bool Load(const std::string& filename);
+    /// Loads a cooked map from a file. The file stays mapped in memory for
+    /// the lifetime of the local map, which reads the waypoints from it.
+    bool Load(const std::string& filename);
+    /// Loads a cooked map from a copy of @a content.
     bool Load(const std::vector<uint8_t>& content);
 
     /// This method constructs the local map with a resolution of sampling_resolution.
     void SetUp();
 
-    /// This method returns the closest waypoint to a given location on the map.
-    SimpleWaypointPtr GetWaypoint(const cg::Location loc) const;
+    /// This method returns the index of the closest waypoint to a given
+    /// location on the map, or INVALID_WAYPOINT_INDEX if the map is empty.
+    WaypointIndex GetWaypoint(const cg::Location loc) const;
 
     /// This method returns n waypoints in an delta area with a certain distance from the ego vehicle.
-    NodeList GetWaypointsInDelta(const cg::Location loc, const uint16_t n_points, const float random_sample) const;
+    std::vector<WaypointIndex> GetWaypointsInDelta(const cg::Location loc, const uint16_t n_points, const float random_sample) const;
 
-    /// This method returns the full list of discrete samples of the map in the local cache.
-    NodeList GetDenseTopology() const;
+    /// This method returns the discrete samples of the map in the local cache.
+    const WaypointGraph &GetWaypointGraph() const;
+
+    /// This method returns the OpenDRIVE waypoint of the given waypoint of the
+    /// graph. It is safe to call from several threads.
+    WaypointPtr GetOpenDriveWaypoint(const WaypointIndex index) const;
 
     std::string GetMapName();
 
@@ -101,12 +100,29 @@ namespace bgi = boost::geometry::index;
   private:
     void Save(const std::string& path);
 
-    void SetUpDenseTopology();
-    void SetUpSpatialTree();
-    void SetUpRoadOption();
+    /// This method attaches the waypoint graph and the spatial tree to the
+    /// cooked map at @a data, which @a holder keeps alive.
+    bool LoadCooked(std::shared_ptr<const void> holder, const uint8_t *data, const std::size_t size);
+
+    /// This method empties the local map, releasing the cooked map if any.
+    void Clear();
+
+    /// This method fills dense_topology with a waypoint per cached record,
+    /// resolving their OpenDRIVE coordinates in parallel. Returns false if
+    /// any of them is not on the map.
+    template <typename CachedWaypoint>
+    bool SetUpCachedWaypoints(const std::vector<CachedWaypoint> &cached_waypoints,
+                              NodeList &dense_topology);
+
+    void SetUpSpatialTree(const NodeList &dense_topology);
+    void SetUpRoadOption(const NodeList &dense_topology);
+
+    /// This method builds the waypoint graph out of the linked dense
+    /// topology, which is released afterwards.
+    void SetUpWaypointGraph(NodeList &dense_topology);
 
     /// This method is used to find and place lane change links.
-    void FindAndLinkLaneChange(SimpleWaypointPtr reference_waypoint);
+    void FindAndLinkLaneChange(const NodeList &dense_topology, SimpleWaypointPtr reference_waypoint);
 
     NodeList GetSuccessors(const SegmentId segment_id,
                           const SegmentTopology &segment_topology,
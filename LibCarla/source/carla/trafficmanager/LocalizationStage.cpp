@@ -22,7 +22,7 @@ LocalizationStage::LocalizationStage(
   Parameters &parameters,
   std::vector<ActorId>& marked_for_removal,
   LocalizationFrame &output_array,
-  RandomGenerator &random_device)
+  VehicleRandomGenerators &random_devices)
     : vehicle_id_list(vehicle_id_list),
     buffer_map(buffer_map),
     simulation_state(simulation_state),
@@ -31,14 +31,62 @@ LocalizationStage::LocalizationStage(
     parameters(parameters),
     marked_for_removal(marked_for_removal),
     output_array(output_array),
-    random_device(random_device){}
+    random_devices(random_devices){}
+
+void LocalizationStage::PrepareCycle(const std::size_t number_of_workers) {
+  parallel_cycle = number_of_workers > 1u;
+
+  // Buffers are created before the update, so workers do not insert into the buffer map.
+  for (const ActorId actor_id : vehicle_id_list) {
+    if (buffer_map.find(actor_id) == buffer_map.end()) {
+      buffer_map.insert({actor_id, Buffer()});
+    }
+  }
+
+  buffer_fronts.clear();
+  if (parallel_cycle) {
+    for (const auto &buffer_entry : buffer_map) {
+      if (!buffer_entry.second.empty()) {
+        buffer_fronts.insert({buffer_entry.first, buffer_entry.second.front()});
+      }
+    }
+    track_traffic.DeferUpdates();
+  }
+}
+
+void LocalizationStage::FinishCycle() {
+  if (parallel_cycle) {
+    track_traffic.CommitUpdates();
+  }
+  buffer_fronts.clear();
+  parallel_cycle = false;
+}
+
+WaypointIndex LocalizationStage::GetBufferFront(const ActorId actor_id) const {
+  if (parallel_cycle) {
+    auto front_iter = buffer_fronts.find(actor_id);
+    return front_iter != buffer_fronts.end() ? front_iter->second : INVALID_WAYPOINT_INDEX;
+  }
+  auto buffer_iter = buffer_map.find(actor_id);
+  if (buffer_iter == buffer_map.end() || buffer_iter->second.empty()) {
+    return INVALID_WAYPOINT_INDEX;
+  }
+  return buffer_iter->second.front();
+}
+
+void LocalizationStage::MarkForRemoval(const ActorId actor_id) {
+  std::lock_guard<std::mutex> lock(marked_for_removal_mutex);
+  marked_for_removal.push_back(actor_id);
+}
 
 void LocalizationStage::Update(const unsigned long index) {
 
   const ActorId actor_id = vehicle_id_list.at(index);
-  const cg::Location vehicle_location = simulation_state.GetLocation(actor_id);
-  const cg::Vector3D heading_vector = simulation_state.GetHeading(actor_id);
-  const cg::Vector3D vehicle_velocity_vector = simulation_state.GetVelocity(actor_id);
+  RandomGenerator &random_device = random_devices.Get(index);
+  const std::size_t slot = simulation_state.GetSlot(actor_id);
+  const cg::Location vehicle_location = simulation_state.GetLocationArray().at(slot);
+  const cg::Vector3D heading_vector = simulation_state.GetHeadingArray()[slot];
+  const cg::Vector3D vehicle_velocity_vector = simulation_state.GetVelocityArray()[slot];
   const float vehicle_speed = vehicle_velocity_vector.Length();
 
   // Speed dependent waypoint horizon length.
@@ -48,14 +96,12 @@ void LocalizationStage::Update(const unsigned long index) {
   }
   const float horizon_square = SQUARE(horizon_length);
 
-  if (buffer_map.find(actor_id) == buffer_map.end()) {
-    buffer_map.insert({actor_id, Buffer()});
-  }
+  const WaypointGraph &waypoint_graph = local_map->GetWaypointGraph();
   Buffer &waypoint_buffer = buffer_map.at(actor_id);
 
   // Clear buffer if vehicle is too far from the first waypoint in the buffer.
   if (!waypoint_buffer.empty() &&
-      cg::Math::DistanceSquared(waypoint_buffer.front()->GetLocation(),
+      cg::Math::DistanceSquared(waypoint_graph.GetLocation(waypoint_buffer.front()),
                                 vehicle_location) > SQUARE(MAX_START_DISTANCE)) {
 
     auto number_of_pops = waypoint_buffer.size();
@@ -67,24 +113,24 @@ void LocalizationStage::Update(const unsigned long index) {
   bool is_at_junction_entrance = false;
   if (!waypoint_buffer.empty()) {
     // Purge passed waypoints.
-    float dot_product = DeviationDotProduct(vehicle_location, heading_vector, waypoint_buffer.front()->GetLocation());
+    float dot_product = DeviationDotProduct(vehicle_location, heading_vector, waypoint_graph.GetLocation(waypoint_buffer.front()));
     while (dot_product <= 0.0f && !waypoint_buffer.empty()) {
       PopWaypoint(actor_id, track_traffic, waypoint_buffer);
       if (!waypoint_buffer.empty()) {
-        dot_product = DeviationDotProduct(vehicle_location, heading_vector, waypoint_buffer.front()->GetLocation());
+        dot_product = DeviationDotProduct(vehicle_location, heading_vector, waypoint_graph.GetLocation(waypoint_buffer.front()));
       }
     }
 
     if (!waypoint_buffer.empty()) {
       // Determine if the vehicle is at the entrance of a junction.
-      SimpleWaypointPtr look_ahead_point = GetTargetWaypoint(waypoint_buffer, JUNCTION_LOOK_AHEAD).first;
-      SimpleWaypointPtr front_waypoint = waypoint_buffer.front();
-      bool front_waypoint_junction = front_waypoint->CheckJunction();
-      is_at_junction_entrance = !front_waypoint_junction && look_ahead_point->CheckJunction();
+      WaypointIndex look_ahead_point = GetTargetWaypoint(waypoint_graph, waypoint_buffer, JUNCTION_LOOK_AHEAD).first;
+      WaypointIndex front_waypoint = waypoint_buffer.front();
+      bool front_waypoint_junction = waypoint_graph.GetRecord(front_waypoint).is_junction;
+      is_at_junction_entrance = !front_waypoint_junction && waypoint_graph.GetRecord(look_ahead_point).is_junction;
       if (!is_at_junction_entrance) {
-        std::vector<SimpleWaypointPtr> last_passed_waypoints = front_waypoint->GetPreviousWaypoint();
+        const WaypointIndexRange last_passed_waypoints = waypoint_graph.GetPrevious(front_waypoint);
         if (last_passed_waypoints.size() == 1) {
-          is_at_junction_entrance = !last_passed_waypoints.front()->CheckJunction() && front_waypoint_junction;
+          is_at_junction_entrance = !waypoint_graph.GetRecord(last_passed_waypoints[0]).is_junction && front_waypoint_junction;
         }
       }
       if (is_at_junction_entrance
@@ -98,28 +144,29 @@ void LocalizationStage::Update(const unsigned long index) {
     // Purge waypoints too far from the front of the buffer, but not if it has reached a junction.
     while (!is_at_junction_entrance
            && !waypoint_buffer.empty()
-           && waypoint_buffer.back()->DistanceSquared(waypoint_buffer.front()) > horizon_square + horizon_square
-           && !waypoint_buffer.back()->CheckJunction()) {
+           && waypoint_graph.DistanceSquared(waypoint_buffer.back(), waypoint_buffer.front()) > horizon_square + horizon_square
+           && !waypoint_graph.GetRecord(waypoint_buffer.back()).is_junction) {
       PopWaypoint(actor_id, track_traffic, waypoint_buffer, false);
     }
   }
 
   // Initializing buffer if it is empty.
   if (waypoint_buffer.empty()) {
-    SimpleWaypointPtr closest_waypoint = local_map->GetWaypoint(vehicle_location);
+    WaypointIndex closest_waypoint = local_map->GetWaypoint(vehicle_location);
     PushWaypoint(actor_id, track_traffic, waypoint_buffer, closest_waypoint);
   }
 
   // Assign a lane change.
-  const ChangeLaneInfo lane_change_info = parameters.GetForceLaneChange(actor_id);
+  const VehicleParameters &vehicle_parameters = parameters.GetVehicleParameters(index);
+  const ChangeLaneInfo lane_change_info = vehicle_parameters.force_lane_change;
   bool force_lane_change = lane_change_info.change_lane;
   bool lane_change_direction = lane_change_info.direction;
 
   // Apply parameters for keep right rule and random lane changes.
   if (!force_lane_change && vehicle_speed > MIN_LANE_CHANGE_SPEED){
-    const float perc_keep_right = parameters.GetKeepRightPercentage(actor_id);
-    const float perc_random_leftlanechange = parameters.GetRandomLeftLaneChangePercentage(actor_id);
-    const float perc_random_rightlanechange = parameters.GetRandomRightLaneChangePercentage(actor_id);
+    const float perc_keep_right = vehicle_parameters.perc_keep_right;
+    const float perc_random_leftlanechange = vehicle_parameters.perc_random_left;
+    const float perc_random_rightlanechange = vehicle_parameters.perc_random_right;
     const bool is_keep_right = perc_keep_right > random_device.next();
     const bool is_random_left_change = perc_random_leftlanechange >= random_device.next();
     const bool is_random_right_change = perc_random_rightlanechange >= random_device.next();
@@ -140,32 +187,29 @@ void LocalizationStage::Update(const unsigned long index) {
     }
   }
 
-  const SimpleWaypointPtr front_waypoint = waypoint_buffer.front();
+  const WaypointIndex front_waypoint = waypoint_buffer.front();
   const float lane_change_distance = SQUARE(std::max(10.0f * vehicle_speed, INTER_LANE_CHANGE_DISTANCE));
 
-  bool recently_not_executed_lane_change = last_lane_change_swpt.find(actor_id) == last_lane_change_swpt.end();
+  const WaypointIndex *last_lane_change = last_lane_change_swpt.Find(actor_id);
+  bool recently_not_executed_lane_change = last_lane_change == nullptr;
   bool done_with_previous_lane_change = true;
   if (!recently_not_executed_lane_change) {
-    float distance_frm_previous = cg::Math::DistanceSquared(last_lane_change_swpt.at(actor_id)->GetLocation(), vehicle_location);
+    float distance_frm_previous = cg::Math::DistanceSquared(waypoint_graph.GetLocation(*last_lane_change), vehicle_location);
     done_with_previous_lane_change = distance_frm_previous > lane_change_distance;
-    if (done_with_previous_lane_change) last_lane_change_swpt.erase(actor_id);
+    if (done_with_previous_lane_change) last_lane_change_swpt.Erase(actor_id);
   }
-  bool auto_or_force_lane_change = parameters.GetAutoLaneChange(actor_id) || force_lane_change;
-  bool front_waypoint_not_junction = !front_waypoint->CheckJunction();
+  bool auto_or_force_lane_change = vehicle_parameters.auto_lane_change || force_lane_change;
+  bool front_waypoint_not_junction = !waypoint_graph.GetRecord(front_waypoint).is_junction;
 
   if (auto_or_force_lane_change
       && front_waypoint_not_junction
       && (recently_not_executed_lane_change || done_with_previous_lane_change)) {
 
-    SimpleWaypointPtr change_over_point = AssignLaneChange(actor_id, vehicle_location, vehicle_speed,
-                                                           force_lane_change, lane_change_direction);
+    WaypointIndex change_over_point = AssignLaneChange(actor_id, vehicle_location, vehicle_speed,
+                                                       force_lane_change, lane_change_direction);
 
-    if (change_over_point != nullptr) {
-      if (last_lane_change_swpt.find(actor_id) != last_lane_change_swpt.end()) {
-        last_lane_change_swpt.at(actor_id) = change_over_point;
-      } else {
-        last_lane_change_swpt.insert({actor_id, change_over_point});
-      }
+    if (change_over_point != INVALID_WAYPOINT_INDEX) {
+      last_lane_change_swpt.Set(actor_id, change_over_point);
       auto number_of_pops = waypoint_buffer.size();
       for (uint64_t j = 0u; j < number_of_pops; ++j) {
         PopWaypoint(actor_id, track_traffic, waypoint_buffer);
@@ -189,9 +233,10 @@ void LocalizationStage::Update(const unsigned long index) {
 
   // Populating the buffer through randomly chosen waypoints.
   else {
-    while (waypoint_buffer.back()->DistanceSquared(waypoint_buffer.front()) <= horizon_square) {
-      SimpleWaypointPtr furthest_waypoint = waypoint_buffer.back();
-      std::vector<SimpleWaypointPtr> next_waypoints = furthest_waypoint->GetNextWaypoint();
+    const WaypointIndex front_index = waypoint_buffer.front();
+    WaypointIndex furthest_index = waypoint_buffer.back();
+    while (waypoint_graph.DistanceSquared(furthest_index, front_index) <= horizon_square) {
+      const WaypointIndexRange next_waypoints = waypoint_graph.GetNext(furthest_index);
       uint64_t selection_index = 0u;
       // Pseudo-randomized path selection if found more than one choice.
       if (next_waypoints.size() > 1) {
@@ -201,15 +246,16 @@ void LocalizationStage::Update(const unsigned long index) {
         if (!parameters.GetOSMMode()) {
           std::cout << "This map has dead-end roads, please change the set_open_street_map parameter to true" << std::endl;
         }
-        marked_for_removal.push_back(actor_id);
+        MarkForRemoval(actor_id);
         break;
       }
-      SimpleWaypointPtr next_wp_selection = next_waypoints.at(selection_index);
+      const WaypointIndex next_wp_selection = next_waypoints[selection_index];
       PushWaypoint(actor_id, track_traffic, waypoint_buffer, next_wp_selection);
-      if (next_wp_selection->GetId() == waypoint_buffer.front()->GetId()){
+      if (next_wp_selection == front_index){
         // Found a loop, stop. Don't use zero distance as there can be two waypoints at the same location
         break;
       }
+      furthest_index = next_wp_selection;
     }
   }
   ExtendAndFindSafeSpace(actor_id, is_at_junction_entrance, waypoint_buffer);
@@ -219,47 +265,49 @@ void LocalizationStage::Update(const unsigned long index) {
   output.is_at_junction_entrance = is_at_junction_entrance;
 
   if (is_at_junction_entrance) {
-    const SimpleWaypointPair &safe_space_end_points = vehicles_at_junction_entrance.at(actor_id);
+    const WaypointIndexPair &safe_space_end_points = *vehicles_at_junction_entrance.Find(actor_id);
     output.junction_end_point = safe_space_end_points.first;
     output.safe_point = safe_space_end_points.second;
   } else {
-    output.junction_end_point = nullptr;
-    output.safe_point = nullptr;
+    output.junction_end_point = INVALID_WAYPOINT_INDEX;
+    output.safe_point = INVALID_WAYPOINT_INDEX;
   }
 
   // Updating geodesic grid position for actor.
-  track_traffic.UpdateGridPosition(actor_id, waypoint_buffer);
+  track_traffic.UpdateGridPosition(actor_id, waypoint_buffer, waypoint_graph);
 }
 
 void LocalizationStage::ExtendAndFindSafeSpace(const ActorId actor_id,
                                                const bool is_at_junction_entrance,
                                                Buffer &waypoint_buffer) {
 
-  SimpleWaypointPtr junction_end_point = nullptr;
-  SimpleWaypointPtr safe_point_after_junction = nullptr;
+  const WaypointGraph &waypoint_graph = local_map->GetWaypointGraph();
+  WaypointIndex junction_end_point = INVALID_WAYPOINT_INDEX;
+  WaypointIndex safe_point_after_junction = INVALID_WAYPOINT_INDEX;
 
   if (is_at_junction_entrance
-      && vehicles_at_junction_entrance.find(actor_id) == vehicles_at_junction_entrance.end()) {
+      && !vehicles_at_junction_entrance.Contains(actor_id)) {
 
     bool entered_junction = false;
     bool past_junction = false;
     bool safe_point_found = false;
-    SimpleWaypointPtr current_waypoint = nullptr;
-    SimpleWaypointPtr junction_begin_point = nullptr;
+    WaypointIndex current_waypoint = INVALID_WAYPOINT_INDEX;
+    WaypointIndex junction_begin_point = INVALID_WAYPOINT_INDEX;
     float safe_distance_squared = SQUARE(SAFE_DISTANCE_AFTER_JUNCTION);
 
     // Scanning existing buffer points.
     for (unsigned long i = 0u; i < waypoint_buffer.size() && !safe_point_found; ++i) {
-      current_waypoint = waypoint_buffer.at(i);
-      if (!entered_junction && current_waypoint->CheckJunction()) {
+      current_waypoint = waypoint_buffer[i];
+      const bool current_waypoint_junction = waypoint_graph.GetRecord(current_waypoint).is_junction;
+      if (!entered_junction && current_waypoint_junction) {
         entered_junction = true;
         junction_begin_point = current_waypoint;
       }
-      if (entered_junction && !past_junction && !current_waypoint->CheckJunction()) {
+      if (entered_junction && !past_junction && !current_waypoint_junction) {
         past_junction = true;
         junction_end_point = current_waypoint;
       }
-      if (past_junction && junction_end_point->DistanceSquared(current_waypoint) > safe_distance_squared) {
+      if (past_junction && waypoint_graph.DistanceSquared(junction_end_point, current_waypoint) > safe_distance_squared) {
         safe_point_found = true;
         safe_point_after_junction = current_waypoint;
       }
@@ -270,11 +318,11 @@ void LocalizationStage::ExtendAndFindSafeSpace(const ActorId actor_id,
       bool abort = false;
 
       while (!past_junction && !abort) {
-        NodeList next_waypoints = current_waypoint->GetNextWaypoint();
+        const WaypointIndexRange next_waypoints = waypoint_graph.GetNext(current_waypoint);
         if (!next_waypoints.empty()) {
-          current_waypoint = next_waypoints.front();
+          current_waypoint = next_waypoints[0];
           PushWaypoint(actor_id, track_traffic, waypoint_buffer, current_waypoint);
-          if (!current_waypoint->CheckJunction()) {
+          if (!waypoint_graph.GetRecord(current_waypoint).is_junction) {
             past_junction = true;
             junction_end_point = current_waypoint;
           }
@@ -284,16 +332,16 @@ void LocalizationStage::ExtendAndFindSafeSpace(const ActorId actor_id,
       }
 
       while (!safe_point_found && !abort) {
-        std::vector<SimpleWaypointPtr> next_waypoints = current_waypoint->GetNextWaypoint();
-        if ((junction_end_point->DistanceSquared(current_waypoint) > safe_distance_squared)
+        const WaypointIndexRange next_waypoints = waypoint_graph.GetNext(current_waypoint);
+        if ((waypoint_graph.DistanceSquared(junction_end_point, current_waypoint) > safe_distance_squared)
             || next_waypoints.size() > 1
-            || current_waypoint->CheckJunction()) {
+            || waypoint_graph.GetRecord(current_waypoint).is_junction) {
 
           safe_point_found = true;
           safe_point_after_junction = current_waypoint;
         } else {
           if (!next_waypoints.empty()) {
-            current_waypoint = next_waypoints.front();
+            current_waypoint = next_waypoints[0];
             PushWaypoint(actor_id, track_traffic, waypoint_buffer, current_waypoint);
           } else {
             abort = true;
@@ -302,51 +350,53 @@ void LocalizationStage::ExtendAndFindSafeSpace(const ActorId actor_id,
       }
     }
 
-    if (junction_end_point != nullptr &&
-        safe_point_after_junction != nullptr &&
-        junction_begin_point->DistanceSquared(junction_end_point) < SQUARE(MIN_JUNCTION_LENGTH)) {
+    if (junction_begin_point != INVALID_WAYPOINT_INDEX &&
+        junction_end_point != INVALID_WAYPOINT_INDEX &&
+        safe_point_after_junction != INVALID_WAYPOINT_INDEX &&
+        waypoint_graph.DistanceSquared(junction_begin_point, junction_end_point) < SQUARE(MIN_JUNCTION_LENGTH)) {
 
-      junction_end_point = nullptr;
-      safe_point_after_junction = nullptr;
+      junction_end_point = INVALID_WAYPOINT_INDEX;
+      safe_point_after_junction = INVALID_WAYPOINT_INDEX;
     }
 
-    vehicles_at_junction_entrance.insert({actor_id, {junction_end_point, safe_point_after_junction}});
+    vehicles_at_junction_entrance.Insert(actor_id, {junction_end_point, safe_point_after_junction});
   }
   else if (!is_at_junction_entrance
-           && vehicles_at_junction_entrance.find(actor_id) != vehicles_at_junction_entrance.end()) {
+           && vehicles_at_junction_entrance.Contains(actor_id)) {
 
-    vehicles_at_junction_entrance.erase(actor_id);
+    vehicles_at_junction_entrance.Erase(actor_id);
   }
 }
 
 void LocalizationStage::RemoveActor(ActorId actor_id) {
-    last_lane_change_swpt.erase(actor_id);
+    last_lane_change_swpt.Erase(actor_id);
     vehicles_at_junction.erase(actor_id);
 }
 
 void LocalizationStage::Reset() {
-  last_lane_change_swpt.clear();
+  last_lane_change_swpt.Clear();
   vehicles_at_junction.clear();
 }
 
-SimpleWaypointPtr LocalizationStage::AssignLaneChange(const ActorId actor_id,
-                                                      const cg::Location vehicle_location,
-                                                      const float vehicle_speed,
-                                                      bool force, bool direction) {
+WaypointIndex LocalizationStage::AssignLaneChange(const ActorId actor_id,
+                                                  const cg::Location vehicle_location,
+                                                  const float vehicle_speed,
+                                                  bool force, bool direction) {
 
   // Waypoint representing the new starting point for the waypoint buffer
-  // due to lane change. Remains nullptr if lane change not viable.
-  SimpleWaypointPtr change_over_point = nullptr;
+  // due to lane change. Remains invalid if lane change not viable.
+  WaypointIndex change_over_point = INVALID_WAYPOINT_INDEX;
 
   // Retrieve waypoint buffer for current vehicle.
+  const WaypointGraph &waypoint_graph = local_map->GetWaypointGraph();
   const Buffer &waypoint_buffer = buffer_map.at(actor_id);
 
   // Check buffer is not empty.
   if (!waypoint_buffer.empty()) {
     // Get the left and right waypoints for the current closest waypoint.
-    const SimpleWaypointPtr &current_waypoint = waypoint_buffer.front();
-    const SimpleWaypointPtr left_waypoint = current_waypoint->GetLeftWaypoint();
-    const SimpleWaypointPtr right_waypoint = current_waypoint->GetRightWaypoint();
+    const WaypointRecord &current_waypoint = waypoint_graph.GetRecord(waypoint_buffer.front());
+    const WaypointIndex left_waypoint = current_waypoint.left;
+    const WaypointIndex right_waypoint = current_waypoint.right;
 
     // Retrieve vehicles with overlapping waypoint buffers with current vehicle.
     const auto blocking_vehicles = track_traffic.GetOverlappingVehicles(actor_id);
@@ -360,24 +410,22 @@ SimpleWaypointPtr LocalizationStage::AssignLaneChange(const ActorId actor_id,
          ++i) {
       const ActorId &other_actor_id = *i;
       // Find vehicle in buffer map and check if it's buffer is not empty.
-      if (buffer_map.find(other_actor_id) != buffer_map.end() && !buffer_map.at(other_actor_id).empty()) {
-        const Buffer &other_buffer = buffer_map.at(other_actor_id);
-        const SimpleWaypointPtr &other_current_waypoint = other_buffer.front();
-        const cg::Location other_location = other_current_waypoint->GetLocation();
+      const WaypointIndex other_current_index = GetBufferFront(other_actor_id);
+      if (other_current_index != INVALID_WAYPOINT_INDEX) {
+        const WaypointRecord &other_current_waypoint = waypoint_graph.GetRecord(other_current_index);
+        const cg::Location other_location = other_current_waypoint.location;
 
-        const cg::Vector3D reference_heading = current_waypoint->GetForwardVector();
-        cg::Vector3D reference_to_other = other_location - current_waypoint->GetLocation();
-        const cg::Vector3D other_heading = other_current_waypoint->GetForwardVector();
+        const cg::Vector3D reference_heading = current_waypoint.forward_vector;
+        cg::Vector3D reference_to_other = other_location - current_waypoint.location;
+        const cg::Vector3D other_heading = other_current_waypoint.forward_vector;
 
-        WaypointPtr current_raw_waypoint = current_waypoint->GetWaypoint();
-        WaypointPtr other_current_raw_waypoint = other_current_waypoint->GetWaypoint();
         // Check both vehicles are not in junction,
         // Check if the other vehicle is in front of the current vehicle,
         // Check if the two vehicles have acceptable angular deviation between their headings.
-        if (!current_waypoint->CheckJunction()
-            && !other_current_waypoint->CheckJunction()
-            && other_current_raw_waypoint->GetRoadId() == current_raw_waypoint->GetRoadId()
-            && other_current_raw_waypoint->GetLaneId() == current_raw_waypoint->GetLaneId()
+        if (!current_waypoint.is_junction
+            && !other_current_waypoint.is_junction
+            && other_current_waypoint.road_id == current_waypoint.road_id
+            && other_current_waypoint.lane_id == current_waypoint.lane_id
             && cg::Math::Dot(reference_heading, reference_to_other) > 0.0f
             && cg::Math::Dot(reference_heading, other_heading) > MAXIMUM_LANE_OBSTACLE_CURVATURE) {
           float squared_distance = cg::Math::DistanceSquared(vehicle_location, other_location);
@@ -397,10 +445,9 @@ SimpleWaypointPtr LocalizationStage::AssignLaneChange(const ActorId actor_id,
 
     // If a valid immediate obstacle found.
     if (!obstacle_too_close && obstacle_actor_id != 0u && !force) {
-      const Buffer &other_buffer = buffer_map.at(obstacle_actor_id);
-      const SimpleWaypointPtr &other_current_waypoint = other_buffer.front();
-      const auto other_neighbouring_lanes = {other_current_waypoint->GetLeftWaypoint(),
-                                             other_current_waypoint->GetRightWaypoint()};
+      const WaypointRecord &other_current_waypoint = waypoint_graph.GetRecord(GetBufferFront(obstacle_actor_id));
+      const auto other_neighbouring_lanes = {other_current_waypoint.left,
+                                             other_current_waypoint.right};
 
       // Flags reflecting whether adjacent lanes are free near the obstacle.
       bool distant_left_lane_free = false;
@@ -409,8 +456,8 @@ SimpleWaypointPtr LocalizationStage::AssignLaneChange(const ActorId actor_id,
       // Check if the neighbouring lanes near the obstructing vehicle are free of other vehicles.
       bool left_right = true;
       for (auto &candidate_lane_wp : other_neighbouring_lanes) {
-        if (candidate_lane_wp != nullptr &&
-            track_traffic.GetPassingVehicles(candidate_lane_wp->GetId()).size() == 0) {
+        if (candidate_lane_wp != INVALID_WAYPOINT_INDEX &&
+            track_traffic.GetPassingVehicles(candidate_lane_wp).size() == 0) {
 
           if (left_right)
             distant_left_lane_free = true;
@@ -422,27 +469,31 @@ SimpleWaypointPtr LocalizationStage::AssignLaneChange(const ActorId actor_id,
 
       // Based on what lanes are free near the obstacle,
       // find the change over point with no vehicles passing through them.
-      if (distant_right_lane_free && right_waypoint != nullptr
-          && track_traffic.GetPassingVehicles(right_waypoint->GetId()).size() == 0) {
+      if (distant_right_lane_free && right_waypoint != INVALID_WAYPOINT_INDEX
+          && track_traffic.GetPassingVehicles(right_waypoint).size() == 0) {
         change_over_point = right_waypoint;
-      } else if (distant_left_lane_free && left_waypoint != nullptr
-               && track_traffic.GetPassingVehicles(left_waypoint->GetId()).size() == 0) {
+      } else if (distant_left_lane_free && left_waypoint != INVALID_WAYPOINT_INDEX
+               && track_traffic.GetPassingVehicles(left_waypoint).size() == 0) {
         change_over_point = left_waypoint;
       }
     } else if (force) {
-      if (direction && right_waypoint != nullptr) {
+      if (direction && right_waypoint != INVALID_WAYPOINT_INDEX) {
         change_over_point = right_waypoint;
-      } else if (!direction && left_waypoint != nullptr) {
+      } else if (!direction && left_waypoint != INVALID_WAYPOINT_INDEX) {
         change_over_point = left_waypoint;
       }
     }
 
-    if (change_over_point != nullptr) {
+    if (change_over_point != INVALID_WAYPOINT_INDEX) {
       const float change_over_distance = cg::Math::Clamp(1.5f * vehicle_speed, MIN_WPT_DISTANCE, MAX_WPT_DISTANCE);
-      const SimpleWaypointPtr starting_point = change_over_point;
-      while (change_over_point->DistanceSquared(starting_point) < SQUARE(change_over_distance) &&
-             !change_over_point->CheckJunction()) {
-        change_over_point = change_over_point->GetNextWaypoint().front();
+      const WaypointIndex starting_point = change_over_point;
+      while (waypoint_graph.DistanceSquared(change_over_point, starting_point) < SQUARE(change_over_distance) &&
+             !waypoint_graph.GetRecord(change_over_point).is_junction) {
+        const WaypointIndexRange next_waypoints = waypoint_graph.GetNext(change_over_point);
+        if (next_waypoints.empty()) {
+          break;
+        }
+        change_over_point = next_waypoints[0];
       }
     }
   }
@@ -462,39 +513,40 @@ void LocalizationStage::ImportPath(Path &imported_path, Buffer &waypoint_buffer,
     }
 
     // Get the latest imported waypoint. and find its closest waypoint in TM's InMemoryMap.
+    const WaypointGraph &waypoint_graph = local_map->GetWaypointGraph();
     cg::Location latest_imported = imported_path.front();
-    SimpleWaypointPtr imported = local_map->GetWaypoint(latest_imported);
+    WaypointIndex imported = local_map->GetWaypoint(latest_imported);
 
     // We need to generate a path compatible with TM's waypoints.
-    while (!imported_path.empty() && waypoint_buffer.back()->DistanceSquared(waypoint_buffer.front()) <= horizon_square) {
+    while (!imported_path.empty() && waypoint_graph.DistanceSquared(waypoint_buffer.back(), waypoint_buffer.front()) <= horizon_square) {
       // Get the latest point we added to the list. If starting, this will be the one referred to the vehicle's location.
-      SimpleWaypointPtr latest_waypoint = waypoint_buffer.back();
+      WaypointIndex latest_waypoint = waypoint_buffer.back();
 
       // Try to link the latest_waypoint to the imported waypoint.
-      std::vector<SimpleWaypointPtr> next_waypoints = latest_waypoint->GetNextWaypoint();
+      const WaypointIndexRange next_waypoints = waypoint_graph.GetNext(latest_waypoint);
       uint64_t selection_index = 0u;
 
       // Choose correct path.
       if (next_waypoints.size() > 1) {
-        const float imported_road_id = imported->GetWaypoint()->GetRoadId();
+        const float imported_road_id = waypoint_graph.GetRecord(imported).road_id;
         float min_distance = std::numeric_limits<float>::infinity();
         for (uint64_t k = 0u; k < next_waypoints.size(); ++k) {
-          SimpleWaypointPtr junction_end_point = next_waypoints.at(k);
-          while (!junction_end_point->CheckJunction()) {
-            junction_end_point = junction_end_point->GetNextWaypoint().front();
+          WaypointIndex junction_end_point = next_waypoints[k];
+          while (!waypoint_graph.GetRecord(junction_end_point).is_junction) {
+            junction_end_point = waypoint_graph.GetNext(junction_end_point)[0];
           }
-          while (junction_end_point->CheckJunction()) {
-            junction_end_point = junction_end_point->GetNextWaypoint().front();
+          while (waypoint_graph.GetRecord(junction_end_point).is_junction) {
+            junction_end_point = waypoint_graph.GetNext(junction_end_point)[0];
           }
-          while (next_waypoints.at(k)->DistanceSquared(junction_end_point) < 50.0f) {
-            junction_end_point = junction_end_point->GetNextWaypoint().front();
+          while (waypoint_graph.DistanceSquared(next_waypoints[k], junction_end_point) < 50.0f) {
+            junction_end_point = waypoint_graph.GetNext(junction_end_point)[0];
           }
-          float jep_road_id = junction_end_point->GetWaypoint()->GetRoadId();
+          float jep_road_id = waypoint_graph.GetRecord(junction_end_point).road_id;
           if (jep_road_id == imported_road_id) {
             selection_index = k;
             break;
           }
-          float distance = junction_end_point->DistanceSquared(imported);
+          float distance = waypoint_graph.DistanceSquared(junction_end_point, imported);
           if (distance < min_distance) {
             min_distance = distance;
             selection_index = k;
@@ -504,15 +556,15 @@ void LocalizationStage::ImportPath(Path &imported_path, Buffer &waypoint_buffer,
         if (!parameters.GetOSMMode()) {
           std::cout << "This map has dead-end roads, please change the set_open_street_map parameter to true" << std::endl;
         }
-        marked_for_removal.push_back(actor_id);
+        MarkForRemoval(actor_id);
         break;
       }
-      SimpleWaypointPtr next_wp_selection = next_waypoints.at(selection_index);
+      WaypointIndex next_wp_selection = next_waypoints[selection_index];
 
       // Remove the imported waypoint from the path if it's close to the last one.
-      if (next_wp_selection->DistanceSquared(imported) < 30.0f) {
+      if (waypoint_graph.DistanceSquared(next_wp_selection, imported) < 30.0f) {
         imported_path.erase(imported_path.begin());
-        std::vector<SimpleWaypointPtr> possible_waypoints = next_wp_selection->GetNextWaypoint();
+        const WaypointIndexRange possible_waypoints = waypoint_graph.GetNext(next_wp_selection);
         if (std::find(possible_waypoints.begin(), possible_waypoints.end(), imported) != possible_waypoints.end()) {
           // If the lane is changing, only push the new waypoint
           PushWaypoint(actor_id, track_traffic, waypoint_buffer, next_wp_selection);
@@ -544,17 +596,18 @@ void LocalizationStage::ImportRoute(Route &imported_actions, Buffer &waypoint_bu
       parameters.RemoveImportedRoute(actor_id, false);
     }
 
+    const WaypointGraph &waypoint_graph = local_map->GetWaypointGraph();
     RoadOption next_road_option = static_cast<RoadOption>(imported_actions.front());
-    while (!imported_actions.empty() && waypoint_buffer.back()->DistanceSquared(waypoint_buffer.front()) <= horizon_square) {
+    while (!imported_actions.empty() && waypoint_graph.DistanceSquared(waypoint_buffer.back(), waypoint_buffer.front()) <= horizon_square) {
       // Get the latest point we added to the list. If starting, this will be the one referred to the vehicle's location.
-      SimpleWaypointPtr latest_waypoint = waypoint_buffer.back();
-      RoadOption latest_road_option = latest_waypoint->GetRoadOption();
+      WaypointIndex latest_waypoint = waypoint_buffer.back();
+      RoadOption latest_road_option = waypoint_graph.GetRecord(latest_waypoint).road_option;
       // Try to link the latest_waypoint to the correct next RouteOption.
-      std::vector<SimpleWaypointPtr> next_waypoints = latest_waypoint->GetNextWaypoint();
+      const WaypointIndexRange next_waypoints = waypoint_graph.GetNext(latest_waypoint);
       uint16_t selection_index = 0u;
       if (next_waypoints.size() > 1) {
         for (uint16_t i=0; i<next_waypoints.size(); ++i) {
-          if (next_waypoints.at(i)->GetRoadOption() == next_road_option) {
+          if (waypoint_graph.GetRecord(next_waypoints[i]).road_option == next_road_option) {
             selection_index = i;
             break;
           } else {
@@ -567,15 +620,16 @@ void LocalizationStage::ImportRoute(Route &imported_actions, Buffer &waypoint_bu
         if (!parameters.GetOSMMode()) {
           std::cout << "This map has dead-end roads, please change the set_open_street_map parameter to true" << std::endl;
         }
-        marked_for_removal.push_back(actor_id);
+        MarkForRemoval(actor_id);
         break;
       }
 
-      SimpleWaypointPtr next_wp_selection = next_waypoints.at(selection_index);
+      WaypointIndex next_wp_selection = next_waypoints[selection_index];
       PushWaypoint(actor_id, track_traffic, waypoint_buffer, next_wp_selection);
 
       // If we are switching to a new RoadOption, it means the current one is already fully imported.
-      if (latest_road_option != next_wp_selection->GetRoadOption() && next_road_option == next_wp_selection->GetRoadOption()) {
+      const RoadOption next_wp_road_option = waypoint_graph.GetRecord(next_wp_selection).road_option;
+      if (latest_road_option != next_wp_road_option && next_road_option == next_wp_road_option) {
         imported_actions.erase(imported_actions.begin());
         next_road_option = static_cast<RoadOption>(imported_actions.front());
       }
@@ -590,32 +644,34 @@ void LocalizationStage::ImportRoute(Route &imported_actions, Buffer &waypoint_bu
 }
 
 Action LocalizationStage::ComputeNextAction(const ActorId& actor_id) {
+  const WaypointGraph &waypoint_graph = local_map->GetWaypointGraph();
   auto waypoint_buffer = buffer_map.at(actor_id);
-  auto next_action = std::make_pair(RoadOption::LaneFollow, waypoint_buffer.back()->GetWaypoint());
+  auto next_action = std::make_pair(RoadOption::LaneFollow, local_map->GetOpenDriveWaypoint(waypoint_buffer.back()));
   bool is_lane_change = false;
-  if (last_lane_change_swpt.find(actor_id) != last_lane_change_swpt.end()) {
+  const WaypointIndex *last_lane_change = last_lane_change_swpt.Find(actor_id);
+  if (last_lane_change != nullptr) {
     // A lane change is happening.
     is_lane_change = true;
     const cg::Vector3D heading_vector = simulation_state.GetHeading(actor_id);
-    const cg::Vector3D relative_vector = simulation_state.GetLocation(actor_id) - last_lane_change_swpt.at(actor_id)->GetLocation();
+    const cg::Vector3D relative_vector = simulation_state.GetLocation(actor_id) - waypoint_graph.GetLocation(*last_lane_change);
     bool left_heading = (heading_vector.x * relative_vector.y - heading_vector.y * relative_vector.x) > 0.0f;
-    if (left_heading) next_action = std::make_pair(RoadOption::ChangeLaneLeft, last_lane_change_swpt.at(actor_id)->GetWaypoint());
-    else next_action = std::make_pair(RoadOption::ChangeLaneRight, last_lane_change_swpt.at(actor_id)->GetWaypoint());
+    if (left_heading) next_action = std::make_pair(RoadOption::ChangeLaneLeft, local_map->GetOpenDriveWaypoint(*last_lane_change));
+    else next_action = std::make_pair(RoadOption::ChangeLaneRight, local_map->GetOpenDriveWaypoint(*last_lane_change));
   }
-  for (auto &swpt : waypoint_buffer) {
-    RoadOption road_opt = swpt->GetRoadOption();
+  for (const WaypointIndex swpt : waypoint_buffer) {
+    RoadOption road_opt = waypoint_graph.GetRecord(swpt).road_option;
     if (road_opt != RoadOption::LaneFollow) {
       if (!is_lane_change) {
         // No lane change in sight, we can assume this will be the next action.
-        return std::make_pair(road_opt, swpt->GetWaypoint());
+        return std::make_pair(road_opt, local_map->GetOpenDriveWaypoint(swpt));
       } else {
         // A lane change will happen as well as another action, we need to figure out which one will happen first.
-        cg::Location lane_change = last_lane_change_swpt.at(actor_id)->GetLocation();
+        cg::Location lane_change = waypoint_graph.GetLocation(*last_lane_change);
         cg::Location actual_location = simulation_state.GetLocation(actor_id);
         auto distance_lane_change = cg::Math::DistanceSquared(actual_location, lane_change);
-        auto distance_other_action = cg::Math::DistanceSquared(actual_location, swpt->GetLocation());
+        auto distance_other_action = cg::Math::DistanceSquared(actual_location, waypoint_graph.GetLocation(swpt));
         if (distance_lane_change < distance_other_action) return next_action;
-        else return std::make_pair(road_opt, swpt->GetWaypoint());
+        else return std::make_pair(road_opt, local_map->GetOpenDriveWaypoint(swpt));
       }
     }
   }
@@ -624,34 +680,36 @@ Action LocalizationStage::ComputeNextAction(const ActorId& actor_id) {
 
 ActionBuffer LocalizationStage::ComputeActionBuffer(const ActorId& actor_id) {
 
+  const WaypointGraph &waypoint_graph = local_map->GetWaypointGraph();
   auto waypoint_buffer = buffer_map.at(actor_id);
   ActionBuffer action_buffer;
   Action lane_change;
   bool is_lane_change = false;
-  SimpleWaypointPtr buffer_front = waypoint_buffer.front();
-  RoadOption last_road_opt = buffer_front->GetRoadOption();
-  action_buffer.push_back(std::make_pair(last_road_opt, buffer_front->GetWaypoint()));
-  if (last_lane_change_swpt.find(actor_id) != last_lane_change_swpt.end()) {
+  WaypointIndex buffer_front = waypoint_buffer.front();
+  RoadOption last_road_opt = waypoint_graph.GetRecord(buffer_front).road_option;
+  action_buffer.push_back(std::make_pair(last_road_opt, local_map->GetOpenDriveWaypoint(buffer_front)));
+  const WaypointIndex *last_lane_change = last_lane_change_swpt.Find(actor_id);
+  if (last_lane_change != nullptr) {
     // A lane change is happening.
     is_lane_change = true;
     const cg::Vector3D heading_vector = simulation_state.GetHeading(actor_id);
-    const cg::Vector3D relative_vector = simulation_state.GetLocation(actor_id) - last_lane_change_swpt.at(actor_id)->GetLocation();
+    const cg::Vector3D relative_vector = simulation_state.GetLocation(actor_id) - waypoint_graph.GetLocation(*last_lane_change);
     bool left_heading = (heading_vector.x * relative_vector.y - heading_vector.y * relative_vector.x) > 0.0f;
-    if (left_heading) lane_change = std::make_pair(RoadOption::ChangeLaneLeft, last_lane_change_swpt.at(actor_id)->GetWaypoint());
-    else lane_change = std::make_pair(RoadOption::ChangeLaneRight, last_lane_change_swpt.at(actor_id)->GetWaypoint());
+    if (left_heading) lane_change = std::make_pair(RoadOption::ChangeLaneLeft, local_map->GetOpenDriveWaypoint(*last_lane_change));
+    else lane_change = std::make_pair(RoadOption::ChangeLaneRight, local_map->GetOpenDriveWaypoint(*last_lane_change));
   }
-  for (auto &wpt : waypoint_buffer) {
-    RoadOption current_road_opt = wpt->GetRoadOption();
+  for (const WaypointIndex wpt : waypoint_buffer) {
+    RoadOption current_road_opt = waypoint_graph.GetRecord(wpt).road_option;
     if (current_road_opt != last_road_opt) {
-      action_buffer.push_back(std::make_pair(current_road_opt, wpt->GetWaypoint()));
+      action_buffer.push_back(std::make_pair(current_road_opt, local_map->GetOpenDriveWaypoint(wpt)));
       last_road_opt = current_road_opt;
     }
   }
   if (is_lane_change) {
     // Insert the lane change action in the appropriate part of the action buffer.
-    auto distance_lane_change = cg::Math::DistanceSquared(waypoint_buffer.front()->GetLocation(), lane_change.second->GetTransform().location);
+    auto distance_lane_change = cg::Math::DistanceSquared(waypoint_graph.GetLocation(waypoint_buffer.front()), lane_change.second->GetTransform().location);
     for (uint16_t i = 0; i < action_buffer.size(); ++i) {
-      auto distance_action = cg::Math::DistanceSquared(waypoint_buffer.front()->GetLocation(), waypoint_buffer.at(i)->GetLocation());
+      auto distance_action = cg::Math::DistanceSquared(waypoint_graph.GetLocation(waypoint_buffer.front()), waypoint_graph.GetLocation(waypoint_buffer[i]));
       // If the waypoint related to the next action is further away from the one of the lane change, insert lane change action here.
       // If we reached the end of the buffer, place the action at the end.
       if (i == action_buffer.size()-1) {
@@ -2,12 +2,14 @@
 #pragma once
 
 #include <memory>
+#include <mutex>
 
 #include "carla/trafficmanager/DataStructures.h"
 #include "carla/trafficmanager/InMemoryMap.h"
 #include "carla/trafficmanager/LocalizationUtils.h"
 #include "carla/trafficmanager/Parameters.h"
 #include "carla/trafficmanager/RandomGenerator.h"
+#include "carla/trafficmanager/ShardedMap.h"
 #include "carla/trafficmanager/TrackTraffic.h"
 #include "carla/trafficmanager/SimulationState.h"
 #include "carla/trafficmanager/Stage.h"
@@ -18,7 +20,7 @@ namespace traffic_manager {
 namespace cc = carla::client;
 
 using LocalMapPtr = std::shared_ptr<InMemoryMap>;
-using LaneChangeSWptMap = std::unordered_map<ActorId, SimpleWaypointPtr>;
+using LaneChangeSWptMap = ShardedMap<ActorId, WaypointIndex>;
 using WaypointPtr = carla::SharedPtr<cc::Waypoint>;
 using Action = std::pair<RoadOption, WaypointPtr>;
 using ActionBuffer = std::vector<Action>;
@@ -39,17 +41,29 @@ private:
   Parameters &parameters;
   // Array of vehicles marked by stages for removal.
   std::vector<ActorId>& marked_for_removal;
+  std::mutex marked_for_removal_mutex;
   LocalizationFrame &output_array;
   LaneChangeSWptMap last_lane_change_swpt;
   ActorIdSet vehicles_at_junction;
-  using SimpleWaypointPair = std::pair<SimpleWaypointPtr, SimpleWaypointPtr>;
-  std::unordered_map<ActorId, SimpleWaypointPair> vehicles_at_junction_entrance;
-  RandomGenerator &random_device;
-
-  SimpleWaypointPtr AssignLaneChange(const ActorId actor_id,
-                                     const cg::Location vehicle_location,
-                                     const float vehicle_speed,
-                                     bool force, bool direction);
+  using WaypointIndexPair = std::pair<WaypointIndex, WaypointIndex>;
+  ShardedMap<ActorId, WaypointIndexPair> vehicles_at_junction_entrance;
+  VehicleRandomGenerators &random_devices;
+  // When vehicles are updated by several workers, the buffers of other
+  // vehicles are seen as they were at the beginning of the cycle,
+  // and the tracked traffic is only updated once the cycle ends.
+  bool parallel_cycle = false;
+  std::unordered_map<ActorId, WaypointIndex> buffer_fronts;
+
+  // Method to get the first waypoint in the buffer of another vehicle,
+  // INVALID_WAYPOINT_INDEX if it has none.
+  WaypointIndex GetBufferFront(const ActorId actor_id) const;
+
+  void MarkForRemoval(const ActorId actor_id);
+
+  WaypointIndex AssignLaneChange(const ActorId actor_id,
+                                 const cg::Location vehicle_location,
+                                 const float vehicle_speed,
+                                 bool force, bool direction);
 
   void ExtendAndFindSafeSpace(const ActorId actor_id,
                               const bool is_at_junction_entrance,
@@ -74,10 +88,17 @@ public:
                     Parameters &parameters,
                     std::vector<ActorId>& marked_for_removal,
                     LocalizationFrame &output_array,
-                    RandomGenerator &random_device);
+                    VehicleRandomGenerators &random_devices);
+
+  // Method to prepare the buffers of the vehicles before they are updated,
+  // possibly from several workers.
+  void PrepareCycle(const std::size_t number_of_workers);
 
   void Update(const unsigned long index) override;
 
+  // Method to commit the changes of the tracked traffic once all vehicles are updated.
+  void FinishCycle();
+
   void RemoveActor(const ActorId actor_id) override;
 
   void Reset() override;
@@ -4,11 +4,14 @@
 
 #pragma once
 
+#include <mutex>
+
 #include "carla/trafficmanager/DataStructures.h"
 #include "carla/trafficmanager/InMemoryMap.h"
 #include "carla/trafficmanager/LocalizationUtils.h"
 #include "carla/trafficmanager/Parameters.h"
 #include "carla/trafficmanager/RandomGenerator.h"
+#include "carla/trafficmanager/ShardedMap.h"
 #include "carla/trafficmanager/SimulationState.h"
 #include "carla/trafficmanager/Stage.h"
 #include "carla/trafficmanager/TrackTraffic.h"
@@ -36,14 +39,21 @@ private:
   const TLFrame &tl_frame;
   const cc::World &world;
   // Structure holding the controller state for registered vehicles.
-  std::unordered_map<ActorId, StateEntry> pid_state_map;
+  ShardedMap<ActorId, StateEntry> pid_state_map;
   // Structure to keep track of duration between teleportation
   // in hybrid physics mode.
-  std::unordered_map<ActorId, cc::Timestamp> teleportation_instance;
+  ShardedMap<ActorId, cc::Timestamp> teleportation_instance;
   ControlFrame &output_array;
   cc::Timestamp current_timestamp;
-  RandomGenerator &random_device;
+  VehicleRandomGenerators &random_devices;
   const LocalMapPtr &local_map;
+  // When vehicles are updated by several workers, the new state of the
+  // teleported dormant vehicles is applied once all of them are updated,
+  // so other vehicles do not read it while it is written.
+  bool parallel_cycle = false;
+  std::vector<std::pair<bool, KinematicState>> kinematic_updates;
+  // Mutex to take the free geodesic grids for dormant vehicles one at a time.
+  std::mutex geogrid_mutex;
 
   std::pair<bool, float> CollisionHandling(const CollisionHazardData &collision_hazard,
                                            const bool tl_hazard,
@@ -55,7 +65,7 @@ private:
                          const bool tl_hazard,
                          const bool collision_emergency_stop);
 
-  float GetLandmarkTargetVelocity(const SimpleWaypoint& waypoint,
+  float GetLandmarkTargetVelocity(const WaypointIndex waypoint,
                                   const cg::Location vehicle_location,
                                   const ActorId actor_id,
                                   float max_target_velocity);
@@ -82,11 +92,17 @@ public:
                   const TLFrame &tl_frame,
                   const cc::World &world,
                   ControlFrame &output_array,
-                  RandomGenerator &random_device,
+                  VehicleRandomGenerators &random_devices,
                   const LocalMapPtr &local_map);
 
+  // Method to prepare the cycle before the vehicles are updated, possibly from several workers.
+  void PrepareCycle(const std::size_t number_of_workers);
+
   void Update(const unsigned long index);
 
+  // Method to apply the state of teleported vehicles once all vehicles are updated.
+  void FinishCycle();
+
   void RemoveActor(const ActorId actor_id);
 
   void Reset();
@@ -0,0 +1,82 @@
+// Copyright (c) 2023 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "carla/Debug.h"
+#include "carla/NonCopyable.h"
+
+namespace carla {
+namespace traffic_manager {
+
+/// Read-only array of plain records that either owns its values or
+/// references values stored elsewhere, like a memory mapped file.
+template <typename T>
+class PackedArray : private NonCopyable {
+public:
+
+  /// Takes ownership of @a values.
+  void assign(std::vector<T> values) {
+    _owned = std::move(values);
+    _data = _owned.data();
+    _size = _owned.size();
+  }
+
+  /// References @a size values at @a data, that must outlive the array.
+  void attach(const T *data, const std::size_t size) {
+    _owned = std::vector<T>();
+    _data = data;
+    _size = size;
+  }
+
+  void clear() {
+    attach(nullptr, 0u);
+  }
+
+  bool empty() const {
+    return _size == 0u;
+  }
+
+  std::size_t size() const {
+    return _size;
+  }
+
+  const T *data() const {
+    return _data;
+  }
+
+  const T &operator[](const std::size_t i) const {
+    DEBUG_ASSERT(i < _size);
+    return _data[i];
+  }
+
+  const T *begin() const {
+    return _data;
+  }
+
+  const T *end() const {
+    return _data + _size;
+  }
+
+  /// Memory owned by the array, in bytes. Attached values are not counted.
+  std::size_t owned_memory() const {
+    return _owned.capacity() * sizeof(T);
+  }
+
+private:
+
+  std::vector<T> _owned;
+
+  const T *_data = nullptr;
+
+  std::size_t _size = 0u;
+};
+
+} // namespace traffic_manager
+} // namespace carla
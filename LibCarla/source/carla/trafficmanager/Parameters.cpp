@@ -41,106 +41,137 @@ void Parameters::SetBoundariesRespawnDormantVehicles(const float lower_bound, co
 }
 
 void Parameters::SetPercentageSpeedDifference(const ActorPtr &actor, const float percentage) {
-
-  float new_percentage = std::min(100.0f, percentage);
-  percentage_difference_from_speed_limit.AddEntry({actor->GetId(), new_percentage});
-  if (exact_desired_speed.Contains(actor->GetId())) {
-    exact_desired_speed.RemoveEntry(actor->GetId());
-  }
+  SetVehicleParameters({{actor->GetId(), VehicleParameterId::PercentageSpeedDifference, percentage}});
 }
 
 void Parameters::SetLaneOffset(const ActorPtr &actor, const float offset) {
-  const auto entry = std::make_pair(actor->GetId(), offset);
-  lane_offset.AddEntry(entry);
+  SetVehicleParameters({{actor->GetId(), VehicleParameterId::LaneOffset, offset}});
 }
 
 void Parameters::SetDesiredSpeed(const ActorPtr &actor, const float value) {
+  SetVehicleParameters({{actor->GetId(), VehicleParameterId::DesiredSpeed, value}});
+}
 
-  float new_value = std::max(0.0f, value);
-  exact_desired_speed.AddEntry({actor->GetId(), new_value});
-  if (percentage_difference_from_speed_limit.Contains(actor->GetId())) {
-    percentage_difference_from_speed_limit.RemoveEntry(actor->GetId());
+void Parameters::SetVehicleParameters(const std::vector<VehicleParameterUpdate> &updates) {
+
+  // All the updates are taken by the same cycle.
+  std::lock_guard<std::mutex> lock(parameters_mutex);
+  for (const VehicleParameterUpdate &update : updates) {
+    SetVehicleParameter(update);
+  }
+  ++parameters_version;
+}
+
+void Parameters::SetVehicleParameter(const VehicleParameterUpdate &update) {
+
+  const ActorId actor_id = update.actor_id;
+  const float value = update.value;
+  switch (update.parameter) {
+    case VehicleParameterId::PercentageSpeedDifference:
+      percentage_difference_from_speed_limit[actor_id] = std::min(100.0f, value);
+      exact_desired_speed.erase(actor_id);
+      break;
+    case VehicleParameterId::LaneOffset:
+      lane_offset[actor_id] = value;
+      break;
+    case VehicleParameterId::DesiredSpeed:
+      exact_desired_speed[actor_id] = std::max(0.0f, value);
+      percentage_difference_from_speed_limit.erase(actor_id);
+      break;
+    case VehicleParameterId::UpdateVehicleLights:
+      auto_update_vehicle_lights[actor_id] = value != 0.0f;
+      break;
+    case VehicleParameterId::ForceLaneChange:
+      force_lane_change[actor_id] = ChangeLaneInfo{true, value != 0.0f};
+      break;
+    case VehicleParameterId::AutoLaneChange:
+      auto_lane_change[actor_id] = value != 0.0f;
+      break;
+    case VehicleParameterId::DistanceToLeadingVehicle:
+      distance_to_leading_vehicle[actor_id] = std::max(0.0f, value);
+      break;
+    case VehicleParameterId::PercentageRunningLight:
+      perc_run_traffic_light[actor_id] = cg::Math::Clamp(value, 0.0f, 100.0f);
+      break;
+    case VehicleParameterId::PercentageRunningSign:
+      perc_run_traffic_sign[actor_id] = cg::Math::Clamp(value, 0.0f, 100.0f);
+      break;
+    case VehicleParameterId::PercentageIgnoreWalkers:
+      perc_ignore_walkers[actor_id] = cg::Math::Clamp(value, 0.0f, 100.0f);
+      break;
+    case VehicleParameterId::PercentageIgnoreVehicles:
+      perc_ignore_vehicles[actor_id] = cg::Math::Clamp(value, 0.0f, 100.0f);
+      break;
+    case VehicleParameterId::KeepRightPercentage:
+      perc_keep_right[actor_id] = value;
+      break;
+    case VehicleParameterId::RandomLeftLaneChangePercentage:
+      perc_random_left[actor_id] = value;
+      break;
+    case VehicleParameterId::RandomRightLaneChangePercentage:
+      perc_random_right[actor_id] = value;
+      break;
   }
 }
 
 void Parameters::SetGlobalPercentageSpeedDifference(const float percentage) {
   float new_percentage = std::min(100.0f, percentage);
+  std::lock_guard<std::mutex> lock(parameters_mutex);
   global_percentage_difference_from_limit = new_percentage;
+  ++parameters_version;
 }
 
 void Parameters::SetGlobalLaneOffset(const float offset) {
+  std::lock_guard<std::mutex> lock(parameters_mutex);
   global_lane_offset = offset;
+  ++parameters_version;
 }
 
 void Parameters::SetCollisionDetection(const ActorPtr &reference_actor, const ActorPtr &other_actor, const bool detect_collision) {
   const ActorId reference_id = reference_actor->GetId();
   const ActorId other_id = other_actor->GetId();
 
+  std::lock_guard<std::mutex> lock(parameters_mutex);
   if (detect_collision) {
-    if (ignore_collision.Contains(reference_id)) {
-      std::shared_ptr<AtomicActorSet> actor_set = ignore_collision.GetValue(reference_id);
-      if (actor_set->Contains(other_id)) {
-        actor_set->Remove({other_id});
+    auto it = ignore_collision.find(reference_id);
+    if (it != ignore_collision.end()) {
+      it->second.erase(other_id);
+      if (it->second.empty()) {
+        ignore_collision.erase(it);
       }
     }
   } else {
-    if (ignore_collision.Contains(reference_id)) {
-      std::shared_ptr<AtomicActorSet> actor_set = ignore_collision.GetValue(reference_id);
-      if (!actor_set->Contains(other_id)) {
-        actor_set->Insert({other_actor});
-      }
-    } else {
-      std::shared_ptr<AtomicActorSet> actor_set = std::make_shared<AtomicActorSet>();
-      actor_set->Insert({other_actor});
-      auto entry = std::make_pair(reference_id, actor_set);
-      ignore_collision.AddEntry(entry);
-    }
+    ignore_collision[reference_id].insert(other_id);
   }
+  ++parameters_version;
 }
 
 void Parameters::SetForceLaneChange(const ActorPtr &actor, const bool direction) {
-
-  const ChangeLaneInfo lane_change_info = {true, direction};
-  const auto entry = std::make_pair(actor->GetId(), lane_change_info);
-  force_lane_change.AddEntry(entry);
+  SetVehicleParameters({{actor->GetId(), VehicleParameterId::ForceLaneChange, direction ? 1.0f : 0.0f}});
 }
 
 void Parameters::SetKeepRightPercentage(const ActorPtr &actor, const float percentage) {
-
-  const auto entry = std::make_pair(actor->GetId(), percentage);
-  perc_keep_right.AddEntry(entry);
+  SetVehicleParameters({{actor->GetId(), VehicleParameterId::KeepRightPercentage, percentage}});
 }
 
 void Parameters::SetRandomLeftLaneChangePercentage(const ActorPtr &actor, const float percentage) {
-
-  const auto entry = std::make_pair(actor->GetId(), percentage);
-  perc_random_left.AddEntry(entry);
+  SetVehicleParameters({{actor->GetId(), VehicleParameterId::RandomLeftLaneChangePercentage, percentage}});
 }
 
 void Parameters::SetRandomRightLaneChangePercentage(const ActorPtr &actor, const float percentage) {
-
-  const auto entry = std::make_pair(actor->GetId(), percentage);
-  perc_random_right.AddEntry(entry);
-
+  SetVehicleParameters({{actor->GetId(), VehicleParameterId::RandomRightLaneChangePercentage, percentage}});
 }
 
 void Parameters::SetUpdateVehicleLights(const ActorPtr &actor, const bool do_update) {
-
-  const auto entry = std::make_pair(actor->GetId(), do_update);
-  auto_update_vehicle_lights.AddEntry(entry);
+  SetVehicleParameters({{actor->GetId(), VehicleParameterId::UpdateVehicleLights, do_update ? 1.0f : 0.0f}});
 }
 
 void Parameters::SetAutoLaneChange(const ActorPtr &actor, const bool enable) {
-
-  const auto entry = std::make_pair(actor->GetId(), enable);
-  auto_lane_change.AddEntry(entry);
+  SetVehicleParameters({{actor->GetId(), VehicleParameterId::AutoLaneChange, enable ? 1.0f : 0.0f}});
 }
 
 void Parameters::SetDistanceToLeadingVehicle(const ActorPtr &actor, const float distance) {
-
-  float new_distance = std::max(0.0f, distance);
-  const auto entry = std::make_pair(actor->GetId(), new_distance);
-  distance_to_leading_vehicle.AddEntry(entry);
+  SetVehicleParameters({{actor->GetId(), VehicleParameterId::DistanceToLeadingVehicle, distance}});
 }
 
 void Parameters::SetSynchronousMode(const bool mode_switch) {
@@ -154,34 +185,23 @@ void Parameters::SetSynchronousModeTimeOutInMiliSecond(const double time) {
 void Parameters::SetGlobalDistanceToLeadingVehicle(const float dist) {
 
   distance_margin.store(dist);
+  ++parameters_version;
 }
 
 void Parameters::SetPercentageRunningLight(const ActorPtr &actor, const float perc) {
-
-  float new_perc = cg::Math::Clamp(perc, 0.0f, 100.0f);
-  const auto entry = std::make_pair(actor->GetId(), new_perc);
-  perc_run_traffic_light.AddEntry(entry);
+  SetVehicleParameters({{actor->GetId(), VehicleParameterId::PercentageRunningLight, perc}});
 }
 
 void Parameters::SetPercentageRunningSign(const ActorPtr &actor, const float perc) {
-
-  float new_perc = cg::Math::Clamp(perc, 0.0f, 100.0f);
-  const auto entry = std::make_pair(actor->GetId(), new_perc);
-  perc_run_traffic_sign.AddEntry(entry);
+  SetVehicleParameters({{actor->GetId(), VehicleParameterId::PercentageRunningSign, perc}});
 }
 
 void Parameters::SetPercentageIgnoreVehicles(const ActorPtr &actor, const float perc) {
-
-  float new_perc = cg::Math::Clamp(perc, 0.0f, 100.0f);
-  const auto entry = std::make_pair(actor->GetId(), new_perc);
-  perc_ignore_vehicles.AddEntry(entry);
+  SetVehicleParameters({{actor->GetId(), VehicleParameterId::PercentageIgnoreVehicles, perc}});
 }
 
 void Parameters::SetPercentageIgnoreWalkers(const ActorPtr &actor, const float perc) {
-
-  float new_perc = cg::Math::Clamp(perc,0.0f,100.0f);
-  const auto entry = std::make_pair(actor->GetId(), new_perc);
-  perc_ignore_walkers.AddEntry(entry);
+  SetVehicleParameters({{actor->GetId(), VehicleParameterId::PercentageIgnoreWalkers, perc}});
 }
 
 void Parameters::SetHybridPhysicsRadius(const float radius) {
@@ -193,6 +213,10 @@ void Parameters::SetOSMMode(const bool mode_switch) {
   osm_mode.store(mode_switch);
 }
 
+void Parameters::SetWorkerThreads(const uint64_t threads) {
+  worker_threads.store(threads);
+}
+
 void Parameters::SetCustomPath(const ActorPtr &actor, const Path path, const bool empty_buffer) {
   const auto entry = std::make_pair(actor->GetId(), path);
   custom_path.AddEntry(entry);
@@ -235,177 +259,111 @@ void Parameters::UpdateImportedRoute(const ActorId &actor_id, const Route route)
   custom_route.AddEntry(entry);
 }
 
-//////////////////////////////////// GETTERS //////////////////////////////////
-
-float Parameters::GetHybridPhysicsRadius() const {
-
-  return hybrid_physics_radius.load();
-}
-
-bool Parameters::GetSynchronousMode() const {
-  return synchronous_mode.load();
-}
-
-double Parameters::GetSynchronousModeTimeOutInMiliSecond() const {
-  return synchronous_time_out.count();
-}
+///////////////////////////////// CYCLE PARAMETERS ////////////////////////////
 
-float Parameters::GetVehicleTargetVelocity(const ActorId &actor_id, const float speed_limit) const {
+void Parameters::UpdateTable(const std::vector<ActorId> &vehicle_id_list) {
 
-  float percentage_difference = global_percentage_difference_from_limit;
-
-  if (percentage_difference_from_speed_limit.Contains(actor_id)) {
-    percentage_difference = percentage_difference_from_speed_limit.GetValue(actor_id);
-  } else if (exact_desired_speed.Contains(actor_id)) {
-    return exact_desired_speed.GetValue(actor_id);
+  // Most cycles nothing changed, and the stages keep reading the same table.
+  if (table_version == parameters_version.load() && table_vehicle_ids == vehicle_id_list) {
+    return;
   }
 
-  return speed_limit * (1.0f - percentage_difference / 100.0f);
-}
-
-float Parameters::GetLaneOffset(const ActorId &actor_id) const {
-  float offset = global_lane_offset;
-
-  if (lane_offset.Contains(actor_id)) {
-    offset = lane_offset.GetValue(actor_id);
-  }
-
-  return offset;
-}
-
-bool Parameters::GetCollisionDetection(const ActorId &reference_actor_id, const ActorId &other_actor_id) const {
-
-  bool avoid_collision = true;
-
-  if (ignore_collision.Contains(reference_actor_id) &&
-    ignore_collision.GetValue(reference_actor_id)->Contains(other_actor_id)) {
-    avoid_collision = false;
-  }
-
-  return avoid_collision;
-}
-
-ChangeLaneInfo Parameters::GetForceLaneChange(const ActorId &actor_id) {
-
-  ChangeLaneInfo change_lane_info {false, false};
-
-  if (force_lane_change.Contains(actor_id)) {
-    change_lane_info = force_lane_change.GetValue(actor_id);
-  }
-
-  force_lane_change.RemoveEntry(actor_id);
-
-  return change_lane_info;
-}
-
-float Parameters::GetKeepRightPercentage(const ActorId &actor_id) {
+  std::lock_guard<std::mutex> lock(parameters_mutex);
+  table_version = parameters_version.load();
+  table_vehicle_ids = vehicle_id_list;
 
-  float percentage = -1.0f;
+  table.defaults = VehicleParameters();
+  table.defaults.percentage_speed_difference = global_percentage_difference_from_limit;
+  table.defaults.lane_offset = global_lane_offset;
+  table.defaults.distance_to_leading_vehicle = distance_margin.load();
 
-  if (perc_keep_right.Contains(actor_id)) {
-    percentage = perc_keep_right.GetValue(actor_id);
+  // Registered vehicles first, in the order of the cycle, then the rest of
+  // the actors with parameters of their own.
+  table.slots.clear();
+  for (std::size_t index = 0u; index < vehicle_id_list.size(); ++index) {
+    table.slots.emplace(vehicle_id_list[index], index);
   }
-
-  return percentage;
-}
-
-float Parameters::GetRandomLeftLaneChangePercentage(const ActorId &actor_id) {
-
-  float percentage = -1.0f;
-
-  if (perc_random_left.Contains(actor_id)) {
-    percentage = perc_random_left.GetValue(actor_id);
-  }
-
-  return percentage;
-}
-
-float Parameters::GetRandomRightLaneChangePercentage(const ActorId &actor_id) {
-
-  float percentage = -1.0f;
-
-  if (perc_random_right.Contains(actor_id)) {
-    percentage = perc_random_right.GetValue(actor_id);
-  }
-
-  return percentage;
-}
-
-bool Parameters::GetAutoLaneChange(const ActorId &actor_id) const {
-
-  bool auto_lane_change_policy = true;
-
-  if (auto_lane_change.Contains(actor_id)) {
-    auto_lane_change_policy = auto_lane_change.GetValue(actor_id);
-  }
-
-  return auto_lane_change_policy;
-}
-
-float Parameters::GetDistanceToLeadingVehicle(const ActorId &actor_id) const {
-
-  float specific_distance_margin = 0.0f;
-  if (distance_to_leading_vehicle.Contains(actor_id)) {
-    specific_distance_margin = distance_to_leading_vehicle.GetValue(actor_id);
-  } else {
-    specific_distance_margin = distance_margin;
+  std::size_t next_slot = vehicle_id_list.size();
+  const auto add_actors = [this, &next_slot](const auto &map) {
+    for (const auto &entry : map) {
+      if (table.slots.emplace(entry.first, next_slot).second) {
+        ++next_slot;
+      }
+    }
+  };
+  add_actors(percentage_difference_from_speed_limit);
+  add_actors(lane_offset);
+  add_actors(exact_desired_speed);
+  add_actors(ignore_collision);
+  add_actors(distance_to_leading_vehicle);
+  add_actors(auto_lane_change);
+  add_actors(perc_run_traffic_light);
+  add_actors(perc_run_traffic_sign);
+  add_actors(perc_ignore_walkers);
+  add_actors(perc_ignore_vehicles);
+  add_actors(perc_keep_right);
+  add_actors(perc_random_left);
+  add_actors(perc_random_right);
+  add_actors(auto_update_vehicle_lights);
+
+  table.vehicles.assign(next_slot, table.defaults);
+  const auto apply = [this](const auto &map, auto field) {
+    for (const auto &entry : map) {
+      table.vehicles[table.slots.at(entry.first)].*field = entry.second;
+    }
+  };
+  apply(percentage_difference_from_speed_limit, &VehicleParameters::percentage_speed_difference);
+  apply(lane_offset, &VehicleParameters::lane_offset);
+  apply(exact_desired_speed, &VehicleParameters::exact_desired_speed);
+  apply(distance_to_leading_vehicle, &VehicleParameters::distance_to_leading_vehicle);
+  apply(auto_lane_change, &VehicleParameters::auto_lane_change);
+  apply(perc_run_traffic_light, &VehicleParameters::perc_run_traffic_light);
+  apply(perc_run_traffic_sign, &VehicleParameters::perc_run_traffic_sign);
+  apply(perc_ignore_walkers, &VehicleParameters::perc_ignore_walkers);
+  apply(perc_ignore_vehicles, &VehicleParameters::perc_ignore_vehicles);
+  apply(perc_keep_right, &VehicleParameters::perc_keep_right);
+  apply(perc_random_left, &VehicleParameters::perc_random_left);
+  apply(perc_random_right, &VehicleParameters::perc_random_right);
+  apply(auto_update_vehicle_lights, &VehicleParameters::update_vehicle_lights);
+
+  for (const auto &entry : ignore_collision) {
+    std::vector<ActorId> &ignored = table.vehicles[table.slots.at(entry.first)].ignore_collision;
+    ignored.assign(entry.second.begin(), entry.second.end());
+    std::sort(ignored.begin(), ignored.end());
   }
 
-  return specific_distance_margin;
-}
-
-float Parameters::GetPercentageRunningLight(const ActorId &actor_id) const {
-
-  float percentage = 0.0f;
-
-  if (perc_run_traffic_light.Contains(actor_id)) {
-    percentage = perc_run_traffic_light.GetValue(actor_id);
+  // Forced lane changes only last one cycle, those of vehicles that are not
+  // registered yet wait until they are.
+  bool consumed_lane_change = false;
+  for (auto it = force_lane_change.begin(); it != force_lane_change.end();) {
+    const auto slot = table.slots.find(it->first);
+    if (slot != table.slots.end() && slot->second < vehicle_id_list.size()) {
+      table.vehicles[slot->second].force_lane_change = it->second;
+      it = force_lane_change.erase(it);
+      consumed_lane_change = true;
+    } else {
+      ++it;
+    }
   }
-
-  return percentage;
-}
-
-float Parameters::GetPercentageRunningSign(const ActorId &actor_id) const {
-
-  float percentage = 0.0f;
-
-  if (perc_run_traffic_sign.Contains(actor_id)) {
-    percentage = perc_run_traffic_sign.GetValue(actor_id);
+  // Rebuild the table next cycle without them.
+  if (consumed_lane_change) {
+    ++parameters_version;
   }
-
-  return percentage;
 }
 
-float Parameters::GetPercentageIgnoreWalkers(const ActorId &actor_id) const {
-
-  float percentage = 0.0f;
+//////////////////////////////////// GETTERS //////////////////////////////////
 
-  if (perc_ignore_walkers.Contains(actor_id)) {
-    percentage = perc_ignore_walkers.GetValue(actor_id);
-  }
+float Parameters::GetHybridPhysicsRadius() const {
 
-  return percentage;
+  return hybrid_physics_radius.load();
 }
 
-bool Parameters::GetUpdateVehicleLights(const ActorId &actor_id) const {
-  bool do_update = false;
-
-  if (auto_update_vehicle_lights.Contains(actor_id)) {
-    do_update = auto_update_vehicle_lights.GetValue(actor_id);
-  }
-
-  return do_update;
+bool Parameters::GetSynchronousMode() const {
+  return synchronous_mode.load();
 }
 
-float Parameters::GetPercentageIgnoreVehicles(const ActorId &actor_id) const {
-
-  float percentage = 0.0f;
-
-  if (perc_ignore_vehicles.Contains(actor_id)) {
-    percentage = perc_ignore_vehicles.GetValue(actor_id);
-  }
-
-  return percentage;
+double Parameters::GetSynchronousModeTimeOutInMiliSecond() const {
+  return synchronous_time_out.count();
 }
 
 bool Parameters::GetHybridPhysicsMode() const {
@@ -434,6 +392,11 @@ bool Parameters::GetOSMMode() const {
   return osm_mode.load();
 }
 
+uint64_t Parameters::GetWorkerThreads() const {
+
+  return worker_threads.load();
+}
+
 bool Parameters::GetUploadPath(const ActorId &actor_id) const {
 
   bool custom_path_bool = false;
@@ -6,18 +6,22 @@
 
 #pragma once
 
+#include <algorithm>
 #include <atomic>
 #include <chrono>
+#include <mutex>
 #include <random>
 #include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 #include "carla/client/Actor.h"
 #include "carla/client/Vehicle.h"
 #include "carla/Memory.h"
 #include "carla/rpc/ActorId.h"
 
-#include "carla/trafficmanager/AtomicActorSet.h"
 #include "carla/trafficmanager/AtomicMap.h"
+#include "carla/trafficmanager/VehicleParameterUpdate.h"
 
 namespace carla {
 namespace traffic_manager {
@@ -34,43 +38,114 @@ struct ChangeLaneInfo {
   bool direction = false;
 };
 
+/// Parameters of a vehicle during a cycle, with the global parameters
+/// already applied where the vehicle does not set its own.
+struct VehicleParameters {
+  /// Target velocity % difference from the speed limit.
+  float percentage_speed_difference = 0.0f;
+  /// Exact target velocity, negative if the vehicle follows the speed limit.
+  float exact_desired_speed = -1.0f;
+  /// Lane offset from the center line.
+  float lane_offset = 0.0f;
+  /// Distance to keep to the leading vehicle.
+  float distance_to_leading_vehicle = 0.0f;
+  /// Lane change forced for this cycle.
+  ChangeLaneInfo force_lane_change;
+  /// Whether the vehicle changes lane automatically.
+  bool auto_lane_change = true;
+  /// % of keep right rule, negative if not set.
+  float perc_keep_right = -1.0f;
+  /// % of random left lane change, negative if not set.
+  float perc_random_left = -1.0f;
+  /// % of random right lane change, negative if not set.
+  float perc_random_right = -1.0f;
+  /// % of running a traffic light.
+  float perc_run_traffic_light = 0.0f;
+  /// % of running a traffic sign.
+  float perc_run_traffic_sign = 0.0f;
+  /// % of ignoring walkers.
+  float perc_ignore_walkers = 0.0f;
+  /// % of ignoring vehicles.
+  float perc_ignore_vehicles = 0.0f;
+  /// Whether the vehicle lights are updated automatically.
+  bool update_vehicle_lights = false;
+  /// Actors ignored during collision detection, sorted.
+  std::vector<ActorId> ignore_collision;
+
+  /// Target velocity of the vehicle for the given speed limit.
+  float GetTargetVelocity(const float speed_limit) const {
+    if (exact_desired_speed >= 0.0f) {
+      return exact_desired_speed;
+    }
+    return speed_limit * (1.0f - percentage_speed_difference / 100.0f);
+  }
+
+  /// Whether the vehicle avoids collisions with the given actor.
+  bool GetCollisionDetection(const ActorId other_actor_id) const {
+    return !std::binary_search(ignore_collision.begin(), ignore_collision.end(), other_actor_id);
+  }
+};
+
+/// Copy of the per-vehicle parameters taken at the start of a cycle, that
+/// does not change during it. The registered vehicles come first, in the
+/// order of the vehicle list of the cycle, followed by any other actor with
+/// parameters of its own.
+struct ParameterTable {
+  std::vector<VehicleParameters> vehicles;
+  /// Position in @a vehicles of each actor.
+  std::unordered_map<ActorId, std::size_t> slots;
+  /// Parameters of the actors that do not set any.
+  VehicleParameters defaults;
+};
+
 class Parameters {
 
 private:
+  /// Protects the per-vehicle parameters set by the clients, until the
+  /// traffic manager copies them to the table of the next cycle.
+  mutable std::mutex parameters_mutex;
+  /// Incremented every time a per-vehicle or global parameter of the table changes.
+  std::atomic<uint64_t> parameters_version{0u};
   /// Target velocity map for individual vehicles, based on a % diffrerence from speed limit.
-  AtomicMap<ActorId, float> percentage_difference_from_speed_limit;
+  std::unordered_map<ActorId, float> percentage_difference_from_speed_limit;
   /// Lane offset map for individual vehicles.
-  AtomicMap<ActorId, float> lane_offset;
+  std::unordered_map<ActorId, float> lane_offset;
   /// Target velocity map for individual vehicles, based on a desired velocity.
-  AtomicMap<ActorId, float> exact_desired_speed;
+  std::unordered_map<ActorId, float> exact_desired_speed;
   /// Global target velocity limit % difference.
   float global_percentage_difference_from_limit = 0;
   /// Global lane offset
   float global_lane_offset = 0;
   /// Map containing a set of actors to be ignored during collision detection.
-  AtomicMap<ActorId, std::shared_ptr<AtomicActorSet>> ignore_collision;
+  std::unordered_map<ActorId, std::unordered_set<ActorId>> ignore_collision;
   /// Map containing distance to leading vehicle command.
-  AtomicMap<ActorId, float> distance_to_leading_vehicle;
+  std::unordered_map<ActorId, float> distance_to_leading_vehicle;
   /// Map containing force lane change commands.
-  AtomicMap<ActorId, ChangeLaneInfo> force_lane_change;
+  std::unordered_map<ActorId, ChangeLaneInfo> force_lane_change;
   /// Map containing auto lane change commands.
-  AtomicMap<ActorId, bool> auto_lane_change;
+  std::unordered_map<ActorId, bool> auto_lane_change;
   /// Map containing % of running a traffic light.
-  AtomicMap<ActorId, float> perc_run_traffic_light;
+  std::unordered_map<ActorId, float> perc_run_traffic_light;
   /// Map containing % of running a traffic sign.
-  AtomicMap<ActorId, float> perc_run_traffic_sign;
+  std::unordered_map<ActorId, float> perc_run_traffic_sign;
   /// Map containing % of ignoring walkers.
-  AtomicMap<ActorId, float> perc_ignore_walkers;
+  std::unordered_map<ActorId, float> perc_ignore_walkers;
   /// Map containing % of ignoring vehicles.
-  AtomicMap<ActorId, float> perc_ignore_vehicles;
+  std::unordered_map<ActorId, float> perc_ignore_vehicles;
   /// Map containing % of keep right rule.
-  AtomicMap<ActorId, float> perc_keep_right;
+  std::unordered_map<ActorId, float> perc_keep_right;
   /// Map containing % of random left lane change.
-  AtomicMap<ActorId, float> perc_random_left;
+  std::unordered_map<ActorId, float> perc_random_left;
   /// Map containing % of random right lane change.
-  AtomicMap<ActorId, float> perc_random_right;
+  std::unordered_map<ActorId, float> perc_random_right;
   /// Map containing the automatic vehicle lights update flag
-  AtomicMap<ActorId, bool> auto_update_vehicle_lights;
+  std::unordered_map<ActorId, bool> auto_update_vehicle_lights;
+  /// Parameters of the current cycle, only accessed by the traffic manager thread.
+  ParameterTable table;
+  /// Version of the parameters the table was built from.
+  uint64_t table_version = 0u;
+  /// Vehicle list the table was built for.
+  std::vector<ActorId> table_vehicle_ids;
   /// Synchronous mode switch.
   std::atomic<bool> synchronous_mode{false};
   /// Distance margin
@@ -91,6 +166,8 @@ private:
   std::atomic<float> hybrid_physics_radius {70.0};
   /// Parameter specifying Open Street Map mode.
   std::atomic<bool> osm_mode {true};
+  /// Number of threads used to update the vehicles.
+  std::atomic<uint64_t> worker_threads {1u};
   /// Parameter specifying if importing a custom path.
   AtomicMap<ActorId, bool> upload_path;
   /// Structure to hold all custom paths.
@@ -100,6 +177,9 @@ private:
   /// Structure to hold all custom routes.
   AtomicMap<ActorId, Route> custom_route;
 
+  /// Applies @a update, with the parameters mutex locked.
+  void SetVehicleParameter(const VehicleParameterUpdate &update);
+
 public:
   Parameters();
   ~Parameters();
@@ -117,6 +197,10 @@ public:
   /// Set a vehicle's exact desired velocity.
   void SetDesiredSpeed(const ActorPtr &actor, const float value);
 
+  /// Set several per-vehicle parameters at once. All of them take effect
+  /// in the same cycle.
+  void SetVehicleParameters(const std::vector<VehicleParameterUpdate> &updates);
+
   /// Set a global % decrease in velocity with respect to the speed limit.
   /// If less than 0, it's a % increase.
   void SetGlobalPercentageSpeedDifference(float const percentage);
@@ -184,6 +268,9 @@ public:
   /// Method to set Open Street Map mode.
   void SetOSMMode(const bool mode_switch);
 
+  /// Method to set the number of threads used to update the vehicles.
+  void SetWorkerThreads(const uint64_t threads);
+
   /// Method to set if we are automatically respawning vehicles.
   void SetRespawnDormantVehicles(const bool mode_switch);
 
@@ -211,52 +298,29 @@ public:
   /// Method to update an already set route.
   void UpdateImportedRoute(const ActorId &actor_id, const Route route);
 
-  ///////////////////////////////// GETTERS /////////////////////////////////////
-
-  /// Method to retrieve hybrid physics radius.
-  float GetHybridPhysicsRadius() const;
-
-  /// Method to query target velocity for a vehicle.
-  float GetVehicleTargetVelocity(const ActorId &actor_id, const float speed_limit) const;
+  ////////////////////////////// CYCLE PARAMETERS ///////////////////////////////
 
-  /// Method to query lane offset for a vehicle.
-  float GetLaneOffset(const ActorId &actor_id) const;
+  /// Called by the traffic manager at the start of every cycle, after
+  /// updating its vehicle list. Takes the parameters set since the last
+  /// cycle, and consumes the forced lane changes of the vehicles.
+  void UpdateTable(const std::vector<ActorId> &vehicle_id_list);
 
-  /// Method to query collision avoidance rule between a pair of vehicles.
-  bool GetCollisionDetection(const ActorId &reference_actor_id, const ActorId &other_actor_id) const;
+  /// Parameters of the vehicle at @a index of the vehicle list of the cycle.
+  const VehicleParameters &GetVehicleParameters(const unsigned long index) const {
+    return table.vehicles[index];
+  }
 
-  /// Method to query lane change command for a vehicle.
-  ChangeLaneInfo GetForceLaneChange(const ActorId &actor_id);
+  /// Parameters of any actor during the cycle. Prefer GetVehicleParameters
+  /// when the index of the vehicle is known.
+  const VehicleParameters &GetActorParameters(const ActorId actor_id) const {
+    const auto it = table.slots.find(actor_id);
+    return it != table.slots.end() ? table.vehicles[it->second] : table.defaults;
+  }
 
-  /// Method to query percentage probability of keep right rule for a vehicle.
-  float GetKeepRightPercentage(const ActorId &actor_id);
-
-  /// Method to query percentage probability of a random right lane change for a vehicle.
-  float GetRandomLeftLaneChangePercentage(const ActorId &actor_id);
-
-  /// Method to query percentage probability of a random left lane change for a vehicle.
-  float GetRandomRightLaneChangePercentage(const ActorId &actor_id);
-
-  /// Method to query auto lane change rule for a vehicle.
-  bool GetAutoLaneChange(const ActorId &actor_id) const;
-
-  /// Method to query distance to leading vehicle for a given vehicle.
-  float GetDistanceToLeadingVehicle(const ActorId &actor_id) const;
-
-  /// Method to get % to run any traffic light.
-  float GetPercentageRunningSign(const ActorId &actor_id) const;
-
-  /// Method to get % to run any traffic light.
-  float GetPercentageRunningLight(const ActorId &actor_id) const;
-
-  /// Method to get % to ignore any vehicle.
-  float GetPercentageIgnoreVehicles(const ActorId &actor_id) const;
-
-  /// Method to get % to ignore any walker.
-  float GetPercentageIgnoreWalkers(const ActorId &actor_id) const;
+  ///////////////////////////////// GETTERS /////////////////////////////////////
 
-  /// Method to get if the vehicle lights should be updates automatically
-  bool GetUpdateVehicleLights(const ActorId &actor_id) const;
+  /// Method to retrieve hybrid physics radius.
+  float GetHybridPhysicsRadius() const;
 
   /// Method to get synchronous mode.
   bool GetSynchronousMode() const;
@@ -279,6 +343,9 @@ public:
   /// Method to get Open Street Map mode.
   bool GetOSMMode() const;
 
+  /// Method to get the number of threads used to update the vehicles.
+  uint64_t GetWorkerThreads() const;
+
   /// Method to get if we are uploading a path.
   bool GetUploadPath(const ActorId &actor_id) const;
 
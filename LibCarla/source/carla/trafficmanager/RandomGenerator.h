@@ -1,8 +1,10 @@
 
 #pragma once
 
+#include <cstdint>
 #include <random>
 #include <unordered_map>
+#include <vector>
 
 #include "carla/rpc/ActorId.h"
 
@@ -12,11 +14,74 @@ namespace traffic_manager {
 class RandomGenerator {
 public:
     RandomGenerator(const uint64_t seed): mt(std::mt19937(seed)), dist(0.0, 100.0) {}
+    /// Generator of a vehicle, seeded from both the traffic manager seed and the vehicle id.
+    RandomGenerator(const uint64_t seed, const ActorId actor_id): dist(0.0, 100.0) {
+        std::seed_seq sequence{static_cast<uint32_t>(seed),
+                               static_cast<uint32_t>(seed >> 32u),
+                               static_cast<uint32_t>(actor_id)};
+        mt.seed(sequence);
+    }
     double next() { return dist(mt); }
 private:
     std::mt19937 mt;
     std::uniform_real_distribution<double> dist;
 };
 
+/// Random generators of the registered vehicles. Each vehicle draws from its
+/// own generator, so the numbers it gets do not depend on the order the
+/// vehicles are updated in nor on the number of workers updating them.
+class VehicleRandomGenerators {
+public:
+    explicit VehicleRandomGenerators(const uint64_t seed): seed(seed) {}
+
+    /// Method to reseed the generators of all the vehicles.
+    void SetSeed(const uint64_t _seed) {
+        seed = _seed;
+        generators.clear();
+        index_generators.clear();
+    }
+
+    /// Method to assign the generators to the vehicles updated in this cycle,
+    /// creating those of new vehicles and dropping those no longer registered.
+    void Update(const std::vector<ActorId> &vehicle_id_list) {
+        ++cycle;
+        index_generators.clear();
+        index_generators.reserve(vehicle_id_list.size());
+        for (const ActorId actor_id : vehicle_id_list) {
+            auto it = generators.find(actor_id);
+            if (it == generators.end()) {
+                it = generators.emplace(actor_id, Entry{RandomGenerator(seed, actor_id), cycle}).first;
+            }
+            it->second.cycle = cycle;
+            index_generators.push_back(&it->second.generator);
+        }
+        if (generators.size() > vehicle_id_list.size()) {
+            for (auto it = generators.begin(); it != generators.end();) {
+                if (it->second.cycle != cycle) {
+                    it = generators.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+        }
+    }
+
+    /// Generator of the vehicle at @a index of the list given to Update.
+    RandomGenerator &Get(const unsigned long index) {
+        return *index_generators.at(index);
+    }
+
+private:
+    struct Entry {
+        RandomGenerator generator;
+        uint64_t cycle;
+    };
+
+    uint64_t seed;
+    uint64_t cycle = 0u;
+    std::unordered_map<ActorId, Entry> generators;
+    std::vector<RandomGenerator *> index_generators;
+};
+
 } // namespace traffic_manager
 } // namespace carla
@@ -0,0 +1,114 @@
+// Copyright (c) 2023 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "carla/NonCopyable.h"
+
+namespace carla {
+namespace traffic_manager {
+
+/// Map split in shards by key, each one guarded by its own mutex, so the
+/// workers updating vehicles in parallel can insert and erase entries without
+/// contending on a single lock.
+///
+/// The lock of a shard is only held while looking up, inserting or erasing a
+/// key. The values returned stay valid until their key is erased, so a worker
+/// can keep using the value of a key that no other worker modifies meanwhile.
+template <typename Key, typename Value>
+class ShardedMap : private NonCopyable {
+public:
+
+  explicit ShardedMap(const std::size_t number_of_shards = 16u)
+    : shards(number_of_shards > 0u ? number_of_shards : 1u) {}
+
+  /// Return the value of @a key, or nullptr if the key is not present.
+  Value *Find(const Key &key) {
+    Shard &shard = GetShard(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.map.find(key);
+    return it != shard.map.end() ? &it->second : nullptr;
+  }
+
+  const Value *Find(const Key &key) const {
+    const Shard &shard = GetShard(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.map.find(key);
+    return it != shard.map.end() ? &it->second : nullptr;
+  }
+
+  bool Contains(const Key &key) const {
+    return Find(key) != nullptr;
+  }
+
+  /// Return the value of @a key, inserting @a value if the key is not present.
+  Value &Insert(const Key &key, Value value) {
+    Shard &shard = GetShard(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    return shard.map.emplace(key, std::move(value)).first->second;
+  }
+
+  /// Set the value of @a key, inserting it if not present.
+  Value &Set(const Key &key, Value value) {
+    Shard &shard = GetShard(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.map.find(key);
+    if (it != shard.map.end()) {
+      it->second = std::move(value);
+      return it->second;
+    }
+    return shard.map.emplace(key, std::move(value)).first->second;
+  }
+
+  void Erase(const Key &key) {
+    Shard &shard = GetShard(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    shard.map.erase(key);
+  }
+
+  void Clear() {
+    for (Shard &shard : shards) {
+      std::lock_guard<std::mutex> lock(shard.mutex);
+      shard.map.clear();
+    }
+  }
+
+  std::size_t Size() const {
+    std::size_t size = 0u;
+    for (const Shard &shard : shards) {
+      std::lock_guard<std::mutex> lock(shard.mutex);
+      size += shard.map.size();
+    }
+    return size;
+  }
+
+private:
+
+  struct Shard {
+    mutable std::mutex mutex;
+    std::unordered_map<Key, Value> map;
+  };
+
+  Shard &GetShard(const Key &key) {
+    return shards[std::hash<Key>{}(key) % shards.size()];
+  }
+
+  const Shard &GetShard(const Key &key) const {
+    return shards[std::hash<Key>{}(key) % shards.size()];
+  }
+
+  std::vector<Shard> shards;
+};
+
+} // namespace traffic_manager
+} // namespace carla
@@ -20,11 +20,11 @@ namespace traffic_manager {
   }
   SimpleWaypoint::~SimpleWaypoint() {}
 
-  std::vector<SimpleWaypointPtr> SimpleWaypoint::GetNextWaypoint() const {
+  const std::vector<SimpleWaypointPtr> &SimpleWaypoint::GetNextWaypoint() const {
     return next_waypoints;
   }
 
-  std::vector<SimpleWaypointPtr> SimpleWaypoint::GetPreviousWaypoint() const {
+  const std::vector<SimpleWaypointPtr> &SimpleWaypoint::GetPreviousWaypoint() const {
     return previous_waypoints;
   }
 
@@ -84,6 +84,13 @@ namespace traffic_manager {
     }
   }
 
+  void SimpleWaypoint::ClearLinks() {
+    next_waypoints.clear();
+    previous_waypoints.clear();
+    next_left_waypoint = nullptr;
+    next_right_waypoint = nullptr;
+  }
+
   float SimpleWaypoint::Distance(const cg::Location &location) const {
     return GetLocation().Distance(location);
   }
@@ -142,5 +149,13 @@ namespace traffic_manager {
     return road_option;
   }
 
+  void SimpleWaypoint::SetGraphIndex(uint32_t _graph_index) {
+    graph_index = _graph_index;
+  }
+
+  uint32_t SimpleWaypoint::GetGraphIndex() const {
+    return graph_index;
+  }
+
 } // namespace traffic_manager
 } // namespace carla
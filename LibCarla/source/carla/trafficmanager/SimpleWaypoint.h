@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <limits>
 #include <memory.h>
 
 #include "carla/client/Waypoint.h"
@@ -34,7 +35,9 @@ namespace traffic_manager {
   };
 
   /// This is a simple wrapper class on Carla's waypoint object.
-  /// The class is used to represent discrete samples of the world map.
+  /// The class is used to represent discrete samples of the world map while
+  /// the local map is set up, the traffic manager then walks the WaypointGraph
+  /// built from them.
   class SimpleWaypoint {
 
     using SimpleWaypointPtr = std::shared_ptr<SimpleWaypoint>;
@@ -57,6 +60,8 @@ namespace traffic_manager {
     GeoGridId geodesic_grid_id = 0;
     // Boolean to hold if the waypoint belongs to a junction
     bool _is_junction = false;
+    /// Index of the waypoint in the waypoint graph of the local map.
+    uint32_t graph_index = std::numeric_limits<uint32_t>::max();
 
   public:
 
@@ -70,10 +75,10 @@ namespace traffic_manager {
     WaypointPtr GetWaypoint() const;
 
     /// Returns the list of next waypoints.
-    std::vector<SimpleWaypointPtr> GetNextWaypoint() const;
+    const std::vector<SimpleWaypointPtr> &GetNextWaypoint() const;
 
     /// Returns the list of previous waypoints.
-    std::vector<SimpleWaypointPtr> GetPreviousWaypoint() const;
+    const std::vector<SimpleWaypointPtr> &GetPreviousWaypoint() const;
 
     /// Returns the vector along the waypoint's direction.
     cg::Vector3D GetForwardVector() const;
@@ -99,6 +104,10 @@ namespace traffic_manager {
     /// This method is used to get the closest right waypoint for a lane change.
     SimpleWaypointPtr GetRightWaypoint();
 
+    /// This method removes all the links to other waypoints. Waypoints
+    /// reference each other, so they are only released once unlinked.
+    void ClearLinks();
+
     /// Accessor methods for geodesic grid id.
     void SetGeodesicGridId(GeoGridId _geodesic_grid_id);
     GeoGridId GetGeodesicGridId();
@@ -134,6 +143,10 @@ namespace traffic_manager {
     // Accessor methods for road option.
     void SetRoadOption(RoadOption _road_option);
     RoadOption GetRoadOption();
+
+    // Accessor methods for the index in the waypoint graph.
+    void SetGraphIndex(uint32_t _graph_index);
+    uint32_t GetGraphIndex() const;
   };
 
 } // namespace traffic_manager
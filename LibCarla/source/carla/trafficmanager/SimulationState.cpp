@@ -10,93 +10,176 @@ void SimulationState::AddActor(ActorId actor_id,
                                KinematicState kinematic_state,
                                StaticAttributes attributes,
                                TrafficLightState tl_state) {
-  actor_set.insert(actor_id);
-  kinematic_state_map.insert({actor_id, kinematic_state});
-  static_attribute_map.insert({actor_id, attributes});
-  tl_state_map.insert({actor_id, tl_state});
+  if (slot_map.find(actor_id) != slot_map.end()) {
+    return;
+  }
+
+  const std::size_t slot = actor_ids.size();
+  slot_map.insert({actor_id, slot});
+  actor_ids.push_back(actor_id);
+
+  locations.emplace_back();
+  rotations.emplace_back();
+  headings.emplace_back();
+  velocities.emplace_back();
+  speed_limits.emplace_back();
+  physics_enabled.emplace_back();
+  dormant.emplace_back();
+  hybrid_end_locations.emplace_back();
+  SetKinematicState(slot, kinematic_state);
+
+  actor_types.push_back(attributes.actor_type);
+  dimensions.emplace_back(attributes.half_length, attributes.half_width, attributes.half_height);
+  tl_states.push_back(tl_state);
 }
 
 bool SimulationState::ContainsActor(ActorId actor_id) const {
-  return actor_set.find(actor_id) != actor_set.end();
+  return slot_map.find(actor_id) != slot_map.end();
 }
 
 void SimulationState::RemoveActor(ActorId actor_id) {
-  actor_set.erase(actor_id);
-  kinematic_state_map.erase(actor_id);
-  static_attribute_map.erase(actor_id);
-  tl_state_map.erase(actor_id);
+  auto slot_iter = slot_map.find(actor_id);
+  if (slot_iter == slot_map.end()) {
+    return;
+  }
+
+  // Move the last actor into the freed slot to keep the arrays dense.
+  const std::size_t slot = slot_iter->second;
+  const std::size_t last_slot = actor_ids.size() - 1u;
+  slot_map.erase(slot_iter);
+  if (slot != last_slot) {
+    const ActorId moved_actor_id = actor_ids[last_slot];
+    actor_ids[slot] = moved_actor_id;
+    locations[slot] = locations[last_slot];
+    rotations[slot] = rotations[last_slot];
+    headings[slot] = headings[last_slot];
+    velocities[slot] = velocities[last_slot];
+    speed_limits[slot] = speed_limits[last_slot];
+    physics_enabled[slot] = physics_enabled[last_slot];
+    dormant[slot] = dormant[last_slot];
+    hybrid_end_locations[slot] = hybrid_end_locations[last_slot];
+    actor_types[slot] = actor_types[last_slot];
+    dimensions[slot] = dimensions[last_slot];
+    tl_states[slot] = tl_states[last_slot];
+    slot_map.at(moved_actor_id) = slot;
+  }
+
+  actor_ids.pop_back();
+  locations.pop_back();
+  rotations.pop_back();
+  headings.pop_back();
+  velocities.pop_back();
+  speed_limits.pop_back();
+  physics_enabled.pop_back();
+  dormant.pop_back();
+  hybrid_end_locations.pop_back();
+  actor_types.pop_back();
+  dimensions.pop_back();
+  tl_states.pop_back();
 }
 
 void SimulationState::Reset() {
-  actor_set.clear();
-  kinematic_state_map.clear();
-  static_attribute_map.clear();
-  tl_state_map.clear();
+  slot_map.clear();
+  actor_ids.clear();
+  locations.clear();
+  rotations.clear();
+  headings.clear();
+  velocities.clear();
+  speed_limits.clear();
+  physics_enabled.clear();
+  dormant.clear();
+  hybrid_end_locations.clear();
+  actor_types.clear();
+  dimensions.clear();
+  tl_states.clear();
+}
+
+void SimulationState::SetKinematicState(const std::size_t slot, const KinematicState &state) {
+  locations[slot] = state.location;
+  rotations[slot] = state.rotation;
+  // The heading is cached here as it is queried several times per vehicle and tick.
+  headings[slot] = state.rotation.GetForwardVector();
+  velocities[slot] = state.velocity;
+  speed_limits[slot] = state.speed_limit;
+  physics_enabled[slot] = state.physics_enabled;
+  dormant[slot] = state.is_dormant;
+  hybrid_end_locations[slot] = state.hybrid_end_location;
 }
 
 void SimulationState::UpdateKinematicState(ActorId actor_id, KinematicState state) {
-  kinematic_state_map.at(actor_id) = state;
+  SetKinematicState(slot_map.at(actor_id), state);
 }
 
 void SimulationState::UpdateKinematicHybridEndLocation(ActorId actor_id, cg::Location location) {
-  kinematic_state_map.at(actor_id).hybrid_end_location = location;
+  hybrid_end_locations[slot_map.at(actor_id)] = location;
 }
 
 void SimulationState::UpdateTrafficLightState(ActorId actor_id, TrafficLightState state) {
   // The green-yellow state transition is not notified to the vehicle. This is done to avoid
   // having vehicles stopped very near the intersection when only the rear part of the vehicle
   // is colliding with the trigger volume of the traffic light.
-  auto previous_tl_state = GetTLS(actor_id);
+  TrafficLightState &previous_tl_state = tl_states[slot_map.at(actor_id)];
   if (previous_tl_state.at_traffic_light && previous_tl_state.tl_state == TLS::Green) {
     state.tl_state = TLS::Green;
   }
 
-  tl_state_map.at(actor_id) = state;
+  previous_tl_state = state;
 }
 
 cg::Location SimulationState::GetLocation(ActorId actor_id) const {
-  return kinematic_state_map.at(actor_id).location;
+  return locations[slot_map.at(actor_id)];
 }
 
 cg::Location SimulationState::GetHybridEndLocation(ActorId actor_id) const {
-  return kinematic_state_map.at(actor_id).hybrid_end_location;
+  return hybrid_end_locations[slot_map.at(actor_id)];
 }
 
 cg::Rotation SimulationState::GetRotation(ActorId actor_id) const {
-  return kinematic_state_map.at(actor_id).rotation;
+  return rotations[slot_map.at(actor_id)];
 }
 
 cg::Vector3D SimulationState::GetHeading(ActorId actor_id) const {
-  return kinematic_state_map.at(actor_id).rotation.GetForwardVector();
+  return headings[slot_map.at(actor_id)];
 }
 
 cg::Vector3D SimulationState::GetVelocity(ActorId actor_id) const {
-  return kinematic_state_map.at(actor_id).velocity;
+  return velocities[slot_map.at(actor_id)];
 }
 
 float SimulationState::GetSpeedLimit(ActorId actor_id) const {
-  return kinematic_state_map.at(actor_id).speed_limit;
+  return speed_limits[slot_map.at(actor_id)];
 }
 
 bool SimulationState::IsPhysicsEnabled(ActorId actor_id) const {
-  return kinematic_state_map.at(actor_id).physics_enabled;
+  return physics_enabled[slot_map.at(actor_id)] != 0u;
 }
 
 bool SimulationState::IsDormant(ActorId actor_id) const {
-  return kinematic_state_map.at(actor_id).is_dormant;
+  return dormant[slot_map.at(actor_id)] != 0u;
 }
 
 TrafficLightState SimulationState::GetTLS(ActorId actor_id) const {
-  return tl_state_map.at(actor_id);
+  return tl_states[slot_map.at(actor_id)];
 }
 
 ActorType SimulationState::GetType(ActorId actor_id) const {
-  return static_attribute_map.at(actor_id).actor_type;
+  return actor_types[slot_map.at(actor_id)];
 }
 
 cg::Vector3D SimulationState::GetDimensions(ActorId actor_id) const {
-  const StaticAttributes &attributes = static_attribute_map.at(actor_id);
-  return cg::Vector3D(attributes.half_length, attributes.half_width, attributes.half_height);
+  return dimensions[slot_map.at(actor_id)];
+}
+
+std::size_t SimulationState::GetSlot(const ActorId actor_id) const {
+  auto slot_iter = slot_map.find(actor_id);
+  if (slot_iter == slot_map.end()) {
+    return INVALID_STATE_SLOT;
+  }
+  return slot_iter->second;
+}
+
+std::size_t SimulationState::Size() const {
+  return actor_ids.size();
 }
 
 } // namespace  traffic_manager
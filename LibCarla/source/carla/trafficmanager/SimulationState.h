@@ -1,7 +1,9 @@
 
 #pragma once
 
-#include <unordered_set>
+#include <limits>
+#include <unordered_map>
+#include <vector>
 
 #include "carla/trafficmanager/DataStructures.h"
 
@@ -23,13 +25,11 @@ struct KinematicState {
   bool is_dormant;
   cg::Location hybrid_end_location;
 };
-using KinematicStateMap = std::unordered_map<ActorId, KinematicState>;
 
 struct TrafficLightState {
   TLS tl_state;
   bool at_traffic_light;
 };
-using TrafficLightStateMap = std::unordered_map<ActorId, TrafficLightState>;
 
 struct StaticAttributes {
   ActorType actor_type;
@@ -37,20 +37,39 @@ struct StaticAttributes {
   float half_width;
   float half_height;
 };
-using StaticAttributeMap = std::unordered_map<ActorId, StaticAttributes>;
+
+/// Slot returned for actors not present in the simulation state.
+static constexpr std::size_t INVALID_STATE_SLOT = std::numeric_limits<std::size_t>::max();
 
 /// This class holds the state of all the vehicles in the simlation.
+/// The state is stored as a structure of arrays indexed by a dense slot per
+/// actor, so stages can iterate over contiguous locations, velocities and
+/// headings. The actor id to slot map is only needed at the edges.
+/// Removing an actor moves the last actor into its slot, so slots are only
+/// stable until the next removal.
 class SimulationState {
 
 private:
-  // Structure to hold ids of all actors in the simulation.
-  std::unordered_set<ActorId> actor_set;
-  // Structure containing dynamic motion related state of actors.
-  KinematicStateMap kinematic_state_map;
-  // Structure containing static attributes of actors.
-  StaticAttributeMap static_attribute_map;
-  // Structure containing dynamic traffic light related state of actors.
-  TrafficLightStateMap tl_state_map;
+  // Structure mapping the id of every actor in the simulation to its slot.
+  std::unordered_map<ActorId, std::size_t> slot_map;
+  // Actor id stored in each slot.
+  std::vector<ActorId> actor_ids;
+  // Dynamic motion related state of actors.
+  std::vector<cg::Location> locations;
+  std::vector<cg::Rotation> rotations;
+  std::vector<cg::Vector3D> headings;
+  std::vector<cg::Vector3D> velocities;
+  std::vector<float> speed_limits;
+  std::vector<uint8_t> physics_enabled;
+  std::vector<uint8_t> dormant;
+  std::vector<cg::Location> hybrid_end_locations;
+  // Static attributes of actors.
+  std::vector<ActorType> actor_types;
+  std::vector<cg::Vector3D> dimensions;
+  // Dynamic traffic light related state of actors.
+  std::vector<TrafficLightState> tl_states;
+
+  void SetKinematicState(const std::size_t slot, const KinematicState &state);
 
 public :
   SimulationState();
@@ -100,6 +119,37 @@ public :
 
   cg::Vector3D GetDimensions(const ActorId actor_id) const;
 
+  // Method to get the slot of an actor, INVALID_STATE_SLOT if not present.
+  std::size_t GetSlot(const ActorId actor_id) const;
+
+  // Number of actors currently in the simulation state.
+  std::size_t Size() const;
+
+  // Methods to access the per slot arrays.
+  const std::vector<ActorId> &GetActorIdArray() const {
+    return actor_ids;
+  }
+
+  const std::vector<cg::Location> &GetLocationArray() const {
+    return locations;
+  }
+
+  const std::vector<cg::Vector3D> &GetHeadingArray() const {
+    return headings;
+  }
+
+  const std::vector<cg::Vector3D> &GetVelocityArray() const {
+    return velocities;
+  }
+
+  const std::vector<cg::Vector3D> &GetDimensionArray() const {
+    return dimensions;
+  }
+
+  const std::vector<ActorType> &GetTypeArray() const {
+    return actor_types;
+  }
+
 };
 
 } // namespace traffic_manager
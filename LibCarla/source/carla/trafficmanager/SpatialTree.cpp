@@ -0,0 +1,195 @@
+// Copyright (c) 2023 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "carla/trafficmanager/SpatialTree.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <queue>
+#include <utility>
+
+namespace carla {
+namespace traffic_manager {
+
+  static uint32_t DivideRoundingUp(const std::size_t value, const std::size_t divisor) {
+    return static_cast<uint32_t>((value + divisor - 1u) / divisor);
+  }
+
+  /// Orders @a entries so every consecutive group of NODE_CAPACITY entries is
+  /// a tile of the Sort-Tile-Recursive packing: sorted by x into vertical
+  /// slices, then by y within each slice. Ties keep the previous order, so
+  /// the same locations always give the same tree.
+  template <typename Entry, typename CenterOf>
+  static void SortTileRecursive(std::vector<Entry> &entries, CenterOf center_of) {
+    const std::size_t node_count = DivideRoundingUp(entries.size(), SpatialTree::NODE_CAPACITY);
+    const std::size_t slice_count = static_cast<std::size_t>(std::ceil(std::sqrt(static_cast<double>(node_count))));
+    const std::size_t slice_size = slice_count * SpatialTree::NODE_CAPACITY;
+
+    std::stable_sort(entries.begin(), entries.end(), [&](const Entry &lhs, const Entry &rhs) {
+      return center_of(lhs).x < center_of(rhs).x;
+    });
+    for (std::size_t begin = 0u; begin < entries.size(); begin += slice_size) {
+      const std::size_t end = std::min(begin + slice_size, entries.size());
+      std::stable_sort(entries.begin() + static_cast<std::ptrdiff_t>(begin),
+                       entries.begin() + static_cast<std::ptrdiff_t>(end),
+                       [&](const Entry &lhs, const Entry &rhs) {
+        return center_of(lhs).y < center_of(rhs).y;
+      });
+    }
+  }
+
+  /// Node bounding @a count consecutive children starting at @a first.
+  template <typename Child, typename LowerOf, typename UpperOf>
+  static SpatialTreeNode MakeNode(const Child *children, const uint32_t first, const uint32_t count,
+                                  LowerOf lower_of, UpperOf upper_of) {
+    SpatialTreeNode node;
+    std::memset(static_cast<void *>(&node), 0, sizeof(node));
+    node.lower = lower_of(children[first]);
+    node.upper = upper_of(children[first]);
+    for (uint32_t i = first + 1u; i < first + count; ++i) {
+      const cg::Location lower = lower_of(children[i]);
+      const cg::Location upper = upper_of(children[i]);
+      node.lower = cg::Location(std::min(node.lower.x, lower.x), std::min(node.lower.y, lower.y), std::min(node.lower.z, lower.z));
+      node.upper = cg::Location(std::max(node.upper.x, upper.x), std::max(node.upper.y, upper.y), std::max(node.upper.z, upper.z));
+    }
+    node.first = first;
+    node.count = count;
+    return node;
+  }
+
+  static float DistanceSquaredToNode(const SpatialTreeNode &node, const cg::Location &location) {
+    auto axis_distance = [](const float value, const float lower, const float upper) {
+      return value < lower ? lower - value : (value > upper ? value - upper : 0.0f);
+    };
+    const float dx = axis_distance(location.x, node.lower.x, node.upper.x);
+    const float dy = axis_distance(location.y, node.lower.y, node.upper.y);
+    const float dz = axis_distance(location.z, node.lower.z, node.upper.z);
+    return dx * dx + dy * dy + dz * dz;
+  }
+
+  void SpatialTree::Build(std::vector<SpatialTreeItem> items_data) {
+    Clear();
+    if (items_data.empty()) {
+      return;
+    }
+
+    auto item_location = [](const SpatialTreeItem &item) {
+      return item.location;
+    };
+    auto node_center = [](const SpatialTreeNode &node) {
+      return cg::Location(
+          0.5f * (node.lower.x + node.upper.x),
+          0.5f * (node.lower.y + node.upper.y),
+          0.5f * (node.lower.z + node.upper.z));
+    };
+    auto node_lower = [](const SpatialTreeNode &node) {
+      return node.lower;
+    };
+    auto node_upper = [](const SpatialTreeNode &node) {
+      return node.upper;
+    };
+
+    // Leaves, bounding consecutive items.
+    SortTileRecursive(items_data, item_location);
+    std::vector<SpatialTreeNode> level;
+    for (std::size_t first = 0u; first < items_data.size(); first += NODE_CAPACITY) {
+      const uint32_t count = static_cast<uint32_t>(std::min<std::size_t>(NODE_CAPACITY, items_data.size() - first));
+      level.push_back(MakeNode(items_data.data(), static_cast<uint32_t>(first), count, item_location, item_location));
+    }
+    const std::size_t leaves = level.size();
+
+    // Each level is appended in the order its parents group it, up to the
+    // root.
+    std::vector<SpatialTreeNode> nodes_data;
+    while (true) {
+      if (level.size() > 1u) {
+        SortTileRecursive(level, node_center);
+      }
+      const std::size_t level_begin = nodes_data.size();
+      nodes_data.insert(nodes_data.end(), level.begin(), level.end());
+      if (level.size() == 1u) {
+        break;
+      }
+      std::vector<SpatialTreeNode> parents;
+      for (std::size_t first = level_begin; first < nodes_data.size(); first += NODE_CAPACITY) {
+        const uint32_t count = static_cast<uint32_t>(std::min<std::size_t>(NODE_CAPACITY, nodes_data.size() - first));
+        parents.push_back(MakeNode(nodes_data.data(), static_cast<uint32_t>(first), count, node_lower, node_upper));
+      }
+      level = std::move(parents);
+    }
+
+    nodes.assign(std::move(nodes_data));
+    leaf_count = leaves;
+    items.assign(std::move(items_data));
+  }
+
+  bool SpatialTree::Attach(const SpatialTreeNode *nodes_data, const std::size_t node_count, const std::size_t leaves,
+                           const SpatialTreeItem *items_data, const std::size_t item_count) {
+    Clear();
+    if (node_count == 0u) {
+      return leaves == 0u && item_count == 0u;
+    }
+    if (leaves == 0u || leaves > node_count) {
+      return false;
+    }
+    // Children come before their parent, so any walk from the root ends.
+    for (std::size_t i = 0u; i < node_count; ++i) {
+      const SpatialTreeNode &node = nodes_data[i];
+      const std::size_t end = static_cast<std::size_t>(node.first) + node.count;
+      if (node.count == 0u || node.count > NODE_CAPACITY) {
+        return false;
+      }
+      if (i < leaves ? end > item_count : end > i) {
+        return false;
+      }
+    }
+    nodes.attach(nodes_data, node_count);
+    leaf_count = leaves;
+    items.attach(items_data, item_count);
+    return true;
+  }
+
+  void SpatialTree::Clear() {
+    nodes.clear();
+    leaf_count = 0u;
+    items.clear();
+  }
+
+  WaypointIndex SpatialTree::Nearest(const cg::Location &location) const {
+    if (nodes.empty()) {
+      return INVALID_WAYPOINT_INDEX;
+    }
+
+    // Best first search. Items are pushed with their distance too, so the
+    // first item popped is closer than anything left in the queue.
+    static constexpr uint64_t ITEM_FLAG = uint64_t(1u) << 32u;
+    using Entry = std::pair<float, uint64_t>;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue;
+    const uint32_t root = static_cast<uint32_t>(nodes.size() - 1u);
+    queue.emplace(DistanceSquaredToNode(nodes[root], location), root);
+    while (!queue.empty()) {
+      const uint64_t entry = queue.top().second;
+      queue.pop();
+      const uint32_t index = static_cast<uint32_t>(entry);
+      if (entry & ITEM_FLAG) {
+        return items[index].index;
+      }
+      const SpatialTreeNode &node = nodes[index];
+      for (uint32_t i = node.first; i < node.first + node.count; ++i) {
+        if (index < leaf_count) {
+          queue.emplace(cg::Math::DistanceSquared(items[i].location, location), ITEM_FLAG | i);
+        } else {
+          queue.emplace(DistanceSquaredToNode(nodes[i], location), i);
+        }
+      }
+    }
+    return INVALID_WAYPOINT_INDEX;
+  }
+
+} // namespace traffic_manager
+} // namespace carla
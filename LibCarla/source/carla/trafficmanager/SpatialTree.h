@@ -0,0 +1,127 @@
+// Copyright (c) 2023 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "carla/geom/Location.h"
+#include "carla/trafficmanager/PackedArray.h"
+#include "carla/trafficmanager/WaypointGraph.h"
+
+namespace carla {
+namespace traffic_manager {
+
+  namespace cg = carla::geom;
+
+  /// Waypoint indexed by the spatial tree.
+  struct SpatialTreeItem {
+    cg::Location location;
+    WaypointIndex index;
+  };
+
+  /// Node of the spatial tree, bounding its children. Children are the
+  /// items[first, first + count) of a leaf, or the nodes[first, first + count)
+  /// of an inner node.
+  struct SpatialTreeNode {
+    cg::Location lower;
+    cg::Location upper;
+    uint32_t first;
+    uint32_t count;
+  };
+
+  /// Static R-tree over the waypoints of the local map, packed with the
+  /// Sort-Tile-Recursive algorithm. Nodes are stored level by level starting
+  /// with the leaves, each level after the one it bounds, so the root is the
+  /// last node and children are referenced by their position. Like the
+  /// waypoint graph, the tree either owns its nodes or is attached to the
+  /// sections of a cooked map file.
+  class SpatialTree {
+  public:
+
+    /// Maximum number of children of a node.
+    static constexpr uint32_t NODE_CAPACITY = 16u;
+
+    void Build(std::vector<SpatialTreeItem> items);
+
+    /// References the nodes and items stored elsewhere, that must outlive the
+    /// tree, the first @a leaves nodes being the leaves. Returns false,
+    /// leaving the tree empty, if the nodes do not form a tree over the items.
+    bool Attach(const SpatialTreeNode *nodes_data, const std::size_t node_count, const std::size_t leaves,
+                const SpatialTreeItem *items_data, const std::size_t item_count);
+
+    void Clear();
+
+    /// Returns the index of the closest waypoint to @a location, or
+    /// INVALID_WAYPOINT_INDEX if the tree is empty.
+    WaypointIndex Nearest(const cg::Location &location) const;
+
+    /// Calls @a callback with every item strictly inside the box between
+    /// @a lower and @a upper, until it returns false.
+    template <typename Callback>
+    void Query(const cg::Location &lower, const cg::Location &upper, Callback &&callback) const;
+
+    const PackedArray<SpatialTreeNode> &GetNodes() const {
+      return nodes;
+    }
+
+    std::size_t GetLeafCount() const {
+      return leaf_count;
+    }
+
+    const PackedArray<SpatialTreeItem> &GetItems() const {
+      return items;
+    }
+
+  private:
+
+    PackedArray<SpatialTreeNode> nodes;
+    /// Nodes [0, leaf_count) are the leaves.
+    std::size_t leaf_count = 0u;
+    PackedArray<SpatialTreeItem> items;
+  };
+
+  template <typename Callback>
+  void SpatialTree::Query(const cg::Location &lower, const cg::Location &upper, Callback &&callback) const {
+    if (nodes.empty()) {
+      return;
+    }
+    auto overlaps = [&](const SpatialTreeNode &node) {
+      return node.lower.x < upper.x && node.upper.x > lower.x
+          && node.lower.y < upper.y && node.upper.y > lower.y
+          && node.lower.z < upper.z && node.upper.z > lower.z;
+    };
+    auto inside = [&](const cg::Location &location) {
+      return location.x > lower.x && location.x < upper.x
+          && location.y > lower.y && location.y < upper.y
+          && location.z > lower.z && location.z < upper.z;
+    };
+
+    std::vector<uint32_t> stack = {static_cast<uint32_t>(nodes.size() - 1u)};
+    while (!stack.empty()) {
+      const uint32_t node_index = stack.back();
+      stack.pop_back();
+      const SpatialTreeNode &node = nodes[node_index];
+      if (node_index < leaf_count) {
+        for (uint32_t i = node.first; i < node.first + node.count; ++i) {
+          if (inside(items[i].location) && !callback(items[i])) {
+            return;
+          }
+        }
+      } else {
+        // Pushed in reverse so the children are visited in order.
+        for (uint32_t i = node.first + node.count; i > node.first; --i) {
+          if (overlaps(nodes[i - 1u])) {
+            stack.push_back(i - 1u);
+          }
+        }
+      }
+    }
+  }
+
+} // namespace traffic_manager
+} // namespace carla
@@ -0,0 +1,95 @@
+// Copyright (c) 2023 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include <algorithm>
+#include <exception>
+#include <future>
+#include <thread>
+#include <vector>
+
+#include "carla/trafficmanager/StageExecutor.h"
+
+namespace carla {
+namespace traffic_manager {
+
+StageExecutor::StageExecutor() {}
+
+StageExecutor::~StageExecutor() {
+  if (thread_pool) {
+    thread_pool->Stop();
+  }
+}
+
+void StageExecutor::SetNumberOfWorkers(const std::size_t workers) {
+  std::size_t new_number_of_workers = workers;
+  if (new_number_of_workers == 0u) {
+    new_number_of_workers = std::max(1u, std::thread::hardware_concurrency());
+  }
+  if (new_number_of_workers == number_of_workers) {
+    return;
+  }
+
+  if (thread_pool) {
+    thread_pool->Stop();
+    thread_pool.reset();
+  }
+
+  number_of_workers = new_number_of_workers;
+  if (number_of_workers > 1u) {
+    // The calling thread takes part in every loop, so one thread less is needed.
+    thread_pool = std::make_unique<carla::ThreadPool>();
+    thread_pool->AsyncRun(number_of_workers - 1u);
+  }
+}
+
+std::size_t StageExecutor::GetNumberOfWorkers() const {
+  return number_of_workers;
+}
+
+void StageExecutor::ParallelFor(const unsigned long size,
+                                const std::function<void(const unsigned long)> &functor) {
+
+  const unsigned long workers = std::min(static_cast<unsigned long>(number_of_workers), size);
+
+  if (workers <= 1u || thread_pool == nullptr) {
+    for (unsigned long index = 0u; index < size; ++index) {
+      functor(index);
+    }
+    return;
+  }
+
+  auto work = [&functor, size, workers](const unsigned long worker) {
+    for (unsigned long index = worker; index < size; index += workers) {
+      functor(index);
+    }
+  };
+
+  std::vector<std::future<void>> pending;
+  pending.reserve(workers - 1u);
+  for (unsigned long worker = 1u; worker < workers; ++worker) {
+    pending.emplace_back(thread_pool->Post([&work, worker]() { work(worker); }));
+  }
+  std::exception_ptr exception;
+  try {
+    work(0u);
+  } catch (...) {
+    exception = std::current_exception();
+  }
+
+  // Wait for every worker before re-throwing, the functor is still in use.
+  for (auto &future : pending) {
+    future.wait();
+  }
+  if (exception) {
+    std::rethrow_exception(exception);
+  }
+  for (auto &future : pending) {
+    future.get();
+  }
+}
+
+} // namespace traffic_manager
+} // namespace carla
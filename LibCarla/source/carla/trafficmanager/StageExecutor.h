@@ -0,0 +1,49 @@
+// Copyright (c) 2023 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include <functional>
+#include <memory>
+
+#include "carla/NonCopyable.h"
+#include "carla/ThreadPool.h"
+
+namespace carla {
+namespace traffic_manager {
+
+/// Worker pool used to run the per-vehicle update of a stage across several
+/// threads. Vehicle indices are interleaved between workers, so worker w
+/// processes the indices w, w + N, w + 2N, ... where N is the number of
+/// workers. A stage can then keep per-worker state in slot (index % N)
+/// without any locking.
+class StageExecutor : private NonCopyable {
+
+private:
+  /// Number of workers, including the calling thread.
+  std::size_t number_of_workers {1u};
+  /// Pool holding the helper threads, null if running serially.
+  std::unique_ptr<carla::ThreadPool> thread_pool;
+
+public:
+  StageExecutor();
+  ~StageExecutor();
+
+  /// Method to resize the worker pool. A value of 1 runs every stage on
+  /// the calling thread and 0 uses all available hardware concurrency.
+  void SetNumberOfWorkers(const std::size_t workers);
+
+  std::size_t GetNumberOfWorkers() const;
+
+  /// Method to call functor for every index in [0, size). Returns once all
+  /// the indices have been processed, acting as a barrier between stages.
+  /// Exceptions thrown by the functor are re-thrown on the calling thread.
+  void ParallelFor(const unsigned long size,
+                   const std::function<void(const unsigned long)> &functor);
+};
+
+} // namespace traffic_manager
+} // namespace carla
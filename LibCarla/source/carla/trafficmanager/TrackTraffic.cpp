@@ -8,20 +8,23 @@ namespace traffic_manager {
 
 using constants::TrackTraffic::BUFFER_STEP_THROUGH;
 using constants::TrackTraffic::INV_BUFFER_STEP_THROUGH;
+using constants::TrackTraffic::DEFERRED_UPDATE_SHARDS;
 
-TrackTraffic::TrackTraffic() {}
+TrackTraffic::TrackTraffic()
+    : deferred_updates(DEFERRED_UPDATE_SHARDS) {}
 
 void TrackTraffic::UpdateUnregisteredGridPosition(const ActorId actor_id,
-                                                  const std::vector<SimpleWaypointPtr> waypoints) {
+                                                  const std::vector<WaypointIndex> &waypoints,
+                                                  const WaypointGraph &waypoint_graph) {
 
     DeleteActor(actor_id);
 
     std::unordered_set<GeoGridId> current_grids;
     // Step through waypoints and update grid list for actor and actor list for grids.
-    for (auto &waypoint : waypoints) {
-        UpdatePassingVehicle(waypoint->GetId(), actor_id);
+    for (const WaypointIndex waypoint : waypoints) {
+        UpdatePassingVehicle(waypoint, actor_id);
 
-        GeoGridId ggid = waypoint->GetGeodesicGridId();
+        GeoGridId ggid = waypoint_graph.GetRecord(waypoint).geodesic_grid_id;
         current_grids.insert(ggid);
 
         if (grid_to_actors.find(ggid) != grid_to_actors.end()) {
@@ -37,44 +40,76 @@ void TrackTraffic::UpdateUnregisteredGridPosition(const ActorId actor_id,
     actor_to_grids.insert({actor_id, current_grids});
 }
 
-void TrackTraffic::UpdateGridPosition(const ActorId actor_id, const Buffer &buffer) {
+void TrackTraffic::UpdateGridPosition(const ActorId actor_id, const Buffer &buffer,
+                                      const WaypointGraph &waypoint_graph) {
     if (!buffer.empty()) {
 
-        // Clear current actor from all grids containing itself.
-        if (actor_to_grids.find(actor_id) != actor_to_grids.end()) {
-            std::unordered_set<GeoGridId> &current_grids = actor_to_grids.at(actor_id);
-            for (auto &grid_id : current_grids) {
-                if (grid_to_actors.find(grid_id) != grid_to_actors.end()) {
-                    ActorIdSet &actor_ids = grid_to_actors.at(grid_id);
-                    actor_ids.erase(actor_id);
-                }
-            }
+        // Step through buffer and collect the grids the path goes through.
+        std::unordered_set<GeoGridId> current_grids;
+        for (const WaypointIndex waypoint : buffer) {
+            current_grids.insert(waypoint_graph.GetRecord(waypoint).geodesic_grid_id);
+        }
 
-            actor_to_grids.erase(actor_id);
+        if (deferring_updates) {
+            DeferredUpdates &updates = GetDeferredUpdates(actor_id);
+            std::lock_guard<std::mutex> lock(updates.mutex);
+            updates.grids.emplace_back(actor_id, std::move(current_grids));
+        } else {
+            SetGridPosition(actor_id, current_grids);
         }
+    }
+}
 
-        // Step through buffer and update grid list for actor and actor list for grids.
-        std::unordered_set<GeoGridId> current_grids;
-        uint64_t buffer_size = buffer.size();
-        for (uint64_t i = 0u; i <= buffer_size - 1u; ++i) {
-            auto waypoint = buffer.at(i);
-            GeoGridId ggid = waypoint->GetGeodesicGridId();
-            current_grids.insert(ggid);
-            // Add grid entry if not present.
-            if (grid_to_actors.find(ggid) == grid_to_actors.end()) {
-                grid_to_actors.insert({ggid, {}});
-            }
+void TrackTraffic::SetGridPosition(const ActorId actor_id, const std::unordered_set<GeoGridId> &current_grids) {
 
-            ActorIdSet &actor_ids = grid_to_actors.at(ggid);
-            if (actor_ids.find(actor_id) == actor_ids.end()) {
-                actor_ids.insert(actor_id);
+    // Clear current actor from all grids containing itself.
+    if (actor_to_grids.find(actor_id) != actor_to_grids.end()) {
+        std::unordered_set<GeoGridId> &previous_grids = actor_to_grids.at(actor_id);
+        for (auto &grid_id : previous_grids) {
+            if (grid_to_actors.find(grid_id) != grid_to_actors.end()) {
+                ActorIdSet &actor_ids = grid_to_actors.at(grid_id);
+                actor_ids.erase(actor_id);
             }
         }
 
-        actor_to_grids.insert({actor_id, current_grids});
+        actor_to_grids.erase(actor_id);
     }
+
+    // Update actor list for grids.
+    for (const GeoGridId ggid : current_grids) {
+        grid_to_actors[ggid].insert(actor_id);
+    }
+
+    actor_to_grids.insert({actor_id, current_grids});
 }
 
+TrackTraffic::DeferredUpdates &TrackTraffic::GetDeferredUpdates(const ActorId actor_id) {
+    return deferred_updates[actor_id % deferred_updates.size()];
+}
+
+void TrackTraffic::DeferUpdates() {
+    deferring_updates = true;
+}
+
+void TrackTraffic::CommitUpdates() {
+    deferring_updates = false;
+    // Changes of an actor are kept in the order they were made,
+    // changes of different actors touch different entries.
+    for (DeferredUpdates &updates : deferred_updates) {
+        for (const auto &waypoint_update : updates.waypoints) {
+            if (std::get<2>(waypoint_update)) {
+                UpdatePassingVehicle(std::get<1>(waypoint_update), std::get<0>(waypoint_update));
+            } else {
+                RemovePassingVehicle(std::get<1>(waypoint_update), std::get<0>(waypoint_update));
+            }
+        }
+        for (const auto &grid_update : updates.grids) {
+            SetGridPosition(grid_update.first, grid_update.second);
+        }
+        updates.waypoints.clear();
+        updates.grids.clear();
+    }
+}
 
 bool TrackTraffic::IsGeoGridFree(const GeoGridId geogrid_id) const {
     if (grid_to_actors.find(geogrid_id) != grid_to_actors.end()) {
@@ -128,13 +163,20 @@ void TrackTraffic::DeleteActor(ActorId actor_id) {
 
     if (waypoint_occupied.find(actor_id) != waypoint_occupied.end()) {
         WaypointIdSet waypoint_id_set = waypoint_occupied.at(actor_id);
-        for (const uint64_t &waypoint_id : waypoint_id_set) {
+        for (const WaypointIndex waypoint_id : waypoint_id_set) {
             RemovePassingVehicle(waypoint_id, actor_id);
         }
     }
 }
 
-void TrackTraffic::UpdatePassingVehicle(uint64_t waypoint_id, ActorId actor_id) {
+void TrackTraffic::UpdatePassingVehicle(WaypointIndex waypoint_id, ActorId actor_id) {
+    if (deferring_updates) {
+        DeferredUpdates &updates = GetDeferredUpdates(actor_id);
+        std::lock_guard<std::mutex> lock(updates.mutex);
+        updates.waypoints.emplace_back(actor_id, waypoint_id, true);
+        return;
+    }
+
     if (waypoint_overlap_tracker.find(waypoint_id) != waypoint_overlap_tracker.end()) {
         ActorIdSet &actor_id_set = waypoint_overlap_tracker.at(waypoint_id);
         if (actor_id_set.find(actor_id) == actor_id_set.end()) {
@@ -154,7 +196,14 @@ void TrackTraffic::UpdatePassingVehicle(uint64_t waypoint_id, ActorId actor_id)
     }
 }
 
-void TrackTraffic::RemovePassingVehicle(uint64_t waypoint_id, ActorId actor_id) {
+void TrackTraffic::RemovePassingVehicle(WaypointIndex waypoint_id, ActorId actor_id) {
+    if (deferring_updates) {
+        DeferredUpdates &updates = GetDeferredUpdates(actor_id);
+        std::lock_guard<std::mutex> lock(updates.mutex);
+        updates.waypoints.emplace_back(actor_id, waypoint_id, false);
+        return;
+    }
+
     if (waypoint_overlap_tracker.find(waypoint_id) != waypoint_overlap_tracker.end()) {
         ActorIdSet &actor_id_set = waypoint_overlap_tracker.at(waypoint_id);
         actor_id_set.erase(actor_id);
@@ -174,7 +223,7 @@ void TrackTraffic::RemovePassingVehicle(uint64_t waypoint_id, ActorId actor_id)
     }
 }
 
-ActorIdSet TrackTraffic::GetPassingVehicles(uint64_t waypoint_id) const {
+ActorIdSet TrackTraffic::GetPassingVehicles(WaypointIndex waypoint_id) const {
 
     if (waypoint_overlap_tracker.find(waypoint_id) != waypoint_overlap_tracker.end()) {
         return waypoint_overlap_tracker.at(waypoint_id);
@@ -184,6 +233,11 @@ ActorIdSet TrackTraffic::GetPassingVehicles(uint64_t waypoint_id) const {
 }
 
 void TrackTraffic::Clear() {
+    deferring_updates = false;
+    for (DeferredUpdates &updates : deferred_updates) {
+        updates.waypoints.clear();
+        updates.grids.clear();
+    }
     waypoint_overlap_tracker.clear();
     waypoint_occupied.clear();
     actor_to_grids.clear();
@@ -1,18 +1,22 @@
 
 #pragma once
 
+#include <mutex>
+#include <tuple>
+#include <vector>
+
 #include "carla/road/RoadTypes.h"
 #include "carla/rpc/ActorId.h"
 
-#include "carla/trafficmanager/SimpleWaypoint.h"
+#include "carla/trafficmanager/WaypointBuffer.h"
+#include "carla/trafficmanager/WaypointGraph.h"
 
 namespace carla {
 namespace traffic_manager {
 
 using ActorId = carla::ActorId;
 using ActorIdSet = std::unordered_set<ActorId>;
-using SimpleWaypointPtr = std::shared_ptr<SimpleWaypoint>;
-using Buffer = std::deque<SimpleWaypointPtr>;
+using Buffer = WaypointBuffer;
 using GeoGridId = carla::road::JuncId;
 
 // This class is used to track the waypoint occupancy of all the actors.
@@ -20,11 +24,11 @@ class TrackTraffic {
 
 private:
     /// Structure to keep track of overlapping waypoints between vehicles.
-    using WaypointOverlap = std::unordered_map<uint64_t, ActorIdSet>;
+    using WaypointOverlap = std::unordered_map<WaypointIndex, ActorIdSet>;
     WaypointOverlap waypoint_overlap_tracker;
 
     /// Structure to keep track of waypoints occupied by vehicles;
-    using WaypointIdSet = std::unordered_set<uint64_t>;
+    using WaypointIdSet = std::unordered_set<WaypointIndex>;
     using WaypointOccupancyMap = std::unordered_map<ActorId, WaypointIdSet>;
     WaypointOccupancyMap waypoint_occupied;
 
@@ -35,18 +39,35 @@ private:
     /// Current hero location.
     cg::Location hero_location = cg::Location(0,0,0);
 
+    /// Changes to the vehicle paths made while the updates are deferred,
+    /// split in shards by actor so the workers do not contend on a single lock.
+    struct DeferredUpdates {
+        std::mutex mutex;
+        /// Waypoints entered (true) or left (false) by the actors, in order.
+        std::vector<std::tuple<ActorId, WaypointIndex, bool>> waypoints;
+        /// Geodesic grids the actors' paths go through.
+        std::vector<std::pair<ActorId, std::unordered_set<GeoGridId>>> grids;
+    };
+    std::vector<DeferredUpdates> deferred_updates;
+    bool deferring_updates = false;
+
+    DeferredUpdates &GetDeferredUpdates(const ActorId actor_id);
+    void SetGridPosition(const ActorId actor_id, const std::unordered_set<GeoGridId> &current_grids);
+
 
 public:
     TrackTraffic();
 
-    /// Methods to update, remove and retrieve vehicles passing through a waypoint.
-    void UpdatePassingVehicle(uint64_t waypoint_id, ActorId actor_id);
-    void RemovePassingVehicle(uint64_t waypoint_id, ActorId actor_id);
-    ActorIdSet GetPassingVehicles(uint64_t waypoint_id) const;
+    /// Methods to update, remove and retrieve vehicles passing through a
+    /// waypoint, given by its index in the waypoint graph.
+    void UpdatePassingVehicle(WaypointIndex waypoint_id, ActorId actor_id);
+    void RemovePassingVehicle(WaypointIndex waypoint_id, ActorId actor_id);
+    ActorIdSet GetPassingVehicles(WaypointIndex waypoint_id) const;
 
-    void UpdateGridPosition(const ActorId actor_id, const Buffer &buffer);
+    void UpdateGridPosition(const ActorId actor_id, const Buffer &buffer, const WaypointGraph &waypoint_graph);
     void UpdateUnregisteredGridPosition(const ActorId actor_id,
-                                        const std::vector<SimpleWaypointPtr> waypoints);
+                                        const std::vector<WaypointIndex> &waypoints,
+                                        const WaypointGraph &waypoint_graph);
 
     ActorIdSet GetOverlappingVehicles(ActorId actor_id) const;
     bool IsGeoGridFree(const GeoGridId geogrid_id) const;
@@ -56,6 +77,13 @@ public:
     cg::Location GetHeroLocation() const;
 
 
+    /// Methods to defer the changes of the vehicle paths, so they can be made
+    /// by several workers while the tracked traffic is only read, and to apply
+    /// them once the workers are done. Changes of different actors do not
+    /// depend on each other, so the result does not depend on the workers.
+    void DeferUpdates();
+    void CommitUpdates();
+
     /// Method to delete actor data from tracking.
     void DeleteActor(ActorId actor_id);
 
@@ -19,19 +19,29 @@ TrafficLightStage::TrafficLightStage(
   const Parameters &parameters,
   const cc::World &world,
   TLFrame &output_array,
-  RandomGenerator &random_device)
+  VehicleRandomGenerators &random_devices,
+  const LocalMapPtr &local_map)
   : vehicle_id_list(vehicle_id_list),
     simulation_state(simulation_state),
     buffer_map(buffer_map),
     parameters(parameters),
     world(world),
     output_array(output_array),
-    random_device(random_device) {}
+    random_devices(random_devices),
+    local_map(local_map) {}
+
+void TrafficLightStage::PrepareCycle() {
+  current_timestamp = world.GetSnapshot().GetTimestamp();
+  junction_changes.assign(vehicle_id_list.size(), {JunctionChange::None, -1});
+}
 
 void TrafficLightStage::Update(const unsigned long index) {
   bool traffic_light_hazard = false;
+  std::pair<JunctionChange, JunctionID> &junction_change = junction_changes.at(index);
 
   const ActorId ego_actor_id = vehicle_id_list.at(index);
+  const VehicleParameters &vehicle_parameters = parameters.GetVehicleParameters(index);
+  RandomGenerator &random_device = random_devices.Get(index);
   if (!simulation_state.IsDormant(ego_actor_id)) {
 
     JunctionID current_junction_id = -1;
@@ -40,8 +50,6 @@ void TrafficLightStage::Update(const unsigned long index) {
     }
     auto affected_junction_id = GetAffectedJunctionId(ego_actor_id);
 
-    current_timestamp = world.GetSnapshot().GetTimestamp();
-
     const TrafficLightState tl_state = simulation_state.GetTLS(ego_actor_id);
     const TLS traffic_light_state = tl_state.tl_state;
     const bool is_at_traffic_light = tl_state.at_traffic_light;
@@ -50,10 +58,10 @@ void TrafficLightStage::Update(const unsigned long index) {
     if (is_at_traffic_light &&
         traffic_light_state != TLS::Green &&
         traffic_light_state != TLS::Off &&
-        parameters.GetPercentageRunningLight(ego_actor_id) <= random_device.next()) {
+        vehicle_parameters.perc_run_traffic_light <= random_device.next()) {
       // Remove actor from non-signalized junction if it is affected by a traffic light.
       if (current_junction_id != -1) {
-        RemoveActor(ego_actor_id);
+        junction_change = {JunctionChange::Leave, current_junction_id};
       }
       traffic_light_hazard = true;
     }
@@ -62,24 +70,45 @@ void TrafficLightStage::Update(const unsigned long index) {
     else if (current_junction_id != -1)
     {
       if ( affected_junction_id == -1 || affected_junction_id != current_junction_id ) {
-        RemoveActor(ego_actor_id);
+        junction_change = {JunctionChange::Leave, current_junction_id};
       }
       else {
-        traffic_light_hazard = HandleNonSignalisedJunction(ego_actor_id, affected_junction_id, current_timestamp);
+        junction_change = {JunctionChange::Handle, affected_junction_id};
       }
     }
     else if (affected_junction_id != -1 &&
             !is_at_traffic_light &&
             traffic_light_state != TLS::Green &&
-            parameters.GetPercentageRunningSign(ego_actor_id) <= random_device.next()) {
+            vehicle_parameters.perc_run_traffic_sign <= random_device.next()) {
 
-      AddActorToNonSignalisedJunction(ego_actor_id, affected_junction_id);
+      junction_change = {JunctionChange::Enter, affected_junction_id};
       traffic_light_hazard = true;
     }
   }
   output_array.at(index) = traffic_light_hazard;
 }
 
+void TrafficLightStage::FinishCycle() {
+  for (unsigned long index = 0u; index < junction_changes.size(); ++index) {
+    const ActorId ego_actor_id = vehicle_id_list.at(index);
+    const std::pair<JunctionChange, JunctionID> &junction_change = junction_changes.at(index);
+    switch (junction_change.first) {
+      case JunctionChange::Leave:
+        RemoveActor(ego_actor_id);
+        break;
+      case JunctionChange::Handle:
+        output_array.at(index) = HandleNonSignalisedJunction(ego_actor_id, junction_change.second, current_timestamp);
+        break;
+      case JunctionChange::Enter:
+        AddActorToNonSignalisedJunction(ego_actor_id, junction_change.second);
+        break;
+      default:
+        break;
+    }
+  }
+  junction_changes.clear();
+}
+
 void TrafficLightStage::AddActorToNonSignalisedJunction(const ActorId ego_actor_id, const JunctionID junction_id) {
 
   if (entering_vehicles_map.find(junction_id) == entering_vehicles_map.end()) {
@@ -130,12 +159,13 @@ bool TrafficLightStage::HandleNonSignalisedJunction(const ActorId ego_actor_id,
 }
 
 JunctionID TrafficLightStage::GetAffectedJunctionId(const ActorId ego_actor_id) {
+    const WaypointGraph &waypoint_graph = local_map->GetWaypointGraph();
     const Buffer &waypoint_buffer = buffer_map.at(ego_actor_id);
-    const SimpleWaypointPtr look_ahead_point = GetTargetWaypoint(waypoint_buffer, JUNCTION_LOOK_AHEAD).first;
-    const auto front_point = waypoint_buffer.front();
+    const WaypointIndex look_ahead_point = GetTargetWaypoint(waypoint_graph, waypoint_buffer, JUNCTION_LOOK_AHEAD).first;
+    const WaypointIndex front_point = waypoint_buffer.front();
 
-    auto look_ahead_junction_id = look_ahead_point->GetJunctionId();
-    auto front_junction_id = front_point->GetJunctionId();
+    auto look_ahead_junction_id = waypoint_graph.GetRecord(look_ahead_point).junction_id;
+    auto front_junction_id = waypoint_graph.GetRecord(front_point).junction_id;
 
     // Check if the vehicle is currently at a non-signalized junction
     JunctionID current_junction_id = -1;
@@ -2,6 +2,7 @@
 #pragma once
 
 #include "carla/trafficmanager/DataStructures.h"
+#include "carla/trafficmanager/InMemoryMap.h"
 #include "carla/trafficmanager/Parameters.h"
 #include "carla/trafficmanager/RandomGenerator.h"
 #include "carla/trafficmanager/SimulationState.h"
@@ -10,6 +11,8 @@
 namespace carla {
 namespace traffic_manager {
 
+using LocalMapPtr = std::shared_ptr<InMemoryMap>;
+
 /// This class has functionality for responding to traffic lights
 /// and managing entry into non-signalized junctions.
 class TrafficLightStage: Stage {
@@ -29,9 +32,22 @@ private:
   /// Map containing the timestamp at which the actor first stopped at a stop sign.
   std::unordered_map<ActorId, cc::Timestamp> vehicle_stop_time;
   TLFrame &output_array;
-  RandomGenerator &random_device;
+  VehicleRandomGenerators &random_devices;
+  const LocalMapPtr &local_map;
   cc::Timestamp current_timestamp;
 
+  /// Change a vehicle makes to the non signalized junction structures.
+  /// Vehicles only read their own entries while they are updated, the
+  /// changes are applied in order once all of them are, as vehicles arriving
+  /// first get priority.
+  enum class JunctionChange : uint8_t {
+    None,
+    Leave,
+    Handle,
+    Enter
+  };
+  std::vector<std::pair<JunctionChange, JunctionID>> junction_changes;
+
   /// This controls all vehicle's interactions at non signalized junctions. Priorities are done by order of arrival
   /// and no two vehicle will enter the junction at the same time. Only once it is exiting can the next one enter.
   /// Additionally, all vehicles will always brake at the stop sign for a set amount of time.
@@ -51,10 +67,17 @@ public:
                     const Parameters &parameters,
                     const cc::World &world,
                     TLFrame &output_array,
-                    RandomGenerator &random_device);
+                    VehicleRandomGenerators &random_devices,
+                    const LocalMapPtr &local_map);
+
+  /// Method to prepare the cycle before the vehicles are updated, possibly from several workers.
+  void PrepareCycle();
 
   void Update(const unsigned long index) override;
 
+  /// Method to apply the changes to the non signalized junctions once all vehicles are updated.
+  void FinishCycle();
+
   void RemoveActor(const ActorId actor_id) override;
 
   void Reset() override;
@@ -65,6 +65,15 @@ public:
     }
   }
 
+  /// Method to set the number of threads used to update the vehicles.
+  /// A value of 0 uses all the available hardware threads.
+  void SetWorkerThreads(const uint64_t threads) {
+    TrafficManagerBase* tm_ptr = GetTM(_port);
+    if (tm_ptr != nullptr) {
+      tm_ptr->SetWorkerThreads(threads);
+    }
+  }
+
   /// Method to set our own imported path.
   void SetCustomPath(const ActorPtr &actor, const Path path, const bool empty_buffer) {
     TrafficManagerBase* tm_ptr = GetTM(_port);
@@ -194,6 +203,16 @@ public:
     }
   }
 
+  /// Set several per-vehicle parameters at once. All of them take effect in
+  /// the same cycle and, for a remote traffic manager, are sent with a
+  /// single call.
+  void SetVehicleParameters(const std::vector<VehicleParameterUpdate> &updates) {
+    TrafficManagerBase* tm_ptr = GetTM(_port);
+    if(tm_ptr != nullptr){
+      tm_ptr->SetVehicleParameters(updates);
+    }
+  }
+
   /// Set a global % decrease in velocity with respect to the speed limit.
   /// If less than 0, it's a % increase.
   void SetGlobalPercentageSpeedDifference(float const percentage){
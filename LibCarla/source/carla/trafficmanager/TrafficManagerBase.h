@@ -9,6 +9,7 @@
 #include <memory>
 #include "carla/client/Actor.h"
 #include "carla/trafficmanager/SimpleWaypoint.h"
+#include "carla/trafficmanager/VehicleParameterUpdate.h"
 
 namespace carla {
 namespace traffic_manager {
@@ -61,6 +62,10 @@ public:
   /// Set a vehicle's exact desired velocity.
   virtual void SetDesiredSpeed(const ActorPtr &actor, const float value) = 0;
 
+  /// Set several per-vehicle parameters at once, all of them take effect
+  /// in the same cycle of the traffic manager.
+  virtual void SetVehicleParameters(const std::vector<VehicleParameterUpdate> &updates) = 0;
+
   /// Set a global % decrease in velocity with respect to the speed limit.
   /// If less than 0, it's a % increase.
   virtual void SetGlobalPercentageSpeedDifference(float const percentage) = 0;
@@ -134,6 +139,9 @@ public:
   /// Method to set Open Street Map mode.
   virtual void SetOSMMode(const bool mode_switch) = 0;
 
+  /// Method to set the number of threads used to update the vehicles.
+  virtual void SetWorkerThreads(const uint64_t threads) = 0;
+
   /// Method to set our own imported path.
   virtual void SetCustomPath(const ActorPtr &actor, const Path path, const bool empty_buffer) = 0;
 
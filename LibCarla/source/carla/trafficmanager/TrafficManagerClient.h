@@ -8,6 +8,7 @@
 
 #include "carla/trafficmanager/Constants.h"
 #include "carla/rpc/Actor.h"
+#include "carla/trafficmanager/VehicleParameterUpdate.h"
 
 #include <rpc/client.h>
 
@@ -94,6 +95,12 @@ public:
     _client->call("set_desired_speed", std::move(_actor), value);
   }
 
+  /// Set several per-vehicle parameters with a single call.
+  void SetVehicleParameters(const std::vector<VehicleParameterUpdate> &updates) {
+    DEBUG_ASSERT(_client != nullptr);
+    _client->call("set_vehicle_parameters", updates);
+  }
+
   /// Method to set a global % decrease in velocity with respect to the speed limit.
   /// If less than 0, it's a % increase.
   void SetGlobalPercentageSpeedDifference(const float percentage) {
@@ -237,6 +244,12 @@ public:
     _client->call("set_osm_mode", mode_switch);
   }
 
+  /// Method to set the number of threads used to update the vehicles.
+  void SetWorkerThreads(const uint64_t threads) {
+    DEBUG_ASSERT(_client != nullptr);
+    _client->call("set_worker_threads", threads);
+  }
+
   /// Method to set our own imported path.
   void SetCustomPath(const carla::rpc::Actor &actor, const Path path, const bool empty_buffer) {
     DEBUG_ASSERT(_client != nullptr);
@@ -8,6 +8,7 @@
 
 #include "carla/Logging.h"
 
+#include "carla/client/FileTransfer.h"
 #include "carla/client/detail/Simulator.h"
 
 #include "carla/trafficmanager/TrafficManagerLocal.h"
@@ -34,54 +35,57 @@ TrafficManagerLocal::TrafficManagerLocal(
     episode_proxy(episode_proxy),
     world(cc::World(episode_proxy)),
 
-    localization_stage(LocalizationStage(vehicle_id_list,
-                                         buffer_map,
-                                         simulation_state,
-                                         track_traffic,
-                                         local_map,
-                                         parameters,
-                                         marked_for_removal,
-                                         localization_frame,
-                                         random_device)),
-
-    collision_stage(CollisionStage(vehicle_id_list,
-                                   simulation_state,
-                                   buffer_map,
-                                   track_traffic,
-                                   parameters,
-                                   collision_frame,
-                                   random_device)),
-
-    traffic_light_stage(TrafficLightStage(vehicle_id_list,
-                                          simulation_state,
-                                          buffer_map,
-                                          parameters,
-                                          world,
-                                          tl_frame,
-                                          random_device)),
-
-    motion_plan_stage(MotionPlanStage(vehicle_id_list,
-                                      simulation_state,
-                                      parameters,
-                                      buffer_map,
-                                      track_traffic,
-                                      longitudinal_PID_parameters,
-                                      longitudinal_highway_PID_parameters,
-                                      lateral_PID_parameters,
-                                      lateral_highway_PID_parameters,
-                                      localization_frame,
-                                      collision_frame,
-                                      tl_frame,
-                                      world,
-                                      control_frame,
-                                      random_device,
-                                      local_map)),
+    localization_stage(vehicle_id_list,
+                       buffer_map,
+                       simulation_state,
+                       track_traffic,
+                       local_map,
+                       parameters,
+                       marked_for_removal,
+                       localization_frame,
+                       random_devices),
+
+    collision_stage(vehicle_id_list,
+                    simulation_state,
+                    buffer_map,
+                    track_traffic,
+                    parameters,
+                    collision_frame,
+                    random_devices,
+                    local_map),
+
+    traffic_light_stage(vehicle_id_list,
+                        simulation_state,
+                        buffer_map,
+                        parameters,
+                        world,
+                        tl_frame,
+                        random_devices,
+                        local_map),
+
+    motion_plan_stage(vehicle_id_list,
+                      simulation_state,
+                      parameters,
+                      buffer_map,
+                      track_traffic,
+                      longitudinal_PID_parameters,
+                      longitudinal_highway_PID_parameters,
+                      lateral_PID_parameters,
+                      lateral_highway_PID_parameters,
+                      localization_frame,
+                      collision_frame,
+                      tl_frame,
+                      world,
+                      control_frame,
+                      random_devices,
+                      local_map),
 
     vehicle_light_stage(VehicleLightStage(vehicle_id_list,
                                           buffer_map,
                                           parameters,
                                           world,
-                                          control_frame)),
+                                          control_frame,
+                                          local_map)),
 
     alsm(ALSM(registered_vehicles,
               buffer_map,
@@ -117,16 +121,11 @@ void TrafficManagerLocal::SetupLocalMap() {
   const carla::SharedPtr<const cc::Map> world_map = world.GetMap();
   local_map = std::make_shared<InMemoryMap>(world_map);
 
+  // Required files are downloaded into the cache folder if missing, the
+  // cooked map is then mapped from there and read in place while the local
+  // map is alive.
   auto files = episode_proxy.Lock()->GetRequiredFiles("TM");
-  if (!files.empty()) {
-    auto content = episode_proxy.Lock()->GetCacheFile(files[0], true);
-    if (content.size() != 0) {
-      local_map->Load(content);
-    } else {
-      log_warning("No InMemoryMap cache found. Setting up local map. This may take a while...");
-      local_map->SetUp();
-    }
-  } else {
+  if (files.empty() || !local_map->Load(cc::FileTransfer::GetFilePath(files[0]))) {
     log_warning("No InMemoryMap cache found. Setting up local map. This may take a while...");
     local_map->SetUp();
   }
@@ -203,6 +202,9 @@ void TrafficManagerLocal::Run() {
       registered_vehicles_state = registered_vehicles.GetState();
     }
 
+    // Taking the parameters set since the last cycle, read by the stages without locking.
+    parameters.UpdateTable(vehicle_id_list);
+
     // Reset frames for current cycle.
     localization_frame.clear();
     localization_frame.resize(number_of_vehicles);
@@ -218,20 +220,39 @@ void TrafficManagerLocal::Run() {
     // that will be inserted by the motion_plan_stage stage.
     control_frame.resize(number_of_vehicles);
 
-    // Run core operation stages.
-    for (unsigned long index = 0u; index < vehicle_id_list.size(); ++index) {
+    // Resize the worker pool if the number of threads has changed.
+    stage_executor.SetNumberOfWorkers(parameters.GetWorkerThreads());
+    const std::size_t number_of_workers = stage_executor.GetNumberOfWorkers();
+    random_devices.Update(vehicle_id_list);
+
+    // Run core operation stages, splitting the vehicles across workers. Changes a vehicle
+    // makes to the state shared with other vehicles are applied once the stage finishes.
+    localization_stage.PrepareCycle(number_of_workers);
+    stage_executor.ParallelFor(number_of_vehicles, [this](const unsigned long index) {
       localization_stage.Update(index);
-    }
-    for (unsigned long index = 0u; index < vehicle_id_list.size(); ++index) {
+    });
+    localization_stage.FinishCycle();
+
+    collision_stage.PrepareCycle(number_of_workers);
+    stage_executor.ParallelFor(number_of_vehicles, [this](const unsigned long index) {
       collision_stage.Update(index);
-    }
+    });
     collision_stage.ClearCycleCache();
-    vehicle_light_stage.UpdateWorldInfo();
-    for (unsigned long index = 0u; index < vehicle_id_list.size(); ++index) {
+
+    traffic_light_stage.PrepareCycle();
+    stage_executor.ParallelFor(number_of_vehicles, [this](const unsigned long index) {
       traffic_light_stage.Update(index);
+    });
+    traffic_light_stage.FinishCycle();
+
+    motion_plan_stage.PrepareCycle(number_of_workers);
+    vehicle_light_stage.UpdateWorldInfo();
+    stage_executor.ParallelFor(number_of_vehicles, [this](const unsigned long index) {
       motion_plan_stage.Update(index);
       vehicle_light_stage.Update(index);
-    }
+    });
+    motion_plan_stage.FinishCycle();
+    vehicle_light_stage.FinishCycle();
 
     registration_lock.unlock();
 
@@ -346,6 +367,10 @@ void TrafficManagerLocal::SetDesiredSpeed(const ActorPtr &actor, const float val
   parameters.SetDesiredSpeed(actor, value);
 }
 
+void TrafficManagerLocal::SetVehicleParameters(const std::vector<VehicleParameterUpdate> &updates) {
+  parameters.SetVehicleParameters(updates);
+}
+
 /// Method to set the automatic management of the vehicle lights
 void TrafficManagerLocal::SetUpdateVehicleLights(const ActorPtr &actor, const bool do_update) {
   parameters.SetUpdateVehicleLights(actor, do_update);
@@ -411,6 +436,10 @@ void TrafficManagerLocal::SetOSMMode(const bool mode_switch) {
   parameters.SetOSMMode(mode_switch);
 }
 
+void TrafficManagerLocal::SetWorkerThreads(const uint64_t threads) {
+  parameters.SetWorkerThreads(threads);
+}
+
 void TrafficManagerLocal::SetCustomPath(const ActorPtr &actor, const Path path, const bool empty_buffer) {
   parameters.SetCustomPath(actor, path, empty_buffer);
 }
@@ -486,8 +515,11 @@ std::vector<ActorId> TrafficManagerLocal::GetRegisteredVehiclesIDs() {
 }
 
 void TrafficManagerLocal::SetRandomDeviceSeed(const uint64_t _seed) {
-  seed = _seed;
-  random_device = RandomGenerator(seed);
+  {
+    std::lock_guard<std::mutex> registration_lock(registration_mutex);
+    seed = _seed;
+    random_devices.SetSeed(seed);
+  }
   world.ResetAllTrafficLights();
 }
 
@@ -23,6 +23,7 @@
 #include "carla/trafficmanager/Parameters.h"
 #include "carla/trafficmanager/RandomGenerator.h"
 #include "carla/trafficmanager/SimulationState.h"
+#include "carla/trafficmanager/StageExecutor.h"
 #include "carla/trafficmanager/TrackTraffic.h"
 #include "carla/trafficmanager/TrafficManagerBase.h"
 #include "carla/trafficmanager/TrafficManagerServer.h"
@@ -95,6 +96,8 @@ private:
   MotionPlanStage motion_plan_stage;
   VehicleLightStage vehicle_light_stage;
   ALSM alsm;
+  /// Worker pool to run the per-vehicle updates of stages in parallel.
+  StageExecutor stage_executor;
   /// Traffic manager server instance.
   TrafficManagerServer server;
   /// Switch to turn on / turn off traffic manager.
@@ -112,7 +115,7 @@ private:
   /// Randomization seed.
   uint64_t seed {static_cast<uint64_t>(time(NULL))};
   /// Structure holding random devices per vehicle.
-  RandomGenerator random_device = RandomGenerator(seed);
+  VehicleRandomGenerators random_devices = VehicleRandomGenerators(seed);
   std::vector<ActorId> marked_for_removal;
   /// Mutex to prevent vehicle registration during frame array re-allocation.
   std::mutex registration_mutex;
@@ -164,6 +167,10 @@ public:
   /// Set a vehicle's exact desired velocity.
   void SetDesiredSpeed(const ActorPtr &actor, const float value);
 
+  /// Set several per-vehicle parameters at once, all of them take effect
+  /// in the same cycle of the traffic manager.
+  void SetVehicleParameters(const std::vector<VehicleParameterUpdate> &updates);
+
   /// Method to set a global % decrease in velocity with respect to the speed limit.
   /// If less than 0, it's a % increase.
   void SetGlobalPercentageSpeedDifference(float const percentage);
@@ -245,6 +252,9 @@ public:
   /// Method to set Open Street Map mode.
   void SetOSMMode(const bool mode_switch);
 
+  /// Method to set the number of threads used to update the vehicles.
+  void SetWorkerThreads(const uint64_t threads);
+
   /// Method to set our own imported path.
   void SetCustomPath(const ActorPtr &actor, const Path path, const bool empty_buffer);
 
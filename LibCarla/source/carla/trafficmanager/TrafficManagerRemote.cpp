@@ -117,6 +117,10 @@ void TrafficManagerRemote::SetDesiredSpeed(const ActorPtr &_actor, const float v
   client.SetDesiredSpeed(actor, value);
 }
 
+void TrafficManagerRemote::SetVehicleParameters(const std::vector<VehicleParameterUpdate> &updates) {
+  client.SetVehicleParameters(updates);
+}
+
 void TrafficManagerRemote::SetGlobalPercentageSpeedDifference(const float percentage) {
   client.SetGlobalPercentageSpeedDifference(percentage);
 }
@@ -221,6 +225,10 @@ void TrafficManagerRemote::SetOSMMode(const bool mode_switch) {
   client.SetOSMMode(mode_switch);
 }
 
+void TrafficManagerRemote::SetWorkerThreads(const uint64_t threads) {
+  client.SetWorkerThreads(threads);
+}
+
 void TrafficManagerRemote::SetCustomPath(const ActorPtr &_actor, const Path path, const bool empty_buffer) {
   carla::rpc::Actor actor(_actor->Serialize());
 
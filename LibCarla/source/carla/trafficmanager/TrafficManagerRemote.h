@@ -64,6 +64,10 @@ public:
   /// Set a vehicle's exact desired velocity.
   void SetDesiredSpeed(const ActorPtr &actor, const float value);
 
+  /// Set several per-vehicle parameters at once, all of them take effect
+  /// in the same cycle of the traffic manager.
+  void SetVehicleParameters(const std::vector<VehicleParameterUpdate> &updates);
+
   /// Method to set a global % decrease in velocity with respect to the speed limit.
   /// If less than 0, it's a % increase.
   void SetGlobalPercentageSpeedDifference(float const percentage);
@@ -128,6 +132,9 @@ public:
   /// Method to set Open Street Map mode.
   void SetOSMMode(const bool mode_switch);
 
+  /// Method to set the number of threads used to update the vehicles.
+  void SetWorkerThreads(const uint64_t threads);
+
   /// Method to set our own imported path.
   void SetCustomPath(const ActorPtr &actor, const Path path, const bool empty_buffer);
 
@@ -105,6 +105,11 @@ public:
         tm->SetDesiredSpeed(carla::client::detail::ActorVariant(actor).Get(tm->GetEpisodeProxy()), value);
       });
 
+      /// Set several per-vehicle parameters at once, by actor id.
+      server->bind("set_vehicle_parameters", [=](const std::vector<VehicleParameterUpdate> &updates) {
+        tm->SetVehicleParameters(updates);
+      });
+
       /// Method to set the automatic management of the vehicle lights
       server->bind("update_vehicle_lights", [=](carla::rpc::Actor actor, const bool do_update) {
         tm->SetUpdateVehicleLights(carla::client::detail::ActorVariant(actor).Get(tm->GetEpisodeProxy()), do_update);
@@ -203,6 +208,11 @@ public:
         tm->SetOSMMode(mode_switch);
       });
 
+      /// Method to set the number of threads used to update the vehicles.
+      server->bind("set_worker_threads", [=](const uint64_t threads) {
+        tm->SetWorkerThreads(threads);
+      });
+
       /// Method to set our own imported path.
       server->bind("set_path", [=](carla::rpc::Actor actor, const Path path, const bool empty_buffer) {
         tm->SetCustomPath(carla::client::detail::ActorVariant(actor).Get(tm->GetEpisodeProxy()), path, empty_buffer);
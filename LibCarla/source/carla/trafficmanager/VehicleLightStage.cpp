@@ -14,23 +14,37 @@ VehicleLightStage::VehicleLightStage(
   const BufferMap &buffer_map,
   const Parameters &parameters,
   const cc::World &world,
-  ControlFrame& control_frame)
+  ControlFrame& control_frame,
+  const LocalMapPtr &local_map)
   : vehicle_id_list(vehicle_id_list),
     buffer_map(buffer_map),
     parameters(parameters),
     world(world),
-    control_frame(control_frame) {}
+    control_frame(control_frame),
+    local_map(local_map) {}
 
 void VehicleLightStage::UpdateWorldInfo() {
   // Get the global weather and all the vehicle light states at once
   all_light_states = world.GetVehiclesLightStates();
   weather = world.GetWeather();
+  light_state_changes.assign(vehicle_id_list.size(), {false, rpc::VehicleLightState::flag_type(0)});
+}
+
+void VehicleLightStage::FinishCycle() {
+  for (unsigned long index = 0u; index < light_state_changes.size(); ++index) {
+    const auto &light_state_change = light_state_changes.at(index);
+    if (light_state_change.first) {
+      control_frame.push_back(carla::rpc::Command::SetVehicleLightState(vehicle_id_list.at(index),
+                                                                        light_state_change.second));
+    }
+  }
+  light_state_changes.clear();
 }
 
 void VehicleLightStage::Update(const unsigned long index) {
   ActorId actor_id = vehicle_id_list.at(index);
 
-  if (!parameters.GetUpdateVehicleLights(actor_id))
+  if (!parameters.GetVehicleParameters(index).update_vehicle_lights)
     return; // this vehicle is not set to have automatic lights update
 
   rpc::VehicleLightState::flag_type light_states = uint32_t(-1);
@@ -52,29 +66,28 @@ void VehicleLightStage::Update(const unsigned long index) {
 
   // Determine if the vehicle is truning left or right by checking the close waypoints
 
+  const WaypointGraph &waypoint_graph = local_map->GetWaypointGraph();
   const Buffer& waypoint_buffer = buffer_map.at(actor_id);
-  cg::Location front_location = waypoint_buffer.front()->GetLocation();
+  cg::Location front_location = waypoint_graph.GetLocation(waypoint_buffer.front());
 
-  for (const SimpleWaypointPtr& waypoint : waypoint_buffer) {
-    if (waypoint->CheckJunction()) {
-      RoadOption target_ro = waypoint->GetRoadOption();
+  for (const WaypointIndex waypoint_index : waypoint_buffer) {
+    const WaypointRecord &waypoint = waypoint_graph.GetRecord(waypoint_index);
+    if (waypoint.is_junction) {
+      RoadOption target_ro = waypoint.road_option;
       if (target_ro == RoadOption::Left) left_turn_indicator = true;
       else if (target_ro == RoadOption::Right) right_turn_indicator = true;
       break;
     }
-    if (cg::Math::DistanceSquared(front_location, waypoint->GetLocation()) > MAX_DISTANCE_LIGHT_CHECK) {
+    if (cg::Math::DistanceSquared(front_location, waypoint.location) > MAX_DISTANCE_LIGHT_CHECK) {
       break;
     }
   }
 
-  // Determine brake light state
-  for (size_t cc = 0; cc < control_frame.size(); cc++) {
-    if (auto* maybe_ctrl = boost::variant2::get_if<carla::rpc::Command::ApplyVehicleControl>(&control_frame[cc].command)) {
-      carla::rpc::Command::ApplyVehicleControl& ctrl = *maybe_ctrl;
-      if (ctrl.actor == actor_id) {
-        brake_lights = (ctrl.control.brake > 0.5); // hard braking, avoid blinking for throttle control
-        break;
-      }
+  // Determine brake light state from the command the motion planner set for the vehicle.
+  if (auto* maybe_ctrl = boost::variant2::get_if<carla::rpc::Command::ApplyVehicleControl>(&control_frame.at(index).command)) {
+    carla::rpc::Command::ApplyVehicleControl& ctrl = *maybe_ctrl;
+    if (ctrl.actor == actor_id) {
+      brake_lights = (ctrl.control.brake > 0.5); // hard braking, avoid blinking for throttle control
     }
   }
 
@@ -143,7 +156,7 @@ void VehicleLightStage::Update(const unsigned long index) {
 
   // Update the vehicle light state if it has changed
   if (new_light_states != light_states)
-    control_frame.push_back(carla::rpc::Command::SetVehicleLightState(actor_id, new_light_states));
+    light_state_changes.at(index) = {true, new_light_states};
 }
 
 void VehicleLightStage::RemoveActor(const ActorId) {
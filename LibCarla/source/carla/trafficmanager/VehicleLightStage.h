@@ -2,6 +2,7 @@
 #pragma once
 
 #include "carla/trafficmanager/DataStructures.h"
+#include "carla/trafficmanager/InMemoryMap.h"
 #include "carla/trafficmanager/Parameters.h"
 #include "carla/trafficmanager/RandomGenerator.h"
 #include "carla/trafficmanager/SimulationState.h"
@@ -10,6 +11,8 @@
 namespace carla {
 namespace traffic_manager {
 
+using LocalMapPtr = std::shared_ptr<InMemoryMap>;
+
 /// This class has functionality for turning on/off the vehicle lights
 /// according to the current vehicle state and its surrounding environment.
 class VehicleLightStage: Stage {
@@ -19,22 +22,31 @@ private:
   const Parameters &parameters;
   const cc::World &world;
   ControlFrame& control_frame;
+  const LocalMapPtr &local_map;
   /// All vehicle light states
   rpc::VehicleLightStateList all_light_states;
   /// Current weather parameters
   rpc::WeatherParameters weather;
+  /// New light state of each vehicle, if it changed, appended to the
+  /// control frame in order once all vehicles are updated.
+  std::vector<std::pair<bool, rpc::VehicleLightState::flag_type>> light_state_changes;
 
 public:
   VehicleLightStage(const std::vector<ActorId> &vehicle_id_list,
                     const BufferMap &buffer_map,
                     const Parameters &parameters,
                     const cc::World &world,
-                    ControlFrame& control_frame);
+                    ControlFrame& control_frame,
+                    const LocalMapPtr &local_map);
 
+  /// Method to get the world information before the vehicles are updated, possibly from several workers.
   void UpdateWorldInfo();
 
   void Update(const unsigned long index) override;
 
+  /// Method to add the light state changes to the control frame once all vehicles are updated.
+  void FinishCycle();
+
   void RemoveActor(const ActorId actor_id) override;
 
   void Reset() override;
@@ -0,0 +1,49 @@
+// Copyright (c) 2023 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/MsgPack.h"
+#include "carla/rpc/ActorId.h"
+
+#include <cstdint>
+
+namespace carla {
+namespace traffic_manager {
+
+  /// Per-vehicle parameters that can be set in bulk.
+  enum class VehicleParameterId : uint8_t {
+    PercentageSpeedDifference,
+    LaneOffset,
+    DesiredSpeed,
+    UpdateVehicleLights,
+    ForceLaneChange,
+    AutoLaneChange,
+    DistanceToLeadingVehicle,
+    PercentageRunningLight,
+    PercentageRunningSign,
+    PercentageIgnoreWalkers,
+    PercentageIgnoreVehicles,
+    KeepRightPercentage,
+    RandomLeftLaneChangePercentage,
+    RandomRightLaneChangePercentage,
+  };
+
+  /// Sets a parameter of a vehicle, same as its individual setter. The
+  /// parameters that are flags are set if @a value is not zero; in the case
+  /// of ForceLaneChange the flag is the direction, true for left.
+  struct VehicleParameterUpdate {
+    ActorId actor_id = 0u;
+    VehicleParameterId parameter = VehicleParameterId::PercentageSpeedDifference;
+    float value = 0.0f;
+
+    MSGPACK_DEFINE_ARRAY(actor_id, parameter, value);
+  };
+
+} // namespace traffic_manager
+} // namespace carla
+
+MSGPACK_ADD_ENUM(carla::traffic_manager::VehicleParameterId);
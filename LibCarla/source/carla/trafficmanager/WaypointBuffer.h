@@ -0,0 +1,143 @@
+// Copyright (c) 2023 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <vector>
+
+#include "carla/Debug.h"
+#include "carla/trafficmanager/WaypointGraph.h"
+
+namespace carla {
+namespace traffic_manager {
+
+/// Path of a vehicle, as a ring buffer of indices into the waypoint graph of
+/// the local map. The capacity is a power of two that only grows, so a
+/// vehicle following its path does not allocate once its buffer is warm.
+class WaypointBuffer {
+public:
+
+  class const_iterator {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = WaypointIndex;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const WaypointIndex *;
+    using reference = WaypointIndex;
+
+    const_iterator(const WaypointBuffer &buffer, std::size_t position)
+      : _buffer(&buffer), _position(position) {}
+
+    WaypointIndex operator*() const {
+      return (*_buffer)[_position];
+    }
+
+    const_iterator &operator++() {
+      ++_position;
+      return *this;
+    }
+
+    const_iterator operator++(int) {
+      const_iterator previous = *this;
+      ++_position;
+      return previous;
+    }
+
+    bool operator==(const const_iterator &rhs) const {
+      return _buffer == rhs._buffer && _position == rhs._position;
+    }
+
+    bool operator!=(const const_iterator &rhs) const {
+      return !(*this == rhs);
+    }
+
+  private:
+    const WaypointBuffer *_buffer;
+    std::size_t _position;
+  };
+
+  bool empty() const {
+    return _size == 0u;
+  }
+
+  std::size_t size() const {
+    return _size;
+  }
+
+  std::size_t capacity() const {
+    return _data.size();
+  }
+
+  WaypointIndex operator[](const std::size_t position) const {
+    DEBUG_ASSERT(position < _size);
+    return _data[(_head + position) & (_data.size() - 1u)];
+  }
+
+  WaypointIndex front() const {
+    return (*this)[0u];
+  }
+
+  WaypointIndex back() const {
+    return (*this)[_size - 1u];
+  }
+
+  const_iterator begin() const {
+    return {*this, 0u};
+  }
+
+  const_iterator end() const {
+    return {*this, _size};
+  }
+
+  void push_back(const WaypointIndex index) {
+    if (_size == _data.size()) {
+      Grow();
+    }
+    _data[(_head + _size) & (_data.size() - 1u)] = index;
+    ++_size;
+  }
+
+  void pop_front() {
+    DEBUG_ASSERT(_size > 0u);
+    _head = (_head + 1u) & (_data.size() - 1u);
+    --_size;
+  }
+
+  void pop_back() {
+    DEBUG_ASSERT(_size > 0u);
+    --_size;
+  }
+
+  void clear() {
+    _head = 0u;
+    _size = 0u;
+  }
+
+private:
+
+  /// Doubles the capacity, moving the waypoints to the beginning of the new
+  /// storage.
+  void Grow() {
+    std::vector<WaypointIndex> data(std::max<std::size_t>(16u, 2u * _data.size()));
+    for (std::size_t i = 0u; i < _size; ++i) {
+      data[i] = (*this)[i];
+    }
+    _data = std::move(data);
+    _head = 0u;
+  }
+
+  std::vector<WaypointIndex> _data;
+
+  std::size_t _head = 0u;
+
+  std::size_t _size = 0u;
+};
+
+} // namespace traffic_manager
+} // namespace carla
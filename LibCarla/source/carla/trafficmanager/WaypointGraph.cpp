@@ -0,0 +1,108 @@
+// Copyright (c) 2023 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "carla/trafficmanager/WaypointGraph.h"
+
+#include <cstring>
+
+namespace carla {
+namespace traffic_manager {
+
+  void WaypointGraph::Build(const std::vector<SimpleWaypointPtr> &dense_topology) {
+    Clear();
+
+    const WaypointIndex size = static_cast<WaypointIndex>(dense_topology.size());
+    for (WaypointIndex i = 0u; i < size; ++i) {
+      dense_topology[i]->SetGraphIndex(i);
+    }
+
+    auto index_of = [](const SimpleWaypointPtr &swp) {
+      return swp == nullptr ? INVALID_WAYPOINT_INDEX : swp->GetGraphIndex();
+    };
+
+    std::vector<WaypointRecord> records_data;
+    std::vector<uint32_t> next_offsets_data;
+    std::vector<WaypointIndex> next_indices_data;
+    std::vector<uint32_t> previous_offsets_data;
+    std::vector<WaypointIndex> previous_indices_data;
+    records_data.reserve(size);
+    next_offsets_data.reserve(size + 1u);
+    previous_offsets_data.reserve(size + 1u);
+    next_offsets_data.push_back(0u);
+    previous_offsets_data.push_back(0u);
+
+    for (const SimpleWaypointPtr &swp : dense_topology) {
+      const WaypointPtr &waypoint = swp->GetWaypoint();
+      const cg::Transform transform = waypoint->GetTransform();
+      WaypointRecord record;
+      // Cleared so the padding is written as zeros to cooked map files.
+      std::memset(static_cast<void *>(&record), 0, sizeof(record));
+      record.location = transform.location;
+      record.forward_vector = transform.rotation.GetForwardVector();
+      record.rotation = transform.rotation;
+      record.id = waypoint->GetId();
+      record.s = waypoint->GetDistance();
+      record.road_id = waypoint->GetRoadId();
+      record.section_id = waypoint->GetSectionId();
+      record.lane_id = waypoint->GetLaneId();
+      record.junction_id = waypoint->GetJunctionId();
+      record.geodesic_grid_id = swp->GetGeodesicGridId();
+      record.left = index_of(swp->GetLeftWaypoint());
+      record.right = index_of(swp->GetRightWaypoint());
+      record.road_option = swp->GetRoadOption();
+      record.is_junction = swp->CheckJunction();
+      records_data.push_back(record);
+
+      for (const SimpleWaypointPtr &next : swp->GetNextWaypoint()) {
+        const WaypointIndex next_index = index_of(next);
+        if (next_index != INVALID_WAYPOINT_INDEX) {
+          next_indices_data.push_back(next_index);
+        }
+      }
+      next_offsets_data.push_back(static_cast<uint32_t>(next_indices_data.size()));
+
+      for (const SimpleWaypointPtr &previous : swp->GetPreviousWaypoint()) {
+        const WaypointIndex previous_index = index_of(previous);
+        if (previous_index != INVALID_WAYPOINT_INDEX) {
+          previous_indices_data.push_back(previous_index);
+        }
+      }
+      previous_offsets_data.push_back(static_cast<uint32_t>(previous_indices_data.size()));
+    }
+
+    records.assign(std::move(records_data));
+    next_offsets.assign(std::move(next_offsets_data));
+    next_indices.assign(std::move(next_indices_data));
+    previous_offsets.assign(std::move(previous_offsets_data));
+    previous_indices.assign(std::move(previous_indices_data));
+  }
+
+  void WaypointGraph::Attach(const WaypointRecord *records_data, const std::size_t size,
+                             const uint32_t *next_offsets_data, const WaypointIndex *next_indices_data, const std::size_t next_count,
+                             const uint32_t *previous_offsets_data, const WaypointIndex *previous_indices_data, const std::size_t previous_count) {
+    records.attach(records_data, size);
+    next_offsets.attach(next_offsets_data, size + 1u);
+    next_indices.attach(next_indices_data, next_count);
+    previous_offsets.attach(previous_offsets_data, size + 1u);
+    previous_indices.attach(previous_indices_data, previous_count);
+  }
+
+  void WaypointGraph::Clear() {
+    records.clear();
+    next_offsets.clear();
+    next_indices.clear();
+    previous_offsets.clear();
+    previous_indices.clear();
+  }
+
+  std::size_t WaypointGraph::GetMemoryUsage() const {
+    return records.owned_memory()
+        + next_offsets.owned_memory() + next_indices.owned_memory()
+        + previous_offsets.owned_memory() + previous_indices.owned_memory();
+  }
+
+} // namespace traffic_manager
+} // namespace carla
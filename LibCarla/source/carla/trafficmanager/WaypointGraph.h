@@ -0,0 +1,162 @@
+// Copyright (c) 2023 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include "carla/geom/Location.h"
+#include "carla/geom/Math.h"
+#include "carla/geom/Rotation.h"
+#include "carla/geom/Transform.h"
+#include "carla/geom/Vector3D.h"
+#include "carla/road/RoadTypes.h"
+#include "carla/trafficmanager/PackedArray.h"
+#include "carla/trafficmanager/SimpleWaypoint.h"
+
+namespace carla {
+namespace traffic_manager {
+
+  namespace cg = carla::geom;
+  namespace crd = carla::road;
+
+  using WaypointIndex = uint32_t;
+
+  /// Index used for missing links.
+  static constexpr WaypointIndex INVALID_WAYPOINT_INDEX = std::numeric_limits<WaypointIndex>::max();
+
+  /// Plain data of a waypoint of the local map. Cooked map files store these
+  /// records as they are laid out in memory.
+  struct WaypointRecord {
+    cg::Location location;
+    cg::Vector3D forward_vector;
+    cg::Rotation rotation;
+    uint64_t id;
+    /// OpenDRIVE position the waypoint was sampled at.
+    double s;
+    crd::RoadId road_id;
+    crd::SectionId section_id;
+    crd::LaneId lane_id;
+    crd::JuncId junction_id;
+    GeoGridId geodesic_grid_id;
+    WaypointIndex left;
+    WaypointIndex right;
+    RoadOption road_option;
+    bool is_junction;
+  };
+
+  /// Range of waypoint indices stored contiguously.
+  class WaypointIndexRange {
+  public:
+    WaypointIndexRange(const WaypointIndex *begin, const WaypointIndex *end)
+      : _begin(begin), _end(end) {}
+
+    const WaypointIndex *begin() const {
+      return _begin;
+    }
+
+    const WaypointIndex *end() const {
+      return _end;
+    }
+
+    std::size_t size() const {
+      return static_cast<std::size_t>(_end - _begin);
+    }
+
+    bool empty() const {
+      return _begin == _end;
+    }
+
+    WaypointIndex operator[](const std::size_t i) const {
+      return _begin[i];
+    }
+
+  private:
+    const WaypointIndex *_begin;
+    const WaypointIndex *_end;
+  };
+
+  /// Discretized local map used by the traffic manager. Waypoints are stored
+  /// contiguously and referenced by their index, successors and predecessors
+  /// are kept in compressed sparse row form. Walking the graph does not touch
+  /// any reference count nor the underlying OpenDRIVE waypoint.
+  ///
+  /// The graph is either built from a SimpleWaypoint topology, which is only
+  /// kept while the local map is being set up, or attached to the sections of
+  /// a cooked map file.
+  class WaypointGraph {
+
+    using SimpleWaypointPtr = std::shared_ptr<SimpleWaypoint>;
+
+  private:
+    PackedArray<WaypointRecord> records;
+    /// Successors of waypoint i are next_indices[next_offsets[i], next_offsets[i + 1]).
+    PackedArray<uint32_t> next_offsets;
+    PackedArray<WaypointIndex> next_indices;
+    /// Predecessors of waypoint i are previous_indices[previous_offsets[i], previous_offsets[i + 1]).
+    PackedArray<uint32_t> previous_offsets;
+    PackedArray<WaypointIndex> previous_indices;
+
+  public:
+    /// Builds the graph and assigns to every waypoint its index.
+    void Build(const std::vector<SimpleWaypointPtr> &dense_topology);
+
+    /// References the records and links stored elsewhere, that must outlive
+    /// the graph. The offsets hold size + 1 values each, the caller checks
+    /// they are in range.
+    void Attach(const WaypointRecord *records_data, const std::size_t size,
+                const uint32_t *next_offsets_data, const WaypointIndex *next_indices_data, const std::size_t next_count,
+                const uint32_t *previous_offsets_data, const WaypointIndex *previous_indices_data, const std::size_t previous_count);
+
+    void Clear();
+
+    std::size_t Size() const {
+      return records.size();
+    }
+
+    const WaypointRecord &GetRecord(const WaypointIndex index) const {
+      return records[index];
+    }
+
+    const cg::Location &GetLocation(const WaypointIndex index) const {
+      return records[index].location;
+    }
+
+    cg::Transform GetTransform(const WaypointIndex index) const {
+      return cg::Transform(records[index].location, records[index].rotation);
+    }
+
+    float DistanceSquared(const WaypointIndex index, const WaypointIndex other) const {
+      return cg::Math::DistanceSquared(records[index].location, records[other].location);
+    }
+
+    WaypointIndexRange GetNext(const WaypointIndex index) const {
+      return {next_indices.data() + next_offsets[index], next_indices.data() + next_offsets[index + 1u]};
+    }
+
+    WaypointIndexRange GetPrevious(const WaypointIndex index) const {
+      return {previous_indices.data() + previous_offsets[index], previous_indices.data() + previous_offsets[index + 1u]};
+    }
+
+    /// Number of successor and predecessor links.
+    std::size_t GetNextCount() const {
+      return next_indices.size();
+    }
+
+    std::size_t GetPreviousCount() const {
+      return previous_indices.size();
+    }
+
+    /// Approximate memory owned by the graph, in bytes. Attached sections
+    /// are not counted.
+    std::size_t GetMemoryUsage() const;
+  };
+
+} // namespace traffic_manager
+} // namespace carla
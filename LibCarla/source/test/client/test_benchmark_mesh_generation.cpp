@@ -0,0 +1,107 @@
+// Copyright (c) 2023 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "test.h"
+#include "OpenDrive.h"
+
+#include <carla/StopWatch.h>
+#include <carla/opendrive/OpenDriveParser.h>
+#include <carla/rpc/OpendriveGenerationParameters.h>
+
+#include <cstdlib>
+#include <fstream>
+#include <limits>
+#include <string>
+
+#if defined(__linux__)
+#  include <sys/resource.h>
+#endif
+
+using namespace carla::opendrive;
+
+/// Peak resident set size of the process in MB.
+static double GetPeakRSS() {
+#if defined(__linux__)
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) == 0) {
+    return static_cast<double>(usage.ru_maxrss) / 1024.0;
+  }
+#endif // __linux__
+  return 0.0;
+}
+
+/// The XODR in LIBCARLA_BENCHMARK_XODR if set, otherwise the biggest of the
+/// test content.
+static std::string LoadBenchmarkXODR() {
+  const char *path = std::getenv("LIBCARLA_BENCHMARK_XODR");
+  if (path != nullptr) {
+    carla::logging::log("Benchmark map", path);
+    std::ifstream file(path);
+    return std::string{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+  }
+  std::string result;
+  for (const auto &file : util::OpenDrive::GetAvailableFiles()) {
+    auto xodr = util::OpenDrive::Load(file);
+    if (xodr.size() > result.size()) {
+      carla::logging::log("Benchmark map", file);
+      result = std::move(xodr);
+    }
+  }
+  return result;
+}
+
+TEST(benchmark_mesh_generation, generate_chunked_mesh) {
+  const auto xodr = LoadBenchmarkXODR();
+  ASSERT_FALSE(xodr.empty());
+  auto map = OpenDriveParser::Load(xodr);
+  ASSERT_TRUE(map.has_value());
+  const double rss_before = GetPeakRSS();
+
+  carla::rpc::OpendriveGenerationParameters parameters;
+  carla::StopWatch timer;
+  const auto meshes = map->GenerateChunkedMesh(parameters);
+  timer.Stop();
+
+  size_t number_of_vertices = 0u;
+  for (const auto &mesh : meshes) {
+    number_of_vertices += mesh->GetVerticesNum();
+  }
+  ASSERT_GT(number_of_vertices, 0u);
+  std::cout << meshes.size() << " chunks, " << number_of_vertices << " vertices in "
+            << timer.GetElapsedTime() << " ms, peak RSS "
+            << rss_before << " MB -> " << GetPeakRSS() << " MB" << std::endl;
+}
+
+TEST(benchmark_mesh_generation, generate_ordered_chunked_mesh) {
+  const auto xodr = LoadBenchmarkXODR();
+  ASSERT_FALSE(xodr.empty());
+  auto map = OpenDriveParser::Load(xodr);
+  ASSERT_TRUE(map.has_value());
+  const double rss_before = GetPeakRSS();
+
+  // The filter expects the minimum and maximum y swapped, as in Unreal.
+  constexpr float max = std::numeric_limits<float>::max();
+  carla::rpc::OpendriveGenerationParameters parameters;
+  carla::StopWatch timer;
+  const auto meshes = map->GenerateOrderedChunkedMeshInLocations(
+      parameters,
+      carla::geom::Vector3D(-max, max, 0.0f),
+      carla::geom::Vector3D(max, -max, 0.0f));
+  timer.Stop();
+
+  size_t number_of_meshes = 0u;
+  size_t number_of_vertices = 0u;
+  for (const auto &pair : meshes) {
+    number_of_meshes += pair.second.size();
+    for (const auto &mesh : pair.second) {
+      number_of_vertices += mesh->GetVerticesNum();
+    }
+  }
+  ASSERT_GT(number_of_vertices, 0u);
+  std::cout << number_of_meshes << " meshes, " << number_of_vertices << " vertices in "
+            << timer.GetElapsedTime() << " ms, peak RSS "
+            << rss_before << " MB -> " << GetPeakRSS() << " MB" << std::endl;
+}
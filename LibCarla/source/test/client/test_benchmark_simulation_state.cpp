@@ -0,0 +1,158 @@
+// Copyright (c) 2023 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "test.h"
+#include "Random.h"
+
+#include <carla/StopWatch.h>
+#include <carla/geom/Math.h>
+#include <carla/trafficmanager/CollisionStage.h>
+#include <carla/trafficmanager/Constants.h>
+#include <carla/trafficmanager/SimulationState.h>
+
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
+#include <vector>
+
+using namespace carla::traffic_manager;
+using namespace carla::traffic_manager::constants::Collision;
+namespace cg = carla::geom;
+
+static constexpr size_t ITERATIONS = 20u;
+static constexpr float OVERLAP_RADIUS = 60.0f;
+
+static KinematicState make_kinematic_state() {
+  KinematicState state;
+  state.location = util::Random::Location(-500.0f, 500.0f);
+  state.location.z = 0.0f;
+  state.rotation = cg::Rotation(0.0f, static_cast<float>(util::Random::Uniform(-180.0, 180.0)), 0.0f);
+  state.velocity = util::Random::Location(-10.0f, 10.0f);
+  state.velocity.z = 0.0f;
+  state.speed_limit = 50.0f;
+  state.physics_enabled = true;
+  state.is_dormant = false;
+  state.hybrid_end_location = state.location;
+  return state;
+}
+
+static float collision_radius_square(const cg::Vector3D &velocity) {
+  const float radius = COLLISION_RADIUS_RATE * velocity.Length() + COLLISION_RADIUS_MIN;
+  return radius * radius;
+}
+
+// Candidate selection of the collision stage as it was with the state kept in
+// actor id keyed maps: every actor with an overlapping path is looked up, and
+// the sort looks up the locations again on every comparison.
+static size_t select_candidates_from_maps(
+    const std::unordered_map<ActorId, KinematicState> &kinematic_state_map,
+    const ActorId ego_actor_id,
+    const ActorIdSet overlapping_actors,
+    std::vector<ActorId> &candidates) {
+  const KinematicState &ego_state = kinematic_state_map.at(ego_actor_id);
+  const cg::Location ego_location = ego_state.location;
+  const float radius_square = collision_radius_square(ego_state.velocity);
+  candidates.clear();
+  for (ActorId overlapping_actor_id : overlapping_actors) {
+    const cg::Location &overlapping_actor_location = kinematic_state_map.at(overlapping_actor_id).location;
+    if (overlapping_actor_id != ego_actor_id
+        && cg::Math::DistanceSquared(overlapping_actor_location, ego_location) < radius_square
+        && std::abs(ego_location.z - overlapping_actor_location.z) < VERTICAL_OVERLAP_THRESHOLD) {
+      candidates.push_back(overlapping_actor_id);
+    }
+  }
+  std::sort(candidates.begin(), candidates.end(),
+            [&kinematic_state_map, &ego_location](const ActorId &a_id_1, const ActorId &a_id_2) {
+              const cg::Location &loc_1 = kinematic_state_map.at(a_id_1).location;
+              const cg::Location &loc_2 = kinematic_state_map.at(a_id_2).location;
+              return (cg::Math::DistanceSquared(ego_location, loc_1) < cg::Math::DistanceSquared(ego_location, loc_2));
+            });
+  return candidates.size();
+}
+
+// Times the candidate selection of the collision stage for every vehicle,
+// with the state in actor id keyed maps against the current structure of
+// arrays, broad-phase grid and (distance, id) pairs. The overlapping paths
+// are copied out of a table every time they are needed, as the track traffic
+// returns them by value; this leaves out the time it takes to merge them.
+static void benchmark_simulation_state(const size_t number_of_vehicles) {
+  std::vector<ActorId> actor_ids;
+  std::unordered_map<ActorId, KinematicState> kinematic_state_map;
+  SimulationState simulation_state;
+  for (size_t i = 0u; i < number_of_vehicles; ++i) {
+    const ActorId actor_id = static_cast<ActorId>(1000u + 7u * i);
+    const KinematicState state = make_kinematic_state();
+    actor_ids.push_back(actor_id);
+    kinematic_state_map.insert({actor_id, state});
+    simulation_state.AddActor(actor_id, state, {ActorType::Vehicle, 2.0f, 1.0f, 0.8f}, {TLS::Green, false});
+  }
+
+  // The paths of nearby vehicles overlap most of the time, as the track
+  // traffic would report them.
+  std::vector<ActorIdSet> overlapping_actors(number_of_vehicles);
+  for (size_t i = 0u; i < number_of_vehicles; ++i) {
+    const cg::Location &location = kinematic_state_map.at(actor_ids[i]).location;
+    for (size_t j = 0u; j < number_of_vehicles; ++j) {
+      const cg::Location &other_location = kinematic_state_map.at(actor_ids[j]).location;
+      if (cg::Math::Distance(location, other_location) < OVERLAP_RADIUS && (i + j) % 3u != 0u) {
+        overlapping_actors[i].insert(actor_ids[j]);
+      }
+    }
+  }
+
+  size_t map_candidates = 0u;
+  std::vector<ActorId> map_candidate_ids;
+  carla::StopWatch map_timer;
+  for (size_t iteration = 0u; iteration < ITERATIONS; ++iteration) {
+    for (size_t i = 0u; i < number_of_vehicles; ++i) {
+      map_candidates += select_candidates_from_maps(
+          kinematic_state_map, actor_ids[i], overlapping_actors[i], map_candidate_ids);
+    }
+  }
+  map_timer.Stop();
+
+  size_t soa_candidates = 0u;
+  std::vector<CollisionCandidate> candidates;
+  std::vector<size_t> nearby_slots;
+  BroadPhaseGrid broad_phase_grid(BROAD_PHASE_CELL_SIZE);
+  carla::StopWatch soa_timer;
+  for (size_t iteration = 0u; iteration < ITERATIONS; ++iteration) {
+    broad_phase_grid.Build(simulation_state.GetLocationArray());
+    const std::vector<cg::Location> &locations = simulation_state.GetLocationArray();
+    const std::vector<cg::Vector3D> &velocities = simulation_state.GetVelocityArray();
+    for (size_t i = 0u; i < number_of_vehicles; ++i) {
+      const size_t ego_slot = simulation_state.GetSlot(actor_ids[i]);
+      const float radius_square = collision_radius_square(velocities[ego_slot]);
+      candidates.clear();
+      nearby_slots.clear();
+      broad_phase_grid.Query(locations[ego_slot], std::sqrt(radius_square), nearby_slots);
+      if (nearby_slots.size() > 1u) {
+        const ActorIdSet overlapping = overlapping_actors[i];
+        SelectCollisionCandidates(simulation_state, ego_slot, radius_square, nearby_slots,
+                                  overlapping, candidates);
+      }
+      soa_candidates += candidates.size();
+    }
+  }
+  soa_timer.Stop();
+
+  ASSERT_EQ(map_candidates, soa_candidates);
+  std::cout << number_of_vehicles << " vehicles: map "
+            << map_timer.GetElapsedTime<std::chrono::microseconds>() << " us, structure of arrays "
+            << soa_timer.GetElapsedTime<std::chrono::microseconds>() << " us" << std::endl;
+}
+
+TEST(benchmark_simulation_state, collision_candidates_100) {
+  benchmark_simulation_state(100u);
+}
+
+TEST(benchmark_simulation_state, collision_candidates_500) {
+  benchmark_simulation_state(500u);
+}
+
+TEST(benchmark_simulation_state, collision_candidates_2000) {
+  benchmark_simulation_state(2000u);
+}
@@ -0,0 +1,74 @@
+// Copyright (c) 2023 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "test.h"
+#include "Random.h"
+
+#include <carla/geom/Math.h>
+#include <carla/trafficmanager/BroadPhaseGrid.h>
+
+#include <algorithm>
+#include <vector>
+
+using carla::traffic_manager::BroadPhaseGrid;
+namespace cg = carla::geom;
+
+TEST(broad_phase_grid, query_matches_brute_force) {
+  std::vector<cg::Location> locations;
+  for (auto i = 0u; i < 2000u; ++i) {
+    locations.push_back(util::Random::Location(-1000.0f, 1000.0f));
+  }
+
+  BroadPhaseGrid grid(20.0f);
+  grid.Build(locations);
+
+  for (const float radius : {5.0f, 20.0f, 75.0f, 5000.0f}) {
+    for (auto i = 0u; i < 100u; ++i) {
+      const cg::Location center = util::Random::Location(-1000.0f, 1000.0f);
+
+      std::vector<size_t> result;
+      grid.Query(center, radius, result);
+      std::sort(result.begin(), result.end());
+      ASSERT_TRUE(std::adjacent_find(result.begin(), result.end()) == result.end());
+
+      for (size_t index = 0u; index < locations.size(); ++index) {
+        if (cg::Math::Distance2D(center, locations[index]) < radius) {
+          ASSERT_TRUE(std::binary_search(result.begin(), result.end(), index));
+        }
+      }
+    }
+  }
+}
+
+TEST(broad_phase_grid, spread_locations_grow_the_cells) {
+  // Locations too far apart for a dense grid of 1 m cells.
+  std::vector<cg::Location> locations;
+  for (auto i = 0u; i < 50u; ++i) {
+    locations.push_back(util::Random::Location(-100000.0f, 100000.0f));
+  }
+  locations.push_back(cg::Location(0.0f, 0.0f, 0.0f));
+  locations.push_back(cg::Location(0.5f, 0.5f, 0.0f));
+
+  BroadPhaseGrid grid(1.0f);
+  grid.Build(locations);
+
+  std::vector<size_t> result;
+  grid.Query(cg::Location(0.0f, 0.0f, 0.0f), 2.0f, result);
+  ASSERT_TRUE(std::find(result.begin(), result.end(), 50u) != result.end());
+  ASSERT_TRUE(std::find(result.begin(), result.end(), 51u) != result.end());
+  for (const size_t index : result) {
+    ASSERT_LT(index, locations.size());
+  }
+
+  // Queries outside the grid return nothing.
+  result.clear();
+  grid.Query(cg::Location(500000.0f, 500000.0f, 0.0f), 10.0f, result);
+  ASSERT_TRUE(result.empty());
+
+  grid.Clear();
+  grid.Query(cg::Location(0.0f, 0.0f, 0.0f), 2.0f, result);
+  ASSERT_TRUE(result.empty());
+}
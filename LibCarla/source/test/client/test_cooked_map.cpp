@@ -0,0 +1,210 @@
+// Copyright (c) 2023 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "test.h"
+#include "OpenDrive.h"
+
+#include <carla/client/Map.h>
+#include <carla/geom/Math.h>
+#include <carla/trafficmanager/CachedSimpleWaypoint.h>
+#include <carla/trafficmanager/CookedMap.h>
+#include <carla/trafficmanager/InMemoryMap.h>
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+using namespace carla::traffic_manager;
+namespace cm = carla::traffic_manager::cooked_map;
+
+static std::vector<uint8_t> ReadFile(const std::string &filename) {
+  std::ifstream file(filename, std::ios::binary);
+  return {std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+}
+
+static std::vector<WaypointIndex> ToVector(const WaypointIndexRange &range) {
+  return {range.begin(), range.end()};
+}
+
+/// Links are compared by index in the graph. With @a exact_positions the
+/// waypoints must also be at the same OpenDRIVE position and give the same
+/// spatial queries, the legacy format only keeps the distance along the road
+/// in single precision.
+static void CheckSameTopology(const InMemoryMap &expected, const InMemoryMap &loaded, const bool exact_positions) {
+  const WaypointGraph &expected_graph = expected.GetWaypointGraph();
+  const WaypointGraph &loaded_graph = loaded.GetWaypointGraph();
+  ASSERT_EQ(loaded_graph.Size(), expected_graph.Size());
+  for (WaypointIndex i = 0u; i < expected_graph.Size(); ++i) {
+    const WaypointRecord &expected_record = expected_graph.GetRecord(i);
+    const WaypointRecord &loaded_record = loaded_graph.GetRecord(i);
+    if (exact_positions) {
+      ASSERT_EQ(loaded_record.id, expected_record.id);
+      ASSERT_EQ(loaded_record.location, expected_record.location);
+    } else {
+      ASSERT_LT(carla::geom::Math::Distance(loaded_record.location, expected_record.location), 0.01f);
+    }
+    ASSERT_EQ(loaded_record.road_id, expected_record.road_id);
+    ASSERT_EQ(loaded_record.section_id, expected_record.section_id);
+    ASSERT_EQ(loaded_record.lane_id, expected_record.lane_id);
+    ASSERT_EQ(loaded_record.junction_id, expected_record.junction_id);
+    ASSERT_EQ(loaded_record.is_junction, expected_record.is_junction);
+    ASSERT_EQ(loaded_record.road_option, expected_record.road_option);
+    ASSERT_EQ(loaded_record.geodesic_grid_id, expected_record.geodesic_grid_id);
+    ASSERT_EQ(loaded_record.left, expected_record.left);
+    ASSERT_EQ(loaded_record.right, expected_record.right);
+    ASSERT_EQ(ToVector(loaded_graph.GetNext(i)), ToVector(expected_graph.GetNext(i)));
+    ASSERT_EQ(ToVector(loaded_graph.GetPrevious(i)), ToVector(expected_graph.GetPrevious(i)));
+
+    const WaypointPtr open_drive_waypoint = loaded.GetOpenDriveWaypoint(i);
+    ASSERT_NE(open_drive_waypoint, nullptr);
+    ASSERT_EQ(open_drive_waypoint->GetId(), loaded_record.id);
+    if (exact_positions) {
+      ASSERT_EQ(open_drive_waypoint->GetTransform().location, loaded_record.location);
+    }
+  }
+  if (expected_graph.Size() > 0u) {
+    const auto location = expected_graph.GetLocation(static_cast<WaypointIndex>(expected_graph.Size() - 1u));
+    ASSERT_EQ(loaded.GetWaypoint(location), expected.GetWaypoint(location));
+    if (exact_positions) {
+      ASSERT_EQ(loaded.GetWaypointsInDelta(location, 10u, 5.0f), expected.GetWaypointsInDelta(location, 10u, 5.0f));
+    }
+  }
+}
+
+/// Record of the legacy format for waypoint @a index of the graph.
+static CachedSimpleWaypoint MakeCachedWaypoint(const WaypointGraph &graph, const WaypointIndex index) {
+  const WaypointRecord &record = graph.GetRecord(index);
+  CachedSimpleWaypoint cached_waypoint;
+  cached_waypoint.waypoint_id = record.id;
+  cached_waypoint.road_id = record.road_id;
+  cached_waypoint.section_id = record.section_id;
+  cached_waypoint.lane_id = record.lane_id;
+  cached_waypoint.s = static_cast<float>(record.s);
+  for (const WaypointIndex next : graph.GetNext(index)) {
+    cached_waypoint.next_waypoints.push_back(graph.GetRecord(next).id);
+  }
+  for (const WaypointIndex previous : graph.GetPrevious(index)) {
+    cached_waypoint.previous_waypoints.push_back(graph.GetRecord(previous).id);
+  }
+  if (record.left != INVALID_WAYPOINT_INDEX) {
+    cached_waypoint.next_left_waypoint = graph.GetRecord(record.left).id;
+  }
+  if (record.right != INVALID_WAYPOINT_INDEX) {
+    cached_waypoint.next_right_waypoint = graph.GetRecord(record.right).id;
+  }
+  cached_waypoint.geodesic_grid_id = record.geodesic_grid_id;
+  cached_waypoint.is_junction = record.is_junction;
+  cached_waypoint.road_option = static_cast<uint8_t>(record.road_option);
+  return cached_waypoint;
+}
+
+template <typename T>
+static std::vector<uint8_t> WithValue(std::vector<uint8_t> content, const uint64_t offset, const T value) {
+  std::memcpy(content.data() + offset, &value, sizeof(T));
+  return content;
+}
+
+TEST(cooked_map, save_and_load) {
+  const std::string filename = "test_cooked_map.bin";
+  for (const auto &file : util::OpenDrive::GetAvailableFiles()) {
+    carla::logging::log("Cooking the local map of", file);
+    auto map = carla::MakeShared<carla::client::Map>(file, util::OpenDrive::Load(file));
+    InMemoryMap expected(map);
+    expected.SetUp();
+
+    InMemoryMap::Cook(map, filename);
+    const std::vector<uint8_t> content = ReadFile(filename);
+    ASSERT_TRUE(cm::IsCookedMap(content.data(), content.size()));
+
+    // Mapped from the file, which stays mapped after it is removed, and read
+    // from memory.
+    InMemoryMap from_file(map);
+    ASSERT_TRUE(from_file.Load(filename));
+    std::remove(filename.c_str());
+    CheckSameTopology(expected, from_file, true);
+    InMemoryMap from_memory(map);
+    ASSERT_TRUE(from_memory.Load(content));
+    CheckSameTopology(expected, from_memory, true);
+  }
+}
+
+TEST(cooked_map, corrupted_files_are_rejected) {
+  const std::string filename = "test_cooked_map_corrupted.bin";
+  for (const auto &file : util::OpenDrive::GetAvailableFiles()) {
+    auto map = carla::MakeShared<carla::client::Map>(file, util::OpenDrive::Load(file));
+    InMemoryMap::Cook(map, filename);
+    const std::vector<uint8_t> content = ReadFile(filename);
+    cm::Header header;
+    std::memcpy(&header, content.data(), sizeof(header));
+    ASSERT_EQ(header.version, cm::VERSION);
+    ASSERT_GT(header.waypoint_count, 0u);
+    ASSERT_GT(header.next_count, 0u);
+    ASSERT_GT(header.tree_node_count, 0u);
+
+    std::vector<std::vector<uint8_t>> corrupted_contents = {
+      // unknown version and header size
+      WithValue(content, offsetof(cm::Header, version), cm::VERSION + 1u),
+      WithValue(content, offsetof(cm::Header, header_size), uint32_t(sizeof(cm::Header) + 8u)),
+      // truncated file
+      std::vector<uint8_t>(content.begin(), content.begin() + static_cast<std::ptrdiff_t>(content.size() / 2u)),
+      // sections out of the file
+      WithValue(content, offsetof(cm::Header, waypoint_count), uint64_t(cm::INVALID_INDEX)),
+      WithValue(content, offsetof(cm::Header, next_count), header.next_count * 1000u),
+      WithValue(content, offsetof(cm::Header, previous_indices_offset), uint64_t(content.size())),
+      WithValue(content, offsetof(cm::Header, tree_node_count), header.tree_node_count * 1000u),
+      // sections not aligned for their records
+      WithValue(content, offsetof(cm::Header, waypoints_offset), header.waypoints_offset + 4u),
+      // links out of range
+      WithValue(content, header.next_indices_offset, uint32_t(header.waypoint_count)),
+      WithValue(content, header.next_offsets_offset + sizeof(uint32_t), uint32_t(header.next_count + 1u)),
+      WithValue(content, header.waypoints_offset + offsetof(WaypointRecord, left), uint32_t(header.waypoint_count)),
+      // spatial tree not over the waypoints
+      WithValue(content, offsetof(cm::Header, tree_leaf_count), header.tree_node_count + 1u),
+      WithValue(content, header.tree_nodes_offset + offsetof(SpatialTreeNode, first), uint32_t(header.waypoint_count)),
+      WithValue(content, header.tree_items_offset + offsetof(SpatialTreeItem, index), uint32_t(header.waypoint_count)),
+      // waypoint out of the map
+      WithValue(content, header.waypoints_offset + offsetof(WaypointRecord, road_id), uint32_t(0xFFFFFFFu)),
+    };
+    for (const auto &corrupted_content : corrupted_contents) {
+      InMemoryMap local_map(map);
+      ASSERT_FALSE(local_map.Load(corrupted_content));
+      ASSERT_EQ(local_map.GetWaypointGraph().Size(), 0u);
+    }
+
+    InMemoryMap missing(map);
+    ASSERT_FALSE(missing.Load(std::string("test_cooked_map_missing.bin")));
+  }
+  std::remove(filename.c_str());
+}
+
+TEST(cooked_map, load_legacy_format) {
+  const std::string filename = "test_cooked_map_legacy.bin";
+  for (const auto &file : util::OpenDrive::GetAvailableFiles()) {
+    auto map = carla::MakeShared<carla::client::Map>(file, util::OpenDrive::Load(file));
+    InMemoryMap expected(map);
+    expected.SetUp();
+
+    // Layout written by the versions before the cooked format.
+    {
+      std::ofstream out_file(filename, std::ios::binary);
+      const WaypointGraph &graph = expected.GetWaypointGraph();
+      const uint32_t total = static_cast<uint32_t>(graph.Size());
+      out_file.write(reinterpret_cast<const char *>(&total), sizeof(uint32_t));
+      for (WaypointIndex i = 0u; i < total; ++i) {
+        MakeCachedWaypoint(graph, i).Write(out_file);
+      }
+    }
+    const std::vector<uint8_t> content = ReadFile(filename);
+    ASSERT_FALSE(cm::IsCookedMap(content.data(), content.size()));
+
+    InMemoryMap legacy(map);
+    ASSERT_TRUE(legacy.Load(filename));
+    CheckSameTopology(expected, legacy, false);
+  }
+  std::remove(filename.c_str());
+}
@@ -0,0 +1,186 @@
+// Copyright (c) 2023 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "test.h"
+#include "Random.h"
+
+#include <carla/client/detail/EpisodeState.h>
+#include <carla/sensor/s11n/EpisodeStateDeltaSerializer.h>
+#include <carla/sensor/s11n/SensorHeaderSerializer.h>
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+using carla::client::detail::EpisodeState;
+using carla::sensor::data::ActorDynamicState;
+using carla::sensor::s11n::EpisodeStateDeltaEncoder;
+using carla::sensor::s11n::EpisodeStateDeltaSerializer;
+using carla::sensor::s11n::EpisodeStateSerializer;
+using carla::sensor::s11n::SensorHeaderSerializer;
+
+static constexpr uint32_t KEYFRAME_INTERVAL = 30u;
+
+static ActorDynamicState make_actor(carla::rpc::ActorId id) {
+  ActorDynamicState actor{};
+  actor.id = id;
+  actor.actor_state = carla::rpc::ActorState::Active;
+  actor.transform.location = util::Random::Location(-500.0f, 500.0f);
+  actor.transform.rotation.yaw = static_cast<float>(util::Random::Uniform(-180.0, 180.0));
+  return actor;
+}
+
+// Prepends the sensor header as the streaming does.
+static carla::Buffer make_message(uint64_t frame, carla::Buffer &&payload) {
+  carla::Buffer header = SensorHeaderSerializer::Serialize(0u, frame, 0.05 * frame, {});
+  carla::Buffer message(header.size() + payload.size());
+  std::memcpy(message.data(), header.data(), header.size());
+  std::memcpy(message.data() + header.size(), payload.data(), payload.size());
+  return message;
+}
+
+static std::shared_ptr<const EpisodeState> decode(
+    const carla::Buffer &message,
+    std::shared_ptr<const EpisodeState> base) {
+  EpisodeStateDeltaSerializer::Message view;
+  EXPECT_TRUE(EpisodeStateDeltaSerializer::Deserialize(message, view));
+  if (!view.IsKeyFrame() &&
+      (base == nullptr || base->GetFrame() != view.delta_header->base_frame)) {
+    return nullptr;
+  }
+  return std::make_shared<const EpisodeState>(view, base.get());
+}
+
+static void check_equal(const std::vector<ActorDynamicState> &actors, const EpisodeState &state) {
+  ASSERT_EQ(state.size(), actors.size());
+  for (const auto &actor : actors) {
+    ASSERT_TRUE(state.ContainsActorSnapshot(actor.id));
+    const auto snapshot = state.GetActorSnapshot(actor.id);
+    ASSERT_NEAR(snapshot.transform.location.x, actor.transform.location.x, 1e-3f);
+    ASSERT_NEAR(snapshot.transform.location.y, actor.transform.location.y, 1e-3f);
+    ASSERT_NEAR(snapshot.transform.rotation.yaw, actor.transform.rotation.yaw, 1e-2f);
+  }
+}
+
+// Simulates an episode where only a fraction of the actors moves, with some
+// actors spawned and destroyed every tick, and reports the bytes per tick of
+// both streams.
+static void run_episode(size_t number_of_actors, size_t number_of_moving_actors) {
+  std::vector<ActorDynamicState> actors;
+  carla::rpc::ActorId next_id = 1u;
+  for (size_t i = 0u; i < number_of_actors; ++i) {
+    actors.emplace_back(make_actor(next_id++));
+  }
+
+  EpisodeStateSerializer::Header header{};
+  header.episode_id = 1u;
+  header.delta_seconds = 0.05f;
+
+  EpisodeStateDeltaEncoder encoder(KEYFRAME_INTERVAL);
+  std::shared_ptr<const EpisodeState> state;
+  size_t full_bytes = 0u;
+  size_t delta_bytes = 0u;
+  constexpr uint64_t TICKS = 100u;
+
+  for (uint64_t frame = 1u; frame <= TICKS; ++frame) {
+    for (size_t i = 0u; i < number_of_moving_actors; ++i) {
+      actors[i].transform.location.x += 0.5f;
+      actors[i].velocity.x = 10.0f;
+    }
+    if (frame % 10u == 0u) {
+      actors.erase(actors.begin() + number_of_moving_actors);
+      actors.emplace_back(make_actor(next_id++));
+    }
+
+    auto message = make_message(frame, encoder.Encode(frame, header, actors, carla::Buffer{}));
+    delta_bytes += message.size();
+    full_bytes += SensorHeaderSerializer::header_offset + sizeof(header) + sizeof(ActorDynamicState) * actors.size();
+
+    state = decode(message, state);
+    ASSERT_NE(state, nullptr);
+    ASSERT_EQ(state->GetFrame(), frame);
+    check_equal(actors, *state);
+  }
+
+  std::cout << number_of_actors << " actors, " << number_of_moving_actors << " moving: full "
+            << full_bytes / TICKS << " bytes/tick, delta "
+            << delta_bytes / TICKS << " bytes/tick" << std::endl;
+  ASSERT_LT(delta_bytes, full_bytes);
+}
+
+TEST(episode_state_delta, small_changes_are_not_sent) {
+  auto actor = make_actor(1u);
+  auto moved = actor;
+  moved.transform.location.x += 1e-4f;
+  ASSERT_FALSE(EpisodeStateDeltaEncoder::HasChanged(actor, moved));
+  moved.transform.location.x += 1e-2f;
+  ASSERT_TRUE(EpisodeStateDeltaEncoder::HasChanged(actor, moved));
+}
+
+TEST(episode_state_delta, missing_base_waits_for_key_frame) {
+  std::vector<ActorDynamicState> actors{make_actor(1u), make_actor(2u)};
+  EpisodeStateSerializer::Header header{};
+  EpisodeStateDeltaEncoder encoder(KEYFRAME_INTERVAL);
+
+  auto first = make_message(1u, encoder.Encode(1u, header, actors, carla::Buffer{}));
+  auto second = make_message(2u, encoder.Encode(2u, header, actors, carla::Buffer{}));
+  ASSERT_EQ(decode(second, nullptr), nullptr);
+
+  auto state = decode(first, nullptr);
+  ASSERT_NE(state, nullptr);
+  state = decode(second, state);
+  ASSERT_NE(state, nullptr);
+  check_equal(actors, *state);
+
+  // A gap in the frames sent forces a key frame.
+  auto third = make_message(5u, encoder.Encode(5u, header, actors, carla::Buffer{}));
+  EpisodeStateDeltaSerializer::Message view;
+  ASSERT_TRUE(EpisodeStateDeltaSerializer::Deserialize(third, view));
+  ASSERT_TRUE(view.IsKeyFrame());
+}
+
+TEST(episode_state_delta, round_trip_1000) {
+  run_episode(1000u, 50u);
+}
+
+TEST(episode_state_delta, round_trip_10000) {
+  run_episode(10000u, 200u);
+}
+
+TEST(episode_state_delta, snapshots_are_sorted_and_index_is_shared) {
+  std::vector<ActorDynamicState> actors;
+  for (carla::rpc::ActorId id : {7u, 3u, 11u, 5u}) {
+    actors.emplace_back(make_actor(id));
+  }
+  EpisodeStateSerializer::Header header{};
+  EpisodeStateDeltaEncoder encoder(KEYFRAME_INTERVAL);
+
+  auto first = decode(make_message(1u, encoder.Encode(1u, header, actors, carla::Buffer{})), nullptr);
+  actors[0u].transform.location.x += 1.0f;
+  auto second = decode(make_message(2u, encoder.Encode(2u, header, actors, carla::Buffer{})), first);
+  ASSERT_NE(second, nullptr);
+  ASSERT_TRUE(std::is_sorted(second->begin(), second->end(), [](const auto &lhs, const auto &rhs) {
+    return lhs.id < rhs.id;
+  }));
+  ASSERT_EQ(first->GetActorIds().begin(), second->GetActorIds().begin());
+  ASSERT_TRUE(second->HasSameActors(*first));
+  ASSERT_EQ(second->FindActorSnapshot(7u)->transform.location.x, actors[0u].transform.location.x);
+
+  actors.erase(actors.begin() + 1u);
+  auto third = decode(make_message(3u, encoder.Encode(3u, header, actors, carla::Buffer{})), second);
+  ASSERT_NE(third, nullptr);
+  ASSERT_NE(second->GetActorIds().begin(), third->GetActorIds().begin());
+  ASSERT_FALSE(third->ContainsActorSnapshot(3u));
+  ASSERT_FALSE(third->HasSameActors(*second));
+  check_equal(actors, *third);
+
+  // A key frame rebuilds the index, the actors are still the same.
+  auto key_frame = decode(make_message(4u, EpisodeStateDeltaEncoder(1u).Encode(4u, header, actors, carla::Buffer{})), nullptr);
+  ASSERT_NE(key_frame, nullptr);
+  ASSERT_NE(third->GetActorIds().begin(), key_frame->GetActorIds().begin());
+  ASSERT_TRUE(key_frame->HasSameActors(*third));
+}
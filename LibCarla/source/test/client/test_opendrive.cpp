@@ -13,15 +13,28 @@
 #include <carla/geom/Location.h>
 #include <carla/geom/Math.h>
 #include <carla/opendrive/OpenDriveParser.h>
+#include <carla/road/InformationSet.h>
 #include <carla/road/MapBuilder.h>
+#include <carla/road/RoadElementSet.h>
+#include <carla/road/element/Geometry.h>
 #include <carla/road/element/RoadInfoElevation.h>
 #include <carla/road/element/RoadInfoGeometry.h>
+#include <carla/road/element/RoadInfoLaneOffset.h>
+#include <carla/road/element/RoadInfoLaneWidth.h>
 #include <carla/road/element/RoadInfoMarkRecord.h>
+#include <carla/road/element/RoadInfoSpeed.h>
+#include <carla/road/element/RoadInfoIterator.h>
+#include <carla/road/element/RoadInfoLaneBorder.h>
 #include <carla/road/element/RoadInfoVisitor.h>
 
+#include <odrSpiral/odrSpiral.h>
 #include <pugixml/pugixml.hpp>
+#include <boost/filesystem.hpp>
 
+#include <algorithm>
+#include <cmath>
 #include <fstream>
+#include <random>
 #include <string>
 
 using namespace carla::road;
@@ -424,3 +437,444 @@ TEST(road, get_waypoint) {
     result.get();
   }
 }
+
+TEST(road, project_locations) {
+  for (const auto& file : util::OpenDrive::GetAvailableFiles()) {
+    carla::logging::log("Parsing", file);
+    auto m = OpenDriveParser::Load(util::OpenDrive::Load(file));
+    ASSERT_TRUE(m.has_value());
+    auto &map = *m;
+    std::vector<carla::geom::Location> locations;
+    for (auto i = 0u; i < 5'000u; ++i) {
+      locations.emplace_back(Random::Location(-500.0f, 500.0f));
+    }
+    for (auto project_to_road : {true, false}) {
+      const auto projections = map.ProjectLocations(locations, project_to_road, static_cast<int32_t>(Lane::LaneType::Driving));
+      ASSERT_EQ(projections.size(), locations.size());
+      for (auto i = 0u; i < locations.size(); ++i) {
+        const auto expected = project_to_road ?
+            map.GetClosestWaypointOnRoad(locations[i]) :
+            map.GetWaypoint(locations[i]);
+        const auto &projection = projections[i];
+        ASSERT_EQ(projection.is_valid, expected.has_value());
+        if (expected.has_value()) {
+          ASSERT_EQ(projection.waypoint, *expected);
+          ASSERT_EQ(projection.transform, map.ComputeTransform(*expected));
+          ASSERT_EQ(projection.lane_width, map.GetLaneWidth(*expected));
+        }
+      }
+    }
+  }
+}
+
+TEST(road, information_set_get_info) {
+  // Widths at even distances and offsets at odd ones, no speed records.
+  std::vector<std::unique_ptr<RoadInfo>> infos;
+  for (auto i = 0; i < 100; ++i) {
+    const double s = static_cast<double>(i);
+    if (i % 2 == 0) {
+      infos.emplace_back(std::make_unique<RoadInfoLaneWidth>(s, s, 0.0, 0.0, 0.0));
+    } else {
+      infos.emplace_back(std::make_unique<RoadInfoLaneOffset>(s, s, 0.0, 0.0, 0.0));
+    }
+  }
+  std::shuffle(infos.begin(), infos.end(), std::mt19937(42u));
+  const InformationSet info_set(std::move(infos));
+
+  ASSERT_EQ(info_set.GetInfos<RoadInfoLaneWidth>().size(), 50u);
+  ASSERT_EQ(info_set.GetInfos<RoadInfoLaneOffset>().size(), 50u);
+  ASSERT_TRUE(info_set.GetInfos<RoadInfoSpeed>().empty());
+  ASSERT_EQ(info_set.GetInfo<RoadInfoSpeed>(50.0), nullptr);
+  ASSERT_EQ(info_set.GetInfo<RoadInfoLaneOffset>(0.5), nullptr);
+
+  for (auto i = 0; i < 1000; ++i) {
+    const double s = 0.1 * i;
+    const auto *width = info_set.GetInfo<RoadInfoLaneWidth>(s);
+    ASSERT_NE(width, nullptr);
+    ASSERT_EQ(width->GetDistance(), 2.0 * std::floor(s / 2.0));
+    const auto *offset = info_set.GetInfo<RoadInfoLaneOffset>(s);
+    if (s < 1.0) {
+      ASSERT_EQ(offset, nullptr);
+    } else {
+      ASSERT_NE(offset, nullptr);
+      ASSERT_EQ(offset->GetDistance(), 2.0 * std::floor((s - 1.0) / 2.0) + 1.0);
+    }
+  }
+
+  const auto forward = info_set.GetInfos<RoadInfoLaneWidth>(10.0, 20.0);
+  ASSERT_EQ(forward.size(), 6u);
+  ASSERT_EQ(forward.front()->GetDistance(), 10.0);
+  ASSERT_EQ(forward.back()->GetDistance(), 20.0);
+  const auto backward = info_set.GetInfos<RoadInfoLaneWidth>(20.0, 10.0);
+  ASSERT_EQ(backward.size(), 6u);
+  ASSERT_EQ(backward.front()->GetDistance(), 20.0);
+  ASSERT_EQ(backward.back()->GetDistance(), 10.0);
+}
+
+TEST(road, compiled_map) {
+  namespace fs = boost::filesystem;
+  const auto folder = fs::temp_directory_path() / fs::unique_path();
+  fs::create_directories(folder);
+  for (const auto& file : util::OpenDrive::GetAvailableFiles()) {
+    carla::logging::log("Parsing", file);
+    const auto xodr = util::OpenDrive::Load(file);
+    const auto path = (folder / OpenDriveParser::GetCompiledMapName(xodr)).string();
+    auto expected = OpenDriveParser::Load(xodr);
+    ASSERT_TRUE(expected.has_value());
+    {
+      // An invalid compiled map is ignored and replaced.
+      std::ofstream out(path, std::ios::binary);
+      out << "not a compiled map";
+    }
+    auto written = OpenDriveParser::Load(xodr, path);
+    ASSERT_TRUE(written.has_value());
+    ASSERT_GT(fs::file_size(path), 1'000u);
+    auto loaded = OpenDriveParser::Load(xodr, path);
+    ASSERT_TRUE(loaded.has_value());
+    for (auto i = 0u; i < 5'000u; ++i) {
+      const auto location = Random::Location(-500.0f, 500.0f);
+      const auto waypoint = expected->GetClosestWaypointOnRoad(location);
+      ASSERT_TRUE(written->GetClosestWaypointOnRoad(location) == waypoint);
+      ASSERT_TRUE(loaded->GetClosestWaypointOnRoad(location) == waypoint);
+    }
+    // The junction conflicts are read back as well.
+    for (auto &pair : expected->GetMap().GetJunctions()) {
+      const auto junction_id = pair.first;
+      const auto *written_junction = written->GetJunction(junction_id);
+      const auto *loaded_junction = loaded->GetJunction(junction_id);
+      ASSERT_NE(written_junction, nullptr);
+      ASSERT_NE(loaded_junction, nullptr);
+      for (auto &road : expected->GetMap().GetRoads()) {
+        const auto road_id = road.first;
+        const bool has_conflicts = pair.second.RoadHasConflicts(road_id);
+        ASSERT_EQ(written_junction->RoadHasConflicts(road_id), has_conflicts);
+        ASSERT_EQ(loaded_junction->RoadHasConflicts(road_id), has_conflicts);
+        if (has_conflicts) {
+          const auto &conflicts = pair.second.GetConflictsOfRoad(road_id);
+          ASSERT_TRUE(written_junction->GetConflictsOfRoad(road_id) == conflicts);
+          ASSERT_TRUE(loaded_junction->GetConflictsOfRoad(road_id) == conflicts);
+        }
+      }
+    }
+  }
+  fs::remove_all(folder);
+}
+
+// -- Previous implementations, the optimized ones must give the same results.
+
+namespace previous {
+
+  /// Type lookups walking the records of every type, as InformationSet did
+  /// before indexing them by type.
+  class InformationSet {
+  public:
+
+    explicit InformationSet(std::vector<std::unique_ptr<RoadInfo>> &&vec)
+      : _road_set(std::move(vec)) {}
+
+    template <typename T>
+    std::vector<const T *> GetInfos() const {
+      std::vector<const T *> vec;
+      for (auto it = MakeRoadInfoIterator<T>(_road_set.GetAll()); !it.IsAtEnd(); ++it) {
+        vec.emplace_back(&*it);
+      }
+      return vec;
+    }
+
+    template <typename T>
+    const T *GetInfo(const double s) const {
+      auto it = MakeRoadInfoIterator<T>(_road_set.GetReverseSubset(s));
+      return it.IsAtEnd() ? nullptr : &*it;
+    }
+
+    template <typename T>
+    std::vector<const T *> GetInfos(const double min_s, const double max_s) const {
+      std::vector<const T *> vec;
+      if (min_s < max_s) {
+        for (auto it = MakeRoadInfoIterator<T>(_road_set.GetSubsetInRange(min_s, max_s)); !it.IsAtEnd(); ++it) {
+          vec.emplace_back(&*it);
+        }
+      } else {
+        for (auto it = MakeRoadInfoIterator<T>(_road_set.GetReverseSubsetInRange(max_s, min_s)); !it.IsAtEnd(); ++it) {
+          vec.emplace_back(&*it);
+        }
+      }
+      return vec;
+    }
+
+  private:
+
+    RoadElementSet<std::unique_ptr<RoadInfo>> _road_set;
+  };
+
+  static Vector2D RotatebyAngle(double angle, double x, double y) {
+    const double cos_a = std::cos(angle);
+    const double sin_a = std::sin(angle);
+    return Vector2D(
+        static_cast<float>(x * cos_a - y * sin_a),
+        static_cast<float>(y * cos_a + x * sin_a));
+  }
+
+  /// Spiral evaluation computing the origin of the spiral on every call.
+  static DirectedPoint SpiralPosFromDist(
+      const Location &start_position, double heading, double length,
+      double curve_start, double curve_end, double dist) {
+    dist = Math::Clamp(dist, 0.0, length);
+    DirectedPoint p(start_position, heading);
+    const double curve_dot = (curve_end - curve_start) / length;
+    const double s_o = curve_start / curve_dot;
+    double x, y, t;
+    odrSpiral(s_o + dist, curve_dot, &x, &y, &t);
+    double x_o, y_o, t_o;
+    odrSpiral(s_o, curve_dot, &x_o, &y_o, &t_o);
+    const Vector2D pos = RotatebyAngle(heading - t_o, x - x_o, y - y_o);
+    p.location.x += pos.x;
+    p.location.y += pos.y;
+    p.tangent = heading + (t - t_o);
+    return p;
+  }
+
+  /// Poly3 samples looked up with a nearest segment query in an R-tree.
+  class Poly3 {
+  public:
+
+    Poly3(const Location &start_position, double heading, double length,
+        double a, double b, double c, double d)
+      : _start_position(start_position),
+        _heading(heading) {
+      _poly.Set(a, b, c, d);
+      constexpr double delta_u = 0.3;
+      double current_s = 0.0;
+      double current_u = 0.0;
+      double last_u = 0.0;
+      double last_v = _poly.Evaluate(current_u);
+      Value last_val{last_u, last_v, 0.0, _poly.Tangent(current_u)};
+      while (current_s < length + delta_u) {
+        current_u += delta_u;
+        const double current_v = _poly.Evaluate(current_u);
+        const double du = current_u - last_u;
+        const double dv = current_v - last_v;
+        current_s += std::sqrt(du * du + dv * dv);
+        Value current_val{current_u, current_v, current_s, _poly.Tangent(current_u)};
+        _rtree.InsertElement(
+            Rtree::BSegment(Rtree::BPoint(static_cast<float>(last_val.s)), Rtree::BPoint(static_cast<float>(current_s))),
+            last_val,
+            current_val);
+        last_u = current_u;
+        last_v = current_v;
+        last_val = current_val;
+      }
+    }
+
+    DirectedPoint PosFromDist(double dist) const {
+      const auto result = _rtree.GetNearestNeighbours(Rtree::BPoint(static_cast<float>(dist))).front();
+      const auto &val1 = result.second.first;
+      const auto &val2 = result.second.second;
+      const double rate = (val2.s - dist) / (val2.s - val1.s);
+      const double u = rate * val1.u + (1.0 - rate) * val2.u;
+      const double v = rate * val1.v + (1.0 - rate) * val2.v;
+      const double tangent = std::atan(rate * val1.t + (1.0 - rate) * val2.t);
+      const Vector2D pos = RotatebyAngle(_heading, u, v);
+      DirectedPoint p(_start_position, _heading + tangent);
+      p.location.x += pos.x;
+      p.location.y += pos.y;
+      return p;
+    }
+
+  private:
+
+    struct Value {
+      double u, v, s, t;
+    };
+    using Rtree = SegmentCloudRtree<Value, 1>;
+
+    Location _start_position;
+    double _heading;
+    CubicPolynomial _poly;
+    Rtree _rtree;
+  };
+
+  /// ParamPoly3 samples looked up with a nearest segment query in an R-tree.
+  class ParamPoly3 {
+  public:
+
+    ParamPoly3(const Location &start_position, double heading, double length,
+        double aU, double bU, double cU, double dU,
+        double aV, double bV, double cV, double dV, bool arc_length)
+      : _start_position(start_position),
+        _heading(heading) {
+      _polyU.Set(aU, bU, cU, dU);
+      _polyV.Set(aV, bV, cV, dV);
+      constexpr double interval_size = 0.5;
+      const size_t number_intervals = std::max(static_cast<size_t>(length / interval_size), size_t(5));
+      double delta_p = 1.0 / number_intervals;
+      if (arc_length) {
+        delta_p *= length;
+      }
+      double param_p = 0.0;
+      double current_s = 0.0;
+      double last_u = _polyU.Evaluate(param_p);
+      double last_v = _polyV.Evaluate(param_p);
+      Value last_val{last_u, last_v, 0.0, _polyU.Tangent(param_p), _polyV.Tangent(param_p)};
+      for (size_t i = 0u; i < number_intervals; ++i) {
+        param_p += delta_p;
+        const double current_u = _polyU.Evaluate(param_p);
+        const double current_v = _polyV.Evaluate(param_p);
+        const double du = current_u - last_u;
+        const double dv = current_v - last_v;
+        current_s += std::sqrt(du * du + dv * dv);
+        Value current_val{current_u, current_v, current_s, _polyU.Tangent(param_p), _polyV.Tangent(param_p)};
+        _rtree.InsertElement(
+            Rtree::BSegment(Rtree::BPoint(static_cast<float>(last_val.s)), Rtree::BPoint(static_cast<float>(current_s))),
+            last_val,
+            current_val);
+        last_u = current_u;
+        last_v = current_v;
+        last_val = current_val;
+        if (current_s > length) {
+          break;
+        }
+      }
+    }
+
+    DirectedPoint PosFromDist(double dist) const {
+      const auto result = _rtree.GetNearestNeighbours(Rtree::BPoint(static_cast<float>(dist))).front();
+      const auto &val1 = result.second.first;
+      const auto &val2 = result.second.second;
+      const double rate = (val2.s - dist) / (val2.s - val1.s);
+      const double u = rate * val1.u + (1.0 - rate) * val2.u;
+      const double v = rate * val1.v + (1.0 - rate) * val2.v;
+      const double t_u = rate * val1.t_u + (1.0 - rate) * val2.t_u;
+      const double t_v = rate * val1.t_v + (1.0 - rate) * val2.t_v;
+      const Vector2D pos = RotatebyAngle(_heading, u, v);
+      DirectedPoint p(_start_position, _heading + std::atan2(t_v, t_u));
+      p.location.x += pos.x;
+      p.location.y += pos.y;
+      return p;
+    }
+
+  private:
+
+    struct Value {
+      double u, v, s, t_u, t_v;
+    };
+    using Rtree = SegmentCloudRtree<Value, 1>;
+
+    Location _start_position;
+    double _heading;
+    CubicPolynomial _polyU;
+    CubicPolynomial _polyV;
+    Rtree _rtree;
+  };
+
+} // namespace previous
+
+static void CheckSamePoint(const DirectedPoint &expected, const DirectedPoint &point, const double dist) {
+  // Both compute the same expressions, only the float bounds of the old
+  // R-tree may pick the neighbouring pair of samples right at a boundary.
+  ASSERT_NEAR(point.location.x, expected.location.x, 1e-4) << "at distance " << dist;
+  ASSERT_NEAR(point.location.y, expected.location.y, 1e-4) << "at distance " << dist;
+  ASSERT_NEAR(point.location.z, expected.location.z, 1e-4) << "at distance " << dist;
+  ASSERT_NEAR(point.tangent, expected.tangent, 1e-9) << "at distance " << dist;
+}
+
+TEST(road, geometry_matches_previous_evaluation) {
+  std::mt19937 generator(42u);
+  std::uniform_real_distribution<double> coefficient(-0.01, 0.01);
+  std::uniform_real_distribution<double> curvature(-0.05, 0.05);
+  std::uniform_real_distribution<double> heading(-3.0, 3.0);
+  std::uniform_real_distribution<double> length(5.0, 200.0);
+  const Location start(10.0f, -20.0f, 0.0f);
+
+  for (auto i = 0; i < 20; ++i) {
+    const double h = heading(generator);
+    const double l = length(generator);
+    double curve_start = curvature(generator);
+    double curve_end = curvature(generator);
+    if (curve_start == curve_end) {
+      curve_end += 0.01;
+    }
+    const GeometrySpiral spiral(0.0, l, h, start, curve_start, curve_end);
+
+    const double a = coefficient(generator), b = coefficient(generator);
+    const double c = 0.1 * coefficient(generator), d = 0.01 * coefficient(generator);
+    const GeometryPoly3 poly3(0.0, l, h, start, a, b, c, d);
+    const previous::Poly3 previous_poly3(start, h, l, a, b, c, d);
+
+    const GeometryParamPoly3 param_poly3(0.0, l, h, start, 0.0, 1.0, c, d, 0.0, b, c, d, true);
+    const previous::ParamPoly3 previous_param_poly3(start, h, l, 0.0, 1.0, c, d, 0.0, b, c, d, true);
+    const GeometryParamPoly3 normalized(0.0, l, h, start, 0.0, l, c, d, 0.0, b, l * c, l * d, false);
+    const previous::ParamPoly3 previous_normalized(start, h, l, 0.0, l, c, d, 0.0, b, l * c, l * d, false);
+
+    for (double dist = -1.0; dist < l + 1.0; dist += 0.0731) {
+      CheckSamePoint(previous::SpiralPosFromDist(start, h, l, curve_start, curve_end, dist), spiral.PosFromDist(dist), dist);
+      CheckSamePoint(previous_poly3.PosFromDist(dist), poly3.PosFromDist(dist), dist);
+      CheckSamePoint(previous_param_poly3.PosFromDist(dist), param_poly3.PosFromDist(dist), dist);
+      CheckSamePoint(previous_normalized.PosFromDist(dist), normalized.PosFromDist(dist), dist);
+    }
+  }
+}
+
+TEST(road, information_set_matches_previous_lookup) {
+  // Several types, some records sharing their distance, in random order. The
+  // lane width coefficient identifies each record.
+  auto make_infos = []() {
+    std::vector<std::unique_ptr<RoadInfo>> infos;
+    std::mt19937 generator(7u);
+    std::uniform_int_distribution<int> distance(0, 400);
+    std::uniform_int_distribution<int> type(0, 3);
+    for (auto i = 0; i < 500; ++i) {
+      const double s = 0.25 * distance(generator);
+      const double id = static_cast<double>(i);
+      switch (type(generator)) {
+        case 0: infos.emplace_back(std::make_unique<RoadInfoLaneWidth>(s, id, 0.0, 0.0, 0.0)); break;
+        case 1: infos.emplace_back(std::make_unique<RoadInfoLaneOffset>(s, id, 0.0, 0.0, 0.0)); break;
+        case 2: infos.emplace_back(std::make_unique<RoadInfoSpeed>(s, id)); break;
+        default: infos.emplace_back(std::make_unique<RoadInfoElevation>(s, id, 0.0, 0.0, 0.0)); break;
+      }
+    }
+    return infos;
+  };
+  const InformationSet info_set(make_infos());
+  const previous::InformationSet previous_info_set(make_infos());
+
+  auto ids = [](const auto &infos) {
+    std::vector<double> result;
+    for (const auto *info : infos) {
+      result.emplace_back(info->GetPolynomial().GetA());
+    }
+    return result;
+  };
+  auto speeds = [](const auto &infos) {
+    std::vector<double> result;
+    for (const auto *info : infos) {
+      result.emplace_back(info->GetSpeed());
+    }
+    return result;
+  };
+
+  ASSERT_EQ(ids(info_set.GetInfos<RoadInfoLaneWidth>()), ids(previous_info_set.GetInfos<RoadInfoLaneWidth>()));
+  ASSERT_EQ(ids(info_set.GetInfos<RoadInfoLaneOffset>()), ids(previous_info_set.GetInfos<RoadInfoLaneOffset>()));
+  ASSERT_EQ(speeds(info_set.GetInfos<RoadInfoSpeed>()), speeds(previous_info_set.GetInfos<RoadInfoSpeed>()));
+  ASSERT_TRUE(info_set.GetInfos<RoadInfoLaneBorder>().empty());
+
+  for (double s = -1.0; s < 102.0; s += 0.125) {
+    const auto *width = info_set.GetInfo<RoadInfoLaneWidth>(s);
+    const auto *previous_width = previous_info_set.GetInfo<RoadInfoLaneWidth>(s);
+    ASSERT_EQ(width == nullptr, previous_width == nullptr) << "at distance " << s;
+    if (width != nullptr) {
+      ASSERT_EQ(width->GetPolynomial().GetA(), previous_width->GetPolynomial().GetA()) << "at distance " << s;
+    }
+    const auto *speed = info_set.GetInfo<RoadInfoSpeed>(s);
+    const auto *previous_speed = previous_info_set.GetInfo<RoadInfoSpeed>(s);
+    ASSERT_EQ(speed == nullptr, previous_speed == nullptr) << "at distance " << s;
+    if (speed != nullptr) {
+      ASSERT_EQ(speed->GetSpeed(), previous_speed->GetSpeed()) << "at distance " << s;
+    }
+    for (const double length : {3.0, -3.0, 0.0}) {
+      ASSERT_EQ(
+          ids(info_set.GetInfos<RoadInfoLaneOffset>(s, s + length)),
+          ids(previous_info_set.GetInfos<RoadInfoLaneOffset>(s, s + length))) << "from " << s << " to " << s + length;
+    }
+  }
+}
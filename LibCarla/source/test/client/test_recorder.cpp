@@ -0,0 +1,639 @@
+// Copyright (c) 2023 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "test.h"
+
+#include <carla/recorder/ChunkStream.h>
+#include <carla/recorder/RecorderQuery.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace cr = carla::recorder;
+
+// =============================================================================
+// -- Recording writer ---------------------------------------------------------
+// =============================================================================
+
+/// Greedy LZ4 block compressor, enough to test the decompressor.
+static std::vector<char> CompressLZ4(const std::vector<char> &input) {
+  std::vector<char> output;
+  auto write_length = [&](size_t length) {
+    for (; length >= 255u; length -= 255u) {
+      output.push_back(static_cast<char>(255u));
+    }
+    output.push_back(static_cast<char>(length));
+  };
+  std::vector<size_t> table(4096u, SIZE_MAX);
+  size_t anchor = 0u;
+  size_t position = 0u;
+  // the last match must start 12 bytes before the end
+  while (input.size() >= 12u && position + 12u <= input.size()) {
+    uint32_t sequence;
+    std::memcpy(&sequence, input.data() + position, sizeof(sequence));
+    const size_t hash = (sequence * 2654435761u) >> 20u;
+    const size_t candidate = table[hash];
+    table[hash] = position;
+    if (candidate == SIZE_MAX ||
+        position - candidate > 65535u ||
+        std::memcmp(input.data() + candidate, input.data() + position, 4u) != 0) {
+      ++position;
+      continue;
+    }
+    size_t match = 4u;
+    while (position + match + 5u < input.size() && input[candidate + match] == input[position + match]) {
+      ++match;
+    }
+    const size_t literals = position - anchor;
+    output.push_back(static_cast<char>(
+        (std::min<size_t>(literals, 15u) << 4u) | std::min<size_t>(match - 4u, 15u)));
+    if (literals >= 15u) {
+      write_length(literals - 15u);
+    }
+    output.insert(output.end(), input.begin() + anchor, input.begin() + position);
+    const size_t offset = position - candidate;
+    output.push_back(static_cast<char>(offset & 0xFFu));
+    output.push_back(static_cast<char>(offset >> 8u));
+    if (match - 4u >= 15u) {
+      write_length(match - 4u - 15u);
+    }
+    position += match;
+    anchor = position;
+  }
+  const size_t literals = input.size() - anchor;
+  output.push_back(static_cast<char>(std::min<size_t>(literals, 15u) << 4u));
+  if (literals >= 15u) {
+    write_length(literals - 15u);
+  }
+  output.insert(output.end(), input.begin() + anchor, input.end());
+  return output;
+}
+
+/// Writes a recording in memory with the same layout as the recorder.
+class RecordingWriter {
+public:
+
+  RecordingWriter() {
+    Write<uint16_t>(1u);
+    WriteString("CARLA_RECORDER");
+    Write<int64_t>(1234);
+    WriteString("Town01");
+    _header_size = _data.size();
+  }
+
+  void StartFrame(uint64_t id, double duration, double elapsed) {
+    _frames.emplace_back(elapsed, _data.size());
+    StartPacket(cr::PacketId::FrameStart);
+    Write(id);
+    Write(duration);
+    Write(elapsed);
+    EndPacket();
+  }
+
+  void EndFrame() {
+    StartPacket(cr::PacketId::FrameEnd);
+    EndPacket();
+  }
+
+  void AddActor(uint32_t id, cr::ActorType type, const std::string &type_id) {
+    StartPacket(cr::PacketId::EventAdd);
+    Write<uint16_t>(1u);
+    Write(id);
+    Write(type);
+    for (auto i = 0u; i < 6u; ++i) {
+      Write(0.0f);
+    }
+    Write<uint32_t>(0u);
+    WriteString(type_id);
+    Write<uint16_t>(1u);
+    Write<uint8_t>(0u);
+    WriteString("role_name");
+    WriteString("autopilot");
+    EndPacket();
+  }
+
+  void DestroyActor(uint32_t id) {
+    StartPacket(cr::PacketId::EventDel);
+    Write<uint16_t>(1u);
+    Write(id);
+    EndPacket();
+  }
+
+  void AddCollision(uint32_t id_1, uint32_t id_2, bool is_hero_1 = false) {
+    StartPacket(cr::PacketId::Collision);
+    Write<uint16_t>(1u);
+    Write(cr::CollisionRecord{0u, id_1, id_2, is_hero_1, false});
+    EndPacket();
+  }
+
+  void AddPositions(const std::vector<cr::PositionRecord> &positions) {
+    StartPacket(cr::PacketId::Position);
+    Write(static_cast<uint16_t>(positions.size()));
+    for (const auto &position : positions) {
+      Write(position);
+    }
+    EndPacket();
+  }
+
+  void WriteIndex() {
+    const uint64_t offset = _data.size();
+    StartPacket(cr::PacketId::Index);
+    Write(static_cast<uint32_t>(_frames.size()));
+    for (const auto &frame : _frames) {
+      Write(cr::IndexFrameRecord{frame.first, frame.second});
+    }
+    Write<uint32_t>(0u);
+    EndPacket();
+    StartPacket(cr::PacketId::IndexFooter);
+    Write(offset);
+    Write(cr::IndexFooterMagic);
+    EndPacket();
+  }
+
+  void Save(const std::string &filename, size_t size = 0u) const {
+    std::ofstream file(filename, std::ios::binary);
+    file.write(_data.data(), size == 0u ? _data.size() : size);
+  }
+
+  /// Saves the recording compressed, with a chunk every @a frames_per_chunk
+  /// frames, alternating stored and compressed chunks.
+  void SaveCompressed(const std::string &filename, size_t frames_per_chunk) const {
+    std::ofstream file(filename, std::ios::binary);
+    file.write(_data.data(), _header_size);
+    for (size_t first = 0u; first < _frames.size(); first += frames_per_chunk) {
+      const size_t begin = _frames[first].second;
+      const size_t end = first + frames_per_chunk < _frames.size() ?
+          _frames[first + frames_per_chunk].second :
+          _data.size();
+      std::vector<char> chunk(_data.begin() + begin, _data.begin() + end);
+      const bool compress = (first / frames_per_chunk) % 2u == 1u;
+      const auto data = compress ? CompressLZ4(chunk) : chunk;
+      const char id = static_cast<char>(cr::PacketId::Chunk);
+      const uint32_t size = static_cast<uint32_t>(sizeof(cr::ChunkHeader) + data.size());
+      const cr::ChunkHeader header{
+          compress ? cr::ChunkFormat::LZ4 : cr::ChunkFormat::Stored,
+          static_cast<uint32_t>(chunk.size())};
+      file.write(&id, sizeof(id));
+      file.write(reinterpret_cast<const char *>(&size), sizeof(size));
+      file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+      file.write(data.data(), data.size());
+    }
+  }
+
+  /// Saves the recording with a ChunkWriter, as the recorder does, starting
+  /// a frame every time the frame before it is written.
+  void SaveChunked(const std::string &filename, cr::ChunkWriter &writer) const {
+    ASSERT_TRUE(writer.Open(filename));
+    std::ostream out(&writer);
+    out.write(_data.data(), _header_size);
+    writer.WriteUncompressed();
+    for (size_t i = 0u; i < _frames.size(); ++i) {
+      writer.FlushBefore(out.tellp());
+      const size_t end = i + 1u < _frames.size() ? _frames[i + 1u].second : _data.size();
+      out.write(_data.data() + _frames[i].second, end - _frames[i].second);
+    }
+    writer.Close();
+  }
+
+  const std::vector<char> &GetData() const {
+    return _data;
+  }
+
+private:
+
+  template <typename T>
+  void Write(const T &value) {
+    const auto *data = reinterpret_cast<const char *>(&value);
+    _data.insert(_data.end(), data, data + sizeof(T));
+  }
+
+  void WriteString(const std::string &value) {
+    Write(static_cast<uint16_t>(value.size()));
+    _data.insert(_data.end(), value.begin(), value.end());
+  }
+
+  void StartPacket(cr::PacketId id) {
+    Write(id);
+    _packet_start = _data.size();
+    Write<uint32_t>(0u);
+  }
+
+  void EndPacket() {
+    const uint32_t size = static_cast<uint32_t>(_data.size() - _packet_start - sizeof(uint32_t));
+    std::memcpy(_data.data() + _packet_start, &size, sizeof(size));
+  }
+
+  std::vector<char> _data;
+
+  size_t _header_size = 0u;
+
+  size_t _packet_start = 0u;
+
+  std::vector<std::pair<double, uint64_t>> _frames;
+};
+
+// =============================================================================
+// -- Test recording -----------------------------------------------------------
+// =============================================================================
+
+static constexpr uint32_t number_of_frames = 200u;
+static constexpr double frame_duration = 0.05;
+
+/// 5 vehicles, 3 walkers and 2 traffic lights alive during the whole
+/// recording, and a vehicle alive from frame 50 to frame 150. Vehicles 1 to 4
+/// and the walkers move 1 meter per frame, vehicle 5 is stopped since frame 1
+/// and the traffic lights never move from the origin.
+static RecordingWriter MakeRecording(bool with_index) {
+  RecordingWriter writer;
+  for (auto frame = 0u; frame < number_of_frames; ++frame) {
+    writer.StartFrame(frame + 1u, frame_duration, frame * frame_duration);
+    if (frame == 0u) {
+      for (auto id = 1u; id <= 5u; ++id) {
+        writer.AddActor(id, cr::ActorType::Vehicle, "vehicle.test");
+      }
+      for (auto id = 6u; id <= 8u; ++id) {
+        writer.AddActor(id, cr::ActorType::Walker, "walker.test");
+      }
+      writer.AddActor(9u, cr::ActorType::TrafficLight, "traffic.traffic_light");
+      writer.AddActor(10u, cr::ActorType::TrafficLight, "traffic.traffic_light");
+    }
+    if (frame == 50u) {
+      writer.AddActor(11u, cr::ActorType::Vehicle, "vehicle.late");
+    }
+    if (frame == 150u) {
+      writer.DestroyActor(11u);
+    }
+    // the same collision in consecutive frames, and again later
+    if ((frame >= 10u && frame <= 12u) || frame == 20u) {
+      writer.AddCollision(1u, 2u);
+    }
+    if (frame == 30u) {
+      writer.AddCollision(3u, 6u, true);
+    }
+    if (frame == 40u) {
+      writer.AddCollision(4u, cr::NoActorId);
+    }
+    std::vector<cr::PositionRecord> positions;
+    for (auto id = 1u; id <= 11u; ++id) {
+      if (id == 11u && (frame < 50u || frame >= 150u)) {
+        continue;
+      }
+      const bool moving = (id <= 4u) || (id >= 6u && id <= 8u) || (id == 11u);
+      const float x = moving ? 100.0f * frame : (id == 5u ? 500.0f : 0.0f);
+      const float y = id <= 8u ? 100.0f * id : 0.0f;
+      positions.push_back(cr::PositionRecord{id, {x, y, 0.0f}, {1.0f, 2.0f, 3.0f}});
+    }
+    writer.AddPositions(positions);
+    writer.EndFrame();
+  }
+  if (with_index) {
+    writer.WriteIndex();
+  }
+  return writer;
+}
+
+static void CheckQueries(const cr::RecorderQuery &query) {
+  ASSERT_EQ(query.GetInfo().map_name, "Town01");
+
+  const auto actors = query.GetActors();
+  ASSERT_EQ(actors.size(), 11u);
+  ASSERT_EQ(actors[0u].type_id, "vehicle.test");
+  ASSERT_EQ(actors[8u].type, cr::ActorType::TrafficLight);
+  ASSERT_LT(actors[0u].destroy_time, 0.0);
+  ASSERT_DOUBLE_EQ(actors[10u].spawn_time, 50u * frame_duration);
+  ASSERT_DOUBLE_EQ(actors[10u].destroy_time, 150u * frame_duration);
+
+  const auto all = query.GetTrajectories();
+  ASSERT_EQ(all.size(), 10u * number_of_frames + 100u);
+  for (auto i = 1u; i < all.size(); ++i) {
+    ASSERT_LE(all[i - 1u].frame, all[i].frame);
+  }
+  const auto trajectory = query.GetTrajectories({1u});
+  ASSERT_EQ(trajectory.size(), number_of_frames);
+  for (auto i = 0u; i < trajectory.size(); ++i) {
+    ASSERT_EQ(trajectory[i].actor_id, 1u);
+    ASSERT_EQ(trajectory[i].frame, i + 1u);
+    ASSERT_FLOAT_EQ(trajectory[i].x, static_cast<float>(i));
+    ASSERT_FLOAT_EQ(trajectory[i].y, 1.0f);
+    ASSERT_FLOAT_EQ(trajectory[i].roll, 1.0f);
+    ASSERT_FLOAT_EQ(trajectory[i].pitch, 2.0f);
+    ASSERT_FLOAT_EQ(trajectory[i].yaw, 3.0f);
+  }
+  ASSERT_EQ(query.GetTrajectories({11u, 5u}).size(), number_of_frames + 100u);
+
+  const auto collisions = query.GetCollisions();
+  ASSERT_EQ(collisions.size(), 4u);
+  ASSERT_EQ(collisions[0u].frame, 11u);
+  ASSERT_EQ(collisions[1u].frame, 21u);
+  ASSERT_EQ(collisions[2u].type_1, 'v');
+  ASSERT_EQ(collisions[2u].type_2, 'w');
+  ASSERT_EQ(collisions[3u].actor_id_2, cr::NoActorId);
+  ASSERT_EQ(collisions[3u].type_2, 'o');
+  ASSERT_EQ(query.GetCollisions('v', 'v').size(), 2u);
+  ASSERT_EQ(query.GetCollisions('v', 'w').size(), 1u);
+  ASSERT_EQ(query.GetCollisions('h', 'a').size(), 1u);
+  ASSERT_EQ(query.GetCollisions('a', 'o').size(), 1u);
+  ASSERT_EQ(query.GetCollisions('w', 'a').size(), 0u);
+
+  const auto blocked = query.GetBlockedActors(5.0, 1.0);
+  ASSERT_EQ(blocked.size(), 3u);
+  ASSERT_EQ(blocked[0u].actor_id, 9u);
+  ASSERT_EQ(blocked[1u].actor_id, 10u);
+  ASSERT_EQ(blocked[2u].actor_id, 5u);
+  ASSERT_NEAR(blocked[0u].duration, number_of_frames * frame_duration, 1e-6);
+  ASSERT_NEAR(blocked[2u].duration, (number_of_frames - 1u) * frame_duration, 1e-6);
+  ASSERT_DOUBLE_EQ(blocked[2u].elapsed, frame_duration);
+  ASSERT_FLOAT_EQ(blocked[2u].x, 5.0f);
+  ASSERT_TRUE(query.GetBlockedActors(20.0, 1.0).empty());
+}
+
+// =============================================================================
+// -- Tests --------------------------------------------------------------------
+// =============================================================================
+
+TEST(recorder, query_plain_recording) {
+  const std::string filename = "test_recorder_plain.log";
+  MakeRecording(false).Save(filename);
+  {
+    cr::RecorderQuery query(filename);
+    CheckQueries(query);
+  }
+  {
+    // split in many segments, without an index
+    cr::RecorderQuery query(filename, 1024u);
+    CheckQueries(query);
+  }
+  std::remove(filename.c_str());
+}
+
+TEST(recorder, query_indexed_recording) {
+  const std::string filename = "test_recorder_indexed.log";
+  MakeRecording(true).Save(filename);
+  {
+    cr::RecordingFile file(filename, 1024u);
+    ASSERT_FALSE(file.IsCompressed());
+    ASSERT_GT(file.GetNumberOfSegments(), 10u);
+  }
+  cr::RecorderQuery query(filename, 1024u);
+  CheckQueries(query);
+  std::remove(filename.c_str());
+}
+
+TEST(recorder, query_compressed_recording) {
+  const std::string filename = "test_recorder_compressed.log";
+  MakeRecording(true).SaveCompressed(filename, 7u);
+  {
+    cr::RecordingFile file(filename);
+    ASSERT_TRUE(file.IsCompressed());
+    ASSERT_EQ(file.GetNumberOfSegments(), (number_of_frames + 6u) / 7u);
+  }
+  cr::RecorderQuery query(filename);
+  CheckQueries(query);
+  std::remove(filename.c_str());
+}
+
+TEST(recorder, query_truncated_recording) {
+  const std::string filename = "test_recorder_truncated.log";
+  MakeRecording(true).Save(filename, 10000u);
+  cr::RecorderQuery query(filename, 1024u);
+  const auto trajectories = query.GetTrajectories();
+  ASSERT_FALSE(trajectories.empty());
+  ASSERT_LT(trajectories.size(), 10u * number_of_frames);
+  ASSERT_EQ(query.GetActors().size(), 10u);
+  std::remove(filename.c_str());
+}
+
+TEST(recorder, query_blocked_destroyed_actor) {
+  // vehicle 1 stops at frame 1 and it is destroyed at frame 100, vehicle 2
+  // stops at frame 1 until the end
+  const std::string filename = "test_recorder_blocked.log";
+  RecordingWriter writer;
+  for (auto frame = 0u; frame < number_of_frames; ++frame) {
+    writer.StartFrame(frame + 1u, frame_duration, frame * frame_duration);
+    if (frame == 0u) {
+      writer.AddActor(1u, cr::ActorType::Vehicle, "vehicle.test");
+      writer.AddActor(2u, cr::ActorType::Vehicle, "vehicle.test");
+    }
+    std::vector<cr::PositionRecord> positions;
+    if (frame < 100u) {
+      positions.push_back(cr::PositionRecord{1u, {500.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 0.0f}});
+    } else if (frame == 100u) {
+      writer.DestroyActor(1u);
+    }
+    positions.push_back(cr::PositionRecord{2u, {0.0f, 500.0f, 0.0f}, {0.0f, 0.0f, 0.0f}});
+    writer.AddPositions(positions);
+    writer.EndFrame();
+  }
+  writer.Save(filename);
+
+  // many more segments than threads
+  cr::RecorderQuery query(filename, 256u);
+  const auto blocked = query.GetBlockedActors(1.0, 1.0);
+  ASSERT_EQ(blocked.size(), 2u);
+  ASSERT_EQ(blocked[0u].actor_id, 2u);
+  ASSERT_NEAR(blocked[0u].duration, (number_of_frames - 1u) * frame_duration, 1e-6);
+  ASSERT_EQ(blocked[1u].actor_id, 1u);
+  ASSERT_NEAR(blocked[1u].duration, 99u * frame_duration, 1e-6);
+  ASSERT_DOUBLE_EQ(blocked[1u].elapsed, frame_duration);
+  ASSERT_FLOAT_EQ(blocked[1u].x, 5.0f);
+  std::remove(filename.c_str());
+}
+
+TEST(recorder, invalid_recording) {
+  const std::string filename = "test_recorder_invalid.log";
+  {
+    std::ofstream file(filename, std::ios::binary);
+    file << "this is not a recording";
+  }
+  ASSERT_THROW(cr::RecordingFile{filename}, std::runtime_error);
+  std::remove(filename.c_str());
+  ASSERT_THROW(cr::RecordingFile{filename}, std::runtime_error);
+}
+
+// =============================================================================
+// -- Chunk streams ------------------------------------------------------------
+// =============================================================================
+
+static bool CompressChunk(const std::vector<char> &data, std::vector<char> &compressed) {
+  compressed = CompressLZ4(data);
+  return compressed.size() < data.size();
+}
+
+static bool DecompressChunk(const std::vector<char> &compressed, std::vector<char> &data) {
+  return cr::DecompressLZ4(compressed.data(), compressed.size(), data.data(), data.size());
+}
+
+static std::vector<char> ReadAll(std::istream &in) {
+  return std::vector<char>(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+static size_t GetFileSize(const std::string &filename) {
+  std::ifstream file(filename, std::ios::binary | std::ios::ate);
+  return static_cast<size_t>(file.tellg());
+}
+
+TEST(recorder, chunk_stream_round_trip) {
+  const std::string filename = "test_recorder_chunks.log";
+  const auto recording = MakeRecording(true);
+  const auto &data = recording.GetData();
+  {
+    cr::ChunkWriter writer(CompressChunk, 4096u);
+    recording.SaveChunked(filename, writer);
+  }
+  ASSERT_LT(GetFileSize(filename), data.size());
+  {
+    cr::RecordingFile file(filename);
+    ASSERT_TRUE(file.IsCompressed());
+    ASSERT_GT(file.GetNumberOfSegments(), 3u);
+  }
+  {
+    cr::RecorderQuery query(filename);
+    CheckQueries(query);
+  }
+
+  cr::ChunkReader reader(DecompressChunk);
+  ASSERT_TRUE(reader.Open(filename));
+  std::istream in(&reader);
+  ASSERT_EQ(ReadAll(in), data);
+
+  // seek back and forth across the chunks
+  in.clear();
+  std::mt19937 generator(42u);
+  std::uniform_int_distribution<size_t> distribution(0u, data.size() - 1u);
+  for (auto i = 0u; i < 200u; ++i) {
+    const size_t position = distribution(generator);
+    const size_t count = std::min<size_t>(100u, data.size() - position);
+    in.seekg(static_cast<std::streamoff>(position));
+    ASSERT_EQ(static_cast<size_t>(in.tellg()), position);
+    std::vector<char> buffer(count);
+    in.read(buffer.data(), static_cast<std::streamsize>(count));
+    ASSERT_TRUE(in);
+    ASSERT_TRUE(std::equal(buffer.begin(), buffer.end(), data.begin() + position));
+  }
+  in.seekg(0, std::ios::end);
+  ASSERT_EQ(static_cast<size_t>(in.tellg()), data.size());
+
+  // as with files, there is nothing to read past the end
+  in.seekg(static_cast<std::streamoff>(data.size() + 10u));
+  ASSERT_EQ(static_cast<size_t>(in.tellg()), data.size() + 10u);
+  ASSERT_EQ(in.get(), std::char_traits<char>::eof());
+  in.clear();
+  in.seekg(10);
+  ASSERT_EQ(in.get(), data[10u]);
+  reader.Close();
+
+  // plain recordings are not read as chunks
+  MakeRecording(true).Save(filename);
+  ASSERT_FALSE(reader.Open(filename));
+  std::remove(filename.c_str());
+}
+
+TEST(recorder, chunk_stream_stored_chunks) {
+  const std::string filename = "test_recorder_stored_chunks.log";
+  const auto recording = MakeRecording(false);
+  const auto &data = recording.GetData();
+  {
+    // data that does not compress is stored as is
+    cr::ChunkWriter writer(
+        [](const std::vector<char> &, std::vector<char> &) { return false; },
+        4096u);
+    recording.SaveChunked(filename, writer);
+  }
+  size_t number_of_chunks = 0u;
+  {
+    cr::RecordingFile file(filename);
+    ASSERT_TRUE(file.IsCompressed());
+    number_of_chunks = file.GetNumberOfSegments();
+    ASSERT_GT(number_of_chunks, 3u);
+  }
+  const size_t chunk_header_size = sizeof(cr::PacketHeader) + sizeof(cr::ChunkHeader);
+  ASSERT_EQ(GetFileSize(filename), data.size() + number_of_chunks * chunk_header_size);
+
+  cr::ChunkReader reader(DecompressChunk);
+  ASSERT_TRUE(reader.Open(filename));
+  std::istream in(&reader);
+  ASSERT_EQ(ReadAll(in), data);
+  reader.Close();
+  std::remove(filename.c_str());
+}
+
+TEST(recorder, chunk_stream_truncated) {
+  const std::string filename = "test_recorder_truncated_chunks.log";
+  const auto recording = MakeRecording(false);
+  const auto &data = recording.GetData();
+  {
+    cr::ChunkWriter writer(CompressChunk, 4096u);
+    recording.SaveChunked(filename, writer);
+  }
+
+  // the last chunk is incomplete, as in a recording that was not closed
+  std::vector<char> file_data;
+  {
+    std::ifstream file(filename, std::ios::binary);
+    file_data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+  }
+  {
+    std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+    file.write(file_data.data(), static_cast<std::streamsize>(file_data.size() - 100u));
+  }
+
+  cr::ChunkReader reader(DecompressChunk);
+  ASSERT_TRUE(reader.Open(filename));
+  std::istream in(&reader);
+  const auto result = ReadAll(in);
+  ASSERT_GT(result.size(), 0u);
+  ASSERT_LT(result.size(), data.size());
+  ASSERT_TRUE(std::equal(result.begin(), result.end(), data.begin()));
+  in.clear();
+  in.seekg(0, std::ios::end);
+  ASSERT_EQ(static_cast<size_t>(in.tellg()), result.size());
+  reader.Close();
+  std::remove(filename.c_str());
+}
+
+TEST(recorder, chunk_writer_seek) {
+  const std::string filename = "test_recorder_chunk_seek.log";
+  const auto header = RecordingWriter().GetData();
+  const std::streamoff header_size = static_cast<std::streamoff>(header.size());
+  {
+    cr::ChunkWriter writer(CompressChunk, 4u);
+    ASSERT_TRUE(writer.Open(filename));
+    std::ostream out(&writer);
+    out.write(header.data(), header_size);
+    writer.WriteUncompressed();
+
+    // the data not sent yet can be rewritten
+    out << "0123456789";
+    out.seekp(header_size + 2);
+    out << "ab";
+    out.seekp(0, std::ios::end);
+    ASSERT_EQ(out.tellp(), header_size + 10);
+    writer.FlushBefore(out.tellp());
+    out << "xyz";
+
+    // but not the data already sent
+    out.seekp(header_size);
+    ASSERT_TRUE(out.fail());
+    out.clear();
+    writer.Close();
+  }
+
+  cr::ChunkReader reader(DecompressChunk);
+  ASSERT_TRUE(reader.Open(filename));
+  std::istream in(&reader);
+  auto expected = header;
+  const std::string content = "01ab456789xyz";
+  expected.insert(expected.end(), content.begin(), content.end());
+  ASSERT_EQ(ReadAll(in), expected);
+  reader.Close();
+  std::remove(filename.c_str());
+}
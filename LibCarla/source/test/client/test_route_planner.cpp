@@ -0,0 +1,213 @@
+// Copyright (c) 2023 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "test.h"
+
+#include <carla/nav/RoutePlanner.h>
+
+#include <recast/DetourAlloc.h>
+#include <recast/DetourNavMeshBuilder.h>
+
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <thread>
+#include <unordered_map>
+
+using carla::ActorId;
+using carla::geom::Location;
+using carla::nav::PlannedRoute;
+using carla::nav::RoutePlanner;
+
+using NavMeshPtr = std::unique_ptr<dtNavMesh, void (*)(dtNavMesh *)>;
+
+/// A navigation mesh of a single square polygon of 10 x 10 meters.
+static NavMeshPtr MakeSquareNavMesh() {
+  const unsigned short verts[] = {
+    0u, 0u, 0u,
+    0u, 0u, 10u,
+    10u, 0u, 10u,
+    10u, 0u, 0u};
+  // the vertices of the polygon and then its neighbours, all of them walls
+  const unsigned short polys[] = {
+    0u, 1u, 2u, 3u, 0xffff, 0xffff,
+    0xffff, 0xffff, 0xffff, 0xffff, 0xffff, 0xffff};
+  const unsigned short poly_flags[] = {1u};
+  const unsigned char poly_areas[] = {0u};
+
+  dtNavMeshCreateParams params;
+  std::memset(&params, 0, sizeof(params));
+  params.verts = verts;
+  params.vertCount = 4;
+  params.polys = polys;
+  params.polyFlags = poly_flags;
+  params.polyAreas = poly_areas;
+  params.polyCount = 1;
+  params.nvp = DT_VERTS_PER_POLYGON;
+  params.bmin[0] = 0.0f; params.bmin[1] = 0.0f; params.bmin[2] = 0.0f;
+  params.bmax[0] = 10.0f; params.bmax[1] = 1.0f; params.bmax[2] = 10.0f;
+  params.cs = 1.0f;
+  params.ch = 1.0f;
+  params.walkableHeight = 2.0f;
+  params.walkableRadius = 0.5f;
+  params.walkableClimb = 0.5f;
+  params.buildBvTree = true;
+
+  unsigned char *data = nullptr;
+  int data_size = 0;
+  if (!dtCreateNavMeshData(&params, &data, &data_size)) {
+    return NavMeshPtr(nullptr, dtFreeNavMesh);
+  }
+  NavMeshPtr mesh(dtAllocNavMesh(), dtFreeNavMesh);
+  if (mesh == nullptr || dtStatusFailed(mesh->init(data, data_size, DT_TILE_FREE_DATA))) {
+    dtFree(data);
+    return NavMeshPtr(nullptr, dtFreeNavMesh);
+  }
+  return mesh;
+}
+
+/// Takes routes from the planner until there are @a count or it times out.
+static std::vector<PlannedRoute> PopRoutes(RoutePlanner &planner, size_t count) {
+  std::vector<PlannedRoute> routes;
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+  PlannedRoute route;
+  while (routes.size() < count && std::chrono::steady_clock::now() < deadline) {
+    if (planner.TryPop(route)) {
+      routes.emplace_back(std::move(route));
+    } else {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  }
+  return routes;
+}
+
+TEST(route_planner, routes) {
+  auto mesh = MakeSquareNavMesh();
+  ASSERT_NE(mesh, nullptr);
+  dtQueryFilter filter;
+  RoutePlanner planner;
+  ASSERT_TRUE(planner.Start(mesh.get(), 2u, 512));
+
+  // the locations are in Unreal axis, the mesh is on the x-y plane
+  const uint64_t request = planner.Request(1u, Location(1.0f, 2.0f, 0.0f), Location(8.0f, 9.0f, 0.0f), &filter);
+  const uint64_t outside = planner.Request(2u, Location(1.0f, 2.0f, 0.0f), Location(50.0f, 50.0f, 0.0f), &filter);
+  auto routes = PopRoutes(planner, 2u);
+  ASSERT_EQ(routes.size(), 2u);
+  for (const auto &route : routes) {
+    if (route.id == 1u) {
+      ASSERT_EQ(route.request, request);
+      ASSERT_TRUE(route.found);
+      ASSERT_GE(route.path.size(), 2u);
+      ASSERT_EQ(route.path.size(), route.area.size());
+      ASSERT_NEAR(route.path.front().x, 1.0f, 0.01f);
+      ASSERT_NEAR(route.path.front().y, 2.0f, 0.01f);
+      ASSERT_NEAR(route.path.back().x, 8.0f, 0.01f);
+      ASSERT_NEAR(route.path.back().y, 9.0f, 0.01f);
+    } else {
+      ASSERT_EQ(route.id, 2u);
+      ASSERT_EQ(route.request, outside);
+      ASSERT_FALSE(route.found);
+      ASSERT_TRUE(route.path.empty());
+    }
+  }
+
+  auto statistics = planner.GetStatistics();
+  ASSERT_EQ(statistics.routes_delivered, 2u);
+  ASSERT_EQ(statistics.queued_requests, 0u);
+  ASSERT_GE(statistics.max_latency, statistics.mean_latency);
+}
+
+TEST(route_planner, superseded_and_cancelled_requests) {
+  constexpr ActorId number_of_walkers = 50u;
+  constexpr ActorId cancelled = 7u;
+  auto mesh = MakeSquareNavMesh();
+  ASSERT_NE(mesh, nullptr);
+  dtQueryFilter filter;
+  RoutePlanner planner;
+  ASSERT_TRUE(planner.Start(mesh.get(), 4u, 512));
+
+  // the routes of the first requests are computed but not taken
+  std::unordered_map<ActorId, uint64_t> latest;
+  for (ActorId id = 1u; id <= number_of_walkers; ++id) {
+    latest[id] = planner.Request(id, Location(1.0f, 1.0f, 0.0f), Location(5.0f, 1.0f, 0.0f), &filter);
+  }
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+  while (planner.GetStatistics().ready_routes < number_of_walkers &&
+         std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  ASSERT_EQ(planner.GetStatistics().ready_routes, number_of_walkers);
+
+  // every walker asks twice more, only the last request is delivered
+  for (int i = 2; i <= 3; ++i) {
+    for (ActorId id = 1u; id <= number_of_walkers; ++id) {
+      const float y = static_cast<float>(i);
+      latest[id] = planner.Request(id, Location(1.0f, 1.0f, 0.0f), Location(5.0f, y, 0.0f), &filter);
+    }
+  }
+  planner.Cancel(cancelled);
+
+  auto routes = PopRoutes(planner, number_of_walkers - 1u);
+  ASSERT_EQ(routes.size(), number_of_walkers - 1u);
+  std::unordered_map<ActorId, int> delivered;
+  for (const auto &route : routes) {
+    ASSERT_NE(route.id, cancelled);
+    ASSERT_EQ(route.request, latest[route.id]);
+    ASSERT_TRUE(route.found);
+    ASSERT_NEAR(route.path.back().y, 3.0f, 0.01f);
+    ++delivered[route.id];
+  }
+  ASSERT_EQ(delivered.size(), number_of_walkers - 1u);
+
+  // the routes left, if any, are from the older requests
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  PlannedRoute route;
+  ASSERT_FALSE(planner.TryPop(route));
+  ASSERT_EQ(planner.GetStatistics().routes_delivered, number_of_walkers - 1u);
+
+  // a cancelled walker can ask again
+  const uint64_t request = planner.Request(cancelled, Location(1.0f, 1.0f, 0.0f), Location(5.0f, 5.0f, 0.0f), &filter);
+  routes = PopRoutes(planner, 1u);
+  ASSERT_EQ(routes.size(), 1u);
+  ASSERT_EQ(routes.front().id, cancelled);
+  ASSERT_EQ(routes.front().request, request);
+}
+
+TEST(route_planner, stop_with_requests_in_flight) {
+  constexpr ActorId number_of_walkers = 2000u;
+  auto mesh = MakeSquareNavMesh();
+  ASSERT_NE(mesh, nullptr);
+  dtQueryFilter filter;
+  RoutePlanner planner;
+  ASSERT_TRUE(planner.Start(mesh.get(), 4u, 512));
+  for (ActorId id = 1u; id <= number_of_walkers; ++id) {
+    planner.Request(id, Location(1.0f, 1.0f, 0.0f), Location(9.0f, 9.0f, 0.0f), &filter);
+  }
+
+  // the requests pending and the routes not taken are discarded
+  planner.Stop();
+  PlannedRoute route;
+  ASSERT_FALSE(planner.TryPop(route));
+  auto statistics = planner.GetStatistics();
+  ASSERT_EQ(statistics.queued_requests, 0u);
+  ASSERT_EQ(statistics.ready_routes, 0u);
+
+  // the planner can be started again, as when a new map is loaded
+  ASSERT_TRUE(planner.Start(mesh.get(), 2u, 512));
+  const uint64_t request = planner.Request(1u, Location(1.0f, 1.0f, 0.0f), Location(9.0f, 9.0f, 0.0f), &filter);
+  auto routes = PopRoutes(planner, 1u);
+  ASSERT_EQ(routes.size(), 1u);
+  ASSERT_EQ(routes.front().request, request);
+
+  // and destroyed with requests in flight
+  {
+    RoutePlanner other;
+    ASSERT_TRUE(other.Start(mesh.get(), 4u, 512));
+    for (ActorId id = 1u; id <= number_of_walkers; ++id) {
+      other.Request(id, Location(1.0f, 1.0f, 0.0f), Location(9.0f, 9.0f, 0.0f), &filter);
+    }
+  }
+}
@@ -8,12 +8,15 @@
 
 #include <carla/MsgPackAdaptors.h>
 #include <carla/ThreadGroup.h>
+#include <carla/client/Future.h>
 #include <carla/rpc/Actor.h>
 #include <carla/rpc/Client.h>
 #include <carla/rpc/Response.h>
 #include <carla/rpc/Server.h>
 
+#include <future>
 #include <thread>
+#include <vector>
 
 using namespace carla::rpc;
 using namespace std::chrono_literals;
@@ -62,3 +65,62 @@ TEST(rpc, server_bind_sync_run_on_game_thread) {
   std::cout << "game thread: run " << i << " slices.\n";
   ASSERT_TRUE(done);
 }
+
+TEST(rpc, pipelined_calls) {
+  const uint16_t port = (TESTING_PORT != 0u ? TESTING_PORT : 2017u);
+
+  Server server(port);
+
+  server.BindSync("do_the_thing", [](int x, int y) -> int {
+    return x + y;
+  });
+
+  server.AsyncRun(4u);
+
+  std::atomic_bool done{false};
+
+  carla::ThreadGroup threads;
+  threads.CreateThread([&]() {
+    Client client("localhost", port);
+    std::vector<std::future<clmdep_msgpack::object_handle>> futures;
+    for (auto i = 0; i < 300; ++i) {
+      futures.emplace_back(client.async_call_with_response("do_the_thing", i, 1));
+    }
+    for (auto i = 0u; i < futures.size(); ++i) {
+      auto result = futures[i].get().as<int>();
+      EXPECT_EQ(result, static_cast<int>(i) + 1);
+    }
+    done = true;
+  });
+
+  auto i = 0u;
+  for (; i < 1'000'000u; ++i) {
+    server.SyncRunFor(2ms);
+    if (done) {
+      break;
+    }
+  }
+  std::cout << "game thread: run " << i << " slices.\n";
+  ASSERT_TRUE(done);
+}
+
+TEST(rpc, future_then) {
+  using carla::client::Future;
+  using carla::time_duration;
+  auto promise = std::make_shared<std::promise<int>>();
+  auto shared = promise->get_future().share();
+  Future<int> future(
+      [shared](time_duration timeout) {
+        return shared.wait_for(timeout.to_chrono()) == std::future_status::ready;
+      },
+      [shared]() { return shared.get(); });
+  auto twice = std::move(future).Then([](int x) { return 2 * x; });
+  ASSERT_FALSE(future.IsValid());
+  ASSERT_TRUE(twice.IsValid());
+  ASSERT_FALSE(twice.IsReady());
+  promise->set_value(21);
+  ASSERT_TRUE(twice.IsReady());
+  ASSERT_EQ(twice.Get(), 42);
+  ASSERT_FALSE(twice.IsValid());
+  ASSERT_EQ(Future<int>::MakeReady(7).Get(), 7);
+}
@@ -0,0 +1,87 @@
+// Copyright (c) 2023 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "test.h"
+#include "Random.h"
+
+#include <carla/trafficmanager/CollisionStage.h>
+#include <carla/trafficmanager/SimulationState.h>
+
+#include <vector>
+
+using namespace carla::traffic_manager;
+namespace cg = carla::geom;
+
+static KinematicState make_kinematic_state(const cg::Location &location) {
+  KinematicState state;
+  state.location = location;
+  state.rotation = cg::Rotation(0.0f, static_cast<float>(util::Random::Uniform(-180.0, 180.0)), 0.0f);
+  state.velocity = util::Random::Location(-10.0f, 10.0f);
+  state.speed_limit = 50.0f;
+  state.physics_enabled = true;
+  state.is_dormant = false;
+  state.hybrid_end_location = state.location;
+  return state;
+}
+
+TEST(simulation_state, remove_keeps_slots_dense) {
+  SimulationState simulation_state;
+  std::vector<KinematicState> states;
+  for (ActorId actor_id = 0u; actor_id < 10u; ++actor_id) {
+    states.push_back(make_kinematic_state(util::Random::Location(-500.0f, 500.0f)));
+    simulation_state.AddActor(actor_id, states.back(), {ActorType::Vehicle, 2.0f, 1.0f, 0.8f}, {TLS::Green, false});
+  }
+  simulation_state.RemoveActor(3u);
+  simulation_state.RemoveActor(9u);
+  simulation_state.RemoveActor(42u);
+  ASSERT_EQ(simulation_state.Size(), 8u);
+  ASSERT_FALSE(simulation_state.ContainsActor(3u));
+  ASSERT_EQ(simulation_state.GetSlot(3u), INVALID_STATE_SLOT);
+  for (ActorId actor_id = 0u; actor_id < 10u; ++actor_id) {
+    if (actor_id == 3u || actor_id == 9u) {
+      continue;
+    }
+    const size_t slot = simulation_state.GetSlot(actor_id);
+    ASSERT_LT(slot, simulation_state.Size());
+    ASSERT_EQ(simulation_state.GetActorIdArray()[slot], actor_id);
+    ASSERT_EQ(simulation_state.GetLocation(actor_id), states[actor_id].location);
+    ASSERT_EQ(simulation_state.GetHeading(actor_id), states[actor_id].rotation.GetForwardVector());
+  }
+}
+
+TEST(simulation_state, collision_candidates_sorted_by_distance_and_id) {
+  // Actors 5 and 2 are at the same distance from the ego vehicle, actor 7 is
+  // farther away, actor 4 is too high and actor 6 is out of range.
+  SimulationState simulation_state;
+  const std::vector<std::pair<ActorId, cg::Location>> actors = {
+      {1u, cg::Location(0.0f, 0.0f, 0.0f)},
+      {5u, cg::Location(10.0f, 0.0f, 0.0f)},
+      {7u, cg::Location(0.0f, 15.0f, 0.0f)},
+      {2u, cg::Location(-10.0f, 0.0f, 0.0f)},
+      {4u, cg::Location(5.0f, 5.0f, 10.0f)},
+      {6u, cg::Location(100.0f, 0.0f, 0.0f)},
+      {3u, cg::Location(0.0f, -5.0f, 0.0f)}};
+  for (const auto &actor : actors) {
+    simulation_state.AddActor(actor.first, make_kinematic_state(actor.second),
+                              {ActorType::Vehicle, 2.0f, 1.0f, 0.8f}, {TLS::Green, false});
+  }
+  BroadPhaseGrid grid(20.0f);
+  grid.Build(simulation_state.GetLocationArray());
+
+  std::vector<size_t> nearby_slots;
+  grid.Query(cg::Location(0.0f, 0.0f, 0.0f), 20.0f, nearby_slots);
+
+  // Actor 3 does not overlap the ego vehicle's path. Both the nearby slots
+  // and the overlapping actors can be the smaller set.
+  const std::vector<CollisionCandidate> expected = {{100.0f, 2u}, {100.0f, 5u}, {225.0f, 7u}};
+  for (const ActorIdSet &overlapping_actors : {ActorIdSet{2u, 4u, 5u, 7u},
+                                               ActorIdSet{2u, 4u, 5u, 6u, 7u, 8u, 9u, 10u, 11u, 12u}}) {
+    std::vector<CollisionCandidate> candidates;
+    SelectCollisionCandidates(simulation_state, simulation_state.GetSlot(1u), 20.0f * 20.0f,
+                              nearby_slots, overlapping_actors, candidates);
+    ASSERT_EQ(candidates, expected);
+  }
+}
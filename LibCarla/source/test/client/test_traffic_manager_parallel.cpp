@@ -0,0 +1,162 @@
+// Copyright (c) 2023 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "test.h"
+
+#include <carla/ThreadGroup.h>
+#include <carla/trafficmanager/RandomGenerator.h>
+#include <carla/trafficmanager/ShardedMap.h>
+#include <carla/trafficmanager/TrackTraffic.h>
+
+#include <random>
+#include <tuple>
+#include <vector>
+
+using carla::ActorId;
+using carla::traffic_manager::ActorIdSet;
+using carla::traffic_manager::RandomGenerator;
+using carla::traffic_manager::ShardedMap;
+using carla::traffic_manager::TrackTraffic;
+using carla::traffic_manager::VehicleRandomGenerators;
+using carla::traffic_manager::WaypointIndex;
+
+TEST(traffic_manager_parallel, sharded_map) {
+  ShardedMap<ActorId, int> map(4u);
+  ASSERT_EQ(map.Find(1u), nullptr);
+  ASSERT_EQ(map.Insert(1u, 10), 10);
+  ASSERT_EQ(map.Insert(1u, 20), 10);
+  ASSERT_EQ(map.Set(1u, 30), 30);
+  int *value = map.Find(1u);
+  ASSERT_NE(value, nullptr);
+
+  // Values stay in place while other keys are inserted.
+  for (ActorId id = 2u; id < 1000u; ++id) {
+    map.Insert(id, static_cast<int>(id));
+  }
+  ASSERT_EQ(value, map.Find(1u));
+  ASSERT_EQ(*value, 30);
+  ASSERT_EQ(map.Size(), 999u);
+
+  map.Erase(1u);
+  ASSERT_FALSE(map.Contains(1u));
+  map.Clear();
+  ASSERT_EQ(map.Size(), 0u);
+}
+
+TEST(traffic_manager_parallel, sharded_map_concurrent_inserts) {
+  constexpr ActorId number_of_keys = 4000u;
+  constexpr ActorId number_of_threads = 4u;
+  ShardedMap<ActorId, ActorId> map;
+  {
+    carla::ThreadGroup threads;
+    for (ActorId t = 0u; t < number_of_threads; ++t) {
+      threads.CreateThread([&map, t]() {
+        for (ActorId id = t; id < number_of_keys; id += number_of_threads) {
+          ActorId &value = map.Insert(id, 0u);
+          value = id * 2u;
+        }
+      });
+    }
+  }
+  ASSERT_EQ(map.Size(), number_of_keys);
+  for (ActorId id = 0u; id < number_of_keys; ++id) {
+    const ActorId *value = map.Find(id);
+    ASSERT_NE(value, nullptr);
+    ASSERT_EQ(*value, id * 2u);
+  }
+}
+
+TEST(traffic_manager_parallel, vehicle_generators_do_not_depend_on_order) {
+  const std::vector<ActorId> vehicles = {7u, 3u, 42u, 15u};
+  const std::vector<ActorId> reversed(vehicles.rbegin(), vehicles.rend());
+
+  VehicleRandomGenerators forward(1234u);
+  VehicleRandomGenerators backward(1234u);
+  forward.Update(vehicles);
+  backward.Update(reversed);
+
+  for (auto i = 0u; i < 10u; ++i) {
+    for (auto index = 0u; index < vehicles.size(); ++index) {
+      const auto reversed_index = vehicles.size() - 1u - index;
+      ASSERT_EQ(forward.Get(index).next(), backward.Get(reversed_index).next());
+    }
+  }
+
+  // Every vehicle has its own sequence.
+  VehicleRandomGenerators generators(1234u);
+  generators.Update(vehicles);
+  ASSERT_NE(generators.Get(0u).next(), generators.Get(1u).next());
+
+  // A vehicle keeps its sequence when others are removed, and it is restarted by a new seed.
+  const double first = generators.Get(2u).next();
+  generators.Update({42u});
+  VehicleRandomGenerators expected(1234u);
+  expected.Update({42u});
+  ASSERT_EQ(expected.Get(0u).next(), first);
+  ASSERT_EQ(generators.Get(0u).next(), expected.Get(0u).next());
+  generators.SetSeed(1234u);
+  generators.Update({42u});
+  ASSERT_EQ(generators.Get(0u).next(), first);
+}
+
+static void ApplyChanges(
+    TrackTraffic &track_traffic,
+    const std::vector<std::tuple<ActorId, WaypointIndex, bool>> &changes) {
+  for (const auto &change : changes) {
+    if (std::get<2>(change)) {
+      track_traffic.UpdatePassingVehicle(std::get<1>(change), std::get<0>(change));
+    } else {
+      track_traffic.RemovePassingVehicle(std::get<1>(change), std::get<0>(change));
+    }
+  }
+}
+
+TEST(traffic_manager_parallel, deferred_track_traffic_updates) {
+  constexpr ActorId number_of_actors = 64u;
+  constexpr WaypointIndex number_of_waypoints = 200u;
+  std::mt19937 generator(42u);
+  std::uniform_int_distribution<WaypointIndex> waypoint_distribution(0u, number_of_waypoints - 1u);
+  std::bernoulli_distribution enter_distribution(0.6);
+
+  // Changes of each actor, in the order the actor makes them.
+  std::vector<std::vector<std::tuple<ActorId, WaypointIndex, bool>>> changes(number_of_actors);
+  for (ActorId actor = 0u; actor < number_of_actors; ++actor) {
+    for (auto i = 0u; i < 100u; ++i) {
+      changes[actor].emplace_back(actor, waypoint_distribution(generator), enter_distribution(generator));
+    }
+  }
+
+  TrackTraffic immediate;
+  for (const auto &actor_changes : changes) {
+    ApplyChanges(immediate, actor_changes);
+  }
+
+  TrackTraffic deferred;
+  deferred.DeferUpdates();
+  {
+    carla::ThreadGroup threads;
+    for (ActorId t = 0u; t < 4u; ++t) {
+      threads.CreateThread([&deferred, &changes, t]() {
+        for (ActorId actor = t; actor < number_of_actors; actor += 4u) {
+          ApplyChanges(deferred, changes[actor]);
+        }
+      });
+    }
+  }
+  // Nothing changes until the updates are committed.
+  for (WaypointIndex waypoint = 0u; waypoint < number_of_waypoints; ++waypoint) {
+    ASSERT_TRUE(deferred.GetPassingVehicles(waypoint).empty());
+  }
+  deferred.CommitUpdates();
+
+  for (WaypointIndex waypoint = 0u; waypoint < number_of_waypoints; ++waypoint) {
+    ASSERT_EQ(deferred.GetPassingVehicles(waypoint), immediate.GetPassingVehicles(waypoint));
+  }
+
+  // Updates are applied right away once committed.
+  deferred.UpdatePassingVehicle(number_of_waypoints, 1u);
+  ASSERT_EQ(deferred.GetPassingVehicles(number_of_waypoints), ActorIdSet({1u}));
+}
@@ -0,0 +1,284 @@
+// Copyright (c) 2023 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "test.h"
+
+#include <carla/ThreadGroup.h>
+#include <carla/client/detail/ActorFactory.h>
+#include <carla/trafficmanager/Parameters.h>
+
+#include <atomic>
+#include <functional>
+#include <vector>
+
+using carla::ActorId;
+using carla::traffic_manager::ActorPtr;
+using carla::traffic_manager::Parameters;
+using carla::traffic_manager::VehicleParameterId;
+using carla::traffic_manager::VehicleParameterUpdate;
+using carla::traffic_manager::VehicleParameters;
+
+/// An actor that is only used for its id, without a simulator.
+static ActorPtr MakeActor(ActorId id) {
+  carla::rpc::Actor description;
+  description.id = id;
+  description.description.id = "static.prop.test";
+  return carla::client::detail::ActorFactory::MakeActor(
+      carla::client::detail::EpisodeProxy{},
+      description,
+      carla::client::GarbageCollectionPolicy::Disabled);
+}
+
+TEST(traffic_manager_parameters, defaults_and_globals) {
+  Parameters parameters;
+  const auto vehicle = MakeActor(1u);
+  parameters.UpdateTable({1u, 2u});
+  for (auto index = 0u; index < 2u; ++index) {
+    const VehicleParameters &values = parameters.GetVehicleParameters(index);
+    ASSERT_EQ(values.percentage_speed_difference, 0.0f);
+    ASSERT_EQ(values.exact_desired_speed, -1.0f);
+    ASSERT_EQ(values.lane_offset, 0.0f);
+    ASSERT_EQ(values.distance_to_leading_vehicle, 2.0f);
+    ASSERT_TRUE(values.auto_lane_change);
+    ASSERT_FALSE(values.force_lane_change.change_lane);
+    ASSERT_EQ(values.perc_keep_right, -1.0f);
+    ASSERT_FALSE(values.update_vehicle_lights);
+    ASSERT_TRUE(values.ignore_collision.empty());
+  }
+
+  // the globals apply to every vehicle without a value of its own
+  parameters.SetGlobalPercentageSpeedDifference(30.0f);
+  parameters.SetGlobalLaneOffset(0.5f);
+  parameters.SetGlobalDistanceToLeadingVehicle(5.0f);
+  parameters.SetPercentageSpeedDifference(vehicle, 10.0f);
+  parameters.UpdateTable({1u, 2u});
+  ASSERT_EQ(parameters.GetVehicleParameters(0u).percentage_speed_difference, 10.0f);
+  ASSERT_EQ(parameters.GetVehicleParameters(1u).percentage_speed_difference, 30.0f);
+  for (auto index = 0u; index < 2u; ++index) {
+    ASSERT_EQ(parameters.GetVehicleParameters(index).lane_offset, 0.5f);
+    ASSERT_EQ(parameters.GetVehicleParameters(index).distance_to_leading_vehicle, 5.0f);
+  }
+  ASSERT_EQ(parameters.GetActorParameters(99u).percentage_speed_difference, 30.0f);
+  ASSERT_EQ(parameters.GetActorParameters(99u).lane_offset, 0.5f);
+
+  // the global speed difference can't slow down more than a 100%
+  parameters.SetGlobalPercentageSpeedDifference(150.0f);
+  parameters.UpdateTable({1u, 2u});
+  ASSERT_EQ(parameters.GetVehicleParameters(1u).percentage_speed_difference, 100.0f);
+}
+
+TEST(traffic_manager_parameters, target_velocity) {
+  VehicleParameters values;
+  ASSERT_FLOAT_EQ(values.GetTargetVelocity(50.0f), 50.0f);
+  values.percentage_speed_difference = 20.0f;
+  ASSERT_FLOAT_EQ(values.GetTargetVelocity(50.0f), 40.0f);
+  values.percentage_speed_difference = -50.0f;
+  ASSERT_FLOAT_EQ(values.GetTargetVelocity(50.0f), 75.0f);
+  values.exact_desired_speed = 10.0f;
+  ASSERT_FLOAT_EQ(values.GetTargetVelocity(50.0f), 10.0f);
+  values.exact_desired_speed = 0.0f;
+  ASSERT_FLOAT_EQ(values.GetTargetVelocity(50.0f), 0.0f);
+
+  // the last of the speed difference and the desired speed set is the one
+  // used, also over the global speed difference
+  Parameters parameters;
+  const auto vehicle = MakeActor(1u);
+  parameters.SetGlobalPercentageSpeedDifference(50.0f);
+  parameters.SetPercentageSpeedDifference(vehicle, 20.0f);
+  parameters.SetDesiredSpeed(vehicle, 15.0f);
+  parameters.UpdateTable({1u});
+  ASSERT_FLOAT_EQ(parameters.GetVehicleParameters(0u).GetTargetVelocity(50.0f), 15.0f);
+  ASSERT_EQ(parameters.GetVehicleParameters(0u).percentage_speed_difference, 50.0f);
+
+  parameters.SetPercentageSpeedDifference(vehicle, 20.0f);
+  parameters.UpdateTable({1u});
+  ASSERT_EQ(parameters.GetVehicleParameters(0u).exact_desired_speed, -1.0f);
+  ASSERT_FLOAT_EQ(parameters.GetVehicleParameters(0u).GetTargetVelocity(50.0f), 40.0f);
+}
+
+TEST(traffic_manager_parameters, unregistered_actors) {
+  Parameters parameters;
+  const auto vehicle = MakeActor(1u);
+  const auto other = MakeActor(42u);
+  parameters.SetDistanceToLeadingVehicle(other, 7.0f);
+  parameters.SetCollisionDetection(vehicle, other, false);
+  parameters.SetCollisionDetection(other, vehicle, false);
+  parameters.UpdateTable({1u});
+
+  // the actors that are not registered get a slot after the vehicles
+  ASSERT_EQ(parameters.GetActorParameters(42u).distance_to_leading_vehicle, 7.0f);
+  ASSERT_EQ(parameters.GetActorParameters(1u).distance_to_leading_vehicle, 2.0f);
+  ASSERT_EQ(&parameters.GetActorParameters(1u), &parameters.GetVehicleParameters(0u));
+  ASSERT_FALSE(parameters.GetVehicleParameters(0u).GetCollisionDetection(42u));
+  ASSERT_TRUE(parameters.GetVehicleParameters(0u).GetCollisionDetection(7u));
+  ASSERT_FALSE(parameters.GetActorParameters(42u).GetCollisionDetection(1u));
+
+  // and keep their values once they are registered
+  parameters.UpdateTable({42u, 1u});
+  ASSERT_EQ(parameters.GetVehicleParameters(0u).distance_to_leading_vehicle, 7.0f);
+  ASSERT_FALSE(parameters.GetVehicleParameters(1u).GetCollisionDetection(42u));
+
+  parameters.SetCollisionDetection(vehicle, other, true);
+  parameters.UpdateTable({42u, 1u});
+  ASSERT_TRUE(parameters.GetVehicleParameters(1u).GetCollisionDetection(42u));
+}
+
+TEST(traffic_manager_parameters, forced_lane_change_lasts_one_cycle) {
+  Parameters parameters;
+  const auto vehicle = MakeActor(1u);
+  const auto other = MakeActor(5u);
+  parameters.SetForceLaneChange(vehicle, true);
+  parameters.SetForceLaneChange(other, false);
+  parameters.UpdateTable({1u});
+  ASSERT_TRUE(parameters.GetVehicleParameters(0u).force_lane_change.change_lane);
+  ASSERT_TRUE(parameters.GetVehicleParameters(0u).force_lane_change.direction);
+  ASSERT_FALSE(parameters.GetActorParameters(5u).force_lane_change.change_lane);
+
+  // the change of a vehicle that is not registered waits until it is
+  parameters.UpdateTable({1u, 5u});
+  ASSERT_FALSE(parameters.GetVehicleParameters(0u).force_lane_change.change_lane);
+  ASSERT_TRUE(parameters.GetVehicleParameters(1u).force_lane_change.change_lane);
+  ASSERT_FALSE(parameters.GetVehicleParameters(1u).force_lane_change.direction);
+
+  parameters.UpdateTable({1u, 5u});
+  ASSERT_FALSE(parameters.GetVehicleParameters(0u).force_lane_change.change_lane);
+  ASSERT_FALSE(parameters.GetVehicleParameters(1u).force_lane_change.change_lane);
+}
+
+TEST(traffic_manager_parameters, table_is_rebuilt_on_changes) {
+  Parameters parameters;
+  const auto vehicle = MakeActor(1u);
+  const auto other = MakeActor(2u);
+  parameters.SetLaneOffset(vehicle, 1.0f);
+  parameters.UpdateTable({1u, 2u});
+  ASSERT_EQ(parameters.GetVehicleParameters(0u).lane_offset, 1.0f);
+
+  // the values set take effect in the next cycle
+  parameters.SetLaneOffset(vehicle, 2.0f);
+  parameters.SetAutoLaneChange(other, false);
+  ASSERT_EQ(parameters.GetVehicleParameters(0u).lane_offset, 1.0f);
+  ASSERT_TRUE(parameters.GetVehicleParameters(1u).auto_lane_change);
+  parameters.UpdateTable({1u, 2u});
+  ASSERT_EQ(parameters.GetVehicleParameters(0u).lane_offset, 2.0f);
+  ASSERT_FALSE(parameters.GetVehicleParameters(1u).auto_lane_change);
+
+  // also when only the vehicle list changes
+  parameters.UpdateTable({2u, 1u});
+  ASSERT_FALSE(parameters.GetVehicleParameters(0u).auto_lane_change);
+  ASSERT_EQ(parameters.GetVehicleParameters(1u).lane_offset, 2.0f);
+
+  // or a global, including the distance margin
+  parameters.SetGlobalDistanceToLeadingVehicle(4.0f);
+  parameters.UpdateTable({2u, 1u});
+  ASSERT_EQ(parameters.GetVehicleParameters(0u).distance_to_leading_vehicle, 4.0f);
+}
+
+static void ExpectSameParameters(const VehicleParameters &lhs, const VehicleParameters &rhs) {
+  EXPECT_EQ(lhs.percentage_speed_difference, rhs.percentage_speed_difference);
+  EXPECT_EQ(lhs.exact_desired_speed, rhs.exact_desired_speed);
+  EXPECT_EQ(lhs.lane_offset, rhs.lane_offset);
+  EXPECT_EQ(lhs.distance_to_leading_vehicle, rhs.distance_to_leading_vehicle);
+  EXPECT_EQ(lhs.force_lane_change.change_lane, rhs.force_lane_change.change_lane);
+  EXPECT_EQ(lhs.force_lane_change.direction, rhs.force_lane_change.direction);
+  EXPECT_EQ(lhs.auto_lane_change, rhs.auto_lane_change);
+  EXPECT_EQ(lhs.perc_keep_right, rhs.perc_keep_right);
+  EXPECT_EQ(lhs.perc_random_left, rhs.perc_random_left);
+  EXPECT_EQ(lhs.perc_random_right, rhs.perc_random_right);
+  EXPECT_EQ(lhs.perc_run_traffic_light, rhs.perc_run_traffic_light);
+  EXPECT_EQ(lhs.perc_run_traffic_sign, rhs.perc_run_traffic_sign);
+  EXPECT_EQ(lhs.perc_ignore_walkers, rhs.perc_ignore_walkers);
+  EXPECT_EQ(lhs.perc_ignore_vehicles, rhs.perc_ignore_vehicles);
+  EXPECT_EQ(lhs.update_vehicle_lights, rhs.update_vehicle_lights);
+}
+
+TEST(traffic_manager_parameters, bulk_updates_match_setters) {
+  using Setter = std::function<void(Parameters &, const ActorPtr &, float)>;
+  const std::vector<std::pair<VehicleParameterId, Setter>> setters = {
+    {VehicleParameterId::PercentageSpeedDifference, [](Parameters &p, const ActorPtr &a, float v) { p.SetPercentageSpeedDifference(a, v); }},
+    {VehicleParameterId::LaneOffset, [](Parameters &p, const ActorPtr &a, float v) { p.SetLaneOffset(a, v); }},
+    {VehicleParameterId::DesiredSpeed, [](Parameters &p, const ActorPtr &a, float v) { p.SetDesiredSpeed(a, v); }},
+    {VehicleParameterId::UpdateVehicleLights, [](Parameters &p, const ActorPtr &a, float v) { p.SetUpdateVehicleLights(a, v != 0.0f); }},
+    {VehicleParameterId::ForceLaneChange, [](Parameters &p, const ActorPtr &a, float v) { p.SetForceLaneChange(a, v != 0.0f); }},
+    {VehicleParameterId::AutoLaneChange, [](Parameters &p, const ActorPtr &a, float v) { p.SetAutoLaneChange(a, v != 0.0f); }},
+    {VehicleParameterId::DistanceToLeadingVehicle, [](Parameters &p, const ActorPtr &a, float v) { p.SetDistanceToLeadingVehicle(a, v); }},
+    {VehicleParameterId::PercentageRunningLight, [](Parameters &p, const ActorPtr &a, float v) { p.SetPercentageRunningLight(a, v); }},
+    {VehicleParameterId::PercentageRunningSign, [](Parameters &p, const ActorPtr &a, float v) { p.SetPercentageRunningSign(a, v); }},
+    {VehicleParameterId::PercentageIgnoreWalkers, [](Parameters &p, const ActorPtr &a, float v) { p.SetPercentageIgnoreWalkers(a, v); }},
+    {VehicleParameterId::PercentageIgnoreVehicles, [](Parameters &p, const ActorPtr &a, float v) { p.SetPercentageIgnoreVehicles(a, v); }},
+    {VehicleParameterId::KeepRightPercentage, [](Parameters &p, const ActorPtr &a, float v) { p.SetKeepRightPercentage(a, v); }},
+    {VehicleParameterId::RandomLeftLaneChangePercentage, [](Parameters &p, const ActorPtr &a, float v) { p.SetRandomLeftLaneChangePercentage(a, v); }},
+    {VehicleParameterId::RandomRightLaneChangePercentage, [](Parameters &p, const ActorPtr &a, float v) { p.SetRandomRightLaneChangePercentage(a, v); }},
+  };
+  const auto vehicle = MakeActor(1u);
+  const auto other = MakeActor(2u);
+  for (const auto &setter : setters) {
+    // values out of range in both directions
+    for (const float value : {-50.0f, 0.0f, 1.0f, 50.0f, 150.0f}) {
+      Parameters parameters;
+      setter.second(parameters, vehicle, value);
+      parameters.SetVehicleParameters({{2u, setter.first, value}});
+      parameters.UpdateTable({1u, 2u});
+      SCOPED_TRACE("parameter " + std::to_string(static_cast<int>(setter.first)) +
+                   ", value " + std::to_string(value));
+      ExpectSameParameters(parameters.GetVehicleParameters(0u), parameters.GetVehicleParameters(1u));
+    }
+  }
+
+  // the speed difference and the desired speed exclude each other, also
+  // within a batch
+  Parameters parameters;
+  parameters.SetPercentageSpeedDifference(vehicle, 20.0f);
+  parameters.SetDesiredSpeed(vehicle, 15.0f);
+  parameters.SetDesiredSpeed(other, 15.0f);
+  parameters.SetPercentageSpeedDifference(other, 20.0f);
+  parameters.SetVehicleParameters({
+      {3u, VehicleParameterId::PercentageSpeedDifference, 20.0f},
+      {3u, VehicleParameterId::DesiredSpeed, 15.0f},
+      {4u, VehicleParameterId::DesiredSpeed, 15.0f},
+      {4u, VehicleParameterId::PercentageSpeedDifference, 20.0f}});
+  parameters.UpdateTable({1u, 2u, 3u, 4u});
+  ExpectSameParameters(parameters.GetVehicleParameters(0u), parameters.GetVehicleParameters(2u));
+  ExpectSameParameters(parameters.GetVehicleParameters(1u), parameters.GetVehicleParameters(3u));
+  ASSERT_FLOAT_EQ(parameters.GetVehicleParameters(2u).GetTargetVelocity(50.0f), 15.0f);
+  ASSERT_FLOAT_EQ(parameters.GetVehicleParameters(3u).GetTargetVelocity(50.0f), 40.0f);
+}
+
+TEST(traffic_manager_parameters, bulk_update_lands_in_one_table) {
+  constexpr ActorId number_of_vehicles = 2000u;
+  constexpr int number_of_batches = 50;
+  std::vector<ActorId> vehicle_ids;
+  for (ActorId id = 1u; id <= number_of_vehicles; ++id) {
+    vehicle_ids.push_back(id);
+  }
+
+  Parameters parameters;
+  std::atomic_bool done{false};
+  carla::ThreadGroup threads;
+  threads.CreateThread([&]() {
+    for (int batch = 1; batch <= number_of_batches; ++batch) {
+      std::vector<VehicleParameterUpdate> updates;
+      for (const ActorId id : vehicle_ids) {
+        updates.push_back({id, VehicleParameterId::LaneOffset, static_cast<float>(batch)});
+      }
+      parameters.SetVehicleParameters(updates);
+    }
+    done = true;
+  });
+
+  // every table the traffic manager builds has either all the values of a
+  // batch or none of them
+  bool finished = false;
+  while (!finished) {
+    finished = done;
+    parameters.UpdateTable(vehicle_ids);
+    const float first = parameters.GetVehicleParameters(0u).lane_offset;
+    for (auto index = 1u; index < number_of_vehicles; ++index) {
+      ASSERT_EQ(parameters.GetVehicleParameters(index).lane_offset, first);
+    }
+  }
+  threads.JoinAll();
+  ASSERT_EQ(parameters.GetVehicleParameters(0u).lane_offset, static_cast<float>(number_of_batches));
+}
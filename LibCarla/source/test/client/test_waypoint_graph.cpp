@@ -0,0 +1,235 @@
+// Copyright (c) 2023 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "test.h"
+#include "OpenDrive.h"
+
+#include <carla/client/Map.h>
+#include <carla/trafficmanager/InMemoryMap.h>
+#include <carla/trafficmanager/SpatialTree.h>
+#include <carla/trafficmanager/WaypointBuffer.h>
+#include <carla/trafficmanager/WaypointGraph.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+using namespace carla::traffic_manager;
+
+static std::vector<WaypointIndex> ToVector(const WaypointIndexRange &range) {
+  return {range.begin(), range.end()};
+}
+
+static std::vector<WaypointIndex> ToVector(const WaypointBuffer &buffer) {
+  return {buffer.begin(), buffer.end()};
+}
+
+TEST(waypoint_graph, matches_open_drive_waypoints) {
+  for (const auto &file : util::OpenDrive::GetAvailableFiles()) {
+    carla::logging::log("Building the waypoint graph of", file);
+    auto map = carla::MakeShared<carla::client::Map>(file, util::OpenDrive::Load(file));
+    InMemoryMap local_map(map);
+    local_map.SetUp();
+
+    const WaypointGraph &graph = local_map.GetWaypointGraph();
+    ASSERT_GT(graph.Size(), 0u);
+    ASSERT_GT(graph.GetMemoryUsage(), 0u);
+
+    for (WaypointIndex index = 0u; index < graph.Size(); ++index) {
+      const WaypointRecord &record = graph.GetRecord(index);
+      const WaypointPtr waypoint = local_map.GetOpenDriveWaypoint(index);
+      ASSERT_NE(waypoint, nullptr);
+      ASSERT_EQ(record.id, waypoint->GetId());
+      ASSERT_EQ(record.location, waypoint->GetTransform().location);
+      ASSERT_EQ(record.road_id, waypoint->GetRoadId());
+      ASSERT_EQ(record.section_id, waypoint->GetSectionId());
+      ASSERT_EQ(record.lane_id, waypoint->GetLaneId());
+      ASSERT_EQ(record.junction_id, waypoint->GetJunctionId());
+      ASSERT_EQ(record.s, waypoint->GetDistance());
+
+      ASSERT_TRUE(record.left == INVALID_WAYPOINT_INDEX || record.left < graph.Size());
+      ASSERT_TRUE(record.right == INVALID_WAYPOINT_INDEX || record.right < graph.Size());
+      for (const WaypointIndex next : graph.GetNext(index)) {
+        ASSERT_LT(next, graph.Size());
+      }
+      for (const WaypointIndex previous : graph.GetPrevious(index)) {
+        ASSERT_LT(previous, graph.Size());
+      }
+
+      const WaypointIndex closest = local_map.GetWaypoint(record.location);
+      ASSERT_NE(closest, INVALID_WAYPOINT_INDEX);
+      ASSERT_EQ(graph.GetLocation(closest), record.location);
+    }
+  }
+}
+
+TEST(waypoint_graph, build_from_topology) {
+  const auto files = util::OpenDrive::GetAvailableFiles();
+  ASSERT_FALSE(files.empty());
+  auto map = carla::MakeShared<carla::client::Map>(files.front(), util::OpenDrive::Load(files.front()));
+  const auto waypoints = map->GenerateWaypoints(5.0);
+  ASSERT_GE(waypoints.size(), 3u);
+
+  // a -> b, with c to one side of b.
+  const auto heading = waypoints[1]->GetTransform().GetForwardVector();
+  WaypointPtr lateral;
+  for (const auto &waypoint : waypoints) {
+    const auto relative = waypoints[1]->GetTransform().location - waypoint->GetTransform().location;
+    if (std::abs(heading.x * relative.y - heading.y * relative.x) > 1.0f) {
+      lateral = waypoint;
+      break;
+    }
+  }
+  ASSERT_NE(lateral, nullptr);
+  NodeList topology = {
+    std::make_shared<SimpleWaypoint>(waypoints[0]),
+    std::make_shared<SimpleWaypoint>(waypoints[1]),
+    std::make_shared<SimpleWaypoint>(lateral)};
+  topology[0]->SetNextWaypoint({topology[1]});
+  topology[1]->SetPreviousWaypoint({topology[0]});
+  topology[1]->SetLeftWaypoint(topology[2]);
+  topology[1]->SetRightWaypoint(topology[2]);
+  topology[2]->SetRoadOption(RoadOption::ChangeLaneLeft);
+
+  WaypointGraph graph;
+  graph.Build(topology);
+  ASSERT_EQ(graph.Size(), 3u);
+  for (WaypointIndex index = 0u; index < 3u; ++index) {
+    ASSERT_EQ(topology[index]->GetGraphIndex(), index);
+    ASSERT_EQ(graph.GetRecord(index).id, topology[index]->GetId());
+  }
+  ASSERT_EQ(ToVector(graph.GetNext(0u)), std::vector<WaypointIndex>({1u}));
+  ASSERT_EQ(ToVector(graph.GetPrevious(1u)), std::vector<WaypointIndex>({0u}));
+  ASSERT_TRUE(graph.GetPrevious(0u).empty());
+  ASSERT_TRUE(graph.GetNext(1u).empty());
+  ASSERT_TRUE(graph.GetNext(2u).empty());
+  // The lane change link is only kept on the side c is at.
+  const WaypointRecord &record = graph.GetRecord(1u);
+  ASSERT_TRUE((record.left == 2u) != (record.right == 2u));
+  ASSERT_EQ(record.left == 2u ? record.right : record.left, INVALID_WAYPOINT_INDEX);
+  ASSERT_EQ(graph.GetRecord(2u).road_option, RoadOption::ChangeLaneLeft);
+
+  for (const SimpleWaypointPtr &waypoint : topology) {
+    waypoint->ClearLinks();
+    ASSERT_TRUE(waypoint->GetNextWaypoint().empty());
+    ASSERT_TRUE(waypoint->GetPreviousWaypoint().empty());
+    ASSERT_EQ(waypoint->GetLeftWaypoint(), nullptr);
+    ASSERT_EQ(waypoint->GetRightWaypoint(), nullptr);
+  }
+
+  graph.Clear();
+  ASSERT_EQ(graph.Size(), 0u);
+}
+
+TEST(waypoint_graph, buffer_wraps_around_and_grows) {
+  WaypointBuffer buffer;
+  ASSERT_TRUE(buffer.empty());
+
+  // Follow a path longer than the capacity, keeping a window of 10.
+  std::vector<WaypointIndex> expected;
+  for (WaypointIndex index = 0u; index < 100u; ++index) {
+    buffer.push_back(index);
+    expected.push_back(index);
+    if (buffer.size() > 10u) {
+      buffer.pop_front();
+      expected.erase(expected.begin());
+    }
+    ASSERT_EQ(ToVector(buffer), expected);
+    ASSERT_EQ(buffer.front(), expected.front());
+    ASSERT_EQ(buffer.back(), expected.back());
+  }
+  ASSERT_EQ(buffer.capacity(), 16u);
+
+  // Growing with the head in the middle of the storage keeps the order.
+  for (WaypointIndex index = 100u; index < 140u; ++index) {
+    buffer.push_back(index);
+    expected.push_back(index);
+  }
+  ASSERT_EQ(ToVector(buffer), expected);
+  ASSERT_EQ(buffer.capacity(), 64u);
+
+  buffer.pop_back();
+  expected.pop_back();
+  ASSERT_EQ(ToVector(buffer), expected);
+  for (size_t i = 0u; i < expected.size(); ++i) {
+    ASSERT_EQ(buffer[i], expected[i]);
+  }
+
+  buffer.clear();
+  ASSERT_TRUE(buffer.empty());
+  ASSERT_EQ(buffer.capacity(), 64u);
+}
+
+TEST(waypoint_graph, spatial_tree_matches_brute_force) {
+  std::mt19937 engine(42u);
+  std::uniform_real_distribution<float> coordinate(-500.0f, 500.0f);
+  auto random_location = [&]() {
+    return carla::geom::Location(coordinate(engine), coordinate(engine), coordinate(engine) * 0.01f);
+  };
+
+  std::vector<SpatialTreeItem> items;
+  for (WaypointIndex index = 0u; index < 5000u; ++index) {
+    items.push_back({random_location(), index});
+  }
+  SpatialTree tree;
+  tree.Build(items);
+  ASSERT_EQ(tree.GetItems().size(), items.size());
+  ASSERT_GT(tree.GetLeafCount(), 1u);
+
+  // A tree attached to the same nodes gives the same answers.
+  SpatialTree attached;
+  ASSERT_TRUE(attached.Attach(tree.GetNodes().data(), tree.GetNodes().size(), tree.GetLeafCount(),
+                              tree.GetItems().data(), tree.GetItems().size()));
+
+  for (size_t i = 0u; i < 200u; ++i) {
+    const carla::geom::Location location = random_location();
+    float closest = std::numeric_limits<float>::max();
+    for (const SpatialTreeItem &item : items) {
+      closest = std::min(closest, carla::geom::Math::DistanceSquared(item.location, location));
+    }
+    const WaypointIndex nearest = tree.Nearest(location);
+    ASSERT_EQ(carla::geom::Math::DistanceSquared(items[nearest].location, location), closest);
+    ASSERT_EQ(attached.Nearest(location), nearest);
+
+    const carla::geom::Location lower(location.x - 50.0f, location.y - 50.0f, location.z - 1.0f);
+    const carla::geom::Location upper(location.x + 50.0f, location.y + 50.0f, location.z + 1.0f);
+    std::vector<WaypointIndex> expected;
+    for (const SpatialTreeItem &item : items) {
+      const carla::geom::Location &l = item.location;
+      if (l.x > lower.x && l.x < upper.x && l.y > lower.y && l.y < upper.y && l.z > lower.z && l.z < upper.z) {
+        expected.push_back(item.index);
+      }
+    }
+    std::vector<WaypointIndex> found;
+    tree.Query(lower, upper, [&](const SpatialTreeItem &item) {
+      found.push_back(item.index);
+      return true;
+    });
+    std::sort(found.begin(), found.end());
+    ASSERT_EQ(found, expected);
+
+    // Stops as soon as the callback returns false.
+    size_t visited = 0u;
+    attached.Query(lower, upper, [&](const SpatialTreeItem &) {
+      ++visited;
+      return false;
+    });
+    ASSERT_EQ(visited, std::min<size_t>(expected.size(), 1u));
+  }
+
+  // Children must come before their parent.
+  std::vector<SpatialTreeNode> nodes(tree.GetNodes().begin(), tree.GetNodes().end());
+  nodes.back().first = static_cast<uint32_t>(nodes.size() - 1u);
+  ASSERT_FALSE(attached.Attach(nodes.data(), nodes.size(), tree.GetLeafCount(),
+                               tree.GetItems().data(), tree.GetItems().size()));
+  ASSERT_EQ(attached.Nearest(random_location()), INVALID_WAYPOINT_INDEX);
+
+  SpatialTree empty;
+  empty.Build({});
+  ASSERT_EQ(empty.Nearest(random_location()), INVALID_WAYPOINT_INDEX);
+}
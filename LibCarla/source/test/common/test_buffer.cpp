@@ -10,6 +10,7 @@
 #include <carla/BufferPool.h>
 
 #include <array>
+#include <cstring>
 #include <list>
 #include <set>
 #include <string>
@@ -134,3 +135,89 @@ TEST(buffer, buffer_pool) {
   // Now delete the pool to test the weak reference inside the buffers.
   pool.reset();
 }
+
+TEST(buffer, buffer_pool_size_classes) {
+  constexpr size_t small_size = 4u * 1024u;
+  constexpr size_t big_size = 4u * 1024u * 1024u;
+  auto pool = std::make_shared<carla::BufferPool>();
+  {
+    auto big = pool->Pop(big_size);
+    ASSERT_EQ(big.size(), big_size);
+  }
+  {
+    // The big buffer must not be handed to a small message.
+    auto small = pool->Pop(small_size);
+    ASSERT_EQ(small.size(), small_size);
+    ASSERT_LT(small.capacity(), big_size);
+  }
+  auto big = pool->Pop(big_size - 1024u);
+  ASSERT_EQ(big.size(), big_size - 1024u);
+  ASSERT_GE(big.capacity(), big_size);
+  const auto statistics = pool->GetStatistics();
+  ASSERT_EQ(statistics.hits, 1u);
+  ASSERT_EQ(statistics.misses, 2u);
+}
+
+TEST(buffer, buffer_pool_high_water_mark) {
+  constexpr size_t size = 64u * 1024u;
+  auto pool = std::make_shared<carla::BufferPool>("", 2u * size);
+  {
+    std::vector<carla::Buffer> buffers;
+    for (auto i = 0u; i < 4u; ++i) {
+      buffers.emplace_back(pool->Pop(size));
+    }
+  }
+  auto statistics = pool->GetStatistics();
+  ASSERT_EQ(statistics.bytes_retained, 2u * size);
+  ASSERT_EQ(statistics.max_bytes_retained, 2u * size);
+  ASSERT_EQ(statistics.bytes_trimmed, 2u * size);
+  pool->Trim(size);
+  statistics = pool->GetStatistics();
+  ASSERT_EQ(statistics.bytes_retained, size);
+  ASSERT_EQ(statistics.bytes_trimmed, 3u * size);
+  pool->Trim();
+  ASSERT_EQ(pool->GetStatistics().bytes_retained, 0u);
+}
+
+TEST(buffer, buffer_pool_small_buffers) {
+  auto pool = std::make_shared<carla::BufferPool>();
+  const std::vector<size_t> sizes = {100u, 500u, 20u, 1000u, 300u, 1u};
+  // Warm up with two buffers in use at a time.
+  for (auto i = 0u; i < sizes.size(); ++i) {
+    auto first = pool->Pop(sizes[i]);
+    auto second = pool->Pop(sizes[(i + 1u) % sizes.size()]);
+    ASSERT_EQ(first.size(), sizes[i]);
+    ASSERT_GE(first.capacity(), 1024u);
+  }
+  const auto warm = pool->GetStatistics();
+  ASSERT_EQ(warm.misses, 2u);
+
+  // Any small buffer serves any small pop, the pool does not grow.
+  for (auto round = 0u; round < 100u; ++round) {
+    for (auto i = 0u; i < sizes.size(); ++i) {
+      auto first = pool->Pop(sizes[i]);
+      auto second = pool->Pop(sizes[(i + 1u) % sizes.size()]);
+      ASSERT_EQ(first.size(), sizes[i]);
+      ASSERT_EQ(second.size(), sizes[(i + 1u) % sizes.size()]);
+    }
+  }
+  const auto statistics = pool->GetStatistics();
+  ASSERT_EQ(statistics.misses, warm.misses);
+  ASSERT_EQ(statistics.bytes_retained, warm.bytes_retained);
+  ASSERT_EQ(statistics.bytes_trimmed, 0u);
+}
+
+TEST(buffer, buffer_pool_huge_pages) {
+  constexpr size_t size = 3u * carla::BufferPool::huge_page_size;
+  auto pool = std::make_shared<carla::BufferPool>();
+  pool->SetHugePages(true);
+  for (auto i = 0u; i < 2u; ++i) {
+    auto buffer = pool->Pop(size);
+    ASSERT_EQ(buffer.size(), size);
+    std::memset(buffer.data(), static_cast<int>(i), size);
+    ASSERT_EQ(buffer[size - 1u], i);
+  }
+  const auto statistics = pool->GetStatistics();
+  ASSERT_EQ(statistics.hits, 1u);
+  ASSERT_EQ(statistics.misses, 1u);
+}
@@ -6,8 +6,63 @@
 
 #include "test.h"
 
+#include <carla/ThreadPool.h>
 #include <carla/Version.h>
 
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
 TEST(miscellaneous, version) {
   std::cout << "LibCarla " << carla::version() << std::endl;
 }
+
+TEST(miscellaneous, thread_pool_parallel_for) {
+  carla::ThreadPool pool;
+  pool.AsyncRun(3u);
+  for (const size_t grain_size : {1u, 7u, 100u, 5000u}) {
+    std::vector<std::atomic_int> visited(1000u);
+    pool.ParallelFor(visited.size(), grain_size, [&](size_t begin, size_t end) {
+      ASSERT_LE(end - begin, grain_size);
+      for (auto i = begin; i < end; ++i) {
+        ++visited[i];
+      }
+    });
+    for (const auto &count : visited) {
+      ASSERT_EQ(count, 1);
+    }
+  }
+  size_t calls = 0u;
+  pool.ParallelFor(0u, 10u, [&](size_t, size_t) { ++calls; });
+  ASSERT_EQ(calls, 0u);
+}
+
+TEST(miscellaneous, thread_pool_nested_parallel_for) {
+  // Every thread of the pool waits for an inner loop, the callers run the
+  // inner ranges themselves.
+  carla::ThreadPool pool;
+  pool.AsyncRun(2u);
+  std::atomic_size_t total{0u};
+  pool.ParallelFor(8u, 1u, [&](size_t, size_t) {
+    pool.ParallelFor(100u, 10u, [&](size_t begin, size_t end) {
+      total += end - begin;
+    });
+  });
+  ASSERT_EQ(total, 800u);
+}
+
+#ifndef LIBCARLA_NO_EXCEPTIONS
+TEST(miscellaneous, thread_pool_parallel_for_exception) {
+  carla::ThreadPool pool;
+  pool.AsyncRun(2u);
+  std::atomic_size_t done{0u};
+  ASSERT_THROW(pool.ParallelFor(100u, 1u, [&](size_t begin, size_t) {
+    if (begin == 42u) {
+      throw std::runtime_error("task failed");
+    }
+    ++done;
+  }), std::runtime_error);
+  // The other ranges still run before the exception is rethrown.
+  ASSERT_EQ(done, 99u);
+}
+#endif // LIBCARLA_NO_EXCEPTIONS
@@ -8,7 +8,9 @@
 
 #include <carla/MsgPackAdaptors.h>
 #include <carla/rpc/Actor.h>
+#include <carla/rpc/ActorColumns.h>
 #include <carla/rpc/Response.h>
+#include <carla/trafficmanager/VehicleParameterUpdate.h>
 
 #include <thread>
 
@@ -105,3 +107,48 @@ TEST(msgpack, optional) {
   ASSERT_TRUE(result.has_value());
   ASSERT_EQ(*result, 42.0f);
 }
+
+TEST(msgpack, actor_columns) {
+  using mp = carla::MsgPack;
+  namespace cg = carla::geom;
+
+  ActorColumns columns;
+  columns.ids = {3u, 7u};
+  columns.vehicle_light_state = {0x1u, 0x3u};
+  columns.vehicle_physics.resize(2u);
+  columns.vehicle_physics[1u].mass = 1500.0f;
+  columns.vehicle_physics[1u].center_of_mass = cg::Location(0.1f, 0.0f, -0.5f);
+  columns.bone_count = {0u, 2u};
+  columns.bone_transforms = {
+      cg::Transform{cg::Location(1.0f, 2.0f, 3.0f)},
+      cg::Transform{cg::Location(4.0f, 5.0f, 6.0f), cg::Rotation(10.0f, 20.0f, 30.0f)}};
+  // Only the columns of the server are sent.
+  columns.speed_limit = {30.0f, 50.0f};
+
+  auto result = mp::UnPack<ActorColumns>(mp::Pack(columns));
+  ASSERT_EQ(result.ids, columns.ids);
+  ASSERT_EQ(result.vehicle_light_state, columns.vehicle_light_state);
+  ASSERT_EQ(result.vehicle_physics.size(), 2u);
+  ASSERT_EQ(result.vehicle_physics[1u].mass, 1500.0f);
+  ASSERT_EQ(result.vehicle_physics[1u].center_of_mass, columns.vehicle_physics[1u].center_of_mass);
+  ASSERT_EQ(result.bone_count, columns.bone_count);
+  ASSERT_EQ(result.bone_transforms, columns.bone_transforms);
+  ASSERT_TRUE(result.speed_limit.empty());
+}
+
+TEST(msgpack, vehicle_parameter_updates) {
+  using mp = carla::MsgPack;
+  using carla::traffic_manager::VehicleParameterId;
+  using carla::traffic_manager::VehicleParameterUpdate;
+
+  std::vector<VehicleParameterUpdate> updates = {
+      {42u, VehicleParameterId::DesiredSpeed, 12.5f},
+      {43u, VehicleParameterId::RandomRightLaneChangePercentage, 30.0f}};
+  auto result = mp::UnPack<std::vector<VehicleParameterUpdate>>(mp::Pack(updates));
+  ASSERT_EQ(result.size(), updates.size());
+  for (auto i = 0u; i < updates.size(); ++i) {
+    ASSERT_EQ(result[i].actor_id, updates[i].actor_id);
+    ASSERT_EQ(result[i].parameter, updates[i].parameter);
+    ASSERT_EQ(result[i].value, updates[i].value);
+  }
+}
@@ -10,12 +10,18 @@
 #include <carla/streaming/Client.h>
 #include <carla/streaming/Server.h>
 #include <carla/streaming/detail/Dispatcher.h>
+#include <carla/streaming/detail/SharedMemoryRing.h>
 #include <carla/streaming/detail/tcp/Client.h>
+#include <carla/streaming/detail/tcp/SendQueue.h>
 #include <carla/streaming/detail/tcp/Server.h>
+#include <carla/streaming/detail/tcp/ServerSession.h>
 #include <carla/streaming/low_level/Client.h>
 #include <carla/streaming/low_level/Server.h>
 
+#include <algorithm>
 #include <atomic>
+#include <memory>
+#include <vector>
 
 using namespace std::chrono_literals;
 
@@ -277,3 +283,174 @@ TEST(streaming, multi_stream) {
     }
   }
 }
+
+TEST(streaming, shared_memory) {
+  using namespace carla::streaming;
+  constexpr size_t number_of_messages = 200u;
+
+  Server srv(TESTING_PORT);
+  srv.SetSynchronousMode(true);
+  // Small enough for the messages to wrap around and fill the ring.
+  srv.SetSharedMemoryCapacity(64u * 1024u);
+  srv.AsyncRun(2u);
+  auto stream = srv.MakeStream();
+  if (!carla::streaming::detail::SharedMemoryRing::IsSupported()) {
+    return;
+  }
+  ASSERT_TRUE(detail::token_type(stream.token()).has_shared_memory());
+
+  std::atomic_size_t messages_received{0u};
+  Client c;
+  c.AsyncRun(2u);
+  c.Subscribe(stream.token(), [&](carla::Buffer buffer) {
+    const size_t index = messages_received++;
+    ASSERT_EQ(buffer.size(), 1u + (index * 997u) % 20000u);
+    ASSERT_TRUE(std::all_of(buffer.begin(), buffer.end(), [=](auto byte) {
+      return byte == static_cast<unsigned char>(index);
+    }));
+  });
+
+  while (!stream.AreClientsListening()) {
+    std::this_thread::sleep_for(1ms);
+  }
+  for (auto i = 0u; i < number_of_messages; ++i) {
+    carla::Buffer buffer(1u + (i * 997u) % 20000u);
+    std::fill(buffer.begin(), buffer.end(), static_cast<unsigned char>(i));
+    stream.Write(carla::BufferView::CreateFrom(std::move(buffer)));
+  }
+  for (auto i = 0u; (i < 1000u) && (messages_received < number_of_messages); ++i) {
+    std::this_thread::sleep_for(1ms);
+  }
+  ASSERT_EQ(messages_received, number_of_messages);
+  ASSERT_EQ(stream.GetStatistics().messages_dropped, 0u);
+}
+
+TEST(streaming, send_queue_policies) {
+  using namespace carla::streaming::detail::tcp;
+  using Policy = SendQueuePolicy;
+  constexpr size_t capacity = 4u;
+  const auto timeout = carla::time_duration::milliseconds(10);
+  auto make_message = []() {
+    return ServerSession::MakeMessage(
+        carla::BufferView::CreateFrom(carla::Buffer{std::string("message")}));
+  };
+  std::vector<SendQueue::value_type> batch;
+
+  {
+    SendQueue queue;
+    ASSERT_TRUE(queue.Push(make_message(), Policy::LatestOnly, capacity, timeout));
+    for (auto i = 0u; i < 9u; ++i) {
+      ASSERT_FALSE(queue.Push(make_message(), Policy::LatestOnly, capacity, timeout));
+    }
+    ASSERT_TRUE(queue.Pop(batch, capacity));
+    ASSERT_EQ(batch.size(), 1u);
+    ASSERT_FALSE(queue.Pop(batch, capacity));
+    auto statistics = queue.GetStatistics();
+    ASSERT_EQ(statistics.messages_sent, 1u);
+    ASSERT_EQ(statistics.messages_dropped, 9u);
+  }
+
+  {
+    SendQueue queue;
+    ASSERT_TRUE(queue.Push(make_message(), Policy::DropOldest, capacity, timeout));
+    for (auto i = 0u; i < 9u; ++i) {
+      ASSERT_FALSE(queue.Push(make_message(), Policy::DropOldest, capacity, timeout));
+    }
+    ASSERT_EQ(queue.GetStatistics().queue_depth, capacity);
+    ASSERT_TRUE(queue.Pop(batch, capacity));
+    ASSERT_EQ(batch.size(), capacity);
+    ASSERT_EQ(queue.GetStatistics().messages_dropped, 10u - capacity);
+  }
+
+  {
+    SendQueue queue;
+    ASSERT_TRUE(queue.Push(make_message(), Policy::Block, capacity, timeout));
+    for (auto i = 1u; i < capacity; ++i) {
+      ASSERT_FALSE(queue.Push(make_message(), Policy::Block, capacity, timeout));
+    }
+    std::atomic_bool pushed{false};
+    carla::ThreadGroup threads;
+    threads.CreateThread([&]() {
+      queue.Push(make_message(), Policy::Block, capacity, carla::time_duration::seconds(10));
+      pushed = true;
+    });
+    std::this_thread::sleep_for(20ms);
+    ASSERT_FALSE(pushed);
+    ASSERT_TRUE(queue.Pop(batch, 1u));
+    threads.JoinAll();
+    ASSERT_TRUE(pushed);
+    auto statistics = queue.GetStatistics();
+    ASSERT_EQ(statistics.messages_dropped, 0u);
+    ASSERT_EQ(statistics.queue_depth, capacity);
+  }
+  {
+    // A deadline already met does not wait, the oldest message is dropped.
+    SendQueue queue;
+    for (auto i = 0u; i < capacity; ++i) {
+      queue.Push(make_message(), Policy::Block, capacity, timeout);
+    }
+    const auto start = SendQueue::clock_type::now();
+    ASSERT_FALSE(queue.Push(make_message(), Policy::Block, capacity, start));
+    ASSERT_LT(SendQueue::clock_type::now() - start, 1s);
+    ASSERT_EQ(queue.GetStatistics().messages_dropped, 1u);
+    ASSERT_EQ(queue.GetStatistics().queue_depth, capacity);
+  }
+}
+
+TEST(streaming, stream_send_queue_policy) {
+  using namespace carla::streaming;
+  constexpr size_t number_of_messages = 200u;
+  constexpr size_t number_of_clients = 3u;
+
+  // Asynchronous mode keeps only the latest message by default, this stream
+  // overrides it to deliver every message.
+  Server srv(TESTING_PORT);
+  srv.AsyncRun(2u);
+  auto stream = srv.MakeStream();
+  stream.SetSendQueuePolicy(detail::tcp::SendQueuePolicy::Block);
+
+  std::vector<std::atomic_size_t> messages_received(number_of_clients);
+  std::vector<std::unique_ptr<Client>> clients;
+  for (auto i = 0u; i < number_of_clients; ++i) {
+    messages_received[i] = 0u;
+    clients.emplace_back(std::make_unique<Client>());
+    clients.back()->AsyncRun(1u);
+    clients.back()->Subscribe(stream.token(), [&messages_received, i](carla::Buffer) {
+      ++messages_received[i];
+    });
+  }
+
+  // Wait for every client to be subscribed.
+  auto all_received = [&]() {
+    return std::all_of(messages_received.begin(), messages_received.end(), [](auto &received) {
+      return received > 0u;
+    });
+  };
+  for (auto i = 0u; (i < 1000u) && !all_received(); ++i) {
+    stream.Write(carla::BufferView::CreateFrom(carla::Buffer{std::string("warm up")}));
+    std::this_thread::sleep_for(1ms);
+  }
+  ASSERT_TRUE(all_received());
+  std::this_thread::sleep_for(20ms);
+  const auto sent_before = stream.GetStatistics().messages_sent;
+  std::vector<size_t> received_before;
+  for (auto &received : messages_received) {
+    received_before.emplace_back(received);
+  }
+  const auto dropped_before = stream.GetStatistics().messages_dropped;
+
+  for (auto i = 0u; i < number_of_messages; ++i) {
+    stream.Write(carla::BufferView::CreateFrom(carla::Buffer{std::string(1000u, 'x')}));
+  }
+  for (auto i = 0u; i < 1000u; ++i) {
+    if (stream.GetStatistics().messages_sent - sent_before == number_of_clients * number_of_messages) {
+      break;
+    }
+    std::this_thread::sleep_for(1ms);
+  }
+  ASSERT_EQ(stream.GetStatistics().messages_dropped, dropped_before);
+  std::this_thread::sleep_for(20ms);
+  for (auto i = 0u; i < number_of_clients; ++i) {
+    ASSERT_EQ(messages_received[i] - received_before[i], number_of_messages);
+  }
+}
@@ -30,13 +30,19 @@ static auto make_special_message(size_t size) {
 class Benchmark {
 public:
 
-  Benchmark(uint16_t port, size_t message_size, double success_ratio)
+  Benchmark(
+      uint16_t port,
+      size_t message_size,
+      double success_ratio,
+      size_t shared_memory_capacity = 0u)
     : _server(port),
       _client(),
       _message(make_special_message(message_size)),
       _client_callback(),
       _work_to_do(_client_callback),
-      _success_ratio(success_ratio) {}
+      _success_ratio(success_ratio) {
+    _server.SetSharedMemoryCapacity(shared_memory_capacity);
+  }
 
   void AddStream() {
     Stream stream = _server.MakeStream();
@@ -136,10 +142,11 @@ static size_t get_max_concurrency() {
 static void benchmark_image(
     const size_t dimensions,
     const size_t number_of_streams = 1u,
-    const double success_ratio = 1.0) {
+    const double success_ratio = 1.0,
+    const size_t shared_memory_capacity = 0u) {
   constexpr auto number_of_messages = 100u;
   carla::logging::log("Benchmark:", number_of_streams, "streams at 90FPS.");
-  Benchmark benchmark(TESTING_PORT, 4u * dimensions, success_ratio);
+  Benchmark benchmark(TESTING_PORT, 4u * dimensions, success_ratio, shared_memory_capacity);
   benchmark.AddStreams(number_of_streams);
   benchmark.Run(number_of_messages);
 }
@@ -167,3 +174,11 @@ TEST(benchmark_streaming, image_800x600_mt) {
 TEST(benchmark_streaming, image_1920x1080_mt) {
   benchmark_image(1920u * 1080u, get_max_concurrency(), 0.9);
 }
+
+TEST(benchmark_streaming, image_1920x1080_shared_memory) {
+  benchmark_image(1920u * 1080u, 1u, 0.9, 64u * 1024u * 1024u);
+}
+
+TEST(benchmark_streaming, image_1920x1080_shared_memory_mt) {
+  benchmark_image(1920u * 1080u, get_max_concurrency(), 0.9, 64u * 1024u * 1024u);
+}
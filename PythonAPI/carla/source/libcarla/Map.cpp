@@ -13,8 +13,12 @@
 #include <carla/client/Landmark.h>
 #include <carla/road/SignalType.h>
 
-#include <ostream>
+#include <cstdint>
 #include <fstream>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
 
 namespace carla {
 namespace client {
@@ -72,6 +76,102 @@ static auto GetLaneValidities(const carla::client::Landmark &self){
   return result;
 }
 
+/// Layout of each element of the buffer returned by Map.project_locations,
+/// matches the numpy dtype documented in the Python API reference.
+struct ProjectedLocation {
+  uint32_t road_id;
+  int32_t lane_id;
+  float s;
+  float x, y, z;
+  float pitch, yaw, roll;
+  float lane_width;
+};
+
+static_assert(sizeof(ProjectedLocation) == 40u, "Unexpected padding.");
+
+template <typename T>
+static void ReadLocations(const char *data, size_t count, std::vector<carla::geom::Location> &result) {
+  const auto *values = reinterpret_cast<const T *>(data);
+  result.reserve(count);
+  for (auto i = 0u; i < count; ++i) {
+    result.emplace_back(
+        static_cast<float>(values[3u * i]),
+        static_cast<float>(values[3u * i + 1u]),
+        static_cast<float>(values[3u * i + 2u]));
+  }
+}
+
+/// Accepts either an object supporting the buffer protocol holding N x 3
+/// float32 or float64 values, like a numpy array, or an iterable of
+/// carla.Location.
+static std::vector<carla::geom::Location> GetLocations(boost::python::object locations) {
+  namespace py = boost::python;
+  std::vector<carla::geom::Location> result;
+  if (!PyObject_CheckBuffer(locations.ptr())) {
+    py::stl_input_iterator<carla::geom::Location> begin(locations), end;
+    result.assign(begin, end);
+    return result;
+  }
+  Py_buffer view;
+  if (PyObject_GetBuffer(locations.ptr(), &view, PyBUF_FORMAT | PyBUF_C_CONTIGUOUS) != 0) {
+    py::throw_error_already_set();
+  }
+  const std::string format = view.format != nullptr ? view.format : "B";
+  const bool is_float = (format == "f") || (format == "<f") || (format == "=f");
+  const bool is_double = (format == "d") || (format == "<d") || (format == "=d");
+  const bool is_n_by_3 = (view.ndim == 2) && (view.shape != nullptr) && (view.shape[1] == 3);
+  if ((!is_float && !is_double) || !is_n_by_3) {
+    PyBuffer_Release(&view);
+    throw std::invalid_argument("locations must be an array of N x 3 float32 or float64 values");
+  }
+  const auto *data = static_cast<const char *>(view.buf);
+  const auto count = static_cast<size_t>(view.shape[0]);
+  if (is_float) {
+    ReadLocations<float>(data, count, result);
+  } else {
+    ReadLocations<double>(data, count, result);
+  }
+  PyBuffer_Release(&view);
+  return result;
+}
+
+static boost::python::object ProjectLocations(
+    const carla::client::Map &self,
+    boost::python::object locations,
+    bool project_to_road,
+    carla::road::Lane::LaneType lane_type) {
+  const auto input = GetLocations(locations);
+  std::vector<ProjectedLocation> records(input.size());
+  {
+    carla::PythonUtil::ReleaseGIL unlock;
+    const auto projections = self.ProjectLocations(
+        input,
+        project_to_road,
+        static_cast<int32_t>(lane_type));
+    for (auto i = 0u; i < projections.size(); ++i) {
+      const auto &projection = projections[i];
+      auto &record = records[i];
+      if (!projection.is_valid) {
+        // Lane zero is the center lane, never returned for a valid waypoint.
+        record = ProjectedLocation{0u, 0, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f};
+        continue;
+      }
+      const auto &transform = projection.transform;
+      record.road_id = projection.waypoint.road_id;
+      record.lane_id = projection.waypoint.lane_id;
+      record.s = static_cast<float>(projection.waypoint.s);
+      record.x = transform.location.x;
+      record.y = transform.location.y;
+      record.z = transform.location.z;
+      record.pitch = transform.rotation.pitch;
+      record.yaw = transform.rotation.yaw;
+      record.roll = transform.rotation.roll;
+      record.lane_width = static_cast<float>(projection.lane_width);
+    }
+  }
+  return RecordsToBytes(records);
+}
+
 static carla::geom::GeoLocation ToGeolocation(
     const carla::client::Map &self,
     const carla::geom::Location &location) {
@@ -159,7 +259,10 @@ void export_map() {
     .add_property("name", CALL_RETURNING_COPY(cc::Map, GetName))
     .def("get_spawn_points", CALL_RETURNING_LIST(cc::Map, GetRecommendedSpawnPoints))
     .def("get_waypoint", &cc::Map::GetWaypoint, (arg("location"), arg("project_to_road")=true, arg("lane_type")=cr::Lane::LaneType::Driving))
-    .def("get_waypoint_xodr", &cc::Map::GetWaypointXODR, (arg("road_id"), arg("lane_id"), arg("s")))
+    .def("project_locations", &ProjectLocations, (arg("locations"), arg("project_to_road")=true, arg("lane_type")=cr::Lane::LaneType::Driving))
+    .def("get_waypoint_xodr", +[](const cc::Map &self, cr::RoadId road_id, cr::LaneId lane_id, float s) {
+      return self.GetWaypointXODR(road_id, lane_id, s);
+    }, (arg("road_id"), arg("lane_id"), arg("s")))
     .def("get_topology", &GetTopology)
     .def("generate_waypoints", CALL_RETURNING_LIST_1(cc::Map, GenerateWaypoints, double), (args("distance")))
     .def("transform_to_geolocation", &ToGeolocation, (arg("location")))
@@ -0,0 +1,82 @@
+// Copyright (c) 2023 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include <carla/PythonUtil.h>
+#include <carla/recorder/RecorderQuery.h>
+
+#include <boost/python/stl_iterator.hpp>
+
+static boost::python::list GetRecordedActors(const carla::recorder::RecorderQuery &self) {
+  namespace py = boost::python;
+  std::vector<carla::recorder::ActorInfo> actors;
+  {
+    carla::PythonUtil::ReleaseGIL unlock;
+    actors = self.GetActors();
+  }
+  py::list result;
+  for (const auto &actor : actors) {
+    py::dict item;
+    item["id"] = actor.id;
+    item["type_id"] = actor.type_id;
+    item["spawn_time"] = actor.spawn_time;
+    item["destroy_time"] = actor.destroy_time < 0.0 ? py::object() : py::object(actor.destroy_time);
+    result.append(item);
+  }
+  return result;
+}
+
+static boost::python::object GetRecordedTrajectories(
+    const carla::recorder::RecorderQuery &self,
+    boost::python::object actor_ids) {
+  std::vector<uint32_t> ids{
+      boost::python::stl_input_iterator<uint32_t>(actor_ids),
+      boost::python::stl_input_iterator<uint32_t>()};
+  std::vector<carla::recorder::TrajectoryPoint> records;
+  {
+    carla::PythonUtil::ReleaseGIL unlock;
+    records = self.GetTrajectories(ids);
+  }
+  return RecordsToBytes(records);
+}
+
+static boost::python::object GetRecordedCollisions(
+    const carla::recorder::RecorderQuery &self,
+    char category_1,
+    char category_2) {
+  std::vector<carla::recorder::Collision> records;
+  {
+    carla::PythonUtil::ReleaseGIL unlock;
+    records = self.GetCollisions(category_1, category_2);
+  }
+  return RecordsToBytes(records);
+}
+
+static boost::python::object GetRecordedBlockedActors(
+    const carla::recorder::RecorderQuery &self,
+    double min_time,
+    double min_distance) {
+  std::vector<carla::recorder::BlockedActor> records;
+  {
+    carla::PythonUtil::ReleaseGIL unlock;
+    records = self.GetBlockedActors(min_time, min_distance);
+  }
+  return RecordsToBytes(records);
+}
+
+void export_recorder() {
+  using namespace boost::python;
+  namespace crec = carla::recorder;
+
+  class_<crec::RecorderQuery, boost::noncopyable>("RecorderQuery", init<std::string>((arg("filename"))))
+    .add_property("map_name", +[](const crec::RecorderQuery &self) { return self.GetInfo().map_name; })
+    .add_property("version", +[](const crec::RecorderQuery &self) { return self.GetInfo().version; })
+    .add_property("date", +[](const crec::RecorderQuery &self) { return self.GetInfo().date; })
+    .def("get_actors", &GetRecordedActors)
+    .def("get_trajectories", &GetRecordedTrajectories, (arg("actor_ids")=list()))
+    .def("get_collisions", &GetRecordedCollisions, (arg("category1")='a', arg("category2")='a'))
+    .def("get_blocked_actors", &GetRecordedBlockedActors, (arg("min_time")=60.0, arg("min_distance")=1.0))
+  ;
+}
@@ -8,6 +8,7 @@
 #include <memory>
 #include <stdio.h>
 #include "carla/PythonUtil.h"
+#include "boost/python/stl_iterator.hpp"
 #include "boost/python/suite/indexing/vector_indexing_suite.hpp"
 
 #include "carla/trafficmanager/TrafficManager.h"
@@ -78,17 +79,52 @@ boost::python::list InterGetActionBuffer(carla::traffic_manager::TrafficManager&
   return l;
 }
 
+void InterSetVehicleParameters(carla::traffic_manager::TrafficManager& self, boost::python::object updates) {
+  namespace py = boost::python;
+  namespace ctm = carla::traffic_manager;
+  std::vector<ctm::VehicleParameterUpdate> update_list;
+  for (py::stl_input_iterator<py::object> it(updates), end; it != end; ++it) {
+    const py::object item = *it;
+    // The vehicle can be given as an actor or by its id.
+    py::extract<ActorPtr> actor(item[0]);
+    ctm::VehicleParameterUpdate update;
+    update.actor_id = actor.check() ? actor()->GetId() : py::extract<ActorId>(item[0])();
+    update.parameter = py::extract<ctm::VehicleParameterId>(item[1]);
+    update.value = py::extract<float>(item[2]);
+    update_list.emplace_back(update);
+  }
+  carla::PythonUtil::ReleaseGIL unlock;
+  self.SetVehicleParameters(update_list);
+}
 
 void export_trafficmanager() {
   namespace cc = carla::client;
   namespace ctm = carla::traffic_manager;
   using namespace boost::python;
 
+  enum_<ctm::VehicleParameterId>("VehicleParameter")
+    .value("PercentageSpeedDifference", ctm::VehicleParameterId::PercentageSpeedDifference)
+    .value("LaneOffset", ctm::VehicleParameterId::LaneOffset)
+    .value("DesiredSpeed", ctm::VehicleParameterId::DesiredSpeed)
+    .value("UpdateVehicleLights", ctm::VehicleParameterId::UpdateVehicleLights)
+    .value("ForceLaneChange", ctm::VehicleParameterId::ForceLaneChange)
+    .value("AutoLaneChange", ctm::VehicleParameterId::AutoLaneChange)
+    .value("DistanceToLeadingVehicle", ctm::VehicleParameterId::DistanceToLeadingVehicle)
+    .value("IgnoreLightsPercentage", ctm::VehicleParameterId::PercentageRunningLight)
+    .value("IgnoreSignsPercentage", ctm::VehicleParameterId::PercentageRunningSign)
+    .value("IgnoreWalkersPercentage", ctm::VehicleParameterId::PercentageIgnoreWalkers)
+    .value("IgnoreVehiclesPercentage", ctm::VehicleParameterId::PercentageIgnoreVehicles)
+    .value("KeepRightRulePercentage", ctm::VehicleParameterId::KeepRightPercentage)
+    .value("RandomLeftLaneChangePercentage", ctm::VehicleParameterId::RandomLeftLaneChangePercentage)
+    .value("RandomRightLaneChangePercentage", ctm::VehicleParameterId::RandomRightLaneChangePercentage)
+  ;
+
   class_<ctm::TrafficManager>("TrafficManager", no_init)
     .def("get_port", &ctm::TrafficManager::Port)
     .def("vehicle_percentage_speed_difference", &ctm::TrafficManager::SetPercentageSpeedDifference, (arg("actor"), arg("percentage")))
     .def("vehicle_lane_offset", &ctm::TrafficManager::SetLaneOffset, (arg("actor"), arg("offset")))
     .def("set_desired_speed", &ctm::TrafficManager::SetDesiredSpeed, (arg("actor"), arg("speed")))
+    .def("set_vehicle_parameters", &InterSetVehicleParameters, (arg("updates")))
     .def("global_percentage_speed_difference", &ctm::TrafficManager::SetGlobalPercentageSpeedDifference, (arg("percentage")))
     .def("global_lane_offset", &ctm::TrafficManager::SetGlobalLaneOffset, (arg("offset")))
     .def("update_vehicle_lights", &ctm::TrafficManager::SetUpdateVehicleLights, (arg("actor"), arg("do_update")))
@@ -109,6 +145,7 @@ void export_trafficmanager() {
     .def("set_hybrid_physics_radius", &ctm::TrafficManager::SetHybridPhysicsRadius, (arg("r")))
     .def("set_random_device_seed", &ctm::TrafficManager::SetRandomDeviceSeed, (arg("value")))
     .def("set_osm_mode", &carla::traffic_manager::TrafficManager::SetOSMMode, (arg("mode_switch")))
+    .def("set_worker_threads", &ctm::TrafficManager::SetWorkerThreads, (arg("threads")=1))
     .def("set_path", &InterSetCustomPath, (arg("actor"), arg("path"), arg("empty_buffer")=true))
     .def("set_route", &InterSetImportedRoute, (arg("actor"), arg("path"), arg("empty_buffer")=true))
     .def("set_respawn_dormant_vehicles", &carla::traffic_manager::TrafficManager::SetRespawnDormantVehicles, (arg("mode_switch")))
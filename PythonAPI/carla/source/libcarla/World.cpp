@@ -55,6 +55,22 @@ namespace rpc {
 } // namespace rpc
 } // namespace carla
 
+namespace carla {
+namespace nav {
+
+  std::ostream &operator<<(std::ostream &out, const RoutePlannerStatistics &statistics) {
+    out << "RoutePlannerStatistics(queued_requests=" << statistics.queued_requests
+        << ",ready_routes=" << statistics.ready_routes
+        << ",routes_delivered=" << statistics.routes_delivered
+        << ",last_latency=" << statistics.last_latency
+        << ",mean_latency=" << statistics.mean_latency
+        << ",max_latency=" << statistics.max_latency << ')';
+    return out;
+  }
+
+} // namespace nav
+} // namespace carla
+
 static auto WaitForTick(const carla::client::World &world, double seconds) {
   carla::PythonUtil::ReleaseGIL unlock;
   return world.WaitForTick(TimeDurationFromSeconds(seconds));
@@ -82,6 +98,187 @@ static auto GetActorsById(carla::client::World &self, const boost::python::list
   return self.GetActors(ids);
 }
 
+/// A carla::client::Future with the type of its result erased, so a single
+/// Python class can hold the result of any asynchronous call.
+class PythonFuture {
+public:
+
+  template <typename T>
+  explicit PythonFuture(carla::client::Future<T> future) {
+    auto shared = std::make_shared<carla::client::Future<T>>(std::move(future));
+    _wait = [shared](carla::time_duration timeout) {
+      return shared->WaitFor(timeout);
+    };
+    _get = [shared]() {
+      auto result = [&]() {
+        carla::PythonUtil::ReleaseGIL unlock;
+        return shared->Get();
+      }();
+      return boost::python::object(result);
+    };
+  }
+
+  bool Done() const {
+    return _result != boost::none || _exception != nullptr || _wait(carla::time_duration::milliseconds(0u));
+  }
+
+  bool Wait(double seconds) const {
+    // once the result is read the future underneath can't be waited anymore
+    if (_result != boost::none || _exception != nullptr) {
+      return true;
+    }
+    carla::PythonUtil::ReleaseGIL unlock;
+    return _wait(TimeDurationFromSeconds(seconds));
+  }
+
+  /// Blocks until the response arrives. The result, or the error, is kept so
+  /// it can be read again.
+  boost::python::object Result() {
+    if (_result == boost::none && _exception == nullptr) {
+      try {
+        _result = _get();
+      } catch (...) {
+        _exception = std::current_exception();
+      }
+      _get = nullptr;
+    }
+    if (_exception != nullptr) {
+      std::rethrow_exception(_exception);
+    }
+    return *_result;
+  }
+
+  /// Implements the iterator returned by __await__: yields until the response
+  /// arrives, so the event loop can run other tasks meanwhile.
+  boost::python::object Next() {
+    if (!Done()) {
+      return Sleep();
+    }
+    auto result = Result();
+    boost::python::object stop{boost::python::handle<>(
+        PyObject_CallFunctionObjArgs(PyExc_StopIteration, result.ptr(), nullptr))};
+    PyErr_SetObject(PyExc_StopIteration, stop.ptr());
+    boost::python::throw_error_already_set();
+    return boost::python::object();
+  }
+
+private:
+
+  /// The response can't notify the event loop, so the task awaiting it polls.
+  /// Yields an asyncio future resolved after a while, doubling the interval
+  /// every time up to 20 ms, so the task sleeps instead of being scheduled
+  /// again right away. Outside of an asyncio loop it yields None.
+  boost::python::object Sleep() {
+    namespace py = boost::python;
+    py::object loop;
+    try {
+      loop = py::import("asyncio").attr("get_running_loop")();
+    } catch (const py::error_already_set &) {
+      PyErr_Clear();
+      return py::object();
+    }
+    py::object future = loop.attr("create_future")();
+    auto wake_up = [](py::object future) {
+      // the task may have been cancelled meanwhile
+      if (!py::extract<bool>(future.attr("done")())) {
+        future.attr("set_result")(py::object());
+      }
+    };
+    loop.attr("call_later")(
+        _poll_interval,
+        py::make_function(wake_up, py::default_call_policies(), boost::mpl::vector<void, py::object>()),
+        future);
+    _poll_interval = std::min(2.0 * _poll_interval, 0.02);
+    // same as asyncio.Future.__await__, tells the task to wait for it
+    future.attr("_asyncio_future_blocking") = true;
+    return future;
+  }
+
+  double _poll_interval = 0.001;
+
+  std::function<bool(carla::time_duration)> _wait;
+
+  std::function<boost::python::object()> _get;
+
+  boost::optional<boost::python::object> _result;
+
+  std::exception_ptr _exception;
+};
+
+static auto GetActorsByIdAsync(carla::client::World &self, const boost::python::list &actor_ids) {
+  std::vector<carla::ActorId> ids{
+      boost::python::stl_input_iterator<carla::ActorId>(actor_ids),
+      boost::python::stl_input_iterator<carla::ActorId>()};
+  carla::PythonUtil::ReleaseGIL unlock;
+  return PythonFuture(self.GetActorsAsync(ids));
+}
+
+static boost::python::dict GetActorsState(
+    const carla::client::World &self,
+    const boost::python::list &actor_ids,
+    carla::rpc::ActorFieldType fields) {
+  namespace py = boost::python;
+  std::vector<carla::ActorId> ids{
+      py::stl_input_iterator<carla::ActorId>(actor_ids),
+      py::stl_input_iterator<carla::ActorId>()};
+  carla::rpc::ActorColumns columns;
+  {
+    carla::PythonUtil::ReleaseGIL unlock;
+    columns = self.GetActorsState(ids, fields);
+  }
+  using carla::rpc::ActorField;
+  using carla::rpc::HasField;
+  py::dict result;
+  result["id"] = RecordsToBytes(columns.ids);
+  if (HasField(fields, ActorField::Transform)) {
+    result["transform"] = RecordsToBytes(columns.transform);
+  }
+  if (HasField(fields, ActorField::Velocity)) {
+    result["velocity"] = RecordsToBytes(columns.velocity);
+  }
+  if (HasField(fields, ActorField::AngularVelocity)) {
+    result["angular_velocity"] = RecordsToBytes(columns.angular_velocity);
+  }
+  if (HasField(fields, ActorField::Acceleration)) {
+    result["acceleration"] = RecordsToBytes(columns.acceleration);
+  }
+  if (HasField(fields, ActorField::VehicleControl)) {
+    result["vehicle_control"] = RecordsToBytes(columns.vehicle_control);
+  }
+  if (HasField(fields, ActorField::SpeedLimit)) {
+    result["speed_limit"] = RecordsToBytes(columns.speed_limit);
+  }
+  if (HasField(fields, ActorField::TrafficLightState)) {
+    result["traffic_light_state"] = RecordsToBytes(columns.traffic_light_state);
+  }
+  if (HasField(fields, ActorField::VehicleLightState)) {
+    result["vehicle_light_state"] = RecordsToBytes(columns.vehicle_light_state);
+  }
+  if (HasField(fields, ActorField::VehiclePhysics)) {
+    result["vehicle_physics"] = RecordsToBytes(columns.vehicle_physics);
+  }
+  if (HasField(fields, ActorField::BoneTransforms)) {
+    result["bone_count"] = RecordsToBytes(columns.bone_count);
+    result["bone_transforms"] = RecordsToBytes(columns.bone_transforms);
+  }
+  return result;
+}
+
+static auto GetSettingsAsync(const carla::client::World &self) {
+  carla::PythonUtil::ReleaseGIL unlock;
+  return PythonFuture(self.GetSettingsAsync());
+}
+
+static auto SpawnActorAsync(
+    carla::client::World &self,
+    const carla::client::ActorBlueprint &blueprint,
+    const carla::geom::Transform &transform,
+    carla::client::Actor *parent,
+    carla::rpc::AttachmentType attachment_type) {
+  carla::PythonUtil::ReleaseGIL unlock;
+  return PythonFuture(self.SpawnActorAsync(blueprint, transform, parent, attachment_type));
+}
+
 static auto GetVehiclesLightStates(carla::client::World &self) {
   boost::python::dict dict;
   auto list = self.GetVehiclesLightStates();
@@ -152,6 +349,30 @@ void export_world() {
     .def(self_ns::str(self_ns::self))
   ;
 
+  class_<PythonFuture>("Future", no_init)
+    .def("done", &PythonFuture::Done)
+    .def("wait", &PythonFuture::Wait, (arg("seconds")))
+    .def("result", &PythonFuture::Result)
+    .def("__await__", +[](object self) { return self; })
+    .def("__iter__", +[](object self) { return self; })
+    .def("__next__", &PythonFuture::Next)
+  ;
+
+  enum_<cr::ActorField>("ActorField")
+    .value("NONE", cr::ActorField::None)
+    .value("Transform", cr::ActorField::Transform)
+    .value("Velocity", cr::ActorField::Velocity)
+    .value("AngularVelocity", cr::ActorField::AngularVelocity)
+    .value("Acceleration", cr::ActorField::Acceleration)
+    .value("VehicleControl", cr::ActorField::VehicleControl)
+    .value("SpeedLimit", cr::ActorField::SpeedLimit)
+    .value("TrafficLightState", cr::ActorField::TrafficLightState)
+    .value("VehicleLightState", cr::ActorField::VehicleLightState)
+    .value("VehiclePhysics", cr::ActorField::VehiclePhysics)
+    .value("BoneTransforms", cr::ActorField::BoneTransforms)
+    .value("All", cr::ActorField::All)
+  ;
+
   class_<cr::EpisodeSettings>("WorldSettings")
     .def(init<bool, bool, double, bool, double, int, float, bool, float, float, bool>(
         (arg("synchronous_mode")=false,
@@ -241,6 +462,16 @@ void export_world() {
     .def_readonly("label", &cr::LabelledPoint::_label)
   ;
 
+  class_<carla::nav::RoutePlannerStatistics>("RoutePlannerStatistics", no_init)
+    .def_readonly("queued_requests", &carla::nav::RoutePlannerStatistics::queued_requests)
+    .def_readonly("ready_routes", &carla::nav::RoutePlannerStatistics::ready_routes)
+    .def_readonly("routes_delivered", &carla::nav::RoutePlannerStatistics::routes_delivered)
+    .def_readonly("last_latency", &carla::nav::RoutePlannerStatistics::last_latency)
+    .def_readonly("mean_latency", &carla::nav::RoutePlannerStatistics::mean_latency)
+    .def_readonly("max_latency", &carla::nav::RoutePlannerStatistics::max_latency)
+    .def(self_ns::str(self_ns::self))
+  ;
+
   enum_<cr::MapLayer>("MapLayer")
     .value("NONE", cr::MapLayer::None)
     .value("Buildings", cr::MapLayer::Buildings)
@@ -314,6 +545,7 @@ void export_world() {
     .def("get_random_location_from_navigation", CALL_RETURNING_OPTIONAL_WITHOUT_GIL(cc::World, GetRandomLocationFromNavigation))
     .def("get_spectator", CONST_CALL_WITHOUT_GIL(cc::World, GetSpectator))
     .def("get_settings", CONST_CALL_WITHOUT_GIL(cc::World, GetSettings))
+    .def("get_settings_async", &GetSettingsAsync)
     .def("apply_settings", &ApplySettings, (arg("settings"), arg("seconds")=0.0))
     .def("get_weather", CONST_CALL_WITHOUT_GIL(cc::World, GetWeather))
     .def("set_weather", &cc::World::SetWeather)
@@ -321,14 +553,22 @@ void export_world() {
     .def("get_actor", CONST_CALL_WITHOUT_GIL_1(cc::World, GetActor, carla::ActorId), (arg("actor_id")))
     .def("get_actors", CONST_CALL_WITHOUT_GIL(cc::World, GetActors))
     .def("get_actors", &GetActorsById, (arg("actor_ids")))
+    .def("get_actors_async", &GetActorsByIdAsync, (arg("actor_ids")))
+    .def("get_actors_state", &GetActorsState, (arg("actor_ids"), arg("fields")))
     .def("spawn_actor", SPAWN_ACTOR_WITHOUT_GIL(SpawnActor))
     .def("try_spawn_actor", SPAWN_ACTOR_WITHOUT_GIL(TrySpawnActor))
+    .def("spawn_actor_async", &SpawnActorAsync, (
+        arg("blueprint"),
+        arg("transform"),
+        arg("attach_to")=carla::SharedPtr<cc::Actor>(),
+        arg("attachment_type")=cr::AttachmentType::Rigid))
     .def("wait_for_tick", &WaitForTick, (arg("seconds")=0.0))
     .def("on_tick", &OnTick, (arg("callback")))
     .def("remove_on_tick", &cc::World::RemoveOnTick, (arg("callback_id")))
     .def("tick", &Tick, (arg("seconds")=0.0))
     .def("set_pedestrians_cross_factor", CALL_WITHOUT_GIL_1(cc::World, SetPedestriansCrossFactor, float), (arg("percentage")))
     .def("set_pedestrians_seed", CALL_WITHOUT_GIL_1(cc::World, SetPedestriansSeed, unsigned int), (arg("seed")))
+    .def("get_pedestrians_route_statistics", CONST_CALL_WITHOUT_GIL(cc::World, GetPedestriansRouteStatistics))
     .def("get_traffic_sign", CONST_CALL_WITHOUT_GIL_1(cc::World, GetTrafficSign, cc::Landmark), arg("landmark"))
     .def("get_traffic_light", CONST_CALL_WITHOUT_GIL_1(cc::World, GetTrafficLight, cc::Landmark), arg("landmark"))
     .def("get_traffic_light_from_opendrive_id", CONST_CALL_WITHOUT_GIL_1(cc::World, GetTrafficLightFromOpenDRIVE, const carla::road::SignId&), arg("traffic_light_id"))
@@ -193,6 +193,21 @@ static carla::time_duration TimeDurationFromSeconds(double seconds) {
   return carla::time_duration::milliseconds(ms);
 }
 
+/// Returns the records as a bytes object, to be read with numpy.frombuffer
+/// and the dtype documented in the Python API reference.
+template <typename T>
+static boost::python::object RecordsToBytes(const std::vector<T> &records) {
+  namespace py = boost::python;
+  const auto *data = reinterpret_cast<const char *>(records.data());
+  const auto size = static_cast<Py_ssize_t>(records.size() * sizeof(T));
+#if PY_MAJOR_VERSION >= 3
+  auto *ptr = PyBytes_FromStringAndSize(data, size);
+#else
+  auto *ptr = PyString_FromStringAndSize(data, size);
+#endif
+  return py::object(py::handle<>(ptr));
+}
+
 static auto MakeCallback(boost::python::object callback) {
   namespace py = boost::python;
   // Make sure the callback is actually callable.
@@ -232,6 +247,7 @@ static auto MakeCallback(boost::python::object callback) {
 #include "TrafficManager.cpp"
 #include "LightManager.cpp"
 #include "OSM2ODR.cpp"
+#include "Recorder.cpp"
 
 #ifdef LIBCARLA_RSS_ENABLED
 #include "AdRss.cpp"
@@ -262,4 +278,5 @@ BOOST_PYTHON_MODULE(libcarla) {
   export_ad_rss();
   #endif
   export_osm2odr();
+  export_recorder();
 }
@@ -0,0 +1,160 @@
+#!/usr/bin/env python
+
+# Copyright (c) 2023 Computer Vision Center (CVC) at the Universitat Autonoma de
+# Barcelona (UAB).
+#
+# This work is licensed under the terms of the MIT license.
+# For a copy, see <https://opensource.org/licenses/MIT>.
+
+"""
+Measures the time per tick of the Traffic Manager against the number of
+threads used to update the vehicles. The simulation runs in synchronous mode,
+so every world tick waits for the Traffic Manager to finish its own cycle.
+"""
+
+import glob
+import os
+import sys
+
+try:
+    sys.path.append(glob.glob('../carla/dist/carla-*%d.%d-%s.egg' % (
+        sys.version_info.major,
+        sys.version_info.minor,
+        'win-amd64' if os.name == 'nt' else 'linux-x86_64'))[0])
+except IndexError:
+    pass
+
+import carla
+
+import argparse
+import random
+import time
+
+
+def spawn_vehicles(client, world, traffic_manager, number_of_vehicles):
+    blueprints = [bp for bp in world.get_blueprint_library().filter('vehicle.*')
+                  if int(bp.get_attribute('number_of_wheels')) == 4]
+    spawn_points = world.get_map().get_spawn_points()
+    random.shuffle(spawn_points)
+    if number_of_vehicles > len(spawn_points):
+        print('Requested %d vehicles, but the map only has %d spawn points' % (
+            number_of_vehicles, len(spawn_points)))
+        number_of_vehicles = len(spawn_points)
+
+    batch = []
+    for transform in spawn_points[:number_of_vehicles]:
+        blueprint = random.choice(blueprints)
+        blueprint.set_attribute('role_name', 'autopilot')
+        batch.append(carla.command.SpawnActor(blueprint, transform).then(
+            carla.command.SetAutopilot(carla.command.FutureActor, True, traffic_manager.get_port())))
+
+    vehicles = []
+    for response in client.apply_batch_sync(batch, True):
+        if not response.error:
+            vehicles.append(response.actor_id)
+    return vehicles
+
+
+def measure(world, ticks):
+    elapsed = []
+    for _ in range(ticks):
+        start = time.perf_counter()
+        world.tick()
+        elapsed.append(time.perf_counter() - start)
+    elapsed.sort()
+    mean = sum(elapsed) / len(elapsed)
+    return 1000.0 * mean, 1000.0 * elapsed[len(elapsed) // 2], 1000.0 * elapsed[int(0.95 * (len(elapsed) - 1))]
+
+
+def main():
+    argparser = argparse.ArgumentParser(description=__doc__)
+    argparser.add_argument(
+        '--host',
+        metavar='H',
+        default='127.0.0.1',
+        help='IP of the host server (default: 127.0.0.1)')
+    argparser.add_argument(
+        '-p', '--port',
+        metavar='P',
+        default=2000,
+        type=int,
+        help='TCP port to listen to (default: 2000)')
+    argparser.add_argument(
+        '--tm-port',
+        metavar='P',
+        default=8000,
+        type=int,
+        help='Port to communicate with TM (default: 8000)')
+    argparser.add_argument(
+        '-n', '--number-of-vehicles',
+        metavar='N',
+        default=500,
+        type=int,
+        help='Number of vehicles (default: 500)')
+    argparser.add_argument(
+        '--threads',
+        metavar='T',
+        nargs='+',
+        default=[1, 2, 4, 8],
+        type=int,
+        help='Number of TM worker threads to benchmark (default: 1 2 4 8)')
+    argparser.add_argument(
+        '--warmup',
+        default=50,
+        type=int,
+        help='Ticks run before measuring each configuration (default: 50)')
+    argparser.add_argument(
+        '--ticks',
+        default=300,
+        type=int,
+        help='Ticks measured for each configuration (default: 300)')
+    argparser.add_argument(
+        '--seed',
+        default=0,
+        type=int,
+        help='Random seed (default: 0)')
+    args = argparser.parse_args()
+
+    random.seed(args.seed)
+
+    client = carla.Client(args.host, args.port)
+    client.set_timeout(60.0)
+    world = client.get_world()
+    original_settings = world.get_settings()
+
+    traffic_manager = client.get_trafficmanager(args.tm_port)
+    traffic_manager.set_random_device_seed(args.seed)
+    vehicles = []
+
+    try:
+        settings = world.get_settings()
+        settings.synchronous_mode = True
+        settings.fixed_delta_seconds = 0.05
+        settings.no_rendering_mode = True
+        world.apply_settings(settings)
+        traffic_manager.set_synchronous_mode(True)
+
+        vehicles = spawn_vehicles(client, world, traffic_manager, args.number_of_vehicles)
+        print('Spawned %d vehicles' % len(vehicles))
+
+        print('%8s | %10s | %10s | %10s' % ('threads', 'mean ms', 'median ms', 'p95 ms'))
+        for threads in args.threads:
+            traffic_manager.set_worker_threads(threads)
+            for _ in range(args.warmup):
+                world.tick()
+            mean, median, p95 = measure(world, args.ticks)
+            print('%8d | %10.3f | %10.3f | %10.3f' % (threads, mean, median, p95))
+
+    finally:
+        traffic_manager.set_worker_threads(1)
+        client.apply_batch([carla.command.DestroyActor(x) for x in vehicles])
+        traffic_manager.set_synchronous_mode(False)
+        world.apply_settings(original_settings)
+
+
+if __name__ == '__main__':
+
+    try:
+        main()
+    except KeyboardInterrupt:
+        pass
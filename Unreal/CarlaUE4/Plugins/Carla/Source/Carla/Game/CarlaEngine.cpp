@@ -85,9 +85,14 @@ void FCarlaEngine::NotifyInitGame(const UCarlaSettings &Settings)
     const auto PrimaryPort   = Settings.PrimaryPort;
 
     auto BroadcastStream     = Server.Start(Settings.RPCPort, StreamingPort, SecondaryPort);
+    if (Settings.SharedMemoryStreamingSize > 0u)
+    {
+      Server.SetSharedMemoryStreaming(Settings.SharedMemoryStreamingSize);
+    }
     Server.AsyncRun(FCarlaEngine_GetNumberOfThreadsForRPCServer());
 
     WorldObserver.SetStream(BroadcastStream);
+    WorldObserver.SetDeltaStream(Server.GetDeltaBroadcastStream());
 
     OnPreTickHandle = FWorldDelegates::OnWorldTickStart.AddRaw(
         this,
@@ -57,6 +57,11 @@ public:
     return CurrentEpisode;
   }
 
+  FWorldObserver &GetWorldObserver()
+  {
+    return WorldObserver;
+  }
+
   void SetRecorder(ACarlaRecorder *InRecorder)
   {
     Recorder = InRecorder;
@@ -415,13 +415,13 @@ void UCarlaEpisode::EndPlay(void)
   }
 }
 
-std::string UCarlaEpisode::StartRecorder(std::string Name, bool AdditionalData)
+std::string UCarlaEpisode::StartRecorder(std::string Name, bool AdditionalData, bool Compressed)
 {
   std::string result;
 
   if (Recorder)
   {
-    result = Recorder->Start(Name, MapName, AdditionalData);
+    result = Recorder->Start(Name, MapName, AdditionalData, Compressed);
   }
   else
   {
@@ -317,7 +317,7 @@ public:
     return Recorder->GetReplayer();
   }
 
-  std::string StartRecorder(std::string name, bool AdditionalData);
+  std::string StartRecorder(std::string name, bool AdditionalData, bool Compressed);
 
   FIntVector GetCurrentMapOrigin() const { return CurrentMapOrigin; }
 
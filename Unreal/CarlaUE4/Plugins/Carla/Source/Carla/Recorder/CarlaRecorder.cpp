@@ -30,6 +30,26 @@
 #include <ctime>
 #include <sstream>
 
+// the records read by the queries of LibCarla must match the ones written here
+static_assert(sizeof(CarlaRecorderFrame) == sizeof(carla::recorder::FrameRecord),
+    "Frame record does not match LibCarla");
+static_assert(sizeof(CarlaRecorderPosition) == sizeof(carla::recorder::PositionRecord),
+    "Position record does not match LibCarla");
+static_assert(sizeof(CarlaRecorderCollision) == sizeof(carla::recorder::CollisionRecord),
+    "Collision record does not match LibCarla");
+static_assert(
+    static_cast<uint8_t>(FCarlaActor::ActorType::Vehicle) ==
+        static_cast<uint8_t>(carla::recorder::ActorType::Vehicle) &&
+    static_cast<uint8_t>(FCarlaActor::ActorType::Walker) ==
+        static_cast<uint8_t>(carla::recorder::ActorType::Walker) &&
+    static_cast<uint8_t>(FCarlaActor::ActorType::TrafficLight) ==
+        static_cast<uint8_t>(carla::recorder::ActorType::TrafficLight) &&
+    static_cast<uint8_t>(FCarlaActor::ActorType::TrafficSign) ==
+        static_cast<uint8_t>(carla::recorder::ActorType::TrafficSign) &&
+    static_cast<uint8_t>(FCarlaActor::ActorType::Sensor) ==
+        static_cast<uint8_t>(carla::recorder::ActorType::Sensor),
+    "Actor types do not match LibCarla");
+
 ACarlaRecorder::ACarlaRecorder(void)
 {
   PrimaryActorTick.TickGroup = TG_PrePhysics;
@@ -404,7 +424,7 @@ void ACarlaRecorder::AddActorBones(FCarlaActor *CarlaActor)
   WalkersBones.Add(std::move(Walker));
 }
 
-std::string ACarlaRecorder::Start(std::string Name, FString MapName, bool AdditionalData)
+std::string ACarlaRecorder::Start(std::string Name, FString MapName, bool AdditionalData, bool Compressed)
 {
   // stop replayer if any in course
   if (Replayer.IsEnabled())
@@ -419,8 +439,8 @@ std::string ACarlaRecorder::Start(std::string Name, FString MapName, bool Additi
   // get the final path + filename
   std::string Filename = GetRecorderFilename(Name);
 
-  // binary file
-  File.open(Filename, std::ios::binary);
+  // binary file, compressed in chunks if required
+  File.open(Filename, Compressed);
   if (!File.is_open())
   {
     return "";
@@ -434,8 +454,10 @@ std::string ACarlaRecorder::Start(std::string Name, FString MapName, bool Additi
 
   // write general info
   Info.Write(File);
+  File.EndHeader();
 
   Frames.Reset();
+  Index.Reset();
   PlatformTime.SetStartTime();
 
   Enable();
@@ -452,8 +474,13 @@ void ACarlaRecorder::Stop(void)
 {
   Disable();
 
-  if (File)
+  if (File.is_open())
   {
+    // the index goes at the end, so the replayer can seek in the file
+    if (!Index.IsEmpty())
+    {
+      Index.Write(File);
+    }
     File.close();
   }
 
@@ -488,7 +515,12 @@ void ACarlaRecorder::Write(double DeltaSeconds)
   Frames.SetFrame(DeltaSeconds);
 
   // start
+  const std::streampos FrameStart = File.tellp();
+  Index.AddFrame(Frames.GetFrame().Elapsed, FrameStart);
   Frames.WriteStart(File);
+  // after the start, as it completes the previous frame
+  File.StartFrame(FrameStart);
+  Index.WriteKeyframe(File);
   VisualTime.Write(File);
 
   // events
@@ -524,6 +556,9 @@ void ACarlaRecorder::Write(double DeltaSeconds)
   // end
   Frames.WriteEnd(File);
 
+  // the keyframes have the actors alive at the start of their frame
+  Index.UpdateActors(EventsAdd.GetEvents(), EventsDel.GetEvents(), EventsParent.GetEvents());
+
   Clear();
 }
 
@@ -15,6 +15,7 @@
 #include "CarlaRecorderPhysicsControl.h"
 #include "CarlaRecorderPlatformTime.h"
 #include "CarlaRecorderBoundingBox.h"
+#include "CarlaRecorderChunks.h"
 #include "CarlaRecorderKinematics.h"
 #include "CarlaRecorderLightScene.h"
 #include "CarlaRecorderLightVehicle.h"
@@ -27,6 +28,7 @@
 #include "CarlaRecorderEventDel.h"
 #include "CarlaRecorderEventParent.h"
 #include "CarlaRecorderFrames.h"
+#include "CarlaRecorderIndex.h"
 #include "CarlaRecorderInfo.h"
 #include "CarlaRecorderPosition.h"
 #include "CarlaRecorderQuery.h"
@@ -35,6 +37,10 @@
 #include "CarlaRecorderWalkerBones.h"
 #include "CarlaReplayer.h"
 
+#include <compiler/disable-ue4-macros.h>
+#include <carla/recorder/RecorderPackets.h>
+#include <compiler/enable-ue4-macros.h>
+
 #include "CarlaRecorder.generated.h"
 
 class AActor;
@@ -44,32 +50,9 @@ class UCarlaLight;
 class ATrafficSignBase;
 class ATrafficLightBase;
 
-enum class CarlaRecorderPacketId : uint8_t
-{
-  FrameStart = 0,
-  FrameEnd,
-  EventAdd,
-  EventDel,
-  EventParent,
-  Collision,
-  Position,
-  State,
-  AnimVehicle,
-  AnimWalker,
-  VehicleLight,
-  SceneLight,
-  Kinematics,
-  BoundingBox,
-  PlatformTime,
-  PhysicsControl,
-  TrafficLightTime,
-  TriggerVolume,
-  FrameCounter,
-  WalkerBones,
-  VisualTime,
-  AnimVehicleWheels,
-  AnimBiker
-};
+// the ids are shared with the queries of LibCarla, that read the recordings
+// without the simulator
+using CarlaRecorderPacketId = carla::recorder::PacketId;
 
 /// Recorder for the simulation
 UCLASS()
@@ -92,7 +75,7 @@ public:
   void Disable(void);
 
   // start / stop
-  std::string Start(std::string Name, FString MapName, bool AdditionalData = false);
+  std::string Start(std::string Name, FString MapName, bool AdditionalData = false, bool Compressed = false);
 
   void Stop(void);
 
@@ -181,13 +164,14 @@ private:
   uint32_t NextCollisionId = 0;
 
   // files
-  std::ofstream File;
+  CarlaRecorderOutputFile File;
 
   UCarlaEpisode *Episode = nullptr;
 
   // structures
   CarlaRecorderInfo Info;
   CarlaRecorderFrames Frames;
+  CarlaRecorderIndex Index;
   CarlaRecorderEventsAdd EventsAdd;
   CarlaRecorderEventsDel EventsDel;
   CarlaRecorderEventsParent EventsParent;
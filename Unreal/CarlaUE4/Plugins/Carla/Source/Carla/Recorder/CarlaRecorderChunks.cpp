@@ -0,0 +1,114 @@
+// Copyright (c) 2023 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "CarlaRecorderChunks.h"
+
+#include "Misc/Compression.h"
+
+#include <vector>
+
+static bool CompressChunk(const std::vector<char> &Data, std::vector<char> &Compressed)
+{
+  const int32 Size = static_cast<int32>(Data.size());
+  int32 CompressedSize = FCompression::CompressMemoryBound(NAME_LZ4, Size);
+  Compressed.resize(CompressedSize);
+  if (!FCompression::CompressMemory(
+      NAME_LZ4,
+      Compressed.data(),
+      CompressedSize,
+      Data.data(),
+      Size))
+  {
+    return false;
+  }
+  Compressed.resize(CompressedSize);
+  return Compressed.size() < Data.size();
+}
+
+static bool DecompressChunk(const std::vector<char> &Compressed, std::vector<char> &Data)
+{
+  return FCompression::UncompressMemory(
+      NAME_LZ4,
+      Data.data(),
+      static_cast<int32>(Data.size()),
+      Compressed.data(),
+      static_cast<int32>(Compressed.size()));
+}
+
+// ---------------------------------------------
+
+CarlaRecorderOutputFile::CarlaRecorderOutputFile(void)
+  : std::ostream(nullptr),
+    ChunkWriter(&CompressChunk)
+{
+}
+
+void CarlaRecorderOutputFile::open(const std::string &Filename, bool bCompressed)
+{
+  close();
+  if (bCompressed)
+  {
+    if (ChunkWriter.Open(Filename))
+    {
+      rdbuf(&ChunkWriter);
+    }
+  }
+  else if (FileBuffer.open(Filename, std::ios::out | std::ios::binary) != nullptr)
+  {
+    rdbuf(&FileBuffer);
+  }
+}
+
+void CarlaRecorderOutputFile::close(void)
+{
+  FileBuffer.close();
+  ChunkWriter.Close();
+  rdbuf(nullptr);
+}
+
+void CarlaRecorderOutputFile::EndHeader(void)
+{
+  if (ChunkWriter.IsOpen())
+  {
+    ChunkWriter.WriteUncompressed();
+  }
+}
+
+void CarlaRecorderOutputFile::StartFrame(std::streampos Position)
+{
+  if (ChunkWriter.IsOpen())
+  {
+    ChunkWriter.FlushBefore(Position);
+  }
+}
+
+// ---------------------------------------------
+
+CarlaRecorderInputFile::CarlaRecorderInputFile(void)
+  : std::istream(nullptr),
+    ChunkReader(&DecompressChunk)
+{
+}
+
+void CarlaRecorderInputFile::open(const std::string &Filename, std::ios_base::openmode Mode)
+{
+  close();
+  if (ChunkReader.Open(Filename))
+  {
+    rdbuf(&ChunkReader);
+  }
+  else if (FileBuffer.open(Filename, Mode | std::ios::in) != nullptr)
+  {
+    rdbuf(&FileBuffer);
+  }
+}
+
+void CarlaRecorderInputFile::close(void)
+{
+  FileBuffer.close();
+  ChunkReader.Close();
+  rdbuf(nullptr);
+}
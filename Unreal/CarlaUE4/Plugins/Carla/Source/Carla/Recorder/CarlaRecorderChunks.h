@@ -0,0 +1,76 @@
+// Copyright (c) 2023 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include <compiler/disable-ue4-macros.h>
+#include <carla/recorder/ChunkStream.h>
+#include <compiler/enable-ue4-macros.h>
+
+#include <fstream>
+#include <string>
+
+// The compressed recordings are written and read by the chunk streams of
+// LibCarla (see carla/recorder/ChunkStream.h), the chunks are compressed
+// with the LZ4 of the engine.
+
+// Output of the recorder, a plain or a compressed recording.
+class CarlaRecorderOutputFile : public std::ostream
+{
+
+public:
+
+  CarlaRecorderOutputFile(void);
+
+  ~CarlaRecorderOutputFile(void)
+  {
+    close();
+  }
+
+  void open(const std::string &Filename, bool bCompressed);
+
+  bool is_open(void) const
+  {
+    return FileBuffer.is_open() || ChunkWriter.IsOpen();
+  }
+
+  void close(void);
+
+  // called after writing the info header
+  void EndHeader(void);
+
+  // called at the start of each frame, with the position of its first packet
+  void StartFrame(std::streampos Position);
+
+private:
+
+  std::filebuf FileBuffer;
+  carla::recorder::ChunkWriter ChunkWriter;
+};
+
+// Input of the replayer and the queries, reads both plain and compressed
+// recordings.
+class CarlaRecorderInputFile : public std::istream
+{
+
+public:
+
+  CarlaRecorderInputFile(void);
+
+  void open(const std::string &Filename, std::ios_base::openmode Mode = std::ios::binary);
+
+  bool is_open(void) const
+  {
+    return FileBuffer.is_open() || ChunkReader.IsOpen();
+  }
+
+  void close(void);
+
+private:
+
+  std::filebuf FileBuffer;
+  carla::recorder::ChunkReader ChunkReader;
+};
@@ -0,0 +1,241 @@
+// Copyright (c) 2023 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "CarlaRecorder.h"
+#include "CarlaRecorderIndex.h"
+#include "CarlaRecorderHelpers.h"
+
+#include <algorithm>
+
+// "CRIX", marks the footer of a file with index
+static constexpr uint32_t IndexMagic = 0x58495243u;
+
+// the footer is a packet with the offset of the index and the magic
+static constexpr uint32_t FooterDataSize = sizeof(uint64_t) + sizeof(uint32_t);
+static constexpr uint32_t FooterSize = sizeof(char) + sizeof(uint32_t) + FooterDataSize;
+
+void CarlaRecorderKeyframe::Read(std::istream &InFile)
+{
+  uint32_t i, Total;
+
+  ReadValue<uint32_t>(InFile, Total);
+  Actors.resize(Total);
+  for (i = 0; i < Total; ++i)
+  {
+    Actors[i].Read(InFile);
+  }
+
+  ReadValue<uint32_t>(InFile, Total);
+  Parents.resize(Total);
+  for (i = 0; i < Total; ++i)
+  {
+    Parents[i].Read(InFile);
+  }
+}
+
+void CarlaRecorderKeyframe::Write(std::ostream &OutFile) const
+{
+  WriteValue<uint32_t>(OutFile, Actors.size());
+  for (const auto &Actor : Actors)
+  {
+    Actor.Write(OutFile);
+  }
+
+  WriteValue<uint32_t>(OutFile, Parents.size());
+  for (const auto &Parent : Parents)
+  {
+    Parent.Write(OutFile);
+  }
+}
+
+// ---------------------------------------------
+
+CarlaRecorderIndex::CarlaRecorderIndex(void)
+{
+  Reset();
+}
+
+void CarlaRecorderIndex::Reset(void)
+{
+  Frames.clear();
+  Keyframes.clear();
+  Actors.clear();
+  Parents.clear();
+  LastKeyframeElapsed = 0.0;
+}
+
+void CarlaRecorderIndex::AddFrame(double Elapsed, std::streampos Offset)
+{
+  Frames.push_back(CarlaRecorderIndexFrame { Elapsed, static_cast<uint64_t>(Offset) });
+}
+
+void CarlaRecorderIndex::WriteKeyframe(std::ostream &OutFile)
+{
+  if (Frames.empty() || Frames.back().Elapsed - LastKeyframeElapsed < KeyframeInterval)
+  {
+    return;
+  }
+  LastKeyframeElapsed = Frames.back().Elapsed;
+  Keyframes.push_back(static_cast<uint32_t>(Frames.size() - 1));
+
+  CarlaRecorderKeyframe Keyframe;
+  Keyframe.Actors.reserve(Actors.size());
+  for (const auto &Actor : Actors)
+  {
+    Keyframe.Actors.push_back(Actor.second);
+  }
+  Keyframe.Parents.reserve(Parents.size());
+  for (const auto &Parent : Parents)
+  {
+    Keyframe.Parents.push_back(CarlaRecorderEventParent { Parent.first, Parent.second });
+  }
+
+  // write the packet id
+  WriteValue<char>(OutFile, static_cast<char>(CarlaRecorderPacketId::Keyframe));
+
+  std::streampos PosStart = OutFile.tellp();
+
+  // write a dummy packet size
+  uint32_t Total = 0;
+  WriteValue<uint32_t>(OutFile, Total);
+
+  Keyframe.Write(OutFile);
+
+  // write the real packet size
+  std::streampos PosEnd = OutFile.tellp();
+  Total = PosEnd - PosStart - sizeof(uint32_t);
+  OutFile.seekp(PosStart, std::ios::beg);
+  WriteValue<uint32_t>(OutFile, Total);
+  OutFile.seekp(PosEnd, std::ios::beg);
+}
+
+void CarlaRecorderIndex::UpdateActors(
+    const std::vector<CarlaRecorderEventAdd> &EventsAdd,
+    const std::vector<CarlaRecorderEventDel> &EventsDel,
+    const std::vector<CarlaRecorderEventParent> &EventsParent)
+{
+  // same order as the replayer processes them
+  for (const auto &Event : EventsAdd)
+  {
+    Actors[Event.DatabaseId] = Event;
+  }
+  for (const auto &Event : EventsDel)
+  {
+    Actors.erase(Event.DatabaseId);
+    Parents.erase(Event.DatabaseId);
+  }
+  for (const auto &Event : EventsParent)
+  {
+    if (Actors.count(Event.DatabaseId) > 0)
+    {
+      Parents[Event.DatabaseId] = Event.DatabaseIdParent;
+    }
+  }
+}
+
+void CarlaRecorderIndex::Write(std::ostream &OutFile)
+{
+  std::streampos PosStart = OutFile.tellp();
+
+  // write the packet id
+  WriteValue<char>(OutFile, static_cast<char>(CarlaRecorderPacketId::Index));
+
+  // write packet size
+  uint32_t Total =
+      sizeof(uint32_t) + Frames.size() * sizeof(CarlaRecorderIndexFrame) +
+      sizeof(uint32_t) + Keyframes.size() * sizeof(uint32_t);
+  WriteValue<uint32_t>(OutFile, Total);
+
+  WriteStdVector<CarlaRecorderIndexFrame>(OutFile, Frames);
+  WriteStdVector<uint32_t>(OutFile, Keyframes);
+
+  // write the footer, as a packet so it is skipped by readers that
+  // don't know about it
+  WriteValue<char>(OutFile, static_cast<char>(CarlaRecorderPacketId::IndexFooter));
+  WriteValue<uint32_t>(OutFile, FooterDataSize);
+  WriteValue<uint64_t>(OutFile, static_cast<uint64_t>(PosStart));
+  WriteValue<uint32_t>(OutFile, IndexMagic);
+}
+
+bool CarlaRecorderIndex::Read(std::istream &InFile)
+{
+  Reset();
+
+  std::streampos Current = InFile.tellg();
+
+  // read the footer at the end of the file
+  InFile.seekg(0, std::ios::end);
+  const uint64_t FileSize = static_cast<uint64_t>(InFile.tellg());
+  char Id = 0;
+  uint32_t Size = 0;
+  uint64_t IndexOffset = 0;
+  uint32_t Magic = 0;
+  if (FileSize >= FooterSize)
+  {
+    InFile.seekg(FileSize - FooterSize, std::ios::beg);
+    ReadValue<char>(InFile, Id);
+    ReadValue<uint32_t>(InFile, Size);
+    ReadValue<uint64_t>(InFile, IndexOffset);
+    ReadValue<uint32_t>(InFile, Magic);
+  }
+  bool bValid =
+      InFile &&
+      Id == static_cast<char>(CarlaRecorderPacketId::IndexFooter) &&
+      Size == FooterDataSize &&
+      Magic == IndexMagic &&
+      IndexOffset < FileSize - FooterSize;
+
+  // read the index, that must end just before the footer
+  if (bValid)
+  {
+    InFile.seekg(IndexOffset, std::ios::beg);
+    ReadValue<char>(InFile, Id);
+    ReadValue<uint32_t>(InFile, Size);
+    bValid =
+        InFile &&
+        Id == static_cast<char>(CarlaRecorderPacketId::Index) &&
+        IndexOffset + sizeof(char) + sizeof(uint32_t) + Size + FooterSize == FileSize;
+  }
+  if (bValid)
+  {
+    ReadStdVector<CarlaRecorderIndexFrame>(InFile, Frames);
+    ReadStdVector<uint32_t>(InFile, Keyframes);
+    bValid = InFile &&
+        static_cast<uint64_t>(InFile.tellg()) == FileSize - FooterSize &&
+        std::all_of(Keyframes.begin(), Keyframes.end(), [this](uint32_t Index) {
+          return Index < Frames.size();
+        });
+  }
+
+  if (!bValid)
+  {
+    Reset();
+  }
+
+  InFile.clear();
+  InFile.seekg(Current, std::ios::beg);
+  return bValid;
+}
+
+double CarlaRecorderIndex::GetTotalTime(void) const
+{
+  return Frames.empty() ? 0.0 : Frames.back().Elapsed;
+}
+
+bool CarlaRecorderIndex::FindKeyframe(double Time, std::streampos &Offset) const
+{
+  // keyframes are sorted by time, find the first one after the time
+  auto It = std::upper_bound(Keyframes.begin(), Keyframes.end(), Time,
+      [this](double Value, uint32_t Index) {
+        return Value < Frames[Index].Elapsed;
+      });
+  if (It == Keyframes.begin())
+  {
+    return false;
+  }
+  Offset = static_cast<std::streampos>(Frames[*std::prev(It)].Offset);
+  return true;
+}
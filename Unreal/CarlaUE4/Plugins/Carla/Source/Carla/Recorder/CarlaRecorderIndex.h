@@ -0,0 +1,97 @@
+// Copyright (c) 2023 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include <map>
+#include <sstream>
+#include <vector>
+
+#include "CarlaRecorderEventAdd.h"
+#include "CarlaRecorderEventDel.h"
+#include "CarlaRecorderEventParent.h"
+
+#pragma pack(push, 1)
+struct CarlaRecorderIndexFrame
+{
+  double Elapsed;
+  // position in the file of the Frame Start packet
+  uint64_t Offset;
+};
+#pragma pack(pop)
+
+// actors alive at the start of a frame, enough to replay from that frame
+// without processing the events of all the previous ones
+struct CarlaRecorderKeyframe
+{
+  std::vector<CarlaRecorderEventAdd> Actors;
+  std::vector<CarlaRecorderEventParent> Parents;
+
+  void Read(std::istream &InFile);
+  void Write(std::ostream &OutFile) const;
+};
+
+// Keeps the time and position in the file of each frame, and writes a
+// keyframe every few seconds of recording. When the recording stops, the
+// table is written at the end of the file, followed by a fixed size footer
+// pointing to it, so the replayer can seek without scanning the whole file.
+// Files without the footer (old or not properly closed) are still valid.
+class CarlaRecorderIndex
+{
+
+public:
+
+  // seconds of recording between keyframes
+  static constexpr double KeyframeInterval = 10.0;
+
+  CarlaRecorderIndex(void);
+  void Reset(void);
+
+  // recorder
+
+  // adds a frame that starts at the current position of the file
+  void AddFrame(double Elapsed, std::streampos Offset);
+
+  // writes a keyframe packet if enough time passed since the last one
+  void WriteKeyframe(std::ostream &OutFile);
+
+  // keeps track of the actors alive, with the events of the current frame
+  void UpdateActors(
+      const std::vector<CarlaRecorderEventAdd> &EventsAdd,
+      const std::vector<CarlaRecorderEventDel> &EventsDel,
+      const std::vector<CarlaRecorderEventParent> &EventsParent);
+
+  // writes the index and the footer, must be the last thing in the file
+  void Write(std::ostream &OutFile);
+
+  // replayer
+
+  // reads the index from the end of the file, keeping the current position,
+  // returns false if the file has no valid index
+  bool Read(std::istream &InFile);
+
+  bool IsEmpty(void) const
+  {
+    return Frames.empty();
+  }
+
+  double GetTotalTime(void) const;
+
+  // position in the file of the frame with the last keyframe at or before
+  // Time, returns false if there is none
+  bool FindKeyframe(double Time, std::streampos &Offset) const;
+
+private:
+
+  std::vector<CarlaRecorderIndexFrame> Frames;
+  // indices in Frames of the frames with a keyframe
+  std::vector<uint32_t> Keyframes;
+
+  // recorder state, sorted by id so actors are spawned in creation order
+  std::map<uint32_t, CarlaRecorderEventAdd> Actors;
+  std::map<uint32_t, uint32_t> Parents;
+  double LastKeyframeElapsed;
+};
@@ -12,6 +12,7 @@
 #include "CarlaRecorderPhysicsControl.h"
 #include "CarlaRecorderPlatformTime.h"
 #include "CarlaRecorderBoundingBox.h"
+#include "CarlaRecorderChunks.h"
 #include "CarlaRecorderKinematics.h"
 #include "CarlaRecorderLightScene.h"
 #include "CarlaRecorderLightVehicle.h"
@@ -49,7 +50,7 @@ public:
 
 private:
 
-  std::ifstream File;
+  CarlaRecorderInputFile File;
   Header Header;
   CarlaRecorderInfo RecInfo;
   CarlaRecorderFrame Frame;
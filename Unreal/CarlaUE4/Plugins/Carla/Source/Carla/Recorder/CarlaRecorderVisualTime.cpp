@@ -13,12 +13,12 @@ void CarlaRecorderVisualTime::SetTime(double ThisTime)
   Time = ThisTime;
 }
 
-void CarlaRecorderVisualTime::Read(std::ifstream &InFile)
+void CarlaRecorderVisualTime::Read(std::istream &InFile)
 {
   ReadValue<double>(InFile, this->Time);
 }
 
-void CarlaRecorderVisualTime::Write(std::ofstream &OutFile)
+void CarlaRecorderVisualTime::Write(std::ostream &OutFile)
 {
   // write the packet id
   WriteValue<char>(OutFile, static_cast<char>(CarlaRecorderPacketId::VisualTime));
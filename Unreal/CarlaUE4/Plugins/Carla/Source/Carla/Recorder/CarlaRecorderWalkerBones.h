@@ -25,9 +25,9 @@ struct CarlaRecorderWalkerBones
   uint32_t DatabaseId;
   std::vector<CarlaRecorderWalkerBone> Bones;
   
-  void Read(std::ifstream &InFile);
+  void Read(std::istream &InFile);
 
-  void Write(std::ofstream &OutFile);
+  void Write(std::ostream &OutFile);
 
   void Clear();
 
@@ -42,7 +42,7 @@ public:
 
   void Clear(void);
 
-  void Write(std::ofstream &OutFile);
+  void Write(std::ostream &OutFile);
 
 private:
 
@@ -67,14 +67,23 @@ void CarlaReplayer::Rewind(void)
 
   MappedId.clear();
   IsHeroMap.clear();
+  bKeyframePending = false;
 
   // read geneal Info
   RecInfo.Read(File);
+
+  // read the index at the end of the file, if any
+  Index.Read(File);
 }
 
 // read last frame in File and return the Total time recorded
 double CarlaReplayer::GetTotalTime(void)
 {
+  if (!Index.IsEmpty())
+  {
+    return Index.GetTotalTime();
+  }
+
   std::streampos Current = File.tellg();
 
   // parse only frames
@@ -276,6 +285,16 @@ void CarlaReplayer::ProcessToTime(double Time, bool IsFirstTime)
     bExitLoop = true;
   }
 
+  // when starting, jump to the last keyframe before the time, it has all the
+  // actors that the events of the previous frames would have created
+  std::streampos KeyframeOffset;
+  if (IsFirstTime && !bExitLoop && Index.FindKeyframe(NewTime, KeyframeOffset))
+  {
+    File.clear();
+    File.seekg(KeyframeOffset, std::ios::beg);
+    bKeyframePending = true;
+  }
+
   // process all frames until time we want or end
   while (!File.eof() && !bExitLoop)
   {
@@ -297,6 +316,14 @@ void CarlaReplayer::ProcessToTime(double Time, bool IsFirstTime)
         }
         break;
 
+      // keyframe, only used when jumping to its frame
+      case static_cast<char>(CarlaRecorderPacketId::Keyframe):
+        if (bKeyframePending)
+          ProcessKeyframe();
+        else
+          SkipPacket();
+        break;
+
       // visual time for FX
       case static_cast<char>(CarlaRecorderPacketId::VisualTime):
         ProcessVisualTime();
@@ -435,6 +462,25 @@ void CarlaReplayer::ProcessVisualTime(void)
   Episode->SetVisualGameTime(VisualTime.Time);
 }
 
+void CarlaReplayer::ProcessKeyframe(void)
+{
+  CarlaRecorderKeyframe Keyframe;
+  Keyframe.Read(File);
+  bKeyframePending = false;
+
+  // create all the actors alive at this frame
+  for (const auto &EventAdd : Keyframe.Actors)
+  {
+    ProcessEventAdd(EventAdd);
+  }
+
+  // and attach them
+  for (const auto &EventParent : Keyframe.Parents)
+  {
+    Helper.ProcessReplayerEventParent(MappedId[EventParent.DatabaseId], MappedId[EventParent.DatabaseIdParent]);
+  }
+}
+
 void CarlaReplayer::ProcessEventsAdd(void)
 {
   uint16_t i, Total;
@@ -445,56 +491,60 @@ void CarlaReplayer::ProcessEventsAdd(void)
   for (i = 0; i < Total; ++i)
   {
     EventAdd.Read(File);
+    ProcessEventAdd(EventAdd);
+  }
+}
 
-    // auto Result = CallbackEventAdd(
-    auto Result = Helper.ProcessReplayerEventAdd(
-        EventAdd.Location,
-        EventAdd.Rotation,
-        EventAdd.Description,
-        EventAdd.DatabaseId,
-        IgnoreHero,
-        IgnoreSpectator,
-        bReplaySensors);
-
-    switch (Result.first)
-    {
-      // actor not created
-      case 0:
-        UE_LOG(LogCarla, Log, TEXT("actor could not be created"));
-        break;
+void CarlaReplayer::ProcessEventAdd(const CarlaRecorderEventAdd &EventAdd)
+{
+  // auto Result = CallbackEventAdd(
+  auto Result = Helper.ProcessReplayerEventAdd(
+      EventAdd.Location,
+      EventAdd.Rotation,
+      EventAdd.Description,
+      EventAdd.DatabaseId,
+      IgnoreHero,
+      IgnoreSpectator,
+      bReplaySensors);
+
+  switch (Result.first)
+  {
+    // actor not created
+    case 0:
+      UE_LOG(LogCarla, Log, TEXT("actor could not be created"));
+      break;
 
-      // actor created but with different id
-      case 1:
-        // mapping id (recorded Id is a new Id in replayer)
-        MappedId[EventAdd.DatabaseId] = Result.second;
-        break;
+    // actor created but with different id
+    case 1:
+      // mapping id (recorded Id is a new Id in replayer)
+      MappedId[EventAdd.DatabaseId] = Result.second;
+      break;
 
-      // actor reused from existing
-      case 2:
-        // mapping id (say desired Id is mapped to what)
-        MappedId[EventAdd.DatabaseId] = Result.second;
-        break;
+    // actor reused from existing
+    case 2:
+      // mapping id (say desired Id is mapped to what)
+      MappedId[EventAdd.DatabaseId] = Result.second;
+      break;
 
-      // actor ignored (either Hero or Spectator)
-      case 3:
-        UE_LOG(LogCarla, Log, TEXT("ignoring actor from replayer (Hero or Spectator)"));
-        break;
+    // actor ignored (either Hero or Spectator)
+    case 3:
+      UE_LOG(LogCarla, Log, TEXT("ignoring actor from replayer (Hero or Spectator)"));
+      break;
 
-    }
+  }
 
-    // check to mark if actor is a hero vehicle or not
-    if (Result.first > 0 && Result.first < 3)
+  // check to mark if actor is a hero vehicle or not
+  if (Result.first > 0 && Result.first < 3)
+  {
+    // init
+    IsHeroMap[Result.second] = false;
+    for (const auto &Item : EventAdd.Description.Attributes)
     {
-      // init
-      IsHeroMap[Result.second] = false;
-      for (const auto &Item : EventAdd.Description.Attributes)
+      if (Item.Id == "role_name" && Item.Value == "hero")
       {
-        if (Item.Id == "role_name" && Item.Value == "hero")
-        {
-          // mark as hero
-          IsHeroMap[Result.second] = true;
-          break;
-        }
+        // mark as hero
+        IsHeroMap[Result.second] = true;
+        break;
       }
     }
   }
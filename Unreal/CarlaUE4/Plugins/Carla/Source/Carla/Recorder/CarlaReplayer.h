@@ -11,8 +11,10 @@
 #include <unordered_map>
 
 #include <functional>
+#include "CarlaRecorderChunks.h"
 #include "CarlaRecorderInfo.h"
 #include "CarlaRecorderFrames.h"
+#include "CarlaRecorderIndex.h"
 #include "CarlaRecorderEventAdd.h"
 #include "CarlaRecorderEventDel.h"
 #include "CarlaRecorderEventParent.h"
@@ -103,11 +105,14 @@ private:
   bool Enabled;
   bool bReplaySensors = false;
   UCarlaEpisode *Episode = nullptr;
-  // binary file reader
-  std::ifstream File;
+  // binary file reader, plain or compressed
+  CarlaRecorderInputFile File;
   Header Header;
   CarlaRecorderInfo RecInfo;
   CarlaRecorderFrame Frame;
+  // frame table and keyframes, empty for files recorded without them
+  CarlaRecorderIndex Index;
+  bool bKeyframePending = false;
   // positions (to be able to interpolate)
   std::vector<CarlaRecorderPosition> CurrPos;
   std::vector<CarlaRecorderPosition> PrevPos;
@@ -142,7 +147,10 @@ private:
 
   void ProcessVisualTime(void);
 
+  void ProcessKeyframe(void);
+
   void ProcessEventsAdd(void);
+  void ProcessEventAdd(const CarlaRecorderEventAdd &EventAdd);
   void ProcessEventsDel(void);
   void ProcessEventsParent(void);
 
@@ -54,6 +54,13 @@ public:
     return Stream.MakeBuffer();
   }
 
+  /// Pop a Buffer of @a Size bytes from the pool, reusing the memory of a
+  /// previous message of similar size if available.
+  carla::Buffer PopBufferFromPool(size_t Size)
+  {
+    return Stream.MakeBuffer(Size);
+  }
+
   /// Send some data down the stream.
   template <typename SensorT, typename... ArgsT>
   void Send(SensorT &Sensor, ArgsT &&... Args);
@@ -67,6 +67,13 @@ public:
     return Stream->AreClientsListening();
   }
 
+  /// Counters of the messages sent and dropped by the clients of this stream.
+  auto GetStatistics()
+  {
+    check(Stream.has_value());
+    return Stream->GetStatistics();
+  }
+
 private:
 
   boost::optional<StreamType> Stream;
@@ -265,35 +265,15 @@ static carla::geom::Vector3D FWorldObserver_GetAcceleration(
   return {Acceleration.X, Acceleration.Y, Acceleration.Z};
 }
 
-static carla::Buffer FWorldObserver_Serialize(
-    carla::Buffer &&buffer,
+static carla::sensor::s11n::EpisodeStateSerializer::Header FWorldObserver_MakeHeader(
     const UCarlaEpisode &Episode,
     float DeltaSeconds,
     bool MapChange,
     bool PendingLightUpdates)
 {
-  TRACE_CPUPROFILER_EVENT_SCOPE_STR(__FUNCTION__);
   using Serializer = carla::sensor::s11n::EpisodeStateSerializer;
   using SimulationState = carla::sensor::s11n::EpisodeStateSerializer::SimulationState;
-  using ActorDynamicState = carla::sensor::data::ActorDynamicState;
-
-
-  const FActorRegistry &Registry = Episode.GetActorRegistry();
-
-  auto total_size = sizeof(Serializer::Header) + sizeof(ActorDynamicState) * Registry.Num();
-  auto current_size = 0;
-  // Set up buffer for writing.
-  buffer.reset(total_size);
-  auto write_data = [&current_size, &buffer](const auto &data)
-  {
-    auto begin = buffer.begin() + current_size;
-    std::memcpy(begin, &data, sizeof(data));
-    current_size += sizeof(data);
-  };
 
-  constexpr float TO_METERS = 1e-2;
-
-  // Write header.
   Serializer::Header header;
   header.episode_id = Episode.GetId();
   header.platform_timestamp = FPlatformTime::Seconds();
@@ -306,10 +286,24 @@ static carla::Buffer FWorldObserver_Serialize(
   simulation_state |= (SimulationState::PendingLightUpdate * PendingLightUpdates);
 
   header.simulation_state = static_cast<SimulationState>(simulation_state);
+  return header;
+}
 
-  write_data(header);
+static void FWorldObserver_GetActorDynamicStates(
+    const UCarlaEpisode &Episode,
+    float DeltaSeconds,
+    std::vector<carla::sensor::data::ActorDynamicState> &Actors)
+{
+  TRACE_CPUPROFILER_EVENT_SCOPE_STR(__FUNCTION__);
+  using ActorDynamicState = carla::sensor::data::ActorDynamicState;
+
+  const FActorRegistry &Registry = Episode.GetActorRegistry();
+
+  Actors.clear();
+  Actors.reserve(Registry.Num());
+
+  constexpr float TO_METERS = 1e-2;
 
-  // Write every actor.
   for (auto& It : Registry)
   {
     const FCarlaActor* View = It.Value.Get();
@@ -353,14 +347,26 @@ static carla::Buffer FWorldObserver_Serialize(
       Acceleration,
       State,
     };
-    write_data(info);
+    Actors.emplace_back(info);
   }
+}
 
-  // Shrink buffer
-  buffer.resize(current_size);
-
-  check(buffer.size() == current_size);
+static carla::Buffer FWorldObserver_Serialize(
+    carla::Buffer &&buffer,
+    const carla::sensor::s11n::EpisodeStateSerializer::Header &header,
+    const std::vector<carla::sensor::data::ActorDynamicState> &Actors)
+{
+  TRACE_CPUPROFILER_EVENT_SCOPE_STR(__FUNCTION__);
+  using ActorDynamicState = carla::sensor::data::ActorDynamicState;
 
+  const auto header_size = sizeof(header);
+  const auto actors_size = sizeof(ActorDynamicState) * Actors.size();
+  buffer.reset(header_size + actors_size);
+  std::memcpy(buffer.data(), &header, header_size);
+  if (actors_size > 0u)
+  {
+    std::memcpy(buffer.data() + header_size, Actors.data(), actors_size);
+  }
   return std::move(buffer);
 }
 
@@ -375,14 +381,44 @@ void FWorldObserver::BroadcastTick(
   if (!Stream.IsStreamReady())
     return;
 
-  auto AsyncStream = Stream.MakeAsyncDataStream(*this, Episode.GetElapsedGameTime());
-
-  carla::Buffer buffer = FWorldObserver_Serialize(
-      AsyncStream.PopBufferFromPool(),
+  const auto Header = FWorldObserver_MakeHeader(
       Episode,
       DeltaSecond,
       MapChange,
       PendingLightUpdates);
+  FWorldObserver_GetActorDynamicStates(Episode, DeltaSecond, ActorStates);
+
+  auto AsyncStream = Stream.MakeAsyncDataStream(*this, Episode.GetElapsedGameTime());
+
+  carla::Buffer buffer = FWorldObserver_Serialize(
+      AsyncStream.PopBufferFromPool(),
+      Header,
+      ActorStates);
 
   AsyncStream.SerializeAndSend(*this, std::move(buffer));
+
+  // The delta stream is only encoded while somebody listens to it, the first
+  // message after a gap is always a key frame.
+  if (DeltaStream.IsStreamReady() && DeltaStream.AreClientsListening())
+  {
+    // The send queues drop messages of slow clients in asynchronous mode,
+    // which breaks the chain of deltas. Send a key frame right away instead
+    // of waiting for the client to ask for it.
+    const uint64_t MessagesDropped = DeltaStream.GetStatistics().messages_dropped;
+    if (MessagesDropped != DeltaMessagesDropped)
+    {
+      DeltaMessagesDropped = MessagesDropped;
+      DeltaEncoder.RequestKeyFrame();
+    }
+
+    auto AsyncDeltaStream = DeltaStream.MakeAsyncDataStream(*this, Episode.GetElapsedGameTime());
+
+    carla::Buffer DeltaBuffer = DeltaEncoder.Encode(
+        FCarlaEngine::GetFrameCounter(),
+        Header,
+        ActorStates,
+        AsyncDeltaStream.PopBufferFromPool());
+
+    AsyncDeltaStream.SerializeAndSend(*this, std::move(DeltaBuffer));
+  }
 }
@@ -8,6 +8,13 @@
 
 #include "Carla/Sensor/DataStream.h"
 
+#include <compiler/disable-ue4-macros.h>
+#include <carla/sensor/data/ActorDynamicState.h>
+#include <carla/sensor/s11n/EpisodeStateDeltaSerializer.h>
+#include <compiler/enable-ue4-macros.h>
+
+#include <vector>
+
 class UCarlaEpisode;
 
 /// Serializes and sends all the actors in the current UCarlaEpisode.
@@ -24,6 +31,18 @@ public:
     Stream = std::move(InStream);
   }
 
+  /// Replace the stream used to send the episode state as deltas.
+  void SetDeltaStream(FDataMultiStream InStream)
+  {
+    DeltaStream = std::move(InStream);
+  }
+
+  /// Make the next message of the delta stream a key frame.
+  void RequestKeyFrame()
+  {
+    DeltaEncoder.RequestKeyFrame();
+  }
+
   /// Return the token that allows subscribing to this sensor's stream.
   auto GetToken() const
   {
@@ -47,4 +66,13 @@ public:
 private:
 
   FDataMultiStream Stream;
+
+  FDataMultiStream DeltaStream;
+
+  carla::sensor::s11n::EpisodeStateDeltaEncoder DeltaEncoder;
+
+  std::vector<carla::sensor::data::ActorDynamicState> ActorStates;
+
+  /// Messages of the delta stream dropped by the send queues so far.
+  uint64_t DeltaMessagesDropped = 0u;
 };
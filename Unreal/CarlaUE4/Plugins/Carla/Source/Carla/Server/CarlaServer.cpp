@@ -34,6 +34,7 @@
 #include <carla/Version.h>
 #include <carla/rpc/AckermannControllerSettings.h>
 #include <carla/rpc/Actor.h>
+#include <carla/rpc/ActorColumns.h>
 #include <carla/rpc/ActorDefinition.h>
 #include <carla/rpc/ActorDescription.h>
 #include <carla/rpc/BoneTransformDataIn.h>
@@ -98,7 +99,8 @@ public:
   FPimpl(uint16_t RPCPort, uint16_t StreamingPort, uint16_t SecondaryPort)
     : Server(RPCPort),
       StreamingServer(StreamingPort),
-      BroadcastStream(StreamingServer.MakeStream())
+      BroadcastStream(StreamingServer.MakeStream()),
+      DeltaBroadcastStream(StreamingServer.MakeStream())
   {
     // we need to create shared_ptr from the router for some handlers to live
     SecondaryServer = std::make_shared<carla::multigpu::Router>(SecondaryPort);
@@ -119,6 +121,8 @@ public:
 
   carla::streaming::Stream BroadcastStream;
 
+  carla::streaming::Stream DeltaBroadcastStream;
+
   std::shared_ptr<carla::multigpu::Router> SecondaryServer;
 
   UCarlaEpisode *Episode = nullptr;
@@ -455,6 +459,19 @@ void FCarlaServer::FPimpl::BindActions()
     return cr::EpisodeInfo{Episode->GetId(), BroadcastStream.token()};
   };
 
+  BIND_SYNC(get_episode_delta_info) << [this]() -> R<cr::EpisodeInfo>
+  {
+    REQUIRE_CARLA_EPISODE();
+    UCarlaGameInstance* GameInstance = UCarlaStatics::GetGameInstance(Episode->GetWorld());
+    if (!GameInstance)
+    {
+      RESPOND_ERROR("unable to find CARLA game instance");
+    }
+    // New subscribers need a key frame to start from.
+    GameInstance->GetCarlaEngine()->GetWorldObserver().RequestKeyFrame();
+    return cr::EpisodeInfo{Episode->GetId(), DeltaBroadcastStream.token()};
+  };
+
   BIND_SYNC(get_map_info) << [this]() -> R<cr::MapInfo>
   {
     REQUIRE_CARLA_EPISODE();
@@ -679,6 +696,75 @@ void FCarlaServer::FPimpl::BindActions()
     return Result;
   };
 
+  BIND_SYNC(get_actors_state) << [this](
+      const std::vector<FCarlaActor::IdType> &ids,
+      cr::ActorFieldType Fields) -> R<cr::ActorColumns>
+  {
+    REQUIRE_CARLA_EPISODE();
+    // One row per requested actor, zeroed if the actor is missing or does not
+    // have the field.
+    cr::ActorColumns Result;
+    Result.ids = ids;
+    const bool bLightState = cr::HasField(Fields, cr::ActorField::VehicleLightState);
+    const bool bPhysics = cr::HasField(Fields, cr::ActorField::VehiclePhysics);
+    const bool bBones = cr::HasField(Fields, cr::ActorField::BoneTransforms);
+    if (bLightState)
+    {
+      Result.vehicle_light_state.resize(ids.size(), 0u);
+    }
+    if (bPhysics)
+    {
+      Result.vehicle_physics.resize(ids.size());
+    }
+    if (bBones)
+    {
+      Result.bone_count.resize(ids.size(), 0u);
+    }
+    for (size_t i = 0u; i < ids.size(); ++i)
+    {
+      FCarlaActor* CarlaActor = Episode->FindCarlaActor(ids[i]);
+      if (!CarlaActor)
+      {
+        continue;
+      }
+      if (bLightState)
+      {
+        FVehicleLightState LightState;
+        if (CarlaActor->GetVehicleLightState(LightState) == ECarlaServerResponse::Success)
+        {
+          Result.vehicle_light_state[i] = cr::VehicleLightState(LightState).GetLightStateAsValue();
+        }
+      }
+      if (bPhysics)
+      {
+        FVehiclePhysicsControl PhysicsControl;
+        if (CarlaActor->GetPhysicsControl(PhysicsControl) == ECarlaServerResponse::Success)
+        {
+          const cr::VehiclePhysicsControl Control(PhysicsControl);
+          auto &Record = Result.vehicle_physics[i];
+          Record.mass = Control.mass;
+          Record.max_rpm = Control.max_rpm;
+          Record.moi = Control.moi;
+          Record.drag_coefficient = Control.drag_coefficient;
+          Record.center_of_mass = Control.center_of_mass;
+        }
+      }
+      if (bBones)
+      {
+        FWalkerBoneControlOut Bones;
+        if (CarlaActor->GetBonesTransform(Bones) == ECarlaServerResponse::Success)
+        {
+          Result.bone_count[i] = Bones.BoneTransforms.Num();
+          for (auto &Bone : Bones.BoneTransforms)
+          {
+            Result.bone_transforms.emplace_back(Bone.Value.World);
+          }
+        }
+      }
+    }
+    return Result;
+  };
+
   BIND_SYNC(spawn_actor) << [this](
       cr::ActorDescription Description,
       const cr::Transform &Transform) -> R<cr::Actor>
@@ -2335,10 +2421,10 @@ BIND_SYNC(is_sensor_enabled_for_ros) << [this](carla::streaming::detail::stream_
 
   // ~~ Logging and playback ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 
-  BIND_SYNC(start_recorder) << [this](std::string name, bool AdditionalData) -> R<std::string>
+  BIND_SYNC(start_recorder) << [this](std::string name, bool AdditionalData, bool Compressed) -> R<std::string>
   {
     REQUIRE_CARLA_EPISODE();
-    return R<std::string>(Episode->StartRecorder(name, AdditionalData));
+    return R<std::string>(Episode->StartRecorder(name, AdditionalData, Compressed));
   };
 
   BIND_SYNC(stop_recorder) << [this]() -> R<void>
@@ -2498,7 +2584,9 @@ BIND_SYNC(is_sensor_enabled_for_ros) << [this](carla::streaming::detail::stream_
       [=](auto, const C::ApplyWalkerState &c) {     MAKE_RESULT(set_walker_state(c.actor, c.transform, c.speed)); },
       [=](auto, const C::ConsoleCommand& c) -> CR {       return console_command(c.cmd); },
       [=](auto, const C::SetTrafficLightState& c) { MAKE_RESULT(set_traffic_light_state(c.actor, c.traffic_light_state)); },
-      [=](auto, const C::ApplyLocation& c)        { MAKE_RESULT(set_actor_location(c.actor, c.location)); }
+      [=](auto, const C::ApplyLocation& c)        { MAKE_RESULT(set_actor_location(c.actor, c.location)); },
+      [=](auto, const C::SetActorCollisions& c)   { MAKE_RESULT(set_actor_collisions(c.actor, c.enabled)); },
+      [=](auto, const C::SetActorDead& c)         { MAKE_RESULT(set_actor_dead(c.actor)); }
   );
 
 #undef MAKE_RESULT
@@ -2636,6 +2724,19 @@ FDataMultiStream FCarlaServer::Start(uint16_t RPCPort, uint16_t StreamingPort, u
   return Pimpl->BroadcastStream;
 }
 
+FDataMultiStream FCarlaServer::GetDeltaBroadcastStream() const
+{
+  check(Pimpl != nullptr);
+  return Pimpl->DeltaBroadcastStream;
+}
+
+void FCarlaServer::SetSharedMemoryStreaming(uint32 SizeInMB)
+{
+  check(Pimpl != nullptr);
+  UE_LOG(LogCarlaServer, Log, TEXT("Shared memory streaming: %d MB per session"), SizeInMB);
+  Pimpl->StreamingServer.SetSharedMemoryCapacity(static_cast<size_t>(SizeInMB) * 1024u * 1024u);
+}
+
 void FCarlaServer::NotifyBeginEpisode(UCarlaEpisode &Episode)
 {
   check(Pimpl != nullptr);
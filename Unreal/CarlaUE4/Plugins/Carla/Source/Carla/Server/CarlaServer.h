@@ -28,6 +28,13 @@ public:
 
   FDataMultiStream Start(uint16_t RPCPort, uint16_t StreamingPort, uint16_t SecondaryPort);
 
+  /// Stream sending the episode state as deltas, for the clients that request it.
+  FDataMultiStream GetDeltaBroadcastStream() const;
+
+  /// Send the streams to the clients on the same host through shared memory
+  /// rings of SizeInMB per client and stream. Zero disables it.
+  void SetSharedMemoryStreaming(uint32 SizeInMB);
+
   void NotifyBeginEpisode(UCarlaEpisode &Episode);
 
   void NotifyEndEpisode();
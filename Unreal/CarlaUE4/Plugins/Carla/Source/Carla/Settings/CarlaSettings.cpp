@@ -137,6 +137,10 @@ void UCarlaSettings::LoadSettings()
     {
       SecondaryPort = Value;
     }
+    if (FParse::Value(FCommandLine::Get(), TEXT("-carla-shared-memory-streaming="), Value))
+    {
+      SharedMemoryStreamingSize = Value;
+    }
     FString Tmp;
     if (FParse::Value(FCommandLine::Get(), TEXT("-carla-primary-host="), Tmp))
     {
@@ -182,6 +186,7 @@ void UCarlaSettings::LogSettings() const
   UE_LOG(LogCarla, Log, TEXT("RPC Port = %d"), RPCPort);
   UE_LOG(LogCarla, Log, TEXT("Streaming Port = %d"), StreamingPort);
   UE_LOG(LogCarla, Log, TEXT("Secondary Port = %d"), SecondaryPort);
+  UE_LOG(LogCarla, Log, TEXT("Shared Memory Streaming = %d MB"), SharedMemoryStreamingSize);
   UE_LOG(LogCarla, Log, TEXT("Synchronous Mode = %s"), EnabledDisabled(bSynchronousMode));
   UE_LOG(LogCarla, Log, TEXT("Rendering = %s"), EnabledDisabled(!bDisableRendering));
   UE_LOG(LogCarla, Log, TEXT("[%s]"), S_CARLA_QUALITYSETTINGS);
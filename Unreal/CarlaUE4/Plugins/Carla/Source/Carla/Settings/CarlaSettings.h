@@ -88,6 +88,10 @@ public:
   /// setting for the secondary servers port.
   uint32 SecondaryPort = 2002u;
 
+  /// Size in MB of the shared memory ring used to send the sensor data to each
+  /// client on the same host. Zero sends everything through TCP.
+  uint32 SharedMemoryStreamingSize = 0u;
+
   /// setting for the IP and Port of the primary server to connect.
   std::string PrimaryIP = "";
   uint32      PrimaryPort = 2002u;